@@ -0,0 +1,168 @@
+#include "desc_transform.h"
+
+#include <string.h>
+
+#include "tusb.h"
+#include "proxy_config.h"
+
+// Interface numbers tracked in the keep mask; anything above is stripped.
+#define XFORM_ITF_MAX 32u
+
+void desc_transform_default_rules(desc_transform_rules_t* rules)
+{
+    if (!rules) return;
+    rules->interval_ms       = (uint8_t)PROXY_XFORM_INTERVAL_MS;
+    rules->interval_itf_mask = (uint8_t)PROXY_XFORM_INTERVAL_ITF_MASK;
+    rules->ep_mps_max        = (uint16_t)PROXY_XFORM_EP_MPS_MAX;
+    rules->strip_unused      = PROXY_XFORM_STRIP_UNUSED != 0;
+}
+
+// HS interrupt bInterval is 2^(n-1) x 125 us; A_device is full speed, where
+// it means milliseconds.
+static uint8_t interval_hs_to_fs(uint8_t b)
+{
+    if (b < 1) b = 1;
+    if (b > 16) b = 16;
+    uint32_t ms = (125u << (b - 1u)) / 1000u;
+    if (ms < 1) ms = 1;
+    if (ms > 255) ms = 255;
+    return (uint8_t)ms;
+}
+
+// Interfaces TinyUSB on A_device can open: HID, numbered below CFG_TUD_HID.
+// Anything else makes SET_CONFIGURATION fail ("no driver") and the PC never
+// finishes enumeration, so it is better left out of what the PC sees.
+static uint32_t keep_mask(desc_transform_rules_t const* rules, uint8_t const* src, uint16_t len)
+{
+    uint32_t seen = 0;
+    uint32_t keep = 0;
+    for (uint16_t off = src[0]; off + 2u <= len; )
+    {
+        uint8_t blen = src[off];
+        if (blen < 2 || off + blen > len) break;
+        if (src[off + 1] == TUSB_DESC_INTERFACE && blen >= 9)
+        {
+            uint8_t itf = src[off + 2];
+            if (itf < XFORM_ITF_MAX && !(seen & (1u << itf)))
+            {
+                // The class of alternate setting 0 decides.
+                seen |= 1u << itf;
+                if (!rules->strip_unused ||
+                    (src[off + 5] == TUSB_CLASS_HID && itf < CFG_TUD_HID))
+                {
+                    keep |= 1u << itf;
+                }
+            }
+        }
+        off = (uint16_t)(off + blen);
+    }
+    // Nothing servable: present the device unchanged rather than empty.
+    return keep ? keep : seen;
+}
+
+uint16_t desc_transform_config(desc_transform_rules_t const* rules,
+                               bool src_high_speed,
+                               uint8_t const* src, uint16_t len,
+                               uint8_t* out, uint16_t max,
+                               desc_transform_result_t* result)
+{
+    desc_transform_result_t res = { 0 };
+    if (!rules || !src || !out ||
+        len < sizeof(tusb_desc_configuration_t) ||
+        src[0] < sizeof(tusb_desc_configuration_t) || src[0] > len ||
+        src[1] != TUSB_DESC_CONFIGURATION || max < src[0])
+    {
+        return 0;
+    }
+
+    uint32_t keep = keep_mask(rules, src, len);
+    uint32_t itf_out = 0;
+    uint32_t itf_all = 0;
+
+    memcpy(out, src, src[0]);
+    uint16_t pos = src[0];
+    bool     in_keep = true;     // descriptors ahead of the first interface stay
+    uint8_t  itf = 0xFF;
+    bool     itf_hid = false;
+
+    for (uint16_t off = src[0]; off + 2u <= len; )
+    {
+        uint8_t blen  = src[off];
+        uint8_t dtype = src[off + 1];
+        if (blen < 2 || off + blen > len) break;
+
+        if (dtype == TUSB_DESC_INTERFACE_ASSOCIATION && blen >= 4)
+        {
+            uint8_t first = src[off + 2];
+            in_keep = first < XFORM_ITF_MAX ? (keep & (1u << first)) != 0 : !rules->strip_unused;
+        }
+        else if (dtype == TUSB_DESC_INTERFACE && blen >= 9)
+        {
+            itf     = src[off + 2];
+            itf_hid = src[off + 5] == TUSB_CLASS_HID;
+            in_keep = itf < XFORM_ITF_MAX ? (keep & (1u << itf)) != 0 : !rules->strip_unused;
+            if (itf < XFORM_ITF_MAX)
+            {
+                itf_all |= 1u << itf;
+                if (in_keep) itf_out |= 1u << itf;
+            }
+        }
+
+        if (in_keep)
+        {
+            if (pos + blen > max)
+            {
+                return 0;
+            }
+            uint8_t* d = &out[pos];
+            memcpy(d, &src[off], blen);
+
+            if (dtype == TUSB_DESC_ENDPOINT && blen >= 7 &&
+                (d[3] & 0x03u) == TUSB_XFER_INTERRUPT)
+            {
+                uint16_t mps = (uint16_t)d[4] | ((uint16_t)d[5] << 8);
+                // Bits 11..12 are HS transactions per microframe; FS has none.
+                uint16_t size = mps & 0x07FFu;
+                if (rules->ep_mps_max && size > rules->ep_mps_max) size = rules->ep_mps_max;
+                if (size != mps)
+                {
+                    d[4] = (uint8_t)(size & 0xFF);
+                    d[5] = (uint8_t)(size >> 8);
+                    res.ep_mps++;
+                }
+
+                uint8_t interval = src_high_speed ? interval_hs_to_fs(d[6]) : (d[6] ? d[6] : 1);
+                if (rules->interval_ms && itf_hid && (d[2] & TUSB_DIR_IN_MASK) &&
+                    itf < 8 && (rules->interval_itf_mask & (1u << itf)) &&
+                    interval > rules->interval_ms)
+                {
+                    // A ceiling: a device that already asks for faster polling keeps it.
+                    interval = rules->interval_ms;
+                }
+                if (interval != d[6])
+                {
+                    d[6] = interval;
+                    res.ep_interval++;
+                }
+            }
+            pos = (uint16_t)(pos + blen);
+        }
+        off = (uint16_t)(off + blen);
+    }
+
+    for (uint8_t i = 0; i < XFORM_ITF_MAX; i++)
+    {
+        if (itf_out & (1u << i)) res.itf_kept++;
+        else if (itf_all & (1u << i)) res.itf_stripped++;
+    }
+
+    tusb_desc_configuration_t* cfg = (tusb_desc_configuration_t*)out;
+    cfg->wTotalLength = tu_htole16(pos);
+    if (res.itf_stripped)
+    {
+        cfg->bNumInterfaces = res.itf_kept;
+    }
+
+    if (result) *result = res;
+    return pos;
+}
@@ -0,0 +1,39 @@
+#ifndef DESC_TRANSFORM_H
+#define DESC_TRANSFORM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Rewrites the physical device's configuration descriptor into the one the
+// PC enumerates. The stored copy is never touched: re-plug digests and
+// session segments are compared against the bytes B_host sent.
+typedef struct
+{
+    uint8_t  interval_ms;        // ceiling for HID interrupt IN bInterval, 0 = keep
+    uint8_t  interval_itf_mask;  // HID interfaces the ceiling applies to
+    uint16_t ep_mps_max;         // interrupt wMaxPacketSize ceiling, 0 = keep
+    bool     strip_unused;       // drop interfaces A_device cannot serve
+} desc_transform_rules_t;
+
+typedef struct
+{
+    uint8_t itf_kept;
+    uint8_t itf_stripped;
+    uint8_t ep_interval;         // endpoints whose bInterval changed
+    uint8_t ep_mps;              // endpoints whose wMaxPacketSize changed
+} desc_transform_result_t;
+
+// Rules from the PROXY_XFORM_* knobs.
+void desc_transform_default_rules(desc_transform_rules_t* rules);
+
+// Writes the transformed copy of `src` to `out`; returns its length, 0 when
+// `src` is malformed or does not fit (callers then present `src` as is).
+// `src_high_speed` converts HS interrupt intervals (2^(n-1) microframes) to
+// the full-speed milliseconds A_device enumerates with.
+uint16_t desc_transform_config(desc_transform_rules_t const* rules,
+                               bool src_high_speed,
+                               uint8_t const* src, uint16_t len,
+                               uint8_t* out, uint16_t max,
+                               desc_transform_result_t* result);
+
+#endif // DESC_TRANSFORM_H
@@ -1,3 +1,5 @@
+#define LOG_MODULE LOG_MOD_DEV
+
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
@@ -15,6 +17,8 @@
 #include "uart_transport.h"
 #include "proxy_config.h"
 #include "remote_storage.h"
+#include "enum_trace.h"
+#include "metrics.h"
 
 #ifndef INPUT_LOG_VERBOSE
 #define INPUT_LOG_VERBOSE 0
@@ -54,10 +58,42 @@ static bool wait_for_string_ready(remote_string_desc_t* entry,
                                   uint32_t timeout_ms);
 static void host_irq_init(void);
 static void host_irq_pulse(void);
+static void send_trace_pages(uint32_t host_us);
+static void send_stats_snapshot(void);
+static void send_metrics_pages(void);
+static void replug_begin(void);
+static void replug_abort(const char* why);
+static bool replug_handle_descriptor_frame(const proto_frame_t *f);
+static void replug_task(void);
+static void handle_descriptor_segment(const proto_frame_t *f);
+static void handle_session_done(const proto_frame_t *f);
+static void send_desc_status(desc_session_t const* session);
 
 // Лічильники для моніторингу інпутів/дропів
-static uint32_t s_input_received = 0;
-static uint32_t s_input_dropped_not_ready = 0;
+METRIC_COUNTER_DEFINE(m_input_received, "dev.input.received");
+METRIC_COUNTER_DEFINE(m_input_dropped_not_ready, "dev.input.dropped_not_ready");
+METRIC_COUNTER_DEFINE(m_input_delivered, "dev.input.delivered");
+METRIC_HISTOGRAM_DEFINE(m_input_interval_us, "dev.input.interval_us");
+METRIC_HISTOGRAM_DEFINE(m_input_latency_ms, "dev.input.latency_ms");
+METRIC_GAUGE_DEFINE(m_pending_reports, "dev.pending_reports");
+METRIC_COUNTER_DEFINE(m_desc_segments_dropped, "dev.desc.segments_dropped");
+METRIC_COUNTER_DEFINE(m_desc_status_sent, "dev.desc.status_sent");
+// PF_INPUT arrival -> PC fetched the report (tud_hid_report_complete_cb), per
+// interface: the wait the polling interval adds on A_device.
+METRIC_HISTOGRAM_DEFINE(m_itf0_deliver_us, "dev.itf0.deliver_us");
+METRIC_HISTOGRAM_DEFINE(m_itf1_deliver_us, "dev.itf1.deliver_us");
+METRIC_HISTOGRAM_DEFINE(m_itf2_deliver_us, "dev.itf2.deliver_us");
+METRIC_HISTOGRAM_DEFINE(m_itf3_deliver_us, "dev.itf3.deliver_us");
+METRIC_HISTOGRAM_DEFINE(m_itf4_deliver_us, "dev.itf4.deliver_us");
+METRIC_HISTOGRAM_DEFINE(m_itf5_deliver_us, "dev.itf5.deliver_us");
+METRIC_HISTOGRAM_DEFINE(m_itf6_deliver_us, "dev.itf6.deliver_us");
+METRIC_HISTOGRAM_DEFINE(m_itf7_deliver_us, "dev.itf7.deliver_us");
+
+static metric_t* const s_itf_deliver_us[] = {
+    &m_itf0_deliver_us, &m_itf1_deliver_us, &m_itf2_deliver_us, &m_itf3_deliver_us,
+    &m_itf4_deliver_us, &m_itf5_deliver_us, &m_itf6_deliver_us, &m_itf7_deliver_us,
+};
+static uint32_t s_input_last_us = 0;
 static uint32_t s_input_last_log_ms = 0;
 static uint32_t s_input_last_ts_ms = 0;
 static uint32_t s_input_min_delta_ms = UINT32_MAX;
@@ -74,14 +110,47 @@ typedef struct
     uint8_t  report_id;
     uint8_t  data[64];
     uint16_t len;
+    uint32_t rx_us;       // PF_INPUT arrival, 0 = not timed (release reports)
 } pending_report_t;
 
 static pending_report_t s_pending_reports[CFG_TUD_HID];
 
+// Arrival time of the report TinyUSB is sending per interface, 0 = none timed.
+static uint32_t s_report_inflight_us[CFG_TUD_HID];
+
+// Shape of the last report delivered per interface; used to send an all-zero
+// "release" report when the physical device disappears.
+typedef struct
+{
+    bool     has_id;
+    uint8_t  report_id;
+    uint16_t len;
+} report_shape_t;
+
+static report_shape_t s_last_report_shape[CFG_TUD_HID];
+
+// Fast re-plug: PF_UNMOUNT keeps TinyUSB attached for PROXY_REPLUG_GRACE_MS.
+// The next descriptor set is only digested (not stored); if it matches the
+// live set we just send READY again and the PC never sees a disconnect.
+// Session sets are compared byte for byte against the live set instead, and
+// gaps are asked for like in a normal session.
+typedef struct
+{
+    bool                 active;
+    bool                 device_seen;
+    uint32_t             start_ms;
+    uint32_t             deadline_ms;
+    remote_desc_digest_t candidate;
+    desc_session_t       session;
+} replug_state_t;
+
+static replug_state_t s_replug;
+
 static void remote_desc_reset(void)
 {
     tinyusb_shutdown();
     remote_storage_init_defaults();
+    memset(s_last_report_shape, 0, sizeof(s_last_report_shape));
 }
 
 // Clear accumulated config and report descriptors without touching string cache.
@@ -89,6 +158,8 @@ static void remote_desc_reset_reports_and_config(void)
 {
     s_remote_desc.config.len   = 0;
     s_remote_desc.config.valid = false;
+    s_remote_desc.config_expected_len = 0;
+    s_remote_desc.config_parsed = false;
     for (uint8_t i = 0; i < CFG_TUD_HID; i++)
     {
         s_remote_desc.reports[i].len   = 0;
@@ -96,6 +167,7 @@ static void remote_desc_reset_reports_and_config(void)
         s_remote_desc.hid_itf_present[i] = false;
         s_remote_desc.hid_report_expected_len[i] = 0;
         s_remote_desc.report_has_id[i] = false;
+        s_remote_desc.report_parsed[i] = false;
     }
     s_remote_desc.descriptors_complete = false;
 }
@@ -223,6 +295,7 @@ static void start_tinyusb_if_ready(void)
 
     tud_connect();
     s_remote_desc.usb_attached = true;
+    enum_trace_record(ET_TUSB_INIT, 0);
     LOGI("[DEV] TinyUSB device stack started");
 
     // Повідомляємо хост, що можна приймати вхідні звіти.
@@ -236,26 +309,64 @@ static void maybe_complete_descriptors(void)
         return;
     }
 
-    // Need device and config first.
-    if (!s_remote_desc.device.valid || !s_remote_desc.config.valid)
+    // Need device and a fully assembled config first. Parsing already
+    // happened incrementally, so this is only a cheap readiness check.
+    if (!s_remote_desc.device.valid || !remote_storage_config_complete())
     {
         return;
     }
 
-    // Keep HID bookkeeping fresh.
-    remote_storage_update_string_allowlist();
-    remote_storage_analyze_report_descriptors();
-
     if (remote_storage_reports_ready())
     {
         s_remote_desc.descriptors_complete = true;
-        LOGI("[DEV] descriptor set considered complete (auto)");
+        LOGI("[DEV] descriptor set considered complete (auto) in %lu us (parse=%lu us chunks=%u)",
+             (unsigned long)(time_us_32() - s_remote_desc.assembly_start_us),
+             (unsigned long)s_remote_desc.assembly_parse_us,
+             s_remote_desc.assembly_chunks);
         start_tinyusb_if_ready();
     }
 }
 
+// True for the first frame of a new descriptor set: a legacy DEVICE frame
+// or a segment of a session we have not seen yet.
+static bool descriptor_frame_starts_set(const proto_frame_t *f)
+{
+    bool idle = (!s_remote_desc.usb_attached && !s_remote_desc.descriptors_complete) ||
+                s_replug.active;
+    if (f->cmd == PF_DESC_DEVICE)
+    {
+        return idle;
+    }
+    if (f->cmd == PF_DESC_SEGMENT && f->len)
+    {
+        uint8_t current = s_replug.active ? s_replug.session.id : s_remote_desc.session.id;
+        return idle && f->data[0] != current;
+    }
+    return false;
+}
+
 static void handle_descriptor_frame(const proto_frame_t *f)
 {
+    if (descriptor_frame_starts_set(f))
+    {
+        // Fresh descriptor set: the timeline starts here on this board.
+        enum_trace_reset();
+    }
+    if (f->cmd == PF_DESC_DONE)
+    {
+        enum_trace_record(ET_DESC_DONE_RECV, 0);
+    }
+    else
+    {
+        enum_trace_record(ET_DESC_CHUNK_ACK,
+                          (uint16_t)(((uint16_t)f->cmd << 8) | (f->len > 0xFF ? 0xFF : f->len)));
+    }
+
+    if (s_replug.active && replug_handle_descriptor_frame(f))
+    {
+        return;
+    }
+
     switch (f->cmd)
     {
         case PF_DESC_DEVICE:
@@ -279,10 +390,15 @@ static void handle_descriptor_frame(const proto_frame_t *f)
             memcpy(s_remote_desc.device.data, f->data, f->len);
             s_remote_desc.device.len   = f->len;
             s_remote_desc.device.valid = true;
+            s_remote_desc.assembly_start_us = time_us_32();
+            remote_desc_digest_feed(&s_remote_desc.digest, f->cmd, f->data, f->len);
             LOGI("[DEV] device descriptor chunk len=%u total=%u",
                  f->len, s_remote_desc.device.len);
             update_speed_from_device_desc();
-            maybe_complete_descriptors();
+            if (remote_storage_device_stored())
+            {
+                maybe_complete_descriptors();
+            }
             break;
 
         case PF_DESC_CONFIG:
@@ -295,17 +411,12 @@ static void handle_descriptor_frame(const proto_frame_t *f)
             // Accumulate chunks; guard buffer size.
             uint16_t base = s_remote_desc.config.len;
             // If уже маємо повний конфіг за wTotalLength – ігноруємо дублікати.
-            if (base >= 4)
+            if (remote_storage_config_complete())
             {
-                uint16_t target = (uint16_t)s_remote_desc.config.data[2] |
-                                  ((uint16_t)s_remote_desc.config.data[3] << 8);
-                if (target && base >= target)
-                {
-                    LOGW("[DEV] extra config chunk ignored (already have %u)", base);
-                    break;
-                }
+                LOGT("[DEV] extra config chunk ignored (already have %u)", base);
+                break;
             }
-            if (base >= sizeof(s_remote_desc.config.data))
+            if (base >= remote_storage_config_capacity())
             {
                 LOGW("[DEV] config descriptor buffer full, dropping chunk len=%u", f->len);
                 remote_desc_reset();
@@ -314,9 +425,9 @@ static void handle_descriptor_frame(const proto_frame_t *f)
 
             uint8_t chunk[PROTO_MAX_PAYLOAD_SIZE];
             uint16_t cpy = f->len;
-            if (base + cpy > sizeof(s_remote_desc.config.data))
+            if (base + cpy > remote_storage_config_capacity())
             {
-                cpy = (uint16_t)(sizeof(s_remote_desc.config.data) - base);
+                cpy = (uint16_t)(remote_storage_config_capacity() - base);
             }
             memcpy(chunk, f->data, cpy);
 
@@ -346,20 +457,15 @@ static void handle_descriptor_frame(const proto_frame_t *f)
             //     processed = (uint16_t)(processed + bl);
             // }
 
-            remote_desc_append(&s_remote_desc.config, chunk, cpy);
-            // Trim до wTotalLength, якщо відомо.
-            if (s_remote_desc.config.len >= 4)
+            cpy = remote_desc_config_append(chunk, cpy);
+            remote_desc_digest_feed(&s_remote_desc.digest, f->cmd, f->data, f->len);
+            bool config_done = remote_storage_config_appended();
+            LOGT("[DEV] config descriptor chunk len=%u total=%u",
+                 cpy, s_remote_desc.config.len);
+            if (config_done)
             {
-                uint16_t target = (uint16_t)s_remote_desc.config.data[2] |
-                                  ((uint16_t)s_remote_desc.config.data[3] << 8);
-                if (target && s_remote_desc.config.len > target)
-                {
-                    s_remote_desc.config.len = target;
-                }
+                maybe_complete_descriptors();
             }
-            LOGI("[DEV] config descriptor chunk len=%u total=%u",
-                 cpy, s_remote_desc.config.len);
-            maybe_complete_descriptors();
             break;
         }
 
@@ -384,14 +490,23 @@ static void handle_descriptor_frame(const proto_frame_t *f)
                     remote_desc_reset();
                     break;
                 }
+                if (s_remote_desc.report_parsed[itf])
+                {
+                    LOGT("[DEV] extra report chunk ignored itf=%u", itf);
+                    break;
+                }
                 // Позначаємо інтерфейс як присутній навіть якщо HID дескриптор з конфіга ще не розібрали.
                 s_remote_desc.hid_itf_present[itf] = true;
                 remote_desc_append(&s_remote_desc.reports[itf],
                                    &f->data[1],
                                    (uint16_t)(f->len - 1));
-                LOGI("[DEV] report descriptor chunk itf=%u len=%u total=%u",
+                remote_desc_digest_feed(&s_remote_desc.digest, f->cmd, f->data, f->len);
+                LOGT("[DEV] report descriptor chunk itf=%u len=%u total=%u",
                      itf, f->len - 1, s_remote_desc.reports[itf].len);
-                maybe_complete_descriptors();
+                if (remote_storage_report_appended(itf))
+                {
+                    maybe_complete_descriptors();
+                }
             }
             break;
 
@@ -440,13 +555,21 @@ static void handle_descriptor_frame(const proto_frame_t *f)
             }
             break;
 
+        case PF_DESC_SEGMENT:
+            handle_descriptor_segment(f);
+            break;
+
         case PF_DESC_DONE:
+            if (f->len)
+            {
+                handle_session_done(f);
+                break;
+            }
             LOGI("[DEV] descriptor transmission complete (reset pending)");
             s_remote_desc.descriptors_complete = true;
             // Готуємося до нового READY після повного комплекту дескрипторів.
             s_remote_desc.ready_sent = false;
-            remote_storage_analyze_report_descriptors();
-            remote_storage_update_string_allowlist();
+            remote_storage_finalize();
             maybe_complete_descriptors();
             start_tinyusb_if_ready();
             // Якщо стек уже запущений, одразу повідомляємо хост.
@@ -463,6 +586,133 @@ static void handle_descriptor_frame(const proto_frame_t *f)
     }
 }
 
+static void handle_descriptor_segment(const proto_frame_t *f)
+{
+    proto_desc_segment_t seg;
+    if (!proto_parse_desc_segment(f->data, f->len, &seg) || seg.session == 0)
+    {
+        LOGW("[DEV] malformed descriptor segment len=%u", f->len);
+        metric_inc(&m_desc_segments_dropped);
+        return;
+    }
+    if (s_remote_desc.usb_attached || s_remote_desc.descriptors_complete)
+    {
+        LOGT("[DEV] descriptor segment ignored session=%u (active session)", seg.session);
+        return;
+    }
+
+    if (seg.session != s_remote_desc.session.id)
+    {
+        // Whatever was assembled belongs to an older set.
+        remote_desc_reset();
+        desc_session_begin(&s_remote_desc.session, seg.session);
+        s_remote_desc.assembly_start_us = time_us_32();
+        LOGI("[DEV] starting descriptor session %u", seg.session);
+    }
+
+    if (!remote_desc_segment_store(&seg))
+    {
+        metric_inc(&m_desc_segments_dropped);
+        LOGT("[DEV] descriptor segment dropped cmd=%u itf=%u off=%u len=%u",
+             seg.desc_cmd, seg.itf, seg.offset, seg.len);
+        return;
+    }
+
+    switch (seg.desc_cmd)
+    {
+        case PF_DESC_DEVICE:
+            if (desc_ranges_complete(&s_remote_desc.session.device))
+            {
+                update_speed_from_device_desc();
+                if (remote_storage_device_stored())
+                {
+                    maybe_complete_descriptors();
+                }
+            }
+            break;
+
+        case PF_DESC_CONFIG:
+            LOGT("[DEV] config segment off=%u len=%u held=%u",
+                 seg.offset, seg.len, s_remote_desc.config.len);
+            if (remote_storage_config_appended())
+            {
+                maybe_complete_descriptors();
+            }
+            break;
+
+        case PF_DESC_REPORT:
+            s_remote_desc.hid_itf_present[seg.itf] = true;
+            LOGT("[DEV] report segment itf=%u off=%u len=%u held=%u",
+                 seg.itf, seg.offset, seg.len, s_remote_desc.reports[seg.itf].len);
+            if (remote_storage_report_appended(seg.itf))
+            {
+                maybe_complete_descriptors();
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+// DONE with a manifest. A complete set goes the legacy DONE way; otherwise
+// B_host gets the gap list and answers with just those bytes and another DONE.
+static void handle_session_done(const proto_frame_t *f)
+{
+    desc_manifest_t m;
+    if (!desc_session_parse_manifest(f->data, f->len, &m))
+    {
+        LOGW("[DEV] malformed descriptor manifest len=%u", f->len);
+        return;
+    }
+
+    if (!s_remote_desc.usb_attached && !s_remote_desc.descriptors_complete)
+    {
+        if (m.session != s_remote_desc.session.id)
+        {
+            // Every segment was lost (or we rebooted): the gap list is the whole set.
+            remote_desc_reset();
+            desc_session_begin(&s_remote_desc.session, m.session);
+            s_remote_desc.assembly_start_us = time_us_32();
+        }
+        desc_session_apply_manifest(&s_remote_desc.session, &m);
+        if (!desc_session_complete(&s_remote_desc.session))
+        {
+            send_desc_status(&s_remote_desc.session);
+            return;
+        }
+    }
+
+    LOGI("[DEV] descriptor session %u complete", m.session);
+    s_remote_desc.descriptors_complete = true;
+    s_remote_desc.ready_sent = false;
+    remote_storage_finalize();
+    maybe_complete_descriptors();
+    start_tinyusb_if_ready();
+    if (s_remote_desc.usb_attached)
+    {
+        notify_host_ready();
+    }
+}
+
+static void send_desc_status(desc_session_t const* session)
+{
+    uint8_t payload[PROTO_MAX_PAYLOAD_SIZE];
+    uint16_t len = desc_session_build_status(session, payload, sizeof(payload));
+    uint8_t buf[PROTO_MAX_FRAME_SIZE];
+    int out = len ? proto_build_ctrl_desc_status(payload, len, buf, sizeof(buf)) : -1;
+    if (out <= 0 || uart_transport_device_send(buf, (uint16_t)out) < 0)
+    {
+        LOGW("[DEV] failed to send DESC_STATUS session=%u", session->id);
+        return;
+    }
+    host_irq_pulse();
+    metric_inc(&m_desc_status_sent);
+    enum_trace_record(ET_DESC_GAPS_SENT, payload[2]);
+    LOGI("[DEV] descriptor session %u incomplete, %u gap(s)%s requested",
+         session->id, payload[2], (payload[1] & PROTO_DESC_STATUS_MORE) ? " (more)" : "");
+}
+
 static void handle_control_frame(const proto_frame_t *f)
 {
     switch (f->cmd)
@@ -517,6 +767,25 @@ static void handle_control_frame(const proto_frame_t *f)
             handle_device_reset_request(f->len ? f->data[0] : 0);
             break;
 
+        case PF_CTRL_TRACE_REQ:
+            if (f->len >= 4)
+            {
+                uint32_t host_us = (uint32_t)f->data[0] |
+                                   ((uint32_t)f->data[1] << 8) |
+                                   ((uint32_t)f->data[2] << 16) |
+                                   ((uint32_t)f->data[3] << 24);
+                send_trace_pages(host_us);
+            }
+            break;
+
+        case PF_CTRL_STATS_REQ:
+            send_stats_snapshot();
+            break;
+
+        case PF_CTRL_METRICS_REQ:
+            send_metrics_pages();
+            break;
+
         default:
             LOGW("[DEV] control cmd=%u len=%u ignored", f->cmd, f->len);
             break;
@@ -527,6 +796,12 @@ static void handle_device_reset_request(uint8_t reason)
 {
     LOGI("[DEV] DEVICE_RESET request reason=%u", reason);
 
+    if (s_replug.active)
+    {
+        // B_host gave up on the held session: do the teardown PF_UNMOUNT deferred.
+        replug_abort("device reset");
+    }
+
     bool descriptors_ready = s_remote_desc.descriptors_complete;
     tinyusb_restart();
     if (!descriptors_ready)
@@ -538,9 +813,248 @@ static void handle_device_reset_request(uint8_t reason)
 static void handle_unmount_frame(void)
 {
     LOGI("[DEV] remote device unmounted");
+    if (s_replug.active)
+    {
+        // B_host sends one UNMOUNT per interface; the first one started the hold.
+        return;
+    }
+    if (PROXY_REPLUG_GRACE_MS > 0 &&
+        s_remote_desc.usb_attached &&
+        s_remote_desc.descriptors_complete)
+    {
+        replug_begin();
+        return;
+    }
     remote_desc_reset();
 }
 
+static void replug_begin(void)
+{
+    s_replug.active      = true;
+    s_replug.device_seen = false;
+    s_replug.start_ms    = board_millis();
+    s_replug.deadline_ms = s_replug.start_ms + PROXY_REPLUG_GRACE_MS;
+    remote_desc_digest_reset(&s_replug.candidate);
+    desc_session_begin(&s_replug.session, 0);
+
+    // Input is gated on READY; clearing it drops PF_INPUT until the set is verified.
+    s_remote_desc.ready_sent = false;
+
+    // Release whatever was held down when the cable was pulled.
+    static const uint8_t zeros[sizeof(((pending_report_t*)0)->data)] = { 0 };
+    for (uint8_t itf = 0; itf < CFG_TUD_HID; itf++)
+    {
+        report_shape_t const* shape = &s_last_report_shape[itf];
+        if (shape->len == 0) continue;
+
+        pending_report_t* p = &s_pending_reports[itf];
+        p->valid     = true;
+        p->has_id    = shape->has_id;
+        p->report_id = shape->report_id;
+        p->len       = shape->len;
+        p->rx_us     = 0;
+        memcpy(p->data, zeros, shape->len);
+    }
+
+    LOGI("[DEV] re-plug hold: keeping USB attached for %u ms", (unsigned)PROXY_REPLUG_GRACE_MS);
+}
+
+static void replug_abort(const char* why)
+{
+    LOGI("[DEV] re-plug hold ended (%s), full teardown", why);
+    s_replug.active = false;
+    remote_desc_reset();
+}
+
+// Live copy of the descriptor a segment addresses; NULL when there is none.
+static uint8_t const* replug_live_desc(uint8_t desc_cmd, uint8_t itf, uint16_t* len)
+{
+    switch (desc_cmd)
+    {
+        case PF_DESC_DEVICE:
+            *len = s_remote_desc.device.len;
+            return s_remote_desc.device.data;
+        case PF_DESC_CONFIG:
+            *len = s_remote_desc.config.len;
+            return s_remote_desc.config.data;
+        case PF_DESC_REPORT:
+            if (itf >= CFG_TUD_HID || !s_remote_desc.reports[itf].valid)
+            {
+                return NULL;
+            }
+            *len = s_remote_desc.reports[itf].len;
+            return s_remote_desc.reports[itf].data;
+        default:
+            return NULL;
+    }
+}
+
+static bool replug_segment_matches(proto_desc_segment_t const* seg)
+{
+    uint16_t live_len = 0;
+    uint8_t const* live = replug_live_desc(seg->desc_cmd, seg->itf, &live_len);
+    return live && seg->total == live_len &&
+           memcmp(&live[seg->offset], seg->data, seg->len) == 0;
+}
+
+static bool replug_manifest_matches(desc_manifest_t const* m)
+{
+    if (m->device_total != s_remote_desc.device.len ||
+        m->config_total != s_remote_desc.config.len)
+    {
+        return false;
+    }
+    for (uint8_t i = 0; i < CFG_TUD_HID && i < DESC_SESSION_MAX_REPORTS; i++)
+    {
+        bool announced = (m->report_mask & (1u << i)) != 0;
+        if (announced != s_remote_desc.reports[i].valid ||
+            (announced && m->report_total[i] != s_remote_desc.reports[i].len))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Session flavour of the re-plug check; same contract as below.
+static bool replug_handle_session_frame(const proto_frame_t *f)
+{
+    if (f->cmd == PF_DESC_SEGMENT)
+    {
+        proto_desc_segment_t seg;
+        if (!proto_parse_desc_segment(f->data, f->len, &seg) || seg.session == 0)
+        {
+            return true;
+        }
+        if (!replug_segment_matches(&seg))
+        {
+            // The normal path starts the new set from this segment; anything
+            // verified so far comes back through the gap list.
+            replug_abort("descriptor bytes differ");
+            return false;
+        }
+        if (seg.session != s_replug.session.id)
+        {
+            desc_session_begin(&s_replug.session, seg.session);
+            s_replug.device_seen = true;
+            s_replug.deadline_ms = board_millis() + PROXY_REPLUG_GRACE_MS;
+        }
+        (void)desc_session_note(&s_replug.session, &seg);
+        return true;
+    }
+
+    desc_manifest_t m;
+    if (!desc_session_parse_manifest(f->data, f->len, &m))
+    {
+        return true;
+    }
+    if (!replug_manifest_matches(&m))
+    {
+        replug_abort("descriptor set differs");
+        return false;
+    }
+    if (m.session != s_replug.session.id)
+    {
+        desc_session_begin(&s_replug.session, m.session);
+    }
+    desc_session_apply_manifest(&s_replug.session, &m);
+    if (!desc_session_complete(&s_replug.session))
+    {
+        s_replug.deadline_ms = board_millis() + PROXY_REPLUG_GRACE_MS;
+        send_desc_status(&s_replug.session);
+        return true;
+    }
+
+    s_replug.active = false;
+    enum_trace_record(ET_REPLUG_RESUME, 0);
+    LOGI("[DEV] re-plug matched, resuming after %lu ms without re-enumeration",
+         (unsigned long)(board_millis() - s_replug.start_ms));
+    notify_host_ready();
+    return true;
+}
+
+// Returns true when the frame was consumed by the re-plug verifier. On a
+// device-descriptor mismatch the hold is dropped and the frame falls through
+// to the normal path, which starts a fresh set from it.
+static bool replug_handle_descriptor_frame(const proto_frame_t *f)
+{
+    if (f->cmd == PF_DESC_SEGMENT || (f->cmd == PF_DESC_DONE && f->len))
+    {
+        return replug_handle_session_frame(f);
+    }
+
+    switch (f->cmd)
+    {
+        case PF_DESC_DEVICE:
+            if (f->len != s_remote_desc.device.len ||
+                memcmp(f->data, s_remote_desc.device.data, f->len) != 0)
+            {
+                replug_abort("different device");
+                return false;
+            }
+            remote_desc_digest_reset(&s_replug.candidate);
+            remote_desc_digest_feed(&s_replug.candidate, f->cmd, f->data, f->len);
+            s_replug.device_seen = true;
+            // Give the rest of the set a full window from here.
+            s_replug.deadline_ms = board_millis() + PROXY_REPLUG_GRACE_MS;
+            return true;
+
+        case PF_DESC_CONFIG:
+        case PF_DESC_REPORT:
+            if (s_replug.device_seen)
+            {
+                remote_desc_digest_feed(&s_replug.candidate, f->cmd, f->data, f->len);
+            }
+            return true;
+
+        case PF_DESC_DONE:
+        {
+            if (!s_replug.device_seen)
+            {
+                return true;
+            }
+
+            if (!remote_desc_digest_equal(&s_replug.candidate, &s_remote_desc.digest))
+            {
+                // Same VID/PID but different config/report bytes. The set was
+                // only digested, so ask B_host to send it again after teardown.
+                replug_abort("descriptor digest mismatch");
+                uint8_t buf[PROTO_MAX_FRAME_SIZE];
+                int out = proto_build_ctrl_desc_resend(buf, sizeof(buf));
+                if (out > 0 && uart_transport_device_send(buf, (uint16_t)out) >= 0)
+                {
+                    host_irq_pulse();
+                    LOGI("[DEV] DESC_RESEND requested");
+                }
+                else
+                {
+                    LOGW("[DEV] failed to send DESC_RESEND");
+                }
+                return true;
+            }
+
+            s_replug.active = false;
+            enum_trace_record(ET_REPLUG_RESUME, 0);
+            LOGI("[DEV] re-plug matched, resuming after %lu ms without re-enumeration",
+                 (unsigned long)(board_millis() - s_replug.start_ms));
+            notify_host_ready();
+            return true;
+        }
+
+        default:
+            // Strings go to the cache as usual; the PC may ask for them any time.
+            return false;
+    }
+}
+
+static void replug_task(void)
+{
+    if (s_replug.active && (int32_t)(board_millis() - s_replug.deadline_ms) >= 0)
+    {
+        replug_abort("grace window expired");
+    }
+}
+
 static void notify_host_ready(void)
 {
     if (s_remote_desc.ready_sent) return;
@@ -561,10 +1075,107 @@ static void notify_host_ready(void)
     }
 
     s_remote_desc.ready_sent = true;
+    enum_trace_record(ET_READY_SENT, 0);
     host_irq_pulse();
     LOGI("[DEV] READY control frame queued");
 }
 
+// Whole ring goes back in one burst. Each page stamps dev_us at build time;
+// B_host aligns clocks with the first page, which has the shortest queueing.
+static void send_trace_pages(uint32_t host_us)
+{
+    uint16_t total = enum_trace_count();
+    uint16_t start = 0;
+    do
+    {
+        uint8_t entries[PROTO_TRACE_PAGE_ENTRIES * ENUM_TRACE_WIRE_SIZE];
+        uint16_t n = enum_trace_encode(start, entries, PROTO_TRACE_PAGE_ENTRIES);
+
+        uint8_t buf[PROTO_MAX_FRAME_SIZE];
+        int out = proto_build_ctrl_trace_data(host_us, time_us_32(),
+                                              (uint8_t)total, (uint8_t)start,
+                                              entries, (uint8_t)n,
+                                              buf, sizeof(buf));
+        if (out <= 0 || uart_transport_device_send(buf, (uint16_t)out) < 0)
+        {
+            LOGW("[DEV] failed to send trace page start=%u", start);
+            break;
+        }
+        start = (uint16_t)(start + n);
+    } while (start < total);
+
+    host_irq_pulse();
+    LOGI("[DEV] enumeration trace sent entries=%u", total);
+}
+
+// Відповідь на PF_CTRL_STATS_REQ: B_host вкладає знімок у телеметрію.
+static void send_stats_snapshot(void)
+{
+    uart_transport_stats_t link;
+    uart_transport_get_stats(&link);
+
+    proto_dev_stats_t st;
+    st.dev_us                  = time_us_32();
+    st.input_received          = metric_value(&m_input_received);
+    st.input_dropped_not_ready = metric_value(&m_input_dropped_not_ready);
+    st.latency_min_ms          = (s_latency_min_ms == UINT32_MAX) ? 0 : s_latency_min_ms;
+    st.latency_max_ms          = s_latency_max_ms;
+    st.crc_errors              = proto_crc_error_count();
+    st.rx_ring_overflow        = link.rx_ring_overflow;
+    st.rx_frame_overflow       = link.rx_frame_overflow;
+    st.rx_ring_high_water      = link.rx_ring_high_water;
+    st.pending_reports         = 0;
+    for (uint8_t itf = 0; itf < CFG_TUD_HID; itf++)
+    {
+        if (s_pending_reports[itf].valid) st.pending_reports++;
+    }
+
+    uint8_t buf[PROTO_MAX_FRAME_SIZE];
+    int out = proto_build_ctrl_stats_data(&st, buf, sizeof(buf));
+    if (out <= 0 || uart_transport_device_send(buf, (uint16_t)out) < 0)
+    {
+        LOGW("[DEV] failed to send stats snapshot");
+        return;
+    }
+    host_irq_pulse();
+}
+
+static void dev_metrics_collect(void)
+{
+    uint32_t pending = 0;
+    for (uint8_t itf = 0; itf < CFG_TUD_HID; itf++)
+    {
+        if (s_pending_reports[itf].valid) pending++;
+    }
+    metric_set(&m_pending_reports, pending);
+}
+
+// Відповідь на PF_CTRL_METRICS_REQ: весь реєстр сторінками, B_host збирає їх у кеш.
+static void send_metrics_pages(void)
+{
+    uint8_t total = metrics_count();
+    uint8_t start = 0;
+    do
+    {
+        uint8_t entries[PROTO_MAX_PAYLOAD_SIZE - PROTO_METRICS_DATA_HDR];
+        uint8_t n = 0;
+        uint16_t used = metrics_encode(start, entries, sizeof(entries), &n);
+
+        uint8_t buf[PROTO_MAX_FRAME_SIZE];
+        int out = proto_build_ctrl_metrics_data(time_us_32(), total, start,
+                                                entries, n, used, buf, sizeof(buf));
+        if (out <= 0 || uart_transport_device_send(buf, (uint16_t)out) < 0)
+        {
+            LOGW("[DEV] failed to send metrics page start=%u", start);
+            break;
+        }
+        if (!n) break;
+        start = (uint8_t)(start + n);
+    } while (start < total);
+
+    host_irq_pulse();
+}
+
 // ------------------------------------------------------
 // Initialization
 // ------------------------------------------------------
@@ -572,6 +1183,20 @@ static void notify_host_ready(void)
 void hid_proxy_dev_init(void)
 {
     LOGI("[DEV] init");
+    metrics_register(&m_input_received);
+    metrics_register(&m_input_dropped_not_ready);
+    metrics_register(&m_input_delivered);
+    metrics_register(&m_input_interval_us);
+    metrics_register(&m_input_latency_ms);
+    metrics_register(&m_pending_reports);
+    metrics_register(&m_desc_segments_dropped);
+    metrics_register(&m_desc_status_sent);
+    for (uint8_t i = 0; i < TU_ARRAY_SIZE(s_itf_deliver_us); i++)
+    {
+        metrics_register(s_itf_deliver_us[i]);
+    }
+    metrics_add_collector(dev_metrics_collect);
+    enum_trace_init(ET_BOARD_A);
     remote_desc_reset();
 
     // 1. Configure the transport: device side uses the dedicated UART link
@@ -591,6 +1216,7 @@ void hid_proxy_dev_task(void)
 void hid_proxy_dev_service(void)
 {
     process_proto_frames();
+    replug_task();
     flush_pending_reports();
 }
 
@@ -703,6 +1329,9 @@ static void flush_pending_reports(void)
             continue;
         }
         p->valid = false;
+        s_report_inflight_us[itf] = p->rx_us;
+        metric_inc(&m_input_delivered);
+        enum_trace_record_once(ET_FIRST_INPUT_DELIVERED, itf);
     }
 }
 
@@ -752,7 +1381,7 @@ static void process_proto_frames(void)
                     {
                         LOGT("[DEV] PF_INPUT len=%u", f.len);
                     }
-                    s_input_received++;
+                    metric_inc(&m_input_received);
 
                     if (!s_remote_desc.usb_attached)
                     {
@@ -760,7 +1389,7 @@ static void process_proto_frames(void)
                         {
                             LOGT("[DEV] HID stack not started yet, dropping input");
                         }
-                        s_input_dropped_not_ready++;
+                        metric_inc(&m_input_dropped_not_ready);
                         break;
                     }
 
@@ -770,7 +1399,7 @@ static void process_proto_frames(void)
                         {
                             LOGT("[DEV] HID NOT READY (descriptors incomplete), dropping");
                         }
-                        s_input_dropped_not_ready++;
+                        metric_inc(&m_input_dropped_not_ready);
                         break;
                     }
 
@@ -781,7 +1410,7 @@ static void process_proto_frames(void)
                             // Поки TinyUSB не готовий, просто ігноруємо трафік, щоб не заважати enumeration.
                             LOGT("[DEV] HID NOT READY (enumeration not complete), dropping");
                         }
-                        s_input_dropped_not_ready++;
+                        metric_inc(&m_input_dropped_not_ready);
                         // LOGW("[DEV] HID NOT READY (enumeration not complete), sending anyway");
                         break;
                     }
@@ -794,6 +1423,12 @@ static void process_proto_frames(void)
 
                     // Лог інтервалів/дропів раз на ~500 подій або раз на 5 сек
                     uint32_t now_ms = board_millis();
+                    uint32_t now_us = time_us_32();
+                    if (s_input_last_us != 0)
+                    {
+                        metric_observe(&m_input_interval_us, now_us - s_input_last_us);
+                    }
+                    s_input_last_us = now_us;
                     if (s_input_last_ts_ms != 0)
                     {
                         uint32_t delta = now_ms - s_input_last_ts_ms;
@@ -829,17 +1464,19 @@ static void process_proto_frames(void)
                     {
                         latency = 0;
                     }
+                    metric_observe(&m_input_latency_ms, latency);
                     if (latency < s_latency_min_ms) s_latency_min_ms = latency;
                     if (latency > s_latency_max_ms) s_latency_max_ms = latency;
 
-                    if ((s_input_received % 500 == 0) ||
+                    uint32_t received = metric_value(&m_input_received);
+                    if ((received % 500 == 0) ||
                         (now_ms - s_input_last_log_ms > 5000))
                     {
                         uint32_t min_d = (s_input_min_delta_ms == UINT32_MAX) ? 0 : s_input_min_delta_ms;
                         uint32_t min_lat = (s_latency_min_ms == UINT32_MAX) ? 0 : s_latency_min_ms;
                         LOGI("[DEV] PF_INPUT stats: received=%lu dropped_not_ready=%lu min_dt=%lu max_dt=%lu lat_min=%lu lat_max=%lu",
-                             (unsigned long)s_input_received,
-                             (unsigned long)s_input_dropped_not_ready,
+                             (unsigned long)received,
+                             (unsigned long)metric_value(&m_input_dropped_not_ready),
                              (unsigned long)min_d,
                              (unsigned long)s_input_max_delta_ms,
                              (unsigned long)min_lat,
@@ -869,7 +1506,24 @@ static void process_proto_frames(void)
                         payload_len--;
                     }
 
-                    if (!tud_hid_n_report(itf_id, report_id, payload, payload_len))
+                    if (itf_id < CFG_TUD_HID)
+                    {
+                        s_last_report_shape[itf_id].has_id    = has_id;
+                        s_last_report_shape[itf_id].report_id = report_id;
+                        s_last_report_shape[itf_id].len       =
+                            payload_len <= sizeof(s_pending_reports[0].data) ? payload_len : 0;
+                    }
+
+                    if (tud_hid_n_report(itf_id, report_id, payload, payload_len))
+                    {
+                        if (itf_id < CFG_TUD_HID)
+                        {
+                            s_report_inflight_us[itf_id] = now_us ? now_us : 1u;
+                        }
+                        metric_inc(&m_input_delivered);
+                        enum_trace_record_once(ET_FIRST_INPUT_DELIVERED, itf_id);
+                    }
+                    else
                     {
                         pending_report_t* p = &s_pending_reports[itf_id];
                         if (payload_len <= sizeof(p->data))
@@ -878,6 +1532,7 @@ static void process_proto_frames(void)
                             p->has_id   = has_id;
                             p->report_id = report_id;
                             p->len      = payload_len;
+                            p->rx_us    = now_us ? now_us : 1u;
                             memcpy(p->data, payload, payload_len);
                             LOGT("[DEV] tud_hid_report busy, queued itf=%u len=%u", itf_id, payload_len);
                         }
@@ -933,6 +1588,7 @@ bool hid_proxy_dev_usb_ready(void)
 void tud_mount_cb(void)
 {
     LOGI("[DEV] tud_mount_cb (USB device mounted by host)");
+    enum_trace_record(ET_TUD_MOUNT, 0);
     notify_host_ready();
 }
 
@@ -952,6 +1608,22 @@ void tud_resume_cb(void)
     LOGI("[DEV] tud_resume_cb");
 }
 
+void tud_hid_report_complete_cb(uint8_t instance, uint8_t const* report, uint16_t len)
+{
+    (void)report;
+    (void)len;
+    if (instance >= CFG_TUD_HID || !s_report_inflight_us[instance])
+    {
+        return;
+    }
+    uint32_t waited = time_us_32() - s_report_inflight_us[instance];
+    s_report_inflight_us[instance] = 0;
+    if (instance < TU_ARRAY_SIZE(s_itf_deliver_us))
+    {
+        metric_observe(s_itf_deliver_us[instance], waited);
+    }
+}
+
 void tud_hid_set_protocol_cb(uint8_t instance, uint8_t protocol)
 {
     uint8_t buf[PROTO_MAX_FRAME_SIZE];
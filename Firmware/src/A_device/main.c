@@ -1,13 +1,17 @@
+#define LOG_MODULE LOG_MOD_DEV
+
 #include "pico/stdlib.h"
 #include "bsp/board.h"
 #include "tusb.h"
 #include "hid_proxy_dev.h"
 #include "logging.h"
+#include "metrics.h"
 
 int main(void)
 {
     stdio_init_all();
     board_init();
+    metrics_init();           // Spin lock for metric updates, before any module counts
     hid_proxy_dev_init();     // Initialize UART transport; TinyUSB starts after descriptors are received
 
     LOGI("[BOOT] A_device starting...");
@@ -20,6 +24,8 @@ int main(void)
         {
             tud_task();       // TinyUSB device state machine (once started)
         }
+
+        logging_task();       // Deferred log output, one entry per pass
     }
 
     return 0;
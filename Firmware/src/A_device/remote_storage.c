@@ -1,20 +1,30 @@
+#define LOG_MODULE LOG_MOD_DEV
+
 #include "remote_storage.h"
 
 #include <string.h>
 
 #include "hid_proxy_dev.h"
+#include "desc_transform.h"
+#include "proto_frame.h"
 #include "tusb.h"
+#include "pico/time.h"
 #include "logging.h"
 
 #ifndef TUSB_DESC_HID
 #define TUSB_DESC_HID 0x21
 #endif
 
+#define DIGEST_FNV_OFFSET 2166136261u
+#define DIGEST_FNV_PRIME  16777619u
+
 remote_desc_state_t s_remote_desc;
+static uint8_t s_config_arena[PROXY_MAX_CONFIG_DESC_SIZE];
 
 void remote_storage_init_defaults(void)
 {
     memset(&s_remote_desc, 0, sizeof(s_remote_desc));
+    s_remote_desc.config.data = s_config_arena;
     s_remote_desc.usb_speed = TUSB_SPEED_FULL;
     for (uint8_t i = 0; i < CFG_TUD_HID; i++)
     {
@@ -23,6 +33,83 @@ void remote_storage_init_defaults(void)
         s_remote_desc.hid_itf_present[i] = false;
     }
     s_remote_desc.lang.allow_fetch = true;
+    remote_desc_digest_reset(&s_remote_desc.digest);
+}
+
+static uint32_t digest_fnv1a(uint32_t h, uint8_t const* data, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; i++)
+    {
+        h ^= data[i];
+        h *= DIGEST_FNV_PRIME;
+    }
+    return h;
+}
+
+void remote_desc_digest_reset(remote_desc_digest_t* d)
+{
+    if (!d) return;
+    memset(d, 0, sizeof(*d));
+    d->device = DIGEST_FNV_OFFSET;
+    d->config = DIGEST_FNV_OFFSET;
+    for (uint8_t i = 0; i < CFG_TUD_HID; i++)
+    {
+        d->reports[i] = DIGEST_FNV_OFFSET;
+    }
+}
+
+void remote_desc_digest_feed(remote_desc_digest_t* d,
+                             uint8_t desc_cmd,
+                             uint8_t const* data,
+                             uint16_t len)
+{
+    if (!d || !data || !len) return;
+
+    switch (desc_cmd)
+    {
+        case PF_DESC_DEVICE:
+            // Device descriptor always travels in one frame; a duplicate replaces it.
+            d->device = digest_fnv1a(DIGEST_FNV_OFFSET, data, len);
+            break;
+
+        case PF_DESC_CONFIG:
+            d->config = digest_fnv1a(d->config, data, len);
+            d->config_len = (uint16_t)(d->config_len + len);
+            break;
+
+        case PF_DESC_REPORT:
+            // Payload starts with the interface number.
+            if (len > 1 && data[0] < CFG_TUD_HID)
+            {
+                d->reports[data[0]] = digest_fnv1a(d->reports[data[0]], &data[1], (uint16_t)(len - 1));
+                d->report_len[data[0]] = (uint16_t)(d->report_len[data[0]] + len - 1);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+bool remote_desc_digest_equal(remote_desc_digest_t const* a,
+                              remote_desc_digest_t const* b)
+{
+    if (!a || !b) return false;
+    if (a->device != b->device ||
+        a->config != b->config ||
+        a->config_len != b->config_len)
+    {
+        return false;
+    }
+    for (uint8_t i = 0; i < CFG_TUD_HID; i++)
+    {
+        if (a->reports[i] != b->reports[i] ||
+            a->report_len[i] != b->report_len[i])
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
 void remote_desc_append(remote_desc_buffer_t* buf,
@@ -49,6 +136,94 @@ void remote_desc_append(remote_desc_buffer_t* buf,
     buf->valid = true;
 }
 
+uint16_t remote_desc_config_append(uint8_t const* data, uint16_t len)
+{
+    remote_desc_arena_buffer_t* buf = &s_remote_desc.config;
+    if (!data || !len)
+    {
+        return 0;
+    }
+
+    uint32_t need = (uint32_t)buf->len + len;
+    if (need > sizeof(s_config_arena))
+    {
+        LOGW("[DEV] config arena overflow (len=%lu cap=%u)", (unsigned long)need, (unsigned)sizeof(s_config_arena));
+        len = (uint16_t)(sizeof(s_config_arena) - buf->len);
+        if (len == 0)
+        {
+            return 0;
+        }
+    }
+
+    memcpy(&buf->data[buf->len], data, len);
+    buf->len  += len;
+    buf->valid = true;
+    return len;
+}
+
+bool remote_desc_segment_store(proto_desc_segment_t const* seg)
+{
+    uint8_t* dst;
+    uint16_t cap;
+    uint16_t* len_field;
+    bool* valid;
+
+    switch (seg->desc_cmd)
+    {
+        case PF_DESC_DEVICE:
+            dst = s_remote_desc.device.data;
+            cap = sizeof(s_remote_desc.device.data);
+            len_field = &s_remote_desc.device.len;
+            valid = &s_remote_desc.device.valid;
+            break;
+
+        case PF_DESC_CONFIG:
+            dst = s_remote_desc.config.data;
+            cap = (uint16_t)sizeof(s_config_arena);
+            len_field = &s_remote_desc.config.len;
+            valid = &s_remote_desc.config.valid;
+            break;
+
+        case PF_DESC_REPORT:
+            if (seg->itf >= CFG_TUD_HID)
+            {
+                return false;
+            }
+            dst = s_remote_desc.reports[seg->itf].data;
+            cap = sizeof(s_remote_desc.reports[seg->itf].data);
+            len_field = &s_remote_desc.reports[seg->itf].len;
+            valid = &s_remote_desc.reports[seg->itf].valid;
+            break;
+
+        default:
+            return false;
+    }
+
+    if (!desc_session_note(&s_remote_desc.session, seg))
+    {
+        return false;
+    }
+
+    // Bytes past our buffer count as held: the truncated copy is all we keep,
+    // as with in-order chunks.
+    if (seg->offset < cap)
+    {
+        uint16_t n = seg->len;
+        if (n > cap - seg->offset) n = (uint16_t)(cap - seg->offset);
+        memcpy(&dst[seg->offset], seg->data, n);
+    }
+
+    uint16_t prefix = desc_ranges_prefix(desc_session_slot(&s_remote_desc.session, seg->desc_cmd, seg->itf));
+    *len_field = prefix < cap ? prefix : cap;
+    *valid = *len_field != 0;
+    return true;
+}
+
+uint16_t remote_storage_config_capacity(void)
+{
+    return (uint16_t)sizeof(s_config_arena);
+}
+
 remote_string_desc_t* remote_desc_get_string_entry(uint8_t index)
 {
     if (index == 0)
@@ -250,6 +425,163 @@ void remote_storage_analyze_report_descriptors(void)
     }
 }
 
+// ---------------------------------------------------------
+// Incremental assembly
+//
+// Chunks only append bytes; each descriptor is parsed exactly once, when the
+// length announced for it is reached (wTotalLength for the configuration,
+// wDescriptorLength from the HID descriptor for report descriptors).
+// ---------------------------------------------------------
+
+static bool config_is_complete(void)
+{
+    uint16_t target = s_remote_desc.config_expected_len;
+    if (!s_remote_desc.config.valid || target == 0)
+    {
+        return false;
+    }
+    // wTotalLength beyond our buffer: the truncated copy is all we will get.
+    return s_remote_desc.config.len >= target ||
+           s_remote_desc.config.len >= sizeof(s_config_arena);
+}
+
+static bool report_try_finalize(uint8_t itf)
+{
+    if (itf >= CFG_TUD_HID || s_remote_desc.report_parsed[itf])
+    {
+        return false;
+    }
+
+    remote_desc_buffer_t const* rep = &s_remote_desc.reports[itf];
+    uint16_t expect = s_remote_desc.hid_report_expected_len[itf];
+    if (!rep->valid || !s_remote_desc.config_parsed || expect == 0)
+    {
+        return false;
+    }
+    if (rep->len < expect && rep->len < PROXY_MAX_DESC_SIZE)
+    {
+        return false;
+    }
+
+    uint32_t t0 = time_us_32();
+    analyze_single_report(itf, rep);
+    s_remote_desc.report_parsed[itf] = true;
+    s_remote_desc.assembly_parse_us += time_us_32() - t0;
+    LOGI("[DEV] report descriptor complete itf=%u len=%u", itf, rep->len);
+    return true;
+}
+
+static void parse_config_once(void)
+{
+    uint32_t t0 = time_us_32();
+    parse_config_for_strings();
+    s_remote_desc.config_parsed = true;
+
+    // Reports that arrived ahead of the configuration keep their interface.
+    for (uint8_t i = 0; i < CFG_TUD_HID; i++)
+    {
+        if (s_remote_desc.reports[i].valid)
+        {
+            s_remote_desc.hid_itf_present[i] = true;
+        }
+    }
+    s_remote_desc.assembly_parse_us += time_us_32() - t0;
+    LOGI("[DEV] config descriptor complete len=%u", s_remote_desc.config.len);
+
+    // Expected report lengths are known now; finish anything already buffered.
+    for (uint8_t i = 0; i < CFG_TUD_HID; i++)
+    {
+        (void)report_try_finalize(i);
+    }
+}
+
+bool remote_storage_device_stored(void)
+{
+    if (s_remote_desc.device_parsed ||
+        !s_remote_desc.device.valid ||
+        s_remote_desc.device.len < sizeof(tusb_desc_device_t))
+    {
+        return false;
+    }
+
+    uint32_t t0 = time_us_32();
+    tusb_desc_device_t const* dev =
+        (tusb_desc_device_t const*)s_remote_desc.device.data;
+    mark_string_index(dev->iManufacturer);
+    mark_string_index(dev->iProduct);
+    mark_string_index(dev->iSerialNumber);
+    s_remote_desc.device_parsed = true;
+    s_remote_desc.assembly_parse_us += time_us_32() - t0;
+    return true;
+}
+
+bool remote_storage_config_appended(void)
+{
+    remote_desc_arena_buffer_t* cfg = &s_remote_desc.config;
+    s_remote_desc.assembly_chunks++;
+
+    if (s_remote_desc.config_expected_len == 0 && cfg->len >= 4)
+    {
+        uint16_t target = (uint16_t)cfg->data[2] | ((uint16_t)cfg->data[3] << 8);
+        s_remote_desc.config_expected_len = target;
+        if (target > sizeof(s_config_arena))
+        {
+            LOGW("[DEV] config wTotalLength=%u exceeds arena (%u), will truncate",
+                 target, (unsigned)sizeof(s_config_arena));
+        }
+    }
+
+    // Trim до wTotalLength, якщо відомо.
+    uint16_t target = s_remote_desc.config_expected_len;
+    if (target && cfg->len > target)
+    {
+        cfg->len = target;
+    }
+
+    if (s_remote_desc.config_parsed || !config_is_complete())
+    {
+        return false;
+    }
+
+    parse_config_once();
+    return true;
+}
+
+bool remote_storage_report_appended(uint8_t itf)
+{
+    s_remote_desc.assembly_chunks++;
+    return report_try_finalize(itf);
+}
+
+bool remote_storage_config_complete(void)
+{
+    return s_remote_desc.config_parsed;
+}
+
+void remote_storage_finalize(void)
+{
+    (void)remote_storage_device_stored();
+
+    if (!s_remote_desc.config_parsed && s_remote_desc.config.valid)
+    {
+        parse_config_once();
+    }
+
+    // Report descriptors whose length was never announced: take what we have.
+    for (uint8_t i = 0; i < CFG_TUD_HID; i++)
+    {
+        remote_desc_buffer_t const* rep = &s_remote_desc.reports[i];
+        if (s_remote_desc.report_parsed[i] || !rep->valid)
+        {
+            continue;
+        }
+        uint32_t t0 = time_us_32();
+        analyze_single_report(i, rep);
+        s_remote_desc.report_parsed[i] = true;
+        s_remote_desc.assembly_parse_us += time_us_32() - t0;
+    }
+}
+
 bool hid_proxy_dev_get_device_descriptor(uint8_t const** out_data,
                                          uint16_t *out_len)
 {
@@ -291,25 +623,55 @@ bool hid_proxy_dev_get_device_descriptor(uint8_t const** out_data,
 bool hid_proxy_dev_get_config_descriptor(uint8_t const** out_data,
                                          uint16_t *out_len)
 {
-    static uint8_t patched_cfg[PROXY_MAX_DESC_SIZE];
-
     if (!s_remote_desc.config.valid ||
         s_remote_desc.config.len < sizeof(tusb_desc_configuration_t))
     {
         return false;
     }
 
-    uint16_t len = s_remote_desc.config.len;
-    if (len > sizeof(patched_cfg))
+    // Rebuilt on every call (a few per enumeration, O(len)): nothing to
+    // invalidate when the set changes. The arena keeps the device's bytes, so
+    // the re-plug digest and resumable sessions compare what was received.
+    static uint8_t s_presented_cfg[PROXY_MAX_CONFIG_DESC_SIZE];
+
+#if PROXY_DESC_XFORM
+    static desc_transform_result_t s_last_xform;
+    static uint16_t s_last_xform_len = 0;
+
+    desc_transform_rules_t rules;
+    desc_transform_result_t res;
+    desc_transform_default_rules(&rules);
+    uint16_t xlen = desc_transform_config(&rules,
+                                          s_remote_desc.usb_speed == TUSB_SPEED_HIGH,
+                                          s_remote_desc.config.data,
+                                          s_remote_desc.config.len,
+                                          s_presented_cfg,
+                                          sizeof(s_presented_cfg),
+                                          &res);
+    if (xlen)
     {
-        len = sizeof(patched_cfg);
+        if (xlen != s_last_xform_len || memcmp(&res, &s_last_xform, sizeof(res)) != 0)
+        {
+            LOGI("[DEV] config transform: len %u -> %u, itf kept=%u stripped=%u, ep interval=%u mps=%u",
+                 s_remote_desc.config.len, xlen, res.itf_kept, res.itf_stripped,
+                 res.ep_interval, res.ep_mps);
+            s_last_xform     = res;
+            s_last_xform_len = xlen;
+        }
+        if (out_data) *out_data = s_presented_cfg;
+        if (out_len)  *out_len  = xlen;
+        return true;
     }
+    LOGW("[DEV] config transform failed (len=%u), presenting as received", s_remote_desc.config.len);
+#endif
 
-    memcpy(patched_cfg, s_remote_desc.config.data, len);
-    tusb_desc_configuration_t* cfg = (tusb_desc_configuration_t*)patched_cfg;
+    // wTotalLength may exceed what was kept; patch a copy, never the arena.
+    uint16_t len = s_remote_desc.config.len;
+    memcpy(s_presented_cfg, s_remote_desc.config.data, len);
+    tusb_desc_configuration_t* cfg = (tusb_desc_configuration_t*)s_presented_cfg;
     cfg->wTotalLength = tu_htole16(len);
 
-    if (out_data) *out_data = patched_cfg;
+    if (out_data) *out_data = s_presented_cfg;
     if (out_len)  *out_len  = len;
     return true;
 }
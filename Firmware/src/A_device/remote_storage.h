@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include "tusb.h"
 #include "proxy_config.h"
+#include "desc_session.h"
 
 typedef struct
 {
@@ -13,6 +14,16 @@ typedef struct
     bool     valid;
 } remote_desc_buffer_t;
 
+// Configuration descriptor storage. `data` points into a fixed static arena
+// of PROXY_MAX_CONFIG_DESC_SIZE bytes (1 KB by default); longer configs are
+// truncated. The arena holds the bytes exactly as received.
+typedef struct
+{
+    uint8_t* data;
+    uint16_t len;
+    bool     valid;
+} remote_desc_arena_buffer_t;
+
 typedef struct
 {
     uint8_t  data[64];
@@ -23,17 +34,38 @@ typedef struct
     uint16_t langid;
 } remote_string_desc_t;
 
+// Running FNV-1a digest of descriptor bytes as received over the link. Kept
+// per descriptor, so chunk sizes and report/string interleaving do not matter.
+typedef struct
+{
+    uint32_t device;
+    uint32_t config;
+    uint32_t reports[CFG_TUD_HID];
+    uint16_t config_len;
+    uint16_t report_len[CFG_TUD_HID];
+} remote_desc_digest_t;
+
 typedef struct
 {
     remote_desc_buffer_t reports[CFG_TUD_HID];
     remote_desc_buffer_t device;
-    remote_desc_buffer_t config;
+    remote_desc_arena_buffer_t config;
     tusb_speed_t         usb_speed;
     bool                 report_has_id[CFG_TUD_HID];
     bool                 hid_itf_present[CFG_TUD_HID];
     uint16_t             hid_report_expected_len[CFG_TUD_HID];
+    // Incremental assembly: each descriptor is parsed once, when it completes.
+    uint16_t             config_expected_len; // wTotalLength, 0 = not known yet
+    bool                 device_parsed;
+    bool                 config_parsed;
+    bool                 report_parsed[CFG_TUD_HID];
+    uint32_t             assembly_start_us;
+    uint32_t             assembly_parse_us;
+    uint16_t             assembly_chunks;
     remote_string_desc_t lang;
     remote_string_desc_t strings[256];
+    remote_desc_digest_t digest;          // of the set currently stored
+    desc_session_t       session;         // PF_DESC_SEGMENT sets: ranges held per descriptor
     bool                 descriptors_complete;
     bool                 usb_attached;
     bool                 tusb_initialized;
@@ -46,6 +78,13 @@ void remote_storage_init_defaults(void);
 void remote_desc_append(remote_desc_buffer_t* buf,
                         uint8_t const* data,
                         uint16_t len);
+// Append a config descriptor chunk to the arena; returns bytes actually stored.
+uint16_t remote_desc_config_append(uint8_t const* data, uint16_t len);
+// Store a PF_DESC_SEGMENT of the current session at its offset. Buffer `len`
+// follows the contiguous prefix, so the incremental hooks below see the same
+// picture as with in-order chunks. False when the segment was dropped.
+bool remote_desc_segment_store(proto_desc_segment_t const* seg);
+uint16_t remote_storage_config_capacity(void);
 remote_string_desc_t* remote_desc_get_string_entry(uint8_t index);
 void remote_desc_store_string(uint8_t index,
                               uint16_t langid,
@@ -53,8 +92,25 @@ void remote_desc_store_string(uint8_t index,
                               uint16_t len);
 void remote_storage_update_string_allowlist(void);
 void remote_storage_analyze_report_descriptors(void);
+
+// Incremental assembler hooks. Each returns true when the call completed (and
+// parsed) a descriptor, i.e. when the overall readiness may have changed.
+bool remote_storage_device_stored(void);
+bool remote_storage_config_appended(void);
+bool remote_storage_report_appended(uint8_t itf);
+// Parse whatever is still unparsed (lengths never announced); used on PF_DESC_DONE.
+void remote_storage_finalize(void);
+bool remote_storage_config_complete(void);
 bool remote_storage_report_has_id(uint8_t itf);
 bool remote_storage_reports_ready(void);
+// Descriptor-set digest used by the fast re-plug path.
+void remote_desc_digest_reset(remote_desc_digest_t* d);
+void remote_desc_digest_feed(remote_desc_digest_t* d,
+                             uint8_t desc_cmd,
+                             uint8_t const* data,
+                             uint16_t len);
+bool remote_desc_digest_equal(remote_desc_digest_t const* a,
+                              remote_desc_digest_t const* b);
 bool remote_storage_get_report_descriptor(uint8_t itf,
                                           uint8_t const** out_data,
                                           uint16_t *out_len);
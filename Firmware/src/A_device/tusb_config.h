@@ -40,7 +40,8 @@ extern "C" {
 
 #define CFG_TUD_ENDPOINT0_SIZE 64
 
-#define CFG_TUD_HID            4
+// Up to PROXY_HUB_MAX_ITFS interfaces when B_host merges devices behind a hub.
+#define CFG_TUD_HID            8
 #define CFG_TUD_CDC            0
 #define CFG_TUD_MSC            0
 #define CFG_TUD_MIDI           0
@@ -1,3 +1,5 @@
+#define LOG_MODULE LOG_MOD_DEV
+
 #include "tusb.h"
 #include "hid_proxy_dev.h"
 #include "logging.h"
@@ -156,6 +158,13 @@ enum
 #define CONFIG_TOTAL_LEN    (TUD_CONFIG_DESC_LEN + TUD_HID_DESC_LEN)
 #define EPNUM_HID           0x81
 
+// Same ceiling the transform puts on mirrored configs.
+#if PROXY_DESC_XFORM && PROXY_XFORM_INTERVAL_MS
+#define HID_POLL_INTERVAL_MS PROXY_XFORM_INTERVAL_MS
+#else
+#define HID_POLL_INTERVAL_MS 10
+#endif
+
 uint8_t const desc_configuration[] =
 {
     TUD_CONFIG_DESCRIPTOR(
@@ -174,7 +183,7 @@ uint8_t const desc_configuration[] =
         sizeof(desc_hid_report_boot_mouse),
         EPNUM_HID,
         CFG_TUD_HID_EP_BUFSIZE,
-        10                  // polling interval (ms)
+        HID_POLL_INTERVAL_MS // polling interval (ms)
     )
 };
 
@@ -1,3 +1,5 @@
+#define LOG_MODULE LOG_MOD_CTRL
+
 #include "control_uart.h"
 
 #include <stdint.h>
@@ -6,15 +8,30 @@
 
 #include "pico/stdlib.h"
 #include "pico/unique_id.h"
-#include "pico/unique_id.h"
+#include "pico/rand.h"
 #include "hardware/uart.h"
 #include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
 
 #include "crc16.h"
 #include "logging.h"
 #include "proxy_config.h"
 #include "hid_proxy_host.h"
+#include "enum_trace.h"
 #include "sha256.h"
+#include "siphash.h"
+#include "proto_frame.h"
+#include "uart_transport.h"
+#include "input_tap.h"
+#include "replay.h"
+#include "inject_sched.h"
+#include "pointer_move.h"
+#include "text_type.h"
+#include "input_state.h"
+#include "input_mixer.h"
+#include "metrics.h"
+#include "fanout.h"
 
 #define SLIP_END     0xC0
 #define SLIP_ESC     0xDB
@@ -31,19 +48,198 @@
 #define CTRL_V2_HMAC_LEN 16
 #define CTRL_V2_MIN_LEN (CTRL_V2_HDR_LEN + CTRL_V2_CRC_LEN + CTRL_V2_HMAC_LEN)
 
+// Fast-MAC frames (version 0x02): v2 header + LE32 replay counter, CRC16 and
+// a SipHash-2-4 tag under the key agreed by SESSION_SETUP.
+#define CTRL_FAST_VERSION  0x02
+#define CTRL_FAST_HDR_LEN  10
+#define CTRL_FAST_TAG_LEN  8
+#define CTRL_FAST_MIN_LEN  (CTRL_FAST_HDR_LEN + CTRL_V2_CRC_LEN + CTRL_FAST_TAG_LEN)
+#define CTRL_SESSION_NONCE_LEN 16
+
 #define CTRL_FLAG_RESPONSE 0x01
 #define CTRL_FLAG_ERROR    0x02
+#define CTRL_FLAG_NO_ACK   0x04
+
+#define CTRL_ACK_WINDOW_MAX 64
+
+// TELEMETRY (0x0D) section types and SUBSCRIBE mask bits.
+#define CTRL_TM_ITF   0x01
+#define CTRL_TM_LINK  0x02
+#define CTRL_TM_ADEV  0x04
+#define CTRL_TM_CTRL  0x08
+#define CTRL_TM_ALL   (CTRL_TM_ITF | CTRL_TM_LINK | CTRL_TM_ADEV | CTRL_TM_CTRL)
+#define CTRL_TM_MORE  0x80  // header mask bit: the snapshot continues in the next frame
+#define CTRL_TM_HDR_LEN 7
+#define CTRL_TM_MAX_LEN 240
+
+// TAP_DATA (0x0F) header: count, used LE16, high_water LE16, dropped LE32.
+#define CTRL_TAP_HDR_LEN 9
+#define CTRL_TAP_MAX_FRAMES_PER_PASS 4
+
+// REPLAY (0x10) subcommands.
+#define CTRL_REPLAY_CLEAR        0x01
+#define CTRL_REPLAY_APPEND       0x02
+#define CTRL_REPLAY_READ         0x03
+#define CTRL_REPLAY_RECORD       0x04
+#define CTRL_REPLAY_RECORD_STOP  0x05
+#define CTRL_REPLAY_PLAY         0x06
+#define CTRL_REPLAY_STOP         0x07
+#define CTRL_REPLAY_STATUS       0x08
+#define CTRL_REPLAY_SAVE         0x09
+#define CTRL_REPLAY_LOAD         0x0A
+#define CTRL_REPLAY_STATUS_LEN   42
+#define CTRL_REPLAY_READ_MAX     200
+
+// SCHEDULE (0x11) subcommands.
+#define CTRL_SCHED_ADD           0x01
+#define CTRL_SCHED_CANCEL        0x02
+#define CTRL_SCHED_STATS         0x03
+#define CTRL_SCHED_FLAG_ABSOLUTE 0x01
+#define CTRL_SCHED_STATS_LEN     43
+
+// MOVE (0x12): mode STOP and the request length.
+#define CTRL_MOVE_STOP           0x02
+#define CTRL_MOVE_REQ_LEN        13
+
+// TYPE_TEXT (0x13) subcommands; APPEND header is sub, layout, itf_sel, flags,
+// interval_us LE16. Bit 0 of flags goes to the engine, bit 1 turns on
+// TYPE_EVENT (0x14) frames.
+#define CTRL_TYPE_APPEND         0x01
+#define CTRL_TYPE_CANCEL         0x02
+#define CTRL_TYPE_HDR_LEN        6
+#define CTRL_TYPE_FLAG_EVENTS    0x02
+#define CTRL_TYPE_STATUS_LEN     15
+
+// KEY (0x15) operations; payload is op, itf_sel, then the op's arguments.
+#define CTRL_KEY_DOWN            0x01
+#define CTRL_KEY_UP              0x02
+#define CTRL_KEY_BUTTON_DOWN     0x03
+#define CTRL_KEY_BUTTON_UP       0x04
+#define CTRL_KEY_RELEASE_ALL     0x05
+#define CTRL_KEY_STATE           0x06
 
 #define CTRL_ERR_BAD_LEN         1
 #define CTRL_ERR_INJECT_FAILED   2
 #define CTRL_ERR_DESC_MISSING    3
 #define CTRL_ERR_LAYOUT_MISSING  4
+#define CTRL_ERR_SESSION_KEY     5
+#define CTRL_ERR_REPLAY          6  // second byte: replay_result_t
+#define CTRL_ERR_SCHEDULE        7  // second byte: inject_sched_result_t, third: accepted
+#define CTRL_ERR_TYPE            8  // second byte: text_type_result_t
+#define CTRL_ERR_KEYS_FULL       9  // KEY_DOWN beyond PROXY_INPUT_STATE_MAX_KEYS
+
+#if (PROXY_CTRL_UART_RX_RING_SIZE & (PROXY_CTRL_UART_RX_RING_SIZE - 1u)) != 0 || \
+    PROXY_CTRL_UART_RX_RING_SIZE > 32768u
+#error "PROXY_CTRL_UART_RX_RING_SIZE must be a power of two <= 32768"
+#endif
+#define CTRL_RX_RING_MASK (PROXY_CTRL_UART_RX_RING_SIZE - 1u)
+
+#if (PROXY_CTRL_UART_TX_RING_SIZE & (PROXY_CTRL_UART_TX_RING_SIZE - 1u)) != 0 || \
+    PROXY_CTRL_UART_TX_RING_SIZE < 1024u
+#error "PROXY_CTRL_UART_TX_RING_SIZE must be a power of two >= 1024"
+#endif
+#define CTRL_TX_RING_MASK (PROXY_CTRL_UART_TX_RING_SIZE - 1u)
 
 static uint8_t  s_ctrl_rx_buf[CTRL_RX_BUF_MAX];
 static uint16_t s_ctrl_rx_len = 0;
 static bool     s_ctrl_rx_esc = false;
-static uint8_t  s_ctrl_hmac_derived[32];
-static bool     s_ctrl_hmac_ready = false;
+static bool     s_ctrl_rx_too_long = false;
+
+// Single producer (UART IRQ) / single consumer (control_uart_task) byte ring.
+static uint8_t           s_ctrl_rx_ring[PROXY_CTRL_UART_RX_RING_SIZE];
+static volatile uint32_t s_ctrl_rx_head = 0;
+static volatile uint32_t s_ctrl_rx_tail = 0;
+static volatile control_uart_stats_t s_ctrl_stats;
+static uint32_t          s_ctrl_overflow_logged = 0;
+
+// Encoded responses waiting for the TX FIFO. Written by the task, drained by
+// the UART IRQ (and by the enqueue that primes the FIFO).
+static uint8_t           s_ctrl_tx_ring[PROXY_CTRL_UART_TX_RING_SIZE];
+static volatile uint32_t s_ctrl_tx_head = 0;
+static volatile uint32_t s_ctrl_tx_tail = 0;
+
+typedef enum
+{
+    HMAC_KEY_NONE = 0,
+    HMAC_KEY_DERIVED = 1,
+    HMAC_KEY_BOOTSTRAP = 2
+} hmac_key_kind_t;
+
+// Both keys are kept as ipad/opad midstates, computed once at init.
+static hmac_sha256_key_t s_ctrl_key_derived;
+static hmac_sha256_key_t s_ctrl_key_bootstrap;
+static bool              s_ctrl_hmac_ready = false;
+// Key the controller signed its last accepted frame with; verified first.
+static hmac_key_kind_t   s_ctrl_session_key = HMAC_KEY_DERIVED;
+
+typedef struct
+{
+    siphash_key_t key;
+    uint32_t      rx_counter;  // last counter accepted from the controller
+    uint32_t      tx_counter;  // last counter used in a response
+    bool          active;
+} ctrl_fast_session_t;
+
+static ctrl_fast_session_t s_ctrl_fast;
+// Set while a fast-MAC frame is dispatched: its responses use the same format.
+static bool                s_ctrl_reply_fast = false;
+
+// Cumulative ACK for NO_ACK inject frames (SET_ACK_MODE).
+typedef struct
+{
+    uint16_t interval_ms;  // 0 = off: NO_ACK frames are never acknowledged
+    uint8_t  window;       // flush after this many covered frames
+    uint8_t  count;        // NO_ACK frames since the last cumulative ACK
+    uint8_t  first_seq;    // oldest seq the bitmap speaks for
+    uint8_t  last_seq;
+    uint8_t  acked_seq;    // last_seq of the previous cumulative ACK
+    bool     acked_valid;
+    uint64_t fail_bits;    // bit i set: frame with seq (last_seq - i) failed or never arrived
+    uint32_t first_us;     // arrival of the oldest covered frame
+    bool     reply_fast;
+    bool     reply_bootstrap;
+} ctrl_cum_ack_t;
+
+static ctrl_cum_ack_t s_ctrl_ack;
+
+// Telemetry subscription (SUBSCRIBE). Frames are signed like the SUBSCRIBE.
+typedef struct
+{
+    uint16_t interval_ms;  // 0 = not subscribed
+    uint8_t  mask;         // CTRL_TM_* sections to include
+    uint16_t seq;          // frames sent since SUBSCRIBE; gaps mean TX drops
+    uint32_t next_us;
+    bool     reply_fast;
+    bool     reply_bootstrap;
+} ctrl_telemetry_t;
+
+static ctrl_telemetry_t s_ctrl_tm;
+
+// Physical input tap drain (TAP). Frames are signed like the TAP request.
+typedef struct
+{
+    uint16_t flush_ms;     // max age of the oldest entry before a partial frame goes out
+    uint8_t  seq;          // TAP_DATA frames sent since TAP
+    bool     reply_fast;
+    bool     reply_bootstrap;
+} ctrl_tap_t;
+
+static ctrl_tap_t s_ctrl_tap;
+
+// TYPE_EVENT progress frames, signed like the TYPE_TEXT request that started typing.
+typedef struct
+{
+    bool     events;
+    bool     was_active;
+    uint8_t  seq;          // TYPE_EVENT frames sent since typing started
+    uint32_t next_us;
+    bool     reply_fast;
+    bool     reply_bootstrap;
+} ctrl_type_t;
+
+static ctrl_type_t s_ctrl_type;
+
+static void send_ctrl_stats(uint8_t seq, bool use_bootstrap);
 
 static void ctrl_init_hmac_key(void)
 {
@@ -51,21 +247,41 @@ static void ctrl_init_hmac_key(void)
     size_t key_len = strlen(PROXY_CTRL_HMAC_KEY);
     pico_unique_board_id_t id;
     pico_get_unique_board_id(&id);
-    hmac_sha256(key, key_len, id.id, PICO_UNIQUE_BOARD_ID_SIZE_BYTES, s_ctrl_hmac_derived);
+
+    uint8_t derived[32];
+    hmac_sha256(key, key_len, id.id, PICO_UNIQUE_BOARD_ID_SIZE_BYTES, derived);
+    hmac_sha256_precompute(&s_ctrl_key_derived, derived, sizeof(derived));
+    hmac_sha256_precompute(&s_ctrl_key_bootstrap, key, key_len);
     s_ctrl_hmac_ready = true;
 }
 
-static void ctrl_get_hmac_key(uint8_t cmd, const uint8_t** key, size_t* key_len)
+static const hmac_sha256_key_t* ctrl_hmac_key(hmac_key_kind_t kind)
 {
-    if (!key || !key_len) return;
-    if (cmd == 0x06 || !s_ctrl_hmac_ready)
+    if (kind == HMAC_KEY_BOOTSTRAP || !s_ctrl_hmac_ready)
     {
-        *key = (const uint8_t*)PROXY_CTRL_HMAC_KEY;
-        *key_len = strlen(PROXY_CTRL_HMAC_KEY);
-        return;
+        return &s_ctrl_key_bootstrap;
     }
-    *key = s_ctrl_hmac_derived;
-    *key_len = sizeof(s_ctrl_hmac_derived);
+    return &s_ctrl_key_derived;
+}
+
+// GET_DEVICE_ID is always bootstrap-signed: the host needs its answer to derive the key.
+static hmac_key_kind_t ctrl_default_key_kind(uint8_t cmd)
+{
+    return (cmd == 0x06) ? HMAC_KEY_BOOTSTRAP : HMAC_KEY_DERIVED;
+}
+
+static void put_le16(uint8_t* p, uint16_t v)
+{
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_le32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)((v >> 8) & 0xFF);
+    p[2] = (uint8_t)((v >> 16) & 0xFF);
+    p[3] = (uint8_t)((v >> 24) & 0xFF);
 }
 
 static int slip_encode(const uint8_t* data, uint16_t len, uint8_t* out, uint16_t out_max)
@@ -101,6 +317,62 @@ static int slip_encode(const uint8_t* data, uint16_t len, uint8_t* out, uint16_t
     return (int)pos;
 }
 
+#if PROXY_CTRL_UART_ENABLED
+// Called from the IRQ or with interrupts disabled. TXIM stays set only while
+// the ring has bytes the FIFO could not take.
+static void ctrl_tx_fill_fifo(uart_hw_t* hw)
+{
+    uint32_t tail = s_ctrl_tx_tail;
+    uint32_t head = s_ctrl_tx_head;
+    while (tail != head && !(hw->fr & UART_UARTFR_TXFF_BITS))
+    {
+        hw->dr = s_ctrl_tx_ring[tail];
+        tail = (tail + 1u) & CTRL_TX_RING_MASK;
+    }
+    s_ctrl_tx_tail = tail;
+
+    if (tail == head)
+    {
+        hw_clear_bits(&hw->imsc, UART_UARTIMSC_TXIM_BITS);
+    }
+    else
+    {
+        hw_set_bits(&hw->imsc, UART_UARTIMSC_TXIM_BITS);
+    }
+}
+
+// Whole frames only: a frame that does not fit is dropped, never truncated.
+static bool ctrl_tx_enqueue(const uint8_t* data, uint16_t len)
+{
+    uint32_t head = s_ctrl_tx_head;
+    uint32_t used = (head - s_ctrl_tx_tail) & CTRL_TX_RING_MASK;
+    if (len > CTRL_TX_RING_MASK - used)
+    {
+        s_ctrl_stats.tx_dropped_frames++;
+        return false;
+    }
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        s_ctrl_tx_ring[head] = data[i];
+        head = (head + 1u) & CTRL_TX_RING_MASK;
+    }
+    s_ctrl_tx_head = head;
+
+    // The PL011 TX interrupt fires on the FIFO level crossing, so prime the
+    // FIFO here; the IRQ takes over once it is full.
+    uint32_t irq = save_and_disable_interrupts();
+    ctrl_tx_fill_fifo(uart_get_hw(PROXY_CTRL_UART_ID));
+    restore_interrupts(irq);
+    return true;
+}
+#endif
+
+static uint32_t ctrl_tx_free(void)
+{
+    return CTRL_TX_RING_MASK - ((s_ctrl_tx_head - s_ctrl_tx_tail) & CTRL_TX_RING_MASK);
+}
+
 static int build_v2_frame(uint8_t seq, uint8_t cmd, uint8_t flags,
                           const uint8_t* payload, uint8_t payload_len,
                           uint8_t* out, uint16_t out_max,
@@ -137,23 +409,51 @@ static int build_v2_frame(uint8_t seq, uint8_t cmd, uint8_t flags,
     out[6 + payload_len] = (uint8_t)(crc & 0xFF);
     out[7 + payload_len] = (uint8_t)(crc >> 8);
 
-    const uint8_t* key = NULL;
-    size_t key_len = 0;
-    if (use_bootstrap)
+    const hmac_sha256_key_t* key =
+        ctrl_hmac_key(use_bootstrap ? HMAC_KEY_BOOTSTRAP : ctrl_default_key_kind(cmd));
+    uint8_t mac[32];
+    hmac_sha256_with(key, out, (size_t)(CTRL_V2_HDR_LEN + payload_len + CTRL_V2_CRC_LEN), mac);
+    memcpy(&out[8 + payload_len], mac, CTRL_V2_HMAC_LEN);
+
+    return (int)total_len;
+#endif
+}
+
+static int build_fast_frame(uint8_t seq, uint8_t cmd, uint8_t flags,
+                            const uint8_t* payload, uint8_t payload_len,
+                            uint8_t* out, uint16_t out_max)
+{
+    if (!s_ctrl_fast.active || payload_len > 240) return 0;
+    uint16_t total_len = (uint16_t)(CTRL_FAST_HDR_LEN + payload_len + CTRL_V2_CRC_LEN + CTRL_FAST_TAG_LEN);
+    if (total_len > out_max) return 0;
+    if (s_ctrl_fast.tx_counter == UINT32_MAX)
     {
-        key = (const uint8_t*)PROXY_CTRL_HMAC_KEY;
-        key_len = strlen(PROXY_CTRL_HMAC_KEY);
+        // Counter space exhausted: the controller has to run SESSION_SETUP again.
+        s_ctrl_fast.active = false;
+        return 0;
     }
-    else
+
+    out[0] = CTRL_V2_MAGIC;
+    out[1] = CTRL_FAST_VERSION;
+    out[2] = flags;
+    out[3] = seq;
+    out[4] = cmd;
+    out[5] = payload_len;
+    put_le32(&out[6], ++s_ctrl_fast.tx_counter);
+    if (payload_len && payload)
     {
-        ctrl_get_hmac_key(cmd, &key, &key_len);
+        memcpy(&out[CTRL_FAST_HDR_LEN], payload, payload_len);
     }
-    uint8_t mac[32];
-    hmac_sha256(key, key_len, out, (size_t)(CTRL_V2_HDR_LEN + payload_len + CTRL_V2_CRC_LEN), mac);
-    memcpy(&out[8 + payload_len], mac, CTRL_V2_HMAC_LEN);
 
+    uint16_t body_len = (uint16_t)(CTRL_FAST_HDR_LEN + payload_len);
+    uint16_t crc = crc16_ccitt(out, body_len, 0xFFFF);
+    out[body_len]     = (uint8_t)(crc & 0xFF);
+    out[body_len + 1] = (uint8_t)(crc >> 8);
+
+    uint64_t tag = siphash24(&s_ctrl_fast.key, out, (size_t)(body_len + CTRL_V2_CRC_LEN));
+    put_le32(&out[body_len + 2], (uint32_t)tag);
+    put_le32(&out[body_len + 6], (uint32_t)(tag >> 32));
     return (int)total_len;
-#endif
 }
 
 static void ctrl_send_response(uint8_t seq, uint8_t cmd, uint8_t flags,
@@ -171,13 +471,15 @@ static void ctrl_send_response(uint8_t seq, uint8_t cmd, uint8_t flags,
     if (PROXY_CTRL_UART_ID == PROXY_UART_ID) return;
 
     uint8_t frame[CTRL_TX_BUF_MAX];
-    int frame_len = build_v2_frame(seq, cmd, flags, payload, payload_len, frame, sizeof(frame), use_bootstrap);
+    int frame_len = s_ctrl_reply_fast
+                        ? build_fast_frame(seq, cmd, flags, payload, payload_len, frame, sizeof(frame))
+                        : build_v2_frame(seq, cmd, flags, payload, payload_len, frame, sizeof(frame), use_bootstrap);
     if (frame_len <= 0) return;
 
     uint8_t encoded[CTRL_TX_BUF_MAX];
     int enc_len = slip_encode(frame, (uint16_t)frame_len, encoded, sizeof(encoded));
     if (enc_len <= 0) return;
-    uart_write_blocking(PROXY_CTRL_UART_ID, encoded, enc_len);
+    (void)ctrl_tx_enqueue(encoded, (uint16_t)enc_len);
 #endif
 }
 
@@ -201,6 +503,12 @@ static void send_interface_list(uint8_t seq, bool use_bootstrap)
         payload[pos++] = list[i].active;
         payload[pos++] = list[i].mounted;
     }
+    // Appended after the 7-byte entries so older readers still parse them:
+    // bInterfaceNumber of each entry on its physical device (hub composites).
+    for (size_t i = 0; i < count && pos < sizeof(payload); i++)
+    {
+        payload[pos++] = list[i].itf_num;
+    }
 
     ctrl_send_response(seq, 0x02, CTRL_FLAG_RESPONSE, payload, (uint8_t)pos, use_bootstrap);
 }
@@ -271,182 +579,1535 @@ static void send_device_id(uint8_t seq)
     ctrl_send_response(seq, 0x06, CTRL_FLAG_RESPONSE, payload, sizeof(payload), true);
 }
 
-static void ctrl_rx_reset(void)
-{
-    s_ctrl_rx_len = 0;
-    s_ctrl_rx_esc = false;
-}
+#define CTRL_TRACE_HDR_LEN      9
+#define CTRL_TRACE_PAGE_ENTRIES 28
+#define CTRL_TRACE_REQ_REFRESH  0x01
+#define CTRL_TRACE_HAS_REMOTE   0x01
+#define CTRL_TRACE_PENDING      0x02
 
-static bool ctrl_hmac_equal(const uint8_t* a, const uint8_t* b, uint16_t len)
+static uint16_t s_trace_total = 0;
+
+static void send_trace_page(uint8_t seq, uint8_t page, uint8_t req_flags, bool use_bootstrap)
 {
-    uint8_t diff = 0;
-    for (uint16_t i = 0; i < len; i++)
+    if (req_flags & CTRL_TRACE_REQ_REFRESH)
     {
-        diff |= (uint8_t)(a[i] ^ b[i]);
+        hid_proxy_host_trace_pull();
     }
-    return diff == 0;
+
+    bool pending = hid_proxy_host_trace_pending();
+    if (page == 0 && !pending)
+    {
+        // Page 0 freezes the merged timeline; later pages read the same snapshot.
+        s_trace_total = enum_trace_snapshot();
+    }
+
+    uint8_t payload[CTRL_TRACE_HDR_LEN + CTRL_TRACE_PAGE_ENTRIES * ENUM_TRACE_WIRE_SIZE];
+    uint16_t n = pending ? 0
+                         : enum_trace_snapshot_encode((uint16_t)(page * CTRL_TRACE_PAGE_ENTRIES),
+                                                      &payload[CTRL_TRACE_HDR_LEN],
+                                                      CTRL_TRACE_PAGE_ENTRIES);
+    int32_t offset = hid_proxy_host_trace_offset_us();
+
+    payload[0] = (uint8_t)(s_trace_total & 0xFF);
+    payload[1] = (uint8_t)(s_trace_total >> 8);
+    payload[2] = page;
+    payload[3] = (uint8_t)((enum_trace_remote_count() ? CTRL_TRACE_HAS_REMOTE : 0) |
+                           (pending ? CTRL_TRACE_PENDING : 0));
+    payload[4] = (uint8_t)n;
+    payload[5] = (uint8_t)((uint32_t)offset & 0xFF);
+    payload[6] = (uint8_t)(((uint32_t)offset >> 8) & 0xFF);
+    payload[7] = (uint8_t)(((uint32_t)offset >> 16) & 0xFF);
+    payload[8] = (uint8_t)(((uint32_t)offset >> 24) & 0xFF);
+
+    ctrl_send_response(seq, 0x07, CTRL_FLAG_RESPONSE, payload,
+                       (uint8_t)(CTRL_TRACE_HDR_LEN + n * ENUM_TRACE_WIRE_SIZE), use_bootstrap);
 }
 
-typedef enum
+// Session key = HMAC-SHA256(derived key, "HBS1" || host nonce || device nonce)[0..15].
+// The reply is an ordinary derived-key v2 frame, so the controller can check
+// it before switching to fast frames; the previous session is dropped.
+static void start_fast_session(uint8_t seq, const uint8_t* host_nonce)
 {
-    HMAC_KEY_NONE = 0,
-    HMAC_KEY_DERIVED = 1,
-    HMAC_KEY_BOOTSTRAP = 2
-} hmac_key_kind_t;
+    rng_128_t rnd;
+    get_rand_128(&rnd);
 
-static hmac_key_kind_t ctrl_verify_hmac(uint8_t cmd, const uint8_t* data, uint16_t payload_len)
+    uint8_t device_nonce[CTRL_SESSION_NONCE_LEN];
+    put_le32(&device_nonce[0],  (uint32_t)rnd.r[0]);
+    put_le32(&device_nonce[4],  (uint32_t)(rnd.r[0] >> 32));
+    put_le32(&device_nonce[8],  (uint32_t)rnd.r[1]);
+    put_le32(&device_nonce[12], (uint32_t)(rnd.r[1] >> 32));
+
+    uint8_t msg[4 + 2 * CTRL_SESSION_NONCE_LEN];
+    memcpy(msg, "HBS1", 4);
+    memcpy(&msg[4], host_nonce, CTRL_SESSION_NONCE_LEN);
+    memcpy(&msg[4 + CTRL_SESSION_NONCE_LEN], device_nonce, CTRL_SESSION_NONCE_LEN);
+
+    uint8_t digest[32];
+    hmac_sha256_with(ctrl_hmac_key(HMAC_KEY_DERIVED), msg, sizeof(msg), digest);
+    siphash_key_init(&s_ctrl_fast.key, digest);
+    s_ctrl_fast.rx_counter = 0;
+    s_ctrl_fast.tx_counter = 0;
+    s_ctrl_fast.active = true;
+    s_ctrl_stats.sessions_started++;
+
+    ctrl_send_response(seq, 0x09, CTRL_FLAG_RESPONSE, device_nonce, sizeof(device_nonce), false);
+}
+
+// Payload: last_seq, count, fail_bits (LE64). Signed like the newest covered frame.
+static void ctrl_ack_flush(void)
 {
-    const uint8_t* key = NULL;
-    size_t key_len = 0;
-    ctrl_get_hmac_key(cmd, &key, &key_len);
-    uint8_t mac[32];
-    hmac_sha256(key, key_len, data, (size_t)(CTRL_V2_HDR_LEN + payload_len + CTRL_V2_CRC_LEN), mac);
-    if (ctrl_hmac_equal(mac, &data[8 + payload_len], CTRL_V2_HMAC_LEN))
+    if (!s_ctrl_ack.count) return;
+
+    uint8_t payload[10];
+    payload[0] = s_ctrl_ack.last_seq;
+    payload[1] = s_ctrl_ack.count;
+    put_le32(&payload[2], (uint32_t)s_ctrl_ack.fail_bits);
+    put_le32(&payload[6], (uint32_t)(s_ctrl_ack.fail_bits >> 32));
+
+    bool prev_fast = s_ctrl_reply_fast;
+    s_ctrl_reply_fast = s_ctrl_ack.reply_fast && s_ctrl_fast.active;
+    ctrl_send_response(s_ctrl_ack.last_seq, 0x0C, CTRL_FLAG_RESPONSE, payload, sizeof(payload),
+                       s_ctrl_ack.reply_bootstrap);
+    s_ctrl_reply_fast = prev_fast;
+
+    s_ctrl_ack.acked_seq = s_ctrl_ack.last_seq;
+    s_ctrl_ack.acked_valid = true;
+    s_ctrl_ack.count = 0;
+    s_ctrl_ack.fail_bits = 0;
+    s_ctrl_stats.cumulative_acks++;
+}
+
+// Bits 1..gap set: the sequence numbers just below a newly recorded frame.
+static inline uint64_t ctrl_ack_missing(uint8_t gap)
+{
+    return gap ? (((1ull << gap) - 1u) << 1) : 0u;
+}
+
+static void ctrl_ack_record(uint8_t seq, bool ok, bool use_bootstrap)
+{
+    if (!ok) s_ctrl_stats.no_ack_failures++;
+    if (!s_ctrl_ack.interval_ms) return;
+
+    // The bitmap spans 64 sequence numbers; flush before it would overflow.
+    // Anything older than first_seq also wraps past the window.
+    if (s_ctrl_ack.count && (uint8_t)(seq - s_ctrl_ack.first_seq) >= CTRL_ACK_WINDOW_MAX)
     {
-        return HMAC_KEY_DERIVED;
+        ctrl_ack_flush();
     }
 
-    const uint8_t* boot_key = (const uint8_t*)PROXY_CTRL_HMAC_KEY;
-    size_t boot_len = strlen(PROXY_CTRL_HMAC_KEY);
-    hmac_sha256(boot_key, boot_len, data, (size_t)(CTRL_V2_HDR_LEN + payload_len + CTRL_V2_CRC_LEN), mac);
-    if (ctrl_hmac_equal(mac, &data[8 + payload_len], CTRL_V2_HMAC_LEN))
+    uint64_t bit;
+    if (!s_ctrl_ack.count)
+    {
+        // Sequence numbers between the previous ACK and this frame never
+        // arrived (or were not NO_ACK frames): report them as failed.
+        uint8_t gap = (uint8_t)(seq - s_ctrl_ack.acked_seq - 1u);
+        if (!s_ctrl_ack.acked_valid || gap >= CTRL_ACK_WINDOW_MAX) gap = 0;
+        s_ctrl_ack.first_seq = (uint8_t)(seq - gap);
+        s_ctrl_ack.last_seq  = seq;
+        s_ctrl_ack.fail_bits = ctrl_ack_missing(gap);
+        s_ctrl_ack.first_us  = time_us_32();
+        bit = 1u;
+    }
+    else if ((uint8_t)(seq - s_ctrl_ack.first_seq) <= (uint8_t)(s_ctrl_ack.last_seq - s_ctrl_ack.first_seq))
+    {
+        // Late or repeated frame inside the window (e.g. a retry): its own bit only.
+        bit = 1ull << (uint8_t)(s_ctrl_ack.last_seq - seq);
+    }
+    else
+    {
+        // 1..63 newer than last_seq; the ones skipped never arrived.
+        uint8_t step = (uint8_t)(seq - s_ctrl_ack.last_seq);
+        s_ctrl_ack.fail_bits = (s_ctrl_ack.fail_bits << step) | ctrl_ack_missing((uint8_t)(step - 1u));
+        s_ctrl_ack.last_seq  = seq;
+        bit = 1u;
+    }
+    s_ctrl_ack.fail_bits = ok ? (s_ctrl_ack.fail_bits & ~bit) : (s_ctrl_ack.fail_bits | bit);
+    s_ctrl_ack.count++;
+    s_ctrl_ack.reply_fast = s_ctrl_reply_fast;
+    s_ctrl_ack.reply_bootstrap = use_bootstrap;
+
+    if (s_ctrl_ack.count >= s_ctrl_ack.window)
     {
-        return HMAC_KEY_BOOTSTRAP;
+        ctrl_ack_flush();
     }
-    return HMAC_KEY_NONE;
 }
 
-static void handle_ctrl_frame(uint8_t const* data, uint16_t len)
+// Result of an inject command: NO_ACK frames only feed the cumulative ACK.
+static void ctrl_inject_result(uint8_t seq, uint8_t cmd, uint8_t flags, uint8_t err, bool use_bootstrap)
 {
-    if (!data || len < CTRL_V2_MIN_LEN) return;
-    if (data[0] != CTRL_V2_MAGIC || data[1] != CTRL_V2_VERSION) return;
+    if (flags & CTRL_FLAG_NO_ACK)
+    {
+        ctrl_ack_record(seq, err == 0, use_bootstrap);
+        return;
+    }
+    if (err)
+    {
+        ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap);
+    }
+    else
+    {
+        ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE, NULL, 0, use_bootstrap);
+    }
+}
 
-    uint8_t payload_len = data[5];
-    uint16_t total_len = (uint16_t)(CTRL_V2_HDR_LEN + payload_len + CTRL_V2_CRC_LEN + CTRL_V2_HMAC_LEN);
-    if (len != total_len) return;
+static void set_ack_mode(uint8_t seq, uint8_t const* payload, bool use_bootstrap)
+{
+    ctrl_ack_flush();
+    s_ctrl_ack.acked_valid = false;
+    s_ctrl_ack.interval_ms = (uint16_t)payload[0] | ((uint16_t)payload[1] << 8);
+    uint8_t window = payload[2];
+    if (window == 0 || window > CTRL_ACK_WINDOW_MAX) window = CTRL_ACK_WINDOW_MAX;
+    s_ctrl_ack.window = window;
 
-    uint16_t crc = crc16_ccitt(data, (uint32_t)(CTRL_V2_HDR_LEN + payload_len), 0xFFFF);
-    uint16_t msg_crc = (uint16_t)data[6 + payload_len] | ((uint16_t)data[7 + payload_len] << 8);
-    if (crc != msg_crc) return;
+    uint8_t resp[3] = { payload[0], payload[1], window };
+    ctrl_send_response(seq, 0x0B, CTRL_FLAG_RESPONSE, resp, sizeof(resp), use_bootstrap);
+}
 
-    hmac_key_kind_t key_kind = ctrl_verify_hmac(data[4], data, payload_len);
-    if (key_kind == HMAC_KEY_NONE) return;
-    bool use_bootstrap = (key_kind == HMAC_KEY_BOOTSTRAP);
+// Payload: seq LE16, time_us LE32, mask, then TLV sections (type, len, data).
+// Histograms and send_max_us cover the time since the previous frame; all
+// other counters are totals, so a dropped frame loses resolution, not data.
+// A snapshot that does not fit one frame is paged: every page carries the same
+// time_us and all but the last have CTRL_TM_MORE set in the mask byte.
+typedef struct
+{
+    uint8_t  payload[CTRL_TM_MAX_LEN];
+    uint16_t pos;
+    uint32_t time_us;
+} ctrl_tm_page_t;
 
-    uint8_t seq = data[3];
-    uint8_t cmd = data[4];
-    uint8_t const* payload = &data[6];
+static void ctrl_tm_page_begin(ctrl_tm_page_t* pg)
+{
+    put_le16(&pg->payload[0], s_ctrl_tm.seq);
+    put_le32(&pg->payload[2], pg->time_us);
+    pg->payload[6] = s_ctrl_tm.mask;
+    pg->pos = CTRL_TM_HDR_LEN;
+}
 
-    switch (cmd)
-    {
-        case 0x01: // INJECT_REPORT
-        {
-            if (payload_len < 2) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
-            uint8_t itf_sel = payload[0];
-            uint8_t rlen    = payload[1];
-            if ((uint16_t)rlen > (uint16_t)(payload_len - 2))
-            {
-                rlen = (uint8_t)(payload_len - 2);
-            }
-            if (rlen == 0) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
+static void ctrl_tm_page_send(ctrl_tm_page_t* pg, bool more)
+{
+    if (more) pg->payload[6] |= CTRL_TM_MORE;
 
-            bool ok = hid_proxy_host_inject_report(itf_sel, &payload[2], rlen);
-            if (!ok)
-            {
-                uint8_t err = CTRL_ERR_INJECT_FAILED;
-                ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap);
-            }
-            else
-            {
-                ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE, NULL, 0, use_bootstrap);
-            }
-            break;
-        }
-        case 0x02: // LIST_INTERFACES
-        {
-            send_interface_list(seq, use_bootstrap);
-            break;
-        }
-        case 0x04: // GET_REPORT_DESC
-        {
-            if (payload_len < 1) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
-            send_report_descriptor(seq, payload[0], use_bootstrap);
-            break;
-        }
-        case 0x05: // GET_REPORT_LAYOUT
-        {
-            if (payload_len < 2) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
-            send_report_layout(seq, payload[0], payload[1], use_bootstrap);
-            break;
-        }
-        case 0x03: // SET_LOG_LEVEL
-        {
-            if (payload_len < 1) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
-            logging_set_level(payload[0]);
-            ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE, NULL, 0, use_bootstrap);
-            break;
-        }
-        case 0x06: // GET_DEVICE_ID
-        {
-            if (payload_len != 0) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
-            send_device_id(seq);
-            break;
-        }
+    bool prev_fast = s_ctrl_reply_fast;
+    s_ctrl_reply_fast = s_ctrl_tm.reply_fast && s_ctrl_fast.active;
+    ctrl_send_response((uint8_t)s_ctrl_tm.seq, 0x0D, CTRL_FLAG_RESPONSE, pg->payload, (uint8_t)pg->pos,
+                       s_ctrl_tm.reply_bootstrap);
+    s_ctrl_reply_fast = prev_fast;
+    s_ctrl_tm.seq++;
+}
 
-        default:
-            // Unknown command: ignore.
-            break;
+// Room for one section; sends the current page first when it is full.
+static uint8_t* ctrl_tm_section(ctrl_tm_page_t* pg, uint8_t type, uint8_t len)
+{
+    if (pg->pos + 2u + len > CTRL_TM_MAX_LEN)
+    {
+        ctrl_tm_page_send(pg, true);
+        ctrl_tm_page_begin(pg);
     }
+    pg->payload[pg->pos++] = type;
+    pg->payload[pg->pos++] = len;
+    uint8_t* data = &pg->payload[pg->pos];
+    pg->pos = (uint16_t)(pg->pos + len);
+    return data;
 }
 
-static void ctrl_slip_feed(uint8_t b)
+static void ctrl_telemetry_send(void)
 {
-    if (b == SLIP_END)
+    ctrl_tm_page_t pg;
+    pg.time_us = time_us_32();
+    ctrl_tm_page_begin(&pg);
+
+    if (s_ctrl_tm.mask & CTRL_TM_ITF)
     {
-        if (s_ctrl_rx_len)
+        hid_proxy_itf_telemetry_t itf[CFG_TUH_HID];
+        size_t n = hid_proxy_host_itf_telemetry(itf, CFG_TUH_HID, true);
+        for (size_t i = 0; i < n; i++)
         {
-            handle_ctrl_frame(s_ctrl_rx_buf, s_ctrl_rx_len);
+            uint8_t* p = ctrl_tm_section(&pg, CTRL_TM_ITF, 28);
+            *p++ = itf[i].itf;
+            *p++ = (uint8_t)((itf[i].mounted ? 0x01 : 0) | (itf[i].input_ready ? 0x02 : 0));
+            put_le32(p, itf[i].input_count); p += 4;
+            put_le32(p, itf[i].input_skipped_not_ready); p += 4;
+            put_le16(p, itf[i].send_max_us > 0xFFFFu ? 0xFFFFu : (uint16_t)itf[i].send_max_us); p += 2;
+            for (uint8_t b = 0; b < HID_PROXY_SEND_HIST_BUCKETS; b++)
+            {
+                put_le16(p, itf[i].send_hist[b]); p += 2;
+            }
         }
-        ctrl_rx_reset();
-        return;
     }
 
-    if (b == SLIP_ESC)
+    if (s_ctrl_tm.mask & CTRL_TM_LINK)
     {
-        s_ctrl_rx_esc = true;
-        return;
+        uart_transport_stats_t link;
+        uart_transport_get_stats(&link);
+        uint8_t inject_pending = 0;
+        uint32_t inject_dropped = 0;
+        hid_proxy_host_inject_queue_state(&inject_pending, &inject_dropped);
+
+        uint8_t* p = ctrl_tm_section(&pg, CTRL_TM_LINK, 29);
+        put_le32(p, link.tx_frames); p += 4;
+        put_le32(p, link.rx_frames); p += 4;
+        put_le32(p, link.rx_ring_overflow); p += 4;
+        put_le32(p, link.rx_frame_overflow); p += 4;
+        put_le32(p, proto_crc_error_count()); p += 4;
+        put_le16(p, link.rx_ring_depth); p += 2;
+        put_le16(p, link.rx_ring_high_water); p += 2;
+        *p++ = inject_pending;
+        put_le32(p, inject_dropped);
     }
 
-    if (s_ctrl_rx_esc)
+    proto_dev_stats_t dev;
+    uint32_t age_ms = 0;
+    if ((s_ctrl_tm.mask & CTRL_TM_ADEV) && hid_proxy_host_dev_stats(&dev, &age_ms))
     {
-        if (b == SLIP_ESC_END)      b = SLIP_END;
-        else if (b == SLIP_ESC_ESC) b = SLIP_ESC;
-        s_ctrl_rx_esc = false;
+        uint8_t* p = ctrl_tm_section(&pg, CTRL_TM_ADEV, 37);
+        put_le32(p, age_ms); p += 4;
+        put_le32(p, dev.input_received); p += 4;
+        put_le32(p, dev.input_dropped_not_ready); p += 4;
+        put_le32(p, dev.latency_min_ms); p += 4;
+        put_le32(p, dev.latency_max_ms); p += 4;
+        put_le32(p, dev.crc_errors); p += 4;
+        put_le32(p, dev.rx_ring_overflow); p += 4;
+        put_le32(p, dev.rx_frame_overflow); p += 4;
+        put_le32(p, dev.rx_ring_high_water); p += 4;
+        *p = dev.pending_reports;
     }
 
-    if (s_ctrl_rx_len < CTRL_RX_BUF_MAX)
+    if (s_ctrl_tm.mask & CTRL_TM_CTRL)
     {
-        s_ctrl_rx_buf[s_ctrl_rx_len++] = b;
+        control_uart_stats_t st;
+        control_uart_get_stats(&st);
+        uint16_t tx_used = (uint16_t)((s_ctrl_tx_head - s_ctrl_tx_tail) & CTRL_TX_RING_MASK);
+
+        uint8_t* p = ctrl_tm_section(&pg, CTRL_TM_CTRL, 24);
+        put_le32(p, st.rx_frames); p += 4;
+        put_le32(p, st.bad_frames); p += 4;
+        put_le32(p, st.auth_failures); p += 4;
+        put_le32(p, st.ring_overflow_bytes); p += 4;
+        put_le32(p, st.tx_dropped_frames); p += 4;
+        put_le16(p, st.ring_high_water); p += 2;
+        put_le16(p, tx_used);
     }
-    else
+
+    ctrl_tm_page_send(&pg, false);
+
+    // The A_device snapshot arrives asynchronously and rides in the next frame.
+    if (s_ctrl_tm.mask & CTRL_TM_ADEV)
     {
-        // Overflow: drop frame and resync.
-        ctrl_rx_reset();
+        (void)hid_proxy_host_dev_stats_pull();
     }
 }
 
-void control_uart_init(void)
+// Payload: interval_ms LE16, mask. Interval 0 cancels; mask 0 means all sections.
+static void subscribe_telemetry(uint8_t seq, uint8_t const* payload, bool use_bootstrap)
 {
-#if !PROXY_CTRL_UART_ENABLED
-    return;
-#else
-    // Don't allow sharing the same UART as the internal bridge link.
-    if (PROXY_CTRL_UART_ID == PROXY_UART_ID)
+    uint16_t interval_ms = (uint16_t)payload[0] | ((uint16_t)payload[1] << 8);
+    uint8_t mask = (uint8_t)(payload[2] & CTRL_TM_ALL);
+    if (mask == 0) mask = CTRL_TM_ALL;
+    if (interval_ms && interval_ms < PROXY_CTRL_TELEMETRY_MIN_MS) interval_ms = PROXY_CTRL_TELEMETRY_MIN_MS;
+
+    s_ctrl_tm.interval_ms = interval_ms;
+    s_ctrl_tm.mask = interval_ms ? mask : 0;
+    s_ctrl_tm.seq = 0;
+    s_ctrl_tm.next_us = time_us_32() + (uint32_t)interval_ms * 1000u;
+    s_ctrl_tm.reply_fast = s_ctrl_reply_fast;
+    s_ctrl_tm.reply_bootstrap = use_bootstrap;
+    if (interval_ms && (mask & CTRL_TM_ADEV))
     {
-        LOGW("[CTRL] PROXY_CTRL_UART_ID conflicts with PROXY_UART_ID; control UART disabled");
-        return;
+        (void)hid_proxy_host_dev_stats_pull();
     }
-
+    // Open a fresh histogram window so the first frame covers one interval.
+    if (interval_ms && (mask & CTRL_TM_ITF))
+    {
+        hid_proxy_itf_telemetry_t itf[CFG_TUH_HID];
+        (void)hid_proxy_host_itf_telemetry(itf, CFG_TUH_HID, true);
+    }
+    LOGI("[CTRL] telemetry interval=%u ms mask=0x%02X", interval_ms, s_ctrl_tm.mask);
+
+    uint8_t resp[3] = { (uint8_t)(interval_ms & 0xFF), (uint8_t)(interval_ms >> 8), s_ctrl_tm.mask };
+    ctrl_send_response(seq, 0x0D, CTRL_FLAG_RESPONSE, resp, sizeof(resp), use_bootstrap);
+}
+
+// Payload: mode, depth LE16, used LE16, high_water LE16, captured,
+// dropped_oldest, dropped_newest, drained (LE32 each).
+static void send_tap_stats(uint8_t seq, bool use_bootstrap)
+{
+    input_tap_stats_t st;
+    input_tap_get_stats(&st);
+
+    uint8_t payload[23];
+    payload[0] = st.mode;
+    put_le16(&payload[1], st.depth);
+    put_le16(&payload[3], st.used);
+    put_le16(&payload[5], st.high_water);
+    put_le32(&payload[7], st.captured);
+    put_le32(&payload[11], st.dropped_oldest);
+    put_le32(&payload[15], st.dropped_newest);
+    put_le32(&payload[19], st.drained);
+    ctrl_send_response(seq, 0x0E, CTRL_FLAG_RESPONSE, payload, sizeof(payload), use_bootstrap);
+}
+
+// Payload: none (query) or mode, flush_ms LE16. Changing the mode clears the ring.
+static void handle_tap(uint8_t seq, uint8_t const* payload, uint8_t payload_len, bool use_bootstrap)
+{
+    if (payload_len == 3)
+    {
+        uint8_t mode = payload[0];
+        if (mode > INPUT_TAP_DROP_NEWEST) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, 0x0E, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
+        input_tap_set_mode((input_tap_mode_t)mode);
+        s_ctrl_tap.flush_ms = (uint16_t)payload[1] | ((uint16_t)payload[2] << 8);
+        s_ctrl_tap.seq = 0;
+        s_ctrl_tap.reply_fast = s_ctrl_reply_fast;
+        s_ctrl_tap.reply_bootstrap = use_bootstrap;
+        LOGI("[CTRL] input tap mode=%u flush=%u ms", mode, s_ctrl_tap.flush_ms);
+    }
+    send_tap_stats(seq, use_bootstrap);
+}
+
+// Payload: state, sources, events LE16, used LE16, size LE16, duration_us,
+// loops_done LE16, then sent, failed, busy_retries, late_max_us,
+// late_mean_us, overruns, record_dropped (LE32 each).
+static void send_replay_status(uint8_t seq, bool use_bootstrap)
+{
+    replay_status_t st;
+    replay_get_status(&st);
+
+    uint8_t payload[CTRL_REPLAY_STATUS_LEN];
+    payload[0] = st.state;
+    payload[1] = st.sources;
+    put_le16(&payload[2], st.events);
+    put_le16(&payload[4], st.used);
+    put_le16(&payload[6], st.size);
+    put_le32(&payload[8], st.duration_us);
+    put_le16(&payload[12], st.loops_done);
+    put_le32(&payload[14], st.sent);
+    put_le32(&payload[18], st.failed);
+    put_le32(&payload[22], st.busy_retries);
+    put_le32(&payload[26], st.late_max_us);
+    put_le32(&payload[30], st.late_mean_us);
+    put_le32(&payload[34], st.overruns);
+    put_le32(&payload[38], st.record_dropped);
+    ctrl_send_response(seq, 0x10, CTRL_FLAG_RESPONSE, payload, sizeof(payload), use_bootstrap);
+}
+
+// Payload: subcommand, then its arguments. READ answers with
+// offset LE16, used LE16, data; everything else with the status payload.
+static void handle_replay(uint8_t seq, uint8_t const* payload, uint8_t payload_len, bool use_bootstrap)
+{
+    uint8_t sub = payload[0];
+    uint8_t const* args = &payload[1];
+    uint8_t args_len = (uint8_t)(payload_len - 1u);
+    replay_result_t res = REPLAY_OK;
+    bool bad_len = false;
+
+    switch (sub)
+    {
+        case CTRL_REPLAY_CLEAR:
+            if (args_len != 4) { bad_len = true; break; }
+            res = replay_clear((uint32_t)args[0] | ((uint32_t)args[1] << 8) |
+                               ((uint32_t)args[2] << 16) | ((uint32_t)args[3] << 24));
+            break;
+        case CTRL_REPLAY_APPEND:
+            if (args_len < 3) { bad_len = true; break; }
+            res = replay_append((uint16_t)args[0] | ((uint16_t)args[1] << 8), &args[2], (uint16_t)(args_len - 2u));
+            break;
+        case CTRL_REPLAY_READ:
+        {
+            if (args_len != 2) { bad_len = true; break; }
+            replay_status_t st;
+            replay_get_status(&st);
+            uint16_t offset = (uint16_t)args[0] | ((uint16_t)args[1] << 8);
+            uint8_t resp[4 + CTRL_REPLAY_READ_MAX];
+            put_le16(&resp[0], offset);
+            put_le16(&resp[2], st.used);
+            uint16_t n = replay_read(offset, &resp[4], CTRL_REPLAY_READ_MAX);
+            ctrl_send_response(seq, 0x10, CTRL_FLAG_RESPONSE, resp, (uint8_t)(4u + n), use_bootstrap);
+            return;
+        }
+        case CTRL_REPLAY_RECORD:
+            if (args_len != 1) { bad_len = true; break; }
+            res = replay_record_start(args[0]);
+            break;
+        case CTRL_REPLAY_RECORD_STOP:
+            replay_record_stop();
+            break;
+        case CTRL_REPLAY_PLAY:
+            if (args_len != 2) { bad_len = true; break; }
+            res = replay_play((uint16_t)args[0] | ((uint16_t)args[1] << 8));
+            break;
+        case CTRL_REPLAY_STOP:
+            replay_stop();
+            break;
+        case CTRL_REPLAY_STATUS:
+            break;
+        case CTRL_REPLAY_SAVE:
+            // Bytes behind this frame mean the controller is still sending;
+            // the UART would drop them while IRQs are off for the erase.
+            res = (s_ctrl_rx_head != s_ctrl_rx_tail) ? REPLAY_ERR_BUSY : replay_save_flash();
+            break;
+        case CTRL_REPLAY_LOAD:
+            res = replay_load_flash();
+            break;
+        default:
+            bad_len = true;
+            break;
+    }
+
+    if (bad_len) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, 0x10, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
+    if (res != REPLAY_OK)
+    {
+        uint8_t err[2] = { CTRL_ERR_REPLAY, (uint8_t)res };
+        ctrl_send_response(seq, 0x10, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, err, sizeof(err), use_bootstrap);
+        return;
+    }
+    send_replay_status(seq, use_bootstrap);
+}
+
+// Payload: pending, depth, high_water, now_us, then accepted, sent, failed,
+// cancelled, rejected, busy_retries, late_max_us, late_mean_us, overruns.
+static void send_sched_stats(uint8_t seq, bool reset, bool use_bootstrap)
+{
+    inject_sched_stats_t st;
+    inject_sched_get_stats(&st, reset);
+
+    uint8_t payload[CTRL_SCHED_STATS_LEN];
+    payload[0] = st.pending;
+    payload[1] = st.depth;
+    payload[2] = st.high_water;
+    put_le32(&payload[3], time_us_32());
+    put_le32(&payload[7], st.accepted);
+    put_le32(&payload[11], st.sent);
+    put_le32(&payload[15], st.failed);
+    put_le32(&payload[19], st.cancelled);
+    put_le32(&payload[23], st.rejected);
+    put_le32(&payload[27], st.busy_retries);
+    put_le32(&payload[31], st.late_max_us);
+    put_le32(&payload[35], st.late_mean_us);
+    put_le32(&payload[39], st.overruns);
+    ctrl_send_response(seq, 0x11, CTRL_FLAG_RESPONSE, payload, sizeof(payload), use_bootstrap);
+}
+
+// ADD: flags, tag LE16, then tuples of due_us LE32, itf_sel, len, report[len].
+// Relative due times count from the moment the frame is handled.
+static void handle_sched_add(uint8_t seq, uint8_t flags, uint8_t const* args, uint8_t args_len,
+                             bool use_bootstrap)
+{
+    uint16_t pos = 3;
+    uint8_t count = 0;
+    while (pos < args_len)
+    {
+        if (pos + 6u > args_len || args[pos + 5] == 0) { count = 0; break; }
+        pos = (uint16_t)(pos + 6u + args[pos + 5]);
+        count++;
+    }
+    if (args_len < 3 || count == 0 || pos != args_len)
+    {
+        ctrl_inject_result(seq, 0x11, flags, CTRL_ERR_BAD_LEN, use_bootstrap);
+        return;
+    }
+
+    bool absolute = (args[0] & CTRL_SCHED_FLAG_ABSOLUTE) != 0;
+    uint16_t tag = (uint16_t)args[1] | ((uint16_t)args[2] << 8);
+    uint32_t now = time_us_32();
+    uint8_t accepted = 0;
+    uint8_t err[3];
+    uint8_t err_len = 0;
+    pos = 3;
+    for (; accepted < count; accepted++)
+    {
+        uint32_t due = (uint32_t)args[pos] | ((uint32_t)args[pos + 1] << 8) |
+                       ((uint32_t)args[pos + 2] << 16) | ((uint32_t)args[pos + 3] << 24);
+        uint8_t rlen = args[pos + 5];
+        int itf = hid_proxy_host_resolve_inject_itf(args[pos + 4]);
+        if (itf < 0)
+        {
+            err[0] = CTRL_ERR_INJECT_FAILED;
+            err[1] = accepted;
+            err_len = 2;
+            break;
+        }
+        inject_sched_result_t res = inject_sched_add(absolute ? due : now + due, tag, (uint8_t)itf,
+                                                     &args[pos + 6], rlen);
+        if (res != INJECT_SCHED_OK)
+        {
+            err[0] = CTRL_ERR_SCHEDULE;
+            err[1] = (uint8_t)res;
+            err[2] = accepted;
+            err_len = 3;
+            break;
+        }
+        pos = (uint16_t)(pos + 6u + rlen);
+    }
+
+    if (flags & CTRL_FLAG_NO_ACK)
+    {
+        ctrl_ack_record(seq, err_len == 0, use_bootstrap);
+        return;
+    }
+
+    if (err_len)
+    {
+        // Earlier tuples stay queued; cancel the tag for all-or-nothing.
+        ctrl_send_response(seq, 0x11, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, err, err_len, use_bootstrap);
+        return;
+    }
+
+    inject_sched_stats_t st;
+    inject_sched_get_stats(&st, false);
+    uint8_t resp[6];
+    resp[0] = accepted;
+    resp[1] = st.pending;
+    put_le32(&resp[2], now);
+    ctrl_send_response(seq, 0x11, CTRL_FLAG_RESPONSE, resp, sizeof(resp), use_bootstrap);
+}
+
+// Payload: subcommand, then its arguments (see handle_sched_add for ADD).
+// CANCEL: tag LE16 (0xFFFF = all) -> removed, pending. STATS: [reset].
+static void handle_schedule(uint8_t seq, uint8_t flags, uint8_t const* payload, uint8_t payload_len,
+                            bool use_bootstrap)
+{
+    uint8_t const* args = &payload[1];
+    uint8_t args_len = (uint8_t)(payload_len - 1u);
+    switch (payload[0])
+    {
+        case CTRL_SCHED_ADD:
+            handle_sched_add(seq, flags, args, args_len, use_bootstrap);
+            return;
+        case CTRL_SCHED_CANCEL:
+        {
+            if (args_len != 2) break;
+            uint8_t resp[2];
+            resp[0] = inject_sched_cancel((uint16_t)args[0] | ((uint16_t)args[1] << 8));
+            inject_sched_stats_t st;
+            inject_sched_get_stats(&st, false);
+            resp[1] = st.pending;
+            ctrl_send_response(seq, 0x11, CTRL_FLAG_RESPONSE, resp, sizeof(resp), use_bootstrap);
+            return;
+        }
+        case CTRL_SCHED_STATS:
+            if (args_len > 1) break;
+            send_sched_stats(seq, args_len == 1 && args[0] != 0, use_bootstrap);
+            return;
+        default:
+            break;
+    }
+    uint8_t err = CTRL_ERR_BAD_LEN;
+    ctrl_send_response(seq, 0x11, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap);
+}
+
+// Payload: none (status), STOP, or mode, itf_sel, buttons, x LE16, y LE16,
+// wheel, max_step, scale_q8 LE16, interval_us LE16. Response: active,
+// remaining LE16, interval_us LE16, sent, failed (LE32).
+static void handle_move(uint8_t seq, uint8_t const* payload, uint8_t payload_len, bool use_bootstrap)
+{
+    if (payload_len == 1 && payload[0] == CTRL_MOVE_STOP)
+    {
+        pointer_move_stop();
+    }
+    else if (payload_len == CTRL_MOVE_REQ_LEN && payload[0] <= POINTER_MOVE_TO)
+    {
+        pointer_move_req_t req;
+        req.mode        = payload[0];
+        req.itf_sel     = payload[1];
+        req.buttons     = payload[2];
+        req.x           = (int16_t)((uint16_t)payload[3] | ((uint16_t)payload[4] << 8));
+        req.y           = (int16_t)((uint16_t)payload[5] | ((uint16_t)payload[6] << 8));
+        req.wheel       = (int8_t)payload[7];
+        req.max_step    = payload[8];
+        req.scale_q8    = (uint16_t)payload[9] | ((uint16_t)payload[10] << 8);
+        req.interval_us = (uint16_t)payload[11] | ((uint16_t)payload[12] << 8);
+        pointer_move_result_t res = pointer_move_start(&req);
+        if (res != POINTER_MOVE_OK)
+        {
+            uint8_t err = (res == POINTER_MOVE_ERR_LAYOUT) ? CTRL_ERR_LAYOUT_MISSING : CTRL_ERR_INJECT_FAILED;
+            ctrl_send_response(seq, 0x12, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap);
+            return;
+        }
+    }
+    else if (payload_len != 0)
+    {
+        uint8_t err = CTRL_ERR_BAD_LEN;
+        ctrl_send_response(seq, 0x12, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap);
+        return;
+    }
+
+    pointer_move_status_t st;
+    pointer_move_get_status(&st);
+    uint8_t resp[13];
+    resp[0] = st.active;
+    put_le16(&resp[1], st.remaining);
+    put_le16(&resp[3], st.interval_us);
+    put_le32(&resp[5], st.sent);
+    put_le32(&resp[9], st.failed);
+    ctrl_send_response(seq, 0x12, CTRL_FLAG_RESPONSE, resp, sizeof(resp), use_bootstrap);
+}
+
+// Payload: active, queued LE16, free LE16, interval_us LE16, typed LE32,
+// unmapped LE16, failed LE16. Shared by TYPE_TEXT responses and TYPE_EVENT.
+static void send_type_status(uint8_t seq, uint8_t cmd, bool use_bootstrap)
+{
+    text_type_status_t st;
+    text_type_get_status(&st);
+
+    uint8_t payload[CTRL_TYPE_STATUS_LEN];
+    payload[0] = st.active;
+    put_le16(&payload[1], st.queued);
+    put_le16(&payload[3], st.free);
+    put_le16(&payload[5], st.interval_us);
+    put_le32(&payload[7], st.typed);
+    put_le16(&payload[11], st.unmapped);
+    put_le16(&payload[13], st.failed);
+    ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE, payload, sizeof(payload), use_bootstrap);
+}
+
+// Payload: none (status), CANCEL, or APPEND header + UTF-8 text.
+static void handle_type_text(uint8_t seq, uint8_t const* payload, uint8_t payload_len, bool use_bootstrap)
+{
+    if (payload_len == 1 && payload[0] == CTRL_TYPE_CANCEL)
+    {
+        text_type_cancel();
+    }
+    else if (payload_len >= CTRL_TYPE_HDR_LEN && payload[0] == CTRL_TYPE_APPEND)
+    {
+        text_type_status_t st;
+        text_type_get_status(&st);
+        uint8_t flags = payload[3];
+        uint16_t interval_us = (uint16_t)payload[4] | ((uint16_t)payload[5] << 8);
+        text_type_result_t res = text_type_append(payload[1], payload[2], flags & TEXT_TYPE_FLAG_RELEASE_EACH,
+                                                  interval_us, &payload[CTRL_TYPE_HDR_LEN],
+                                                  (uint16_t)(payload_len - CTRL_TYPE_HDR_LEN));
+        if (res == TEXT_TYPE_ERR_ITF)
+        {
+            uint8_t err = CTRL_ERR_INJECT_FAILED;
+            ctrl_send_response(seq, 0x13, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap);
+            return;
+        }
+        if (res != TEXT_TYPE_OK)
+        {
+            uint8_t err[2] = { CTRL_ERR_TYPE, (uint8_t)res };
+            ctrl_send_response(seq, 0x13, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, err, sizeof(err), use_bootstrap);
+            return;
+        }
+        if (!st.active)
+        {
+            // Events follow the request that starts typing; appends only add text.
+            s_ctrl_type.events = (flags & CTRL_TYPE_FLAG_EVENTS) != 0;
+            s_ctrl_type.seq = 0;
+            s_ctrl_type.next_us = time_us_32() + PROXY_TYPE_TEXT_PROGRESS_MS * 1000u;
+            s_ctrl_type.reply_fast = s_ctrl_reply_fast;
+            s_ctrl_type.reply_bootstrap = use_bootstrap;
+        }
+    }
+    else if (payload_len != 0)
+    {
+        uint8_t err = CTRL_ERR_BAD_LEN;
+        ctrl_send_response(seq, 0x13, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap);
+        return;
+    }
+    send_type_status(seq, 0x13, use_bootstrap);
+}
+
+// TYPE_EVENT: one frame per PROXY_TYPE_TEXT_PROGRESS_MS while typing and one
+// when the queue has drained, so the controller need not poll.
+static void ctrl_type_events(void)
+{
+    text_type_status_t st;
+    text_type_get_status(&st);
+    bool done = s_ctrl_type.was_active && !st.active;
+    s_ctrl_type.was_active = st.active;
+    if (!s_ctrl_type.events) return;
+
+    bool tick = st.active && (int32_t)(time_us_32() - s_ctrl_type.next_us) >= 0;
+    if (!done && !tick) return;
+    if (tick) s_ctrl_type.next_us = time_us_32() + PROXY_TYPE_TEXT_PROGRESS_MS * 1000u;
+
+    bool prev_fast = s_ctrl_reply_fast;
+    s_ctrl_reply_fast = s_ctrl_type.reply_fast && s_ctrl_fast.active;
+    send_type_status(s_ctrl_type.seq++, 0x14, s_ctrl_type.reply_bootstrap);
+    s_ctrl_reply_fast = prev_fast;
+}
+
+// Payload: itf, injected mods, buttons, count, keys[count], then the physical
+// mods, buttons, count, keys[count].
+static void send_key_state(uint8_t seq, uint8_t itf, bool use_bootstrap)
+{
+    input_state_view_t v;
+    if (!input_state_get(itf, &v))
+    {
+        uint8_t err = CTRL_ERR_INJECT_FAILED;
+        ctrl_send_response(seq, 0x15, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap);
+        return;
+    }
+
+    uint8_t payload[7 + PROXY_INPUT_STATE_MAX_KEYS + INPUT_STATE_PHYS_KEYS];
+    uint8_t pos = 0;
+    payload[pos++] = v.itf;
+    payload[pos++] = v.inj_mods;
+    payload[pos++] = v.inj_buttons;
+    payload[pos++] = v.inj_count;
+    memcpy(&payload[pos], v.inj_keys, v.inj_count);
+    pos = (uint8_t)(pos + v.inj_count);
+    payload[pos++] = v.phys_mods;
+    payload[pos++] = v.phys_buttons;
+    payload[pos++] = v.phys_count;
+    memcpy(&payload[pos], v.phys_keys, v.phys_count);
+    pos = (uint8_t)(pos + v.phys_count);
+    ctrl_send_response(seq, 0x15, CTRL_FLAG_RESPONSE, payload, pos, use_bootstrap);
+}
+
+static void handle_key(uint8_t seq, uint8_t flags, uint8_t const* payload, uint8_t payload_len, bool use_bootstrap)
+{
+    if (payload_len < 2)
+    {
+        ctrl_inject_result(seq, 0x15, flags, CTRL_ERR_BAD_LEN, use_bootstrap);
+        return;
+    }
+
+    uint8_t op = payload[0];
+    uint8_t itf_sel = payload[1];
+    uint8_t itf = itf_sel;
+    input_state_result_t res;
+    switch (op)
+    {
+        case CTRL_KEY_DOWN:
+        case CTRL_KEY_UP:
+            res = input_state_keys(itf_sel, op == CTRL_KEY_DOWN, &payload[2], (uint8_t)(payload_len - 2), &itf);
+            break;
+        case CTRL_KEY_BUTTON_DOWN:
+        case CTRL_KEY_BUTTON_UP:
+            if (payload_len != 3)
+            {
+                ctrl_inject_result(seq, 0x15, flags, CTRL_ERR_BAD_LEN, use_bootstrap);
+                return;
+            }
+            res = input_state_buttons(itf_sel, op == CTRL_KEY_BUTTON_DOWN, payload[2], &itf);
+            break;
+        case CTRL_KEY_RELEASE_ALL:
+            res = input_state_release_all(itf_sel);
+            if (res == INPUT_STATE_OK && itf_sel != INPUT_STATE_ITF_ALL)
+            {
+                int resolved = hid_proxy_host_resolve_inject_itf(itf_sel);
+                if (resolved >= 0) itf = (uint8_t)resolved;
+            }
+            break;
+        case CTRL_KEY_STATE:
+        {
+            int resolved = hid_proxy_host_resolve_inject_itf(itf_sel);
+            if (resolved < 0)
+            {
+                ctrl_inject_result(seq, 0x15, flags & (uint8_t)~CTRL_FLAG_NO_ACK, CTRL_ERR_INJECT_FAILED, use_bootstrap);
+                return;
+            }
+            send_key_state(seq, (uint8_t)resolved, use_bootstrap);
+            return;
+        }
+        default:
+            ctrl_inject_result(seq, 0x15, flags, CTRL_ERR_BAD_LEN, use_bootstrap);
+            return;
+    }
+
+    uint8_t err = 0;
+    if (res == INPUT_STATE_ERR_ITF) err = CTRL_ERR_INJECT_FAILED;
+    else if (res == INPUT_STATE_ERR_LAYOUT) err = CTRL_ERR_LAYOUT_MISSING;
+    else if (res == INPUT_STATE_ERR_FULL) err = CTRL_ERR_KEYS_FULL;
+
+    if (err || (flags & CTRL_FLAG_NO_ACK) || itf == INPUT_STATE_ITF_ALL)
+    {
+        ctrl_inject_result(seq, 0x15, flags, err, use_bootstrap);
+        return;
+    }
+    send_key_state(seq, itf, use_bootstrap);
+}
+
+#define CTRL_MIX_ENTRY_LEN 20u
+
+// Empty payload: query. [itf_sel, policy] sets the policy first; itf_sel is a
+// number, 0xFF/0xFE as INJECT_REPORT, or 0xFD for every interface. Response:
+// count, then per interface slot: itf, policy, interval_us LE16, physical_in,
+// injected_in, merged_out, suppressed (LE32 each).
+static void handle_mix(uint8_t seq, uint8_t const* payload, uint8_t payload_len, bool use_bootstrap)
+{
+    if (payload_len != 0 && (payload_len != 2 || payload[1] >= INPUT_MIX_POLICY_COUNT))
+    {
+        uint8_t err = CTRL_ERR_BAD_LEN;
+        ctrl_send_response(seq, 0x16, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap);
+        return;
+    }
+    if (payload_len == 2)
+    {
+        uint8_t itf = payload[0];
+        if (itf == 0xFF || itf == 0xFE)
+        {
+            int resolved = hid_proxy_host_resolve_inject_itf(itf);
+            itf = resolved < 0 ? 0xFF : (uint8_t)resolved;
+        }
+        if (!input_mixer_set_policy(itf, payload[1]))
+        {
+            uint8_t err = CTRL_ERR_INJECT_FAILED;
+            ctrl_send_response(seq, 0x16, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap);
+            return;
+        }
+    }
+
+    uint8_t resp[1 + CFG_TUH_HID * CTRL_MIX_ENTRY_LEN];
+    uint8_t pos = 0;
+    resp[pos++] = CFG_TUH_HID;
+    for (uint8_t i = 0; i < CFG_TUH_HID; i++)
+    {
+        input_mixer_stats_t st;
+        input_mixer_get_stats(i, &st);
+        resp[pos++] = st.itf;
+        resp[pos++] = st.policy;
+        put_le16(&resp[pos], st.interval_us);
+        put_le32(&resp[pos + 2], st.physical_in);
+        put_le32(&resp[pos + 6], st.injected_in);
+        put_le32(&resp[pos + 10], st.merged_out);
+        put_le32(&resp[pos + 14], st.suppressed);
+        pos = (uint8_t)(pos + 18u);
+    }
+    ctrl_send_response(seq, 0x16, CTRL_FLAG_RESPONSE, resp, pos, use_bootstrap);
+}
+
+#define CTRL_LOG_READ_HDR_LEN 7u
+
+// Empty payload: read. [mode] first switches the drain: 0 text on stdio,
+// 1 "@L" records on stdio, 2 held for this command. Response: mode, dropped
+// LE32, words still queued LE16, then whole ring entries (LE words, decoded
+// by tools/logdecode against the ELF).
+static void handle_log_read(uint8_t seq, uint8_t const* payload, uint8_t payload_len, bool use_bootstrap)
+{
+    if (payload_len > 1 || (payload_len == 1 && payload[0] > LOG_DRAIN_HOLD))
+    {
+        uint8_t err = CTRL_ERR_BAD_LEN;
+        ctrl_send_response(seq, 0x17, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap);
+        return;
+    }
+    if (payload_len == 1) logging_set_drain(payload[0]);
+
+    uint8_t resp[CTRL_TM_MAX_LEN];
+    uint16_t len = logging_read(&resp[CTRL_LOG_READ_HDR_LEN], (uint16_t)(sizeof(resp) - CTRL_LOG_READ_HDR_LEN));
+    logging_stats_t st;
+    logging_get_stats(&st);
+    resp[0] = logging_get_drain();
+    put_le32(&resp[1], st.dropped);
+    put_le16(&resp[5], st.used_words > UINT16_MAX ? UINT16_MAX : (uint16_t)st.used_words);
+    ctrl_send_response(seq, 0x17, CTRL_FLAG_RESPONSE, resp, (uint8_t)(CTRL_LOG_READ_HDR_LEN + len), use_bootstrap);
+}
+
+// GET_METRICS: [board, start]. Board 1 (A_device) serves the snapshot cached
+// on B_host; asking for its first page also pulls a fresh one over the link.
+#define CTRL_METRICS_HDR_LEN     8u
+#define CTRL_METRICS_BOARD_HOST  0u
+#define CTRL_METRICS_BOARD_DEV   1u
+
+static void handle_get_metrics(uint8_t seq, uint8_t const* payload, uint8_t payload_len, bool use_bootstrap)
+{
+    uint8_t board = payload_len >= 1 ? payload[0] : CTRL_METRICS_BOARD_HOST;
+    uint8_t start = payload_len >= 2 ? payload[1] : 0;
+    if (payload_len > 2 || board > CTRL_METRICS_BOARD_DEV)
+    {
+        uint8_t err = CTRL_ERR_BAD_LEN;
+        ctrl_send_response(seq, 0x18, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap);
+        return;
+    }
+
+    uint8_t resp[CTRL_TM_MAX_LEN];
+    uint8_t* entries = &resp[CTRL_METRICS_HDR_LEN];
+    uint16_t room = (uint16_t)(sizeof(resp) - CTRL_METRICS_HDR_LEN);
+    uint8_t count = 0;
+    uint8_t total;
+    uint32_t age_ms = 0;
+    uint16_t len;
+    if (board == CTRL_METRICS_BOARD_HOST)
+    {
+        len = metrics_encode(start, entries, room, &count);
+        total = metrics_count();
+    }
+    else
+    {
+        len = hid_proxy_host_dev_metrics(start, entries, room, &count, &total, &age_ms);
+        if (start == 0) (void)hid_proxy_host_dev_metrics_pull();
+    }
+
+    resp[0] = board;
+    resp[1] = total;
+    resp[2] = start;
+    resp[3] = count;
+    put_le32(&resp[4], age_ms);
+    ctrl_send_response(seq, 0x18, CTRL_FLAG_RESPONSE, resp, (uint8_t)(CTRL_METRICS_HDR_LEN + len), use_bootstrap);
+}
+
+#define CTRL_FANOUT_OP_FOCUS  0u
+#define CTRL_FANOUT_OP_ROUTE  1u
+#define CTRL_FANOUT_OP_RESYNC 2u
+#define CTRL_FANOUT_HDR_LEN   7u
+#define CTRL_FANOUT_TGT_LEN   13u
+
+// Empty payload: query. [0, target] moves the focus, [1, itf, target] pins an
+// interface to a target (0xFF: follow the focus), [2, target] sends the
+// descriptor set to that target alone. Response: targets, focus, descriptor
+// scope mask, focus switches LE32; per target ready, tx_frames, tx_errors,
+// rx_frames (LE32 each); then a count and the route entry of each interface.
+static void handle_fanout(uint8_t seq, uint8_t const* payload, uint8_t payload_len, bool use_bootstrap)
+{
+    bool bad_len = false;
+    bool ok = true;
+    if (payload_len)
+    {
+        switch (payload[0])
+        {
+            case CTRL_FANOUT_OP_FOCUS:
+                bad_len = payload_len != 2;
+                ok = bad_len || hid_proxy_host_set_focus(payload[1]);
+                break;
+            case CTRL_FANOUT_OP_ROUTE:
+                bad_len = payload_len != 3;
+                ok = bad_len || fanout_set_route(payload[1], payload[2]);
+                break;
+            case CTRL_FANOUT_OP_RESYNC:
+                bad_len = payload_len != 2;
+                ok = bad_len || hid_proxy_host_fanout_resync(payload[1]);
+                break;
+            default:
+                bad_len = true;
+                break;
+        }
+    }
+    if (bad_len || !ok)
+    {
+        uint8_t err = bad_len ? CTRL_ERR_BAD_LEN : CTRL_ERR_INJECT_FAILED;
+        ctrl_send_response(seq, 0x19, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap);
+        return;
+    }
+
+    uint8_t resp[CTRL_FANOUT_HDR_LEN + FANOUT_MAX_TARGETS * CTRL_FANOUT_TGT_LEN + 1 + CFG_TUH_HID];
+    uint8_t pos = 0;
+    resp[pos++] = fanout_targets();
+    resp[pos++] = fanout_focus();
+    resp[pos++] = fanout_desc_scope();
+    put_le32(&resp[pos], fanout_switch_count());
+    pos = (uint8_t)(pos + 4u);
+    for (uint8_t t = 0; t < fanout_targets(); t++)
+    {
+        fanout_target_stats_t st;
+        fanout_target_stats(t, &st);
+        resp[pos++] = st.ready ? 1 : 0;
+        put_le32(&resp[pos], st.tx_frames);
+        put_le32(&resp[pos + 4], st.tx_errors);
+        put_le32(&resp[pos + 8], st.rx_frames);
+        pos = (uint8_t)(pos + 12u);
+    }
+    resp[pos++] = CFG_TUH_HID;
+    for (uint8_t i = 0; i < CFG_TUH_HID; i++)
+    {
+        resp[pos++] = fanout_route_entry(i);
+    }
+    ctrl_send_response(seq, 0x19, CTRL_FLAG_RESPONSE, resp, pos, use_bootstrap);
+}
+
+// Sends whole frames only while the TX ring can take them; otherwise the
+// entries stay in the tap ring, where the drop policy applies.
+static void ctrl_tap_drain(void)
+{
+    if (input_tap_mode() == INPUT_TAP_OFF) return;
+
+    uint32_t oldest_us;
+    if (!input_tap_oldest_us(&oldest_us)) return;
+
+    input_tap_stats_t st;
+    input_tap_get_stats(&st);
+    bool due = (time_us_32() - oldest_us) >= (uint32_t)s_ctrl_tap.flush_ms * 1000u ||
+               st.used >= st.depth / 2u;
+    if (!due) return;
+
+    for (uint8_t frames = 0; frames < CTRL_TAP_MAX_FRAMES_PER_PASS; frames++)
+    {
+        // Worst case SLIP doubles every byte of the signed frame.
+        uint32_t free_bytes = ctrl_tx_free();
+        uint32_t room = free_bytes > 2u + 2u * CTRL_V2_MIN_LEN ? (free_bytes - 2u) / 2u - CTRL_V2_MIN_LEN : 0;
+        if (room > CTRL_TM_MAX_LEN) room = CTRL_TM_MAX_LEN;
+        if (room < CTRL_TAP_HDR_LEN + INPUT_TAP_ENTRY_HDR + INPUT_TAP_REPORT_MAX) return;
+
+        uint8_t payload[CTRL_TM_MAX_LEN];
+        uint8_t count = 0;
+        uint16_t len = input_tap_drain(&payload[CTRL_TAP_HDR_LEN], (uint16_t)(room - CTRL_TAP_HDR_LEN), &count);
+        if (!count) return;
+
+        input_tap_get_stats(&st);
+        payload[0] = count;
+        put_le16(&payload[1], st.used);
+        put_le16(&payload[3], st.high_water);
+        put_le32(&payload[5], st.dropped_oldest + st.dropped_newest);
+
+        bool prev_fast = s_ctrl_reply_fast;
+        s_ctrl_reply_fast = s_ctrl_tap.reply_fast && s_ctrl_fast.active;
+        ctrl_send_response(s_ctrl_tap.seq++, 0x0F, CTRL_FLAG_RESPONSE, payload,
+                           (uint8_t)(CTRL_TAP_HDR_LEN + len), s_ctrl_tap.reply_bootstrap);
+        s_ctrl_reply_fast = prev_fast;
+
+        if (!st.used) return;
+    }
+}
+
+// Payload: count, then count x (itf_sel, delay_us LE16, len, report[len]).
+// The whole batch is checked before anything is injected, so a malformed
+// tail never leaves half a macro on the link.
+static void handle_inject_batch(uint8_t seq, uint8_t flags, uint8_t const* payload, uint8_t payload_len,
+                                bool use_bootstrap)
+{
+    uint8_t count = payload_len ? payload[0] : 0;
+    uint16_t pos = 1;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (pos + 4u > payload_len || payload[pos + 3] == 0) { pos = 0; break; }
+        pos = (uint16_t)(pos + 4u + payload[pos + 3]);
+    }
+    if (count == 0 || pos != payload_len)
+    {
+        ctrl_inject_result(seq, 0x0A, flags, CTRL_ERR_BAD_LEN, use_bootstrap);
+        return;
+    }
+
+    uint8_t accepted = 0;
+    pos = 1;
+    for (; accepted < count; accepted++)
+    {
+        uint8_t itf_sel = payload[pos];
+        uint16_t delay_us = (uint16_t)payload[pos + 1] | ((uint16_t)payload[pos + 2] << 8);
+        uint8_t rlen = payload[pos + 3];
+        if (!hid_proxy_host_inject_report_after(itf_sel, &payload[pos + 4], rlen, delay_us)) break;
+        pos = (uint16_t)(pos + 4u + rlen);
+    }
+
+    if (flags & CTRL_FLAG_NO_ACK)
+    {
+        ctrl_ack_record(seq, accepted == count, use_bootstrap);
+        return;
+    }
+
+    if (accepted < count)
+    {
+        // Later tuples are not attempted: the rest of a sequence is meaningless without it.
+        uint8_t err[2] = { CTRL_ERR_INJECT_FAILED, accepted };
+        ctrl_send_response(seq, 0x0A, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, err, sizeof(err), use_bootstrap);
+        return;
+    }
+
+    uint8_t pending = 0;
+    uint32_t dropped = 0;
+    hid_proxy_host_inject_queue_state(&pending, &dropped);
+    uint8_t resp[6];
+    resp[0] = accepted;
+    resp[1] = pending;
+    put_le32(&resp[2], dropped);
+    ctrl_send_response(seq, 0x0A, CTRL_FLAG_RESPONSE, resp, sizeof(resp), use_bootstrap);
+}
+
+static void ctrl_rx_reset(void)
+{
+    s_ctrl_rx_len = 0;
+    s_ctrl_rx_esc = false;
+    s_ctrl_rx_too_long = false;
+}
+
+static bool ctrl_hmac_equal(const uint8_t* a, const uint8_t* b, uint16_t len)
+{
+    uint8_t diff = 0;
+    for (uint16_t i = 0; i < len; i++)
+    {
+        diff |= (uint8_t)(a[i] ^ b[i]);
+    }
+    return diff == 0;
+}
+
+// One MAC per frame in the steady state: the key that verified the previous
+// frame is tried first, the other one only when the controller switches keys.
+static hmac_key_kind_t ctrl_verify_hmac(uint8_t cmd, const uint8_t* data, uint16_t payload_len)
+{
+    hmac_key_kind_t first = (cmd == 0x06) ? HMAC_KEY_BOOTSTRAP : s_ctrl_session_key;
+    hmac_key_kind_t second = (first == HMAC_KEY_DERIVED) ? HMAC_KEY_BOOTSTRAP : HMAC_KEY_DERIVED;
+    size_t mac_len = (size_t)(CTRL_V2_HDR_LEN + payload_len + CTRL_V2_CRC_LEN);
+    uint8_t mac[32];
+
+    hmac_key_kind_t kind = HMAC_KEY_NONE;
+    hmac_sha256_with(ctrl_hmac_key(first), data, mac_len, mac);
+    if (ctrl_hmac_equal(mac, &data[8 + payload_len], CTRL_V2_HMAC_LEN))
+    {
+        kind = first;
+    }
+    else if (s_ctrl_hmac_ready)
+    {
+        hmac_sha256_with(ctrl_hmac_key(second), data, mac_len, mac);
+        if (ctrl_hmac_equal(mac, &data[8 + payload_len], CTRL_V2_HMAC_LEN))
+        {
+            kind = second;
+        }
+    }
+
+    // The bootstrap-only GET_DEVICE_ID does not move the session key.
+    if (kind != HMAC_KEY_NONE && cmd != 0x06)
+    {
+        s_ctrl_session_key = kind;
+    }
+    return kind;
+}
+
+// NO_ACK is honoured by INJECT_REPORT and INJECT_BATCH; queries always answer.
+static void ctrl_dispatch(uint8_t seq, uint8_t cmd, uint8_t flags,
+                          uint8_t const* payload, uint8_t payload_len, bool use_bootstrap)
+{
+    switch (cmd)
+    {
+        case 0x01: // INJECT_REPORT
+        {
+            if (payload_len < 2) { ctrl_inject_result(seq, cmd, flags, CTRL_ERR_BAD_LEN, use_bootstrap); return; }
+            uint8_t itf_sel = payload[0];
+            uint8_t rlen    = payload[1];
+            if ((uint16_t)rlen > (uint16_t)(payload_len - 2))
+            {
+                rlen = (uint8_t)(payload_len - 2);
+            }
+            if (rlen == 0) { ctrl_inject_result(seq, cmd, flags, CTRL_ERR_BAD_LEN, use_bootstrap); return; }
+
+            bool ok = hid_proxy_host_inject_report(itf_sel, &payload[2], rlen);
+            ctrl_inject_result(seq, cmd, flags, ok ? 0 : CTRL_ERR_INJECT_FAILED, use_bootstrap);
+            break;
+        }
+        case 0x02: // LIST_INTERFACES
+        {
+            send_interface_list(seq, use_bootstrap);
+            break;
+        }
+        case 0x04: // GET_REPORT_DESC
+        {
+            if (payload_len < 1) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
+            send_report_descriptor(seq, payload[0], use_bootstrap);
+            break;
+        }
+        case 0x05: // GET_REPORT_LAYOUT
+        {
+            if (payload_len < 2) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
+            send_report_layout(seq, payload[0], payload[1], use_bootstrap);
+            break;
+        }
+        case 0x03: // SET_LOG_LEVEL
+        {
+            if (payload_len < 1) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
+            logging_set_level(payload[0]);
+            ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE, NULL, 0, use_bootstrap);
+            break;
+        }
+        case 0x06: // GET_DEVICE_ID
+        {
+            if (payload_len != 0) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
+            send_device_id(seq);
+            break;
+        }
+        case 0x07: // GET_TRACE
+        {
+            if (payload_len < 1) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
+            send_trace_page(seq, payload[0], payload_len > 1 ? payload[1] : 0, use_bootstrap);
+            break;
+        }
+        case 0x08: // GET_CTRL_STATS
+        {
+            send_ctrl_stats(seq, use_bootstrap);
+            break;
+        }
+        case 0x09: // SESSION_SETUP
+        {
+            if (payload_len != CTRL_SESSION_NONCE_LEN) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
+            // Only a full-HMAC frame under the derived key may agree a session key.
+            if (use_bootstrap || s_ctrl_reply_fast) { uint8_t err = CTRL_ERR_SESSION_KEY; ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
+            start_fast_session(seq, payload);
+            break;
+        }
+        case 0x0A: // INJECT_BATCH
+        {
+            handle_inject_batch(seq, flags, payload, payload_len, use_bootstrap);
+            break;
+        }
+        case 0x0B: // SET_ACK_MODE
+        {
+            if (payload_len != 3) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
+            set_ack_mode(seq, payload, use_bootstrap);
+            break;
+        }
+        case 0x0D: // SUBSCRIBE
+        {
+            if (payload_len != 3) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
+            subscribe_telemetry(seq, payload, use_bootstrap);
+            break;
+        }
+        case 0x0E: // TAP
+        {
+            if (payload_len != 0 && payload_len != 3) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
+            handle_tap(seq, payload, payload_len, use_bootstrap);
+            break;
+        }
+        case 0x10: // REPLAY
+        {
+            if (payload_len < 1) { uint8_t err = CTRL_ERR_BAD_LEN; ctrl_send_response(seq, cmd, CTRL_FLAG_RESPONSE | CTRL_FLAG_ERROR, &err, 1, use_bootstrap); return; }
+            handle_replay(seq, payload, payload_len, use_bootstrap);
+            break;
+        }
+        case 0x11: // SCHEDULE
+        {
+            if (payload_len < 1) { ctrl_inject_result(seq, cmd, flags, CTRL_ERR_BAD_LEN, use_bootstrap); return; }
+            handle_schedule(seq, flags, payload, payload_len, use_bootstrap);
+            break;
+        }
+        case 0x12: // MOVE
+        {
+            handle_move(seq, payload, payload_len, use_bootstrap);
+            break;
+        }
+        case 0x13: // TYPE_TEXT
+        {
+            handle_type_text(seq, payload, payload_len, use_bootstrap);
+            break;
+        }
+        case 0x15: // KEY
+        {
+            handle_key(seq, flags, payload, payload_len, use_bootstrap);
+            break;
+        }
+        case 0x16: // MIX
+        {
+            handle_mix(seq, payload, payload_len, use_bootstrap);
+            break;
+        }
+        case 0x17: // LOG_READ
+        {
+            handle_log_read(seq, payload, payload_len, use_bootstrap);
+            break;
+        }
+        case 0x18: // GET_METRICS
+        {
+            handle_get_metrics(seq, payload, payload_len, use_bootstrap);
+            break;
+        }
+        case 0x19: // FANOUT
+        {
+            handle_fanout(seq, payload, payload_len, use_bootstrap);
+            break;
+        }
+
+        default:
+            // Unknown command: ignore.
+            break;
+    }
+}
+
+static void handle_v2_frame(uint8_t const* data, uint16_t len)
+{
+    if (len < CTRL_V2_MIN_LEN) { s_ctrl_stats.bad_frames++; return; }
+
+    uint8_t payload_len = data[5];
+    uint16_t total_len = (uint16_t)(CTRL_V2_HDR_LEN + payload_len + CTRL_V2_CRC_LEN + CTRL_V2_HMAC_LEN);
+    if (len != total_len) { s_ctrl_stats.bad_frames++; return; }
+
+    uint16_t crc = crc16_ccitt(data, (uint32_t)(CTRL_V2_HDR_LEN + payload_len), 0xFFFF);
+    uint16_t msg_crc = (uint16_t)data[6 + payload_len] | ((uint16_t)data[7 + payload_len] << 8);
+    if (crc != msg_crc) { s_ctrl_stats.bad_frames++; return; }
+
+    hmac_key_kind_t key_kind = ctrl_verify_hmac(data[4], data, payload_len);
+    if (key_kind == HMAC_KEY_NONE) { s_ctrl_stats.auth_failures++; return; }
+
+    ctrl_dispatch(data[3], data[4], data[2], &data[6], payload_len, key_kind == HMAC_KEY_BOOTSTRAP);
+}
+
+static void handle_fast_frame(uint8_t const* data, uint16_t len)
+{
+    if (len < CTRL_FAST_MIN_LEN) { s_ctrl_stats.bad_frames++; return; }
+
+    uint8_t payload_len = data[5];
+    uint16_t body_len = (uint16_t)(CTRL_FAST_HDR_LEN + payload_len);
+    if (len != (uint16_t)(body_len + CTRL_V2_CRC_LEN + CTRL_FAST_TAG_LEN)) { s_ctrl_stats.bad_frames++; return; }
+
+    uint16_t crc = crc16_ccitt(data, body_len, 0xFFFF);
+    uint16_t msg_crc = (uint16_t)data[body_len] | ((uint16_t)data[body_len + 1] << 8);
+    if (crc != msg_crc) { s_ctrl_stats.bad_frames++; return; }
+
+    if (!s_ctrl_fast.active) { s_ctrl_stats.auth_failures++; return; }
+    uint64_t tag = siphash24(&s_ctrl_fast.key, data, (size_t)(body_len + CTRL_V2_CRC_LEN));
+    uint8_t expect[CTRL_FAST_TAG_LEN];
+    put_le32(&expect[0], (uint32_t)tag);
+    put_le32(&expect[4], (uint32_t)(tag >> 32));
+    if (!ctrl_hmac_equal(expect, &data[body_len + CTRL_V2_CRC_LEN], CTRL_FAST_TAG_LEN))
+    {
+        s_ctrl_stats.auth_failures++;
+        return;
+    }
+
+    // Both directions share the key: a reflected B_host response must not
+    // be accepted as a command. The counter must strictly increase.
+    if (data[2] & CTRL_FLAG_RESPONSE) { s_ctrl_stats.auth_failures++; return; }
+    uint32_t counter = (uint32_t)data[6] | ((uint32_t)data[7] << 8) |
+                       ((uint32_t)data[8] << 16) | ((uint32_t)data[9] << 24);
+    if (counter <= s_ctrl_fast.rx_counter) { s_ctrl_stats.replay_rejects++; return; }
+    s_ctrl_fast.rx_counter = counter;
+
+    s_ctrl_reply_fast = true;
+    ctrl_dispatch(data[3], data[4], data[2], &data[CTRL_FAST_HDR_LEN], payload_len, false);
+    s_ctrl_reply_fast = false;
+}
+
+static void handle_ctrl_frame(uint8_t const* data, uint16_t len)
+{
+    if (!data || len < 2 || data[0] != CTRL_V2_MAGIC) { s_ctrl_stats.bad_frames++; return; }
+
+    if (data[1] == CTRL_V2_VERSION)
+    {
+        handle_v2_frame(data, len);
+    }
+    else if (data[1] == CTRL_FAST_VERSION)
+    {
+        handle_fast_frame(data, len);
+    }
+    else
+    {
+        s_ctrl_stats.bad_frames++;
+    }
+}
+
+// Returns true when SLIP_END closed a non-empty frame in s_ctrl_rx_buf; the
+// caller handles it and calls ctrl_rx_reset().
+static bool ctrl_slip_feed(uint8_t b)
+{
+    if (b == SLIP_END)
+    {
+        if (s_ctrl_rx_too_long)
+        {
+            s_ctrl_stats.frame_too_long++;
+            ctrl_rx_reset();
+            return false;
+        }
+        if (s_ctrl_rx_len)
+        {
+            return true;
+        }
+        ctrl_rx_reset();
+        return false;
+    }
+
+    if (s_ctrl_rx_too_long)
+    {
+        // Skip the rest of an oversized frame up to the next END.
+        return false;
+    }
+
+    if (b == SLIP_ESC)
+    {
+        s_ctrl_rx_esc = true;
+        return false;
+    }
+
+    if (s_ctrl_rx_esc)
+    {
+        if (b == SLIP_ESC_END)      b = SLIP_END;
+        else if (b == SLIP_ESC_ESC) b = SLIP_ESC;
+        s_ctrl_rx_esc = false;
+    }
+
+    if (s_ctrl_rx_len < CTRL_RX_BUF_MAX)
+    {
+        s_ctrl_rx_buf[s_ctrl_rx_len++] = b;
+    }
+    else
+    {
+        s_ctrl_rx_too_long = true;
+    }
+    return false;
+}
+
+#if PROXY_CTRL_UART_ENABLED
+// RX FIFO / RX timeout / TX IRQ: only moves bytes between the FIFOs and the rings. At 3 Mbaud the
+// 32-byte FIFO fills in ~107 us, shorter than a long tuh_task() pass.
+static void __isr ctrl_uart_irq_handler(void)
+{
+    uart_hw_t* hw = uart_get_hw(PROXY_CTRL_UART_ID);
+    uint32_t head = s_ctrl_rx_head;
+    uint32_t tail = s_ctrl_rx_tail;
+
+    while (!(hw->fr & UART_UARTFR_RXFE_BITS))
+    {
+        uint32_t dr = hw->dr;
+        s_ctrl_stats.rx_bytes++;
+        if (dr & UART_UARTDR_OE_BITS)
+        {
+            s_ctrl_stats.hw_overruns++;
+        }
+
+        uint32_t next = (head + 1u) & CTRL_RX_RING_MASK;
+        if (next == tail)
+        {
+            // Drop the newest byte: the broken frame fails its length/CRC
+            // check and the next SLIP_END resyncs.
+            s_ctrl_stats.ring_overflow_bytes++;
+            continue;
+        }
+        s_ctrl_rx_ring[head] = (uint8_t)dr;
+        head = next;
+    }
+
+    s_ctrl_rx_head = head;
+    uint32_t used = (head - tail) & CTRL_RX_RING_MASK;
+    if (used > s_ctrl_stats.ring_high_water)
+    {
+        s_ctrl_stats.ring_high_water = (uint16_t)used;
+    }
+
+    ctrl_tx_fill_fifo(hw);
+}
+#endif
+
+void control_uart_get_stats(control_uart_stats_t* out)
+{
+    if (!out) return;
+    uint32_t irq = save_and_disable_interrupts();
+    memcpy(out, (const void*)&s_ctrl_stats, sizeof(*out));
+    restore_interrupts(irq);
+    out->ring_size = (uint16_t)(PROXY_CTRL_UART_RX_RING_SIZE > 0xFFFFu ? 0xFFFFu
+                                                                       : PROXY_CTRL_UART_RX_RING_SIZE);
+}
+
+static void send_ctrl_stats(uint8_t seq, bool use_bootstrap)
+{
+    control_uart_stats_t st;
+    control_uart_get_stats(&st);
+
+    uint8_t payload[4 + 12 * 4];
+    payload[0] = (uint8_t)(st.ring_size & 0xFF);
+    payload[1] = (uint8_t)(st.ring_size >> 8);
+    payload[2] = (uint8_t)(st.ring_high_water & 0xFF);
+    payload[3] = (uint8_t)(st.ring_high_water >> 8);
+    put_le32(&payload[4],  st.rx_bytes);
+    put_le32(&payload[8],  st.rx_frames);
+    put_le32(&payload[12], st.ring_overflow_bytes);
+    put_le32(&payload[16], st.hw_overruns);
+    put_le32(&payload[20], st.frame_too_long);
+    put_le32(&payload[24], st.bad_frames);
+    put_le32(&payload[28], st.auth_failures);
+    put_le32(&payload[32], st.replay_rejects);
+    put_le32(&payload[36], st.sessions_started);
+    put_le32(&payload[40], st.tx_dropped_frames);
+    put_le32(&payload[44], st.cumulative_acks);
+    put_le32(&payload[48], st.no_ack_failures);
+    ctrl_send_response(seq, 0x08, CTRL_FLAG_RESPONSE, payload, sizeof(payload), use_bootstrap);
+}
+
+void control_uart_init(void)
+{
+#if !PROXY_CTRL_UART_ENABLED
+    return;
+#else
+    // Don't allow sharing the same UART as the internal bridge link.
+    if (PROXY_CTRL_UART_ID == PROXY_UART_ID)
+    {
+        LOGW("[CTRL] PROXY_CTRL_UART_ID conflicts with PROXY_UART_ID; control UART disabled");
+        return;
+    }
+
     uint32_t requested_baud = PROXY_CTRL_UART_BAUD;
     uint32_t actual_baud = uart_init(PROXY_CTRL_UART_ID, requested_baud);
 
@@ -478,6 +2139,14 @@ void control_uart_init(void)
 
     ctrl_init_hmac_key();
     ctrl_rx_reset();
+
+    while (uart_is_readable(PROXY_CTRL_UART_ID)) (void)uart_getc(PROXY_CTRL_UART_ID);
+    s_ctrl_rx_head = s_ctrl_rx_tail = 0;
+    s_ctrl_tx_head = s_ctrl_tx_tail = 0;
+    int irq = (PROXY_CTRL_UART_ID == uart0) ? UART0_IRQ : UART1_IRQ;
+    irq_set_exclusive_handler(irq, ctrl_uart_irq_handler);
+    irq_set_enabled(irq, true);
+    uart_set_irq_enables(PROXY_CTRL_UART_ID, true, false);
 #endif
 }
 
@@ -491,19 +2160,61 @@ void control_uart_task(void)
         return;
     }
 
-    // Keep processing bounded so we don't starve USB host tasks.
-    const uint32_t budget_us  = 500u;
+    if (s_ctrl_stats.ring_overflow_bytes != s_ctrl_overflow_logged)
+    {
+        s_ctrl_overflow_logged = s_ctrl_stats.ring_overflow_bytes;
+        LOGW("[CTRL] RX ring overflow, dropped=%lu hw_overruns=%lu",
+             (unsigned long)s_ctrl_overflow_logged,
+             (unsigned long)s_ctrl_stats.hw_overruns);
+    }
+
+    if (s_ctrl_ack.count &&
+        (time_us_32() - s_ctrl_ack.first_us) >= (uint32_t)s_ctrl_ack.interval_ms * 1000u)
+    {
+        ctrl_ack_flush();
+    }
+
+    if (s_ctrl_tm.interval_ms && (int32_t)(time_us_32() - s_ctrl_tm.next_us) >= 0)
+    {
+        // Skip missed ticks instead of bursting after a long stall.
+        uint32_t interval_us = (uint32_t)s_ctrl_tm.interval_ms * 1000u;
+        s_ctrl_tm.next_us += interval_us;
+        if ((int32_t)(time_us_32() - s_ctrl_tm.next_us) >= 0)
+        {
+            s_ctrl_tm.next_us = time_us_32() + interval_us;
+        }
+        ctrl_telemetry_send();
+    }
+
+    ctrl_tap_drain();
+    ctrl_type_events();
+
+    // Bytes are already safe in the ring, so only whole frames are budgeted:
+    // a batch ends after PROXY_CTRL_UART_RX_MAX_FRAMES frames or the time budget.
     const uint32_t t_start_us = time_us_32();
-    uint32_t bytes_processed  = 0;
-    const uint32_t max_bytes  = 512u;
+    uint32_t frames = 0;
+    uint32_t tail = s_ctrl_rx_tail;
+    uint32_t head = s_ctrl_rx_head;
 
-    while (uart_is_readable(PROXY_CTRL_UART_ID))
+    while (tail != head)
     {
-        uint8_t b = (uint8_t)uart_getc(PROXY_CTRL_UART_ID);
-        ctrl_slip_feed(b);
+        uint8_t b = s_ctrl_rx_ring[tail];
+        tail = (tail + 1u) & CTRL_RX_RING_MASK;
+        if (!ctrl_slip_feed(b))
+        {
+            continue;
+        }
+
+        // Release ring space before handling the frame.
+        s_ctrl_rx_tail = tail;
+        s_ctrl_stats.rx_frames++;
+        handle_ctrl_frame(s_ctrl_rx_buf, s_ctrl_rx_len);
+        ctrl_rx_reset();
 
-        if (++bytes_processed >= max_bytes) break;
-        if ((time_us_32() - t_start_us) >= budget_us) break;
+        if (++frames >= PROXY_CTRL_UART_RX_MAX_FRAMES) break;
+        if ((time_us_32() - t_start_us) >= PROXY_CTRL_UART_RX_BUDGET_US) break;
+        head = s_ctrl_rx_head;
     }
+    s_ctrl_rx_tail = tail;
 #endif
 }
@@ -14,6 +14,28 @@
 // - No responses/ACKs are sent (one-way control).
 // - SLIP markers: END=0xC0, ESC=0xDB, ESC_END=0xDC, ESC_ESC=0xDD.
 
+#include <stdint.h>
+
+// Receive-path counters. Everything the parser drops is counted somewhere here.
+typedef struct
+{
+    uint32_t rx_bytes;             // bytes taken from the hardware FIFO
+    uint32_t rx_frames;            // SLIP frames handed to the parser
+    uint32_t ring_overflow_bytes;  // bytes dropped because the RX ring was full
+    uint32_t hw_overruns;          // hardware FIFO overruns (UARTDR.OE)
+    uint32_t frame_too_long;       // SLIP frames longer than the frame buffer
+    uint32_t bad_frames;           // bad magic/version/length/CRC
+    uint32_t auth_failures;        // HMAC mismatch with both keys, bad fast-MAC tag
+    uint32_t replay_rejects;       // fast-MAC frames with a non-increasing counter
+    uint32_t sessions_started;     // accepted SESSION_SETUP commands
+    uint32_t tx_dropped_frames;    // responses dropped because the TX ring was full
+    uint32_t cumulative_acks;      // cumulative ACK frames sent for NO_ACK commands
+    uint32_t no_ack_failures;      // NO_ACK inject commands that failed
+    uint16_t ring_high_water;      // max bytes queued in the RX ring
+    uint16_t ring_size;
+} control_uart_stats_t;
+
 void control_uart_init(void);
 void control_uart_task(void);
+void control_uart_get_stats(control_uart_stats_t* out);
 
@@ -1,9 +1,14 @@
+#define LOG_MODULE LOG_MOD_DESC
+
 #include "descriptor_logger.h"
 
 #include "hid_proxy_host.h"
 #include "logging.h"
 #include "proto_frame.h"
 #include "string_manager.h"
+#include "proxy_config.h"
+#include "enum_trace.h"
+#include "metrics.h"
 #include "tusb.h"
 #include "pico/stdlib.h"
 
@@ -16,8 +21,13 @@
 #define HID_DESC_TYPE_REPORT 0x22
 #endif
 
-#define DESC_LOG_MAX_CONFIG_LEN 512
+#define DESC_LOG_MAX_CONFIG_LEN PROXY_MAX_CONFIG_DESC_SIZE
+#define DESC_LOG_MAX_REPORT_LEN 512
 #define DESC_LOG_HEX_CHUNK      16
+// Config bytes per streamed PF_DESC_CONFIG frame (matches send_descriptor_frames).
+#define DESC_LOG_STREAM_CHUNK   48
+// Main-loop passes a string request may fail to queue before the stage is skipped.
+#define DESC_LOG_STR_QUEUE_RETRIES 32
 
 #define DESC_FWD_DEVICE  TU_BIT(0)
 #define DESC_FWD_CONFIG  TU_BIT(1)
@@ -36,26 +46,67 @@ typedef struct
 {
     uint8_t  dev_addr;
     bool     active;
+    bool     capture;          // fetch only, for the hub composite (no frames)
     uint16_t langid;
     uint16_t cfg_len;
+    uint16_t cfg_fwd_off;      // next config byte to stream to A_device
+    bool     cfg_streaming;
+    bool     cfg_requested;
+    bool     ctrl_busy;        // one of our control transfers is in flight
+    desc_str_stage_t str_stage;
+    bool     str_started;
+    uint8_t  str_queue_fail;
     tusb_desc_device_t device;
     uint8_t  cfg_buf[DESC_LOG_MAX_CONFIG_LEN];
+    uint8_t  report_buf[DESC_LOG_MAX_REPORT_LEN];
     uint8_t  string_buf[PROXY_STRING_DESC_MAX];
     uint8_t  string_indices[3];
     uint8_t  forward_pending;
     uint8_t  hid_report_expected_mask;
     uint8_t  hid_report_forwarded_mask;
+    uint8_t  hid_report_fetched_mask;   // fetched, forward in progress
     uint8_t  hid_fetch_pending;
     uint16_t hid_report_len[CFG_TUH_HID];
     bool     hid_config_seen;
     bool     done_sent;
 } descriptor_log_ctx_t;
 
+// Per-stage enumeration timestamps, microseconds since descriptor_logger_start().
+// Zero means the stage has not been reached yet.
+typedef struct
+{
+    uint32_t device_us;      // device descriptor fetched
+    uint32_t config_us;      // config descriptor fetched
+    uint32_t config_fwd_us;  // last config chunk sent to A_device
+    uint32_t reports_us;     // all expected report descriptors forwarded
+    uint32_t strings_us;     // string fetch stages finished
+    uint32_t done_us;        // PF_DESC_DONE sent
+    uint32_t ready_us;       // READY ack from A_device
+} descriptor_log_timing_t;
+
+// Stages of the last forwarded enumeration; set together once READY arrives.
+METRIC_GAUGE_DEFINE(m_enum_device_us, "host.enum.device_us");
+METRIC_GAUGE_DEFINE(m_enum_config_us, "host.enum.config_us");
+METRIC_GAUGE_DEFINE(m_enum_config_fwd_us, "host.enum.config_fwd_us");
+METRIC_GAUGE_DEFINE(m_enum_reports_us, "host.enum.reports_us");
+METRIC_GAUGE_DEFINE(m_enum_strings_us, "host.enum.strings_us");
+METRIC_GAUGE_DEFINE(m_enum_done_us, "host.enum.done_us");
+METRIC_GAUGE_DEFINE(m_enum_ready_us, "host.enum.ready_us");
+METRIC_HISTOGRAM_DEFINE(m_enum_ready_ms, "host.enum.ready_ms");
+
 static descriptor_logger_ops_t s_ops;
 static descriptor_log_ctx_t s_desc_log;
+// Kept outside s_desc_log: the context is wiped once DONE is out, but the
+// stage timestamps are needed until READY arrives.
+static descriptor_log_timing_t s_desc_timing;
+static uint32_t s_desc_timing_base_us;
+// Interrupt IN bInterval per HID interface (ms at full speed); also outlives
+// s_desc_log so MOVE can pace reports after enumeration.
+static uint8_t s_hid_poll_ms[CFG_TUH_HID];
 
 static void descriptor_log_reset(void);
 static void descriptor_log_start_internal(uint8_t dev_addr,
+                                          bool forward,
                                           const uint8_t* report_desc,
                                           uint16_t report_len);
 static void descriptor_log_dump_hex(const char* label,
@@ -70,25 +121,46 @@ static void descriptor_forward_clear_pending(uint8_t mask);
 static void descriptor_forward_try_complete(void);
 static const char* descriptor_log_stage_label(desc_str_stage_t stage);
 static void descriptor_log_schedule_strings(desc_str_stage_t stage);
+static bool descriptor_log_request_string(void);
 static void descriptor_log_device_cb(tuh_xfer_t* xfer);
 static void descriptor_log_config_cb(tuh_xfer_t* xfer);
 static void descriptor_log_string_cb(tuh_xfer_t* xfer);
-static void descriptor_log_request_config(void);
-static void descriptor_log_fetch_missing_reports(void)
+static bool descriptor_log_request_config(void);
+static void descriptor_log_kick(void);
+
+// Index the rest of the bridge (PF_INPUT, A_device) knows interface `itf` of
+// the device being fetched by; differs from `itf` only behind a hub.
+static uint8_t descriptor_log_composite_itf(uint8_t itf)
+{
+    uint8_t comp = hid_proxy_host_composite_itf(s_desc_log.dev_addr, itf);
+    return (comp == 0xFF && !s_desc_log.capture) ? itf : comp;
+}
+
+static void descriptor_timing_mark(uint32_t* stamp)
+{
+    if (*stamp == 0)
+    {
+        uint32_t dt = time_us_32() - s_desc_timing_base_us;
+        *stamp = dt ? dt : 1;
+    }
+}
+
+static bool descriptor_log_fetch_missing_reports(void)
 {
     if (!s_desc_log.active)
     {
-        return;
+        return false;
     }
 
     // Не відправляємо кілька control-запитів одночасно: дочекаємось завершення попереднього.
-    if (s_desc_log.hid_fetch_pending)
+    if (s_desc_log.hid_fetch_pending || s_desc_log.ctrl_busy)
     {
-        return;
+        return false;
     }
 
     uint8_t missing = s_desc_log.hid_report_expected_mask &
-                      (uint8_t)~s_desc_log.hid_report_forwarded_mask;
+                      (uint8_t)~(s_desc_log.hid_report_forwarded_mask |
+                                 s_desc_log.hid_report_fetched_mask);
 
     for (uint8_t itf = 0; itf < CFG_TUH_HID; itf++)
     {
@@ -98,16 +170,16 @@ static void descriptor_log_fetch_missing_reports(void)
         }
 
         uint16_t rep_len = s_desc_log.hid_report_len[itf];
-        if (rep_len == 0 || rep_len > sizeof(s_desc_log.cfg_buf))
+        if (rep_len == 0 || rep_len > sizeof(s_desc_log.report_buf))
         {
-            rep_len = sizeof(s_desc_log.cfg_buf);
+            rep_len = sizeof(s_desc_log.report_buf);
         }
 
         bool queued = tuh_descriptor_get_hid_report(s_desc_log.dev_addr,
                                                     itf,
                                                     HID_DESC_TYPE_REPORT,
                                                     0,
-                                                    s_desc_log.cfg_buf,
+                                                    s_desc_log.report_buf,
                                                     rep_len,
                                                     descriptor_log_report_cb,
                                                     itf);
@@ -116,7 +188,8 @@ static void descriptor_log_fetch_missing_reports(void)
             LOGI("[B] requesting HID report descriptor itf=%u len=%u",
                  itf, rep_len);
             s_desc_log.hid_fetch_pending = TU_BIT(itf);
-            break; // чекаємо завершення, потім візьмемо наступний
+            s_desc_log.ctrl_busy = true;
+            return true; // чекаємо завершення, потім візьмемо наступний
         }
         else
         {
@@ -125,8 +198,38 @@ static void descriptor_log_fetch_missing_reports(void)
         }
     }
 
-    // In case all reports are already satisfied (e.g., via stubs), check completion.
-    descriptor_forward_try_complete();
+    return false;
+}
+
+// Single scheduler for the device control pipe. TinyUSB runs one control
+// transfer per device at a time, so the pipeline is: whenever a fetch
+// completes, queue the next one first and only then forward what arrived.
+// Priority follows the mount-to-READY critical path: config, reports, strings.
+static void descriptor_log_kick(void)
+{
+    if (!s_desc_log.active || s_desc_log.ctrl_busy)
+    {
+        return;
+    }
+
+    if (!s_desc_log.cfg_requested)
+    {
+        if (s_desc_log.device.bLength)
+        {
+            descriptor_log_request_config();
+        }
+        return;
+    }
+
+    if (s_desc_log.hid_config_seen && descriptor_log_fetch_missing_reports())
+    {
+        return;
+    }
+
+    if (s_desc_log.str_started && s_desc_log.str_stage < DESC_STR_STAGE_DONE)
+    {
+        descriptor_log_request_string();
+    }
 }
 
 void descriptor_logger_init(const descriptor_logger_ops_t* ops)
@@ -136,6 +239,15 @@ void descriptor_logger_init(const descriptor_logger_ops_t* ops)
         s_ops = *ops;
     }
     descriptor_log_reset();
+
+    metrics_register(&m_enum_device_us);
+    metrics_register(&m_enum_config_us);
+    metrics_register(&m_enum_config_fwd_us);
+    metrics_register(&m_enum_reports_us);
+    metrics_register(&m_enum_strings_us);
+    metrics_register(&m_enum_done_us);
+    metrics_register(&m_enum_ready_us);
+    metrics_register(&m_enum_ready_ms);
 }
 
 void descriptor_logger_reset(void)
@@ -147,7 +259,103 @@ void descriptor_logger_start(uint8_t dev_addr,
                              const uint8_t* report_desc,
                              uint16_t report_len)
 {
-    descriptor_log_start_internal(dev_addr, report_desc, report_len);
+    descriptor_log_start_internal(dev_addr, true, report_desc, report_len);
+}
+
+void descriptor_logger_capture(uint8_t dev_addr)
+{
+    descriptor_log_start_internal(dev_addr, false, NULL, 0);
+}
+
+uint8_t descriptor_logger_active_dev(void)
+{
+    return s_desc_log.active ? s_desc_log.dev_addr : 0;
+}
+
+uint8_t descriptor_logger_poll_interval_ms(uint8_t itf)
+{
+    return (itf < CFG_TUH_HID) ? s_hid_poll_ms[itf] : 0;
+}
+
+void descriptor_logger_move_itf(uint8_t from, uint8_t to)
+{
+    if (from < CFG_TUH_HID && to < CFG_TUH_HID && from != to)
+    {
+        s_hid_poll_ms[to]   = s_hid_poll_ms[from];
+        s_hid_poll_ms[from] = 0;
+    }
+}
+
+void descriptor_logger_note_ready(void)
+{
+    if (s_desc_timing.done_us == 0 || s_desc_timing.ready_us != 0)
+    {
+        return;
+    }
+    descriptor_timing_mark(&s_desc_timing.ready_us);
+
+    metric_set(&m_enum_device_us, s_desc_timing.device_us);
+    metric_set(&m_enum_config_us, s_desc_timing.config_us);
+    metric_set(&m_enum_config_fwd_us, s_desc_timing.config_fwd_us);
+    metric_set(&m_enum_reports_us, s_desc_timing.reports_us);
+    metric_set(&m_enum_strings_us, s_desc_timing.strings_us);
+    metric_set(&m_enum_done_us, s_desc_timing.done_us);
+    metric_set(&m_enum_ready_us, s_desc_timing.ready_us);
+    metric_observe(&m_enum_ready_ms, s_desc_timing.ready_us / 1000u);
+
+    LOGI("[B] enum timing (ms from mount): dev=%lu cfg=%lu cfg_fwd=%lu reports=%lu strings=%lu done=%lu ready=%lu",
+         (unsigned long)(s_desc_timing.device_us / 1000u),
+         (unsigned long)(s_desc_timing.config_us / 1000u),
+         (unsigned long)(s_desc_timing.config_fwd_us / 1000u),
+         (unsigned long)(s_desc_timing.reports_us / 1000u),
+         (unsigned long)(s_desc_timing.strings_us / 1000u),
+         (unsigned long)(s_desc_timing.done_us / 1000u),
+         (unsigned long)(s_desc_timing.ready_us / 1000u));
+}
+
+void descriptor_logger_task(void)
+{
+    if (!s_desc_log.active)
+    {
+        return;
+    }
+
+    // Retry control requests that could not be queued from a callback
+    // (e.g. the HID driver still owned the control pipe).
+    descriptor_log_kick();
+
+    if (!s_desc_log.cfg_streaming)
+    {
+        return;
+    }
+
+    // One frame per main-loop pass: tuh_task() keeps fetching report/string
+    // descriptors between chunks instead of waiting for the whole config.
+    uint16_t remaining = (uint16_t)(s_desc_log.cfg_len - s_desc_log.cfg_fwd_off);
+    uint16_t chunk = remaining > DESC_LOG_STREAM_CHUNK ? DESC_LOG_STREAM_CHUNK : remaining;
+    if (chunk)
+    {
+        bool sent = s_ops.send_descriptor_chunk &&
+                    s_ops.send_descriptor_chunk(PF_DESC_CONFIG,
+                                                s_desc_log.cfg_fwd_off,
+                                                s_desc_log.cfg_len,
+                                                &s_desc_log.cfg_buf[s_desc_log.cfg_fwd_off],
+                                                chunk);
+        if (!sent)
+        {
+            LOGW("[B] config stream chunk failed off=%u, will retry", s_desc_log.cfg_fwd_off);
+            return;
+        }
+        s_desc_log.cfg_fwd_off = (uint16_t)(s_desc_log.cfg_fwd_off + chunk);
+    }
+
+    if (s_desc_log.cfg_fwd_off >= s_desc_log.cfg_len)
+    {
+        s_desc_log.cfg_streaming = false;
+        descriptor_timing_mark(&s_desc_timing.config_fwd_us);
+        LOGI("[B] config descriptor forwarded len=%u", s_desc_log.cfg_len);
+        descriptor_forward_clear_pending(DESC_FWD_CONFIG);
+    }
 }
 
 void descriptor_logger_mark_report_forwarded(uint8_t itf)
@@ -156,6 +364,12 @@ void descriptor_logger_mark_report_forwarded(uint8_t itf)
     {
         s_desc_log.hid_report_forwarded_mask |= TU_BIT(itf);
     }
+    if (s_desc_log.hid_report_expected_mask &&
+        (s_desc_log.hid_report_forwarded_mask & s_desc_log.hid_report_expected_mask) ==
+            s_desc_log.hid_report_expected_mask)
+    {
+        descriptor_timing_mark(&s_desc_timing.reports_us);
+    }
     descriptor_forward_try_complete();
 }
 
@@ -202,6 +416,7 @@ static void descriptor_log_dump_hex(const char* label,
 }
 
 static void descriptor_log_start_internal(uint8_t dev_addr,
+                                          bool forward,
                                           const uint8_t* report_desc,
                                           uint16_t report_len)
 {
@@ -211,8 +426,25 @@ static void descriptor_log_start_internal(uint8_t dev_addr,
 
         s_desc_log.dev_addr = dev_addr;
         s_desc_log.active   = true;
+        s_desc_log.capture  = !forward;
         s_desc_log.forward_pending = DESC_FWD_DEVICE;
-        descriptor_forward_set_pending(DESC_FWD_STRINGS);
+
+        if (forward)
+        {
+            descriptor_forward_set_pending(DESC_FWD_STRINGS);
+            memset(&s_desc_timing, 0, sizeof(s_desc_timing));
+            memset(s_hid_poll_ms, 0, sizeof(s_hid_poll_ms));
+            s_desc_timing_base_us = time_us_32();
+            enum_trace_reset();
+            enum_trace_remote_reset();
+            hid_proxy_host_desc_session_begin();
+        }
+        else
+        {
+            // Strings come from the primary device; A_device hears nothing
+            // until the composite set is complete.
+            LOGI("[B] capturing descriptors of dev=%u for the composite", dev_addr);
+        }
 
         if (!tuh_descriptor_get_device(dev_addr,
                                        &s_desc_log.device,
@@ -224,6 +456,10 @@ static void descriptor_log_start_internal(uint8_t dev_addr,
             descriptor_forward_clear_pending(DESC_FWD_DEVICE);
             s_desc_log.active = false;
         }
+        else
+        {
+            s_desc_log.ctrl_busy = true;
+        }
     }
 
     if (report_desc && report_len)
@@ -235,6 +471,14 @@ static void descriptor_log_start_internal(uint8_t dev_addr,
 
 static void descriptor_log_finish(void)
 {
+    if (s_desc_log.capture)
+    {
+        // A capture that failed before its reports is dropped; the owner retries.
+        LOGW("[B] descriptor capture of dev=%u failed", s_desc_log.dev_addr);
+        descriptor_log_reset();
+        return;
+    }
+
     descriptor_forward_try_complete();
 
     if (s_desc_log.done_sent)
@@ -299,14 +543,31 @@ static void descriptor_log_schedule_strings(desc_str_stage_t stage)
     {
         return;
     }
+    if (s_desc_log.capture)
+    {
+        descriptor_log_finish();
+        return;
+    }
+
+    s_desc_log.str_started    = true;
+    s_desc_log.str_stage      = stage;
+    s_desc_log.str_queue_fail = 0;
 
     if (stage >= DESC_STR_STAGE_DONE)
     {
+        descriptor_timing_mark(&s_desc_timing.strings_us);
         descriptor_forward_clear_pending(DESC_FWD_STRINGS);
         descriptor_log_finish();
         return;
     }
 
+    descriptor_log_kick();
+}
+
+static bool descriptor_log_request_string(void)
+{
+    desc_str_stage_t stage = s_desc_log.str_stage;
+
     if (stage == DESC_STR_STAGE_LANG)
     {
         if (!tuh_descriptor_get_string(s_desc_log.dev_addr,
@@ -317,10 +578,16 @@ static void descriptor_log_schedule_strings(desc_str_stage_t stage)
                                        descriptor_log_string_cb,
                                        (uintptr_t)stage))
         {
+            if (++s_desc_log.str_queue_fail < DESC_LOG_STR_QUEUE_RETRIES)
+            {
+                return false; // control pipe busy, retry from task
+            }
             LOGW("[B] failed to request LangID descriptor dev=%u", s_desc_log.dev_addr);
             descriptor_log_schedule_strings((desc_str_stage_t)(stage + 1));
+            return false;
         }
-        return;
+        s_desc_log.ctrl_busy = true;
+        return true;
     }
 
     uint8_t index = s_desc_log.string_indices[stage - DESC_STR_STAGE_MANUF];
@@ -328,12 +595,10 @@ static void descriptor_log_schedule_strings(desc_str_stage_t stage)
     {
         LOGI("[B] %s string missing", descriptor_log_stage_label(stage));
         descriptor_log_schedule_strings((desc_str_stage_t)(stage + 1));
-        return;
+        return false;
     }
 
     uint16_t lang = s_desc_log.langid ? s_desc_log.langid : 0x0409;
-    LOGI("[B] requesting string idx=%u lang=0x%04X stage=%u",
-         index, lang, stage);
     if (!tuh_descriptor_get_string(s_desc_log.dev_addr,
                                    index,
                                    lang,
@@ -342,11 +607,20 @@ static void descriptor_log_schedule_strings(desc_str_stage_t stage)
                                    descriptor_log_string_cb,
                                    (uintptr_t)stage))
     {
+        if (++s_desc_log.str_queue_fail < DESC_LOG_STR_QUEUE_RETRIES)
+        {
+            return false;
+        }
         LOGW("[B] failed to request %s string idx=%u",
              descriptor_log_stage_label(stage),
              index);
         descriptor_log_schedule_strings((desc_str_stage_t)(stage + 1));
+        return false;
     }
+    LOGI("[B] requesting string idx=%u lang=0x%04X stage=%u",
+         index, lang, stage);
+    s_desc_log.ctrl_busy = true;
+    return true;
 }
 
 static void descriptor_log_device_cb(tuh_xfer_t* xfer)
@@ -356,6 +630,7 @@ static void descriptor_log_device_cb(tuh_xfer_t* xfer)
         return;
     }
 
+    s_desc_log.ctrl_busy = false;
     if (xfer->result != XFER_RESULT_SUCCESS)
     {
         LOGW("[B] device descriptor transfer failed dev=%u result=%d",
@@ -367,6 +642,16 @@ static void descriptor_log_device_cb(tuh_xfer_t* xfer)
     }
 
     tusb_desc_device_t const* desc = &s_desc_log.device;
+    descriptor_timing_mark(&s_desc_timing.device_us);
+    enum_trace_record(ET_DESC_FETCHED, (uint16_t)(TUSB_DESC_DEVICE << 8));
+    s_desc_log.string_indices[0] = desc->iManufacturer;
+    s_desc_log.string_indices[1] = desc->iProduct;
+    s_desc_log.string_indices[2] = desc->iSerialNumber;
+
+    // Config fetch goes out first; the device descriptor is logged and
+    // forwarded over UART while that transfer is in flight.
+    descriptor_log_kick();
+
     uint16_t vid = tu_le16toh(desc->idVendor);
     uint16_t pid = tu_le16toh(desc->idProduct);
 
@@ -389,7 +674,7 @@ static void descriptor_log_device_cb(tuh_xfer_t* xfer)
                             (uint8_t const*)desc,
                             dump_len);
 
-    if (dump_len && s_ops.send_descriptor_frames)
+    if (dump_len && !s_desc_log.capture && s_ops.send_descriptor_frames)
     {
         if (s_ops.send_descriptor_frames(PF_DESC_DEVICE,
                                          (uint8_t const*)desc,
@@ -403,21 +688,17 @@ static void descriptor_log_device_cb(tuh_xfer_t* xfer)
         }
     }
 
-    s_desc_log.string_indices[0] = desc->iManufacturer;
-    s_desc_log.string_indices[1] = desc->iProduct;
-    s_desc_log.string_indices[2] = desc->iSerialNumber;
-
-    descriptor_log_request_config();
     descriptor_forward_clear_pending(DESC_FWD_DEVICE);
 }
 
-static void descriptor_log_request_config(void)
+static bool descriptor_log_request_config(void)
 {
     if (!s_desc_log.active)
     {
-        return;
+        return false;
     }
 
+    s_desc_log.cfg_requested = true;
     descriptor_forward_set_pending(DESC_FWD_CONFIG);
 
     if (!tuh_descriptor_get_configuration(s_desc_log.dev_addr,
@@ -431,7 +712,10 @@ static void descriptor_log_request_config(void)
              s_desc_log.dev_addr);
         descriptor_forward_clear_pending(DESC_FWD_CONFIG);
         descriptor_log_schedule_strings(DESC_STR_STAGE_LANG);
+        return false;
     }
+    s_desc_log.ctrl_busy = true;
+    return true;
 }
 
 static void descriptor_log_config_cb(tuh_xfer_t* xfer)
@@ -441,6 +725,10 @@ static void descriptor_log_config_cb(tuh_xfer_t* xfer)
         return;
     }
 
+    s_desc_log.ctrl_busy = false;
+    descriptor_timing_mark(&s_desc_timing.config_us);
+    enum_trace_record(ET_DESC_FETCHED, (uint16_t)(TUSB_DESC_CONFIGURATION << 8));
+
     if (xfer->result != XFER_RESULT_SUCCESS)
     {
         LOGW("[B] config descriptor transfer failed dev=%u result=%d",
@@ -454,6 +742,7 @@ static void descriptor_log_config_cb(tuh_xfer_t* xfer)
     uint16_t len = (uint16_t)TU_MIN((size_t)xfer->actual_len,
                                     sizeof(s_desc_log.cfg_buf));
     s_desc_log.cfg_len = len;
+    s_desc_log.cfg_fwd_off = 0;
 
     if (len < sizeof(tusb_desc_configuration_t))
     {
@@ -473,6 +762,12 @@ static void descriptor_log_config_cb(tuh_xfer_t* xfer)
     LOGI("[B] config descriptor: bConfigurationValue=%u maxPower=%umA",
          cfg->bConfigurationValue,
          cfg->bMaxPower * 2);
+    if (tu_le16toh(cfg->wTotalLength) > len)
+    {
+        LOGW("[B] config descriptor truncated: wTotalLength=%u buffer=%u",
+             tu_le16toh(cfg->wTotalLength),
+             (unsigned)sizeof(s_desc_log.cfg_buf));
+    }
 
     descriptor_log_dump_hex("config desc", s_desc_log.cfg_buf, len);
     descriptor_log_print_interfaces(s_desc_log.cfg_buf, len);
@@ -508,6 +803,17 @@ static void descriptor_log_config_cb(tuh_xfer_t* xfer)
             uint16_t rep_len = (uint16_t)p[7] | ((uint16_t)p[8] << 8);
             s_desc_log.hid_report_len[last_itf] = rep_len;
         }
+        else if (dtype == TUSB_DESC_ENDPOINT && blen >= sizeof(tusb_desc_endpoint_t) &&
+                 last_itf < CFG_TUH_HID && (hid_mask & TU_BIT(last_itf)))
+        {
+            tusb_desc_endpoint_t const* ep = (tusb_desc_endpoint_t const*)p;
+            uint8_t comp = descriptor_log_composite_itf(last_itf);
+            if (tu_edpt_dir(ep->bEndpointAddress) == TUSB_DIR_IN &&
+                ep->bmAttributes.xfer == TUSB_XFER_INTERRUPT && comp < CFG_TUH_HID)
+            {
+                s_hid_poll_ms[comp] = ep->bInterval;
+            }
+        }
         p += blen;
     }
     if (hid_mask == 0) hid_mask = TU_BIT(0); // at least one
@@ -521,25 +827,22 @@ static void descriptor_log_config_cb(tuh_xfer_t* xfer)
         }
     }
     LOGI("[B] HID report descriptors expected mask=0x%02X", hid_mask);
-    descriptor_log_fetch_missing_reports();
-
-    if (s_ops.send_descriptor_frames)
-    {
-        if (s_ops.send_descriptor_frames(PF_DESC_CONFIG, s_desc_log.cfg_buf, len))
-        {
-            LOGI("[B] config descriptor forwarded len=%u", len);
-        }
-        else
-        {
-            LOGW("[B] failed to forward config descriptor len=%u", len);
-        }
-    }
-
-    descriptor_log_schedule_strings(DESC_STR_STAGE_LANG);
-    descriptor_forward_clear_pending(DESC_FWD_CONFIG);
-
-    // Try to fetch missing HID reports that didn't arrive via mount.
-    descriptor_log_fetch_missing_reports();
+
+    if (s_desc_log.capture)
+    {
+        // Kept for the composite; only the report descriptors are left to fetch.
+        descriptor_log_kick();
+        descriptor_forward_clear_pending(DESC_FWD_CONFIG);
+        return;
+    }
+
+    // Config is streamed from descriptor_logger_task(); DESC_FWD_CONFIG stays
+    // pending until the last chunk is out, while report/string fetches proceed.
+    // Strings are queued behind the report fetches by descriptor_log_kick().
+    s_desc_log.cfg_streaming = true;
+    s_desc_log.str_started   = true;
+    s_desc_log.str_stage     = DESC_STR_STAGE_LANG;
+    descriptor_log_kick();
 }
 
 static void descriptor_log_string_cb(tuh_xfer_t* xfer)
@@ -550,9 +853,15 @@ static void descriptor_log_string_cb(tuh_xfer_t* xfer)
         return;
     }
 
-    uint16_t len = (uint16_t)TU_MIN((size_t)xfer->actual_len,
-                                    sizeof(s_desc_log.string_buf));
-    memcpy(s_desc_log.string_buf, xfer->buffer, len);
+    s_desc_log.ctrl_busy = false;
+    enum_trace_record(ET_DESC_FETCHED,
+                      (uint16_t)((TUSB_DESC_STRING << 8) |
+                                 ((stage == DESC_STR_STAGE_LANG) ? 0
+                                  : s_desc_log.string_indices[stage - DESC_STR_STAGE_MANUF])));
+    uint16_t len = (xfer->result == XFER_RESULT_SUCCESS)
+                   ? (uint16_t)TU_MIN((size_t)xfer->actual_len,
+                                      sizeof(s_desc_log.string_buf))
+                   : 0;
 
     if (stage == DESC_STR_STAGE_LANG)
     {
@@ -621,27 +930,41 @@ static void descriptor_log_report_cb(tuh_xfer_t* xfer)
         return;
     }
 
-    uint8_t itf = (uint8_t)xfer->user_data;
+    uint8_t itf  = (uint8_t)xfer->user_data;
+    uint8_t comp = descriptor_log_composite_itf(itf);
 
     // Звільнити слоти очікування, аби можна було запросити наступний HID report.
     s_desc_log.hid_fetch_pending &= (uint8_t)~TU_BIT(itf);
+    s_desc_log.ctrl_busy = false;
 
     if (xfer->result != XFER_RESULT_SUCCESS)
     {
         LOGW("[B] HID report descriptor fetch failed itf=%u result=%d", itf, xfer->result);
-        descriptor_log_fetch_missing_reports();
+        descriptor_log_kick();
         return;
     }
 
-    uint16_t len = (uint16_t)xfer->actual_len;
+    uint16_t full_len = (uint16_t)TU_MIN((size_t)xfer->actual_len,
+                                         sizeof(s_desc_log.report_buf));
+    uint16_t len = full_len;
     if (len > PROTO_MAX_PAYLOAD_SIZE - 1)
     {
         len = PROTO_MAX_PAYLOAD_SIZE - 1;
     }
 
-    // Update inferred type using the full report descriptor.
-    hid_proxy_host_update_inferred_type(itf, xfer->buffer, (uint16_t)xfer->actual_len);
-    hid_proxy_host_store_report_desc(itf, xfer->buffer, (uint16_t)xfer->actual_len);
+    enum_trace_record(ET_DESC_FETCHED, (uint16_t)((HID_DESC_TYPE_REPORT << 8) | itf));
+
+    // report_buf is reused by the next fetch, so take the data out first.
+    uint8_t tmp[PROTO_MAX_PAYLOAD_SIZE];
+    tmp[0] = comp;
+    memcpy(&tmp[1], xfer->buffer, len);
+    hid_proxy_host_update_inferred_type(comp, xfer->buffer, full_len);
+    hid_proxy_host_store_report_desc(comp, xfer->buffer, full_len);
+
+    // Next interface (or the first string) is fetched while this one is
+    // pushed over UART.
+    s_desc_log.hid_report_fetched_mask |= TU_BIT(itf);
+    descriptor_log_kick();
 
     // If we already sent a stub for this interface, do not resend.
     if (s_desc_log.hid_report_forwarded_mask & TU_BIT(itf))
@@ -650,9 +973,13 @@ static void descriptor_log_report_cb(tuh_xfer_t* xfer)
         return;
     }
 
-    uint8_t tmp[PROTO_MAX_PAYLOAD_SIZE];
-    tmp[0] = itf;
-    memcpy(&tmp[1], xfer->buffer, len);
+    if (s_desc_log.capture)
+    {
+        LOGI("[B] HID report descriptor captured itf=%u -> %u len=%u", itf, comp, full_len);
+        descriptor_logger_mark_report_forwarded(itf);
+        return;
+    }
+
     if (s_ops.send_descriptor_frames &&
         s_ops.send_descriptor_frames(PF_DESC_REPORT, tmp, (uint16_t)(len + 1)))
     {
@@ -662,10 +989,10 @@ static void descriptor_log_report_cb(tuh_xfer_t* xfer)
     else
     {
         LOGW("[B] failed to forward fetched HID report descriptor itf=%u", itf);
+        s_desc_log.hid_report_fetched_mask &= (uint8_t)~TU_BIT(itf); // fetch again
     }
 
     descriptor_forward_try_complete();
-    descriptor_log_fetch_missing_reports();
 }
 
 static void descriptor_forward_reset(void)
@@ -673,6 +1000,7 @@ static void descriptor_forward_reset(void)
     s_desc_log.forward_pending = 0;
     s_desc_log.done_sent = false;
     s_desc_log.hid_report_forwarded_mask = 0;
+    s_desc_log.hid_report_fetched_mask = 0;
     s_desc_log.hid_fetch_pending = 0;
 }
 
@@ -709,8 +1037,24 @@ static void descriptor_forward_try_complete(void)
         return;
     }
 
+    if (s_ops.set_fetched && s_desc_log.cfg_len)
+    {
+        s_ops.set_fetched(s_desc_log.dev_addr,
+                          (uint8_t const*)&s_desc_log.device, sizeof(s_desc_log.device),
+                          s_desc_log.cfg_buf, s_desc_log.cfg_len);
+    }
+    if (s_desc_log.capture)
+    {
+        // Nothing goes to A_device from here; the owner forwards the composite.
+        LOGI("[B] descriptors of dev=%u captured", s_desc_log.dev_addr);
+        descriptor_log_reset();
+        return;
+    }
+
     // Re-send critical descriptors right before DONE to tolerate UART loss.
-    if (s_ops.send_descriptor_frames)
+    // A resumable session does not need it: DONE carries the manifest and
+    // A_device asks for whatever it is missing.
+    if (!PROXY_DESC_RESUME && s_ops.send_descriptor_frames)
     {
         if (s_desc_log.device.bLength)
         {
@@ -734,6 +1078,7 @@ static void descriptor_forward_try_complete(void)
     if (s_ops.send_descriptor_done && s_ops.send_descriptor_done())
     {
         s_desc_log.done_sent = true;
+        descriptor_timing_mark(&s_desc_timing.done_us);
         LOGI("[B] Descriptor transmission complete");
     }
     else
@@ -7,14 +7,39 @@
 typedef struct
 {
     bool (*send_descriptor_frames)(uint8_t cmd, const uint8_t* data, uint16_t len);
+    // Send exactly one descriptor frame without pacing delays (used for streaming).
+    // `offset`/`total` place the chunk inside the descriptor.
+    bool (*send_descriptor_chunk)(uint8_t cmd, uint16_t offset, uint16_t total,
+                                  const uint8_t* data, uint16_t len);
     bool (*send_descriptor_done)(void);
+    // Device + config descriptors of a fully fetched set, before DONE (or
+    // instead of it for a capture). Optional.
+    void (*set_fetched)(uint8_t dev_addr,
+                        const uint8_t* device, uint16_t device_len,
+                        const uint8_t* cfg, uint16_t cfg_len);
 } descriptor_logger_ops_t;
 
 void descriptor_logger_init(const descriptor_logger_ops_t* ops);
 void descriptor_logger_reset(void);
+// Streams pending descriptor chunks to A_device; call from the main loop.
+void descriptor_logger_task(void);
 void descriptor_logger_start(uint8_t dev_addr,
                              const uint8_t* report_desc,
                              uint16_t report_len);
+// Hub aggregation: fetches a further device's descriptors without sending
+// anything to A_device or touching the string cache. Report descriptors are
+// stored under their composite interface, then ops.set_fetched is called.
+void descriptor_logger_capture(uint8_t dev_addr);
+// Device whose descriptors are being fetched; 0 when idle.
+uint8_t descriptor_logger_active_dev(void);
 void descriptor_logger_mark_report_forwarded(uint8_t itf);
+// Stamps the READY ack and publishes the stage breakdown of the last
+// enumeration as host.enum.* metrics (GET_METRICS).
+void descriptor_logger_note_ready(void);
+// Interrupt IN bInterval of HID interface `itf` from the last config
+// descriptor; 0 when unknown.
+uint8_t descriptor_logger_poll_interval_ms(uint8_t itf);
+// Composite interface `from` was renumbered to `to`.
+void descriptor_logger_move_itf(uint8_t from, uint8_t to);
 
 #endif // DESCRIPTOR_LOGGER_H
@@ -0,0 +1,290 @@
+#define LOG_MODULE LOG_MOD_LINK
+
+#include "fanout.h"
+
+#include <string.h>
+
+#include "logging.h"
+#include "proxy_config.h"
+#include "proto_frame.h"
+
+#if PROXY_FANOUT_TARGETS < 1u || PROXY_FANOUT_TARGETS > FANOUT_MAX_TARGETS
+#error "PROXY_FANOUT_TARGETS must be 1..FANOUT_MAX_TARGETS"
+#endif
+
+#define FANOUT_USAGE_KEY_1 0x1Eu   // HID usage of '1'; '2'.. follow
+
+static fanout_link_ops_t const* s_ops;
+static uint8_t  s_targets = 1;
+static uint8_t  s_focus;
+static uint8_t  s_route[FANOUT_ROUTE_ITFS];
+static uint8_t  s_desc_mask;
+static uint8_t  s_reply = FANOUT_NO_TARGET;
+static uint8_t  s_rx_next;
+static uint8_t  s_hotkey_key;      // digit of the hotkey being held, 0 = none
+static uint32_t s_switches;
+static fanout_target_stats_t s_stats[FANOUT_MAX_TARGETS];
+
+static uint8_t all_mask(void)
+{
+    return (uint8_t)((1u << s_targets) - 1u);
+}
+
+void fanout_init(uint8_t targets, fanout_link_ops_t const* ops)
+{
+    if (targets < 1) targets = 1;
+    if (targets > FANOUT_MAX_TARGETS) targets = FANOUT_MAX_TARGETS;
+    s_ops      = ops;
+    s_targets  = targets;
+    s_focus    = 0;
+    s_reply    = FANOUT_NO_TARGET;
+    s_rx_next  = 0;
+    s_hotkey_key = 0;
+    s_switches = 0;
+    memset(s_route, FANOUT_ROUTE_FOCUS, sizeof(s_route));
+    memset(s_stats, 0, sizeof(s_stats));
+    s_desc_mask = all_mask();
+}
+
+uint8_t fanout_targets(void)
+{
+    return s_targets;
+}
+
+uint8_t fanout_focus(void)
+{
+    return s_focus;
+}
+
+bool fanout_set_focus(uint8_t target)
+{
+    if (target >= s_targets)
+    {
+        return false;
+    }
+    if (target != s_focus)
+    {
+        LOGI("[FAN] focus %u -> %u", s_focus, target);
+        s_focus = target;
+        s_switches++;
+    }
+    return true;
+}
+
+bool fanout_set_route(uint8_t itf, uint8_t target)
+{
+    if (itf >= FANOUT_ROUTE_ITFS || (target != FANOUT_ROUTE_FOCUS && target >= s_targets))
+    {
+        return false;
+    }
+    s_route[itf] = target;
+    return true;
+}
+
+uint8_t fanout_route_entry(uint8_t itf)
+{
+    return itf < FANOUT_ROUTE_ITFS ? s_route[itf] : FANOUT_ROUTE_FOCUS;
+}
+
+uint8_t fanout_route(uint8_t itf)
+{
+    uint8_t t = fanout_route_entry(itf);
+    return t == FANOUT_ROUTE_FOCUS ? s_focus : t;
+}
+
+uint32_t fanout_switch_count(void)
+{
+    return s_switches;
+}
+
+static uint8_t dest_mask(uint8_t const* frame, uint16_t len)
+{
+    if (len > PROTO_HEADER_SIZE && frame[0] == PF_INPUT)
+    {
+        return (uint8_t)(1u << fanout_route(frame[PROTO_HEADER_SIZE]));
+    }
+    if (s_reply != FANOUT_NO_TARGET)
+    {
+        return (uint8_t)(1u << s_reply);
+    }
+    if (len >= 2 && frame[0] == PF_CONTROL &&
+        (frame[1] == PF_CTRL_TRACE_REQ || frame[1] == PF_CTRL_STATS_REQ ||
+         frame[1] == PF_CTRL_METRICS_REQ))
+    {
+        return (uint8_t)(1u << s_focus);
+    }
+    return s_desc_mask;
+}
+
+// READY answers DONE; until then the target's PC has not (re)enumerated.
+static bool starts_set(uint8_t const* frame, uint16_t len)
+{
+    if (len < 2) return false;
+    return frame[0] == PF_UNMOUNT ||
+           (frame[0] == PF_DESCRIPTOR && frame[1] == PF_DESC_DONE) ||
+           (frame[0] == PF_CONTROL && frame[1] == PF_CTRL_DEVICE_RESET);
+}
+
+static int send_masked(uint8_t const* frame, uint16_t len, bool isr)
+{
+    if (!s_ops || !frame || !len) return -1;
+
+    uint8_t mask = dest_mask(frame, len);
+    bool    sent = false;
+    int     err  = -1;
+    for (uint8_t t = 0; t < s_targets; t++)
+    {
+        if (!(mask & (1u << t))) continue;
+
+        int wr;
+        if (isr)
+        {
+            wr = s_ops->send_from_isr ? s_ops->send_from_isr(t, frame, len) : -1;
+        }
+        else
+        {
+            wr = s_ops->send ? s_ops->send(t, frame, len) : -1;
+        }
+        if (wr < 0)
+        {
+            s_stats[t].tx_errors++;
+            err = wr;
+            continue;
+        }
+        s_stats[t].tx_frames++;
+        if (starts_set(frame, len))
+        {
+            s_stats[t].ready = false;
+        }
+        sent = true;
+    }
+    return sent ? (int)len : err;
+}
+
+int fanout_send(uint8_t const* frame, uint16_t len)
+{
+    return send_masked(frame, len, false);
+}
+
+int fanout_send_from_isr(uint8_t const* frame, uint16_t len)
+{
+    return send_masked(frame, len, true);
+}
+
+int fanout_recv(uint8_t* buf, uint16_t max, uint8_t* source)
+{
+    s_reply = FANOUT_NO_TARGET;
+    if (!s_ops || !s_ops->recv) return -1;
+
+    for (uint8_t i = 0; i < s_targets; i++)
+    {
+        uint8_t t = (uint8_t)((s_rx_next + i) % s_targets);
+        int len = s_ops->recv(t, buf, max);
+        if (len > 0)
+        {
+            s_rx_next = (uint8_t)((t + 1u) % s_targets);
+            s_stats[t].rx_frames++;
+            s_reply = t;
+            if (source) *source = t;
+            return len;
+        }
+    }
+    return 0;
+}
+
+void fanout_reply_begin(uint8_t target)
+{
+    s_reply = target < s_targets ? target : FANOUT_NO_TARGET;
+}
+
+void fanout_reply_end(void)
+{
+    s_reply = FANOUT_NO_TARGET;
+}
+
+uint8_t fanout_reply_target(void)
+{
+    return s_reply;
+}
+
+void fanout_desc_scope_reply(void)
+{
+    if (s_reply != FANOUT_NO_TARGET)
+    {
+        fanout_desc_scope_target(s_reply);
+    }
+}
+
+void fanout_desc_scope_target(uint8_t target)
+{
+    if (target >= s_targets) return;
+    // Several targets may be catching up at once; the others stay out.
+    if (s_desc_mask == all_mask())
+    {
+        s_desc_mask = 0;
+    }
+    s_desc_mask |= (uint8_t)(1u << target);
+}
+
+void fanout_desc_scope_all(void)
+{
+    s_desc_mask = all_mask();
+}
+
+uint8_t fanout_desc_scope(void)
+{
+    return s_desc_mask;
+}
+
+void fanout_note_ready(uint8_t target)
+{
+    if (target >= s_targets) return;
+    s_stats[target].ready = true;
+    if (s_desc_mask != all_mask() && (s_desc_mask & (1u << target)))
+    {
+        s_desc_mask &= (uint8_t)~(1u << target);
+        if (!s_desc_mask)
+        {
+            s_desc_mask = all_mask();
+        }
+    }
+}
+
+bool fanout_target_stats(uint8_t target, fanout_target_stats_t* out)
+{
+    if (target >= s_targets || !out) return false;
+    *out = s_stats[target];
+    return true;
+}
+
+uint8_t fanout_hotkey_feed(uint8_t mods, uint8_t const* keys, uint8_t count, bool* swallow)
+{
+    *swallow = false;
+    if (!PROXY_FANOUT_HOTKEY_MODS || s_targets < 2)
+    {
+        return FANOUT_NO_TARGET;
+    }
+
+    if (s_hotkey_key)
+    {
+        for (uint8_t i = 0; i < count; i++)
+        {
+            if (keys[i] == s_hotkey_key)
+            {
+                *swallow = true;
+                return FANOUT_NO_TARGET;
+            }
+        }
+        s_hotkey_key = 0;
+        return FANOUT_NO_TARGET;
+    }
+
+    if (mods != PROXY_FANOUT_HOTKEY_MODS || count != 1 ||
+        keys[0] < FANOUT_USAGE_KEY_1 || keys[0] >= FANOUT_USAGE_KEY_1 + s_targets)
+    {
+        return FANOUT_NO_TARGET;
+    }
+    s_hotkey_key = keys[0];
+    *swallow = true;
+    return (uint8_t)(keys[0] - FANOUT_USAGE_KEY_1);
+}
@@ -0,0 +1,84 @@
+#ifndef FANOUT_H
+#define FANOUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// One physical keyboard/mouse, several A_device targets (PROXY_FANOUT_TARGETS).
+// Every B_host -> A_device frame goes through fanout_send(), which picks the
+// targets from the frame itself:
+//   PF_INPUT               the route of its interface (default: the focus);
+//   while answering a target (fanout_reply_begin, or a frame fanout_recv
+//   returned)              that target only;
+//   TRACE/STATS/METRICS_REQ the focus;
+//   everything else        the descriptor scope, normally every target, so
+//                          all targets stay enumerated with the same set.
+// Switching focus only changes the table; no target re-enumerates.
+//
+// Pure bookkeeping over a link ops table: hid_proxy_host.c plugs in the
+// hardware and PIO links, tools/fanout_sim simulated ones.
+
+#define FANOUT_MAX_TARGETS 4u
+#define FANOUT_ROUTE_ITFS  16u
+#define FANOUT_ROUTE_FOCUS 0xFFu   // route entry: follow the focus
+#define FANOUT_NO_TARGET   0xFFu
+
+typedef struct
+{
+    int (*send)(uint8_t target, uint8_t const* frame, uint16_t len);
+    // IRQ context; may be NULL. Returns UART_TRANSPORT_BUSY-style negatives.
+    int (*send_from_isr)(uint8_t target, uint8_t const* frame, uint16_t len);
+    int (*recv)(uint8_t target, uint8_t* buf, uint16_t max);
+} fanout_link_ops_t;
+
+typedef struct
+{
+    uint32_t tx_frames;
+    uint32_t tx_errors;
+    uint32_t rx_frames;
+    bool     ready;          // READY seen since its last descriptor set
+} fanout_target_stats_t;
+
+void    fanout_init(uint8_t targets, fanout_link_ops_t const* ops);
+uint8_t fanout_targets(void);
+
+// Routing table.
+uint8_t fanout_focus(void);
+// False for an unknown target; true (and no change) when already focused.
+bool    fanout_set_focus(uint8_t target);
+bool    fanout_set_route(uint8_t itf, uint8_t target);
+// Raw table entry (FANOUT_ROUTE_FOCUS or a target).
+uint8_t fanout_route_entry(uint8_t itf);
+// Target PF_INPUT of `itf` goes to.
+uint8_t fanout_route(uint8_t itf);
+uint32_t fanout_switch_count(void);
+
+// Link I/O. Returns `len` when at least one target took the frame.
+int fanout_send(uint8_t const* frame, uint16_t len);
+int fanout_send_from_isr(uint8_t const* frame, uint16_t len);
+// Next frame from any target, round robin; the target becomes the reply
+// target until the next call.
+int fanout_recv(uint8_t* buf, uint16_t max, uint8_t* source);
+
+// Answers produced outside fanout_recv (TinyUSB callbacks) go to `target`.
+void    fanout_reply_begin(uint8_t target);
+void    fanout_reply_end(void);
+uint8_t fanout_reply_target(void);
+
+// Descriptor/lifecycle traffic scope. A target that asked for its set again
+// gets it alone, so the others are not re-enumerated; a physical change
+// widens it back to every target.
+void    fanout_desc_scope_reply(void);
+void    fanout_desc_scope_target(uint8_t target);
+void    fanout_desc_scope_all(void);
+uint8_t fanout_desc_scope(void);   // bit mask
+
+void fanout_note_ready(uint8_t target);
+bool fanout_target_stats(uint8_t target, fanout_target_stats_t* out);
+
+// Focus hotkey over the decoded physical keyboard state. Returns the target
+// to focus (FANOUT_NO_TARGET otherwise); `*swallow` is set while the digit of
+// a hotkey is held, so the report must not be forwarded.
+uint8_t fanout_hotkey_feed(uint8_t mods, uint8_t const* keys, uint8_t count, bool* swallow);
+
+#endif // FANOUT_H
@@ -0,0 +1,43 @@
+#ifndef HID_FIELDS_H
+#define HID_FIELDS_H
+
+#include <stdint.h>
+
+// Bit-field access for HID reports built or merged on B_host (KEY, MIX, MOVE,
+// TYPE_TEXT). HID fields are little-endian, LSB first. Buffers are
+// HID_FIELD_REPORT_MAX bytes: bits past that read as 0 and are not written.
+// Fields wider than 32 bits are cut to their low 32.
+
+#define HID_FIELD_REPORT_MAX 64u
+
+static inline uint32_t hid_field_read(uint8_t const* report, uint16_t bit_off, uint8_t size)
+{
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < size && i < 32; i++)
+    {
+        uint16_t bit = (uint16_t)(bit_off + i);
+        if (bit / 8u >= HID_FIELD_REPORT_MAX) break;
+        if (report[bit / 8u] & (1u << (bit % 8u))) v |= 1u << i;
+    }
+    return v;
+}
+
+static inline int32_t hid_field_read_signed(uint8_t const* report, uint16_t bit_off, uint8_t size)
+{
+    uint32_t v = hid_field_read(report, bit_off, size);
+    if (size && size < 32 && (v & (1u << (size - 1u)))) v |= ~((1u << size) - 1u);
+    return (int32_t)v;
+}
+
+static inline void hid_field_write(uint8_t* report, uint16_t bit_off, uint8_t size, uint32_t value)
+{
+    for (uint8_t i = 0; i < size && i < 32; i++)
+    {
+        uint16_t bit = (uint16_t)(bit_off + i);
+        if (bit / 8u >= HID_FIELD_REPORT_MAX) return;
+        if (value & (1u << i)) report[bit / 8u] |= (uint8_t)(1u << (bit % 8u));
+        else report[bit / 8u] &= (uint8_t)~(1u << (bit % 8u));
+    }
+}
+
+#endif // HID_FIELDS_H
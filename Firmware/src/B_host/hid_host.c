@@ -1,3 +1,5 @@
+#define LOG_MODULE LOG_MOD_HOST
+
 #include <string.h>
 #include "tusb.h"
 #include "hid_host.h"
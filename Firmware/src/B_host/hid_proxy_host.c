@@ -1,3 +1,5 @@
+#define LOG_MODULE LOG_MOD_HOST
+
 #include "hid_proxy_host.h"
 
 #include "hid_host.h"
@@ -9,6 +11,17 @@
 #include "proxy_config.h"
 #include "descriptor_logger.h"
 #include "string_manager.h"
+#include "enum_trace.h"
+#include "input_tap.h"
+#include "replay.h"
+#include "input_state.h"
+#include "input_mixer.h"
+#include "inject_sched.h"
+#include "metrics.h"
+#include "desc_session.h"
+#include "hub_aggregate.h"
+#include "fanout.h"
+#include "pio_link.h"
 #include "tusb.h"
 
 #include <string.h>
@@ -24,7 +37,9 @@
 	{
 	    bool     active;
 	    uint8_t  dev_addr;
-	    uint8_t  itf;
+	    uint8_t  itf;          // composite index: PF_INPUT itf_id, control UART
+	    uint8_t  instance;     // TinyUSB HID instance, for tuh_hid_* calls
+	    uint8_t  itf_num;      // bInterfaceNumber on the physical device
 	    uint8_t  protocol;
 	    uint8_t  itf_protocol; // bInterfaceProtocol (keyboard/mouse/other)
 	    uint8_t  inferred_type; // bit0=keyboard, bit1=mouse (from report descriptor)
@@ -37,12 +52,16 @@
     uint32_t input_count;
     uint32_t input_skipped_not_ready;
     uint32_t input_last_ts_ms;
+    uint32_t input_last_us;
     uint32_t input_last_log_ms;
     uint32_t input_min_delta_ms;
     uint32_t input_max_delta_ms;
     uint16_t input_seq;
     uint32_t send_min_us;
     uint32_t send_max_us;
+    // Telemetry window (control UART SUBSCRIBE), reset on every snapshot.
+    uint16_t tm_send_hist[HID_PROXY_SEND_HIST_BUCKETS];
+    uint32_t tm_send_max_us;
     bool     protocol_report_set;
     bool     protocol_boot_supported;
     uint8_t  protocol_attempts; // attempts to switch to REPORT
@@ -50,6 +69,10 @@
 
 static host_itf_state_t s_itf[CFG_TUH_HID];
 
+#if PROXY_HUB_AGGREGATE && (PROXY_HUB_MAX_ITFS > CFG_TUH_HID)
+#error "PROXY_HUB_MAX_ITFS must be <= CFG_TUH_HID"
+#endif
+
 static bool s_wait_ready_ack = false;
 static bool s_control_poll_enabled = false;
 static volatile bool s_ctrl_irq_pending = false;
@@ -61,6 +84,8 @@ typedef struct
 {
     bool     active;
     uint8_t  itf;
+    uint8_t  instance;
+    uint8_t  target;       // fan-out target that asked
     uint8_t  report_type;
     uint8_t  report_id;
     uint16_t requested_len;
@@ -71,11 +96,98 @@ static uint8_t              s_ctrl_get_report_buf[GET_REPORT_BUF_SIZE];
 static uint64_t             s_ready_retry_deadline = 0;
 static uint8_t              s_ready_retry_count    = 0;
 
+#define TRACE_PULL_TIMEOUT_US 200000u
+static bool     s_trace_pull_pending = false;
+static uint32_t s_trace_pull_t0_us   = 0;
+static int32_t  s_trace_offset_us    = 0;
+
+// Last PF_CTRL_STATS_DATA snapshot from A_device.
+static proto_dev_stats_t s_dev_stats;
+static bool              s_dev_stats_valid = false;
+static uint32_t          s_dev_stats_rx_ms = 0;
+
+// A_device metrics registry: PF_CTRL_METRICS_DATA pages are staged until the
+// last one arrives, then replace the cached snapshot in one go.
+typedef struct
+{
+    uint8_t  data[PROXY_DEV_METRICS_BYTES];
+    uint16_t len;
+    uint8_t  count;
+} dev_metrics_buf_t;
+
+static dev_metrics_buf_t s_dev_metrics;
+static dev_metrics_buf_t s_dev_metrics_stage;
+static uint8_t           s_dev_metrics_next = 0;   // next page start expected
+static bool              s_dev_metrics_valid = false;
+static uint32_t          s_dev_metrics_rx_ms = 0;
+
+METRIC_COUNTER_DEFINE(m_input_reports, "host.input.reports");
+METRIC_COUNTER_DEFINE(m_input_skipped, "host.input.skipped_not_ready");
+METRIC_COUNTER_DEFINE(m_input_send_failed, "host.input.send_failed");
+METRIC_HISTOGRAM_DEFINE(m_input_interval_us, "host.input.interval_us");
+METRIC_HISTOGRAM_DEFINE(m_input_send_us, "host.input.send_us");
+METRIC_COUNTER_DEFINE(m_inject_sent, "host.inject.sent");
+METRIC_COUNTER_DEFINE(m_inject_failed, "host.inject.failed");
+METRIC_COUNTER_DEFINE(m_timed_sent, "host.inject.timed_sent");
+METRIC_COUNTER_DEFINE(m_desc_resume_rounds, "host.desc.resume_rounds");
+METRIC_COUNTER_DEFINE(m_desc_resume_bytes, "host.desc.resume_bytes");
+METRIC_HISTOGRAM_DEFINE(m_desc_resume_ms, "host.desc.resume_ms");
+
+// Resumable descriptor session (PROXY_DESC_RESUME). What went out for the
+// current set stays here (report bytes in s_report_desc), so a
+// PF_CTRL_DESC_STATUS gap list is served without asking the device again.
+typedef struct
+{
+    uint8_t  id;                       // 0 = legacy in-order frames
+    uint8_t  rounds;                   // gap lists served for this set
+    uint32_t first_gap_ms;             // first gap list, 0 = none yet
+    uint16_t device_len;
+    uint8_t  device[sizeof(tusb_desc_device_t)];
+    uint16_t config_len;
+    uint8_t  config[PROXY_MAX_CONFIG_DESC_SIZE];
+    uint8_t  report_mask;
+    uint16_t report_len[CFG_TUH_HID];  // bytes forwarded per interface
+} host_desc_session_t;
+
+static host_desc_session_t s_desc_session;
+static uint8_t             s_desc_session_last = 0;
+
+#define INJECT_REPORT_MAX 64u
+
+// INJECT_BATCH reports with a delay wait in the inject_sched heap under
+// INJECT_SCHED_TAG_BATCH; each is due `delay_us` after the previous one.
+static uint32_t s_batch_tail_due_us = 0;
+
+// Timed reports (SCHEDULE, REPLAY) the alarm IRQ may not write itself: the
+// interface mixes, or injected input is being recorded. The IRQ parks them
+// here at their deadline and timed_handoff_task() sends them through
+// send_injected_input(). Single producer (alarm IRQs, which never nest),
+// single consumer (main loop); indices run free and are masked.
+#if (PROXY_TIMED_HANDOFF_DEPTH & (PROXY_TIMED_HANDOFF_DEPTH - 1u)) != 0 || PROXY_TIMED_HANDOFF_DEPTH > 128u
+#error "PROXY_TIMED_HANDOFF_DEPTH must be a power of two <= 128"
+#endif
+typedef struct
+{
+    uint8_t itf;
+    uint8_t len;
+    uint8_t report[INJECT_REPORT_MAX];
+} timed_handoff_t;
+
+static timed_handoff_t  s_timed_q[PROXY_TIMED_HANDOFF_DEPTH];
+static volatile uint8_t s_timed_head = 0;
+static volatile uint8_t s_timed_tail = 0;
+
 static bool send_descriptor_frames(uint8_t cmd, const uint8_t* data, uint16_t len);
+static bool send_descriptor_chunk(uint8_t cmd, uint16_t offset, uint16_t total,
+                                  const uint8_t* data, uint16_t len);
 static bool send_descriptor_done(void);
+static bool send_descriptor_done_frame(void);
+static bool send_descriptor_range(uint8_t cmd, uint8_t itf, uint16_t offset, uint16_t len);
+static void force_descriptor_reset(void);
 static void send_unmount_frame(void);
 static bool send_device_reset_command(uint8_t reason);
 static void ensure_input_streaming(void);
+static void timed_handoff_task(void);
 static void log_input_state(void);
 static void set_report_protocol_once(host_itf_state_t* hs);
 static void maybe_switch_to_report_protocol(host_itf_state_t* hs, uint16_t report_len);
@@ -86,16 +198,22 @@ static void handle_ctrl_set_protocol(uint8_t itf, uint8_t protocol);
 static void handle_ctrl_set_idle(uint8_t itf, uint8_t duration, uint8_t report_id);
 static void handle_ctrl_set_report(uint8_t const* payload, uint16_t len);
 static void handle_ctrl_get_report_request(uint8_t const* payload, uint16_t len);
+static void handle_ctrl_trace_data(uint8_t const* payload, uint16_t len);
+static void handle_ctrl_desc_resend(void);
+static bool replay_descriptor_set(void);
+static void handle_ctrl_desc_status(uint8_t const* payload, uint16_t len);
+static void handle_ctrl_stats_data(uint8_t const* payload, uint16_t len);
+static void handle_ctrl_metrics_data(uint8_t const* payload, uint16_t len);
 static void send_get_report_response(uint8_t report_type, uint8_t report_id,
                                      uint8_t const* data, uint16_t len);
 static bool send_set_idle_request(uint8_t itf, uint8_t duration, uint8_t report_id);
 static void control_irq_handler(uint gpio, uint32_t events);
 
-static host_itf_state_t* alloc_slot(uint8_t dev_addr, uint8_t itf);
+static host_itf_state_t* alloc_slot(uint8_t dev_addr, uint8_t instance, uint8_t itf);
 static host_itf_state_t* ensure_slot_for_itf(uint8_t itf);
 static host_itf_state_t* ensure_slot_for_dev_itf(uint8_t dev_addr, uint8_t itf);
-static host_itf_state_t* ensure_slot_for_dev_itf(uint8_t dev_addr, uint8_t itf);
 static host_itf_state_t* find_slot_by_itf(uint8_t itf);
+static bool send_composite_set(bool reset);
 
 #define REPORT_DESC_MAX 256
 static uint8_t  s_report_desc[CFG_TUH_HID][REPORT_DESC_MAX];
@@ -184,6 +302,8 @@ void hid_proxy_host_store_report_desc(uint8_t itf, uint8_t const* desc, uint16_t
     memcpy(s_report_desc[itf], desc, copy_len);
     s_report_desc_len[itf] = len;
     s_report_desc_trunc[itf] = trunc;
+    input_state_reset_itf(itf);
+    input_mixer_reset_itf(itf);
 }
 
 uint16_t hid_proxy_host_get_report_desc(uint8_t itf, uint8_t* out, uint16_t max_len, bool* truncated)
@@ -205,6 +325,28 @@ uint16_t hid_proxy_host_get_report_desc(uint8_t itf, uint8_t* out, uint16_t max_
     return len;
 }
 
+void hid_proxy_host_desc_session_begin(void)
+{
+    if (!PROXY_DESC_RESUME)
+    {
+        return;
+    }
+    if (!s_desc_session_last)
+    {
+        // Not 1 after every boot: A_device may still hold part of a set we
+        // started before a reset.
+        s_desc_session_last = (uint8_t)time_us_32();
+    }
+    s_desc_session_last++;
+    if (!s_desc_session_last)
+    {
+        s_desc_session_last = 1;
+    }
+    memset(&s_desc_session, 0, sizeof(s_desc_session));
+    s_desc_session.id = s_desc_session_last;
+    LOGI("[B] descriptor session %u", s_desc_session.id);
+}
+
 typedef struct
 {
     uint8_t report_id;
@@ -226,6 +368,13 @@ typedef struct
     uint8_t wheel_size_bits;
     uint8_t wheel_signed;
     uint8_t has_keyboard;
+    uint8_t has_kb_mods;
+    uint16_t kb_mods_offset_bits;
+    uint16_t kb_keys_offset_bits;
+    uint8_t kb_keys_count;
+    uint8_t kb_keys_size_bits;
+    uint8_t kb_keys_bitmap;
+    uint8_t kb_keys_usage_min;
 } report_layout_entry_t;
 
 static int32_t hid_read_signed(uint32_t data, uint8_t size)
@@ -287,7 +436,7 @@ static void build_usage_list(uint16_t* out, uint8_t* out_count,
     *out_count = count;
 }
 
-bool hid_proxy_host_get_report_layout(uint8_t itf, uint8_t report_id, hid_report_layout_t* out)
+static bool get_report_layout(uint8_t itf, uint8_t report_id, bool prefer_keyboard, hid_report_layout_t* out)
 {
     if (!out) return false;
 
@@ -382,12 +531,38 @@ bool hid_proxy_host_get_report_layout(uint8_t itf, uint8_t report_id, hid_report
                 uint16_t start_offset = entry->total_bits;
                 entry->total_bits = (uint16_t)(entry->total_bits + (uint16_t)(report_size * report_count));
 
+                // Only the first usages matter; an NKRO bitmap's range would overrun.
                 uint16_t usages[16];
                 uint8_t usage_count = 0;
-                build_usage_list(usages, &usage_count, usage_list, usage_list_count, usage_min, usage_max, (uint8_t)report_count);
+                uint8_t usage_cap = (uint8_t)(report_count < TU_ARRAY_SIZE(usages) ? report_count : TU_ARRAY_SIZE(usages));
+                build_usage_list(usages, &usage_count, usage_list, usage_list_count, usage_min, usage_max, usage_cap);
 
                 bool is_constant = (data & 0x01u) != 0;
-                if (!is_constant)
+                if (!is_constant && usage_page == 0x07)
+                {
+                    // Keyboard: modifier bits (E0..E7) and the key field, either
+                    // a bitmap (NKRO, one bit per usage) or a boot-style array.
+                    bool is_variable = (data & 0x02u) != 0;
+                    uint16_t first = usage_count ? usages[0] : (usage_min >= 0 ? (uint16_t)usage_min : 0);
+                    entry->has_keyboard = 1;
+                    if (is_variable && report_size == 1 && first >= 0xE0)
+                    {
+                        if (!entry->has_kb_mods && first == 0xE0)
+                        {
+                            entry->has_kb_mods = 1;
+                            entry->kb_mods_offset_bits = start_offset;
+                        }
+                    }
+                    else if (!entry->kb_keys_count)
+                    {
+                        entry->kb_keys_offset_bits = start_offset;
+                        entry->kb_keys_count = (uint8_t)(report_count > 255 ? 255 : report_count);
+                        entry->kb_keys_size_bits = (uint8_t)report_size;
+                        entry->kb_keys_bitmap = (is_variable && report_size == 1) ? 1 : 0;
+                        entry->kb_keys_usage_min = (uint8_t)first;
+                    }
+                }
+                else if (!is_constant)
                 {
                     for (uint8_t idx = 0; idx < report_count; idx++)
                     {
@@ -460,17 +635,14 @@ bool hid_proxy_host_get_report_layout(uint8_t itf, uint8_t report_id, hid_report
                 break;
             }
         }
-        if (!selected)
+        for (size_t n = 0; n < TU_ARRAY_SIZE(entries) && (!selected || prefer_keyboard); n++)
         {
-            for (size_t n = 0; n < TU_ARRAY_SIZE(entries); n++)
+            report_layout_entry_t* e = &entries[n];
+            if (e->report_id == 0xFF) continue;
+            if (e->has_keyboard && (e->kb_keys_count || !prefer_keyboard))
             {
-                report_layout_entry_t* e = &entries[n];
-                if (e->report_id == 0xFF) continue;
-                if (e->has_keyboard)
-                {
-                    selected = e;
-                    break;
-                }
+                selected = e;
+                break;
             }
         }
     }
@@ -505,11 +677,37 @@ bool hid_proxy_host_get_report_layout(uint8_t itf, uint8_t report_id, hid_report
 
     out->kb_report_len = (uint8_t)((selected->total_bits + 7u) / 8u);
     out->kb_has_report_id = selected->report_id ? 1 : 0;
+    out->kb_has_mods = selected->has_kb_mods;
+    out->kb_mods_offset_bits = selected->kb_mods_offset_bits;
+    out->kb_keys_offset_bits = selected->kb_keys_offset_bits;
+    out->kb_keys_count = selected->kb_keys_count;
+    out->kb_keys_size_bits = selected->kb_keys_size_bits;
+    out->kb_keys_bitmap = selected->kb_keys_bitmap;
+    out->kb_keys_usage_min = selected->kb_keys_usage_min;
     return true;
 }
 
+bool hid_proxy_host_get_report_layout(uint8_t itf, uint8_t report_id, hid_report_layout_t* out)
+{
+    return get_report_layout(itf, report_id, false, out);
+}
+
+bool hid_proxy_host_get_keyboard_layout(uint8_t itf, hid_report_layout_t* out)
+{
+    return get_report_layout(itf, 0, true, out);
+}
+
 uint8_t hid_proxy_host_first_dev_addr(void)
 {
+    // With a hub the composite carries the primary device's strings.
+    uint8_t primary = PROXY_HUB_AGGREGATE ? hub_aggregate_primary() : 0;
+    for (size_t i = 0; primary && i < TU_ARRAY_SIZE(s_itf); i++)
+    {
+        if (s_itf[i].active && s_itf[i].mounted && s_itf[i].dev_addr == primary)
+        {
+            return primary;
+        }
+    }
     for (size_t i = 0; i < TU_ARRAY_SIZE(s_itf); i++)
     {
         if (s_itf[i].active && s_itf[i].mounted)
@@ -520,18 +718,43 @@ uint8_t hid_proxy_host_first_dev_addr(void)
     return 0;
 }
 
-static host_itf_state_t* find_slot(uint8_t dev_addr, uint8_t itf)
+static host_itf_state_t* find_slot(uint8_t dev_addr, uint8_t instance)
 {
     for (size_t i = 0; i < TU_ARRAY_SIZE(s_itf); i++)
     {
         if (s_itf[i].active &&
             s_itf[i].dev_addr == dev_addr &&
-            s_itf[i].itf == itf)
+            s_itf[i].instance == instance)
+        {
+            return &s_itf[i];
+        }
+    }
+    return NULL;
+}
+
+static host_itf_state_t* find_slot_by_itf_num(uint8_t dev_addr, uint8_t itf_num)
+{
+    for (size_t i = 0; i < TU_ARRAY_SIZE(s_itf); i++)
+    {
+        if (s_itf[i].active &&
+            s_itf[i].dev_addr == dev_addr &&
+            s_itf[i].itf_num == itf_num)
         {
             return &s_itf[i];
         }
     }
     return NULL;
+}
+
+// Composite interface of `itf_num` of `dev_addr`: the interface number itself
+// for a lone device, base + number behind a hub.
+static uint8_t composite_itf(uint8_t dev_addr, uint8_t itf_num)
+{
+    if (!PROXY_HUB_AGGREGATE)
+    {
+        return itf_num;
+    }
+    return hub_aggregate_attach(dev_addr, itf_num);
 }
 
 static host_itf_state_t* find_slot_by_itf(uint8_t itf)
@@ -559,12 +782,17 @@ static host_itf_state_t* ensure_slot_for_itf(uint8_t itf)
         return NULL;
     }
 
-    return ensure_slot_for_dev_itf(dev_addr, itf);
+    uint8_t base = PROXY_HUB_AGGREGATE ? hub_aggregate_itf_base(dev_addr) : 0;
+    if (base > itf)
+    {
+        return NULL;
+    }
+    return ensure_slot_for_dev_itf(dev_addr, (uint8_t)(itf - base));
 }
 
-static host_itf_state_t* alloc_slot(uint8_t dev_addr, uint8_t itf)
+static host_itf_state_t* alloc_slot(uint8_t dev_addr, uint8_t instance, uint8_t itf)
 {
-    host_itf_state_t* existing = find_slot(dev_addr, itf);
+    host_itf_state_t* existing = find_slot(dev_addr, instance);
     if (existing) return existing;
 
     for (size_t i = 0; i < TU_ARRAY_SIZE(s_itf); i++)
@@ -575,11 +803,14 @@ static host_itf_state_t* alloc_slot(uint8_t dev_addr, uint8_t itf)
             s_itf[i].active   = true;
             s_itf[i].dev_addr = dev_addr;
             s_itf[i].itf      = itf;
+            s_itf[i].instance = instance;
+            s_itf[i].itf_num  = instance;
             s_itf[i].input_paused = true;
             s_itf[i].input_ready = false;
             s_itf[i].input_count = 0;
             s_itf[i].input_skipped_not_ready = 0;
             s_itf[i].input_last_ts_ms = 0;
+            s_itf[i].input_last_us = 0;
             s_itf[i].input_last_log_ms = 0;
             s_itf[i].input_min_delta_ms = UINT32_MAX;
             s_itf[i].input_max_delta_ms = 0;
@@ -592,12 +823,21 @@ static host_itf_state_t* alloc_slot(uint8_t dev_addr, uint8_t itf)
     return NULL;
 }
 
+// `itf` is the interface number on `dev_addr`, as in its config descriptor.
 static host_itf_state_t* ensure_slot_for_dev_itf(uint8_t dev_addr, uint8_t itf)
 {
-    host_itf_state_t* hs = find_slot_by_itf(itf);
+    host_itf_state_t* hs = find_slot_by_itf_num(dev_addr, itf);
+    if (hs) return hs;
+
+    uint8_t comp = composite_itf(dev_addr, itf);
+    if (comp >= CFG_TUH_HID)
+    {
+        return NULL;
+    }
+    hs = find_slot_by_itf(comp);
     if (hs) return hs;
 
-    hs = alloc_slot(dev_addr, itf);
+    hs = alloc_slot(dev_addr, itf, comp);
     if (hs)
     {
         hs->mounted  = true;
@@ -606,7 +846,7 @@ static host_itf_state_t* ensure_slot_for_dev_itf(uint8_t dev_addr, uint8_t itf)
         hs->protocol = HID_PROTOCOL_REPORT;
         hs->protocol_report_set = true;
         hs->protocol_boot_supported = true;
-        LOGW("[B] created slot for itf=%u dev=%u (no mount callback)", itf, dev_addr);
+        LOGW("[B] created slot for itf=%u dev=%u (no mount callback)", comp, dev_addr);
     }
     return hs;
 }
@@ -615,6 +855,11 @@ void hid_proxy_host_ensure_slot(uint8_t dev_addr, uint8_t itf)
 {
     (void)ensure_slot_for_dev_itf(dev_addr, itf);
 }
+
+uint8_t hid_proxy_host_composite_itf(uint8_t dev_addr, uint8_t itf_num)
+{
+    return PROXY_HUB_AGGREGATE ? hub_aggregate_itf(dev_addr, itf_num) : itf_num;
+}
 
 static bool any_active_for_dev(uint8_t dev_addr)
 {
@@ -628,6 +873,265 @@ static bool any_active_for_dev(uint8_t dev_addr)
     return false;
 }
 
+static bool any_active_other_dev(uint8_t dev_addr)
+{
+    for (size_t i = 0; i < TU_ARRAY_SIZE(s_itf); i++)
+    {
+        if (s_itf[i].active && s_itf[i].dev_addr != dev_addr)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// Hub aggregation (PROXY_HUB_AGGREGATE). The first device is forwarded as
+// fetched, exactly like a lone device. Every further device is only captured
+// by the descriptor logger; once all are captured the composite set is
+// synthesized from the stored descriptors and A_device re-enumerates with it.
+// ---------------------------------------------------------------------------
+#define HUB_CAPTURE_TRIES 3u
+
+static bool    s_hub_compose_pending = false;
+static uint8_t s_hub_capture_dev     = 0;
+static uint8_t s_hub_capture_tries   = 0;
+static uint8_t s_hub_cfg[PROXY_MAX_CONFIG_DESC_SIZE];
+static uint8_t s_hub_report[1 + REPORT_DESC_MAX];
+
+static void host_set_fetched(uint8_t dev_addr,
+                             const uint8_t* device, uint16_t device_len,
+                             const uint8_t* cfg, uint16_t cfg_len)
+{
+    if (!PROXY_HUB_AGGREGATE)
+    {
+        return;
+    }
+    if (!hub_aggregate_store(dev_addr, device, device_len, cfg, cfg_len))
+    {
+        LOGW("[B] hub: descriptors of dev=%u not kept (HID part over %u bytes?)",
+             dev_addr, (unsigned)PROXY_HUB_DEV_CFG_MAX);
+        return;
+    }
+    if (hub_aggregate_count() > 1 && hub_aggregate_complete())
+    {
+        // Sent from the task: this runs inside a TinyUSB transfer callback.
+        s_hub_compose_pending = true;
+    }
+}
+
+// Composite indexes change when the composite is first presented (every
+// device packed from 0) and when a device leaves (the rest close up, a lone
+// device goes back to its own interface numbers); per-interface state
+// (report descriptor, poll interval) moves with its interface. The mapping
+// keeps the interface order, so a slot whose target is taken only waits for
+// the occupant to move on.
+static void hub_renumber_slots(void)
+{
+    bool moved = true;
+    while (moved)
+    {
+        moved = false;
+        for (size_t i = 0; i < TU_ARRAY_SIZE(s_itf); i++)
+        {
+            host_itf_state_t* hs = &s_itf[i];
+            if (!hs->active) continue;
+            uint8_t old = hs->itf;
+            uint8_t itf = hub_aggregate_itf(hs->dev_addr, hs->itf_num);
+            if (itf == old || itf >= CFG_TUH_HID || old >= CFG_TUH_HID || find_slot_by_itf(itf)) continue;
+
+            memcpy(s_report_desc[itf], s_report_desc[old], REPORT_DESC_MAX);
+            s_report_desc_len[itf]   = s_report_desc_len[old];
+            s_report_desc_trunc[itf] = s_report_desc_trunc[old];
+            s_report_desc_len[old]   = 0;
+            s_report_desc_trunc[old] = 0;
+            input_state_reset_itf(old);
+            input_mixer_reset_itf(old);
+            input_state_reset_itf(itf);
+            input_mixer_reset_itf(itf);
+            descriptor_logger_move_itf(old, itf);
+            LOGI("[B] hub: dev=%u itf %u -> %u", hs->dev_addr, old, itf);
+            hs->itf = itf;
+            moved = true;
+        }
+    }
+}
+
+// `gone_dev` left while other devices stay: re-present whatever is left.
+static void hub_regroup(uint8_t gone_dev)
+{
+    uint8_t old_primary = hub_aggregate_primary();
+    if (descriptor_logger_active_dev() == gone_dev)
+    {
+        descriptor_logger_reset();
+    }
+    hub_aggregate_detach(gone_dev);
+    if (s_hub_capture_dev == gone_dev)
+    {
+        s_hub_capture_dev = 0;
+    }
+    hub_renumber_slots();
+
+    uint8_t primary = hub_aggregate_primary();
+    LOGI("[B] hub: dev=%u gone, %u device(s) left", gone_dev, hub_aggregate_count());
+    if (primary != old_primary)
+    {
+        string_manager_reset();
+    }
+
+    if (hub_aggregate_count() > 1)
+    {
+        // Pending captures finish first; the composite follows from there.
+        s_hub_compose_pending = hub_aggregate_complete();
+        return;
+    }
+
+    // One device left: back to forwarding its own descriptor set.
+    s_hub_compose_pending = false;
+    force_descriptor_reset();
+    string_manager_reset();
+    descriptor_logger_reset();
+    if (primary)
+    {
+        descriptor_logger_start(primary, NULL, 0);
+    }
+}
+
+static void hub_task(void)
+{
+    if (!PROXY_HUB_AGGREGATE || descriptor_logger_active_dev())
+    {
+        return;
+    }
+
+    if (s_hub_compose_pending)
+    {
+        s_hub_compose_pending = false;
+        send_composite_set(true);
+        return;
+    }
+
+    uint8_t dev = hub_aggregate_next_pending();
+    if (!dev)
+    {
+        return;
+    }
+    if (dev != s_hub_capture_dev)
+    {
+        s_hub_capture_dev   = dev;
+        s_hub_capture_tries = 0;
+    }
+    if (s_hub_capture_tries >= HUB_CAPTURE_TRIES)
+    {
+        return;
+    }
+    if (++s_hub_capture_tries == HUB_CAPTURE_TRIES)
+    {
+        LOGW("[B] hub: last descriptor capture attempt for dev=%u", dev);
+    }
+    descriptor_logger_capture(dev);
+}
+
+
+// ---------------------------------------------------------------------------
+// Fan-out (PROXY_FANOUT_TARGETS): target 0 is the hardware link, the rest are
+// PIO links. fanout.c picks the targets of every frame.
+// ---------------------------------------------------------------------------
+static int host_link_send(uint8_t target, uint8_t const* frame, uint16_t len)
+{
+#if PROXY_FANOUT_TARGETS > 1
+    if (target)
+    {
+        return pio_link_send((uint8_t)(target - 1u), frame, len);
+    }
+#endif
+    return uart_transport_send(frame, len);
+}
+
+static int host_link_send_from_isr(uint8_t target, uint8_t const* frame, uint16_t len)
+{
+#if PROXY_FANOUT_TARGETS > 1
+    if (target)
+    {
+        return pio_link_send_from_isr((uint8_t)(target - 1u), frame, len);
+    }
+#endif
+    return uart_transport_send_from_isr(frame, len);
+}
+
+static int host_link_recv(uint8_t target, uint8_t* buf, uint16_t max)
+{
+#if PROXY_FANOUT_TARGETS > 1
+    if (target)
+    {
+        return pio_link_recv_frame((uint8_t)(target - 1u), buf, max);
+    }
+#endif
+    return uart_transport_recv_frame(buf, max);
+}
+
+static const fanout_link_ops_t s_link_ops = {
+    .send          = host_link_send,
+    .send_from_isr = host_link_send_from_isr,
+    .recv          = host_link_recv,
+};
+
+static void switch_focus(uint8_t target)
+{
+    // Whatever the old target believes held is released there first.
+    input_state_release_all(INPUT_STATE_ITF_ALL);
+    fanout_set_focus(target);
+}
+
+// Focus hotkey on the physical keyboard report just recorded by input_state.
+// True while the hotkey digit is held: that report reaches no target.
+static bool fanout_hotkey_filter(uint8_t itf, uint8_t const* report, uint16_t len)
+{
+    hid_report_layout_t const* kb;
+    hid_report_layout_t const* mouse;
+    input_state_layouts(itf, &kb, &mouse);
+    if (!kb || (kb->kb_has_report_id && (len < 1 || report[0] != kb->report_id)))
+    {
+        return false;
+    }
+
+    input_state_view_t v;
+    if (!input_state_get(itf, &v))
+    {
+        return false;
+    }
+    bool swallow = false;
+    uint8_t target = fanout_hotkey_feed(v.phys_mods, v.phys_keys, v.phys_count, &swallow);
+    if (target != FANOUT_NO_TARGET && target != fanout_focus())
+    {
+        LOGI("[B] hotkey: focus -> target %u", target);
+        switch_focus(target);
+    }
+    return swallow;
+}
+
+bool hid_proxy_host_set_focus(uint8_t target)
+{
+    if (target >= fanout_targets())
+    {
+        return false;
+    }
+    if (target != fanout_focus())
+    {
+        switch_focus(target);
+    }
+    return true;
+}
+
+bool hid_proxy_host_fanout_resync(uint8_t target)
+{
+    if (target >= fanout_targets())
+    {
+        return false;
+    }
+    fanout_desc_scope_target(target);
+    return replay_descriptor_set();
+}
 
 static bool host_send_descriptor_frames(uint8_t cmd, const uint8_t* data, uint16_t len)
 {
@@ -642,6 +1146,8 @@ static uint32_t host_time_ms(void)
 void hid_proxy_host_init(void)
 {
     memset(s_itf, 0, sizeof(s_itf));
+    hub_aggregate_reset();
+    fanout_init(PROXY_FANOUT_TARGETS, &s_link_ops);
     s_control_poll_enabled = false;
     s_ctrl_irq_pending = false;
 
@@ -652,9 +1158,24 @@ void hid_proxy_host_init(void)
     string_manager_init(&string_ops);
     descriptor_logger_ops_t logger_ops = {
         .send_descriptor_frames = host_send_descriptor_frames,
+        .send_descriptor_chunk  = send_descriptor_chunk,
         .send_descriptor_done   = send_descriptor_done,
+        .set_fetched            = host_set_fetched,
     };
     descriptor_logger_init(&logger_ops);
+    enum_trace_init(ET_BOARD_B);
+
+    metrics_register(&m_input_reports);
+    metrics_register(&m_input_skipped);
+    metrics_register(&m_input_send_failed);
+    metrics_register(&m_input_interval_us);
+    metrics_register(&m_input_send_us);
+    metrics_register(&m_inject_sent);
+    metrics_register(&m_inject_failed);
+    metrics_register(&m_timed_sent);
+    metrics_register(&m_desc_resume_rounds);
+    metrics_register(&m_desc_resume_bytes);
+    metrics_register(&m_desc_resume_ms);
 
     gpio_init(PROXY_IRQ_PIN);
     gpio_set_dir(PROXY_IRQ_PIN, GPIO_IN);
@@ -684,8 +1205,11 @@ void hid_proxy_host_task(void)
         s_ctrl_irq_pending = false;
     }
 
+    descriptor_logger_task();
+    hub_task();
     string_manager_task();
     ensure_input_streaming();
+    timed_handoff_task();
 }
 
 void hid_proxy_host_on_mount(uint8_t dev_addr,
@@ -693,6 +1217,8 @@ void hid_proxy_host_on_mount(uint8_t dev_addr,
                              uint8_t const* desc_report,
                              uint16_t desc_len)
 {
+    // A physical change re-enumerates every target.
+    fanout_desc_scope_all();
     if (instance >= CFG_TUH_HID)
     {
         LOGW("[B] HID mount skipped itf=%u (beyond CFG_TUH_HID=%u)",
@@ -701,24 +1227,41 @@ void hid_proxy_host_on_mount(uint8_t dev_addr,
         return;
     }
 
-    host_itf_state_t* hs = alloc_slot(dev_addr, instance);
+    tuh_itf_info_t info;
+    bool have_info = tuh_hid_itf_get_info(dev_addr, instance, &info);
+    uint8_t itf_num = have_info ? info.desc.bInterfaceNumber : instance;
+    uint8_t itf = composite_itf(dev_addr, itf_num);
+    if (itf >= CFG_TUH_HID)
+    {
+        LOGW("[B] HID mount skipped dev=%u itf=%u (no composite interface left)",
+             dev_addr,
+             itf_num);
+        return;
+    }
+
+    host_itf_state_t* hs = alloc_slot(dev_addr, instance, itf);
     if (!hs)
     {
         LOGW("[B] no free slot for dev=%u itf=%u", dev_addr, instance);
         return;
     }
+    hs->itf      = itf;
+    hs->itf_num  = itf_num;
     hs->mounted  = true;
     hs->input_started = false;
     hs->input_ready   = false;
     hs->input_count   = 0;
     hs->input_skipped_not_ready = 0;
     hs->input_last_ts_ms = 0;
+    hs->input_last_us = 0;
     hs->input_last_log_ms = 0;
     hs->input_min_delta_ms = UINT32_MAX;
     hs->input_max_delta_ms = 0;
     hs->input_seq = 0;
 	    hs->send_min_us = UINT32_MAX;
 	    hs->send_max_us = 0;
+    memset(hs->tm_send_hist, 0, sizeof(hs->tm_send_hist));
+    hs->tm_send_max_us = 0;
     hs->protocol = HID_PROTOCOL_BOOT;
     hs->itf_protocol = 0;
     hs->inferred_type = 0;
@@ -726,8 +1269,7 @@ void hid_proxy_host_on_mount(uint8_t dev_addr,
     hs->protocol_boot_supported = false;
     hs->protocol_attempts       = 0;
 
-    tuh_itf_info_t info;
-	    if (tuh_hid_itf_get_info(dev_addr, instance, &info))
+	    if (have_info)
 	    {
 	        uint8_t proto = info.desc.bInterfaceProtocol;
 	        hs->itf_protocol = proto;
@@ -740,8 +1282,19 @@ void hid_proxy_host_on_mount(uint8_t dev_addr,
          instance,
          desc_len);
 
+    if (PROXY_HUB_AGGREGATE && dev_addr != hub_aggregate_primary())
+    {
+        // Another device is already presented: capture this one from
+        // hub_task() and re-enumerate A_device with the composite.
+        LOGI("[B] hub: dev=%u itf=%u joins the composite as itf %u", dev_addr, itf_num, itf);
+        hs->inferred_type = infer_hid_type_from_report_desc(desc_report, desc_len);
+        hs->input_pending = false;
+        return;
+    }
+
     string_manager_reset();
     descriptor_logger_start(dev_addr, desc_report, desc_len);
+    enum_trace_record(ET_MOUNT, instance);
     hs->inferred_type = infer_hid_type_from_report_desc(desc_report, desc_len);
 
     hs->input_pending = false;
@@ -754,8 +1307,16 @@ void hid_proxy_host_on_mount(uint8_t dev_addr,
 void hid_proxy_host_on_unmount(uint8_t dev_addr, uint8_t instance)
 {
     LOGI("[B] HID unmount dev=%u itf=%u", dev_addr, instance);
-    send_unmount_frame();
+    enum_trace_record(ET_UNMOUNT, instance);
+    fanout_desc_scope_all();
     host_itf_state_t* hs = find_slot(dev_addr, instance);
+    uint8_t itf = hs ? hs->itf : instance;
+    // Behind a hub the PC keeps the device while anything else is attached.
+    bool others = PROXY_HUB_AGGREGATE && any_active_other_dev(dev_addr);
+    if (!others)
+    {
+        send_unmount_frame();
+    }
 	    if (hs)
 	    {
 	        hs->input_paused   = true;
@@ -769,10 +1330,27 @@ void hid_proxy_host_on_unmount(uint8_t dev_addr, uint8_t instance)
 	        hs->mounted = false;
 	        hs->active  = false;
 	    }
-    if (instance < CFG_TUH_HID)
+    if (itf < CFG_TUH_HID)
+    {
+        s_report_desc_len[itf] = 0;
+        s_report_desc_trunc[itf] = 0;
+        input_state_reset_itf(itf);
+        input_mixer_reset_itf(itf);
+    }
+
+    if (PROXY_HUB_AGGREGATE && !any_active_for_dev(dev_addr))
+    {
+        if (others)
+        {
+            hub_regroup(dev_addr);
+            return;
+        }
+        hub_aggregate_detach(dev_addr);
+        s_hub_compose_pending = false;
+    }
+    if (others)
     {
-        s_report_desc_len[instance] = 0;
-        s_report_desc_trunc[instance] = 0;
+        return;
     }
 
     s_wait_ready_ack = false;
@@ -781,6 +1359,20 @@ void hid_proxy_host_on_unmount(uint8_t dev_addr, uint8_t instance)
     string_manager_reset();
 }
 
+// Log2 buckets: [0] < BASE, [i] < BASE << i, last bucket open-ended.
+static void send_hist_record(host_itf_state_t* hs, uint32_t send_us)
+{
+    uint8_t b = 0;
+    uint32_t edge = HID_PROXY_SEND_HIST_BASE_US;
+    while (b < HID_PROXY_SEND_HIST_BUCKETS - 1u && send_us >= edge)
+    {
+        b++;
+        edge <<= 1;
+    }
+    if (hs->tm_send_hist[b] != UINT16_MAX) hs->tm_send_hist[b]++;
+    if (send_us > hs->tm_send_max_us) hs->tm_send_max_us = send_us;
+}
+
 void hid_proxy_host_on_report(uint8_t dev_addr, uint8_t instance,
                               uint8_t const* report, uint16_t len)
 {
@@ -804,7 +1396,14 @@ void hid_proxy_host_on_report(uint8_t dev_addr, uint8_t instance,
 
     uint32_t now_ms = board_millis();
     uint32_t t_start_us = time_us_32();
+    uint8_t tap_flags = 0;
     hs->input_count++;
+    metric_inc(&m_input_reports);
+    if (hs->input_last_us != 0)
+    {
+        metric_observe(&m_input_interval_us, t_start_us - hs->input_last_us);
+    }
+    hs->input_last_us = t_start_us;
     if (hs->input_last_ts_ms != 0)
     {
         uint32_t delta = now_ms - hs->input_last_ts_ms;
@@ -818,6 +1417,7 @@ void hid_proxy_host_on_report(uint8_t dev_addr, uint8_t instance,
     if (hs->input_paused || s_wait_ready_ack)
     {
         hs->input_skipped_not_ready++;
+        metric_inc(&m_input_skipped);
         if (INPUT_LOG_VERBOSE)
         {
             LOGW("[B] skipping input frame (not ready) itf=%u len=%u", hs->itf, len);
@@ -827,6 +1427,7 @@ void hid_proxy_host_on_report(uint8_t dev_addr, uint8_t instance,
     if (!hs->input_ready)
     {
         hs->input_skipped_not_ready++;
+        metric_inc(&m_input_skipped);
         if (INPUT_LOG_VERBOSE)
         {
             LOGW("[B] skipping input frame (READY not acked) itf=%u len=%u", hs->itf, len);
@@ -834,16 +1435,32 @@ void hid_proxy_host_on_report(uint8_t dev_addr, uint8_t instance,
         goto restart_receive;
     }
 
-    int out = proto_build_input(hs->itf, now_ms, hs->input_seq++, report, len, buf, sizeof(buf));
+    // Keys and buttons held through KEY stay held across physical reports.
+    uint8_t merged[INPUT_STATE_REPORT_MAX];
+    uint8_t const* fwd = input_state_on_physical(hs->itf, report, len, merged);
+    if (fanout_targets() > 1 && fanout_hotkey_filter(hs->itf, report, len))
+    {
+        goto restart_receive;
+    }
+    if (input_mixer_take_physical(hs->itf, fwd, len))
+    {
+        // Held by the mixer; it sends the merged report on the poll interval.
+        tap_flags |= INPUT_TAP_FLAG_MIXED;
+        goto restart_receive;
+    }
+    int out = proto_build_input(hs->itf, now_ms, hs->input_seq++, fwd, len, buf, sizeof(buf));
     if (out > 0)
     {
-        int wr = uart_transport_send(buf, (uint16_t)out);
+        int wr = fanout_send(buf, (uint16_t)out);
         if (wr < 0)
         {
+            metric_inc(&m_input_send_failed);
             LOGW("[B] UART send input frame failed wr=%d out=%d", wr, out);
         }
         else
         {
+            tap_flags |= INPUT_TAP_FLAG_FORWARDED;
+            enum_trace_record_once(ET_FIRST_INPUT_SENT, hs->itf);
             if (INPUT_LOG_VERBOSE)
             {
                 LOGT("[B] input frame sent len=%d", out);
@@ -853,6 +1470,8 @@ void hid_proxy_host_on_report(uint8_t dev_addr, uint8_t instance,
         uint32_t send_us = t_end_us - t_start_us;
         if (send_us < hs->send_min_us) hs->send_min_us = send_us;
         if (send_us > hs->send_max_us) hs->send_max_us = send_us;
+        send_hist_record(hs, send_us);
+        metric_observe(&m_input_send_us, send_us);
     }
     else
     {
@@ -860,7 +1479,7 @@ void hid_proxy_host_on_report(uint8_t dev_addr, uint8_t instance,
     }
 
 restart_receive:
-    if (!tuh_hid_receive_report(hs->dev_addr, hs->itf))
+    if (!tuh_hid_receive_report(hs->dev_addr, hs->instance))
     {
         LOGW("[B] tuh_hid_receive_report() failed after report");
         hs->input_pending = false;
@@ -872,6 +1491,10 @@ restart_receive:
         hs->input_pending = true;
     }
 
+    // Tap copy only after the report is on the link and the endpoint re-armed.
+    input_tap_record(hs->itf, tap_flags, t_start_us, report, len);
+    replay_record(REPLAY_SRC_PHYSICAL, hs->itf, t_start_us, report, len);
+
     if ((hs->input_count % 500 == 0) || (now_ms - hs->input_last_log_ms > 5000))
     {
         uint32_t min_d = (hs->input_min_delta_ms == UINT32_MAX) ? 0 : hs->input_min_delta_ms;
@@ -899,9 +1522,9 @@ void tuh_hid_get_report_complete_cb(uint8_t dev_addr,
                                     uint16_t len)
 {
     if (s_ctrl_get_report.active &&
-        (s_ctrl_get_report.itf != instance))
+        (s_ctrl_get_report.instance != instance))
     {
-        LOGW("[B] GET_REPORT complete wrong itf=%u expected=%u", instance, s_ctrl_get_report.itf);
+        LOGW("[B] GET_REPORT complete wrong itf=%u expected=%u", instance, s_ctrl_get_report.instance);
         return;
     }
     if (len > s_ctrl_get_report.requested_len)
@@ -914,17 +1537,19 @@ void tuh_hid_get_report_complete_cb(uint8_t dev_addr,
          report_id,
          len);
 
+    fanout_reply_begin(s_ctrl_get_report.target);
     send_get_report_response(report_type,
                              report_id,
                              (len ? s_ctrl_get_report_buf : NULL),
                              len);
+    fanout_reply_end();
     s_ctrl_get_report.active = false;
 }
 
 static bool fetch_control_frame(proto_frame_t* frame)
 {
     uint8_t buf[PROTO_MAX_FRAME_SIZE];
-    int len = uart_transport_recv_frame(buf, sizeof(buf));
+    int len = fanout_recv(buf, sizeof(buf), NULL);
     if (len <= 0) return false;
 
     if (!proto_parse(buf, (uint16_t)len, frame))
@@ -1008,6 +1633,26 @@ static bool process_control_frames(void)
                 string_manager_handle_ctrl_request(frame.data, frame.len);
                 break;
 
+            case PF_CTRL_TRACE_DATA:
+                handle_ctrl_trace_data(frame.data, frame.len);
+                break;
+
+            case PF_CTRL_DESC_RESEND:
+                handle_ctrl_desc_resend();
+                break;
+
+            case PF_CTRL_DESC_STATUS:
+                handle_ctrl_desc_status(frame.data, frame.len);
+                break;
+
+            case PF_CTRL_STATS_DATA:
+                handle_ctrl_stats_data(frame.data, frame.len);
+                break;
+
+            case PF_CTRL_METRICS_DATA:
+                handle_ctrl_metrics_data(frame.data, frame.len);
+                break;
+
             default:
                 LOGW("[B] unknown control cmd=%u len=%u", frame.cmd, frame.len);
                 break;
@@ -1020,6 +1665,7 @@ static bool process_control_frames(void)
 static void handle_ctrl_ready(void)
 {
     // Завжди реагуємо на READY, навіть якщо флаг уже скинуто.
+    fanout_note_ready(fanout_reply_target());
     s_wait_ready_ack = false;
     s_ready_retry_deadline = 0;
     for (size_t i = 0; i < TU_ARRAY_SIZE(s_itf); i++)
@@ -1038,13 +1684,118 @@ static void handle_ctrl_ready(void)
     s_ctrl_irq_pending = false;
 
     LOGI("[B] READY ack received");
+    enum_trace_record(ET_READY_RECV, 0);
+    if (s_desc_session.first_gap_ms)
+    {
+        uint32_t ms = board_millis() - s_desc_session.first_gap_ms;
+        metric_observe(&m_desc_resume_ms, ms);
+        LOGI("[B] descriptor session %u recovered in %lu ms (%u round(s))",
+             s_desc_session.id, (unsigned long)ms, s_desc_session.rounds);
+        s_desc_session.first_gap_ms = 0;
+    }
+    descriptor_logger_note_ready();
     ensure_input_streaming();
 }
-
-static void handle_ctrl_set_protocol(uint8_t itf, uint8_t protocol)
+
+// A_device held the PC session across a re-plug but the new descriptor set
+// did not match; it only digested the frames, so run the whole set again.
+static bool replay_descriptor_set(void)
 {
-    host_itf_state_t* hs = find_slot_by_itf(itf);
-    if (hs)
+    s_wait_ready_ack = false;
+    s_ready_retry_deadline = 0;
+    s_control_poll_enabled = false;
+
+    if (PROXY_HUB_AGGREGATE && hub_aggregate_count() > 1 && hub_aggregate_complete())
+    {
+        LOGI("[B] DESC_RESEND: replaying the composite set");
+        send_composite_set(false);
+        return true;
+    }
+
+    for (size_t i = 0; i < TU_ARRAY_SIZE(s_itf); i++)
+    {
+        if (s_itf[i].active && s_itf[i].mounted)
+        {
+            LOGI("[B] DESC_RESEND: replaying descriptors for dev=%u", s_itf[i].dev_addr);
+            string_manager_reset();
+            descriptor_logger_reset();
+            descriptor_logger_start(s_itf[i].dev_addr, NULL, 0);
+            return true;
+        }
+    }
+
+    LOGW("[B] DESC_RESEND ignored: no mounted device");
+    return false;
+}
+
+static void handle_ctrl_desc_resend(void)
+{
+    // Only the asking target gets the set; the others keep their PC session.
+    fanout_desc_scope_reply();
+    replay_descriptor_set();
+}
+
+// A_device is short of some bytes of the current session: resend exactly
+// those, then DONE again. It answers with READY or the next gap list.
+static void handle_ctrl_desc_status(uint8_t const* payload, uint16_t len)
+{
+    desc_status_t st;
+    if (!desc_session_parse_status(payload, len, &st))
+    {
+        LOGW("[B] DESC_STATUS malformed len=%u", len);
+        return;
+    }
+    // With several targets the first READY clears the wait; the rest still catch up.
+    if (!s_desc_session.id || st.session != s_desc_session.id ||
+        (!s_wait_ready_ack && fanout_targets() < 2))
+    {
+        LOGW("[B] DESC_STATUS for session %u ignored (current %u)", st.session, s_desc_session.id);
+        return;
+    }
+
+    s_desc_session.rounds++;
+    metric_inc(&m_desc_resume_rounds);
+    if (!s_desc_session.first_gap_ms)
+    {
+        s_desc_session.first_gap_ms = board_millis();
+    }
+    if (s_desc_session.rounds > PROXY_DESC_RESUME_ROUNDS)
+    {
+        LOGW("[B] descriptor session %u still incomplete after %u rounds, forcing UNMOUNT/RESET",
+             s_desc_session.id, s_desc_session.rounds - 1u);
+        fanout_desc_scope_reply();
+        force_descriptor_reset();
+        return;
+    }
+
+    uint32_t bytes = 0;
+    for (uint8_t i = 0; i < st.count; i++)
+    {
+        desc_gap_t const* g = &st.gaps[i];
+        if (send_descriptor_range(g->desc_cmd, g->itf, g->offset, g->len))
+        {
+            bytes += g->len;
+        }
+        else
+        {
+            LOGW("[B] DESC_STATUS gap cmd=%u itf=%u off=%u len=%u not served",
+                 g->desc_cmd, g->itf, g->offset, g->len);
+        }
+    }
+    metric_add(&m_desc_resume_bytes, bytes);
+    enum_trace_record(ET_DESC_GAPS_RECV, st.count);
+    LOGI("[B] descriptor session %u: resent %u gap(s), %lu bytes (round %u)",
+         s_desc_session.id, st.count, (unsigned long)bytes, s_desc_session.rounds);
+
+    send_descriptor_done_frame();
+    s_ready_retry_deadline = to_ms_since_boot(get_absolute_time()) + 300;
+    s_ready_retry_count    = 0;
+}
+
+static void handle_ctrl_set_protocol(uint8_t itf, uint8_t protocol)
+{
+    host_itf_state_t* hs = find_slot_by_itf(itf);
+    if (hs)
     {
         hs->protocol = protocol;
     }
@@ -1055,7 +1806,7 @@ static void handle_ctrl_set_protocol(uint8_t itf, uint8_t protocol)
         return;
     }
 
-    if (tuh_hid_set_protocol(hs->dev_addr, itf, protocol))
+    if (tuh_hid_set_protocol(hs->dev_addr, hs->instance, protocol))
     {
         LOGI("[B] SET_PROTOCOL forwarded itf=%u protocol=%u", itf, protocol);
         if (protocol == HID_PROTOCOL_REPORT)
@@ -1115,13 +1866,19 @@ static void handle_ctrl_set_report(uint8_t const* payload, uint16_t len)
         LOGW("[B] SET_REPORT ignored wrong itf=%u", itf);
         return;
     }
+    // Keyboard LEDs follow the target that has the interface.
+    if (fanout_reply_target() != FANOUT_NO_TARGET && fanout_reply_target() != fanout_route(itf))
+    {
+        LOGT("[B] SET_REPORT itf=%u from unfocused target %u dropped", itf, fanout_reply_target());
+        return;
+    }
 
     uint8_t report_type = payload[1];
     uint8_t report_id   = payload[2];
     uint16_t report_len = len - 3;
 
     if (!tuh_hid_set_report(hs->dev_addr,
-                            itf,
+                            hs->instance,
                             report_id,
                             report_type,
                             (void*)(uintptr_t)(payload + 3),
@@ -1167,12 +1924,14 @@ static void handle_ctrl_get_report_request(uint8_t const* payload, uint16_t len)
 
     s_ctrl_get_report.active        = true;
     s_ctrl_get_report.itf           = itf;
+    s_ctrl_get_report.instance      = hs->instance;
+    s_ctrl_get_report.target        = fanout_reply_target();
     s_ctrl_get_report.report_type   = payload[1];
     s_ctrl_get_report.report_id     = payload[2];
     s_ctrl_get_report.requested_len = (uint16_t)payload[3] | ((uint16_t)payload[4] << 8);
 
     if (!tuh_hid_get_report(hs->dev_addr,
-                            itf,
+                            hs->instance,
                             s_ctrl_get_report.report_id,
                             s_ctrl_get_report.report_type,
                             s_ctrl_get_report_buf,
@@ -1203,7 +1962,7 @@ static bool send_set_idle_request(uint8_t itf, uint8_t duration, uint8_t report_
     }
 
     tuh_itf_info_t info;
-    if (!tuh_hid_itf_get_info(hs->dev_addr, itf, &info))
+    if (!tuh_hid_itf_get_info(hs->dev_addr, hs->instance, &info))
     {
         return false;
     }
@@ -1249,7 +2008,7 @@ static void send_get_report_response(uint8_t report_type, uint8_t report_id,
         return;
     }
 
-    int wr = uart_transport_send(buf, (uint16_t)out);
+    int wr = fanout_send(buf, (uint16_t)out);
     if (wr < 0)
     {
         LOGW("[B] UART send GET_REPORT response failed wr=%d out=%d", wr, out);
@@ -1271,18 +2030,15 @@ static void ensure_input_streaming(void)
             if (s_ready_retry_count > 5)
             {
                 LOGW("[B] READY ack timeout exceeded, forcing UNMOUNT/RESET");
-                s_wait_ready_ack = false;
-                s_control_poll_enabled = false;
-                send_unmount_frame();
-                send_device_reset_command(PF_RESET_REASON_REENUMERATE);
-                s_ready_retry_deadline = 0;
+                force_descriptor_reset();
                 return;
             }
 
             LOGW("[B] READY ack timeout, re-sending descriptor DONE (retry %u)",
                  s_ready_retry_count);
             s_ready_retry_deadline = now + 300;
-            send_descriptor_done();
+            // Frame only: send_descriptor_done() would restart the retry count.
+            send_descriptor_done_frame();
             return;
         }
     }
@@ -1298,7 +2054,7 @@ static void ensure_input_streaming(void)
         }
         if (hs->input_pending) continue;
 
-        if (!tuh_hid_receive_report(hs->dev_addr, hs->itf))
+        if (!tuh_hid_receive_report(hs->dev_addr, hs->instance))
         {
             LOGW("[B] tuh_hid_receive_report() failed to start/continue input");
             hs->input_started = false;
@@ -1353,7 +2109,7 @@ static void set_report_protocol_once(host_itf_state_t* hs)
 
     hs->protocol_attempts++;
 
-    if (tuh_hid_set_protocol(hs->dev_addr, hs->itf, HID_PROTOCOL_REPORT))
+    if (tuh_hid_set_protocol(hs->dev_addr, hs->instance, HID_PROTOCOL_REPORT))
     {
         hs->protocol        = HID_PROTOCOL_REPORT;
         hs->protocol_report_set = true;
@@ -1401,6 +2157,147 @@ static void control_irq_handler(uint gpio, uint32_t events)
     }
 }
 
+static void force_descriptor_reset(void)
+{
+    s_wait_ready_ack = false;
+    s_control_poll_enabled = false;
+    send_unmount_frame();
+    send_device_reset_command(PF_RESET_REASON_REENUMERATE);
+    s_ready_retry_deadline = 0;
+}
+
+// One PF_DESC_SEGMENT of the current session, no pacing.
+static bool send_descriptor_segment(uint8_t cmd, uint8_t itf, uint16_t offset, uint16_t total,
+                                    const uint8_t* data, uint16_t len)
+{
+    proto_desc_segment_t seg = {
+        .session  = s_desc_session.id,
+        .desc_cmd = cmd,
+        .itf      = itf,
+        .offset   = offset,
+        .total    = total,
+        .data     = data,
+        .len      = len,
+    };
+    uint8_t buf[PROTO_MAX_FRAME_SIZE];
+    int out = proto_build_desc_segment(&seg, buf, sizeof(buf));
+    if (out <= 0)
+    {
+        LOGW("[B] proto_build_desc_segment failed cmd=%u off=%u len=%u", cmd, offset, len);
+        return false;
+    }
+
+    for (int attempt = 0; attempt < 3; attempt++)
+    {
+        int wr = fanout_send(buf, (uint16_t)out);
+        if (wr >= 0)
+        {
+            enum_trace_record(ET_DESC_CHUNK_SENT, (uint16_t)(((uint16_t)cmd << 8) | (len > 0xFF ? 0xFF : len)));
+            return true;
+        }
+        LOGW("[B] UART send descriptor segment failed cmd=%u off=%u wr=%d attempt=%d",
+             cmd, offset, wr, attempt + 1);
+        sleep_ms(1);
+    }
+    return false;
+}
+
+static const uint8_t* session_desc_source(uint8_t cmd, uint8_t itf, uint16_t* total)
+{
+    switch (cmd)
+    {
+        case PF_DESC_DEVICE:
+            *total = s_desc_session.device_len;
+            return s_desc_session.device;
+        case PF_DESC_CONFIG:
+            *total = s_desc_session.config_len;
+            return s_desc_session.config;
+        case PF_DESC_REPORT:
+            if (itf >= CFG_TUH_HID || !(s_desc_session.report_mask & TU_BIT(itf)))
+            {
+                return NULL;
+            }
+            *total = s_desc_session.report_len[itf];
+            return s_report_desc[itf];
+        default:
+            return NULL;
+    }
+}
+
+// [offset, offset + len) of a descriptor already in the session store, paced
+// like send_descriptor_frames().
+static bool send_descriptor_range(uint8_t cmd, uint8_t itf, uint16_t offset, uint16_t len)
+{
+    uint16_t total = 0;
+    const uint8_t* src = session_desc_source(cmd, itf, &total);
+    if (!src || offset >= total)
+    {
+        return false;
+    }
+    if (len > total - offset)
+    {
+        len = (uint16_t)(total - offset);
+    }
+
+    const uint16_t chunk_max = 48;
+    while (len)
+    {
+        uint16_t chunk = len > chunk_max ? chunk_max : len;
+        if (!send_descriptor_segment(cmd, itf, offset, total, &src[offset], chunk))
+        {
+            return false;
+        }
+        offset = (uint16_t)(offset + chunk);
+        len    = (uint16_t)(len - chunk);
+        if (len)
+        {
+            sleep_ms(2);
+        }
+    }
+    return true;
+}
+
+// Whole DEVICE/CONFIG/REPORT descriptor into the session store, then out.
+static bool send_descriptor_session(uint8_t cmd, const uint8_t* data, uint16_t len)
+{
+    switch (cmd)
+    {
+        case PF_DESC_DEVICE:
+            if (len > sizeof(s_desc_session.device)) len = sizeof(s_desc_session.device);
+            memcpy(s_desc_session.device, data, len);
+            s_desc_session.device_len = len;
+            return send_descriptor_range(cmd, 0, 0, len);
+
+        case PF_DESC_CONFIG:
+            if (len > sizeof(s_desc_session.config)) len = sizeof(s_desc_session.config);
+            memcpy(s_desc_session.config, data, len);
+            s_desc_session.config_len = len;
+            return send_descriptor_range(cmd, 0, 0, len);
+
+        case PF_DESC_REPORT:
+        {
+            // As in the legacy frames, the first byte is the interface.
+            if (len < 2 || data[0] >= CFG_TUH_HID)
+            {
+                LOGW("[B] PF_DESC_REPORT len=%u itf=%u not sent", len, len ? data[0] : 0);
+                return false;
+            }
+            uint8_t itf = data[0];
+            uint16_t rlen = (uint16_t)(len - 1);
+            if (rlen > REPORT_DESC_MAX) rlen = REPORT_DESC_MAX;
+            memcpy(s_report_desc[itf], &data[1], rlen);
+            s_desc_session.report_len[itf] = rlen;
+            s_desc_session.report_mask |= (uint8_t)TU_BIT(itf);
+            LOGI("[B] sending report descriptor itf=%u total_len=%u (session %u)",
+                 itf, rlen, s_desc_session.id);
+            return send_descriptor_range(cmd, itf, 0, rlen);
+        }
+
+        default:
+            return false;
+    }
+}
+
 static bool send_descriptor_frames(uint8_t cmd, const uint8_t* data, uint16_t len)
 {
     // Для рядків надсилаємо одним кадром (якщо влазить), щоб не обрізати payload.
@@ -1420,15 +2317,21 @@ static bool send_descriptor_frames(uint8_t cmd, const uint8_t* data, uint16_t le
             return false;
         }
 
-        int wr = uart_transport_send(buf, (uint16_t)out);
+        int wr = fanout_send(buf, (uint16_t)out);
         if (wr < 0)
         {
             LOGW("[B] UART send descriptor failed cmd=%u wr=%d out=%d", cmd, wr, out);
             return false;
         }
+        enum_trace_record(ET_DESC_CHUNK_SENT, (uint16_t)(((uint16_t)cmd << 8) | (len > 0xFF ? 0xFF : len)));
         return true;
     }
 
+    if (PROXY_DESC_RESUME && s_desc_session.id && data)
+    {
+        return send_descriptor_session(cmd, data, len);
+    }
+
     if (cmd == PF_DESC_REPORT)
     {
         LOGI("[B] sending report descriptor itf=%u total_len=%u", data ? data[0] : 0, len);
@@ -1485,7 +2388,7 @@ static bool send_descriptor_frames(uint8_t cmd, const uint8_t* data, uint16_t le
         bool sent = false;
         for (int attempt = 0; attempt < 3 && !sent; attempt++)
         {
-        int wr = uart_transport_send(buf, (uint16_t)out);
+        int wr = fanout_send(buf, (uint16_t)out);
         if (wr < 0)
         {
             LOGW("[B] UART send descriptor failed cmd=%u wr=%d out=%d attempt=%d",
@@ -1499,6 +2402,7 @@ static bool send_descriptor_frames(uint8_t cmd, const uint8_t* data, uint16_t le
                 LOGI("[B] sent report chunk itf=%u off=%u size=%u payload_len=%u",
                      itf_id, offset, chunk, payload_len);
             }
+            enum_trace_record(ET_DESC_CHUNK_SENT, (uint16_t)(((uint16_t)cmd << 8) | payload_len));
             sent = true;
         }
     }
@@ -1511,10 +2415,68 @@ static bool send_descriptor_frames(uint8_t cmd, const uint8_t* data, uint16_t le
     return true;
 }
 
-static bool send_descriptor_done(void)
+// Single PF_DESCRIPTOR frame, no inter-frame sleep; `data` must fit one payload.
+// `offset`/`total` place it inside the descriptor for session segments.
+static bool send_descriptor_chunk(uint8_t cmd, uint16_t offset, uint16_t total,
+                                  const uint8_t* data, uint16_t len)
+{
+    if (PROXY_DESC_RESUME && s_desc_session.id && cmd == PF_DESC_CONFIG)
+    {
+        if (total > sizeof(s_desc_session.config)) total = sizeof(s_desc_session.config);
+        if (offset >= total)
+        {
+            return false;
+        }
+        if (len > total - offset) len = (uint16_t)(total - offset);
+        memcpy(&s_desc_session.config[offset], data, len);
+        s_desc_session.config_len = total;
+        return send_descriptor_segment(cmd, 0, offset, total, data, len);
+    }
+
+    uint8_t buf[PROTO_MAX_FRAME_SIZE];
+    int out = proto_build_descriptor(cmd, data, len, buf, sizeof(buf));
+    if (out <= 0)
+    {
+        LOGW("[B] proto_build_descriptor failed cmd=%u chunk=%u", cmd, len);
+        return false;
+    }
+
+    for (int attempt = 0; attempt < 3; attempt++)
+    {
+        int wr = fanout_send(buf, (uint16_t)out);
+        if (wr >= 0)
+        {
+            enum_trace_record(ET_DESC_CHUNK_SENT, (uint16_t)(((uint16_t)cmd << 8) | (len > 0xFF ? 0xFF : len)));
+            return true;
+        }
+        LOGW("[B] UART send descriptor failed cmd=%u wr=%d out=%d attempt=%d",
+             cmd, wr, out, attempt + 1);
+    }
+    return false;
+}
+
+// PF_DESC_DONE only; a session set carries its manifest.
+static bool send_descriptor_done_frame(void)
 {
+    uint8_t manifest[PROTO_DESC_MANIFEST_HDR + DESC_SESSION_MAX_REPORTS * PROTO_DESC_MANIFEST_ENTRY];
+    uint16_t mlen = 0;
+    if (s_desc_session.id)
+    {
+        desc_manifest_t m = {
+            .session      = s_desc_session.id,
+            .device_total = s_desc_session.device_len,
+            .config_total = s_desc_session.config_len,
+            .report_mask  = s_desc_session.report_mask,
+        };
+        for (uint8_t i = 0; i < CFG_TUH_HID && i < DESC_SESSION_MAX_REPORTS; i++)
+        {
+            m.report_total[i] = s_desc_session.report_len[i];
+        }
+        mlen = desc_session_build_manifest(&m, manifest, sizeof(manifest));
+    }
+
     uint8_t buf[PROTO_MAX_FRAME_SIZE];
-    int out = proto_build_descriptor(PF_DESC_DONE, NULL, 0, buf, sizeof(buf));
+    int out = proto_build_descriptor(PF_DESC_DONE, mlen ? manifest : NULL, mlen, buf, sizeof(buf));
     if (out <= 0)
     {
         LOGW("[B] proto_build_descriptor DONE failed");
@@ -1524,7 +2486,7 @@ static bool send_descriptor_done(void)
     bool sent = false;
     for (int attempt = 0; attempt < 3 && !sent; attempt++)
     {
-        int wr = uart_transport_send(buf, (uint16_t)out);
+        int wr = fanout_send(buf, (uint16_t)out);
         if (wr < 0)
         {
             LOGW("[B] UART send descriptor DONE failed wr=%d out=%d attempt=%d",
@@ -1538,6 +2500,14 @@ static bool send_descriptor_done(void)
     }
     if (!sent) return false;
 
+    enum_trace_record(ET_DESC_DONE_SENT, 0);
+    return true;
+}
+
+static bool send_descriptor_done(void)
+{
+    if (!send_descriptor_done_frame()) return false;
+
     s_wait_ready_ack = true;
     s_ready_retry_deadline = to_ms_since_boot(get_absolute_time()) + 300; // 300ms до повтору
     s_ready_retry_count    = 0;
@@ -1555,13 +2525,65 @@ static bool send_descriptor_done(void)
     return true;
 }
 
+// The hub composite as one descriptor set: primary's device descriptor, the
+// synthesized config, then every composite interface's report descriptor.
+static bool send_composite_set(bool reset)
+{
+    if (!hub_aggregate_packed())
+    {
+        hub_aggregate_set_packed(true);
+        hub_renumber_slots();
+    }
+
+    uint8_t  device[sizeof(tusb_desc_device_t)];
+    uint16_t cfg_len = hub_aggregate_build_config(s_hub_cfg, sizeof(s_hub_cfg));
+    if (!cfg_len || !hub_aggregate_build_device(device, sizeof(device)))
+    {
+        LOGW("[B] hub: composite descriptor set not built");
+        return false;
+    }
+
+    if (reset)
+    {
+        force_descriptor_reset();
+    }
+    hid_proxy_host_desc_session_begin();
+    LOGI("[B] hub: composite of %u device(s), %u interface(s), config %u bytes",
+         hub_aggregate_count(), s_hub_cfg[4], cfg_len);
+
+    bool ok = send_descriptor_frames(PF_DESC_DEVICE, device, sizeof(device)) &&
+              send_descriptor_frames(PF_DESC_CONFIG, s_hub_cfg, cfg_len);
+    for (uint8_t itf = 0; ok && itf < CFG_TUH_HID; itf++)
+    {
+        uint16_t len = s_report_desc_len[itf];
+        if (!len || !find_slot_by_itf(itf))
+        {
+            continue;
+        }
+        if (len > REPORT_DESC_MAX)
+        {
+            LOGW("[B] hub: report descriptor itf=%u truncated to %u bytes", itf, REPORT_DESC_MAX);
+            len = REPORT_DESC_MAX;
+        }
+        s_hub_report[0] = itf;
+        memcpy(&s_hub_report[1], s_report_desc[itf], len);
+        ok = send_descriptor_frames(PF_DESC_REPORT, s_hub_report, (uint16_t)(len + 1));
+    }
+    ok = ok && send_descriptor_done();
+    if (!ok)
+    {
+        LOGW("[B] hub: composite descriptor set not sent");
+    }
+    return ok;
+}
+
 static void send_unmount_frame(void)
 {
     uint8_t buf[PROTO_MAX_FRAME_SIZE];
     int out = proto_build_unmount(buf, sizeof(buf));
     if (out > 0)
     {
-        int wr = uart_transport_send(buf, (uint16_t)out);
+        int wr = fanout_send(buf, (uint16_t)out);
         if (wr < 0)
         {
             LOGW("[B] UART send UNMOUNT failed wr=%d out=%d", wr, out);
@@ -1579,6 +2601,7 @@ static void send_unmount_frame(void)
 
 bool hid_proxy_host_request_device_reset(uint8_t reason)
 {
+    fanout_desc_scope_all();
     return send_device_reset_command(reason);
 }
 
@@ -1594,6 +2617,7 @@ size_t hid_proxy_host_list_interfaces(hid_proxy_itf_info_t* out, size_t max_entr
 
         out[written].dev_addr    = s_itf[i].dev_addr;
         out[written].itf         = s_itf[i].itf;
+        out[written].itf_num     = s_itf[i].itf_num;
         out[written].itf_protocol= s_itf[i].itf_protocol;
         out[written].protocol    = s_itf[i].protocol;
         out[written].inferred_type = s_itf[i].inferred_type;
@@ -1618,13 +2642,8 @@ static host_itf_state_t* find_first_protocol(uint8_t itf_protocol)
     return NULL;
 }
 
-bool hid_proxy_host_inject_report(uint8_t itf_sel, uint8_t const* report, uint16_t len)
+static host_itf_state_t* resolve_inject_target(uint8_t itf_sel)
 {
-    if (!report || len == 0)
-    {
-        return false;
-    }
-
     host_itf_state_t* hs = NULL;
     if (itf_sel == 0xFF)
     {
@@ -1641,15 +2660,19 @@ bool hid_proxy_host_inject_report(uint8_t itf_sel, uint8_t const* report, uint16
 
     if (!hs || !hs->active || !hs->mounted)
     {
-        return false;
+        return NULL;
     }
 
     if (hs->input_paused || s_wait_ready_ack || !hs->input_ready)
     {
         hs->input_skipped_not_ready++;
-        return false;
+        return NULL;
     }
+    return hs;
+}
 
+static bool send_input_frame(host_itf_state_t* hs, uint8_t const* report, uint16_t len)
+{
     uint8_t buf[PROTO_MAX_FRAME_SIZE];
     uint32_t now_ms = board_millis();
     int out = proto_build_input(hs->itf, now_ms, hs->input_seq++, report, len, buf, sizeof(buf));
@@ -1658,14 +2681,170 @@ bool hid_proxy_host_inject_report(uint8_t itf_sel, uint8_t const* report, uint16
         return false;
     }
 
-    int wr = uart_transport_send(buf, (uint16_t)out);
+    int wr = fanout_send(buf, (uint16_t)out);
+    return wr >= 0;
+}
+
+static bool send_injected_input(host_itf_state_t* hs, uint8_t const* report, uint16_t len)
+{
+    // Recorded as given, before mixing: a replay reproduces the controller's input.
+    if (!input_mixer_take_injected(hs->itf, report, len) && !send_input_frame(hs, report, len))
+    {
+        metric_inc(&m_inject_failed);
+        return false;
+    }
+    metric_inc(&m_inject_sent);
+    replay_record(REPLAY_SRC_INJECTED, hs->itf, time_us_32(), report, len);
+    return true;
+}
+
+bool hid_proxy_host_send_input(uint8_t itf, uint8_t const* report, uint16_t len)
+{
+    if (!report || len == 0)
+    {
+        return false;
+    }
+
+    host_itf_state_t* hs = resolve_inject_target(itf);
+    if (!hs)
+    {
+        return false;
+    }
+    return send_input_frame(hs, report, len);
+}
+
+int hid_proxy_host_send_input_isr(uint8_t itf, uint8_t const* report, uint16_t len)
+{
+    // Alarm IRQ context: only reads interface state, never logs, and keeps
+    // its own frame buffer and sequence so the main loop's stay untouched.
+    // Callers are timer IRQs of equal priority, so they never nest.
+    static uint8_t  s_isr_frame[PROTO_MAX_FRAME_SIZE];
+    static uint16_t s_isr_seq = 0;
+
+    host_itf_state_t* hs = find_slot_by_itf(itf);
+    if (!hs || !hs->mounted || hs->input_paused || s_wait_ready_ack || !hs->input_ready)
+    {
+        return -1;
+    }
+
+    // The mixer and the recorder live in the main loop; a report written here
+    // would overwrite the merged one and miss the recording.
+    if (input_mixer_active(itf) || replay_recording(REPLAY_SRC_INJECTED))
+    {
+        uint8_t tail = s_timed_tail;
+        if (len > INJECT_REPORT_MAX || (uint8_t)(tail - s_timed_head) >= PROXY_TIMED_HANDOFF_DEPTH)
+        {
+            return -1;
+        }
+        timed_handoff_t* e = &s_timed_q[tail & (PROXY_TIMED_HANDOFF_DEPTH - 1u)];
+        e->itf = itf;
+        e->len = (uint8_t)len;
+        memcpy(e->report, report, len);
+        s_timed_tail = (uint8_t)(tail + 1u);
+        return 0;
+    }
+
+    int out = proto_build_input(hs->itf, board_millis(), s_isr_seq, report, len,
+                                s_isr_frame, sizeof(s_isr_frame));
+    if (out <= 0)
+    {
+        return -1;
+    }
+
+    int wr = fanout_send_from_isr(s_isr_frame, (uint16_t)out);
+    if (wr == UART_TRANSPORT_BUSY)
+    {
+        return wr;
+    }
     if (wr < 0)
+    {
+        return -1;
+    }
+    s_isr_seq++;
+    metric_inc(&m_timed_sent);
+    return 0;
+}
+
+int hid_proxy_host_resolve_inject_itf(uint8_t itf_sel)
+{
+    host_itf_state_t* hs = resolve_inject_target(itf_sel);
+    return hs ? (int)hs->itf : -1;
+}
+
+bool hid_proxy_host_inject_report(uint8_t itf_sel, uint8_t const* report, uint16_t len)
+{
+    if (!report || len == 0)
     {
         return false;
     }
+
+    host_itf_state_t* hs = resolve_inject_target(itf_sel);
+    if (!hs)
+    {
+        return false;
+    }
+    return send_injected_input(hs, report, len);
+}
+
+bool hid_proxy_host_inject_report_after(uint8_t itf_sel, uint8_t const* report, uint16_t len,
+                                        uint32_t delay_us)
+{
+    if (!report || len == 0)
+    {
+        return false;
+    }
+
+    // The target is resolved (and 0xFF/0xFE pinned) when the report is accepted.
+    host_itf_state_t* hs = resolve_inject_target(itf_sel);
+    if (!hs)
+    {
+        return false;
+    }
+
+    // A report still waiting (in the heap or the timed hand-off) keeps the
+    // chain going, so nothing sent now overtakes it.
+    uint32_t now = time_us_32();
+    bool chained = inject_sched_pending(INJECT_SCHED_TAG_BATCH) != 0;
+    if (!chained && s_timed_head == s_timed_tail && delay_us == 0)
+    {
+        s_batch_tail_due_us = now;
+        return send_injected_input(hs, report, len);
+    }
+
+    // Spacing is relative to the previous queued report, or to now when idle.
+    uint32_t due = (chained ? s_batch_tail_due_us : now) + delay_us;
+    if (inject_sched_add(due, INJECT_SCHED_TAG_BATCH, hs->itf, report, len) != INJECT_SCHED_OK)
+    {
+        return false;
+    }
+    s_batch_tail_due_us = due;
     return true;
 }
 
+void hid_proxy_host_inject_queue_state(uint8_t* pending, uint32_t* dropped)
+{
+    inject_sched_stats_t st;
+    inject_sched_get_stats(&st, false);
+    if (pending) *pending = inject_sched_pending(INJECT_SCHED_TAG_BATCH);
+    if (dropped) *dropped = st.failed;
+}
+
+static void timed_handoff_task(void)
+{
+    while (s_timed_head != s_timed_tail)
+    {
+        timed_handoff_t* e = &s_timed_q[s_timed_head & (PROXY_TIMED_HANDOFF_DEPTH - 1u)];
+        // Failures land in host.inject.failed; the timed sender already
+        // counted the report as sent at its deadline.
+        host_itf_state_t* hs = resolve_inject_target(e->itf);
+        if (hs)
+        {
+            (void)send_injected_input(hs, e->report, e->len);
+        }
+        s_timed_head = (uint8_t)(s_timed_head + 1u);
+    }
+}
+
 static bool send_device_reset_command(uint8_t reason)
 {
     uint8_t buf[PROTO_MAX_FRAME_SIZE];
@@ -1675,7 +2854,7 @@ static bool send_device_reset_command(uint8_t reason)
         return false;
     }
 
-    int wr = uart_transport_send(buf, (uint16_t)out);
+    int wr = fanout_send(buf, (uint16_t)out);
     if (wr < 0)
     {
         LOGW("[B] UART send DEVICE_RESET failed wr=%d out=%d", wr, out);
@@ -1685,3 +2864,243 @@ static bool send_device_reset_command(uint8_t reason)
     LOGI("[B] DEVICE_RESET command sent reason=%u", reason);
     return true;
 }
+
+bool hid_proxy_host_trace_pull(void)
+{
+    uint32_t now = time_us_32();
+    uint8_t buf[PROTO_MAX_FRAME_SIZE];
+    int out = proto_build_ctrl_trace_req(now, buf, sizeof(buf));
+    if (out <= 0)
+    {
+        return false;
+    }
+
+    int wr = fanout_send(buf, (uint16_t)out);
+    if (wr < 0)
+    {
+        LOGW("[B] UART send TRACE_REQ failed wr=%d out=%d", wr, out);
+        return false;
+    }
+
+    s_trace_pull_t0_us   = now;
+    s_trace_pull_pending = true;
+    return true;
+}
+
+bool hid_proxy_host_trace_pending(void)
+{
+    if (s_trace_pull_pending &&
+        (time_us_32() - s_trace_pull_t0_us) > TRACE_PULL_TIMEOUT_US)
+    {
+        LOGW("[B] trace pull timed out, A_device events may be stale");
+        s_trace_pull_pending = false;
+    }
+    return s_trace_pull_pending;
+}
+
+int32_t hid_proxy_host_trace_offset_us(void)
+{
+    return s_trace_offset_us;
+}
+
+static void handle_ctrl_trace_data(uint8_t const* payload, uint16_t len)
+{
+    uint32_t now = time_us_32();
+    if (len < PROTO_TRACE_DATA_HDR)
+    {
+        LOGW("[B] TRACE_DATA frame too short");
+        return;
+    }
+
+    uint32_t host_us = (uint32_t)payload[0] | ((uint32_t)payload[1] << 8) |
+                       ((uint32_t)payload[2] << 16) | ((uint32_t)payload[3] << 24);
+    uint32_t dev_us  = (uint32_t)payload[4] | ((uint32_t)payload[5] << 8) |
+                       ((uint32_t)payload[6] << 16) | ((uint32_t)payload[7] << 24);
+    uint8_t total = payload[8];
+    uint8_t start = payload[9];
+    uint8_t count = payload[10];
+
+    if (!s_trace_pull_pending || host_us != s_trace_pull_t0_us)
+    {
+        LOGW("[B] stale TRACE_DATA page start=%u ignored", start);
+        return;
+    }
+    if ((uint16_t)(PROTO_TRACE_DATA_HDR + (uint16_t)count * ENUM_TRACE_WIRE_SIZE) > len)
+    {
+        LOGW("[B] TRACE_DATA page truncated count=%u len=%u", count, len);
+        s_trace_pull_pending = false;
+        return;
+    }
+
+    if (start == 0)
+    {
+        // Offset from the first page only: later pages queue behind it, so
+        // their round trip overstates the link delay. Assumes a symmetric path.
+        uint32_t rtt = now - host_us;
+        s_trace_offset_us = (int32_t)(dev_us - (host_us + rtt / 2u));
+        enum_trace_remote_reset();
+        LOGI("[B] trace pull rtt=%lu us offset=%ld us entries=%u",
+             (unsigned long)rtt, (long)s_trace_offset_us, total);
+    }
+
+    enum_trace_remote_ingest(s_trace_offset_us, &payload[PROTO_TRACE_DATA_HDR], count);
+    if ((uint16_t)(start + count) >= total)
+    {
+        s_trace_pull_pending = false;
+    }
+}
+
+size_t hid_proxy_host_itf_telemetry(hid_proxy_itf_telemetry_t* out, size_t max_entries, bool reset_window)
+{
+    if (!out || max_entries == 0) return 0;
+
+    size_t n = 0;
+    for (size_t i = 0; i < TU_ARRAY_SIZE(s_itf) && n < max_entries; i++)
+    {
+        host_itf_state_t* hs = &s_itf[i];
+        if (!hs->active) continue;
+
+        hid_proxy_itf_telemetry_t* t = &out[n++];
+        t->itf                     = hs->itf;
+        t->mounted                 = hs->mounted ? 1 : 0;
+        t->input_ready             = hs->input_ready ? 1 : 0;
+        t->input_count             = hs->input_count;
+        t->input_skipped_not_ready = hs->input_skipped_not_ready;
+        t->send_max_us             = hs->tm_send_max_us;
+        memcpy(t->send_hist, hs->tm_send_hist, sizeof(t->send_hist));
+        if (reset_window)
+        {
+            memset(hs->tm_send_hist, 0, sizeof(hs->tm_send_hist));
+            hs->tm_send_max_us = 0;
+        }
+    }
+    return n;
+}
+
+bool hid_proxy_host_dev_stats_pull(void)
+{
+    uint8_t buf[PROTO_MAX_FRAME_SIZE];
+    int out = proto_build_ctrl_stats_req(buf, sizeof(buf));
+    if (out <= 0)
+    {
+        return false;
+    }
+
+    int wr = fanout_send(buf, (uint16_t)out);
+    if (wr < 0)
+    {
+        LOGW("[B] UART send STATS_REQ failed wr=%d out=%d", wr, out);
+        return false;
+    }
+    return true;
+}
+
+bool hid_proxy_host_dev_stats(proto_dev_stats_t* out, uint32_t* age_ms)
+{
+    if (!s_dev_stats_valid) return false;
+    if (out) *out = s_dev_stats;
+    if (age_ms) *age_ms = board_millis() - s_dev_stats_rx_ms;
+    return true;
+}
+
+static void handle_ctrl_stats_data(uint8_t const* payload, uint16_t len)
+{
+    if (!proto_parse_ctrl_stats_data(payload, len, &s_dev_stats))
+    {
+        LOGW("[B] STATS_DATA frame too short len=%u", len);
+        return;
+    }
+    s_dev_stats_valid = true;
+    s_dev_stats_rx_ms = board_millis();
+}
+
+bool hid_proxy_host_dev_metrics_pull(void)
+{
+    uint8_t buf[PROTO_MAX_FRAME_SIZE];
+    int out = proto_build_ctrl_metrics_req(buf, sizeof(buf));
+    if (out <= 0)
+    {
+        return false;
+    }
+
+    int wr = fanout_send(buf, (uint16_t)out);
+    if (wr < 0)
+    {
+        LOGW("[B] UART send METRICS_REQ failed wr=%d out=%d", wr, out);
+        return false;
+    }
+    return true;
+}
+
+uint16_t hid_proxy_host_dev_metrics(uint8_t start, uint8_t* out, uint16_t max,
+                                    uint8_t* count, uint8_t* total, uint32_t* age_ms)
+{
+    if (count) *count = 0;
+    if (total) *total = s_dev_metrics_valid ? s_dev_metrics.count : 0;
+    if (age_ms) *age_ms = s_dev_metrics_valid ? board_millis() - s_dev_metrics_rx_ms : UINT32_MAX;
+    if (!s_dev_metrics_valid || !out) return 0;
+
+    uint16_t at = 0;
+    uint16_t used = 0;
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < s_dev_metrics.count; i++)
+    {
+        uint16_t sz = metrics_entry_size(&s_dev_metrics.data[at], (uint16_t)(s_dev_metrics.len - at));
+        if (!sz) break;
+        if (i >= start)
+        {
+            if ((uint16_t)(used + sz) > max) break;
+            memcpy(&out[used], &s_dev_metrics.data[at], sz);
+            used = (uint16_t)(used + sz);
+            n++;
+        }
+        at = (uint16_t)(at + sz);
+    }
+    if (count) *count = n;
+    return used;
+}
+
+static void handle_ctrl_metrics_data(uint8_t const* payload, uint16_t len)
+{
+    if (len < PROTO_METRICS_DATA_HDR)
+    {
+        LOGW("[B] METRICS_DATA frame too short len=%u", len);
+        return;
+    }
+    uint8_t total = payload[4];
+    uint8_t start = payload[5];
+    uint8_t count = payload[6];
+    uint8_t const* entries = &payload[PROTO_METRICS_DATA_HDR];
+    uint16_t entries_len = (uint16_t)(len - PROTO_METRICS_DATA_HDR);
+
+    if (start == 0)
+    {
+        s_dev_metrics_stage.len   = 0;
+        s_dev_metrics_stage.count = 0;
+        s_dev_metrics_next        = 0;
+    }
+    if (start != s_dev_metrics_next)
+    {
+        LOGW("[B] stale METRICS_DATA page start=%u ignored", start);
+        return;
+    }
+    s_dev_metrics_next = (uint8_t)(start + count);
+
+    if ((uint32_t)s_dev_metrics_stage.len + entries_len <= sizeof(s_dev_metrics_stage.data))
+    {
+        memcpy(&s_dev_metrics_stage.data[s_dev_metrics_stage.len], entries, entries_len);
+        s_dev_metrics_stage.len   = (uint16_t)(s_dev_metrics_stage.len + entries_len);
+        s_dev_metrics_stage.count = (uint8_t)(s_dev_metrics_stage.count + count);
+    }
+    else
+    {
+        LOGW("[B] METRICS_DATA page start=%u past PROXY_DEV_METRICS_BYTES, dropped", start);
+    }
+
+    if (count == 0 || s_dev_metrics_next >= total)
+    {
+        s_dev_metrics       = s_dev_metrics_stage;
+        s_dev_metrics_valid = true;
+        s_dev_metrics_rx_ms = board_millis();
+    }
+}
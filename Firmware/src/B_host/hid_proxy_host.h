@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include "hid_host.h"
+#include "proto_frame.h"
 
 void hid_proxy_host_init(void);
 
@@ -23,7 +24,8 @@ bool hid_proxy_host_request_device_reset(uint8_t reason);
 typedef struct
 {
     uint8_t dev_addr;
-    uint8_t itf;
+    uint8_t itf;          // composite index (what A_device presents)
+    uint8_t itf_num;      // bInterfaceNumber on the physical device `dev_addr`
     uint8_t itf_protocol; // HID ITF protocol (keyboard/mouse/other)
     uint8_t protocol;     // HID protocol (boot/report)
     uint8_t inferred_type; // bit0=keyboard, bit1=mouse (from report descriptor)
@@ -51,6 +53,14 @@ typedef struct
     uint8_t wheel_signed;
     uint8_t kb_report_len;
     uint8_t kb_has_report_id;
+    // Keyboard fields (not part of GET_REPORT_LAYOUT); bit offsets exclude the report ID.
+    uint8_t kb_has_mods;
+    uint16_t kb_mods_offset_bits;
+    uint16_t kb_keys_offset_bits;
+    uint8_t kb_keys_count;      // 0 = no key field
+    uint8_t kb_keys_size_bits;
+    uint8_t kb_keys_bitmap;     // 1 = one bit per usage (NKRO), 0 = array of usages
+    uint8_t kb_keys_usage_min;
 } hid_report_layout_t;
 
 // Snapshot of active HID interfaces (B_host side).
@@ -60,8 +70,13 @@ size_t hid_proxy_host_list_interfaces(hid_proxy_itf_info_t* out, size_t max_entr
 // Update inferred HID type (keyboard/mouse) from a report descriptor for interface `itf`.
 void hid_proxy_host_update_inferred_type(uint8_t itf, uint8_t const* desc, uint16_t len);
 void hid_proxy_host_store_report_desc(uint8_t itf, uint8_t const* desc, uint16_t len);
+// Starts a resumable descriptor session (PROXY_DESC_RESUME) for the set the
+// descriptor logger is about to forward.
+void hid_proxy_host_desc_session_begin(void);
 uint16_t hid_proxy_host_get_report_desc(uint8_t itf, uint8_t* out, uint16_t max_len, bool* truncated);
 bool hid_proxy_host_get_report_layout(uint8_t itf, uint8_t report_id, hid_report_layout_t* out);
+// Auto-selects the report that carries keys even when the interface also has a pointer.
+bool hid_proxy_host_get_keyboard_layout(uint8_t itf, hid_report_layout_t* out);
 
 // Inject an input report into the bridge (B_host -> A_device), using the same PF_INPUT format
 // as physical HID reports. `itf_sel` can be a concrete interface index (0..CFG_TUH_HID-1),
@@ -70,11 +85,89 @@ bool hid_proxy_host_get_report_layout(uint8_t itf, uint8_t report_id, hid_report
 //   0xFE = first mounted keyboard interface
 bool hid_proxy_host_inject_report(uint8_t itf_sel, uint8_t const* report, uint16_t len);
 
+// Same, but sent `delay_us` after the previously queued report (after now when
+// none is queued). With nothing queued and delay 0 the report goes to the link
+// immediately; otherwise it waits in the inject_sched heap and leaves on the
+// SCHEDULE path. Readiness is checked on accept and again when due; reports
+// that can no longer be sent are counted as dropped (inject_sched `failed`).
+bool hid_proxy_host_inject_report_after(uint8_t itf_sel, uint8_t const* report, uint16_t len,
+                                        uint32_t delay_us);
+void hid_proxy_host_inject_queue_state(uint8_t* pending, uint32_t* dropped);
+
+// Sends a finished report for interface `itf` past the input mixer (the
+// mixer's own output path); not recorded by REPLAY.
+bool hid_proxy_host_send_input(uint8_t itf, uint8_t const* report, uint16_t len);
+
+// Resolves an inject selector (0xFF/0xFE or a number) to a concrete, ready
+// interface number; -1 when none is ready. Lets timed senders pin the target.
+int hid_proxy_host_resolve_inject_itf(uint8_t itf_sel);
+
+// Timed send path (REPLAY, scheduled injection), safe to call from a timer
+// alarm IRQ: builds the input frame for interface `itf` and writes it straight
+// to the link. When the interface mixes (MIX) or injected input is being
+// recorded, the report is handed to the main loop instead, which sends it as
+// injected input on its next pass. Returns 0 when sent or handed off,
+// UART_TRANSPORT_BUSY when the main loop is mid-frame on the link (retry
+// later), -1 when the interface is missing or not ready, or the hand-off queue
+// is full.
+int hid_proxy_host_send_input_isr(uint8_t itf, uint8_t const* report, uint16_t len);
+
 // Utility: get dev_addr of first active HID (0 if none)
 uint8_t hid_proxy_host_first_dev_addr(void);
 
 // Ensure tracking slot exists for a given dev/itf (used when TinyUSB host
 // callbacks не приходять для всіх HID інтерфейсів, але контролі вже йдуть).
 void hid_proxy_host_ensure_slot(uint8_t dev_addr, uint8_t itf);
+// Composite interface (PF_INPUT itf_id) of interface `itf_num` of `dev_addr`;
+// `itf_num` itself without hub aggregation, 0xFF when it has none.
+uint8_t hid_proxy_host_composite_itf(uint8_t dev_addr, uint8_t itf_num);
+
+// Fan-out (PROXY_FANOUT_TARGETS > 1). Moving the focus first sends
+// all-released reports (input_state_release_all) to the old target, which
+// also drops keys and buttons held through KEY. Resync sends the descriptor
+// set to one target only, e.g. an A_device powered up after B_host.
+bool hid_proxy_host_set_focus(uint8_t target);
+bool hid_proxy_host_fanout_resync(uint8_t target);
+
+// Enumeration trace: ask A_device for its trace ring (PF_CTRL_TRACE_REQ).
+// The reply is merged into enum_trace's remote ring by the control frame loop.
+bool hid_proxy_host_trace_pull(void);
+bool hid_proxy_host_trace_pending(void);
+// A_device clock minus B_host clock, measured on the last completed pull.
+int32_t hid_proxy_host_trace_offset_us(void);
+
+// Per-interface telemetry (control UART SUBSCRIBE). The send-time histogram
+// covers uart_transport_send() per forwarded report: bucket 0 is below
+// HID_PROXY_SEND_HIST_BASE_US, each next bucket doubles the edge, the last
+// one is open-ended. Buckets saturate at 0xFFFF.
+#define HID_PROXY_SEND_HIST_BUCKETS 8u
+#define HID_PROXY_SEND_HIST_BASE_US 8u
+
+typedef struct
+{
+    uint8_t  itf;
+    uint8_t  mounted;
+    uint8_t  input_ready;
+    uint32_t input_count;
+    uint32_t input_skipped_not_ready;
+    uint32_t send_max_us;  // histogram window only
+    uint16_t send_hist[HID_PROXY_SEND_HIST_BUCKETS];
+} hid_proxy_itf_telemetry_t;
+
+// Snapshot of active interfaces; `reset_window` starts a new histogram window.
+size_t hid_proxy_host_itf_telemetry(hid_proxy_itf_telemetry_t* out, size_t max_entries, bool reset_window);
+
+// A_device counters: pull sends PF_CTRL_STATS_REQ, the reply is cached by the
+// control frame loop. Returns false until the first snapshot has arrived.
+bool hid_proxy_host_dev_stats_pull(void);
+bool hid_proxy_host_dev_stats(proto_dev_stats_t* out, uint32_t* age_ms);
+
+// A_device metrics registry: pull sends PF_CTRL_METRICS_REQ, the pages are
+// cached by the control frame loop. The getter copies cached metrics from
+// index `start` in metrics_encode() form while they fit in `max`; `age_ms`
+// is UINT32_MAX until the first complete snapshot.
+bool     hid_proxy_host_dev_metrics_pull(void);
+uint16_t hid_proxy_host_dev_metrics(uint8_t start, uint8_t* out, uint16_t max,
+                                    uint8_t* count, uint8_t* total, uint32_t* age_ms);
 
 #endif // HID_PROXY_HOST_H
@@ -0,0 +1,371 @@
+#include "hub_aggregate.h"
+
+#include <string.h>
+
+#include "proxy_config.h"
+
+#if PROXY_HUB_MAX_ITFS > 15u
+#error "PROXY_HUB_MAX_ITFS must be <= 15 (one endpoint number per interface)"
+#endif
+
+#define HUB_DESC_CONFIGURATION 0x02u
+#define HUB_DESC_INTERFACE     0x04u
+#define HUB_DESC_ENDPOINT      0x05u
+#define HUB_DESC_IAD           0x0Bu
+#define HUB_CLASS_HID          0x03u
+#define HUB_DEVICE_DESC_LEN    18u
+#define HUB_CONFIG_DESC_LEN    9u
+#define HUB_ATTR_REMOTE_WAKEUP 0x20u
+#define HUB_MAX_POWER_UNITS    250u   // 500 mA in 2 mA units
+
+typedef struct
+{
+    uint8_t  dev_addr;
+    uint8_t  itf_count;
+    uint8_t  itf_nums[PROXY_HUB_MAX_ITFS];  // HID bInterfaceNumbers, ascending
+    bool     stored;
+    uint8_t  attributes;
+    uint8_t  max_power;
+    uint8_t  device[HUB_DEVICE_DESC_LEN];
+    uint16_t hid_len;
+    uint8_t  hid[PROXY_HUB_DEV_CFG_MAX];
+} hub_dev_t;
+
+// Mount order, packed at the front; s_devs[0] is the primary.
+static hub_dev_t s_devs[PROXY_HUB_MAX_DEVICES];
+static uint8_t   s_count;
+static bool      s_packed;   // composite presented: every device numbered by rank
+
+static hub_dev_t* find_dev(uint8_t dev_addr)
+{
+    for (uint8_t i = 0; i < s_count; i++)
+    {
+        if (s_devs[i].dev_addr == dev_addr)
+        {
+            return &s_devs[i];
+        }
+    }
+    return NULL;
+}
+
+// Until the composite is presented the primary keeps its own interface
+// numbers, so a lone device is presented with the config it sent. Every other
+// device, and the primary too once packed, is numbered by rank among its HID
+// interfaces: the composite's interfaces run 0..bNumInterfaces-1 (USB 2.0
+// 9.6.5) whatever non-HID interfaces the devices have.
+static bool keeps_own_numbers(hub_dev_t const* d)
+{
+    return d == &s_devs[0] && !s_packed;
+}
+
+static int16_t local_offset(hub_dev_t const* d, uint8_t itf_num)
+{
+    for (uint8_t i = 0; i < d->itf_count; i++)
+    {
+        if (d->itf_nums[i] == itf_num)
+        {
+            return keeps_own_numbers(d) ? itf_num : i;
+        }
+    }
+    return -1;
+}
+
+static uint8_t itf_span(hub_dev_t const* d)
+{
+    if (!d->itf_count)
+    {
+        return 0;
+    }
+    return keeps_own_numbers(d) ? (uint8_t)(d->itf_nums[d->itf_count - 1] + 1u) : d->itf_count;
+}
+
+static uint8_t itf_base(hub_dev_t const* d)
+{
+    uint8_t base = 0;
+    for (hub_dev_t const* p = s_devs; p < d; p++)
+    {
+        base = (uint8_t)(base + itf_span(p));
+    }
+    return base;
+}
+
+static uint8_t composite_of(hub_dev_t const* d, uint8_t itf_num)
+{
+    int16_t off = local_offset(d, itf_num);
+    if (off < 0)
+    {
+        return HUB_AGG_NO_ITF;
+    }
+    uint16_t itf = (uint16_t)(itf_base(d) + off);
+    return itf < PROXY_HUB_MAX_ITFS ? (uint8_t)itf : HUB_AGG_NO_ITF;
+}
+
+void hub_aggregate_reset(void)
+{
+    memset(s_devs, 0, sizeof(s_devs));
+    s_count  = 0;
+    s_packed = false;
+}
+
+void hub_aggregate_set_packed(bool packed)
+{
+    s_packed = packed && s_count > 1;
+}
+
+bool hub_aggregate_packed(void)
+{
+    return s_packed;
+}
+
+uint8_t hub_aggregate_attach(uint8_t dev_addr, uint8_t local_itf)
+{
+    if (!dev_addr || local_itf >= PROXY_HUB_MAX_ITFS)
+    {
+        return HUB_AGG_NO_ITF;
+    }
+
+    hub_dev_t* d = find_dev(dev_addr);
+    if (d && local_offset(d, local_itf) >= 0)
+    {
+        return composite_of(d, local_itf);
+    }
+    if (!d)
+    {
+        if (s_count >= PROXY_HUB_MAX_DEVICES)
+        {
+            return HUB_AGG_NO_ITF;
+        }
+        d = &s_devs[s_count++];
+        memset(d, 0, sizeof(*d));
+        d->dev_addr = dev_addr;
+    }
+
+    hub_dev_t saved = *d;
+    uint8_t   span  = itf_span(d);
+    uint8_t   pos   = d->itf_count;
+    while (pos && d->itf_nums[pos - 1] > local_itf)
+    {
+        d->itf_nums[pos] = d->itf_nums[pos - 1];
+        pos--;
+    }
+    d->itf_nums[pos] = local_itf;
+    d->itf_count++;
+
+    // Growing into the next device's run would renumber it under the PC.
+    bool last = d == &s_devs[s_count - 1];
+    if ((!last && itf_span(d) != span) ||
+        itf_base(d) + itf_span(d) > PROXY_HUB_MAX_ITFS)
+    {
+        if (!saved.itf_count && last)
+        {
+            memset(d, 0, sizeof(*d));
+            s_count--;
+        }
+        else
+        {
+            *d = saved;
+        }
+        return HUB_AGG_NO_ITF;
+    }
+    return composite_of(d, local_itf);
+}
+
+uint8_t hub_aggregate_itf(uint8_t dev_addr, uint8_t local_itf)
+{
+    hub_dev_t const* d = find_dev(dev_addr);
+    return d ? composite_of(d, local_itf) : HUB_AGG_NO_ITF;
+}
+
+uint8_t hub_aggregate_itf_base(uint8_t dev_addr)
+{
+    hub_dev_t const* d = find_dev(dev_addr);
+    return d ? itf_base(d) : HUB_AGG_NO_ITF;
+}
+
+void hub_aggregate_detach(uint8_t dev_addr)
+{
+    hub_dev_t* d = find_dev(dev_addr);
+    if (!d)
+    {
+        return;
+    }
+    uint8_t idx = (uint8_t)(d - s_devs);
+    memmove(&s_devs[idx], &s_devs[idx + 1], (size_t)(s_count - idx - 1u) * sizeof(s_devs[0]));
+    s_count--;
+    memset(&s_devs[s_count], 0, sizeof(s_devs[0]));
+    if (s_count < 2)
+    {
+        s_packed = false;
+    }
+}
+
+uint8_t hub_aggregate_count(void)
+{
+    return s_count;
+}
+
+uint8_t hub_aggregate_primary(void)
+{
+    return s_count ? s_devs[0].dev_addr : 0;
+}
+
+uint8_t hub_aggregate_next_pending(void)
+{
+    for (uint8_t i = 1; i < s_count; i++)
+    {
+        if (!s_devs[i].stored)
+        {
+            return s_devs[i].dev_addr;
+        }
+    }
+    return 0;
+}
+
+bool hub_aggregate_complete(void)
+{
+    for (uint8_t i = 0; i < s_count; i++)
+    {
+        if (!s_devs[i].stored)
+        {
+            return false;
+        }
+    }
+    return s_count != 0;
+}
+
+bool hub_aggregate_store(uint8_t dev_addr,
+                         uint8_t const* device, uint16_t device_len,
+                         uint8_t const* cfg, uint16_t cfg_len)
+{
+    hub_dev_t* d = find_dev(dev_addr);
+    if (!d || !device || device_len < HUB_DEVICE_DESC_LEN || !cfg ||
+        cfg_len < HUB_CONFIG_DESC_LEN || cfg[1] != HUB_DESC_CONFIGURATION)
+    {
+        return false;
+    }
+
+    uint16_t pos  = 0;
+    bool     keep = false;
+    for (uint16_t off = cfg[0]; off + 2u <= cfg_len; )
+    {
+        uint8_t blen  = cfg[off];
+        uint8_t dtype = cfg[off + 1];
+        if (blen < 2 || off + blen > cfg_len) break;
+
+        if (dtype == HUB_DESC_INTERFACE && blen >= 9)
+        {
+            keep = cfg[off + 5] == HUB_CLASS_HID && cfg[off + 2] < PROXY_HUB_MAX_ITFS;
+        }
+        else if (dtype == HUB_DESC_IAD)
+        {
+            keep = false;
+        }
+
+        if (keep)
+        {
+            if (pos + blen > sizeof(d->hid))
+            {
+                return false;
+            }
+            memcpy(&d->hid[pos], &cfg[off], blen);
+            pos = (uint16_t)(pos + blen);
+        }
+        off = (uint16_t)(off + blen);
+    }
+
+    memcpy(d->device, device, HUB_DEVICE_DESC_LEN);
+    d->attributes = cfg[7];
+    d->max_power  = cfg[8];
+    d->hid_len    = pos;
+    d->stored     = true;
+    return true;
+}
+
+bool hub_aggregate_build_device(uint8_t* out, uint16_t max)
+{
+    if (!out || max < HUB_DEVICE_DESC_LEN || !s_count || !s_devs[0].stored)
+    {
+        return false;
+    }
+    memcpy(out, s_devs[0].device, HUB_DEVICE_DESC_LEN);
+    out[4]  = 0;   // bDeviceClass: per interface
+    out[5]  = 0;
+    out[6]  = 0;
+    out[17] = 1;   // bNumConfigurations
+    return true;
+}
+
+uint16_t hub_aggregate_build_config(uint8_t* out, uint16_t max)
+{
+    if (!out || max < HUB_CONFIG_DESC_LEN || !hub_aggregate_complete())
+    {
+        return 0;
+    }
+
+    uint16_t pos   = HUB_CONFIG_DESC_LEN;
+    uint8_t  n_itf = 0;
+    uint8_t  attr  = 0x80;
+    uint16_t power = 0;
+
+    for (uint8_t i = 0; i < s_count; i++)
+    {
+        hub_dev_t const* d = &s_devs[i];
+        attr  |= d->attributes & HUB_ATTR_REMOTE_WAKEUP;
+        power  = (uint16_t)(power + d->max_power);
+
+        bool    keep = false;
+        uint8_t itf  = 0;
+        for (uint16_t off = 0; off + 2u <= d->hid_len; )
+        {
+            uint8_t const* p = &d->hid[off];
+            uint8_t blen = p[0];
+            if (blen < 2 || off + blen > d->hid_len) break;
+
+            if (p[1] == HUB_DESC_INTERFACE)
+            {
+                // Interfaces that never mounted have no slot to feed them.
+                itf  = composite_of(d, p[2]);
+                keep = itf != HUB_AGG_NO_ITF;
+                if (keep && p[3] == 0)
+                {
+                    n_itf++;
+                }
+            }
+
+            if (keep)
+            {
+                if (pos + blen > max)
+                {
+                    return 0;
+                }
+                uint8_t* o = &out[pos];
+                memcpy(o, p, blen);
+                if (p[1] == HUB_DESC_INTERFACE)
+                {
+                    o[2] = itf;
+                    if (i)
+                    {
+                        o[8] = 0;   // iInterface indexes another device's strings
+                    }
+                }
+                else if (p[1] == HUB_DESC_ENDPOINT && blen >= 7)
+                {
+                    o[2] = (uint8_t)((p[2] & 0x80u) | (itf + 1u));
+                }
+                pos = (uint16_t)(pos + blen);
+            }
+            off = (uint16_t)(off + blen);
+        }
+    }
+
+    out[0] = HUB_CONFIG_DESC_LEN;
+    out[1] = HUB_DESC_CONFIGURATION;
+    out[2] = (uint8_t)(pos & 0xFF);
+    out[3] = (uint8_t)(pos >> 8);
+    out[4] = n_itf;
+    out[5] = 1;    // bConfigurationValue
+    out[6] = 0;    // iConfiguration
+    out[7] = attr;
+    out[8] = (uint8_t)(power > HUB_MAX_POWER_UNITS ? HUB_MAX_POWER_UNITS : power);
+    return pos;
+}
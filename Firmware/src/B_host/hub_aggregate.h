@@ -0,0 +1,62 @@
+#ifndef HUB_AGGREGATE_H
+#define HUB_AGGREGATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// HID devices behind a hub, presented to the PC as one composite device
+// (PROXY_HUB_AGGREGATE). Every device gets a contiguous run of composite
+// interfaces starting at its base, in mount order. Until the composite is
+// presented the first device keeps base 0 and its own interface numbers, so
+// a lone device is numbered exactly as before; once packed, every device's
+// HID interfaces are numbered by rank, so the composite runs from 0 without
+// holes. PF_INPUT and the control UART address interfaces by composite index;
+// TinyUSB calls still use the device's own (dev_addr, instance).
+//
+// Pure bookkeeping, no TinyUSB calls: hid_proxy_host.c decides when to
+// forward the composite set.
+
+#define HUB_AGG_NO_ITF 0xFFu
+
+void hub_aggregate_reset(void);
+
+// Switch to rank numbering for the composite (ignored with fewer than two
+// devices). Falls back to the primary's own numbers when one device is left.
+// Composite indexes change, so the caller moves its per-interface state.
+void hub_aggregate_set_packed(bool packed);
+bool hub_aggregate_packed(void);
+
+// Composite interface of interface `local_itf` (bInterfaceNumber) of
+// `dev_addr`; registers the device on first use. HUB_AGG_NO_ITF when the
+// device table or PROXY_HUB_MAX_ITFS is exhausted.
+uint8_t hub_aggregate_attach(uint8_t dev_addr, uint8_t local_itf);
+// Lookup only; HUB_AGG_NO_ITF for unknown devices.
+uint8_t hub_aggregate_itf(uint8_t dev_addr, uint8_t local_itf);
+uint8_t hub_aggregate_itf_base(uint8_t dev_addr);
+// Forgets `dev_addr`; the devices after it move down to close the gap.
+void hub_aggregate_detach(uint8_t dev_addr);
+
+uint8_t hub_aggregate_count(void);
+// Device whose identity (device descriptor, strings) the composite uses; 0 = none.
+uint8_t hub_aggregate_primary(void);
+// First non-primary device whose descriptors have not been stored yet (the
+// primary's come from its normal forwarded enumeration); 0 = none.
+uint8_t hub_aggregate_next_pending(void);
+// True once every attached device has stored its descriptors.
+bool hub_aggregate_complete(void);
+
+// Keeps the device descriptor and the HID interfaces of `cfg` (with their
+// HID class and endpoint descriptors) for composite synthesis.
+bool hub_aggregate_store(uint8_t dev_addr,
+                         uint8_t const* device, uint16_t device_len,
+                         uint8_t const* cfg, uint16_t cfg_len);
+
+// Composite device descriptor: the primary's, with class at interface level.
+bool hub_aggregate_build_device(uint8_t* out, uint16_t max);
+// Composite configuration (call once packed): every device's HID interfaces
+// renumbered to their composite index, 0..bNumInterfaces-1, endpoints renumbered to match (IN 0x81 + i, OUT 0x01 + i),
+// interface strings kept for the primary only. Returns the length, 0 when
+// something is missing or `max` is too small.
+uint16_t hub_aggregate_build_config(uint8_t* out, uint16_t max);
+
+#endif // HUB_AGGREGATE_H
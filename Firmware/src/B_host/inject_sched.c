@@ -0,0 +1,267 @@
+#include "inject_sched.h"
+
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/timer.h"
+#include "hardware/sync.h"
+
+#include "logging.h"
+#include "proxy_config.h"
+#include "uart_transport.h"
+#include "hid_proxy_host.h"
+
+#if PROXY_INJECT_SCHED_DEPTH > 255u
+#error "PROXY_INJECT_SCHED_DEPTH must be <= 255"
+#endif
+
+typedef struct
+{
+    uint32_t due_us;
+    uint32_t order;   // accept order: equal deadlines leave in FIFO order
+    uint16_t tag;
+    uint8_t  itf;
+    uint8_t  len;
+    uint8_t  report[INJECT_SCHED_REPORT_MAX];
+} sched_slot_t;
+
+// The heap holds slot indices, so sifting moves single bytes, not reports.
+// The main loop edits it with IRQs off; the alarm IRQ pops from it.
+static sched_slot_t s_slots[PROXY_INJECT_SCHED_DEPTH];
+static uint8_t      s_heap[PROXY_INJECT_SCHED_DEPTH];
+static uint8_t      s_heap_n = 0;
+static uint8_t      s_free[PROXY_INJECT_SCHED_DEPTH];
+static uint8_t      s_free_n = 0;
+static uint32_t     s_order = 0;
+static int          s_alarm = -1;
+
+static inject_sched_stats_t s_stats;
+static uint64_t             s_late_sum_us = 0;
+
+// Deadlines are compared as signed differences, so the 32-bit clock may wrap.
+static bool slot_before(uint8_t a, uint8_t b)
+{
+    int32_t d = (int32_t)(s_slots[a].due_us - s_slots[b].due_us);
+    if (d != 0) return d < 0;
+    return (int32_t)(s_slots[a].order - s_slots[b].order) < 0;
+}
+
+static void sift_up(uint8_t i)
+{
+    while (i > 0)
+    {
+        uint8_t parent = (uint8_t)((i - 1u) / 2u);
+        if (!slot_before(s_heap[i], s_heap[parent])) break;
+        uint8_t t = s_heap[i];
+        s_heap[i] = s_heap[parent];
+        s_heap[parent] = t;
+        i = parent;
+    }
+}
+
+static void sift_down(uint8_t i)
+{
+    for (;;)
+    {
+        uint16_t l = (uint16_t)(2u * i + 1u);
+        uint16_t r = (uint16_t)(l + 1u);
+        uint8_t m = i;
+        if (l < s_heap_n && slot_before(s_heap[l], s_heap[m])) m = (uint8_t)l;
+        if (r < s_heap_n && slot_before(s_heap[r], s_heap[m])) m = (uint8_t)r;
+        if (m == i) return;
+        uint8_t t = s_heap[i];
+        s_heap[i] = s_heap[m];
+        s_heap[m] = t;
+        i = m;
+    }
+}
+
+static void heap_pop(void)
+{
+    s_free[s_free_n++] = s_heap[0];
+    s_heap_n--;
+    if (s_heap_n)
+    {
+        s_heap[0] = s_heap[s_heap_n];
+        sift_down(0);
+    }
+}
+
+// Arms the alarm for the earliest deadline; a deadline already due goes
+// through the IRQ at once. Call with IRQs off (or from the alarm IRQ).
+static void sched_arm(void)
+{
+    if (!s_heap_n)
+    {
+        hardware_alarm_cancel((uint)s_alarm);
+        return;
+    }
+    int32_t wait = (int32_t)(s_slots[s_heap[0]].due_us - time_us_32());
+    if (wait <= 0 ||
+        hardware_alarm_set_target((uint)s_alarm, from_us_since_boot(time_us_64() + (uint32_t)wait)))
+    {
+        hardware_alarm_force_irq((uint)s_alarm);
+    }
+}
+
+static void sched_alarm_cb(uint alarm_num)
+{
+    (void)alarm_num;
+    while (s_heap_n)
+    {
+        sched_slot_t* slot = &s_slots[s_heap[0]];
+        uint32_t now = time_us_32();
+        int32_t wait = (int32_t)(slot->due_us - now);
+        if (wait > 0)
+        {
+            // Returns true when the target was missed: send it right here.
+            if (!hardware_alarm_set_target((uint)s_alarm, from_us_since_boot(time_us_64() + (uint32_t)wait)))
+            {
+                return;
+            }
+            continue;
+        }
+
+        int rc = hid_proxy_host_send_input_isr(slot->itf, slot->report, slot->len);
+        if (rc == UART_TRANSPORT_BUSY)
+        {
+            // The main loop is mid-frame on the link and cannot finish it
+            // while this IRQ runs: keep the report and come back shortly.
+            s_stats.busy_retries++;
+            while (hardware_alarm_set_target((uint)s_alarm,
+                                             from_us_since_boot(time_us_64() + PROXY_LINK_BUSY_RETRY_US)))
+            {
+            }
+            return;
+        }
+
+        uint32_t late = (uint32_t)(-wait);
+        if (rc < 0) s_stats.failed++;
+        else s_stats.sent++;
+        if (late > s_stats.late_max_us) s_stats.late_max_us = late;
+        if (late > PROXY_INJECT_SCHED_LATE_LIMIT_US) s_stats.overruns++;
+        s_late_sum_us += late;
+        heap_pop();
+    }
+}
+
+void inject_sched_init(void)
+{
+    for (uint8_t i = 0; i < PROXY_INJECT_SCHED_DEPTH; i++)
+    {
+        s_free[i] = (uint8_t)(PROXY_INJECT_SCHED_DEPTH - 1u - i);
+    }
+    s_free_n = PROXY_INJECT_SCHED_DEPTH;
+    s_heap_n = 0;
+
+    s_alarm = hardware_alarm_claim_unused(false);
+    if (s_alarm < 0)
+    {
+        LOGW("[SCHED] no free hardware alarm, scheduled injection disabled");
+        return;
+    }
+    hardware_alarm_set_callback((uint)s_alarm, sched_alarm_cb);
+}
+
+inject_sched_result_t inject_sched_add(uint32_t due_us, uint16_t tag, uint8_t itf,
+                                       uint8_t const* report, uint16_t len)
+{
+    if (!report || len == 0 || len > INJECT_SCHED_REPORT_MAX) return INJECT_SCHED_ERR_LEN;
+
+    int32_t ahead = (int32_t)(due_us - time_us_32());
+    if (ahead > (int32_t)PROXY_INJECT_SCHED_HORIZON_US || ahead < -(int32_t)PROXY_INJECT_SCHED_HORIZON_US)
+    {
+        s_stats.rejected++;
+        return INJECT_SCHED_ERR_RANGE;
+    }
+
+    uint32_t irq = save_and_disable_interrupts();
+    if (s_alarm < 0 || s_free_n == 0)
+    {
+        s_stats.rejected++;
+        restore_interrupts(irq);
+        return INJECT_SCHED_ERR_FULL;
+    }
+
+    uint8_t idx = s_free[--s_free_n];
+    sched_slot_t* slot = &s_slots[idx];
+    slot->due_us = due_us;
+    slot->order  = s_order++;
+    slot->tag    = tag;
+    slot->itf    = itf;
+    slot->len    = (uint8_t)len;
+    memcpy(slot->report, report, len);
+
+    s_heap[s_heap_n] = idx;
+    sift_up(s_heap_n++);
+    s_stats.accepted++;
+    if (s_heap_n > s_stats.high_water) s_stats.high_water = s_heap_n;
+    if (s_heap[0] == idx) sched_arm();
+    restore_interrupts(irq);
+    return INJECT_SCHED_OK;
+}
+
+uint8_t inject_sched_cancel(uint16_t tag)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    uint8_t kept = 0;
+    uint8_t removed = 0;
+    for (uint8_t i = 0; i < s_heap_n; i++)
+    {
+        uint8_t idx = s_heap[i];
+        if (tag == INJECT_SCHED_TAG_ALL || s_slots[idx].tag == tag)
+        {
+            s_free[s_free_n++] = idx;
+            removed++;
+        }
+        else
+        {
+            s_heap[kept++] = idx;
+        }
+    }
+
+    if (removed)
+    {
+        s_heap_n = kept;
+        for (int i = (int)s_heap_n / 2 - 1; i >= 0; i--)
+        {
+            sift_down((uint8_t)i);
+        }
+        s_stats.cancelled += removed;
+        sched_arm();
+    }
+    restore_interrupts(irq);
+    return removed;
+}
+
+uint8_t inject_sched_pending(uint16_t tag)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < s_heap_n; i++)
+    {
+        if (tag == INJECT_SCHED_TAG_ALL || s_slots[s_heap[i]].tag == tag) n++;
+    }
+    restore_interrupts(irq);
+    return n;
+}
+
+void inject_sched_get_stats(inject_sched_stats_t* out, bool reset)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    if (out)
+    {
+        *out = s_stats;
+        out->pending = s_heap_n;
+        out->depth   = PROXY_INJECT_SCHED_DEPTH;
+        uint32_t done = s_stats.sent + s_stats.failed;
+        out->late_mean_us = done ? (uint32_t)(s_late_sum_us / done) : 0;
+    }
+    if (reset)
+    {
+        memset(&s_stats, 0, sizeof(s_stats));
+        s_stats.high_water = s_heap_n;
+        s_late_sum_us = 0;
+    }
+    restore_interrupts(irq);
+}
@@ -0,0 +1,56 @@
+#ifndef INJECT_SCHED_H
+#define INJECT_SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Deadline-scheduled injection (SCHEDULE, cmd 0x11). Reports carry a due time
+// on the B_host clock (time_us_32) and wait in a min-heap; a hardware alarm
+// fires at the earliest deadline and writes the report straight to the link,
+// so controller-side UART/MAC jitter does not reach the output. INJECT_BATCH
+// queues its delayed reports here too, under INJECT_SCHED_TAG_BATCH.
+
+#define INJECT_SCHED_REPORT_MAX 64u
+#define INJECT_SCHED_TAG_ALL    0xFFFFu
+#define INJECT_SCHED_TAG_BATCH  0xFFFEu
+
+typedef enum
+{
+    INJECT_SCHED_OK        = 0,
+    INJECT_SCHED_ERR_FULL  = 1,  // PROXY_INJECT_SCHED_DEPTH reports pending
+    INJECT_SCHED_ERR_RANGE = 2,  // due time beyond PROXY_INJECT_SCHED_HORIZON_US
+    INJECT_SCHED_ERR_LEN   = 3   // report empty or longer than 64 bytes
+} inject_sched_result_t;
+
+typedef struct
+{
+    uint8_t  pending;
+    uint8_t  depth;
+    uint8_t  high_water;
+    uint32_t accepted;
+    uint32_t sent;
+    uint32_t failed;        // interface gone or not ready at the deadline
+    uint32_t cancelled;
+    uint32_t rejected;      // queue full or due time out of range
+    uint32_t busy_retries;  // link busy with a main-loop frame at the deadline
+    uint32_t late_max_us;
+    uint32_t late_mean_us;
+    uint32_t overruns;      // sent later than PROXY_INJECT_SCHED_LATE_LIMIT_US
+} inject_sched_stats_t;
+
+void inject_sched_init(void);
+
+// `itf` is a concrete interface number (resolve selectors first). A due time
+// in the past sends at once and counts the lateness.
+inject_sched_result_t inject_sched_add(uint32_t due_us, uint16_t tag, uint8_t itf,
+                                       uint8_t const* report, uint16_t len);
+
+// Removes pending reports with `tag` (INJECT_SCHED_TAG_ALL: every report).
+// Returns the number removed.
+uint8_t inject_sched_cancel(uint16_t tag);
+// Pending reports with `tag` (INJECT_SCHED_TAG_ALL: every report).
+uint8_t inject_sched_pending(uint16_t tag);
+
+void inject_sched_get_stats(inject_sched_stats_t* out, bool reset);
+
+#endif // INJECT_SCHED_H
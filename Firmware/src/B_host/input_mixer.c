@@ -0,0 +1,393 @@
+#include "input_mixer.h"
+
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "tusb.h"
+
+#include "logging.h"
+#include "proxy_config.h"
+#include "hid_proxy_host.h"
+#include "input_state.h"
+#include "descriptor_logger.h"
+#include "hid_fields.h"
+
+#define MIX_REPORT_MAX       HID_FIELD_REPORT_MAX
+#define USAGE_ERROR_ROLLOVER 0x01u
+
+// Newest report of each source for one role (keyboard or pointer report of
+// the interface); relative motion of both sources adds up until it is sent.
+typedef struct
+{
+    uint8_t  phys[MIX_REPORT_MAX];
+    uint8_t  phys_len;
+    uint8_t  inj[MIX_REPORT_MAX];
+    uint8_t  inj_len;
+    uint32_t phys_at_us;
+    uint32_t inj_at_us;
+    int32_t  acc_x;
+    int32_t  acc_y;
+    int32_t  acc_wheel;
+    bool     dirty;
+} mix_role_t;
+
+typedef struct
+{
+    uint8_t    policy;
+    uint16_t   interval_us;   // 0 = not read from the endpoint yet
+    bool       sent_any;
+    uint32_t   last_out_us;
+    mix_role_t kb;
+    mix_role_t mouse;
+    uint32_t   physical_in;
+    uint32_t   injected_in;
+    uint32_t   merged_out;
+    uint32_t   suppressed;
+} mix_itf_t;
+
+static mix_itf_t s_mix[CFG_TUH_HID];
+static bool      s_mix_init = false;
+
+static void mix_init(void)
+{
+    if (s_mix_init) return;
+    s_mix_init = true;
+    for (uint8_t i = 0; i < CFG_TUH_HID; i++)
+    {
+        s_mix[i].policy = PROXY_MIX_DEFAULT_POLICY < INPUT_MIX_POLICY_COUNT ? PROXY_MIX_DEFAULT_POLICY : INPUT_MIX_OFF;
+    }
+}
+
+static int32_t axis_limit(uint8_t size_bits)
+{
+    if (size_bits < 2) return 1;
+    if (size_bits > 16) return 32767;
+    return (int32_t)((1u << (size_bits - 1u)) - 1u);
+}
+
+// Sends up to the axis limit and keeps the rest for the next report.
+static int32_t take_axis(int32_t* acc, uint8_t size_bits)
+{
+    int32_t lim = axis_limit(size_bits);
+    int32_t v = *acc;
+    if (v > lim) v = lim;
+    if (v < -lim) v = -lim;
+    *acc -= v;
+    return v;
+}
+
+static bool role_match(hid_report_layout_t const* l, uint8_t const* report, uint16_t len)
+{
+    if (!l->kb_has_report_id) return true;
+    return len >= 1 && report[0] == l->report_id;
+}
+
+static bool mix_recent(uint32_t at_us, uint8_t len, uint32_t now)
+{
+    return len && (now - at_us) < PROXY_MIX_HOLDOFF_MS * 1000u;
+}
+
+static uint16_t mix_interval_us(uint8_t itf)
+{
+    mix_itf_t* m = &s_mix[itf];
+    if (!m->interval_us)
+    {
+        uint8_t poll_ms = descriptor_logger_poll_interval_ms(itf);
+        if (poll_ms > 65) poll_ms = 65;
+        m->interval_us = poll_ms ? (uint16_t)(poll_ms * 1000u) : PROXY_MIX_DEFAULT_INTERVAL_US;
+    }
+    return m->interval_us;
+}
+
+// Adds the keys of `src` to `out`: ORed bits for a bitmap, a union for an
+// array, ErrorRollOver in every slot when the array overflows.
+static void union_keys(hid_report_layout_t const* l, uint16_t base, uint8_t* out, uint8_t const* src)
+{
+    if (l->kb_has_mods)
+    {
+        uint16_t off = (uint16_t)(base + l->kb_mods_offset_bits);
+        hid_field_write(out, off, 8, hid_field_read(out, off, 8) | hid_field_read(src, off, 8));
+    }
+    if (l->kb_keys_bitmap)
+    {
+        for (uint16_t s = 0; s < l->kb_keys_count; s++)
+        {
+            uint16_t off = (uint16_t)(base + l->kb_keys_offset_bits + s);
+            if (hid_field_read(src, off, 1)) hid_field_write(out, off, 1, 1);
+        }
+        return;
+    }
+
+    for (uint8_t k = 0; k < l->kb_keys_count; k++)
+    {
+        uint32_t usage = hid_field_read(src, (uint16_t)(base + l->kb_keys_offset_bits + k * l->kb_keys_size_bits),
+                                        l->kb_keys_size_bits);
+        if (usage == 0) continue;
+
+        int free_slot = -1;
+        bool present = false;
+        for (uint8_t s = 0; s < l->kb_keys_count; s++)
+        {
+            uint32_t v = hid_field_read(out, (uint16_t)(base + l->kb_keys_offset_bits + s * l->kb_keys_size_bits),
+                                        l->kb_keys_size_bits);
+            if (v == usage) present = true;
+            if (v == 0 && free_slot < 0) free_slot = s;
+        }
+        if (present) continue;
+        if (usage == USAGE_ERROR_ROLLOVER || free_slot < 0)
+        {
+            for (uint8_t s = 0; s < l->kb_keys_count; s++)
+            {
+                hid_field_write(out, (uint16_t)(base + l->kb_keys_offset_bits + s * l->kb_keys_size_bits),
+                                l->kb_keys_size_bits, USAGE_ERROR_ROLLOVER);
+            }
+            return;
+        }
+        hid_field_write(out, (uint16_t)(base + l->kb_keys_offset_bits + free_slot * l->kb_keys_size_bits),
+                        l->kb_keys_size_bits, usage);
+    }
+}
+
+// Builds the merged report of a role from the sources the policy lets in.
+static uint16_t build_merged(mix_itf_t* m, mix_role_t* r, hid_report_layout_t const* l, bool kb,
+                             uint32_t now, uint8_t* out)
+{
+    bool use_phys = r->phys_len != 0;
+    bool use_inj = r->inj_len != 0;
+    if (m->policy == INPUT_MIX_PHYSICAL_FIRST && mix_recent(r->phys_at_us, r->phys_len, now)) use_inj = false;
+    if (m->policy == INPUT_MIX_INJECTED_FIRST && mix_recent(r->inj_at_us, r->inj_len, now)) use_phys = false;
+    if (m->policy == INPUT_MIX_INJECTED_ONLY) use_phys = false;
+    if (use_phys && use_inj && r->phys_len != r->inj_len) use_phys = false;
+
+    // The newer report is the base, so fields the mixer does not know
+    // (absolute axes, vendor bytes) follow the latest input.
+    uint8_t const* base_src = NULL;
+    uint8_t const* other = NULL;
+    uint16_t len = 0;
+    if (use_phys && use_inj)
+    {
+        bool phys_newer = (int32_t)(r->phys_at_us - r->inj_at_us) >= 0;
+        base_src = phys_newer ? r->phys : r->inj;
+        other = phys_newer ? r->inj : r->phys;
+        len = r->phys_len;
+    }
+    else if (use_phys)
+    {
+        base_src = r->phys;
+        len = r->phys_len;
+    }
+    else if (use_inj)
+    {
+        base_src = r->inj;
+        len = r->inj_len;
+    }
+    if (!base_src) return 0;
+
+    memset(out, 0, MIX_REPORT_MAX);
+    memcpy(out, base_src, len);
+    uint16_t base = l->kb_has_report_id ? 8u : 0u;
+
+    if (kb)
+    {
+        if (other) union_keys(l, base, out, other);
+        return len;
+    }
+
+    if ((l->flags & 0x01) && other)
+    {
+        uint8_t count = l->buttons_count > 8 ? 8 : l->buttons_count;
+        for (uint8_t i = 0; i < count; i++)
+        {
+            uint16_t off = (uint16_t)(base + l->buttons_offset_bits + i * l->buttons_size_bits);
+            if (hid_field_read(other, off, l->buttons_size_bits)) hid_field_write(out, off, l->buttons_size_bits, 1);
+        }
+    }
+    if (l->x_signed)
+    {
+        hid_field_write(out, (uint16_t)(base + l->x_offset_bits), l->x_size_bits,
+                        (uint32_t)take_axis(&r->acc_x, l->x_size_bits));
+    }
+    if (l->y_signed)
+    {
+        hid_field_write(out, (uint16_t)(base + l->y_offset_bits), l->y_size_bits,
+                        (uint32_t)take_axis(&r->acc_y, l->y_size_bits));
+    }
+    if ((l->flags & 0x02) && l->wheel_signed)
+    {
+        hid_field_write(out, (uint16_t)(base + l->wheel_offset_bits), l->wheel_size_bits,
+                        (uint32_t)take_axis(&r->acc_wheel, l->wheel_size_bits));
+    }
+    return len;
+}
+
+static void flush_role(uint8_t itf, mix_itf_t* m, mix_role_t* r, hid_report_layout_t const* l, bool kb,
+                       uint32_t now)
+{
+    if (!r->dirty || !l) return;
+    uint8_t report[MIX_REPORT_MAX];
+    uint16_t len = build_merged(m, r, l, kb, now, report);
+    if (!len)
+    {
+        r->dirty = false;
+        return;
+    }
+    if (!hid_proxy_host_send_input(itf, report, len)) return;  // link busy: next pass
+
+    m->merged_out++;
+    // Motion larger than one report keeps the role due.
+    r->dirty = !kb && (r->acc_x || r->acc_y || r->acc_wheel);
+}
+
+// One merged report per poll interval and interface.
+static void flush_itf(uint8_t itf, uint32_t now)
+{
+    mix_itf_t* m = &s_mix[itf];
+    if (m->policy == INPUT_MIX_OFF || (!m->kb.dirty && !m->mouse.dirty)) return;
+    // Unsigned age: any idle time, however long, makes the next report due.
+    if (m->sent_any && (uint32_t)(now - m->last_out_us) < mix_interval_us(itf)) return;
+
+    hid_report_layout_t const* kb = NULL;
+    hid_report_layout_t const* mouse = NULL;
+    input_state_layouts(itf, &kb, &mouse);
+    flush_role(itf, m, &m->kb, kb, true, now);
+    flush_role(itf, m, &m->mouse, mouse, false, now);
+    m->sent_any = true;
+    m->last_out_us = now;
+}
+
+static bool mix_take(uint8_t itf, uint8_t const* report, uint16_t len, bool injected)
+{
+    mix_init();
+    if (itf >= CFG_TUH_HID || !report || len == 0 || len > MIX_REPORT_MAX) return false;
+    mix_itf_t* m = &s_mix[itf];
+    if (m->policy == INPUT_MIX_OFF) return false;
+
+    hid_report_layout_t const* kb = NULL;
+    hid_report_layout_t const* mouse = NULL;
+    input_state_layouts(itf, &kb, &mouse);
+    mix_role_t* r = NULL;
+    hid_report_layout_t const* l = NULL;
+    if (kb && role_match(kb, report, len))
+    {
+        r = &m->kb;
+        l = kb;
+    }
+    else if (mouse && role_match(mouse, report, len))
+    {
+        r = &m->mouse;
+        l = mouse;
+    }
+    if (!r) return false;  // consumer keys, vendor reports: unchanged
+
+    uint32_t now = time_us_32();
+    if (injected) m->injected_in++;
+    else m->physical_in++;
+
+    bool drop = false;
+    if (injected && m->policy == INPUT_MIX_PHYSICAL_FIRST) drop = mix_recent(r->phys_at_us, r->phys_len, now);
+    if (!injected && m->policy == INPUT_MIX_INJECTED_FIRST) drop = mix_recent(r->inj_at_us, r->inj_len, now);
+    if (!injected && m->policy == INPUT_MIX_INJECTED_ONLY) drop = true;
+    if (drop)
+    {
+        m->suppressed++;
+        return true;
+    }
+
+    memcpy(injected ? r->inj : r->phys, report, len);
+    if (injected)
+    {
+        r->inj_len = (uint8_t)len;
+        r->inj_at_us = now;
+    }
+    else
+    {
+        r->phys_len = (uint8_t)len;
+        r->phys_at_us = now;
+    }
+
+    if (r == &m->mouse)
+    {
+        uint16_t base = l->kb_has_report_id ? 8u : 0u;
+        if (l->x_signed) r->acc_x += hid_field_read_signed(report, (uint16_t)(base + l->x_offset_bits), l->x_size_bits);
+        if (l->y_signed) r->acc_y += hid_field_read_signed(report, (uint16_t)(base + l->y_offset_bits), l->y_size_bits);
+        if ((l->flags & 0x02) && l->wheel_signed)
+        {
+            r->acc_wheel += hid_field_read_signed(report, (uint16_t)(base + l->wheel_offset_bits), l->wheel_size_bits);
+        }
+    }
+    r->dirty = true;
+    flush_itf(itf, now);
+    return true;
+}
+
+bool input_mixer_take_physical(uint8_t itf, uint8_t const* report, uint16_t len)
+{
+    return mix_take(itf, report, len, false);
+}
+
+bool input_mixer_take_injected(uint8_t itf, uint8_t const* report, uint16_t len)
+{
+    return mix_take(itf, report, len, true);
+}
+
+static void mix_clear(uint8_t itf)
+{
+    mix_itf_t* m = &s_mix[itf];
+    memset(&m->kb, 0, sizeof(m->kb));
+    memset(&m->mouse, 0, sizeof(m->mouse));
+    m->interval_us = 0;
+    m->sent_any = false;
+}
+
+bool input_mixer_set_policy(uint8_t itf, uint8_t policy)
+{
+    mix_init();
+    if (policy >= INPUT_MIX_POLICY_COUNT) return false;
+    for (uint8_t i = 0; i < CFG_TUH_HID; i++)
+    {
+        if (itf != INPUT_MIXER_ITF_ALL && itf != i) continue;
+        if (s_mix[i].policy != policy) mix_clear(i);
+        s_mix[i].policy = policy;
+    }
+    LOGI("[MIX] itf=%u policy=%u", itf, policy);
+    return itf == INPUT_MIXER_ITF_ALL || itf < CFG_TUH_HID;
+}
+
+bool input_mixer_active(uint8_t itf)
+{
+    mix_init();
+    return itf < CFG_TUH_HID && s_mix[itf].policy != INPUT_MIX_OFF;
+}
+
+void input_mixer_task(void)
+{
+    mix_init();
+    uint32_t now = time_us_32();
+    for (uint8_t i = 0; i < CFG_TUH_HID; i++)
+    {
+        flush_itf(i, now);
+    }
+}
+
+void input_mixer_get_stats(uint8_t itf, input_mixer_stats_t* out)
+{
+    mix_init();
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    out->itf = itf;
+    if (itf >= CFG_TUH_HID) return;
+    mix_itf_t const* m = &s_mix[itf];
+    out->policy = m->policy;
+    out->interval_us = m->interval_us;
+    out->physical_in = m->physical_in;
+    out->injected_in = m->injected_in;
+    out->merged_out = m->merged_out;
+    out->suppressed = m->suppressed;
+}
+
+void input_mixer_reset_itf(uint8_t itf)
+{
+    mix_init();
+    if (itf >= CFG_TUH_HID) return;
+    mix_clear(itf);
+}
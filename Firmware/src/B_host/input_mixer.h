@@ -0,0 +1,50 @@
+#ifndef INPUT_MIXER_H
+#define INPUT_MIXER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Input mixer (MIX, cmd 0x16). With a policy other than OFF, physical and
+// injected reports of an interface no longer go out one by one (last report
+// wins); the mixer keeps the newest report of each source and sends one
+// merged report per endpoint poll interval: buttons and modifiers ORed, key
+// arrays united, relative axes summed. Timed senders (REPLAY, SCHEDULE) hand
+// reports for a mixing interface to the main loop, which feeds them in here.
+
+#define INPUT_MIXER_ITF_ALL 0xFDu
+
+typedef enum
+{
+    INPUT_MIX_OFF            = 0,  // pass-through
+    INPUT_MIX_MERGE          = 1,  // both sources, always
+    INPUT_MIX_PHYSICAL_FIRST = 2,  // injected input ignored while the user is active
+    INPUT_MIX_INJECTED_FIRST = 3,  // physical input ignored while the controller is active
+    INPUT_MIX_INJECTED_ONLY  = 4,  // exclusive lock: physical input dropped
+    INPUT_MIX_POLICY_COUNT
+} input_mix_policy_t;
+
+typedef struct
+{
+    uint8_t  itf;
+    uint8_t  policy;
+    uint16_t interval_us;
+    uint32_t physical_in;
+    uint32_t injected_in;
+    uint32_t merged_out;
+    uint32_t suppressed;   // reports ignored by a priority policy
+} input_mixer_stats_t;
+
+bool input_mixer_set_policy(uint8_t itf, uint8_t policy);
+bool input_mixer_active(uint8_t itf);
+
+// Return true when the mixer took the report; it is then sent merged later.
+bool input_mixer_take_physical(uint8_t itf, uint8_t const* report, uint16_t len);
+bool input_mixer_take_injected(uint8_t itf, uint8_t const* report, uint16_t len);
+
+// Main loop: sends due merged reports.
+void input_mixer_task(void);
+void input_mixer_get_stats(uint8_t itf, input_mixer_stats_t* out);
+// Descriptor changed or interface gone; the policy is kept.
+void input_mixer_reset_itf(uint8_t itf);
+
+#endif // INPUT_MIXER_H
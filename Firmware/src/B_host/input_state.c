@@ -0,0 +1,402 @@
+#include "input_state.h"
+
+#include <string.h>
+
+#include "tusb.h"
+
+#include "logging.h"
+#include "hid_proxy_host.h"
+#include "input_mixer.h"
+
+#define USAGE_ERROR_ROLLOVER 0x01u
+#define USAGE_FIRST_KEY      0x04u  // 0x00..0x03: none and error usages
+
+typedef struct
+{
+    bool     parsed;
+    bool     has_kb;
+    bool     has_mouse;
+    hid_report_layout_t kb;
+    hid_report_layout_t mouse;
+    uint8_t  inj_mods;
+    uint8_t  inj_buttons;
+    uint8_t  inj_count;
+    uint8_t  inj_keys[PROXY_INPUT_STATE_MAX_KEYS];
+    // Last physical report of each role, the base of synthesized reports.
+    uint8_t  phys_kb[INPUT_STATE_REPORT_MAX];
+    uint8_t  phys_kb_len;
+    uint8_t  phys_mouse[INPUT_STATE_REPORT_MAX];
+    uint8_t  phys_mouse_len;
+} itf_input_t;
+
+static itf_input_t s_in[CFG_TUH_HID];
+
+static uint16_t layout_base(hid_report_layout_t const* l)
+{
+    return l->kb_has_report_id ? 8u : 0u;
+}
+
+static uint16_t layout_len(hid_report_layout_t const* l)
+{
+    uint16_t len = (uint16_t)(layout_base(l) / 8u + l->kb_report_len);
+    return len > INPUT_STATE_REPORT_MAX ? INPUT_STATE_REPORT_MAX : len;
+}
+
+static bool role_match(hid_report_layout_t const* l, uint8_t const* report, uint16_t len)
+{
+    if (!l->kb_has_report_id) return true;
+    return len >= 1 && report[0] == l->report_id;
+}
+
+// Interfaces without a stored report descriptor: boot formats by protocol.
+static void boot_layouts(uint8_t itf, itf_input_t* st)
+{
+    hid_proxy_itf_info_t list[CFG_TUH_HID];
+    size_t n = hid_proxy_host_list_interfaces(list, CFG_TUH_HID);
+    uint8_t proto = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (list[i].itf == itf) proto = list[i].itf_protocol;
+    }
+
+    if (proto == HID_ITF_PROTOCOL_KEYBOARD)
+    {
+        memset(&st->kb, 0, sizeof(st->kb));
+        st->kb.itf = itf;
+        st->kb.kb_report_len = 8;
+        st->kb.kb_has_mods = 1;
+        st->kb.kb_keys_offset_bits = 16;
+        st->kb.kb_keys_count = 6;
+        st->kb.kb_keys_size_bits = 8;
+        st->has_kb = true;
+    }
+    else if (proto == HID_ITF_PROTOCOL_MOUSE)
+    {
+        memset(&st->mouse, 0, sizeof(st->mouse));
+        st->mouse.itf = itf;
+        st->mouse.flags = 0x0F;
+        st->mouse.buttons_count = 3;
+        st->mouse.buttons_size_bits = 1;
+        st->mouse.x_offset_bits = 8;
+        st->mouse.x_size_bits = 8;
+        st->mouse.y_offset_bits = 16;
+        st->mouse.y_size_bits = 8;
+        st->mouse.wheel_offset_bits = 24;
+        st->mouse.wheel_size_bits = 8;
+        st->mouse.kb_report_len = 4;
+        st->has_mouse = true;
+    }
+}
+
+// Descriptor parsing is deferred to first use and cached until the
+// descriptor changes.
+static itf_input_t* state_for(uint8_t itf)
+{
+    itf_input_t* st = &s_in[itf];
+    if (st->parsed) return st;
+
+    st->parsed = true;
+    st->has_kb = hid_proxy_host_get_keyboard_layout(itf, &st->kb) && st->kb.kb_keys_count;
+    st->has_mouse = hid_proxy_host_get_report_layout(itf, 0, &st->mouse) &&
+                    (st->mouse.flags & 0x0C) == 0x0C;
+    if (!st->has_kb && !st->has_mouse) boot_layouts(itf, st);
+    return st;
+}
+
+static void merge_kb(itf_input_t const* st, uint8_t* report)
+{
+    hid_report_layout_t const* l = &st->kb;
+    uint16_t base = layout_base(l);
+    if (l->kb_has_mods)
+    {
+        uint8_t mods = (uint8_t)hid_field_read(report, (uint16_t)(base + l->kb_mods_offset_bits), 8);
+        hid_field_write(report, (uint16_t)(base + l->kb_mods_offset_bits), 8, mods | st->inj_mods);
+    }
+
+    for (uint8_t k = 0; k < st->inj_count; k++)
+    {
+        uint8_t usage = st->inj_keys[k];
+        if (l->kb_keys_bitmap)
+        {
+            if (usage >= l->kb_keys_usage_min && usage - l->kb_keys_usage_min < l->kb_keys_count)
+            {
+                hid_field_write(report, (uint16_t)(base + l->kb_keys_offset_bits + (usage - l->kb_keys_usage_min)), 1, 1);
+            }
+            continue;
+        }
+
+        int free_slot = -1;
+        bool present = false;
+        for (uint8_t s = 0; s < l->kb_keys_count; s++)
+        {
+            uint16_t off = (uint16_t)(base + l->kb_keys_offset_bits + s * l->kb_keys_size_bits);
+            uint32_t v = hid_field_read(report, off, l->kb_keys_size_bits);
+            if (v == usage) present = true;
+            if (v == 0 && free_slot < 0) free_slot = s;
+            if (v == USAGE_ERROR_ROLLOVER) return;
+        }
+        if (present) continue;
+        if (free_slot < 0)
+        {
+            // More keys than array slots: ErrorRollOver in every slot, as a
+            // physical 6KRO keyboard reports it; modifiers stay valid.
+            for (uint8_t s = 0; s < l->kb_keys_count; s++)
+            {
+                hid_field_write(report, (uint16_t)(base + l->kb_keys_offset_bits + s * l->kb_keys_size_bits),
+                                l->kb_keys_size_bits, USAGE_ERROR_ROLLOVER);
+            }
+            return;
+        }
+        hid_field_write(report, (uint16_t)(base + l->kb_keys_offset_bits + free_slot * l->kb_keys_size_bits),
+                        l->kb_keys_size_bits, usage);
+    }
+}
+
+static void merge_mouse(itf_input_t const* st, uint8_t* report)
+{
+    hid_report_layout_t const* l = &st->mouse;
+    if (!(l->flags & 0x01)) return;
+    uint16_t base = layout_base(l);
+    uint8_t count = l->buttons_count > 8 ? 8 : l->buttons_count;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (st->inj_buttons & (1u << i))
+        {
+            hid_field_write(report, (uint16_t)(base + l->buttons_offset_bits + i * l->buttons_size_bits),
+                            l->buttons_size_bits, 1);
+        }
+    }
+}
+
+// Physical state plus injected state; a mouse report carries no motion. With
+// the mixer on, the report holds the injected state only and the mixer adds
+// the physical one.
+static bool send_synth(uint8_t itf, itf_input_t* st, bool kb)
+{
+    hid_report_layout_t const* l = kb ? &st->kb : &st->mouse;
+    uint8_t const* phys = kb ? st->phys_kb : st->phys_mouse;
+    uint8_t phys_len = kb ? st->phys_kb_len : st->phys_mouse_len;
+    uint16_t len = layout_len(l);
+
+    uint8_t report[INPUT_STATE_REPORT_MAX];
+    memset(report, 0, sizeof(report));
+    if (phys_len == len && !input_mixer_active(itf)) memcpy(report, phys, len);
+    else if (l->kb_has_report_id) report[0] = l->report_id;
+
+    if (kb)
+    {
+        merge_kb(st, report);
+    }
+    else
+    {
+        uint16_t base = layout_base(l);
+        hid_field_write(report, (uint16_t)(base + l->x_offset_bits), l->x_size_bits, 0);
+        hid_field_write(report, (uint16_t)(base + l->y_offset_bits), l->y_size_bits, 0);
+        if (l->flags & 0x02) hid_field_write(report, (uint16_t)(base + l->wheel_offset_bits), l->wheel_size_bits, 0);
+        merge_mouse(st, report);
+    }
+    return hid_proxy_host_inject_report(itf, report, len);
+}
+
+input_state_result_t input_state_keys(uint8_t itf_sel, bool down, uint8_t const* usages, uint8_t count,
+                                      uint8_t* itf_out)
+{
+    int itf = hid_proxy_host_resolve_inject_itf(itf_sel);
+    if (itf < 0 || itf >= CFG_TUH_HID) return INPUT_STATE_ERR_ITF;
+    if (itf_out) *itf_out = (uint8_t)itf;
+    itf_input_t* st = state_for((uint8_t)itf);
+    if (!st->has_kb) return INPUT_STATE_ERR_LAYOUT;
+
+    uint8_t saved_mods = st->inj_mods;
+    uint8_t saved_count = st->inj_count;
+    uint8_t saved_keys[PROXY_INPUT_STATE_MAX_KEYS];
+    memcpy(saved_keys, st->inj_keys, sizeof(saved_keys));
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint8_t usage = usages[i];
+        if (usage >= 0xE0 && usage <= 0xE7)
+        {
+            uint8_t bit = (uint8_t)(1u << (usage - 0xE0));
+            if (down) st->inj_mods |= bit;
+            else st->inj_mods &= (uint8_t)~bit;
+            continue;
+        }
+        if (usage < USAGE_FIRST_KEY) continue;
+
+        uint8_t k = 0;
+        while (k < st->inj_count && st->inj_keys[k] != usage) k++;
+        if (down && k == st->inj_count)
+        {
+            if (st->inj_count >= PROXY_INPUT_STATE_MAX_KEYS)
+            {
+                st->inj_mods = saved_mods;
+                st->inj_count = saved_count;
+                memcpy(st->inj_keys, saved_keys, sizeof(saved_keys));
+                return INPUT_STATE_ERR_FULL;
+            }
+            st->inj_keys[st->inj_count++] = usage;
+        }
+        else if (!down && k < st->inj_count)
+        {
+            memmove(&st->inj_keys[k], &st->inj_keys[k + 1], (size_t)(st->inj_count - k - 1u));
+            st->inj_count--;
+        }
+    }
+
+    if (!send_synth((uint8_t)itf, st, true))
+    {
+        st->inj_mods = saved_mods;
+        st->inj_count = saved_count;
+        memcpy(st->inj_keys, saved_keys, sizeof(saved_keys));
+        return INPUT_STATE_ERR_ITF;
+    }
+    return INPUT_STATE_OK;
+}
+
+input_state_result_t input_state_buttons(uint8_t itf_sel, bool down, uint8_t mask, uint8_t* itf_out)
+{
+    int itf = hid_proxy_host_resolve_inject_itf(itf_sel);
+    if (itf < 0 || itf >= CFG_TUH_HID) return INPUT_STATE_ERR_ITF;
+    if (itf_out) *itf_out = (uint8_t)itf;
+    itf_input_t* st = state_for((uint8_t)itf);
+    if (!st->has_mouse) return INPUT_STATE_ERR_LAYOUT;
+
+    uint8_t saved = st->inj_buttons;
+    if (down) st->inj_buttons |= mask;
+    else st->inj_buttons &= (uint8_t)~mask;
+    if (!send_synth((uint8_t)itf, st, false))
+    {
+        st->inj_buttons = saved;
+        return INPUT_STATE_ERR_ITF;
+    }
+    return INPUT_STATE_OK;
+}
+
+static bool release_one(uint8_t itf)
+{
+    itf_input_t* st = state_for(itf);
+    st->inj_mods = 0;
+    st->inj_buttons = 0;
+    st->inj_count = 0;
+    st->phys_kb_len = 0;
+    st->phys_mouse_len = 0;
+
+    bool ok = true;
+    if (st->has_kb) ok = send_synth(itf, st, true) && ok;
+    if (st->has_mouse) ok = send_synth(itf, st, false) && ok;
+    return ok;
+}
+
+input_state_result_t input_state_release_all(uint8_t itf_sel)
+{
+    if (itf_sel != INPUT_STATE_ITF_ALL)
+    {
+        int itf = hid_proxy_host_resolve_inject_itf(itf_sel);
+        if (itf < 0 || itf >= CFG_TUH_HID) return INPUT_STATE_ERR_ITF;
+        return release_one((uint8_t)itf) ? INPUT_STATE_OK : INPUT_STATE_ERR_ITF;
+    }
+
+    bool any = false;
+    bool ok = true;
+    for (uint8_t i = 0; i < CFG_TUH_HID; i++)
+    {
+        if (hid_proxy_host_resolve_inject_itf(i) != (int)i) continue;
+        any = true;
+        ok = release_one(i) && ok;
+    }
+    LOGI("[KEY] release all: %s", any ? (ok ? "ok" : "partial") : "no interface");
+    return (any && ok) ? INPUT_STATE_OK : INPUT_STATE_ERR_ITF;
+}
+
+bool input_state_get(uint8_t itf, input_state_view_t* out)
+{
+    if (itf >= CFG_TUH_HID || !out) return false;
+    itf_input_t* st = state_for(itf);
+
+    memset(out, 0, sizeof(*out));
+    out->itf = itf;
+    out->inj_mods = st->inj_mods;
+    out->inj_buttons = st->inj_buttons;
+    out->inj_count = st->inj_count;
+    memcpy(out->inj_keys, st->inj_keys, st->inj_count);
+
+    hid_report_layout_t const* l = &st->kb;
+    if (st->has_kb && st->phys_kb_len == layout_len(l))
+    {
+        uint16_t base = layout_base(l);
+        if (l->kb_has_mods) out->phys_mods = (uint8_t)hid_field_read(st->phys_kb, (uint16_t)(base + l->kb_mods_offset_bits), 8);
+        for (uint16_t s = 0; s < l->kb_keys_count && out->phys_count < INPUT_STATE_PHYS_KEYS; s++)
+        {
+            if (l->kb_keys_bitmap)
+            {
+                if (hid_field_read(st->phys_kb, (uint16_t)(base + l->kb_keys_offset_bits + s), 1))
+                {
+                    out->phys_keys[out->phys_count++] = (uint8_t)(l->kb_keys_usage_min + s);
+                }
+                continue;
+            }
+            uint32_t v = hid_field_read(st->phys_kb, (uint16_t)(base + l->kb_keys_offset_bits + s * l->kb_keys_size_bits),
+                                        l->kb_keys_size_bits);
+            if (v >= USAGE_FIRST_KEY && v < 0xE0) out->phys_keys[out->phys_count++] = (uint8_t)v;
+        }
+    }
+
+    l = &st->mouse;
+    if (st->has_mouse && (l->flags & 0x01) && st->phys_mouse_len == layout_len(l))
+    {
+        uint8_t count = l->buttons_count > 8 ? 8 : l->buttons_count;
+        for (uint8_t i = 0; i < count; i++)
+        {
+            if (hid_field_read(st->phys_mouse, (uint16_t)(layout_base(l) + l->buttons_offset_bits + i * l->buttons_size_bits), 1))
+            {
+                out->phys_buttons |= (uint8_t)(1u << i);
+            }
+        }
+    }
+    return true;
+}
+
+uint8_t const* input_state_on_physical(uint8_t itf, uint8_t const* report, uint16_t len, uint8_t* scratch)
+{
+    if (itf >= CFG_TUH_HID || len > INPUT_STATE_REPORT_MAX) return report;
+    itf_input_t* st = state_for(itf);
+
+    if (st->has_kb && role_match(&st->kb, report, len))
+    {
+        memcpy(st->phys_kb, report, len);
+        st->phys_kb_len = (uint8_t)len;
+        if ((!st->inj_mods && !st->inj_count) || input_mixer_active(itf)) return report;
+        memset(scratch, 0, INPUT_STATE_REPORT_MAX);
+        memcpy(scratch, report, len);
+        merge_kb(st, scratch);
+        return scratch;
+    }
+    if (st->has_mouse && role_match(&st->mouse, report, len))
+    {
+        memcpy(st->phys_mouse, report, len);
+        st->phys_mouse_len = (uint8_t)len;
+        if (!st->inj_buttons || input_mixer_active(itf)) return report;
+        memset(scratch, 0, INPUT_STATE_REPORT_MAX);
+        memcpy(scratch, report, len);
+        merge_mouse(st, scratch);
+        return scratch;
+    }
+    return report;
+}
+
+void input_state_layouts(uint8_t itf, hid_report_layout_t const** kb, hid_report_layout_t const** mouse)
+{
+    *kb = NULL;
+    *mouse = NULL;
+    if (itf >= CFG_TUH_HID) return;
+    itf_input_t* st = state_for(itf);
+    if (st->has_kb) *kb = &st->kb;
+    if (st->has_mouse) *mouse = &st->mouse;
+}
+
+void input_state_reset_itf(uint8_t itf)
+{
+    if (itf >= CFG_TUH_HID) return;
+    memset(&s_in[itf], 0, sizeof(s_in[itf]));
+}
@@ -0,0 +1,62 @@
+#ifndef INPUT_STATE_H
+#define INPUT_STATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "proxy_config.h"
+#include "hid_proxy_host.h"
+#include "hid_fields.h"
+
+// Per-interface input state (KEY, cmd 0x15). Keys, modifiers and mouse
+// buttons held through KEY_DOWN / BUTTON_DOWN are kept on B_host and merged
+// into every report the interface sends, physical ones included, so a
+// physical report no longer drops an injected Ctrl and an injected key no
+// longer drops the physically held Shift. Raw INJECT_REPORT bypasses it.
+
+#define INPUT_STATE_ITF_ALL      0xFDu  // RELEASE_ALL: every interface
+#define INPUT_STATE_REPORT_MAX   HID_FIELD_REPORT_MAX
+#define INPUT_STATE_PHYS_KEYS    16u
+
+typedef enum
+{
+    INPUT_STATE_OK         = 0,
+    INPUT_STATE_ERR_ITF    = 1,  // no ready interface, or the report did not go out
+    INPUT_STATE_ERR_LAYOUT = 2,  // interface has no keyboard (keys) or pointer (buttons)
+    INPUT_STATE_ERR_FULL   = 3   // PROXY_INPUT_STATE_MAX_KEYS keys already held
+} input_state_result_t;
+
+typedef struct
+{
+    uint8_t itf;
+    uint8_t inj_mods;
+    uint8_t inj_buttons;
+    uint8_t inj_count;
+    uint8_t inj_keys[PROXY_INPUT_STATE_MAX_KEYS];
+    uint8_t phys_mods;
+    uint8_t phys_buttons;
+    uint8_t phys_count;
+    uint8_t phys_keys[INPUT_STATE_PHYS_KEYS];
+} input_state_view_t;
+
+// Usages E0..E7 act on the modifier byte. Each call sends one report built
+// from the physical state plus the injected one; the state is rolled back
+// when that report cannot be sent.
+input_state_result_t input_state_keys(uint8_t itf_sel, bool down, uint8_t const* usages, uint8_t count,
+                                      uint8_t* itf_out);
+input_state_result_t input_state_buttons(uint8_t itf_sel, bool down, uint8_t mask, uint8_t* itf_out);
+// Forgets injected state and sends all-released reports, which also clears
+// keys the target host believes held after a lost physical release.
+input_state_result_t input_state_release_all(uint8_t itf_sel);
+bool input_state_get(uint8_t itf, input_state_view_t* out);
+
+// Forward path of a physical report: records it as the physical state and
+// returns the report to send, `scratch` when injected state had to be merged.
+uint8_t const* input_state_on_physical(uint8_t itf, uint8_t const* report, uint16_t len, uint8_t* scratch);
+// Cached keyboard and pointer layouts of the interface (NULL when it has no
+// such role); the input mixer shares them.
+void input_state_layouts(uint8_t itf, hid_report_layout_t const** kb, hid_report_layout_t const** mouse);
+// Descriptor changed or interface gone.
+void input_state_reset_itf(uint8_t itf);
+
+#endif // INPUT_STATE_H
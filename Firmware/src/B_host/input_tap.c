@@ -0,0 +1,122 @@
+#include "input_tap.h"
+
+#include <string.h>
+
+#include "proxy_config.h"
+
+typedef struct
+{
+    uint32_t t_us;
+    uint16_t seq;
+    uint8_t  itf;
+    uint8_t  flags;
+    uint8_t  len;
+    uint8_t  report[INPUT_TAP_REPORT_MAX];
+} tap_slot_t;
+
+// Written by hid_proxy_host_on_report() and drained by control_uart_task();
+// both run in the main loop, so the ring needs no locking.
+static tap_slot_t        s_tap_ring[PROXY_INPUT_TAP_DEPTH];
+static uint16_t          s_tap_head  = 0;   // oldest entry
+static uint16_t          s_tap_count = 0;
+static uint16_t          s_tap_seq   = 0;   // every captured report, dropped or not
+static input_tap_mode_t  s_tap_mode  = INPUT_TAP_OFF;
+static input_tap_stats_t s_tap_stats;
+
+void input_tap_set_mode(input_tap_mode_t mode)
+{
+    s_tap_head  = 0;
+    s_tap_count = 0;
+    s_tap_seq   = 0;
+    memset(&s_tap_stats, 0, sizeof(s_tap_stats));
+    s_tap_mode = mode;
+}
+
+input_tap_mode_t input_tap_mode(void)
+{
+    return s_tap_mode;
+}
+
+void input_tap_record(uint8_t itf, uint8_t flags, uint32_t t_us,
+                      uint8_t const* report, uint16_t len)
+{
+    if (s_tap_mode == INPUT_TAP_OFF) return;
+
+    s_tap_stats.captured++;
+    uint16_t seq = s_tap_seq++;
+
+    if (s_tap_count == PROXY_INPUT_TAP_DEPTH)
+    {
+        if (s_tap_mode == INPUT_TAP_DROP_NEWEST)
+        {
+            s_tap_stats.dropped_newest++;
+            return;
+        }
+        s_tap_head = (uint16_t)((s_tap_head + 1u) % PROXY_INPUT_TAP_DEPTH);
+        s_tap_count--;
+        s_tap_stats.dropped_oldest++;
+    }
+
+    if (len > INPUT_TAP_REPORT_MAX)
+    {
+        len = INPUT_TAP_REPORT_MAX;
+        flags |= INPUT_TAP_FLAG_TRUNCATED;
+    }
+
+    tap_slot_t* slot = &s_tap_ring[(s_tap_head + s_tap_count) % PROXY_INPUT_TAP_DEPTH];
+    slot->t_us  = t_us;
+    slot->seq   = seq;
+    slot->itf   = itf;
+    slot->flags = flags;
+    slot->len   = (uint8_t)len;
+    if (len) memcpy(slot->report, report, len);
+
+    s_tap_count++;
+    if (s_tap_count > s_tap_stats.high_water) s_tap_stats.high_water = s_tap_count;
+}
+
+uint16_t input_tap_drain(uint8_t* out, uint16_t max, uint8_t* count)
+{
+    uint16_t pos = 0;
+    uint8_t n = 0;
+    while (s_tap_count && n < UINT8_MAX)
+    {
+        tap_slot_t* slot = &s_tap_ring[s_tap_head];
+        if (pos + INPUT_TAP_ENTRY_HDR + slot->len > max) break;
+
+        out[pos++] = (uint8_t)(slot->t_us & 0xFF);
+        out[pos++] = (uint8_t)((slot->t_us >> 8) & 0xFF);
+        out[pos++] = (uint8_t)((slot->t_us >> 16) & 0xFF);
+        out[pos++] = (uint8_t)((slot->t_us >> 24) & 0xFF);
+        out[pos++] = (uint8_t)(slot->seq & 0xFF);
+        out[pos++] = (uint8_t)(slot->seq >> 8);
+        out[pos++] = slot->itf;
+        out[pos++] = slot->flags;
+        out[pos++] = slot->len;
+        memcpy(&out[pos], slot->report, slot->len);
+        pos = (uint16_t)(pos + slot->len);
+
+        s_tap_head = (uint16_t)((s_tap_head + 1u) % PROXY_INPUT_TAP_DEPTH);
+        s_tap_count--;
+        s_tap_stats.drained++;
+        n++;
+    }
+    if (count) *count = n;
+    return pos;
+}
+
+bool input_tap_oldest_us(uint32_t* t_us)
+{
+    if (!s_tap_count) return false;
+    if (t_us) *t_us = s_tap_ring[s_tap_head].t_us;
+    return true;
+}
+
+void input_tap_get_stats(input_tap_stats_t* out)
+{
+    if (!out) return;
+    *out = s_tap_stats;
+    out->used  = s_tap_count;
+    out->depth = PROXY_INPUT_TAP_DEPTH;
+    out->mode  = (uint8_t)s_tap_mode;
+}
@@ -0,0 +1,55 @@
+#ifndef INPUT_TAP_H
+#define INPUT_TAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Physical input tap: copies of the reports B_host captures from the real
+// device, queued for the control UART (TAP, cmd 0x0E). Recording is a memcpy
+// into a fixed slot ring after the report has been forwarded to A_device.
+
+#define INPUT_TAP_REPORT_MAX   64u
+// Wire entry: t_us LE32, seq LE16, itf, flags, len, report[len].
+#define INPUT_TAP_ENTRY_HDR    9u
+
+#define INPUT_TAP_FLAG_FORWARDED 0x01  // report went to A_device
+#define INPUT_TAP_FLAG_TRUNCATED 0x02  // report longer than INPUT_TAP_REPORT_MAX
+#define INPUT_TAP_FLAG_MIXED     0x04  // held by the input mixer, sent merged later
+
+typedef enum
+{
+    INPUT_TAP_OFF         = 0,
+    INPUT_TAP_DROP_OLDEST = 1,  // full ring: overwrite the oldest entry
+    INPUT_TAP_DROP_NEWEST = 2   // full ring: discard the new report
+} input_tap_mode_t;
+
+typedef struct
+{
+    uint32_t captured;        // reports offered to the tap while enabled
+    uint32_t dropped_oldest;  // entries overwritten before they were drained
+    uint32_t dropped_newest;  // reports refused because the ring was full
+    uint32_t drained;         // entries encoded for the control UART
+    uint16_t used;            // entries waiting right now
+    uint16_t high_water;      // max entries waiting since the tap was enabled
+    uint16_t depth;
+    uint8_t  mode;
+} input_tap_stats_t;
+
+// Switching the mode (including OFF) clears the ring and the counters.
+void input_tap_set_mode(input_tap_mode_t mode);
+input_tap_mode_t input_tap_mode(void);
+
+// Called by hid_proxy_host for every captured report; cheap when disabled.
+void input_tap_record(uint8_t itf, uint8_t flags, uint32_t t_us,
+                      uint8_t const* report, uint16_t len);
+
+// Moves whole entries into `out` (wire format above) until `max` is reached.
+// Returns the bytes written and the number of entries in `*count`.
+uint16_t input_tap_drain(uint8_t* out, uint16_t max, uint8_t* count);
+
+// Arrival time of the oldest waiting entry; false when the ring is empty.
+bool input_tap_oldest_us(uint32_t* t_us);
+
+void input_tap_get_stats(input_tap_stats_t* out);
+
+#endif // INPUT_TAP_H
@@ -7,18 +7,32 @@
 #include "proxy_config.h"
 #include "uart_transport.h"
 #include "control_uart.h"
+#include "replay.h"
+#include "inject_sched.h"
+#include "pointer_move.h"
+#include "text_type.h"
+#include "input_mixer.h"
+#include "metrics.h"
+#include "pio_link.h"
 
 int main(void)
 {
     stdio_init_all();
     board_init();
+    metrics_init();
 
     LOGI("[BOOT] B_host: starting...");
 
     uart_transport_init_host();//0, I2C_SDA_PIN, I2C_SCL_PIN, PROXY_I2C_ADDR, I2C_BAUD);
+    if (PROXY_FANOUT_TARGETS > 1)
+    {
+        pio_link_init(PROXY_FANOUT_TARGETS - 1u);
+    }
     control_uart_init();
     hid_host_init();
     hid_proxy_host_init();
+    replay_init();
+    inject_sched_init();
 
     tusb_init();
 
@@ -27,6 +41,10 @@ int main(void)
         control_uart_task();
         tuh_task();
         hid_proxy_host_task();
+        pointer_move_task();
+        text_type_task();
+        input_mixer_task();
+        logging_task();
     }
 
     return 0;
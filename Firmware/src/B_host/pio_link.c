@@ -0,0 +1,205 @@
+#define LOG_MODULE LOG_MOD_LINK
+
+#include "pio_link.h"
+
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+#include "logging.h"
+#include "proxy_config.h"
+#include "proto_frame.h"
+#include "uart_transport.h"
+#include "pio_link.pio.h"
+
+#define PIO_LINK_RING_SIZE 2048u   // power of two
+
+#define SLIP_END     0xC0
+#define SLIP_ESC     0xDB
+#define SLIP_ESC_END 0xDC
+#define SLIP_ESC_ESC 0xDD
+
+typedef struct
+{
+    PIO      pio;
+    uint     sm_tx;
+    uint     sm_rx;
+    uint8_t  ring[PIO_LINK_RING_SIZE];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    uint32_t overflow;
+    uint8_t  frame[PROTO_MAX_FRAME_SIZE];
+    uint16_t frame_len;
+    bool     esc;
+    volatile bool tx_busy;
+} pio_link_t;
+
+static pio_link_t s_links[PIO_LINK_MAX];
+static uint8_t    s_count;
+
+static void link_drain(pio_link_t* l)
+{
+    while (!pio_sm_is_rx_fifo_empty(l->pio, l->sm_rx))
+    {
+        uint8_t  b    = (uint8_t)(pio_sm_get(l->pio, l->sm_rx) >> 24);
+        uint32_t next = (l->head + 1u) & (PIO_LINK_RING_SIZE - 1u);
+        if (next == l->tail)
+        {
+            // Drop the newest byte; the frame CRC catches the hole.
+            l->overflow++;
+            continue;
+        }
+        l->ring[l->head] = b;
+        l->head = next;
+    }
+}
+
+static void __isr pio_link_irq(void)
+{
+    for (uint8_t i = 0; i < s_count; i++)
+    {
+        link_drain(&s_links[i]);
+    }
+}
+
+void pio_link_init(uint8_t links)
+{
+    if (links > PIO_LINK_MAX) links = PIO_LINK_MAX;
+    s_count = links;
+
+    int offset_tx[2] = { -1, -1 };
+    int offset_rx[2] = { -1, -1 };
+    for (uint8_t i = 0; i < links; i++)
+    {
+        pio_link_t* l = &s_links[i];
+        memset(l, 0, sizeof(*l));
+        uint8_t block = i / 2u;
+        l->pio   = block ? pio1 : pio0;
+        l->sm_tx = (i % 2u) * 2u;
+        l->sm_rx = l->sm_tx + 1u;
+        if (offset_tx[block] < 0)
+        {
+            offset_tx[block] = (int)pio_add_program(l->pio, &pio_link_tx_program);
+            offset_rx[block] = (int)pio_add_program(l->pio, &pio_link_rx_program);
+        }
+
+        uint pin_tx = PROXY_FANOUT_PIO_PIN_BASE + 2u * i;
+        pio_sm_claim(l->pio, l->sm_tx);
+        pio_sm_claim(l->pio, l->sm_rx);
+        pio_link_tx_program_init(l->pio, l->sm_tx, (uint)offset_tx[block], pin_tx, PROXY_FANOUT_PIO_BAUD);
+        pio_link_rx_program_init(l->pio, l->sm_rx, (uint)offset_rx[block], pin_tx + 1u, PROXY_FANOUT_PIO_BAUD);
+        pio_set_irq0_source_enabled(l->pio, (enum pio_interrupt_source)(pis_sm0_rx_fifo_not_empty + l->sm_rx), true);
+
+        LOGI("[PIO] link %u (target %u) on pio%u TX=%u RX=%u @%u baud",
+             i, i + 1u, block, pin_tx, pin_tx + 1u, PROXY_FANOUT_PIO_BAUD);
+    }
+
+    if (links)
+    {
+        irq_set_exclusive_handler(PIO0_IRQ_0, pio_link_irq);
+        irq_set_enabled(PIO0_IRQ_0, true);
+    }
+    if (links > 2)
+    {
+        irq_set_exclusive_handler(PIO1_IRQ_0, pio_link_irq);
+        irq_set_enabled(PIO1_IRQ_0, true);
+    }
+}
+
+static inline void put_byte(pio_link_t* l, uint8_t b)
+{
+    pio_sm_put_blocking(l->pio, l->sm_tx, b);
+}
+
+static void put_frame(pio_link_t* l, uint8_t const* data, uint16_t len)
+{
+    put_byte(l, SLIP_END);
+    for (uint16_t i = 0; i < len; i++)
+    {
+        uint8_t b = data[i];
+        if (b == SLIP_END)
+        {
+            put_byte(l, SLIP_ESC);
+            put_byte(l, SLIP_ESC_END);
+        }
+        else if (b == SLIP_ESC)
+        {
+            put_byte(l, SLIP_ESC);
+            put_byte(l, SLIP_ESC_ESC);
+        }
+        else
+        {
+            put_byte(l, b);
+        }
+    }
+    put_byte(l, SLIP_END);
+}
+
+int pio_link_send(uint8_t link, uint8_t const* data, uint16_t len)
+{
+    if (link >= s_count) return -1;
+    if (!data || !len) return 0;
+
+    pio_link_t* l = &s_links[link];
+    l->tx_busy = true;
+    put_frame(l, data, len);
+    l->tx_busy = false;
+    return (int)len;
+}
+
+int pio_link_send_from_isr(uint8_t link, uint8_t const* data, uint16_t len)
+{
+    if (link >= s_count) return -1;
+    if (!data || !len) return 0;
+
+    pio_link_t* l = &s_links[link];
+    if (l->tx_busy) return UART_TRANSPORT_BUSY;
+    put_frame(l, data, len);
+    return (int)len;
+}
+
+int pio_link_recv_frame(uint8_t link, uint8_t* data, uint16_t maxlen)
+{
+    if (link >= s_count || !data || !maxlen) return -1;
+
+    pio_link_t* l = &s_links[link];
+    while (l->tail != l->head)
+    {
+        uint8_t b = l->ring[l->tail];
+        l->tail = (l->tail + 1u) & (PIO_LINK_RING_SIZE - 1u);
+
+        if (b == SLIP_END)
+        {
+            if (!l->frame_len) continue;
+            uint16_t n = l->frame_len < maxlen ? l->frame_len : maxlen;
+            memcpy(data, l->frame, n);
+            l->frame_len = 0;
+            l->esc = false;
+            return (int)n;
+        }
+        if (b == SLIP_ESC)
+        {
+            l->esc = true;
+            continue;
+        }
+        if (l->esc)
+        {
+            if (b == SLIP_ESC_END)      b = SLIP_END;
+            else if (b == SLIP_ESC_ESC) b = SLIP_ESC;
+            l->esc = false;
+        }
+        if (l->frame_len < sizeof(l->frame))
+        {
+            l->frame[l->frame_len++] = b;
+        }
+        else
+        {
+            LOGW("[PIO] link %u RX frame overflow, dropped", link);
+            l->frame_len = 0;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,20 @@
+#ifndef PIO_LINK_H
+#define PIO_LINK_H
+
+#include <stdint.h>
+
+// Extra B_host -> A_device links for PROXY_FANOUT_TARGETS > 1: SLIP frames
+// over PIO UARTs, same framing as uart_transport but no flow control. Link n
+// serves fan-out target n + 1 (PROXY_FANOUT_PIO_PIN_BASE pins); two links per
+// PIO block.
+
+#define PIO_LINK_MAX 3u
+
+void pio_link_init(uint8_t links);
+int  pio_link_send(uint8_t link, uint8_t const* data, uint16_t len);
+// IRQ context: UART_TRANSPORT_BUSY while the main loop is writing a frame.
+int  pio_link_send_from_isr(uint8_t link, uint8_t const* data, uint16_t len);
+// One decoded SLIP frame; 0 when none is complete yet.
+int  pio_link_recv_frame(uint8_t link, uint8_t* data, uint16_t maxlen);
+
+#endif // PIO_LINK_H
@@ -0,0 +1,212 @@
+#include "pointer_move.h"
+
+#include <string.h>
+
+#include "pico/stdlib.h"
+
+#include "logging.h"
+#include "proxy_config.h"
+#include "hid_proxy_host.h"
+#include "descriptor_logger.h"
+#include "hid_fields.h"
+
+#define MOVE_REPORT_MAX HID_FIELD_REPORT_MAX
+
+typedef struct
+{
+    bool     active;
+    bool     has_layout;
+    hid_report_layout_t layout;
+    uint8_t  itf;
+    uint8_t  buttons;
+    int8_t   wheel;          // pending until the first report
+    int32_t  step_max;       // per report and axis
+    uint16_t home_left;      // MOVE_TO homing reports still to send
+    int32_t  total_x;
+    int32_t  total_y;
+    int32_t  done_x;
+    int32_t  done_y;
+    uint32_t steps;
+    uint32_t step_i;
+    uint32_t next_us;
+    uint16_t interval_us;
+    uint32_t sent;
+    uint32_t failed;
+} pointer_move_state_t;
+
+static pointer_move_state_t s_move;
+
+static int32_t axis_limit(uint8_t size_bits)
+{
+    if (size_bits < 2) return 1;
+    if (size_bits > 16) return 32767;
+    return (int32_t)((1u << (size_bits - 1u)) - 1u);
+}
+
+static int32_t clamp_axis(int32_t v, int32_t lim)
+{
+    if (v > lim) return lim;
+    if (v < -lim) return -lim;
+    return v;
+}
+
+static uint16_t build_report(uint8_t* report, int32_t dx, int32_t dy, int32_t wheel)
+{
+    memset(report, 0, MOVE_REPORT_MAX);
+    if (!s_move.has_layout)
+    {
+        // No parsed descriptor: boot mouse (buttons, x, y, wheel).
+        report[0] = s_move.buttons;
+        report[1] = (uint8_t)(int8_t)clamp_axis(dx, 127);
+        report[2] = (uint8_t)(int8_t)clamp_axis(dy, 127);
+        report[3] = (uint8_t)(int8_t)clamp_axis(wheel, 127);
+        return 4;
+    }
+
+    hid_report_layout_t const* l = &s_move.layout;
+    uint16_t max_bit = (uint16_t)(l->x_offset_bits + l->x_size_bits);
+    uint16_t y_end = (uint16_t)(l->y_offset_bits + l->y_size_bits);
+    if (y_end > max_bit) max_bit = y_end;
+    uint16_t buttons_bits = (uint16_t)(l->buttons_count * l->buttons_size_bits);
+    if ((l->flags & 0x01) && l->buttons_offset_bits + buttons_bits > max_bit)
+    {
+        max_bit = (uint16_t)(l->buttons_offset_bits + buttons_bits);
+    }
+    if ((l->flags & 0x02) && l->wheel_offset_bits + l->wheel_size_bits > max_bit)
+    {
+        max_bit = (uint16_t)(l->wheel_offset_bits + l->wheel_size_bits);
+    }
+
+    uint16_t base = 0;
+    if (l->report_id)
+    {
+        report[0] = l->report_id;
+        base = 8;
+    }
+    uint16_t len = (uint16_t)(base / 8u + (max_bit + 7u) / 8u);
+    if (len > MOVE_REPORT_MAX) len = MOVE_REPORT_MAX;
+
+    if (l->flags & 0x01)
+    {
+        uint8_t count = l->buttons_count > 8 ? 8 : l->buttons_count;
+        for (uint8_t i = 0; i < count; i++)
+        {
+            hid_field_write(report, (uint16_t)(base + l->buttons_offset_bits + i * l->buttons_size_bits),
+                            l->buttons_size_bits, (s_move.buttons >> i) & 1);
+        }
+    }
+    hid_field_write(report, (uint16_t)(base + l->x_offset_bits), l->x_size_bits, dx);
+    hid_field_write(report, (uint16_t)(base + l->y_offset_bits), l->y_size_bits, dy);
+    if (l->flags & 0x02)
+    {
+        hid_field_write(report, (uint16_t)(base + l->wheel_offset_bits), l->wheel_size_bits,
+                        clamp_axis(wheel, axis_limit(l->wheel_size_bits)));
+    }
+    return len;
+}
+
+pointer_move_result_t pointer_move_start(pointer_move_req_t const* req)
+{
+    memset(&s_move, 0, sizeof(s_move));
+    int itf = hid_proxy_host_resolve_inject_itf(req->itf_sel);
+    if (itf < 0) return POINTER_MOVE_ERR_ITF;
+
+    s_move.itf = (uint8_t)itf;
+    s_move.has_layout = hid_proxy_host_get_report_layout(s_move.itf, 0, &s_move.layout);
+    if (s_move.has_layout && (s_move.layout.flags & 0x0C) != 0x0C) return POINTER_MOVE_ERR_LAYOUT;
+
+    int32_t lim = 127;
+    if (s_move.has_layout)
+    {
+        int32_t lx = axis_limit(s_move.layout.x_size_bits);
+        int32_t ly = axis_limit(s_move.layout.y_size_bits);
+        lim = lx < ly ? lx : ly;
+    }
+    s_move.step_max = (req->max_step && req->max_step < lim) ? req->max_step : lim;
+
+    // Constant, small steps keep the host's pointer acceleration at one gain,
+    // so a calibrated scale maps units to pixels reliably.
+    int32_t scale = req->scale_q8 ? req->scale_q8 : 256;
+    s_move.total_x = (int32_t)(((int64_t)req->x * scale + (req->x < 0 ? -128 : 128)) / 256);
+    s_move.total_y = (int32_t)(((int64_t)req->y * scale + (req->y < 0 ? -128 : 128)) / 256);
+    int32_t span = s_move.total_x < 0 ? -s_move.total_x : s_move.total_x;
+    int32_t span_y = s_move.total_y < 0 ? -s_move.total_y : s_move.total_y;
+    if (span_y > span) span = span_y;
+    s_move.steps = (uint32_t)((span + s_move.step_max - 1) / s_move.step_max);
+    if (s_move.steps == 0) s_move.steps = 1;  // buttons / wheel only
+
+    s_move.home_left = (req->mode == POINTER_MOVE_TO) ? PROXY_MOVE_HOME_REPORTS : 0;
+    s_move.buttons = req->buttons;
+    s_move.wheel = req->wheel;
+
+    uint8_t poll_ms = descriptor_logger_poll_interval_ms(s_move.itf);
+    if (poll_ms > 65) poll_ms = 65;
+    s_move.interval_us = req->interval_us ? req->interval_us
+                       : (poll_ms ? (uint16_t)(poll_ms * 1000u) : PROXY_MOVE_DEFAULT_INTERVAL_US);
+    s_move.next_us = time_us_32();
+    s_move.active = true;
+
+    LOGT("[MOVE] itf=%u mode=%u total=(%ld,%ld) steps=%lu step=%ld interval=%u us",
+         s_move.itf, req->mode, (long)s_move.total_x, (long)s_move.total_y,
+         (unsigned long)s_move.steps, (long)s_move.step_max, s_move.interval_us);
+    return POINTER_MOVE_OK;
+}
+
+void pointer_move_stop(void)
+{
+    s_move.active = false;
+}
+
+void pointer_move_task(void)
+{
+    if (!s_move.active) return;
+    uint32_t now = time_us_32();
+    if ((int32_t)(now - s_move.next_us) < 0) return;
+
+    int32_t dx;
+    int32_t dy;
+    if (s_move.home_left)
+    {
+        dx = -s_move.step_max;
+        dy = -s_move.step_max;
+        s_move.home_left--;
+    }
+    else
+    {
+        // Even steps on the straight line: no jerky remainder at the end.
+        s_move.step_i++;
+        int32_t nx = (int32_t)((int64_t)s_move.total_x * s_move.step_i / s_move.steps);
+        int32_t ny = (int32_t)((int64_t)s_move.total_y * s_move.step_i / s_move.steps);
+        dx = nx - s_move.done_x;
+        dy = ny - s_move.done_y;
+        s_move.done_x = nx;
+        s_move.done_y = ny;
+    }
+
+    uint8_t report[MOVE_REPORT_MAX];
+    uint16_t len = build_report(report, dx, dy, s_move.wheel);
+    s_move.wheel = 0;
+    if (hid_proxy_host_inject_report(s_move.itf, report, len)) s_move.sent++;
+    else s_move.failed++;
+
+    if (!s_move.home_left && s_move.step_i >= s_move.steps)
+    {
+        s_move.active = false;
+        return;
+    }
+
+    // Catch up after a stall by one report, not a burst.
+    s_move.next_us += s_move.interval_us;
+    if ((int32_t)(now - s_move.next_us) >= 0) s_move.next_us = now + s_move.interval_us;
+}
+
+void pointer_move_get_status(pointer_move_status_t* out)
+{
+    if (!out) return;
+    uint32_t remaining = s_move.active ? s_move.home_left + (s_move.steps - s_move.step_i) : 0;
+    out->active      = s_move.active ? 1 : 0;
+    out->remaining   = remaining > UINT16_MAX ? UINT16_MAX : (uint16_t)remaining;
+    out->interval_us = s_move.interval_us;
+    out->sent        = s_move.sent;
+    out->failed      = s_move.failed;
+}
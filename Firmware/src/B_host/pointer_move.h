@@ -0,0 +1,54 @@
+#ifndef POINTER_MOVE_H
+#define POINTER_MOVE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Pointer motion engine (MOVE, cmd 0x12). Turns one "move by / move to"
+// request into a paced series of relative reports built from the interface's
+// parsed report layout, so the controller sends one frame per motion instead
+// of one per report.
+
+typedef enum
+{
+    POINTER_MOVE_BY = 0,  // relative motion
+    POINTER_MOVE_TO = 1   // home to the top-left corner, then move by (x, y)
+} pointer_move_mode_t;
+
+typedef enum
+{
+    POINTER_MOVE_OK          = 0,
+    POINTER_MOVE_ERR_ITF     = 1,  // no ready interface for the selector
+    POINTER_MOVE_ERR_LAYOUT  = 2   // interface has a layout without X/Y
+} pointer_move_result_t;
+
+typedef struct
+{
+    uint8_t  mode;          // pointer_move_mode_t
+    uint8_t  itf_sel;       // as INJECT_REPORT: number, 0xFF mouse, 0xFE keyboard
+    uint8_t  buttons;       // held in every report of the motion
+    int8_t   wheel;         // sent with the first report
+    int16_t  x;
+    int16_t  y;
+    uint8_t  max_step;      // counts per report and axis; 0 = axis limit
+    uint16_t scale_q8;      // counts per unit, 8.8 fixed point; 0 = 1.0
+    uint16_t interval_us;   // report spacing; 0 = endpoint poll interval
+} pointer_move_req_t;
+
+typedef struct
+{
+    uint8_t  active;
+    uint16_t remaining;     // reports still to send
+    uint16_t interval_us;
+    uint32_t sent;
+    uint32_t failed;
+} pointer_move_status_t;
+
+// Replaces any motion in progress.
+pointer_move_result_t pointer_move_start(pointer_move_req_t const* req);
+void pointer_move_stop(void);
+// Main-loop pacing; sends at most one report per call.
+void pointer_move_task(void);
+void pointer_move_get_status(pointer_move_status_t* out);
+
+#endif // POINTER_MOVE_H
@@ -0,0 +1,406 @@
+#include "replay.h"
+
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/timer.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+
+#include "crc16.h"
+#include "logging.h"
+#include "proxy_config.h"
+#include "uart_transport.h"
+#include "hid_proxy_host.h"
+
+#if PROXY_REPLAY_BUF_SIZE > 65535u
+#error "PROXY_REPLAY_BUF_SIZE must fit the 16-bit upload offsets"
+#endif
+
+// Flash copy: header page + buffer, in the last sectors of flash.
+#define REPLAY_FLASH_MAGIC  0x50524248u  // "HBRP"
+#define REPLAY_FLASH_HDR    16u
+#define REPLAY_FLASH_BYTES  (((REPLAY_FLASH_HDR + PROXY_REPLAY_BUF_SIZE) + FLASH_SECTOR_SIZE - 1u) & \
+                             ~(FLASH_SECTOR_SIZE - 1u))
+#define REPLAY_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - REPLAY_FLASH_BYTES)
+
+_Static_assert(REPLAY_FLASH_BYTES < PICO_FLASH_SIZE_BYTES, "PROXY_REPLAY_BUF_SIZE does not fit the flash");
+
+// End of the firmware image in flash (linker script).
+extern char __flash_binary_end;
+
+static bool flash_area_free(void)
+{
+    return (uintptr_t)&__flash_binary_end - XIP_BASE <= REPLAY_FLASH_OFFSET;
+}
+
+static uint8_t  s_buf[PROXY_REPLAY_BUF_SIZE];
+static uint16_t s_used = 0;
+static uint16_t s_events = 0;
+static uint32_t s_duration_us = 0;
+
+static volatile uint8_t s_state = REPLAY_IDLE;
+static uint8_t          s_sources = 0;
+static uint32_t         s_record_t0_us = 0;
+static uint32_t         s_record_dropped = 0;
+
+// Playback state; owned by the alarm IRQ while s_state == REPLAY_PLAYING.
+static int      s_alarm = -1;
+static uint16_t s_play_pos = 0;
+static uint16_t s_play_loops = 0;
+static uint16_t s_loops_done = 0;
+static uint32_t s_loop_period_us = 0;
+static uint64_t s_loop_start_us = 0;
+static uint32_t s_sent = 0;
+static uint32_t s_failed = 0;
+static uint32_t s_busy_retries = 0;
+static uint32_t s_late_max_us = 0;
+static uint64_t s_late_sum_us = 0;
+static uint32_t s_overruns = 0;
+
+static uint32_t le32_at(uint16_t pos)
+{
+    return (uint32_t)s_buf[pos] | ((uint32_t)s_buf[pos + 1] << 8) |
+           ((uint32_t)s_buf[pos + 2] << 16) | ((uint32_t)s_buf[pos + 3] << 24);
+}
+
+static void put_le32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)((v >> 8) & 0xFF);
+    p[2] = (uint8_t)((v >> 16) & 0xFF);
+    p[3] = (uint8_t)((v >> 24) & 0xFF);
+}
+
+// Walks the buffer: entries must end exactly at s_used, with sane lengths and
+// non-decreasing timestamps. Returns the entry count, 0 if malformed.
+static uint16_t count_entries(uint32_t* last_t_us)
+{
+    uint16_t pos = 0;
+    uint16_t n = 0;
+    uint32_t prev_t = 0;
+    while (pos < s_used)
+    {
+        if ((uint32_t)pos + REPLAY_ENTRY_HDR > s_used) return 0;
+        uint32_t t = le32_at(pos);
+        uint8_t len = s_buf[pos + 5];
+        if (len == 0 || len > REPLAY_REPORT_MAX || t < prev_t) return 0;
+        if ((uint32_t)pos + REPLAY_ENTRY_HDR + len > s_used) return 0;
+        prev_t = t;
+        pos = (uint16_t)(pos + REPLAY_ENTRY_HDR + len);
+        n++;
+    }
+    if (last_t_us) *last_t_us = prev_t;
+    return n;
+}
+
+static void replay_reset_play_stats(void)
+{
+    s_loops_done = 0;
+    s_sent = 0;
+    s_failed = 0;
+    s_busy_retries = 0;
+    s_late_max_us = 0;
+    s_late_sum_us = 0;
+    s_overruns = 0;
+}
+
+// Sends every entry that is due, then arms the alarm for the next one. Runs
+// in the alarm IRQ; loops when the next target is already in the past.
+static void replay_fire(void)
+{
+    while (s_state == REPLAY_PLAYING)
+    {
+        uint64_t next_us;
+        if (s_play_pos >= s_used)
+        {
+            s_loops_done++;
+            if (s_play_loops && s_loops_done >= s_play_loops)
+            {
+                s_state = REPLAY_IDLE;
+                return;
+            }
+            s_loop_start_us += s_loop_period_us;
+            s_play_pos = 0;
+        }
+
+        uint64_t target_us = s_loop_start_us + le32_at(s_play_pos);
+        uint64_t now_us = time_us_64();
+        if (target_us > now_us)
+        {
+            next_us = target_us;
+        }
+        else
+        {
+            uint8_t itf = s_buf[s_play_pos + 4];
+            uint8_t len = s_buf[s_play_pos + 5];
+            int rc = hid_proxy_host_send_input_isr(itf, &s_buf[s_play_pos + REPLAY_ENTRY_HDR], len);
+            if (rc == UART_TRANSPORT_BUSY)
+            {
+                // The main loop is mid-frame on the link and cannot finish it
+                // while this IRQ runs: keep the entry and come back shortly.
+                s_busy_retries++;
+                while (hardware_alarm_set_target((uint)s_alarm,
+                                                 from_us_since_boot(time_us_64() + PROXY_LINK_BUSY_RETRY_US)))
+                {
+                }
+                return;
+            }
+
+            uint32_t late = (uint32_t)(now_us - target_us);
+            if (rc < 0) s_failed++;
+            else s_sent++;
+            if (late > s_late_max_us) s_late_max_us = late;
+            if (late > PROXY_REPLAY_LATE_LIMIT_US) s_overruns++;
+            s_late_sum_us += late;
+            s_play_pos = (uint16_t)(s_play_pos + REPLAY_ENTRY_HDR + len);
+            continue;
+        }
+
+        // Returns true when the target was missed: handle it right here.
+        if (!hardware_alarm_set_target((uint)s_alarm, from_us_since_boot(next_us)))
+        {
+            return;
+        }
+    }
+}
+
+static void replay_alarm_cb(uint alarm_num)
+{
+    (void)alarm_num;
+    replay_fire();
+}
+
+void replay_init(void)
+{
+    s_alarm = hardware_alarm_claim_unused(false);
+    if (s_alarm < 0)
+    {
+        LOGW("[REPLAY] no free hardware alarm, playback disabled");
+        return;
+    }
+    if (!flash_area_free())
+    {
+        LOGW("[REPLAY] firmware image reaches the replay flash area at 0x%06lx, SAVE disabled",
+             (unsigned long)REPLAY_FLASH_OFFSET);
+    }
+    hardware_alarm_set_callback((uint)s_alarm, replay_alarm_cb);
+}
+
+replay_result_t replay_clear(uint32_t duration_us)
+{
+    if (s_state != REPLAY_IDLE) return REPLAY_ERR_STATE;
+    s_used = 0;
+    s_events = 0;
+    s_duration_us = duration_us;
+    s_record_dropped = 0;
+    replay_reset_play_stats();
+    return REPLAY_OK;
+}
+
+replay_result_t replay_append(uint16_t offset, uint8_t const* data, uint16_t len)
+{
+    if (s_state != REPLAY_IDLE) return REPLAY_ERR_STATE;
+    if ((uint32_t)offset + len > PROXY_REPLAY_BUF_SIZE || offset > s_used) return REPLAY_ERR_RANGE;
+
+    memcpy(&s_buf[offset], data, len);
+    if ((uint16_t)(offset + len) > s_used) s_used = (uint16_t)(offset + len);
+    s_events = count_entries(NULL);
+    return REPLAY_OK;
+}
+
+uint16_t replay_read(uint16_t offset, uint8_t* out, uint16_t max)
+{
+    if (offset >= s_used) return 0;
+    uint16_t n = (uint16_t)(s_used - offset);
+    if (n > max) n = max;
+    memcpy(out, &s_buf[offset], n);
+    return n;
+}
+
+replay_result_t replay_record_start(uint8_t sources)
+{
+    if (s_state != REPLAY_IDLE) return REPLAY_ERR_STATE;
+    sources &= (REPLAY_SRC_PHYSICAL | REPLAY_SRC_INJECTED);
+    if (!sources) sources = REPLAY_SRC_PHYSICAL;
+
+    s_used = 0;
+    s_events = 0;
+    s_duration_us = 0;
+    s_record_dropped = 0;
+    s_sources = sources;
+    s_record_t0_us = time_us_32();
+    s_state = REPLAY_RECORDING;
+    LOGI("[REPLAY] recording sources=0x%02X", sources);
+    return REPLAY_OK;
+}
+
+void replay_record_stop(void)
+{
+    if (s_state != REPLAY_RECORDING) return;
+    s_duration_us = time_us_32() - s_record_t0_us;
+    s_state = REPLAY_IDLE;
+    LOGI("[REPLAY] recorded events=%u bytes=%u duration=%lu us dropped=%lu",
+         s_events, s_used, (unsigned long)s_duration_us, (unsigned long)s_record_dropped);
+}
+
+void replay_record(uint8_t source, uint8_t itf, uint32_t t_us,
+                   uint8_t const* report, uint16_t len)
+{
+    if (s_state != REPLAY_RECORDING || !(s_sources & source)) return;
+
+    if (len == 0 || len > REPLAY_REPORT_MAX ||
+        (uint32_t)s_used + REPLAY_ENTRY_HDR + len > PROXY_REPLAY_BUF_SIZE ||
+        s_events == UINT16_MAX)
+    {
+        s_record_dropped++;
+        return;
+    }
+
+    uint8_t* e = &s_buf[s_used];
+    put_le32(e, t_us - s_record_t0_us);
+    e[4] = itf;
+    e[5] = (uint8_t)len;
+    memcpy(&e[REPLAY_ENTRY_HDR], report, len);
+    s_used = (uint16_t)(s_used + REPLAY_ENTRY_HDR + len);
+    s_events++;
+}
+
+bool replay_recording(uint8_t source)
+{
+    return s_state == REPLAY_RECORDING && (s_sources & source);
+}
+
+replay_result_t replay_play(uint16_t loops)
+{
+    if (s_state != REPLAY_IDLE || s_alarm < 0) return REPLAY_ERR_STATE;
+
+    uint32_t last_t = 0;
+    if (count_entries(&last_t) == 0) return REPLAY_ERR_FORMAT;
+
+    replay_reset_play_stats();
+    s_play_loops = loops;
+    s_play_pos = 0;
+    // A zero period would replay the same instant forever.
+    s_loop_period_us = s_duration_us > last_t ? s_duration_us : last_t + 1u;
+    s_loop_start_us = time_us_64() + PROXY_REPLAY_START_LEAD_US;
+    s_state = REPLAY_PLAYING;
+
+    if (hardware_alarm_set_target((uint)s_alarm, from_us_since_boot(s_loop_start_us + le32_at(0))))
+    {
+        uint32_t irq = save_and_disable_interrupts();
+        replay_fire();
+        restore_interrupts(irq);
+    }
+    LOGI("[REPLAY] play events=%u loops=%u period=%lu us",
+         s_events, loops, (unsigned long)s_loop_period_us);
+    return REPLAY_OK;
+}
+
+void replay_stop(void)
+{
+    if (s_state == REPLAY_RECORDING)
+    {
+        replay_record_stop();
+        return;
+    }
+    if (s_state != REPLAY_PLAYING) return;
+
+    uint32_t irq = save_and_disable_interrupts();
+    s_state = REPLAY_IDLE;
+    hardware_alarm_cancel((uint)s_alarm);
+    restore_interrupts(irq);
+}
+
+replay_result_t replay_save_flash(void)
+{
+    if (s_state != REPLAY_IDLE) return REPLAY_ERR_STATE;
+    if (!flash_area_free()) return REPLAY_ERR_FLASH;
+    // Erasing would drop physical input and link frames mid-stream.
+    if (hid_proxy_host_first_dev_addr() != 0) return REPLAY_ERR_BUSY;
+
+    uint8_t hdr[REPLAY_FLASH_HDR];
+    memset(hdr, 0xFF, sizeof(hdr));
+    put_le32(&hdr[0], REPLAY_FLASH_MAGIC);
+    hdr[4] = (uint8_t)(s_used & 0xFF);
+    hdr[5] = (uint8_t)(s_used >> 8);
+    put_le32(&hdr[6], s_duration_us);
+    uint16_t crc = crc16_ccitt(s_buf, s_used, 0xFFFF);
+    hdr[10] = (uint8_t)(crc & 0xFF);
+    hdr[11] = (uint8_t)(crc >> 8);
+
+    // One sector / page at a time, so pending IRQs get serviced between them.
+    // A sector erase still keeps IRQs off for tens to hundreds of ms.
+    uint32_t total = REPLAY_FLASH_HDR + s_used;
+    uint32_t erase_max_us = 0;
+    for (uint32_t off = 0; off < total; off += FLASH_SECTOR_SIZE)
+    {
+        uint32_t t0 = time_us_32();
+        uint32_t irq = save_and_disable_interrupts();
+        flash_range_erase(REPLAY_FLASH_OFFSET + off, FLASH_SECTOR_SIZE);
+        restore_interrupts(irq);
+        uint32_t dt = time_us_32() - t0;
+        if (dt > erase_max_us) erase_max_us = dt;
+    }
+
+    static uint8_t page[FLASH_PAGE_SIZE];
+    for (uint32_t off = 0; off < total; off += FLASH_PAGE_SIZE)
+    {
+        memset(page, 0xFF, sizeof(page));
+        for (uint32_t i = 0; i < FLASH_PAGE_SIZE && off + i < total; i++)
+        {
+            uint32_t src = off + i;
+            page[i] = (src < REPLAY_FLASH_HDR) ? hdr[src] : s_buf[src - REPLAY_FLASH_HDR];
+        }
+        uint32_t irq = save_and_disable_interrupts();
+        flash_range_program(REPLAY_FLASH_OFFSET + off, page, FLASH_PAGE_SIZE);
+        restore_interrupts(irq);
+    }
+    LOGI("[REPLAY] saved %u bytes to flash, IRQs off up to %lu us per sector",
+         s_used, (unsigned long)erase_max_us);
+    return REPLAY_OK;
+}
+
+replay_result_t replay_load_flash(void)
+{
+    if (s_state != REPLAY_IDLE) return REPLAY_ERR_STATE;
+
+    const uint8_t* flash = (const uint8_t*)(XIP_BASE + REPLAY_FLASH_OFFSET);
+    uint32_t magic = (uint32_t)flash[0] | ((uint32_t)flash[1] << 8) |
+                     ((uint32_t)flash[2] << 16) | ((uint32_t)flash[3] << 24);
+    uint16_t used = (uint16_t)flash[4] | ((uint16_t)flash[5] << 8);
+    if (magic != REPLAY_FLASH_MAGIC || used > PROXY_REPLAY_BUF_SIZE) return REPLAY_ERR_FLASH;
+
+    uint16_t crc = (uint16_t)flash[10] | ((uint16_t)flash[11] << 8);
+    if (crc16_ccitt(&flash[REPLAY_FLASH_HDR], used, 0xFFFF) != crc) return REPLAY_ERR_FLASH;
+
+    memcpy(s_buf, &flash[REPLAY_FLASH_HDR], used);
+    s_used = used;
+    s_duration_us = (uint32_t)flash[6] | ((uint32_t)flash[7] << 8) |
+                    ((uint32_t)flash[8] << 16) | ((uint32_t)flash[9] << 24);
+    s_events = count_entries(NULL);
+    replay_reset_play_stats();
+    return REPLAY_OK;
+}
+
+void replay_get_status(replay_status_t* out)
+{
+    if (!out) return;
+    uint32_t irq = save_and_disable_interrupts();
+    out->state          = s_state;
+    out->sources        = s_sources;
+    out->events         = s_events;
+    out->used           = s_used;
+    out->size           = PROXY_REPLAY_BUF_SIZE;
+    out->duration_us    = s_duration_us;
+    out->loops_done     = s_loops_done;
+    out->sent           = s_sent;
+    out->failed         = s_failed;
+    out->busy_retries   = s_busy_retries;
+    out->late_max_us    = s_late_max_us;
+    uint32_t done       = s_sent + s_failed;
+    out->late_mean_us   = done ? (uint32_t)(s_late_sum_us / done) : 0;
+    out->overruns       = s_overruns;
+    out->record_dropped = s_record_dropped;
+    restore_interrupts(irq);
+}
@@ -0,0 +1,84 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// On-device record/replay (REPLAY, cmd 0x10). A sequence is a byte buffer of
+// entries: t_us LE32 (offset from sequence start), itf, len, report[len],
+// with non-decreasing t_us. Playback runs from a hardware alarm IRQ that
+// writes straight to the B_host -> A_device link, so no controller and no
+// main-loop latency sit between the schedule and the wire.
+
+#define REPLAY_ENTRY_HDR   6u
+#define REPLAY_REPORT_MAX  64u
+
+#define REPLAY_SRC_PHYSICAL 0x01
+#define REPLAY_SRC_INJECTED 0x02
+
+typedef enum
+{
+    REPLAY_IDLE      = 0,
+    REPLAY_RECORDING = 1,
+    REPLAY_PLAYING   = 2
+} replay_state_t;
+
+typedef enum
+{
+    REPLAY_OK         = 0,
+    REPLAY_ERR_STATE  = 1,  // not allowed in the current state
+    REPLAY_ERR_RANGE  = 2,  // offset/length outside the buffer
+    REPLAY_ERR_FORMAT = 3,  // malformed entries or no entries
+    REPLAY_ERR_FLASH  = 4,  // no valid sequence stored in flash, or no room for one
+    REPLAY_ERR_BUSY   = 5   // SAVE: a device is mounted or the control port is mid-stream
+} replay_result_t;
+
+typedef struct
+{
+    uint8_t  state;           // replay_state_t
+    uint8_t  sources;         // REPLAY_SRC_* while recording
+    uint16_t events;
+    uint16_t used;            // bytes in the buffer
+    uint16_t size;            // PROXY_REPLAY_BUF_SIZE
+    uint32_t duration_us;     // loop period; 0 = last entry time
+    uint16_t loops_done;
+    uint32_t sent;            // reports written to the link
+    uint32_t failed;          // interface missing or not ready when due
+    uint32_t busy_retries;    // link busy with a main-loop frame when due
+    uint32_t late_max_us;     // worst schedule error
+    uint32_t late_mean_us;
+    uint32_t overruns;        // reports later than PROXY_REPLAY_LATE_LIMIT_US
+    uint32_t record_dropped;  // reports not recorded because the buffer was full
+} replay_status_t;
+
+void replay_init(void);
+
+// Sequence buffer. Uploads must be contiguous: `offset` is the current
+// length (new data) or already-written data (an idempotent retry).
+replay_result_t replay_clear(uint32_t duration_us);
+replay_result_t replay_append(uint16_t offset, uint8_t const* data, uint16_t len);
+uint16_t        replay_read(uint16_t offset, uint8_t* out, uint16_t max);
+
+replay_result_t replay_record_start(uint8_t sources);
+void            replay_record_stop(void);
+// Hook for hid_proxy_host: records when the matching source is armed.
+void            replay_record(uint8_t source, uint8_t itf, uint32_t t_us,
+                              uint8_t const* report, uint16_t len);
+// True while recording with `source` armed; safe from IRQs.
+bool            replay_recording(uint8_t source);
+
+// loops = 0 repeats until replay_stop().
+replay_result_t replay_play(uint16_t loops);
+void            replay_stop(void);
+
+// Persist the buffer to the last sectors of flash. Each 4 KB sector erase runs
+// with IRQs off (~45 ms typical, up to 400 ms), during which the control and
+// link UARTs drop what arrives and USB host stalls. Refused with
+// REPLAY_ERR_BUSY while a HID device is mounted; the caller checks its own
+// port the same way.
+replay_result_t replay_save_flash(void);
+replay_result_t replay_load_flash(void);
+
+void replay_get_status(replay_status_t* out);
+
+#endif // REPLAY_H
@@ -1,3 +1,5 @@
+#define LOG_MODULE LOG_MOD_DESC
+
 #include "string_manager.h"
 
 #include "hid_proxy_host.h"
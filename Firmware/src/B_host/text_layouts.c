@@ -0,0 +1,101 @@
+#include "text_layouts.h"
+
+#include <stddef.h>
+
+typedef struct
+{
+    uint16_t cp;
+    uint8_t  usage;
+    uint8_t  mods;
+} text_layout_key_t;
+
+// Sorted by code point for binary search.
+static const text_layout_key_t s_layout_us[] =
+{
+    { 0x0009, 0x2B, 0x00 }, { 0x000A, 0x28, 0x00 }, { 0x0020, 0x2C, 0x00 }, { 0x0021, 0x1E, 0x02 },
+    { 0x0022, 0x34, 0x02 }, { 0x0023, 0x20, 0x02 }, { 0x0024, 0x21, 0x02 }, { 0x0025, 0x22, 0x02 },
+    { 0x0026, 0x24, 0x02 }, { 0x0027, 0x34, 0x00 }, { 0x0028, 0x26, 0x02 }, { 0x0029, 0x27, 0x02 },
+    { 0x002A, 0x25, 0x02 }, { 0x002B, 0x2E, 0x02 }, { 0x002C, 0x36, 0x00 }, { 0x002D, 0x2D, 0x00 },
+    { 0x002E, 0x37, 0x00 }, { 0x002F, 0x38, 0x00 }, { 0x0030, 0x27, 0x00 }, { 0x0031, 0x1E, 0x00 },
+    { 0x0032, 0x1F, 0x00 }, { 0x0033, 0x20, 0x00 }, { 0x0034, 0x21, 0x00 }, { 0x0035, 0x22, 0x00 },
+    { 0x0036, 0x23, 0x00 }, { 0x0037, 0x24, 0x00 }, { 0x0038, 0x25, 0x00 }, { 0x0039, 0x26, 0x00 },
+    { 0x003A, 0x33, 0x02 }, { 0x003B, 0x33, 0x00 }, { 0x003C, 0x36, 0x02 }, { 0x003D, 0x2E, 0x00 },
+    { 0x003E, 0x37, 0x02 }, { 0x003F, 0x38, 0x02 }, { 0x0040, 0x1F, 0x02 }, { 0x0041, 0x04, 0x02 },
+    { 0x0042, 0x05, 0x02 }, { 0x0043, 0x06, 0x02 }, { 0x0044, 0x07, 0x02 }, { 0x0045, 0x08, 0x02 },
+    { 0x0046, 0x09, 0x02 }, { 0x0047, 0x0A, 0x02 }, { 0x0048, 0x0B, 0x02 }, { 0x0049, 0x0C, 0x02 },
+    { 0x004A, 0x0D, 0x02 }, { 0x004B, 0x0E, 0x02 }, { 0x004C, 0x0F, 0x02 }, { 0x004D, 0x10, 0x02 },
+    { 0x004E, 0x11, 0x02 }, { 0x004F, 0x12, 0x02 }, { 0x0050, 0x13, 0x02 }, { 0x0051, 0x14, 0x02 },
+    { 0x0052, 0x15, 0x02 }, { 0x0053, 0x16, 0x02 }, { 0x0054, 0x17, 0x02 }, { 0x0055, 0x18, 0x02 },
+    { 0x0056, 0x19, 0x02 }, { 0x0057, 0x1A, 0x02 }, { 0x0058, 0x1B, 0x02 }, { 0x0059, 0x1C, 0x02 },
+    { 0x005A, 0x1D, 0x02 }, { 0x005B, 0x2F, 0x00 }, { 0x005C, 0x31, 0x00 }, { 0x005D, 0x30, 0x00 },
+    { 0x005E, 0x23, 0x02 }, { 0x005F, 0x2D, 0x02 }, { 0x0060, 0x35, 0x00 }, { 0x0061, 0x04, 0x00 },
+    { 0x0062, 0x05, 0x00 }, { 0x0063, 0x06, 0x00 }, { 0x0064, 0x07, 0x00 }, { 0x0065, 0x08, 0x00 },
+    { 0x0066, 0x09, 0x00 }, { 0x0067, 0x0A, 0x00 }, { 0x0068, 0x0B, 0x00 }, { 0x0069, 0x0C, 0x00 },
+    { 0x006A, 0x0D, 0x00 }, { 0x006B, 0x0E, 0x00 }, { 0x006C, 0x0F, 0x00 }, { 0x006D, 0x10, 0x00 },
+    { 0x006E, 0x11, 0x00 }, { 0x006F, 0x12, 0x00 }, { 0x0070, 0x13, 0x00 }, { 0x0071, 0x14, 0x00 },
+    { 0x0072, 0x15, 0x00 }, { 0x0073, 0x16, 0x00 }, { 0x0074, 0x17, 0x00 }, { 0x0075, 0x18, 0x00 },
+    { 0x0076, 0x19, 0x00 }, { 0x0077, 0x1A, 0x00 }, { 0x0078, 0x1B, 0x00 }, { 0x0079, 0x1C, 0x00 },
+    { 0x007A, 0x1D, 0x00 }, { 0x007B, 0x2F, 0x02 }, { 0x007C, 0x31, 0x02 }, { 0x007D, 0x30, 0x02 },
+    { 0x007E, 0x35, 0x02 },
+};
+
+static const text_layout_key_t s_layout_ua[] =
+{
+    { 0x0009, 0x2B, 0x00 }, { 0x000A, 0x28, 0x00 }, { 0x0020, 0x2C, 0x00 }, { 0x0021, 0x1E, 0x02 },
+    { 0x0022, 0x1F, 0x02 }, { 0x0025, 0x22, 0x02 }, { 0x0027, 0x35, 0x00 }, { 0x0028, 0x26, 0x02 },
+    { 0x0029, 0x27, 0x02 }, { 0x002A, 0x25, 0x02 }, { 0x002B, 0x2E, 0x02 }, { 0x002C, 0x38, 0x02 },
+    { 0x002D, 0x2D, 0x00 }, { 0x002E, 0x38, 0x00 }, { 0x002F, 0x31, 0x02 }, { 0x0030, 0x27, 0x00 },
+    { 0x0031, 0x1E, 0x00 }, { 0x0032, 0x1F, 0x00 }, { 0x0033, 0x20, 0x00 }, { 0x0034, 0x21, 0x00 },
+    { 0x0035, 0x22, 0x00 }, { 0x0036, 0x23, 0x00 }, { 0x0037, 0x24, 0x00 }, { 0x0038, 0x25, 0x00 },
+    { 0x0039, 0x26, 0x00 }, { 0x003A, 0x23, 0x02 }, { 0x003B, 0x21, 0x02 }, { 0x003D, 0x2E, 0x00 },
+    { 0x003F, 0x24, 0x02 }, { 0x005C, 0x31, 0x00 }, { 0x005F, 0x2D, 0x02 }, { 0x0404, 0x34, 0x02 },
+    { 0x0406, 0x16, 0x02 }, { 0x0407, 0x30, 0x02 }, { 0x0410, 0x09, 0x02 }, { 0x0411, 0x36, 0x02 },
+    { 0x0412, 0x07, 0x02 }, { 0x0413, 0x18, 0x02 }, { 0x0414, 0x0F, 0x02 }, { 0x0415, 0x17, 0x02 },
+    { 0x0416, 0x33, 0x02 }, { 0x0417, 0x13, 0x02 }, { 0x0418, 0x05, 0x02 }, { 0x0419, 0x14, 0x02 },
+    { 0x041A, 0x15, 0x02 }, { 0x041B, 0x0E, 0x02 }, { 0x041C, 0x19, 0x02 }, { 0x041D, 0x1C, 0x02 },
+    { 0x041E, 0x0D, 0x02 }, { 0x041F, 0x0A, 0x02 }, { 0x0420, 0x0B, 0x02 }, { 0x0421, 0x06, 0x02 },
+    { 0x0422, 0x11, 0x02 }, { 0x0423, 0x08, 0x02 }, { 0x0424, 0x04, 0x02 }, { 0x0425, 0x2F, 0x02 },
+    { 0x0426, 0x1A, 0x02 }, { 0x0427, 0x1B, 0x02 }, { 0x0428, 0x0C, 0x02 }, { 0x0429, 0x12, 0x02 },
+    { 0x042C, 0x10, 0x02 }, { 0x042E, 0x37, 0x02 }, { 0x042F, 0x1D, 0x02 }, { 0x0430, 0x09, 0x00 },
+    { 0x0431, 0x36, 0x00 }, { 0x0432, 0x07, 0x00 }, { 0x0433, 0x18, 0x00 }, { 0x0434, 0x0F, 0x00 },
+    { 0x0435, 0x17, 0x00 }, { 0x0436, 0x33, 0x00 }, { 0x0437, 0x13, 0x00 }, { 0x0438, 0x05, 0x00 },
+    { 0x0439, 0x14, 0x00 }, { 0x043A, 0x15, 0x00 }, { 0x043B, 0x0E, 0x00 }, { 0x043C, 0x19, 0x00 },
+    { 0x043D, 0x1C, 0x00 }, { 0x043E, 0x0D, 0x00 }, { 0x043F, 0x0A, 0x00 }, { 0x0440, 0x0B, 0x00 },
+    { 0x0441, 0x06, 0x00 }, { 0x0442, 0x11, 0x00 }, { 0x0443, 0x08, 0x00 }, { 0x0444, 0x04, 0x00 },
+    { 0x0445, 0x2F, 0x00 }, { 0x0446, 0x1A, 0x00 }, { 0x0447, 0x1B, 0x00 }, { 0x0448, 0x0C, 0x00 },
+    { 0x0449, 0x12, 0x00 }, { 0x044C, 0x10, 0x00 }, { 0x044E, 0x37, 0x00 }, { 0x044F, 0x1D, 0x00 },
+    { 0x0454, 0x34, 0x00 }, { 0x0456, 0x16, 0x00 }, { 0x0457, 0x30, 0x00 }, { 0x0490, 0x18, 0x42 },
+    { 0x0491, 0x18, 0x40 }, { 0x2019, 0x35, 0x00 }, { 0x20B4, 0x35, 0x02 }, { 0x2116, 0x20, 0x02 },
+};
+
+typedef struct
+{
+    text_layout_key_t const* keys;
+    size_t                   count;
+} text_layout_t;
+
+static const text_layout_t s_layouts[TEXT_LAYOUT_COUNT] =
+{
+    { s_layout_us, sizeof(s_layout_us) / sizeof(s_layout_us[0]) },
+    { s_layout_ua, sizeof(s_layout_ua) / sizeof(s_layout_ua[0]) },
+};
+
+bool text_layout_lookup(uint8_t layout, uint32_t cp, uint8_t* usage, uint8_t* mods)
+{
+    if (layout >= TEXT_LAYOUT_COUNT || cp > 0xFFFFu) return false;
+
+    text_layout_t const* l = &s_layouts[layout];
+    size_t lo = 0;
+    size_t hi = l->count;
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi) / 2u;
+        if (l->keys[mid].cp < cp) lo = mid + 1u;
+        else hi = mid;
+    }
+    if (lo == l->count || l->keys[lo].cp != cp) return false;
+
+    *usage = l->keys[lo].usage;
+    *mods  = l->keys[lo].mods;
+    return true;
+}
@@ -0,0 +1,19 @@
+#ifndef TEXT_LAYOUTS_H
+#define TEXT_LAYOUTS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Compiled keyboard layout tables for TYPE_TEXT: Unicode code point -> HID
+// usage (page 0x07) plus the modifiers that produce it on that layout.
+
+#define TEXT_LAYOUT_US     0u  // US QWERTY
+#define TEXT_LAYOUT_UA     1u  // Ukrainian (Enhanced), AltGr for ґ/Ґ
+#define TEXT_LAYOUT_COUNT  2u
+
+#define TEXT_MOD_SHIFT     0x02u  // left Shift
+#define TEXT_MOD_ALTGR     0x40u  // right Alt
+
+bool text_layout_lookup(uint8_t layout, uint32_t cp, uint8_t* usage, uint8_t* mods);
+
+#endif // TEXT_LAYOUTS_H
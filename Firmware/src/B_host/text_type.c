@@ -0,0 +1,250 @@
+#include "text_type.h"
+
+#include <string.h>
+
+#include "pico/stdlib.h"
+
+#include "logging.h"
+#include "proxy_config.h"
+#include "hid_proxy_host.h"
+#include "descriptor_logger.h"
+#include "hid_fields.h"
+#include "text_layouts.h"
+
+#if (PROXY_TYPE_TEXT_DEPTH & (PROXY_TYPE_TEXT_DEPTH - 1u)) != 0 || PROXY_TYPE_TEXT_DEPTH > 32768u
+#error "PROXY_TYPE_TEXT_DEPTH must be a power of two <= 32768"
+#endif
+
+#define TYPE_QUEUE_MASK  (PROXY_TYPE_TEXT_DEPTH - 1u)
+#define TYPE_REPORT_MAX  HID_FIELD_REPORT_MAX
+#define TYPE_KEY(usage, mods) ((uint16_t)((usage) | ((uint16_t)(mods) << 8)))
+
+// Keystrokes: usage in the low byte, modifiers in the high byte.
+static uint16_t s_queue[PROXY_TYPE_TEXT_DEPTH];
+static uint16_t s_head = 0;
+static uint16_t s_tail = 0;
+
+typedef struct
+{
+    bool     active;
+    bool     has_layout;
+    hid_report_layout_t layout;
+    uint8_t  itf;
+    uint8_t  flags;
+    uint16_t held;           // key currently pressed, 0 = none
+    uint16_t interval_us;
+    uint32_t next_us;
+    uint32_t typed;
+    uint16_t unmapped;
+    uint16_t failed;
+} text_type_state_t;
+
+static text_type_state_t s_type;
+
+static uint16_t queue_used(void)
+{
+    return (uint16_t)((s_head - s_tail) & TYPE_QUEUE_MASK);
+}
+
+// Returns the next code point and advances *pos; malformed input yields
+// 0xFFFD, which no layout maps.
+static uint32_t utf8_next(uint8_t const* s, uint16_t len, uint16_t* pos)
+{
+    uint8_t b = s[(*pos)++];
+    if (b < 0x80) return b;
+
+    uint8_t extra;
+    uint32_t cp;
+    if ((b & 0xE0) == 0xC0) { extra = 1; cp = b & 0x1F; }
+    else if ((b & 0xF0) == 0xE0) { extra = 2; cp = b & 0x0F; }
+    else if ((b & 0xF8) == 0xF0) { extra = 3; cp = b & 0x07; }
+    else return 0xFFFD;
+
+    for (uint8_t i = 0; i < extra; i++)
+    {
+        if (*pos >= len || (s[*pos] & 0xC0) != 0x80) return 0xFFFD;
+        cp = (cp << 6) | (s[(*pos)++] & 0x3F);
+    }
+    return cp;
+}
+
+// Maps one chunk; with `out` NULL only counts the keystrokes.
+static uint16_t map_text(uint8_t layout, uint8_t const* utf8, uint16_t len, uint16_t* out, uint16_t* unmapped)
+{
+    uint16_t keys = 0;
+    uint16_t pos = 0;
+    while (pos < len)
+    {
+        uint32_t cp = utf8_next(utf8, len, &pos);
+        if (cp == '\r')
+        {
+            if (pos < len && utf8[pos] == '\n') continue;  // CRLF types one Enter
+            cp = '\n';
+        }
+
+        uint8_t usage;
+        uint8_t mods;
+        if (!text_layout_lookup(layout, cp, &usage, &mods))
+        {
+            if (unmapped) (*unmapped)++;
+            continue;
+        }
+        if (out) out[(s_head + keys) & TYPE_QUEUE_MASK] = TYPE_KEY(usage, mods);
+        keys++;
+    }
+    return keys;
+}
+
+static uint16_t build_report(uint8_t* report, uint16_t key)
+{
+    uint8_t usage = (uint8_t)(key & 0xFF);
+    uint8_t mods = (uint8_t)(key >> 8);
+    memset(report, 0, TYPE_REPORT_MAX);
+    if (!s_type.has_layout)
+    {
+        // Boot keyboard: modifiers, reserved, six key slots.
+        report[0] = mods;
+        report[2] = usage;
+        return 8;
+    }
+
+    hid_report_layout_t const* l = &s_type.layout;
+    uint16_t base = 0;
+    if (l->kb_has_report_id)
+    {
+        report[0] = l->report_id;
+        base = 8;
+    }
+    if (l->kb_has_mods)
+    {
+        hid_field_write(report, (uint16_t)(base + l->kb_mods_offset_bits), 8, mods);
+    }
+    if (usage)
+    {
+        if (l->kb_keys_bitmap)
+        {
+            if (usage >= l->kb_keys_usage_min && usage - l->kb_keys_usage_min < l->kb_keys_count)
+            {
+                hid_field_write(report, (uint16_t)(base + l->kb_keys_offset_bits + (usage - l->kb_keys_usage_min)), 1, 1);
+            }
+        }
+        else
+        {
+            hid_field_write(report, (uint16_t)(base + l->kb_keys_offset_bits), l->kb_keys_size_bits, usage);
+        }
+    }
+
+    uint16_t len = (uint16_t)(base / 8u + l->kb_report_len);
+    return len > TYPE_REPORT_MAX ? TYPE_REPORT_MAX : len;
+}
+
+static void send_key(uint16_t key)
+{
+    uint8_t report[TYPE_REPORT_MAX];
+    uint16_t len = build_report(report, key);
+    if (!hid_proxy_host_inject_report(s_type.itf, report, len))
+    {
+        s_type.failed++;
+        s_type.held = 0;
+        return;
+    }
+    s_type.held = key;
+    if (key) s_type.typed++;
+}
+
+text_type_result_t text_type_append(uint8_t layout, uint8_t itf_sel, uint8_t flags, uint16_t interval_us,
+                                    uint8_t const* utf8, uint16_t len)
+{
+    if (layout >= TEXT_LAYOUT_COUNT) return TEXT_TYPE_ERR_LAYOUT;
+
+    uint16_t keys = map_text(layout, utf8, len, NULL, NULL);
+    if (keys > TYPE_QUEUE_MASK - queue_used()) return TEXT_TYPE_ERR_FULL;
+
+    if (!s_type.active)
+    {
+        int itf = hid_proxy_host_resolve_inject_itf(itf_sel);
+        if (itf < 0) return TEXT_TYPE_ERR_ITF;
+
+        memset(&s_type, 0, sizeof(s_type));
+        s_type.itf = (uint8_t)itf;
+        s_type.flags = flags;
+        s_type.has_layout = hid_proxy_host_get_keyboard_layout(s_type.itf, &s_type.layout) &&
+                            s_type.layout.kb_keys_count;
+
+        uint8_t poll_ms = descriptor_logger_poll_interval_ms(s_type.itf);
+        if (poll_ms > 65) poll_ms = 65;
+        s_type.interval_us = interval_us ? interval_us
+                           : (poll_ms ? (uint16_t)(poll_ms * 1000u) : PROXY_TYPE_TEXT_DEFAULT_INTERVAL_US);
+        s_type.next_us = time_us_32();
+    }
+
+    map_text(layout, utf8, len, s_queue, &s_type.unmapped);
+    s_head = (uint16_t)((s_head + keys) & TYPE_QUEUE_MASK);
+    if (keys || s_type.held) s_type.active = true;
+
+    LOGT("[TYPE] itf=%u layout=%u +%u keys queued=%u unmapped=%u",
+         s_type.itf, layout, keys, queue_used(), s_type.unmapped);
+    return TEXT_TYPE_OK;
+}
+
+void text_type_cancel(void)
+{
+    s_tail = s_head;
+    // The held key is released on the next pass.
+}
+
+void text_type_task(void)
+{
+    if (!s_type.active) return;
+    uint32_t now = time_us_32();
+    if ((int32_t)(now - s_type.next_us) < 0) return;
+
+    // A key is pressed in the report that releases the previous one, so a
+    // character costs one report; a release of its own is needed only before
+    // the same key again and at the end.
+    if (s_type.held)
+    {
+        uint16_t next = queue_used() ? s_queue[s_tail] : 0;
+        bool release = !next || (s_type.flags & TEXT_TYPE_FLAG_RELEASE_EACH) ||
+                       (next & 0xFF) == (s_type.held & 0xFF);
+        if (release)
+        {
+            send_key(0);
+        }
+        else
+        {
+            s_tail = (uint16_t)((s_tail + 1u) & TYPE_QUEUE_MASK);
+            send_key(next);
+        }
+    }
+    else if (queue_used())
+    {
+        uint16_t next = s_queue[s_tail];
+        s_tail = (uint16_t)((s_tail + 1u) & TYPE_QUEUE_MASK);
+        send_key(next);
+    }
+
+    if (!s_type.held && !queue_used())
+    {
+        s_type.active = false;
+        LOGT("[TYPE] done typed=%lu unmapped=%u failed=%u",
+             (unsigned long)s_type.typed, s_type.unmapped, s_type.failed);
+        return;
+    }
+
+    // Catch up after a stall by one report, not a burst.
+    s_type.next_us += s_type.interval_us;
+    if ((int32_t)(now - s_type.next_us) >= 0) s_type.next_us = now + s_type.interval_us;
+}
+
+void text_type_get_status(text_type_status_t* out)
+{
+    if (!out) return;
+    out->active      = s_type.active ? 1 : 0;
+    out->queued      = queue_used();
+    out->free        = (uint16_t)(TYPE_QUEUE_MASK - queue_used());
+    out->interval_us = s_type.interval_us;
+    out->typed       = s_type.typed;
+    out->unmapped    = s_type.unmapped;
+    out->failed      = s_type.failed;
+}
@@ -0,0 +1,44 @@
+#ifndef TEXT_TYPE_H
+#define TEXT_TYPE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Text typing engine (TYPE_TEXT, cmd 0x13). UTF-8 text is mapped to keystrokes
+// through a compiled layout table when it arrives, then the main loop types
+// them one report per endpoint poll interval, in the keyboard interface's own
+// report format (boot array or NKRO bitmap).
+
+#define TEXT_TYPE_FLAG_RELEASE_EACH 0x01u  // release after every key, not only before a repeat
+
+typedef enum
+{
+    TEXT_TYPE_OK         = 0,
+    TEXT_TYPE_ERR_ITF    = 1,  // no ready interface for the selector
+    TEXT_TYPE_ERR_LAYOUT = 2,  // unknown layout ID
+    TEXT_TYPE_ERR_FULL   = 3   // the keystrokes do not fit the queue
+} text_type_result_t;
+
+typedef struct
+{
+    uint8_t  active;
+    uint16_t queued;        // keystrokes waiting
+    uint16_t free;          // keystrokes the queue can still take
+    uint16_t interval_us;
+    uint32_t typed;         // since typing last started from idle
+    uint16_t unmapped;      // characters the layout cannot produce (skipped)
+    uint16_t failed;        // reports the link refused
+} text_type_status_t;
+
+// Queues `len` bytes of UTF-8. `itf_sel`, `flags` and `interval_us`
+// (0 = endpoint poll interval) apply when typing starts from idle. The chunk
+// is queued whole or not at all; split text on character boundaries.
+text_type_result_t text_type_append(uint8_t layout, uint8_t itf_sel, uint8_t flags, uint16_t interval_us,
+                                    uint8_t const* utf8, uint16_t len);
+// Drops queued keystrokes and releases the held key.
+void text_type_cancel(void);
+// Main-loop pacing; sends at most one report per call.
+void text_type_task(void);
+void text_type_get_status(text_type_status_t* out);
+
+#endif // TEXT_TYPE_H
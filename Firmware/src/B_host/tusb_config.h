@@ -33,7 +33,13 @@ extern "C" {
 //--------------------------------------------------------------------
 
 #define CFG_TUH_HUB            1
-#define CFG_TUH_HID            4
+// TinyUSB parses the whole configuration descriptor during enumeration; the
+// default (256) rejects large composites. Keep >= PROXY_MAX_CONFIG_DESC_SIZE.
+#define CFG_TUH_ENUMERATION_BUFSIZE 1024
+// HID interfaces across all devices: hub composites (PROXY_HUB_MAX_ITFS).
+#define CFG_TUH_HID            8
+// Hub + PROXY_HUB_MAX_DEVICES devices behind it.
+#define CFG_TUH_DEVICE_MAX     5
 #define CFG_TUH_HID_EPIN_BUFSIZE   64
 #define CFG_TUH_HID_EPOUT_BUFSIZE  64
 
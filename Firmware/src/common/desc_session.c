@@ -0,0 +1,304 @@
+// common/desc_session.c
+#include "desc_session.h"
+
+#include <string.h>
+
+static uint16_t le16_read(uint8_t const* p)
+{
+    return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+static void le16_write(uint8_t* p, uint16_t v)
+{
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)(v >> 8);
+}
+
+void desc_ranges_reset(desc_ranges_t* r)
+{
+    memset(r, 0, sizeof(*r));
+}
+
+bool desc_ranges_add(desc_ranges_t* r, uint16_t offset, uint16_t len)
+{
+    if (!len)
+    {
+        return true;
+    }
+
+    uint16_t start = offset;
+    uint32_t end32 = (uint32_t)offset + len;
+    if (r->total && end32 > r->total) end32 = r->total;
+    if (end32 > UINT16_MAX) end32 = UINT16_MAX;
+    uint16_t end = (uint16_t)end32;
+    if (start >= end)
+    {
+        return true;
+    }
+
+    // held[i, j) overlap or touch the new range.
+    uint8_t i = 0;
+    while (i < r->count && r->held[i].end < start) i++;
+    uint8_t j = i;
+    while (j < r->count && r->held[j].start <= end) j++;
+
+    if (i == j)
+    {
+        if (r->count >= PROXY_DESC_RESUME_RANGES)
+        {
+            return false;
+        }
+        memmove(&r->held[i + 1], &r->held[i], (size_t)(r->count - i) * sizeof(r->held[0]));
+        r->held[i].start = start;
+        r->held[i].end   = end;
+        r->count++;
+        return true;
+    }
+
+    if (r->held[i].start < start) start = r->held[i].start;
+    if (r->held[j - 1].end > end) end = r->held[j - 1].end;
+    r->held[i].start = start;
+    r->held[i].end   = end;
+    memmove(&r->held[i + 1], &r->held[j], (size_t)(r->count - j) * sizeof(r->held[0]));
+    r->count = (uint8_t)(r->count - (j - i - 1));
+    return true;
+}
+
+uint16_t desc_ranges_prefix(desc_ranges_t const* r)
+{
+    return (r->count && r->held[0].start == 0) ? r->held[0].end : 0;
+}
+
+bool desc_ranges_complete(desc_ranges_t const* r)
+{
+    return desc_ranges_prefix(r) >= r->total;
+}
+
+void desc_session_begin(desc_session_t* s, uint8_t id)
+{
+    memset(s, 0, sizeof(*s));
+    s->id = id;
+}
+
+desc_ranges_t* desc_session_slot(desc_session_t* s, uint8_t desc_cmd, uint8_t itf)
+{
+    switch (desc_cmd)
+    {
+        case PF_DESC_DEVICE: return &s->device;
+        case PF_DESC_CONFIG: return &s->config;
+        case PF_DESC_REPORT: return (itf < DESC_SESSION_MAX_REPORTS) ? &s->reports[itf] : NULL;
+        default:             return NULL;
+    }
+}
+
+bool desc_session_note(desc_session_t* s, proto_desc_segment_t const* seg)
+{
+    if (!s->id || seg->session != s->id || !seg->total)
+    {
+        return false;
+    }
+
+    desc_ranges_t* r = desc_session_slot(s, seg->desc_cmd, seg->itf);
+    if (!r)
+    {
+        return false;
+    }
+    if (!r->total)
+    {
+        // After the manifest a zero total means "not part of this set".
+        if (s->manifest)
+        {
+            return false;
+        }
+        r->total = seg->total;
+    }
+    else if (r->total != seg->total)
+    {
+        return false;
+    }
+
+    return desc_ranges_add(r, seg->offset, seg->len);
+}
+
+static void ranges_set_total(desc_ranges_t* r, uint16_t total)
+{
+    if (r->total != total)
+    {
+        // Bytes taken against another length cannot be trusted.
+        desc_ranges_reset(r);
+        r->total = total;
+    }
+}
+
+void desc_session_apply_manifest(desc_session_t* s, desc_manifest_t const* m)
+{
+    ranges_set_total(&s->device, m->device_total);
+    ranges_set_total(&s->config, m->config_total);
+    for (uint8_t i = 0; i < DESC_SESSION_MAX_REPORTS; i++)
+    {
+        ranges_set_total(&s->reports[i], (m->report_mask & (1u << i)) ? m->report_total[i] : 0);
+    }
+    s->report_mask = m->report_mask;
+    s->manifest    = true;
+}
+
+bool desc_session_complete(desc_session_t const* s)
+{
+    if (!s->manifest ||
+        !desc_ranges_complete(&s->device) ||
+        !desc_ranges_complete(&s->config))
+    {
+        return false;
+    }
+    for (uint8_t i = 0; i < DESC_SESSION_MAX_REPORTS; i++)
+    {
+        if ((s->report_mask & (1u << i)) && !desc_ranges_complete(&s->reports[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint16_t desc_session_build_manifest(desc_manifest_t const* m, uint8_t* out, uint16_t max)
+{
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < DESC_SESSION_MAX_REPORTS; i++)
+    {
+        if (m->report_mask & (1u << i)) n++;
+    }
+    uint16_t need = (uint16_t)(PROTO_DESC_MANIFEST_HDR + n * PROTO_DESC_MANIFEST_ENTRY);
+    if (!out || max < need)
+    {
+        return 0;
+    }
+
+    out[0] = m->session;
+    le16_write(&out[1], m->device_total);
+    le16_write(&out[3], m->config_total);
+    out[5] = n;
+    uint8_t* e = &out[PROTO_DESC_MANIFEST_HDR];
+    for (uint8_t i = 0; i < DESC_SESSION_MAX_REPORTS; i++)
+    {
+        if (m->report_mask & (1u << i))
+        {
+            e[0] = i;
+            le16_write(&e[1], m->report_total[i]);
+            e += PROTO_DESC_MANIFEST_ENTRY;
+        }
+    }
+    return need;
+}
+
+bool desc_session_parse_manifest(uint8_t const* p, uint16_t len, desc_manifest_t* out)
+{
+    if (!p || !out || len < PROTO_DESC_MANIFEST_HDR)
+    {
+        return false;
+    }
+    uint8_t n = p[5];
+    if (len != PROTO_DESC_MANIFEST_HDR + n * PROTO_DESC_MANIFEST_ENTRY)
+    {
+        return false;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->session      = p[0];
+    out->device_total = le16_read(&p[1]);
+    out->config_total = le16_read(&p[3]);
+    uint8_t const* e = &p[PROTO_DESC_MANIFEST_HDR];
+    for (uint8_t k = 0; k < n; k++, e += PROTO_DESC_MANIFEST_ENTRY)
+    {
+        if (e[0] >= DESC_SESSION_MAX_REPORTS)
+        {
+            return false;
+        }
+        out->report_mask |= (uint8_t)(1u << e[0]);
+        out->report_total[e[0]] = le16_read(&e[1]);
+    }
+    return out->session != 0;
+}
+
+// Appends the gaps of one descriptor; false once `out` is full.
+static bool status_put_gaps(desc_ranges_t const* r, uint8_t desc_cmd, uint8_t itf,
+                            uint8_t* out, uint16_t max, uint16_t* pos)
+{
+    uint16_t cursor = 0;
+    for (uint8_t k = 0; k <= r->count; k++)
+    {
+        uint16_t next = (k < r->count) ? r->held[k].start : r->total;
+        if (next > cursor)
+        {
+            if (*pos + PROTO_DESC_STATUS_ENTRY > max || out[2] >= PROTO_DESC_STATUS_MAX_GAPS)
+            {
+                return false;
+            }
+            uint8_t* e = &out[*pos];
+            e[0] = desc_cmd;
+            e[1] = itf;
+            le16_write(&e[2], cursor);
+            le16_write(&e[4], (uint16_t)(next - cursor));
+            *pos = (uint16_t)(*pos + PROTO_DESC_STATUS_ENTRY);
+            out[2]++;
+        }
+        if (k < r->count && r->held[k].end > cursor)
+        {
+            cursor = r->held[k].end;
+        }
+    }
+    return true;
+}
+
+uint16_t desc_session_build_status(desc_session_t const* s, uint8_t* out, uint16_t max)
+{
+    if (!out || max < PROTO_DESC_STATUS_HDR)
+    {
+        return 0;
+    }
+
+    out[0] = s->id;
+    out[1] = 0;
+    out[2] = 0;
+    uint16_t pos = PROTO_DESC_STATUS_HDR;
+    bool fit = status_put_gaps(&s->device, PF_DESC_DEVICE, 0, out, max, &pos) &&
+               status_put_gaps(&s->config, PF_DESC_CONFIG, 0, out, max, &pos);
+    for (uint8_t i = 0; fit && i < DESC_SESSION_MAX_REPORTS; i++)
+    {
+        if (s->report_mask & (1u << i))
+        {
+            fit = status_put_gaps(&s->reports[i], PF_DESC_REPORT, i, out, max, &pos);
+        }
+    }
+    if (!fit)
+    {
+        out[1] |= PROTO_DESC_STATUS_MORE;
+    }
+    return pos;
+}
+
+bool desc_session_parse_status(uint8_t const* p, uint16_t len, desc_status_t* out)
+{
+    if (!p || !out || len < PROTO_DESC_STATUS_HDR)
+    {
+        return false;
+    }
+    uint8_t n = p[2];
+    if (n > PROTO_DESC_STATUS_MAX_GAPS ||
+        len != PROTO_DESC_STATUS_HDR + n * PROTO_DESC_STATUS_ENTRY)
+    {
+        return false;
+    }
+
+    out->session = p[0];
+    out->flags   = p[1];
+    out->count   = n;
+    uint8_t const* e = &p[PROTO_DESC_STATUS_HDR];
+    for (uint8_t k = 0; k < n; k++, e += PROTO_DESC_STATUS_ENTRY)
+    {
+        out->gaps[k].desc_cmd = e[0];
+        out->gaps[k].itf      = e[1];
+        out->gaps[k].offset   = le16_read(&e[2]);
+        out->gaps[k].len      = le16_read(&e[4]);
+    }
+    return true;
+}
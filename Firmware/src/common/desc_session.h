@@ -0,0 +1,93 @@
+// common/desc_session.h
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "proto_frame.h"
+#include "proxy_config.h"
+
+// Resumable descriptor sessions (PROXY_DESC_RESUME). B_host tags every
+// DEVICE/CONFIG/REPORT byte with a session id and its offset
+// (PF_DESC_SEGMENT) and closes the set with a DONE manifest of descriptor
+// lengths. A_device tracks which byte ranges of each descriptor it holds; if
+// the set is short at DONE it lists the gaps (PF_CTRL_DESC_STATUS) and B_host
+// resends only those, so link corruption costs a few frames instead of a full
+// UNMOUNT/RESET and re-enumeration.
+
+// Report descriptors per session; matches CFG_TUD_HID / CFG_TUH_HID.
+#define DESC_SESSION_MAX_REPORTS 8u
+
+typedef struct
+{
+    uint16_t start;
+    uint16_t end;    // exclusive
+} desc_range_t;
+
+// Received bytes of one descriptor as sorted, disjoint ranges.
+typedef struct
+{
+    uint16_t     total;   // descriptor length, 0 = not announced yet
+    uint8_t      count;
+    desc_range_t held[PROXY_DESC_RESUME_RANGES];
+} desc_ranges_t;
+
+typedef struct
+{
+    uint8_t       id;            // 0 = no session
+    bool          manifest;      // DONE manifest applied, totals are final
+    uint8_t       report_mask;   // report descriptors the manifest announced
+    desc_ranges_t device;
+    desc_ranges_t config;
+    desc_ranges_t reports[DESC_SESSION_MAX_REPORTS];
+} desc_session_t;
+
+typedef struct
+{
+    uint8_t  session;
+    uint16_t device_total;
+    uint16_t config_total;
+    uint8_t  report_mask;
+    uint16_t report_total[DESC_SESSION_MAX_REPORTS];
+} desc_manifest_t;
+
+typedef struct
+{
+    uint8_t  desc_cmd;
+    uint8_t  itf;
+    uint16_t offset;
+    uint16_t len;
+} desc_gap_t;
+
+typedef struct
+{
+    uint8_t    session;
+    uint8_t    flags;        // PROTO_DESC_STATUS_*
+    uint8_t    count;
+    desc_gap_t gaps[PROTO_DESC_STATUS_MAX_GAPS];
+} desc_status_t;
+
+void desc_ranges_reset(desc_ranges_t* r);
+// Adds [offset, offset + len). False when the list is full and the range
+// touches none of the held ones; nothing changes then.
+bool desc_ranges_add(desc_ranges_t* r, uint16_t offset, uint16_t len);
+// Bytes held contiguously from offset 0.
+uint16_t desc_ranges_prefix(desc_ranges_t const* r);
+bool desc_ranges_complete(desc_ranges_t const* r);
+
+void desc_session_begin(desc_session_t* s, uint8_t id);
+// Tracker of one descriptor, or NULL for other commands / interfaces.
+desc_ranges_t* desc_session_slot(desc_session_t* s, uint8_t desc_cmd, uint8_t itf);
+// Records a segment of session `s`. False when it belongs elsewhere, its
+// total disagrees with what is already known, or the tracker is full; the
+// caller drops the bytes and they come back as a gap.
+bool desc_session_note(desc_session_t* s, proto_desc_segment_t const* seg);
+void desc_session_apply_manifest(desc_session_t* s, desc_manifest_t const* m);
+// Manifest applied and every announced descriptor fully held.
+bool desc_session_complete(desc_session_t const* s);
+
+// Wire helpers; each returns the payload length, 0 when `max` is too small.
+uint16_t desc_session_build_manifest(desc_manifest_t const* m, uint8_t* out, uint16_t max);
+bool desc_session_parse_manifest(uint8_t const* p, uint16_t len, desc_manifest_t* out);
+uint16_t desc_session_build_status(desc_session_t const* s, uint8_t* out, uint16_t max);
+bool desc_session_parse_status(uint8_t const* p, uint16_t len, desc_status_t* out);
@@ -0,0 +1,190 @@
+// common/enum_trace.c
+#include "enum_trace.h"
+
+#include <string.h>
+
+#include "pico/time.h"
+#include "proxy_config.h"
+
+typedef struct
+{
+    enum_trace_entry_t entries[PROXY_ENUM_TRACE_DEPTH];
+    uint16_t head;   // next write slot
+    uint16_t count;
+} enum_trace_ring_t;
+
+static uint8_t           s_board;
+static enum_trace_ring_t s_local;
+static enum_trace_ring_t s_remote;
+static enum_trace_entry_t s_snapshot[2 * PROXY_ENUM_TRACE_DEPTH];
+static uint16_t          s_snapshot_len;
+static uint32_t          s_seen_mask;   // events recorded since reset, for _once
+
+static void ring_push(enum_trace_ring_t* ring, enum_trace_entry_t const* e)
+{
+    ring->entries[ring->head] = *e;
+    ring->head = (uint16_t)((ring->head + 1u) % PROXY_ENUM_TRACE_DEPTH);
+    if (ring->count < PROXY_ENUM_TRACE_DEPTH)
+    {
+        ring->count++;
+    }
+}
+
+static enum_trace_entry_t const* ring_at(enum_trace_ring_t const* ring, uint16_t idx)
+{
+    // idx 0 = oldest entry still in the ring.
+    uint16_t first = (uint16_t)((ring->head + PROXY_ENUM_TRACE_DEPTH - ring->count) % PROXY_ENUM_TRACE_DEPTH);
+    return &ring->entries[(first + idx) % PROXY_ENUM_TRACE_DEPTH];
+}
+
+static void entry_encode(enum_trace_entry_t const* e, uint8_t* out)
+{
+    out[0] = (uint8_t)(e->t_us & 0xFF);
+    out[1] = (uint8_t)((e->t_us >> 8) & 0xFF);
+    out[2] = (uint8_t)((e->t_us >> 16) & 0xFF);
+    out[3] = (uint8_t)((e->t_us >> 24) & 0xFF);
+    out[4] = e->board;
+    out[5] = e->event;
+    out[6] = (uint8_t)(e->arg & 0xFF);
+    out[7] = (uint8_t)(e->arg >> 8);
+}
+
+void enum_trace_init(uint8_t board)
+{
+    s_board = board;
+    enum_trace_reset();
+    enum_trace_remote_reset();
+    s_snapshot_len = 0;
+}
+
+void enum_trace_reset(void)
+{
+    s_local.head  = 0;
+    s_local.count = 0;
+    s_seen_mask   = 0;
+}
+
+void enum_trace_record(uint8_t event, uint16_t arg)
+{
+    enum_trace_entry_t e = {
+        .t_us  = time_us_32(),
+        .board = s_board,
+        .event = event,
+        .arg   = arg,
+    };
+    ring_push(&s_local, &e);
+    if (event < 32)
+    {
+        s_seen_mask |= (1u << event);
+    }
+}
+
+void enum_trace_record_once(uint8_t event, uint16_t arg)
+{
+    // Called from per-report hot paths, so a bit test instead of a ring scan.
+    if (event < 32 && (s_seen_mask & (1u << event)))
+    {
+        return;
+    }
+    enum_trace_record(event, arg);
+}
+
+uint16_t enum_trace_count(void)
+{
+    return s_local.count;
+}
+
+uint16_t enum_trace_encode(uint16_t start, uint8_t* out, uint16_t max_entries)
+{
+    uint16_t n = 0;
+    while (start + n < s_local.count && n < max_entries)
+    {
+        entry_encode(ring_at(&s_local, (uint16_t)(start + n)), &out[n * ENUM_TRACE_WIRE_SIZE]);
+        n++;
+    }
+    return n;
+}
+
+void enum_trace_remote_reset(void)
+{
+    s_remote.head  = 0;
+    s_remote.count = 0;
+}
+
+void enum_trace_remote_ingest(int32_t offset_us, uint8_t const* data, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++)
+    {
+        uint8_t const* p = &data[i * ENUM_TRACE_WIRE_SIZE];
+        uint32_t t = (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+                     ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+        enum_trace_entry_t e = {
+            .t_us  = t - (uint32_t)offset_us,
+            .board = p[4],
+            .event = p[5],
+            .arg   = (uint16_t)p[6] | ((uint16_t)p[7] << 8),
+        };
+        ring_push(&s_remote, &e);
+    }
+}
+
+uint16_t enum_trace_remote_count(void)
+{
+    return s_remote.count;
+}
+
+uint16_t enum_trace_snapshot(void)
+{
+    s_snapshot_len = 0;
+    for (uint16_t i = 0; i < s_local.count; i++)
+    {
+        s_snapshot[s_snapshot_len++] = *ring_at(&s_local, i);
+    }
+    for (uint16_t i = 0; i < s_remote.count; i++)
+    {
+        s_snapshot[s_snapshot_len++] = *ring_at(&s_remote, i);
+    }
+    if (!s_snapshot_len)
+    {
+        return 0;
+    }
+
+    // Earliest event becomes t=0; signed deltas keep 32-bit wrap harmless.
+    uint32_t base = s_snapshot[0].t_us;
+    for (uint16_t i = 1; i < s_snapshot_len; i++)
+    {
+        if ((int32_t)(s_snapshot[i].t_us - base) < 0)
+        {
+            base = s_snapshot[i].t_us;
+        }
+    }
+    for (uint16_t i = 0; i < s_snapshot_len; i++)
+    {
+        s_snapshot[i].t_us -= base;
+    }
+
+    // Insertion sort: both halves are already ordered, total is small.
+    for (uint16_t i = 1; i < s_snapshot_len; i++)
+    {
+        enum_trace_entry_t e = s_snapshot[i];
+        uint16_t j = i;
+        while (j > 0 && s_snapshot[j - 1].t_us > e.t_us)
+        {
+            s_snapshot[j] = s_snapshot[j - 1];
+            j--;
+        }
+        s_snapshot[j] = e;
+    }
+    return s_snapshot_len;
+}
+
+uint16_t enum_trace_snapshot_encode(uint16_t start, uint8_t* out, uint16_t max_entries)
+{
+    uint16_t n = 0;
+    while (start + n < s_snapshot_len && n < max_entries)
+    {
+        entry_encode(&s_snapshot[start + n], &out[n * ENUM_TRACE_WIRE_SIZE]);
+        n++;
+    }
+    return n;
+}
@@ -0,0 +1,67 @@
+// common/enum_trace.h
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Enumeration timeline tracer: timestamped phase events in a fixed RAM ring.
+// Both boards record locally. B_host pulls the A_device ring over the link
+// (PF_CTRL_TRACE_REQ / PF_CTRL_TRACE_DATA), shifts it onto its own clock and
+// serves the merged timeline over the control UART (GET_TRACE).
+
+typedef enum
+{
+    ET_BOARD_B = 0,
+    ET_BOARD_A = 1
+} enum_trace_board_t;
+
+typedef enum
+{
+    ET_MOUNT                 = 1,  // B: HID mount callback, arg=itf
+    ET_DESC_FETCHED          = 2,  // B: descriptor read from device, arg=(type<<8)|index
+    ET_DESC_CHUNK_SENT       = 3,  // B: PF_DESCRIPTOR frame out, arg=(cmd<<8)|len
+    ET_DESC_CHUNK_ACK        = 4,  // A: PF_DESCRIPTOR frame accepted, arg=(cmd<<8)|len
+    ET_DESC_DONE_SENT        = 5,  // B
+    ET_DESC_DONE_RECV        = 6,  // A
+    ET_TUSB_INIT             = 7,  // A: TinyUSB device stack started
+    ET_TUD_MOUNT             = 8,  // A: tud_mount_cb
+    ET_READY_SENT            = 9,  // A
+    ET_READY_RECV            = 10, // B
+    ET_FIRST_INPUT_SENT      = 11, // B: first PF_INPUT after READY, arg=itf
+    ET_FIRST_INPUT_DELIVERED = 12, // A: first report accepted by tud_hid_n_report, arg=itf
+    ET_UNMOUNT               = 13, // B: physical device detached, arg=itf
+    ET_REPLUG_RESUME         = 14, // A: re-plugged device matched, PC link kept, arg=0
+    ET_DESC_GAPS_SENT        = 15, // A: PF_CTRL_DESC_STATUS sent, arg=gap count
+    ET_DESC_GAPS_RECV        = 16  // B: PF_CTRL_DESC_STATUS served, arg=gap count
+} enum_trace_event_t;
+
+typedef struct
+{
+    uint32_t t_us;
+    uint8_t  board;
+    uint8_t  event;
+    uint16_t arg;
+} enum_trace_entry_t;
+
+// Wire form: t_us LE32, board, event, arg LE16.
+#define ENUM_TRACE_WIRE_SIZE 8u
+
+void     enum_trace_init(uint8_t board);
+void     enum_trace_reset(void);
+void     enum_trace_record(uint8_t event, uint16_t arg);
+// Records the event only once per enum_trace_reset() (first-input markers).
+void     enum_trace_record_once(uint8_t event, uint16_t arg);
+uint16_t enum_trace_count(void);
+// Encodes up to `max_entries` local entries, oldest first, starting at `start`.
+uint16_t enum_trace_encode(uint16_t start, uint8_t* out, uint16_t max_entries);
+
+// B_host side: entries pulled from A_device. `offset_us` is A clock minus B clock.
+void     enum_trace_remote_reset(void);
+void     enum_trace_remote_ingest(int32_t offset_us, uint8_t const* data, uint16_t count);
+uint16_t enum_trace_remote_count(void);
+
+// Freezes local + remote entries into one time-sorted timeline (relative to the
+// earliest event) and returns its length; pages are then read with
+// enum_trace_snapshot_encode() so they stay consistent across requests.
+uint16_t enum_trace_snapshot(void);
+uint16_t enum_trace_snapshot_encode(uint16_t start, uint8_t* out, uint16_t max_entries);
@@ -1,4 +1,6 @@
 // common/i2c_link.c
+#define LOG_MODULE LOG_MOD_LINK
+
 #include "i2c_link.h"
 #include "logging.h"
 
@@ -1,3 +1,300 @@
 #include "logging.h"
 
+#include <string.h>
+
+#include "pico/time.h"
+#include "hardware/sync.h"
+#include "hardware/uart.h"
+
+#if (LOG_RING_WORDS & (LOG_RING_WORDS - 1u)) != 0
+#error "LOG_RING_WORDS must be a power of two"
+#endif
+
+// Entry: header, format address (the token), time_us_32(), then one word per
+// argument; a string argument is its length followed by its bytes, padded to
+// whole words. The header is written last: 0 means "reserved, not yet
+// complete", so the drain stops there and entries leave in call order.
+#define LOG_HDR_WORDS 3u
+#define LOG_RING_MASK (LOG_RING_WORDS - 1u)
+
+#define LOG_HDR(words, level, module, nargs) \
+    ((uint32_t)(words) | ((uint32_t)(level) << 8) | ((uint32_t)(module) << 11) | ((uint32_t)(nargs) << 16))
+#define LOG_HDR_WORDS_OF(h) ((h) & 0xFFu)
+#define LOG_HDR_LEVEL(h)    (((h) >> 8) & 0x07u)
+#define LOG_HDR_NARGS(h)    (((h) >> 16) & 0x1Fu)
+
 volatile uint8_t g_log_level = LOG_LEVEL;
+
+static uint32_t          s_ring[LOG_RING_WORDS];
+static volatile uint32_t s_head = 0;   // reserved up to here
+static volatile uint32_t s_tail = 0;   // drained up to here
+static volatile uint32_t s_dropped = 0;
+static uint32_t          s_dropped_reported = 0;
+static uint32_t          s_written = 0;
+static uint32_t          s_high_water = 0;
+static uint8_t           s_drain = LOG_DRAIN;
+
+// Text of the entry being written out; +2 for the line end.
+#define LOG_LINE_MAX 160u
+static char              s_line[LOG_LINE_MAX + 2u];
+static uint16_t          s_line_len = 0;
+static uint16_t          s_line_pos = 0;
+
+// Call sites run in the main loop and in IRQ handlers on one core: the
+// reservation is a few instructions with IRQs off, the copy runs with them on.
+void logging_push(uint8_t level, uint8_t module, char const* fmt, uint8_t nargs,
+                  uintptr_t const* args, uint32_t str_mask)
+{
+    if (nargs > LOG_MAX_ARGS) nargs = LOG_MAX_ARGS;
+    uint8_t slen[LOG_MAX_ARGS];
+    uint32_t words = LOG_HDR_WORDS + nargs;
+    for (uint8_t i = 0; i < nargs; i++)
+    {
+        if (!(str_mask & (1u << i))) continue;
+        char const* s = (char const*)args[i];
+        slen[i] = s ? (uint8_t)strnlen(s, LOG_STR_MAX) : 0;
+        words += (slen[i] + 3u) / 4u;
+    }
+
+    uint32_t irq = save_and_disable_interrupts();
+    uint32_t head = s_head;
+    uint32_t used = head - s_tail;
+    if (words > LOG_RING_WORDS - used)
+    {
+        s_dropped++;
+        restore_interrupts(irq);
+        return;
+    }
+    s_head = head + words;
+    s_ring[head & LOG_RING_MASK] = 0;
+    s_written++;
+    if (used + words > s_high_water) s_high_water = used + words;
+    restore_interrupts(irq);
+
+    uint32_t pos = head + 1u;
+    s_ring[pos++ & LOG_RING_MASK] = (uint32_t)(uintptr_t)fmt;
+    s_ring[pos++ & LOG_RING_MASK] = time_us_32();
+    for (uint8_t i = 0; i < nargs; i++)
+    {
+        if (!(str_mask & (1u << i)))
+        {
+            s_ring[pos++ & LOG_RING_MASK] = (uint32_t)args[i];
+            continue;
+        }
+        char const* s = (char const*)args[i];
+        s_ring[pos++ & LOG_RING_MASK] = slen[i];
+        for (uint8_t off = 0; off < slen[i]; off += 4u)
+        {
+            uint32_t w = 0;
+            for (uint8_t b = 0; b < 4u && off + b < slen[i]; b++)
+            {
+                w |= (uint32_t)(uint8_t)s[off + b] << (8u * b);
+            }
+            s_ring[pos++ & LOG_RING_MASK] = w;
+        }
+    }
+    __compiler_memory_barrier();
+    s_ring[head & LOG_RING_MASK] = LOG_HDR(words, level, module, nargs);
+}
+
+// Header of the oldest complete entry, 0 when there is none.
+static uint32_t oldest_entry(void)
+{
+    if (s_tail == s_head) return 0;
+    return s_ring[s_tail & LOG_RING_MASK];
+}
+
+static void release_entry(uint32_t hdr)
+{
+    s_tail = s_tail + LOG_HDR_WORDS_OF(hdr);
+}
+
+// Appends printf output to the pending line, cut at the buffer end.
+static void line_add(char const* spec, uint32_t w, char const* text)
+{
+    size_t room = sizeof(s_line) - 2u - s_line_len;   // "\r\n" always fits
+    int n = text ? snprintf(&s_line[s_line_len], room, spec, text)
+                 : snprintf(&s_line[s_line_len], room, spec, w);
+    if (n > 0) s_line_len = (uint16_t)(s_line_len + ((size_t)n < room ? (size_t)n : room - 1u));
+}
+
+static void format_entry(uint32_t hdr)
+{
+    static char const k_tags[5][5] = { "", "[E] ", "[W] ", "[I] ", "[T] " };
+    uint32_t pos = s_tail + 1u;
+    char const* fmt = (char const*)(uintptr_t)s_ring[pos++ & LOG_RING_MASK];
+    pos++;  // timestamp: text lines look as they did without the ring
+    uint8_t nargs = (uint8_t)LOG_HDR_NARGS(hdr);
+    uint8_t level = (uint8_t)LOG_HDR_LEVEL(hdr);
+    line_add("%s", 0, k_tags[level < 5 ? level : 0]);
+
+    // One snprintf per conversion, each with its single stored argument.
+    uint8_t arg = 0;
+    while (*fmt)
+    {
+        char spec[12];
+        uint8_t n = 0;
+        if (*fmt != '%')
+        {
+            while (*fmt && *fmt != '%' && n < sizeof(spec) - 1u) spec[n++] = *fmt++;
+            spec[n] = '\0';
+            line_add("%s", 0, spec);
+            continue;
+        }
+        spec[n++] = *fmt++;
+        while (*fmt && n < sizeof(spec) - 2u && !strchr("diouxXcsp%", *fmt)) spec[n++] = *fmt++;
+        if (!*fmt) break;
+        char conv = *fmt++;
+        spec[n++] = conv;
+        spec[n] = '\0';
+        if (conv == '%')
+        {
+            line_add("%%", 0, NULL);
+            continue;
+        }
+        if (arg++ >= nargs) continue;
+
+        uint32_t w = s_ring[pos++ & LOG_RING_MASK];
+        if (conv != 's')
+        {
+            line_add(spec, w, NULL);
+            continue;
+        }
+        char text[LOG_STR_MAX + 1u];
+        uint32_t len = w < LOG_STR_MAX ? w : LOG_STR_MAX;
+        for (uint32_t i = 0; i < len; i += 4u)
+        {
+            uint32_t bytes = s_ring[pos++ & LOG_RING_MASK];
+            for (uint32_t b = 0; b < 4u && i + b < len; b++) text[i + b] = (char)(bytes >> (8u * b));
+        }
+        text[len] = '\0';
+        line_add(spec, 0, text);
+    }
+}
+
+static void format_record(uint32_t hdr)
+{
+    // "@L" then every word of the entry as 8 hex digits; tools/logdecode turns
+    // it back into text with the format strings from the ELF.
+    line_add("@L", 0, NULL);
+    for (uint32_t i = 0; i < LOG_HDR_WORDS_OF(hdr); i++)
+    {
+        line_add("%08lx", s_ring[(s_tail + i) & LOG_RING_MASK], NULL);
+    }
+}
+
+static void line_end(void)
+{
+    s_line[s_line_len++] = '\r';
+    s_line[s_line_len++] = '\n';
+    s_line_pos = 0;
+}
+
+// Feeds the pending line to the stdio UART only while its TX FIFO has room,
+// so a drain pass never waits for the wire.
+static bool line_pump(bool block)
+{
+#ifdef uart_default
+    while (s_line_pos < s_line_len && (block || uart_is_writable(uart_default)))
+    {
+        uart_putc_raw(uart_default, s_line[s_line_pos++]);
+    }
+#else
+    (void)block;
+    fwrite(&s_line[s_line_pos], 1, (size_t)(s_line_len - s_line_pos), stdout);
+    s_line_pos = s_line_len;
+#endif
+    if (s_line_pos < s_line_len) return false;
+    s_line_len = 0;
+    s_line_pos = 0;
+    return true;
+}
+
+static bool drain_one(uint8_t mode, bool block)
+{
+    if (!line_pump(block)) return true;
+
+    uint32_t hdr = oldest_entry();
+    if (!hdr)
+    {
+        uint32_t dropped = s_dropped;
+        if (dropped == s_dropped_reported) return false;
+        line_add("[W] [LOG] %lu entries dropped (ring full)", dropped - s_dropped_reported, NULL);
+        s_dropped_reported = dropped;
+    }
+    else
+    {
+        if (mode == LOG_DRAIN_RECORDS) format_record(hdr);
+        else format_entry(hdr);
+        release_entry(hdr);
+    }
+    line_end();
+    line_pump(block);
+    return true;
+}
+
+void logging_task(void)
+{
+    if (s_drain == LOG_DRAIN_HOLD)
+    {
+        if (s_line_len) (void)line_pump(false);
+        return;
+    }
+    (void)drain_one(s_drain, false);
+}
+
+void logging_flush(void)
+{
+    uint8_t mode = s_drain == LOG_DRAIN_RECORDS ? LOG_DRAIN_RECORDS : LOG_DRAIN_TEXT;
+    while (drain_one(mode, true))
+    {
+    }
+}
+
+void logging_set_drain(uint8_t mode)
+{
+    if (mode <= LOG_DRAIN_HOLD) s_drain = mode;
+}
+
+uint8_t logging_get_drain(void)
+{
+    return s_drain;
+}
+
+uint16_t logging_read(uint8_t* out, uint16_t max_len)
+{
+    uint16_t len = 0;
+    for (;;)
+    {
+        uint32_t hdr = oldest_entry();
+        if (!hdr) break;
+        uint32_t bytes = LOG_HDR_WORDS_OF(hdr) * 4u;
+        if (bytes > max_len)
+        {
+            // Never fits the reader's buffer: drop it rather than stall.
+            release_entry(hdr);
+            s_dropped++;
+            continue;
+        }
+        if (len + bytes > max_len) break;
+        for (uint32_t i = 0; i < LOG_HDR_WORDS_OF(hdr); i++)
+        {
+            uint32_t w = s_ring[(s_tail + i) & LOG_RING_MASK];
+            out[len++] = (uint8_t)w;
+            out[len++] = (uint8_t)(w >> 8);
+            out[len++] = (uint8_t)(w >> 16);
+            out[len++] = (uint8_t)(w >> 24);
+        }
+        release_entry(hdr);
+    }
+    return len;
+}
+
+void logging_get_stats(logging_stats_t* out)
+{
+    if (!out) return;
+    out->used_words = s_head - s_tail;
+    out->high_water = s_high_water;
+    out->written = s_written;
+    out->dropped = s_dropped;
+}
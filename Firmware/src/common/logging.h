@@ -3,12 +3,82 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifndef LOG_LEVEL
 // 0 = off, 1 = errors, 2 = warn, 3 = info, 4 = trace
 #define LOG_LEVEL 4
 #endif
 
+// Deferred (tokenized) logging. A call site stores the address of its format
+// string and its arguments as raw 32-bit words in a RAM ring; logging_task()
+// turns them into output from the main loop, so hot paths never wait for the
+// stdio UART. 0 = printf at the call site, as before.
+#ifndef LOG_DEFERRED
+#define LOG_DEFERRED 1
+#endif
+
+// Where logging_task() sends entries (runtime: logging_set_drain()):
+// 0 = text on stdio, 1 = "@L" hex records on stdio, decoded on the host
+// against the ELF by tools/logdecode, 2 = held for the control channel
+// (B_host LOG_READ, cmd 0x17).
+#define LOG_DRAIN_TEXT    0u
+#define LOG_DRAIN_RECORDS 1u
+#define LOG_DRAIN_HOLD    2u
+#ifndef LOG_DRAIN
+#define LOG_DRAIN LOG_DRAIN_TEXT
+#endif
+
+#ifndef LOG_RING_WORDS
+#define LOG_RING_WORDS 2048u   // power of two; 8 KB
+#endif
+
+#ifndef LOG_STR_MAX
+#define LOG_STR_MAX 64u        // %s arguments are copied, cut to this length
+#endif
+
+#define LOG_MAX_ARGS 16u
+
+// Compile-time level per module: a file picks its module with
+// `#define LOG_MODULE LOG_MOD_HOST` above its includes, and LOGx calls above
+// that module's level compile to nothing. Override with -DLOG_LEVEL_HOST=2 etc.
+#define LOG_MOD_CORE 0u
+#define LOG_MOD_HOST 1u   // B_host USB host and HID forwarding
+#define LOG_MOD_CTRL 2u   // B_host control UART
+#define LOG_MOD_LINK 3u   // inter-board UART transport and framing
+#define LOG_MOD_DESC 4u   // B_host descriptor / string dumps
+#define LOG_MOD_DEV  5u   // A_device
+
+#ifndef LOG_LEVEL_CORE
+#define LOG_LEVEL_CORE LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_HOST
+#define LOG_LEVEL_HOST LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_CTRL
+#define LOG_LEVEL_CTRL LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_LINK
+#define LOG_LEVEL_LINK LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_DESC
+#define LOG_LEVEL_DESC LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_DEV
+#define LOG_LEVEL_DEV LOG_LEVEL
+#endif
+
+#ifndef LOG_MODULE
+#define LOG_MODULE LOG_MOD_CORE
+#endif
+
+#define LOG_MODULE_LEVEL                                   \
+    (LOG_MODULE == LOG_MOD_HOST ? LOG_LEVEL_HOST :         \
+     LOG_MODULE == LOG_MOD_CTRL ? LOG_LEVEL_CTRL :         \
+     LOG_MODULE == LOG_MOD_LINK ? LOG_LEVEL_LINK :         \
+     LOG_MODULE == LOG_MOD_DESC ? LOG_LEVEL_DESC :         \
+     LOG_MODULE == LOG_MOD_DEV  ? LOG_LEVEL_DEV  : LOG_LEVEL_CORE)
+
 extern volatile uint8_t g_log_level;
 
 static inline uint8_t logging_get_level(void)
@@ -21,7 +91,78 @@ static inline void logging_set_level(uint8_t level)
     g_log_level = level;
 }
 
-#define LOGE(fmt, ...) do { if (logging_get_level() >= 1) printf("[E] " fmt "\n", ##__VA_ARGS__); } while(0)
-#define LOGW(fmt, ...) do { if (logging_get_level() >= 2) printf("[W] " fmt "\n", ##__VA_ARGS__); } while(0)
-#define LOGI(fmt, ...) do { if (logging_get_level() >= 3) printf("[I] " fmt "\n", ##__VA_ARGS__); } while(0)
-#define LOGT(fmt, ...) do { if (logging_get_level() >= 4) printf("[T] " fmt "\n", ##__VA_ARGS__); } while(0)
+typedef struct
+{
+    uint32_t used_words;
+    uint32_t high_water;
+    uint32_t written;
+    uint32_t dropped;      // ring full at the call site
+} logging_stats_t;
+
+// Call-site half of the deferred path; use the LOGx macros.
+void logging_push(uint8_t level, uint8_t module, char const* fmt, uint8_t nargs,
+                  uintptr_t const* args, uint32_t str_mask);
+
+// Main loop: drains at most one entry per call in the current drain mode.
+void logging_task(void);
+// Drains everything as text; for paths that are about to stop the main loop.
+void logging_flush(void);
+void logging_set_drain(uint8_t mode);
+uint8_t logging_get_drain(void);
+// Moves whole entries (LE words, as in the ring) into `out`; returns bytes.
+uint16_t logging_read(uint8_t* out, uint16_t max_len);
+void logging_get_stats(logging_stats_t* out);
+
+// Argument plumbing: count, walk, and spot string arguments at compile time.
+#define LOG_NARG(...) LOG_NARG_(_, ##__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_NARG_(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, N, ...) N
+#define LOG_CAT(a, b)  LOG_CAT_(a, b)
+#define LOG_CAT_(a, b) a##b
+#define LOG_FOR_EACH(M, ...) LOG_CAT(LOG_FE_, LOG_NARG(__VA_ARGS__))(M, ##__VA_ARGS__)
+#define LOG_FE_0(M)
+#define LOG_FE_1(M, a0) M(0, a0)
+#define LOG_FE_2(M, a0, a1) M(0, a0) M(1, a1)
+#define LOG_FE_3(M, a0, a1, a2) M(0, a0) M(1, a1) M(2, a2)
+#define LOG_FE_4(M, a0, a1, a2, a3) M(0, a0) M(1, a1) M(2, a2) M(3, a3)
+#define LOG_FE_5(M, a0, a1, a2, a3, a4) M(0, a0) M(1, a1) M(2, a2) M(3, a3) M(4, a4)
+#define LOG_FE_6(M, a0, a1, a2, a3, a4, a5) M(0, a0) M(1, a1) M(2, a2) M(3, a3) M(4, a4) M(5, a5)
+#define LOG_FE_7(M, a0, a1, a2, a3, a4, a5, a6) M(0, a0) M(1, a1) M(2, a2) M(3, a3) M(4, a4) M(5, a5) M(6, a6)
+#define LOG_FE_8(M, a0, a1, a2, a3, a4, a5, a6, a7) M(0, a0) M(1, a1) M(2, a2) M(3, a3) M(4, a4) M(5, a5) M(6, a6) M(7, a7)
+#define LOG_FE_9(M, a0, a1, a2, a3, a4, a5, a6, a7, a8) M(0, a0) M(1, a1) M(2, a2) M(3, a3) M(4, a4) M(5, a5) M(6, a6) M(7, a7) M(8, a8)
+#define LOG_FE_10(M, a0, a1, a2, a3, a4, a5, a6, a7, a8, a9) M(0, a0) M(1, a1) M(2, a2) M(3, a3) M(4, a4) M(5, a5) M(6, a6) M(7, a7) M(8, a8) M(9, a9)
+#define LOG_FE_11(M, a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10) M(0, a0) M(1, a1) M(2, a2) M(3, a3) M(4, a4) M(5, a5) M(6, a6) M(7, a7) M(8, a8) M(9, a9) M(10, a10)
+#define LOG_FE_12(M, a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11) M(0, a0) M(1, a1) M(2, a2) M(3, a3) M(4, a4) M(5, a5) M(6, a6) M(7, a7) M(8, a8) M(9, a9) M(10, a10) M(11, a11)
+#define LOG_FE_13(M, a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12) M(0, a0) M(1, a1) M(2, a2) M(3, a3) M(4, a4) M(5, a5) M(6, a6) M(7, a7) M(8, a8) M(9, a9) M(10, a10) M(11, a11) M(12, a12)
+#define LOG_FE_14(M, a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13) M(0, a0) M(1, a1) M(2, a2) M(3, a3) M(4, a4) M(5, a5) M(6, a6) M(7, a7) M(8, a8) M(9, a9) M(10, a10) M(11, a11) M(12, a12) M(13, a13)
+#define LOG_FE_15(M, a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14) M(0, a0) M(1, a1) M(2, a2) M(3, a3) M(4, a4) M(5, a5) M(6, a6) M(7, a7) M(8, a8) M(9, a9) M(10, a10) M(11, a11) M(12, a12) M(13, a13) M(14, a14)
+#define LOG_FE_16(M, a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15) M(0, a0) M(1, a1) M(2, a2) M(3, a3) M(4, a4) M(5, a5) M(6, a6) M(7, a7) M(8, a8) M(9, a9) M(10, a10) M(11, a11) M(12, a12) M(13, a13) M(14, a14) M(15, a15)
+
+#define LOG_IS_STR(x)   _Generic((x), char*: 1u, char const*: 1u, default: 0u)
+#define LOG_ARG_(i, x)  , (uintptr_t)(x)
+#define LOG_SBIT_(i, x) | (LOG_IS_STR(x) << (i))
+
+static inline void __attribute__((format(printf, 1, 2))) logging_check_format(char const* fmt, ...)
+{
+    (void)fmt;
+}
+
+#if LOG_DEFERRED
+#define LOG_EMIT(lvl, tag, fmt, ...) do {                                            \
+        if (0) logging_check_format(fmt, ##__VA_ARGS__);                              \
+        uintptr_t const log_args_[] = { 0 LOG_FOR_EACH(LOG_ARG_, ##__VA_ARGS__) };    \
+        logging_push((lvl), LOG_MODULE, fmt, LOG_NARG(__VA_ARGS__), &log_args_[1],    \
+                     0u LOG_FOR_EACH(LOG_SBIT_, ##__VA_ARGS__));                       \
+    } while (0)
+#else
+#define LOG_EMIT(lvl, tag, fmt, ...) printf(tag fmt "\n", ##__VA_ARGS__)
+#endif
+
+#define LOG_AT(lvl, tag, fmt, ...) do {                                              \
+        if ((lvl) <= LOG_MODULE_LEVEL && logging_get_level() >= (lvl))                \
+            LOG_EMIT(lvl, tag, fmt, ##__VA_ARGS__);                                   \
+    } while (0)
+
+#define LOGE(fmt, ...) LOG_AT(1, "[E] ", fmt, ##__VA_ARGS__)
+#define LOGW(fmt, ...) LOG_AT(2, "[W] ", fmt, ##__VA_ARGS__)
+#define LOGI(fmt, ...) LOG_AT(3, "[I] ", fmt, ##__VA_ARGS__)
+#define LOGT(fmt, ...) LOG_AT(4, "[T] ", fmt, ##__VA_ARGS__)
@@ -0,0 +1,257 @@
+// common/metrics.c
+#include "metrics.h"
+
+#include <string.h>
+
+spin_lock_t* g_metrics_lock = NULL;
+
+static metric_t*           s_head = NULL;
+static metric_t*           s_tail = NULL;
+static uint8_t             s_count = 0;
+static metrics_collector_t s_collectors[METRICS_MAX_COLLECTORS];
+static uint8_t             s_collector_n = 0;
+
+void metrics_init(void)
+{
+    if (g_metrics_lock) return;
+    int num = spin_lock_claim_unused(false);
+    if (num >= 0)
+    {
+        g_metrics_lock = spin_lock_init((uint)num);
+    }
+}
+
+uint8_t metrics_hist_bucket(uint32_t v)
+{
+    if (v < METRICS_HIST_LINEAR) return (uint8_t)v;
+    uint32_t e = 31u - (uint32_t)__builtin_clz(v);
+    uint32_t sub = (v >> (e - METRICS_HIST_SUB_BITS)) & ((1u << METRICS_HIST_SUB_BITS) - 1u);
+    uint32_t b = METRICS_HIST_LINEAR + ((e - 3u) << METRICS_HIST_SUB_BITS) + sub;
+    return (uint8_t)(b < METRICS_HIST_BUCKETS ? b : METRICS_HIST_BUCKETS - 1u);
+}
+
+uint32_t metrics_hist_bucket_floor(uint8_t bucket)
+{
+    if (bucket < METRICS_HIST_LINEAR) return bucket;
+    uint32_t i = bucket - METRICS_HIST_LINEAR;
+    uint32_t e = 3u + (i >> METRICS_HIST_SUB_BITS);
+    uint32_t sub = i & ((1u << METRICS_HIST_SUB_BITS) - 1u);
+    return ((1u << METRICS_HIST_SUB_BITS) + sub) << (e - METRICS_HIST_SUB_BITS);
+}
+
+void metric_max(metric_t* m, uint32_t v)
+{
+    uint32_t saved = metrics_lock();
+    if (v > m->value) m->value = v;
+    metrics_unlock(saved);
+}
+
+void metric_observe(metric_t* m, uint32_t v)
+{
+    metric_hist_t* h = m->hist;
+    if (!h) return;
+    uint8_t b = metrics_hist_bucket(v);
+
+    uint32_t saved = metrics_lock();
+    h->count++;
+    h->sum += v;
+    if (v < h->min) h->min = v;
+    if (v > h->max) h->max = v;
+    h->buckets[b]++;
+    metrics_unlock(saved);
+}
+
+void metrics_register(metric_t* m)
+{
+    if (!m || m->registered || s_count == UINT8_MAX) return;
+    m->registered = true;
+    m->next = NULL;
+    if (s_tail) s_tail->next = m;
+    else s_head = m;
+    s_tail = m;
+    s_count++;
+}
+
+uint8_t metrics_count(void)
+{
+    return s_count;
+}
+
+void metrics_add_collector(metrics_collector_t fn)
+{
+    if (!fn) return;
+    for (uint8_t i = 0; i < s_collector_n; i++)
+    {
+        if (s_collectors[i] == fn) return;
+    }
+    if (s_collector_n < METRICS_MAX_COLLECTORS) s_collectors[s_collector_n++] = fn;
+}
+
+// ------------------------------------------------------
+// Wire encoding
+// ------------------------------------------------------
+
+static uint8_t varint_size(uint64_t v)
+{
+    uint8_t n = 1;
+    while (v >= 0x80u)
+    {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+static uint8_t* varint_put(uint8_t* p, uint64_t v)
+{
+    while (v >= 0x80u)
+    {
+        *p++ = (uint8_t)(v | 0x80u);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+// Returns the bytes written, 0 if the metric does not fit. With `trim` a
+// histogram drops its top buckets rather than fail.
+static uint16_t encode_one(metric_t const* m, uint8_t* out, uint16_t room, bool trim)
+{
+    size_t name_len = strlen(m->name);
+    if (name_len > METRICS_NAME_MAX) name_len = METRICS_NAME_MAX;
+    uint16_t need = (uint16_t)(2u + name_len);
+
+    metric_hist_t h = { 0 };  // only filled for histograms
+    uint8_t first = 0;
+    uint8_t n = 0;
+    if (m->kind == METRIC_HISTOGRAM)
+    {
+        // Copy under the lock so count, sum and buckets agree.
+        uint32_t saved = metrics_lock();
+        h = *m->hist;
+        metrics_unlock(saved);
+        if (!h.count) h.min = 0;
+
+        uint8_t last = 0;
+        bool any = false;
+        for (uint8_t b = 0; b < METRICS_HIST_BUCKETS; b++)
+        {
+            if (!h.buckets[b]) continue;
+            if (!any) first = b;
+            last = b;
+            any = true;
+        }
+        n = any ? (uint8_t)(last - first + 1u) : 0;
+
+        need = (uint16_t)(need + varint_size(h.count) + varint_size(h.sum) +
+                          varint_size(h.min) + varint_size(h.max) + 2u);
+        if (need > room) return 0;
+        uint16_t span = 0;
+        uint8_t fit = 0;
+        while (fit < n && need + span + varint_size(h.buckets[first + fit]) <= room)
+        {
+            span = (uint16_t)(span + varint_size(h.buckets[first + fit]));
+            fit++;
+        }
+        if (fit < n && !trim) return 0;
+        n = fit;
+        need = (uint16_t)(need + span);
+    }
+    else
+    {
+        need = (uint16_t)(need + varint_size(m->value));
+        if (need > room) return 0;
+    }
+
+    uint8_t* p = out;
+    *p++ = m->kind;
+    *p++ = (uint8_t)name_len;
+    memcpy(p, m->name, name_len);
+    p += name_len;
+    if (m->kind == METRIC_HISTOGRAM)
+    {
+        p = varint_put(p, h.count);
+        p = varint_put(p, h.sum);
+        p = varint_put(p, h.min);
+        p = varint_put(p, h.max);
+        *p++ = first;
+        *p++ = n;
+        for (uint8_t i = 0; i < n; i++)
+        {
+            p = varint_put(p, h.buckets[first + i]);
+        }
+    }
+    else
+    {
+        p = varint_put(p, m->value);
+    }
+    return (uint16_t)(p - out);
+}
+
+uint16_t metrics_encode(uint8_t start, uint8_t* out, uint16_t max, uint8_t* count)
+{
+    if (count) *count = 0;
+    if (!out) return 0;
+
+    if (start == 0)
+    {
+        for (uint8_t i = 0; i < s_collector_n; i++)
+        {
+            s_collectors[i]();
+        }
+    }
+
+    metric_t const* m = s_head;
+    for (uint8_t i = 0; m && i < start; i++)
+    {
+        m = m->next;
+    }
+
+    uint16_t used = 0;
+    uint8_t n = 0;
+    for (; m; m = m->next)
+    {
+        uint16_t w = encode_one(m, &out[used], (uint16_t)(max - used), n == 0);
+        if (!w) break;
+        used = (uint16_t)(used + w);
+        n++;
+    }
+    if (count) *count = n;
+    return used;
+}
+
+static uint16_t varint_skip(uint8_t const* p, uint16_t len, uint16_t at)
+{
+    for (uint8_t i = 0; i < 10 && at < len; i++)
+    {
+        if (!(p[at++] & 0x80u)) return at;
+    }
+    return 0;
+}
+
+uint16_t metrics_entry_size(uint8_t const* p, uint16_t len)
+{
+    if (!p || len < 2) return 0;
+    uint8_t kind = p[0];
+    uint16_t at = (uint16_t)(2u + p[1]);
+    if (at > len) return 0;
+
+    uint8_t fields = (kind == METRIC_HISTOGRAM) ? 4u : (kind <= METRIC_GAUGE ? 1u : 0u);
+    if (!fields) return 0;
+    for (uint8_t i = 0; i < fields; i++)
+    {
+        at = varint_skip(p, len, at);
+        if (!at) return 0;
+    }
+    if (kind != METRIC_HISTOGRAM) return at;
+
+    if ((uint16_t)(at + 2u) > len) return 0;
+    uint8_t n = p[at + 1u];
+    at = (uint16_t)(at + 2u);
+    for (uint8_t i = 0; i < n; i++)
+    {
+        at = varint_skip(p, len, at);
+        if (!at) return 0;
+    }
+    return at;
+}
@@ -0,0 +1,132 @@
+// common/metrics.h
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "hardware/sync.h"
+
+// Metrics registry shared by both boards: named counters, gauges and
+// log-linear histograms. A module defines its metrics statically and registers
+// them once at init. Updates take a hardware spin lock for a few instructions,
+// so they are safe from IRQ handlers and from either core. GET_METRICS
+// (control UART 0x18) serves the B_host registry and the A_device registry
+// pulled over the link (PF_CTRL_METRICS_REQ / PF_CTRL_METRICS_DATA).
+
+typedef enum
+{
+    METRIC_COUNTER   = 0,  // monotonic since boot
+    METRIC_GAUGE     = 1,  // current value
+    METRIC_HISTOGRAM = 2   // distribution since boot
+} metric_kind_t;
+
+// Histogram buckets: values below METRICS_HIST_LINEAR get one bucket each,
+// above that every power of two splits into 1 << METRICS_HIST_SUB_BITS equal
+// buckets. The last bucket is open-ended (from 114688 up).
+#define METRICS_HIST_LINEAR   8u
+#define METRICS_HIST_SUB_BITS 2u
+#define METRICS_HIST_BUCKETS  64u
+
+// Names longer than this are cut on the wire.
+#define METRICS_NAME_MAX      32u
+#define METRICS_MAX_COLLECTORS 4u
+
+typedef struct
+{
+    uint32_t count;
+    uint64_t sum;
+    uint32_t min;
+    uint32_t max;
+    uint32_t buckets[METRICS_HIST_BUCKETS];
+} metric_hist_t;
+
+typedef struct metric_s
+{
+    char const*      name;
+    uint8_t          kind;     // metric_kind_t
+    bool             registered;
+    struct metric_s* next;
+    uint32_t         value;    // counter / gauge
+    metric_hist_t*   hist;     // histogram only
+} metric_t;
+
+#define METRIC_COUNTER_DEFINE(var, metric_name) \
+    static metric_t var = { .name = (metric_name), .kind = METRIC_COUNTER }
+#define METRIC_GAUGE_DEFINE(var, metric_name) \
+    static metric_t var = { .name = (metric_name), .kind = METRIC_GAUGE }
+#define METRIC_HISTOGRAM_DEFINE(var, metric_name)                   \
+    static metric_hist_t var##_hist = { .min = UINT32_MAX };        \
+    static metric_t var = { .name = (metric_name), .kind = METRIC_HISTOGRAM, .hist = &var##_hist }
+
+// Claims the spin lock. Until then updates fall back to masking IRQs, so a
+// module may count before main() reaches metrics_init().
+void metrics_init(void);
+
+extern spin_lock_t* g_metrics_lock;
+
+static inline uint32_t metrics_lock(void)
+{
+    return g_metrics_lock ? spin_lock_blocking(g_metrics_lock) : save_and_disable_interrupts();
+}
+
+static inline void metrics_unlock(uint32_t saved)
+{
+    if (g_metrics_lock) spin_unlock(g_metrics_lock, saved);
+    else restore_interrupts(saved);
+}
+
+static inline void metric_add(metric_t* m, uint32_t n)
+{
+    uint32_t saved = metrics_lock();
+    m->value += n;
+    metrics_unlock(saved);
+}
+
+static inline void metric_inc(metric_t* m)
+{
+    metric_add(m, 1);
+}
+
+// Aligned 32-bit stores are atomic: no lock needed.
+static inline void metric_set(metric_t* m, uint32_t v)
+{
+    m->value = v;
+}
+
+static inline uint32_t metric_value(metric_t const* m)
+{
+    return m->value;
+}
+
+// Raises a gauge to `v` if it is below (high-water marks).
+void metric_max(metric_t* m, uint32_t v);
+void metric_observe(metric_t* m, uint32_t v);
+
+// Appends to the registry; registering twice is a no-op. Wire order is
+// registration order.
+void    metrics_register(metric_t* m);
+uint8_t metrics_count(void);
+
+// Collectors run before a snapshot starts (metrics_encode with start 0) and
+// copy state kept elsewhere (link counters, queue depths) into metrics.
+typedef void (*metrics_collector_t)(void);
+void metrics_add_collector(metrics_collector_t fn);
+
+uint8_t  metrics_hist_bucket(uint32_t v);
+uint32_t metrics_hist_bucket_floor(uint8_t bucket);
+
+// Wire form of one metric (all integers LEB128 varints):
+//   kind, name_len, name
+//   counter / gauge: value
+//   histogram:       count, sum, min, max, first_bucket (byte), n (byte),
+//                    n bucket counts from first_bucket on
+// Buckets outside [first_bucket, first_bucket + n) are empty, except when a
+// histogram alone does not fit a page: its top buckets are cut and the
+// bucket counts add up to less than `count`.
+
+// Encodes registered metrics from index `start` while they fit in `max`
+// bytes. Returns the bytes written; `*count` gets the number of metrics.
+uint16_t metrics_encode(uint8_t start, uint8_t* out, uint16_t max, uint8_t* count);
+
+// Size of the encoded metric at `p`, 0 if it runs past `len` or is malformed.
+uint16_t metrics_entry_size(uint8_t const* p, uint16_t len);
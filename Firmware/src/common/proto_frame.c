@@ -1,4 +1,6 @@
 // common/proto_frame.c
+#define LOG_MODULE LOG_MOD_LINK
+
 #include "proto_frame.h"
 #include "crc16.h"
 #include "logging.h"
@@ -8,6 +10,8 @@
 #define PROTO_LOG_VERBOSE 0
 #endif
 
+static uint32_t s_crc_errors = 0;
+
 static void log_hexdump(const char* tag, const uint8_t* buf, uint16_t len)
 {
     if (!tag || !buf || !len) return;
@@ -80,6 +84,7 @@ bool proto_parse(const uint8_t *buf, uint16_t len, proto_frame_t *out)
     uint16_t crc_calc = crc16_ccitt(buf, PROTO_HEADER_SIZE + plen, 0xFFFF);
     if (crc_calc != crc_expected)
     {
+        s_crc_errors++;
         if (PROTO_LOG_VERBOSE)
         {
             LOGW("[PROTO] CRC mismatch calc=0x%04X exp=0x%04X len=%u", crc_calc, crc_expected, frame_len);
@@ -102,6 +107,11 @@ bool proto_parse(const uint8_t *buf, uint16_t len, proto_frame_t *out)
     return true;
 }
 
+uint32_t proto_crc_error_count(void)
+{
+    return s_crc_errors;
+}
+
 static int proto_build_common(uint8_t type, uint8_t cmd,
                               const uint8_t *payload, uint16_t plen,
                               uint8_t *out_buf, uint16_t out_max)
@@ -158,6 +168,44 @@ int proto_build_descriptor(uint8_t desc_cmd, const uint8_t *desc, uint16_t len,
     return proto_build_common(PF_DESCRIPTOR, desc_cmd, desc, len, out_buf, out_max);
 }
 
+int proto_build_desc_segment(const proto_desc_segment_t *seg,
+                             uint8_t *out_buf, uint16_t out_max)
+{
+    if (!seg || (seg->len && !seg->data)) return -1;
+    if (seg->len > PROTO_MAX_PAYLOAD_SIZE - PROTO_DESC_SEGMENT_HDR) return -1;
+
+    uint8_t payload[PROTO_MAX_PAYLOAD_SIZE];
+    payload[0] = seg->session;
+    payload[1] = seg->desc_cmd;
+    payload[2] = seg->itf;
+    le16_write(&payload[3], seg->offset);
+    le16_write(&payload[5], seg->total);
+    if (seg->len)
+    {
+        memcpy(&payload[PROTO_DESC_SEGMENT_HDR], seg->data, seg->len);
+    }
+    return proto_build_common(PF_DESCRIPTOR, PF_DESC_SEGMENT,
+                              payload, (uint16_t)(PROTO_DESC_SEGMENT_HDR + seg->len),
+                              out_buf, out_max);
+}
+
+bool proto_parse_desc_segment(const uint8_t *payload, uint16_t len,
+                              proto_desc_segment_t *seg)
+{
+    if (!payload || !seg || len < PROTO_DESC_SEGMENT_HDR) return false;
+
+    seg->session  = payload[0];
+    seg->desc_cmd = payload[1];
+    seg->itf      = payload[2];
+    seg->offset   = le16_read(&payload[3]);
+    seg->total    = le16_read(&payload[5]);
+    seg->data     = &payload[PROTO_DESC_SEGMENT_HDR];
+    seg->len      = (uint16_t)(len - PROTO_DESC_SEGMENT_HDR);
+
+    // A segment never reaches past its own descriptor.
+    return (uint32_t)seg->offset + seg->len <= seg->total;
+}
+
 int proto_build_unmount(uint8_t *out_buf, uint16_t out_max)
 {
     return proto_build_common(PF_UNMOUNT, 0, NULL, 0, out_buf, out_max);
@@ -175,6 +223,45 @@ int proto_build_ctrl_device_reset(uint8_t reason,
                               out_max);
 }
 
+int proto_build_ctrl_trace_req(uint32_t host_us,
+                               uint8_t *out_buf, uint16_t out_max)
+{
+    uint8_t payload[4];
+    le32_write(payload, host_us);
+    return proto_build_common(PF_CONTROL, PF_CTRL_TRACE_REQ,
+                              payload, sizeof(payload), out_buf, out_max);
+}
+
+int proto_build_ctrl_stats_req(uint8_t *out_buf, uint16_t out_max)
+{
+    return proto_build_common(PF_CONTROL, PF_CTRL_STATS_REQ,
+                              NULL, 0, out_buf, out_max);
+}
+
+int proto_build_ctrl_metrics_req(uint8_t *out_buf, uint16_t out_max)
+{
+    return proto_build_common(PF_CONTROL, PF_CTRL_METRICS_REQ,
+                              NULL, 0, out_buf, out_max);
+}
+
+bool proto_parse_ctrl_stats_data(const uint8_t *payload, uint16_t len,
+                                 proto_dev_stats_t *out)
+{
+    if (!payload || !out || len < PROTO_STATS_DATA_LEN) return false;
+
+    out->dev_us                  = le32_read(&payload[0]);
+    out->input_received          = le32_read(&payload[4]);
+    out->input_dropped_not_ready = le32_read(&payload[8]);
+    out->latency_min_ms          = le32_read(&payload[12]);
+    out->latency_max_ms          = le32_read(&payload[16]);
+    out->crc_errors              = le32_read(&payload[20]);
+    out->rx_ring_overflow        = le32_read(&payload[24]);
+    out->rx_frame_overflow       = le32_read(&payload[28]);
+    out->rx_ring_high_water      = le32_read(&payload[32]);
+    out->pending_reports         = payload[36];
+    return true;
+}
+
 int proto_build_ctrl_set_protocol(uint8_t itf_id, uint8_t protocol,
                                   uint8_t *out_buf, uint16_t out_max)
 {
@@ -229,6 +316,19 @@ int proto_build_ctrl_ready(uint8_t *out_buf, uint16_t out_max)
                               NULL, 0, out_buf, out_max);
 }
 
+int proto_build_ctrl_desc_resend(uint8_t *out_buf, uint16_t out_max)
+{
+    return proto_build_common(PF_CONTROL, PF_CTRL_DESC_RESEND,
+                              NULL, 0, out_buf, out_max);
+}
+
+int proto_build_ctrl_desc_status(const uint8_t *payload, uint16_t len,
+                                 uint8_t *out_buf, uint16_t out_max)
+{
+    return proto_build_common(PF_CONTROL, PF_CTRL_DESC_STATUS,
+                              payload, len, out_buf, out_max);
+}
+
 int proto_build_ctrl_string_req(uint8_t index, uint16_t langid,
                                 uint8_t *out_buf, uint16_t out_max)
 {
@@ -264,3 +364,65 @@ int proto_build_ctrl_get_report_resp(uint8_t itf_id, uint8_t rtype, uint8_t rid,
     return proto_build_common(PF_CONTROL, PF_CTRL_GET_REPORT,
                               buf, (uint16_t)(len + 3), out_buf, out_max);
 }
+
+int proto_build_ctrl_trace_data(uint32_t host_us, uint32_t dev_us,
+                                uint8_t total, uint8_t start,
+                                const uint8_t *entries, uint8_t count,
+                                uint8_t *out_buf, uint16_t out_max)
+{
+    uint16_t plen = (uint16_t)(PROTO_TRACE_DATA_HDR + (uint16_t)count * 8u);
+    if (plen > PROTO_MAX_PAYLOAD_SIZE) return -1;
+
+    uint8_t buf[PROTO_MAX_PAYLOAD_SIZE];
+    le32_write(&buf[0], host_us);
+    le32_write(&buf[4], dev_us);
+    buf[8]  = total;
+    buf[9]  = start;
+    buf[10] = count;
+    if (count && entries)
+    {
+        memcpy(&buf[PROTO_TRACE_DATA_HDR], entries, (size_t)count * 8u);
+    }
+    return proto_build_common(PF_CONTROL, PF_CTRL_TRACE_DATA,
+                              buf, plen, out_buf, out_max);
+}
+
+int proto_build_ctrl_metrics_data(uint32_t dev_us, uint8_t total, uint8_t start,
+                                  const uint8_t *entries, uint8_t count, uint16_t entries_len,
+                                  uint8_t *out_buf, uint16_t out_max)
+{
+    uint16_t plen = (uint16_t)(PROTO_METRICS_DATA_HDR + entries_len);
+    if (plen > PROTO_MAX_PAYLOAD_SIZE) return -1;
+
+    uint8_t buf[PROTO_MAX_PAYLOAD_SIZE];
+    le32_write(&buf[0], dev_us);
+    buf[4] = total;
+    buf[5] = start;
+    buf[6] = count;
+    if (entries_len && entries)
+    {
+        memcpy(&buf[PROTO_METRICS_DATA_HDR], entries, entries_len);
+    }
+    return proto_build_common(PF_CONTROL, PF_CTRL_METRICS_DATA,
+                              buf, plen, out_buf, out_max);
+}
+
+int proto_build_ctrl_stats_data(const proto_dev_stats_t *st,
+                                uint8_t *out_buf, uint16_t out_max)
+{
+    if (!st) return -1;
+
+    uint8_t buf[PROTO_STATS_DATA_LEN];
+    le32_write(&buf[0],  st->dev_us);
+    le32_write(&buf[4],  st->input_received);
+    le32_write(&buf[8],  st->input_dropped_not_ready);
+    le32_write(&buf[12], st->latency_min_ms);
+    le32_write(&buf[16], st->latency_max_ms);
+    le32_write(&buf[20], st->crc_errors);
+    le32_write(&buf[24], st->rx_ring_overflow);
+    le32_write(&buf[28], st->rx_frame_overflow);
+    le32_write(&buf[32], st->rx_ring_high_water);
+    buf[36] = st->pending_reports;
+    return proto_build_common(PF_CONTROL, PF_CTRL_STATS_DATA,
+                              buf, sizeof(buf), out_buf, out_max);
+}
@@ -26,7 +26,8 @@ typedef enum
     PF_DESC_HID      = 3,   // HID descriptor for a specific interface
     PF_DESC_REPORT   = 4,   // Full HID report descriptor (payload starts with itf_id)
     PF_DESC_STRING   = 5,   // USB string descriptor
-    PF_DESC_DONE     = 6    // Marker signalling descriptor transmission complete
+    PF_DESC_DONE     = 6,   // Marker signalling descriptor transmission complete
+    PF_DESC_SEGMENT  = 7    // Resumable DEVICE/CONFIG/REPORT bytes at an offset
 } proto_desc_cmd_t;
 
 // Control commands (inside PF_CONTROL)
@@ -38,9 +39,72 @@ typedef enum
     PF_CTRL_SET_IDLE     = 4,   // set idle
     PF_CTRL_READY        = 5,   // device ready for input stream
     PF_CTRL_STRING_REQ   = 6,   // request USB string descriptor
-    PF_CTRL_DEVICE_RESET = 7    // force TinyUSB disconnect/re-enumeration
+    PF_CTRL_DEVICE_RESET = 7,   // force TinyUSB disconnect/re-enumeration
+    PF_CTRL_TRACE_REQ    = 8,   // B_host -> A_device: send enumeration trace ring
+    PF_CTRL_TRACE_DATA   = 9,   // A_device -> B_host: one page of trace entries
+    PF_CTRL_DESC_RESEND  = 10,  // A_device -> B_host: re-plug digest mismatch, send descriptors again
+    PF_CTRL_STATS_REQ    = 11,  // B_host -> A_device: send a counter snapshot
+    PF_CTRL_STATS_DATA   = 12,  // A_device -> B_host: counter snapshot (proto_dev_stats_t)
+    PF_CTRL_METRICS_REQ  = 13,  // B_host -> A_device: send the metrics registry
+    PF_CTRL_METRICS_DATA = 14,  // A_device -> B_host: one page of encoded metrics
+    PF_CTRL_DESC_STATUS  = 15   // A_device -> B_host: byte ranges a descriptor session still lacks
 } proto_ctrl_cmd_t;
 
+// PF_CTRL_TRACE_DATA payload: host_us echo (4) + dev_us (4) + total + start + count,
+// followed by `count` entries of ENUM_TRACE_WIRE_SIZE bytes.
+#define PROTO_TRACE_DATA_HDR      11
+#define PROTO_TRACE_PAGE_ENTRIES  28
+
+// PF_CTRL_STATS_DATA payload: nine LE32 counters + pending report count.
+#define PROTO_STATS_DATA_LEN      37
+
+// PF_CTRL_METRICS_DATA payload: dev_us (4) + total + start + count, followed
+// by `count` metrics in the metrics_encode() wire form.
+#define PROTO_METRICS_DATA_HDR    7
+
+// PF_DESC_SEGMENT payload: session, desc_cmd, itf, offset LE16, total LE16,
+// then the bytes. Each descriptor lands at its offset, so a lost frame leaves
+// a hole instead of shifting everything after it.
+#define PROTO_DESC_SEGMENT_HDR    7
+
+// PF_DESC_DONE of a session carries a manifest: session, device total LE16,
+// config total LE16, report count, then (itf, total LE16) per report
+// descriptor. An empty DONE closes a legacy in-order set.
+#define PROTO_DESC_MANIFEST_HDR   6
+#define PROTO_DESC_MANIFEST_ENTRY 3
+
+// PF_CTRL_DESC_STATUS payload: session, flags, count, then `count` gaps of
+// (desc_cmd, itf, offset LE16, len LE16).
+#define PROTO_DESC_STATUS_HDR      3
+#define PROTO_DESC_STATUS_ENTRY    6
+#define PROTO_DESC_STATUS_MAX_GAPS ((PROTO_MAX_PAYLOAD_SIZE - PROTO_DESC_STATUS_HDR) / PROTO_DESC_STATUS_ENTRY)
+#define PROTO_DESC_STATUS_MORE     0x01  // more gaps than fit; the rest follow after the next DONE
+
+typedef struct
+{
+    uint8_t        session;
+    uint8_t        desc_cmd;  // PF_DESC_DEVICE / PF_DESC_CONFIG / PF_DESC_REPORT
+    uint8_t        itf;       // report descriptors only
+    uint16_t       offset;
+    uint16_t       total;     // full descriptor length
+    uint8_t const* data;
+    uint16_t       len;
+} proto_desc_segment_t;
+
+typedef struct
+{
+    uint32_t dev_us;                   // A_device clock when the snapshot was taken
+    uint32_t input_received;           // PF_INPUT frames received
+    uint32_t input_dropped_not_ready;  // PF_INPUT dropped before the PC enumerated
+    uint32_t latency_min_ms;           // link latency in the current log window
+    uint32_t latency_max_ms;
+    uint32_t crc_errors;               // link frames rejected by proto_parse CRC
+    uint32_t rx_ring_overflow;         // link RX ring bytes dropped
+    uint32_t rx_frame_overflow;        // link frames longer than PROTO_MAX_FRAME_SIZE
+    uint32_t rx_ring_high_water;
+    uint8_t  pending_reports;          // reports waiting for tud_hid_ready()
+} proto_dev_stats_t;
+
 typedef enum
 {
     PF_RESET_REASON_REENUMERATE = 1, // descriptors changed, reattach
@@ -59,6 +123,9 @@ typedef struct
 // Parse raw buffer into proto_frame_t
 bool proto_parse(const uint8_t *buf, uint16_t len, proto_frame_t *out);
 
+// Frames rejected by proto_parse because of a CRC mismatch (since boot).
+uint32_t proto_crc_error_count(void);
+
 // Builders used on host side (B_host)
 int proto_build_input(uint8_t itf_id, uint32_t host_time_ms, uint16_t seq,
                       const uint8_t *report, uint16_t len,
@@ -67,9 +134,21 @@ int proto_build_input(uint8_t itf_id, uint32_t host_time_ms, uint16_t seq,
 int proto_build_descriptor(uint8_t desc_cmd, const uint8_t *desc, uint16_t len,
                            uint8_t *out_buf, uint16_t out_max);
 
+int proto_build_desc_segment(const proto_desc_segment_t *seg,
+                             uint8_t *out_buf, uint16_t out_max);
+// `seg->data` points into `payload`.
+bool proto_parse_desc_segment(const uint8_t *payload, uint16_t len,
+                              proto_desc_segment_t *seg);
+
 int proto_build_unmount(uint8_t *out_buf, uint16_t out_max);
 int proto_build_ctrl_device_reset(uint8_t reason,
                                   uint8_t *out_buf, uint16_t out_max);
+int proto_build_ctrl_trace_req(uint32_t host_us,
+                               uint8_t *out_buf, uint16_t out_max);
+int proto_build_ctrl_stats_req(uint8_t *out_buf, uint16_t out_max);
+bool proto_parse_ctrl_stats_data(const uint8_t *payload, uint16_t len,
+                                 proto_dev_stats_t *out);
+int proto_build_ctrl_metrics_req(uint8_t *out_buf, uint16_t out_max);
 
 // Builders used on device side (A_device) to send control to host
 int proto_build_ctrl_set_protocol(uint8_t itf_id, uint8_t protocol,
@@ -86,8 +165,20 @@ int proto_build_ctrl_set_idle(uint8_t itf_id, uint8_t duration, uint8_t rid,
                               uint8_t *out_buf, uint16_t out_max);
 
 int proto_build_ctrl_ready(uint8_t *out_buf, uint16_t out_max);
+int proto_build_ctrl_desc_resend(uint8_t *out_buf, uint16_t out_max);
+int proto_build_ctrl_desc_status(const uint8_t *payload, uint16_t len,
+                                 uint8_t *out_buf, uint16_t out_max);
 int proto_build_ctrl_string_req(uint8_t index, uint16_t langid,
                                 uint8_t *out_buf, uint16_t out_max);
+int proto_build_ctrl_trace_data(uint32_t host_us, uint32_t dev_us,
+                                uint8_t total, uint8_t start,
+                                const uint8_t *entries, uint8_t count,
+                                uint8_t *out_buf, uint16_t out_max);
+int proto_build_ctrl_metrics_data(uint32_t dev_us, uint8_t total, uint8_t start,
+                                  const uint8_t *entries, uint8_t count, uint16_t entries_len,
+                                  uint8_t *out_buf, uint16_t out_max);
+int proto_build_ctrl_stats_data(const proto_dev_stats_t *st,
+                                uint8_t *out_buf, uint16_t out_max);
 int proto_build_ctrl_get_report_resp(uint8_t itf_id, uint8_t rtype, uint8_t rid,
                                      uint8_t const* report, uint16_t len,
                                      uint8_t *out_buf, uint16_t out_max);
@@ -102,6 +102,123 @@
     #define PROXY_CTRL_HMAC_KEY "your-master-secret"
 #endif
 
+// Control UART RX: the IRQ drains the 32-byte hardware FIFO into this ring
+// (power of two), control_uart_task() parses complete frames from it in
+// bounded batches.
+#ifndef PROXY_CTRL_UART_RX_RING_SIZE
+#  define PROXY_CTRL_UART_RX_RING_SIZE 4096u
+#endif
+
+// Control UART TX: encoded responses queue here and the UART IRQ feeds the
+// FIFO, so the task never blocks on the wire (power of two, >= 1024).
+#ifndef PROXY_CTRL_UART_TX_RING_SIZE
+#  define PROXY_CTRL_UART_TX_RING_SIZE 2048u
+#endif
+
+#ifndef PROXY_CTRL_UART_RX_BUDGET_US
+#  define PROXY_CTRL_UART_RX_BUDGET_US 1000u
+#endif
+
+#ifndef PROXY_CTRL_UART_RX_MAX_FRAMES
+#  define PROXY_CTRL_UART_RX_MAX_FRAMES 16u
+#endif
+
+// Shortest telemetry interval SUBSCRIBE accepts; shorter requests are clamped.
+#ifndef PROXY_CTRL_TELEMETRY_MIN_MS
+#  define PROXY_CTRL_TELEMETRY_MIN_MS 10u
+#endif
+
+// B_host: physical input tap ring (TAP), slots of 64-byte reports.
+#ifndef PROXY_INPUT_TAP_DEPTH
+#  define PROXY_INPUT_TAP_DEPTH 64u
+#endif
+
+// B_host: timed reports (SCHEDULE, REPLAY) handed from the alarm IRQ to the
+// main loop because their interface mixes or injected input is recorded
+// (power of two, <= 128, 66 bytes each).
+#ifndef PROXY_TIMED_HANDOFF_DEPTH
+#  define PROXY_TIMED_HANDOFF_DEPTH 8u
+#endif
+
+// B_host: REPLAY sequence buffer (bytes, <= 65535) and playback timing.
+#ifndef PROXY_REPLAY_BUF_SIZE
+#  define PROXY_REPLAY_BUF_SIZE 32768u
+#endif
+
+// Lateness above this counts as an overrun in the REPLAY status.
+#ifndef PROXY_REPLAY_LATE_LIMIT_US
+#  define PROXY_REPLAY_LATE_LIMIT_US 100u
+#endif
+
+// REPLAY/SCHEDULE: re-check delay when the link UART is busy with a main-loop frame.
+#ifndef PROXY_LINK_BUSY_RETRY_US
+#  define PROXY_LINK_BUSY_RETRY_US 20u
+#endif
+
+// Delay between PLAY and the first entry, so the first event is not late.
+#ifndef PROXY_REPLAY_START_LEAD_US
+#  define PROXY_REPLAY_START_LEAD_US 1000u
+#endif
+
+// B_host: deadline-scheduled injection (SCHEDULE, delayed INJECT_BATCH
+// reports), 76-byte slots, <= 255.
+#ifndef PROXY_INJECT_SCHED_DEPTH
+#  define PROXY_INJECT_SCHED_DEPTH 32u
+#endif
+
+// Furthest a scheduled report may be due ahead of (or behind) the B_host clock.
+#ifndef PROXY_INJECT_SCHED_HORIZON_US
+#  define PROXY_INJECT_SCHED_HORIZON_US 10000000u
+#endif
+
+#ifndef PROXY_INJECT_SCHED_LATE_LIMIT_US
+#  define PROXY_INJECT_SCHED_LATE_LIMIT_US 100u
+#endif
+
+// B_host MOVE: homing reports before MOVE_TO, and report spacing when the
+// endpoint bInterval is unknown.
+#ifndef PROXY_MOVE_HOME_REPORTS
+#  define PROXY_MOVE_HOME_REPORTS 32u
+#endif
+
+#ifndef PROXY_MOVE_DEFAULT_INTERVAL_US
+#  define PROXY_MOVE_DEFAULT_INTERVAL_US 8000u
+#endif
+
+// B_host TYPE_TEXT: queued keystrokes (power of two, 2 bytes each), report
+// spacing when the endpoint bInterval is unknown, and TYPE_EVENT period.
+#ifndef PROXY_TYPE_TEXT_DEPTH
+#  define PROXY_TYPE_TEXT_DEPTH 2048u
+#endif
+
+#ifndef PROXY_TYPE_TEXT_DEFAULT_INTERVAL_US
+#  define PROXY_TYPE_TEXT_DEFAULT_INTERVAL_US 10000u
+#endif
+
+#ifndef PROXY_TYPE_TEXT_PROGRESS_MS
+#  define PROXY_TYPE_TEXT_PROGRESS_MS 250u
+#endif
+
+// B_host KEY (input state model): keys held by KEY_DOWN per interface.
+#ifndef PROXY_INPUT_STATE_MAX_KEYS
+#  define PROXY_INPUT_STATE_MAX_KEYS 14u
+#endif
+
+// B_host MIX: policy at mount (0 = off, reports pass straight through), how
+// long the other source stays suppressed after activity under the priority
+// policies, and output spacing when the endpoint bInterval is unknown.
+#ifndef PROXY_MIX_DEFAULT_POLICY
+#  define PROXY_MIX_DEFAULT_POLICY 0u
+#endif
+
+#ifndef PROXY_MIX_HOLDOFF_MS
+#  define PROXY_MIX_HOLDOFF_MS 300u
+#endif
+
+#ifndef PROXY_MIX_DEFAULT_INTERVAL_US
+#  define PROXY_MIX_DEFAULT_INTERVAL_US 1000u
+#endif
+
 #ifndef INPUT_LOG_VERBOSE
 #  define INPUT_LOG_VERBOSE 0
 #endif
@@ -122,6 +239,15 @@
 #  define PROXY_MAX_DESC_SIZE  512
 #endif
 
+// Configuration descriptors (wTotalLength) of gaming keyboards and multi-interface
+// composites exceed PROXY_MAX_DESC_SIZE, so they get their own, larger bound.
+// This is a hard limit: both boards keep the config in a static buffer of this
+// size (1 KB by default) and truncate anything longer.
+// B_host: keep CFG_TUH_ENUMERATION_BUFSIZE in B_host/tusb_config.h at least this big.
+#ifndef PROXY_MAX_CONFIG_DESC_SIZE
+#  define PROXY_MAX_CONFIG_DESC_SIZE 1024
+#endif
+
 // Bound the amount of UART RX processing per `hid_proxy_*_task()` call.
 // Helps prevent starving TinyUSB (device enumeration/state machine) when the
 // other side is streaming input frames early.
@@ -141,6 +267,125 @@
 #  define PROXY_UART_RX_MAX_FRAMES_RUN 128u
 #endif
 
+// Enumeration timeline tracer: ring depth per board (8 bytes per entry).
+// B_host keeps a second ring of the same depth for the A_device events.
+#ifndef PROXY_ENUM_TRACE_DEPTH
+#  define PROXY_ENUM_TRACE_DEPTH 96u
+#endif
+
+// Fast re-plug: after PF_UNMOUNT A_device stays attached to the PC this long,
+// waiting for a byte-identical descriptor set. 0 restores immediate teardown.
+#ifndef PROXY_REPLUG_GRACE_MS
+#  define PROXY_REPLUG_GRACE_MS 3000u
+#endif
+
+// Resumable descriptor sessions: B_host sends DEVICE/CONFIG/REPORT bytes as
+// PF_DESC_SEGMENT (session id + offset) and closes the set with a manifest.
+// A_device answers an incomplete set with PF_CTRL_DESC_STATUS and B_host
+// resends only those byte ranges. 0 restores the legacy in-order frames.
+#ifndef PROXY_DESC_RESUME
+#  define PROXY_DESC_RESUME 1
+#endif
+
+// Disjoint received ranges A_device tracks per descriptor. A segment that
+// would need one more is dropped and shows up as a gap instead.
+#ifndef PROXY_DESC_RESUME_RANGES
+#  define PROXY_DESC_RESUME_RANGES 8u
+#endif
+
+// Gap lists B_host serves for one descriptor set before it gives up and
+// falls back to UNMOUNT/RESET.
+#ifndef PROXY_DESC_RESUME_ROUNDS
+#  define PROXY_DESC_RESUME_ROUNDS 8u
+#endif
+
+// Descriptor transform on A_device: what the PC enumerates is derived from the
+// physical device's configuration descriptor by these rules. 0 presents it
+// unchanged (wTotalLength aside).
+#ifndef PROXY_DESC_XFORM
+#  define PROXY_DESC_XFORM 1
+#endif
+
+// Ceiling for bInterval (ms) of HID interrupt IN endpoints. The PC polls
+// A_device at this rate, so a report waits at most this long on A_device
+// instead of the device's own interval (often 8-10 ms). 0 = keep.
+#ifndef PROXY_XFORM_INTERVAL_MS
+#  define PROXY_XFORM_INTERVAL_MS 1u
+#endif
+
+// HID interfaces (bit = bInterfaceNumber) PROXY_XFORM_INTERVAL_MS applies to.
+#ifndef PROXY_XFORM_INTERVAL_ITF_MASK
+#  define PROXY_XFORM_INTERVAL_ITF_MASK 0xFFu
+#endif
+
+// wMaxPacketSize ceiling for interrupt endpoints: 64 is the full-speed limit
+// and A_device's CFG_TUD_HID_EP_BUFSIZE. 0 = keep.
+#ifndef PROXY_XFORM_EP_MPS_MAX
+#  define PROXY_XFORM_EP_MPS_MAX 64u
+#endif
+
+// Drop interfaces A_device has no driver for (non-HID, or HID numbered at or
+// above CFG_TUD_HID) instead of failing SET_CONFIGURATION on them.
+#ifndef PROXY_XFORM_STRIP_UNUSED
+#  define PROXY_XFORM_STRIP_UNUSED 1
+#endif
+
+// B_host: HID devices behind a hub are merged into one composite device for
+// the PC (interfaces numbered back to back, identity of the first device).
+// 0 keeps one device per bridge: every mount restarts enumeration.
+#ifndef PROXY_HUB_AGGREGATE
+#  define PROXY_HUB_AGGREGATE 1
+#endif
+
+// Physical devices merged into the composite; CFG_TUH_DEVICE_MAX also counts
+// the hub itself.
+#ifndef PROXY_HUB_MAX_DEVICES
+#  define PROXY_HUB_MAX_DEVICES 4u
+#endif
+
+// Composite HID interfaces, bounded by CFG_TUH_HID (B_host) and CFG_TUD_HID
+// (A_device).
+#ifndef PROXY_HUB_MAX_ITFS
+#  define PROXY_HUB_MAX_ITFS 8u
+#endif
+
+// HID part of each device's configuration descriptor kept for the composite.
+#ifndef PROXY_HUB_DEV_CFG_MAX
+#  define PROXY_HUB_DEV_CFG_MAX 256u
+#endif
+
+// B_host: A_device targets driven by the one physical keyboard/mouse (KVM).
+// Target 0 is the PROXY_UART_ID link; targets 1.. are PIO UARTs (SLIP, no
+// flow control). Every target is enumerated with the same descriptor set;
+// input follows the routing table and the focus. 1 = single target.
+#ifndef PROXY_FANOUT_TARGETS
+#  define PROXY_FANOUT_TARGETS 1u
+#endif
+
+// PIO link baud; the A_device boards on them are built with the same
+// PROXY_UART_BAUD and PROXY_UART_USE_HW_FLOW=0.
+#ifndef PROXY_FANOUT_PIO_BAUD
+#  define PROXY_FANOUT_PIO_BAUD (3000000)
+#endif
+
+// Target t >= 1 uses TX = base + 2*(t-1), RX = TX + 1 (8/9, 10/11, 12/13).
+#ifndef PROXY_FANOUT_PIO_PIN_BASE
+#  define PROXY_FANOUT_PIO_PIN_BASE 8u
+#endif
+
+// Focus hotkey: exactly these modifiers held plus digit 1..PROXY_FANOUT_TARGETS
+// moves the focus (default Right Ctrl). The digit never reaches a target.
+// 0 disables the hotkey; FANOUT (0x19) still switches.
+#ifndef PROXY_FANOUT_HOTKEY_MODS
+#  define PROXY_FANOUT_HOTKEY_MODS 0x10u
+#endif
+
+// B_host cache of the A_device metrics registry (GET_METRICS board 1), in
+// encoded bytes. Metrics past the end are left out of the snapshot.
+#ifndef PROXY_DEV_METRICS_BYTES
+#  define PROXY_DEV_METRICS_BYTES 1024u
+#endif
+
 #ifndef LOG_LEVEL
 #define LOG_LEVEL 4
 #endif
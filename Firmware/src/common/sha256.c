@@ -99,7 +99,15 @@ void sha256_init(sha256_ctx_t* ctx)
 
 void sha256_update(sha256_ctx_t* ctx, const uint8_t* data, size_t len)
 {
-    for (size_t i = 0; i < len; ++i)
+    size_t i = 0;
+    // Whole blocks straight from the input when nothing is buffered.
+    while (ctx->datalen == 0 && len - i >= 64)
+    {
+        sha256_transform(ctx, &data[i]);
+        ctx->bitlen += 512;
+        i += 64;
+    }
+    for (; i < len; ++i)
     {
         ctx->data[ctx->datalen] = data[i];
         ctx->datalen++;
@@ -156,6 +164,13 @@ void sha256_final(sha256_ctx_t* ctx, uint8_t hash[32])
 void hmac_sha256(const uint8_t* key, size_t key_len,
                  const uint8_t* data, size_t data_len,
                  uint8_t out[32])
+{
+    hmac_sha256_key_t k;
+    hmac_sha256_precompute(&k, key, key_len);
+    hmac_sha256_with(&k, data, data_len, out);
+}
+
+void hmac_sha256_precompute(hmac_sha256_key_t* k, const uint8_t* key, size_t key_len)
 {
     uint8_t kopad[64];
     uint8_t kipad[64];
@@ -181,15 +196,35 @@ void hmac_sha256(const uint8_t* key, size_t key_len,
     }
 
     sha256_ctx_t ctx;
-    uint8_t inner[32];
 
     sha256_init(&ctx);
     sha256_update(&ctx, kipad, sizeof(kipad));
-    sha256_update(&ctx, data, data_len);
-    sha256_final(&ctx, inner);
+    memcpy(k->inner, ctx.state, sizeof(k->inner));
 
     sha256_init(&ctx);
     sha256_update(&ctx, kopad, sizeof(kopad));
+    memcpy(k->outer, ctx.state, sizeof(k->outer));
+}
+
+static void sha256_resume(sha256_ctx_t* ctx, const uint32_t midstate[8])
+{
+    memcpy(ctx->state, midstate, sizeof(ctx->state));
+    ctx->bitlen  = 512;
+    ctx->datalen = 0;
+}
+
+void hmac_sha256_with(const hmac_sha256_key_t* k,
+                      const uint8_t* data, size_t data_len,
+                      uint8_t out[32])
+{
+    sha256_ctx_t ctx;
+    uint8_t inner[32];
+
+    sha256_resume(&ctx, k->inner);
+    sha256_update(&ctx, data, data_len);
+    sha256_final(&ctx, inner);
+
+    sha256_resume(&ctx, k->outer);
     sha256_update(&ctx, inner, sizeof(inner));
     sha256_final(&ctx, out);
 }
@@ -21,6 +21,18 @@ void hmac_sha256(const uint8_t* key, size_t key_len,
                  const uint8_t* data, size_t data_len,
                  uint8_t out[32]);
 
+// HMAC key with the ipad/opad blocks already compressed. A MAC over short
+// data then costs two SHA-256 compressions instead of four.
+typedef struct {
+    uint32_t inner[8];
+    uint32_t outer[8];
+} hmac_sha256_key_t;
+
+void hmac_sha256_precompute(hmac_sha256_key_t* k, const uint8_t* key, size_t key_len);
+void hmac_sha256_with(const hmac_sha256_key_t* k,
+                      const uint8_t* data, size_t data_len,
+                      uint8_t out[32]);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
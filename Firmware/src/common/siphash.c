@@ -0,0 +1,61 @@
+#include "siphash.h"
+
+static uint64_t load_le64(const uint8_t* p)
+{
+    return (uint64_t)p[0]         | ((uint64_t)p[1] << 8)  |
+           ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) |
+           ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) |
+           ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+#define ROTL64(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
+
+#define SIPROUND(v0, v1, v2, v3)                                   \
+    do {                                                           \
+        v0 += v1; v1 = ROTL64(v1, 13); v1 ^= v0; v0 = ROTL64(v0, 32); \
+        v2 += v3; v3 = ROTL64(v3, 16); v3 ^= v2;                   \
+        v0 += v3; v3 = ROTL64(v3, 21); v3 ^= v0;                   \
+        v2 += v1; v1 = ROTL64(v1, 17); v1 ^= v2; v2 = ROTL64(v2, 32); \
+    } while (0)
+
+void siphash_key_init(siphash_key_t* k, const uint8_t key[16])
+{
+    k->k0 = load_le64(&key[0]);
+    k->k1 = load_le64(&key[8]);
+}
+
+uint64_t siphash24(const siphash_key_t* k, const uint8_t* data, size_t len)
+{
+    uint64_t v0 = 0x736f6d6570736575ull ^ k->k0;
+    uint64_t v1 = 0x646f72616e646f6dull ^ k->k1;
+    uint64_t v2 = 0x6c7967656e657261ull ^ k->k0;
+    uint64_t v3 = 0x7465646279746573ull ^ k->k1;
+
+    size_t full = len & ~(size_t)7u;
+    for (size_t i = 0; i < full; i += 8)
+    {
+        uint64_t m = load_le64(&data[i]);
+        v3 ^= m;
+        SIPROUND(v0, v1, v2, v3);
+        SIPROUND(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    // Last block: remaining bytes, length in the top byte.
+    uint64_t b = (uint64_t)len << 56;
+    for (size_t i = 0; i < (len & 7u); i++)
+    {
+        b |= (uint64_t)data[full + i] << (8u * i);
+    }
+    v3 ^= b;
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    v0 ^= b;
+
+    v2 ^= 0xFF;
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    return v0 ^ v1 ^ v2 ^ v3;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// SipHash-2-4 (Aumasson/Bernstein) with a 128-bit key and 64-bit tag.
+// Used as the per-session control-UART MAC: a short frame costs a handful of
+// 64-bit ARX rounds instead of two SHA-256 compressions.
+typedef struct {
+    uint64_t k0;
+    uint64_t k1;
+} siphash_key_t;
+
+void siphash_key_init(siphash_key_t* k, const uint8_t key[16]);
+uint64_t siphash24(const siphash_key_t* k, const uint8_t* data, size_t len);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
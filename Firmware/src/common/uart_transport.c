@@ -1,3 +1,5 @@
+#define LOG_MODULE LOG_MOD_LINK
+
 #include "uart_transport.h"
 #include "pico/stdlib.h"
 #include "hardware/uart.h"
@@ -9,6 +11,7 @@
 #include "proxy_config.h"
 #include "logging.h"
 #include "proto_frame.h"
+#include "metrics.h"
 #include <string.h>
 
 static transport_role_t s_role = TRANSPORT_ROLE_NONE;
@@ -25,6 +28,18 @@ static uint8_t  s_rx_ring[UART_RX_RING_SIZE];
 static uint32_t s_rx_head = 0;
 static uint32_t s_rx_tail = 0;
 static uint32_t s_rx_overflow = 0;
+static uart_transport_stats_t s_stats;
+// Set while the main loop writes a frame; IRQ senders back off instead of
+// splicing their bytes into it.
+static volatile bool s_tx_busy = false;
+
+METRIC_COUNTER_DEFINE(m_link_tx_frames, "link.tx_frames");
+METRIC_COUNTER_DEFINE(m_link_rx_frames, "link.rx_frames");
+METRIC_COUNTER_DEFINE(m_link_crc_errors, "link.crc_errors");
+METRIC_COUNTER_DEFINE(m_link_rx_ring_overflow, "link.rx_ring_overflow");
+METRIC_COUNTER_DEFINE(m_link_rx_frame_overflow, "link.rx_frame_overflow");
+METRIC_GAUGE_DEFINE(m_link_rx_ring_depth, "link.rx_ring_depth");
+METRIC_GAUGE_DEFINE(m_link_rx_ring_high_water, "link.rx_ring_high_water");
 
 #define SLIP_END     0xC0
 #define SLIP_ESC     0xDB
@@ -51,6 +66,7 @@ static inline void rx_ring_push(uint8_t b)
     {
         // Overflow: drop oldest byte, count once per overflow event.
         s_rx_tail = (s_rx_tail + 1u) % UART_RX_RING_SIZE;
+        s_stats.rx_ring_overflow++;
         if ((s_rx_overflow++ % 128u) == 0)
         {
             LOGW("[UART] RX ring overflow (%u)", s_rx_overflow);
@@ -58,6 +74,12 @@ static inline void rx_ring_push(uint8_t b)
     }
     s_rx_ring[s_rx_head] = b;
     s_rx_head = next;
+
+    uint32_t depth = (s_rx_head + UART_RX_RING_SIZE - s_rx_tail) % UART_RX_RING_SIZE;
+    if (depth > s_stats.rx_ring_high_water)
+    {
+        s_stats.rx_ring_high_water = (uint16_t)depth;
+    }
 }
 
 static inline bool rx_ring_pop(uint8_t* out)
@@ -103,6 +125,32 @@ static void setup_irq_handler(void)
     uart_set_irq_enables(s_uart, true, false);
 }
 
+// Snapshot-time copy: the hot paths keep bumping s_stats only.
+static void link_metrics_collect(void)
+{
+    uart_transport_stats_t st;
+    uart_transport_get_stats(&st);
+    metric_set(&m_link_tx_frames, st.tx_frames);
+    metric_set(&m_link_rx_frames, st.rx_frames);
+    metric_set(&m_link_crc_errors, proto_crc_error_count());
+    metric_set(&m_link_rx_ring_overflow, st.rx_ring_overflow);
+    metric_set(&m_link_rx_frame_overflow, st.rx_frame_overflow);
+    metric_set(&m_link_rx_ring_depth, st.rx_ring_depth);
+    metric_set(&m_link_rx_ring_high_water, st.rx_ring_high_water);
+}
+
+static void link_metrics_register(void)
+{
+    metrics_register(&m_link_tx_frames);
+    metrics_register(&m_link_rx_frames);
+    metrics_register(&m_link_crc_errors);
+    metrics_register(&m_link_rx_ring_overflow);
+    metrics_register(&m_link_rx_frame_overflow);
+    metrics_register(&m_link_rx_ring_depth);
+    metrics_register(&m_link_rx_ring_high_water);
+    metrics_add_collector(link_metrics_collect);
+}
+
 void uart_transport_init_host() 
 {
     s_role = TRANSPORT_ROLE_HOST;
@@ -126,6 +174,7 @@ void uart_transport_init_host()
 
     setup_irq_handler();
     uart_transport_flush();
+    link_metrics_register();
 
     if (actual_baud != requested_baud)
     {
@@ -169,6 +218,7 @@ void uart_transport_init_device()
 
     setup_irq_handler();
     uart_transport_flush();
+    link_metrics_register();
 
     if (actual_baud != requested_baud)
     {
@@ -234,7 +284,10 @@ int uart_transport_send(const uint8_t* data, uint16_t len)
     if (enc_len <= 0) return -1;
 
     uint32_t t0 = time_us_32();
+    s_tx_busy = true;
     uart_write_blocking(s_uart, encoded, enc_len);
+    s_stats.tx_frames++;
+    s_tx_busy = false;
     uint32_t send_us = time_us_32() - t0;
     if (send_us > 2000)
     {
@@ -257,6 +310,36 @@ int uart_transport_send(const uint8_t* data, uint16_t len)
     return (int)len;
 }
 
+int uart_transport_send_from_isr(const uint8_t* data, uint16_t len)
+{
+    if (s_role != TRANSPORT_ROLE_HOST || !s_uart) return -1;
+    if (!data || !len) return 0;
+    if (s_tx_busy) return UART_TRANSPORT_BUSY;
+
+    uart_putc_raw(s_uart, SLIP_END);
+    for (uint16_t i = 0; i < len; i++)
+    {
+        uint8_t b = data[i];
+        if (b == SLIP_END)
+        {
+            uart_putc_raw(s_uart, SLIP_ESC);
+            uart_putc_raw(s_uart, SLIP_ESC_END);
+        }
+        else if (b == SLIP_ESC)
+        {
+            uart_putc_raw(s_uart, SLIP_ESC);
+            uart_putc_raw(s_uart, SLIP_ESC_ESC);
+        }
+        else
+        {
+            uart_putc_raw(s_uart, b);
+        }
+    }
+    uart_putc_raw(s_uart, SLIP_END);
+    s_stats.tx_frames++;
+    return (int)len;
+}
+
 // -----------------------------------------------------------------------------
 // SLAVE reads data pushed by master (A_device consumes reports from B_host)
 // -----------------------------------------------------------------------------
@@ -271,6 +354,7 @@ int uart_transport_device_send(const uint8_t* data, uint16_t len)
 
     uint32_t t0 = time_us_32();
     uart_write_blocking(s_uart, encoded, enc_len);
+    s_stats.tx_frames++;
     uint32_t send_us = time_us_32() - t0;
     if (send_us > 2000)
     {
@@ -317,6 +401,7 @@ int uart_transport_recv_frame(uint8_t* data, uint16_t maxlen)
             memcpy(data, s_rx_buf, frame_len);
             s_rx_len = 0;
             s_rx_esc = false;
+            s_stats.rx_frames++;
             bool do_log = false;
             if (LOG_SAMPLE_UART == 0)
             {
@@ -353,6 +438,7 @@ int uart_transport_recv_frame(uint8_t* data, uint16_t maxlen)
             else
             {
                 LOGW("[UART] RX buffer overflow, flushing");
+                s_stats.rx_frame_overflow++;
                 s_rx_len = 0;
                 s_rx_esc = false;
             }
@@ -361,3 +447,12 @@ int uart_transport_recv_frame(uint8_t* data, uint16_t maxlen)
 
     return 0;
 }
+
+void uart_transport_get_stats(uart_transport_stats_t* out)
+{
+    if (!out) return;
+    uint32_t irq = save_and_disable_interrupts();
+    *out = s_stats;
+    out->rx_ring_depth = (uint16_t)((s_rx_head + UART_RX_RING_SIZE - s_rx_tail) % UART_RX_RING_SIZE);
+    restore_interrupts(irq);
+}
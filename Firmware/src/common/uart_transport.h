@@ -23,12 +23,31 @@ void uart_transport_init_device();
 int  uart_transport_send(const uint8_t* data, uint16_t len);
 int  uart_transport_device_send(const uint8_t* data, uint16_t len);
 
+// B_host: send from an IRQ that preempts the main loop (replay alarm). Returns
+// UART_TRANSPORT_BUSY instead of interleaving with a uart_transport_send()
+// the IRQ interrupted; the caller retries later. Encodes on the fly, no stack buffer.
+#define UART_TRANSPORT_BUSY (-2)
+int  uart_transport_send_from_isr(const uint8_t* data, uint16_t len);
+
 // Прочитати один декодований SLIP-кадр; 0 якщо поки нема повного кадру.
 int  uart_transport_recv_frame(uint8_t* data, uint16_t maxlen);
 
 // Drop any unread bytes from RX FIFO (used to resync after protocol errors).
 void uart_transport_flush_rx(void);
 
+// Лічильники лінка з моменту init; flush_rx їх не скидає.
+typedef struct
+{
+    uint32_t tx_frames;           // frames handed to the wire
+    uint32_t rx_frames;           // SLIP frames decoded from the ring
+    uint32_t rx_ring_overflow;    // bytes dropped because the RX ring was full
+    uint32_t rx_frame_overflow;   // frames dropped for exceeding PROTO_MAX_FRAME_SIZE
+    uint16_t rx_ring_depth;       // bytes waiting in the RX ring right now
+    uint16_t rx_ring_high_water;  // max bytes ever queued in the RX ring
+} uart_transport_stats_t;
+
+void uart_transport_get_stats(uart_transport_stats_t* out);
+
 #ifdef __cplusplus
 }
 #endif
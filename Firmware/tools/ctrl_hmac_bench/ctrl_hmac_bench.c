@@ -0,0 +1,243 @@
+/*
+ * Host benchmark: verified control-UART v2 frames per second.
+ *
+ * Compares the old verification path (hmac_sha256() from the raw key, derived
+ * key first, bootstrap key on mismatch) with the cached ipad/opad midstates
+ * and per-session key tracking used by B_host/control_uart.c, and with the
+ * SESSION_SETUP fast-MAC frames (SipHash-2-4 tag + replay counter).
+ *
+ * Build and run from Firmware/:
+ *   gcc -O2 -Isrc/common tools/ctrl_hmac_bench/ctrl_hmac_bench.c \
+ *       src/common/sha256.c src/common/siphash.c src/common/crc16.c -o ctrl_hmac_bench
+ *   ./ctrl_hmac_bench [frames]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "crc16.h"
+#include "sha256.h"
+#include "siphash.h"
+
+#define HDR_LEN  6
+#define CRC_LEN  2
+#define HMAC_LEN 16
+#define FAST_HDR_LEN 10
+#define FAST_TAG_LEN 8
+
+static const char* k_bootstrap = "your-master-secret";
+static uint8_t     s_derived[32];
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint16_t build_frame(uint8_t* out, uint8_t seq, uint8_t payload_len,
+                            const uint8_t* key, size_t key_len)
+{
+    out[0] = 0xF1;
+    out[1] = 0x01;
+    out[2] = 0x00;
+    out[3] = seq;
+    out[4] = 0x01;
+    out[5] = payload_len;
+    for (uint8_t i = 0; i < payload_len; i++) out[HDR_LEN + i] = (uint8_t)(i * 7u + seq);
+    uint16_t crc = crc16_ccitt(out, HDR_LEN + payload_len, 0xFFFF);
+    out[HDR_LEN + payload_len]     = (uint8_t)(crc & 0xFF);
+    out[HDR_LEN + payload_len + 1] = (uint8_t)(crc >> 8);
+    uint8_t mac[32];
+    hmac_sha256(key, key_len, out, HDR_LEN + payload_len + CRC_LEN, mac);
+    memcpy(&out[HDR_LEN + payload_len + CRC_LEN], mac, HMAC_LEN);
+    return (uint16_t)(HDR_LEN + payload_len + CRC_LEN + HMAC_LEN);
+}
+
+static bool mac_ok(const uint8_t* mac, const uint8_t* frame, uint8_t payload_len)
+{
+    return memcmp(mac, &frame[HDR_LEN + payload_len + CRC_LEN], HMAC_LEN) == 0;
+}
+
+static bool verify_legacy(const uint8_t* frame)
+{
+    uint8_t plen = frame[5];
+    uint8_t mac[32];
+    hmac_sha256(s_derived, sizeof(s_derived), frame, HDR_LEN + plen + CRC_LEN, mac);
+    if (mac_ok(mac, frame, plen)) return true;
+    hmac_sha256((const uint8_t*)k_bootstrap, strlen(k_bootstrap), frame, HDR_LEN + plen + CRC_LEN, mac);
+    return mac_ok(mac, frame, plen);
+}
+
+static hmac_sha256_key_t s_key_derived;
+static hmac_sha256_key_t s_key_bootstrap;
+static const hmac_sha256_key_t* s_session_key = &s_key_derived;
+
+static bool verify_cached(const uint8_t* frame)
+{
+    uint8_t plen = frame[5];
+    uint8_t mac[32];
+    hmac_sha256_with(s_session_key, frame, HDR_LEN + plen + CRC_LEN, mac);
+    if (mac_ok(mac, frame, plen)) return true;
+
+    const hmac_sha256_key_t* other =
+        (s_session_key == &s_key_derived) ? &s_key_bootstrap : &s_key_derived;
+    hmac_sha256_with(other, frame, HDR_LEN + plen + CRC_LEN, mac);
+    if (!mac_ok(mac, frame, plen)) return false;
+    s_session_key = other;
+    return true;
+}
+
+static siphash_key_t s_fast_key;
+static uint32_t      s_fast_rx_counter;
+static uint32_t      s_fast_tx_counter;
+
+static void put_le64(uint8_t* p, uint64_t v)
+{
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint16_t build_fast_frame(uint8_t* out, uint8_t seq, uint8_t payload_len)
+{
+    uint32_t counter = ++s_fast_tx_counter;
+    out[0] = 0xF1;
+    out[1] = 0x02;
+    out[2] = 0x00;
+    out[3] = seq;
+    out[4] = 0x01;
+    out[5] = payload_len;
+    out[6] = (uint8_t)counter;
+    out[7] = (uint8_t)(counter >> 8);
+    out[8] = (uint8_t)(counter >> 16);
+    out[9] = (uint8_t)(counter >> 24);
+    for (uint8_t i = 0; i < payload_len; i++) out[FAST_HDR_LEN + i] = (uint8_t)(i * 7u + seq);
+    uint16_t crc = crc16_ccitt(out, FAST_HDR_LEN + payload_len, 0xFFFF);
+    out[FAST_HDR_LEN + payload_len]     = (uint8_t)(crc & 0xFF);
+    out[FAST_HDR_LEN + payload_len + 1] = (uint8_t)(crc >> 8);
+    put_le64(&out[FAST_HDR_LEN + payload_len + CRC_LEN],
+             siphash24(&s_fast_key, out, FAST_HDR_LEN + payload_len + CRC_LEN));
+    return (uint16_t)(FAST_HDR_LEN + payload_len + CRC_LEN + FAST_TAG_LEN);
+}
+
+// Tag + replay counter, as handle_fast_frame() does (the CRC is checked on
+// both paths and left out, like in verify_*()). The replay window is reset
+// per pass over the frame set so the same frames can be reused.
+static bool verify_fast(const uint8_t* frame)
+{
+    uint8_t plen = frame[5];
+    uint16_t body = (uint16_t)(FAST_HDR_LEN + plen);
+
+    uint8_t tag[FAST_TAG_LEN];
+    put_le64(tag, siphash24(&s_fast_key, frame, body + CRC_LEN));
+    if (memcmp(tag, &frame[body + CRC_LEN], FAST_TAG_LEN) != 0) return false;
+
+    uint32_t counter = (uint32_t)frame[6] | ((uint32_t)frame[7] << 8) |
+                       ((uint32_t)frame[8] << 16) | ((uint32_t)frame[9] << 24);
+    if (counter == 1) s_fast_rx_counter = 0;
+    if (counter <= s_fast_rx_counter) return false;
+    s_fast_rx_counter = counter;
+    return true;
+}
+
+static void run(const char* label, bool (*verify)(const uint8_t*),
+                uint8_t frames[][HDR_LEN + 240 + CRC_LEN + HMAC_LEN], unsigned count,
+                unsigned iterations)
+{
+    unsigned ok = 0;
+    double t0 = now_s();
+    for (unsigned i = 0; i < iterations; i++)
+    {
+        ok += verify(frames[i % count]) ? 1u : 0u;
+    }
+    double dt = now_s() - t0;
+    printf("  %-28s %10.0f frames/s  (%.2f us/frame, ok=%u)\n",
+           label, iterations / dt, dt * 1e6 / iterations, ok);
+    if (ok != iterations)
+    {
+        fprintf(stderr, "verification failed for %s\n", label);
+        exit(1);
+    }
+}
+
+static void self_check(void)
+{
+    // RFC 4231 test case 2.
+    static const uint8_t expect[32] = {
+        0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24, 0x26, 0x08, 0x95, 0x75, 0xc7,
+        0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83, 0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43
+    };
+    const char* data = "what do ya want for nothing?";
+    uint8_t a[32], b[32];
+    hmac_sha256((const uint8_t*)"Jefe", 4, (const uint8_t*)data, strlen(data), a);
+    hmac_sha256_key_t k;
+    hmac_sha256_precompute(&k, (const uint8_t*)"Jefe", 4);
+    hmac_sha256_with(&k, (const uint8_t*)data, strlen(data), b);
+    if (memcmp(a, expect, 32) != 0 || memcmp(b, expect, 32) != 0)
+    {
+        fprintf(stderr, "HMAC self-check failed\n");
+        exit(1);
+    }
+
+    // SipHash-2-4 reference vector: key 00..0f, message 00..0e.
+    uint8_t key[16], msg[15];
+    for (int i = 0; i < 16; i++) key[i] = (uint8_t)i;
+    for (int i = 0; i < 15; i++) msg[i] = (uint8_t)i;
+    siphash_key_t sk;
+    siphash_key_init(&sk, key);
+    if (siphash24(&sk, msg, sizeof(msg)) != 0xa129ca6149be45e5ull)
+    {
+        fprintf(stderr, "SipHash self-check failed\n");
+        exit(1);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    unsigned iterations = (argc > 1) ? (unsigned)strtoul(argv[1], NULL, 10) : 200000u;
+    static uint8_t frames[64][HDR_LEN + 240 + CRC_LEN + HMAC_LEN];
+
+    self_check();
+
+    // Same derivation as ctrl_init_hmac_key(), with a fixed board id.
+    static const uint8_t board_id[8] = { 0xE6, 0x61, 0x38, 0x52, 0x83, 0x2B, 0x4A, 0x2F };
+    hmac_sha256((const uint8_t*)k_bootstrap, strlen(k_bootstrap), board_id, sizeof(board_id), s_derived);
+    hmac_sha256_precompute(&s_key_derived, s_derived, sizeof(s_derived));
+    hmac_sha256_precompute(&s_key_bootstrap, (const uint8_t*)k_bootstrap, strlen(k_bootstrap));
+
+    // Session key as start_fast_session() derives it, with fixed nonces.
+    uint8_t setup[4 + 32];
+    memcpy(setup, "HBS1", 4);
+    for (int i = 0; i < 32; i++) setup[4 + i] = (uint8_t)(0xA0 + i);
+    uint8_t session[32];
+    hmac_sha256_with(&s_key_derived, setup, sizeof(setup), session);
+    siphash_key_init(&s_fast_key, session);
+
+    static const uint8_t sizes[] = { 10, 40, 240 };
+    for (size_t s = 0; s < sizeof(sizes); s++)
+    {
+        printf("payload %u bytes, derived-key session:\n", sizes[s]);
+        for (unsigned i = 0; i < 64; i++) build_frame(frames[i], (uint8_t)i, sizes[s], s_derived, sizeof(s_derived));
+        run("legacy hmac_sha256()", verify_legacy, frames, 64, iterations);
+        s_session_key = &s_key_derived;
+        run("cached midstate", verify_cached, frames, 64, iterations);
+
+        printf("payload %u bytes, bootstrap-key session:\n", sizes[s]);
+        for (unsigned i = 0; i < 64; i++)
+        {
+            build_frame(frames[i], (uint8_t)i, sizes[s], (const uint8_t*)k_bootstrap, strlen(k_bootstrap));
+        }
+        run("legacy hmac_sha256()", verify_legacy, frames, 64, iterations);
+        s_session_key = &s_key_derived;
+        run("cached midstate + session", verify_cached, frames, 64, iterations);
+
+        printf("payload %u bytes, fast-MAC session:\n", sizes[s]);
+        s_fast_tx_counter = 0;
+        for (unsigned i = 0; i < 64; i++) build_fast_frame(frames[i], (uint8_t)i, sizes[s]);
+        run("siphash-2-4 + counter", verify_fast, frames, 64, iterations);
+    }
+    return 0;
+}
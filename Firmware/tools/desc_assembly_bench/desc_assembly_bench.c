@@ -0,0 +1,298 @@
+/*
+ * Host benchmark: A_device descriptor assembly for a large composite device.
+ *
+ * Feeds one descriptor set through A_device/remote_storage.c in the chunks
+ * B_host sends (48 bytes, send_descriptor_range()), in B_host order: device,
+ * configuration, then each interface's report descriptor. Two strategies:
+ *
+ *   incremental  what hid_proxy_dev.c does now: chunks only append, each
+ *                descriptor is parsed once when its announced length is
+ *                reached, readiness is checked only when a hook says so.
+ *   rewalk       the behaviour before incremental assembly: after every chunk
+ *                the whole config is re-walked for strings and HID lengths,
+ *                every report descriptor is re-scanned for Report IDs and
+ *                readiness is re-evaluated.
+ *
+ * The set is a ~1 KB configuration (PROXY_MAX_CONFIG_DESC_SIZE): CFG_TUD_HID
+ * HID interfaces followed by vendor interfaces up to the limit, plus one
+ * ~480-byte report descriptor per HID interface. Both strategies must agree on Report IDs and expected report
+ * lengths. Host timings are relative; the RP2040 is roughly 20-40x slower.
+ *
+ * Build and run from Firmware/:
+ *   gcc -O2 -DLOG_LEVEL=0 -Itools/proto_bench/shim -Isrc/common -Isrc/A_device \
+ *       tools/desc_assembly_bench/desc_assembly_bench.c src/A_device/remote_storage.c \
+ *       src/A_device/desc_transform.c src/common/desc_session.c -o desc_assembly_bench
+ *   ./desc_assembly_bench [sets]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "proxy_config.h"
+#include "proto_frame.h"
+#include "remote_storage.h"
+
+// remote_storage.c logs through the deferred LOGx path; nothing is printed here.
+volatile uint8_t g_log_level = 0;
+void logging_push(uint8_t level, uint8_t module, char const* fmt, uint8_t nargs,
+                  uintptr_t const* args, uint32_t str_mask)
+{
+    (void)level; (void)module; (void)fmt; (void)nargs; (void)args; (void)str_mask;
+}
+
+uint32_t time_us_32(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u);
+}
+
+#define CHUNK_MAX   48u
+#define HID_ITFS    CFG_TUD_HID
+#define VENDOR_ITFS 34u
+#define REPORT_LEN  480u
+
+static uint8_t  s_device[18] = { 18, 1, 0x00, 0x02, 0, 0, 0, 64, 0x6D, 0x04, 0x2B, 0xC5, 0x00, 0x01, 1, 2, 3, 1 };
+static uint8_t  s_config[PROXY_MAX_CONFIG_DESC_SIZE];
+static uint16_t s_config_len;
+static uint8_t  s_reports[HID_ITFS][REPORT_LEN];
+static uint16_t s_report_len[HID_ITFS];
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint16_t put_itf(uint16_t o, uint8_t itf, uint8_t cls, uint8_t proto, uint8_t istr)
+{
+    uint8_t const d[9] = { 9, 4, itf, 0, 2, cls, cls == 3 ? 1 : 0, proto, istr };
+    memcpy(&s_config[o], d, sizeof(d));
+    return (uint16_t)(o + sizeof(d));
+}
+
+static uint16_t put_ep(uint16_t o, uint8_t addr)
+{
+    uint8_t const d[7] = { 7, 5, addr, 3, 64, 0, 1 };
+    memcpy(&s_config[o], d, sizeof(d));
+    return (uint16_t)(o + sizeof(d));
+}
+
+// Vendor-page report descriptor without Report IDs (the last interface has
+// one near the end), so every scan walks most of it.
+static void build_report(uint8_t itf)
+{
+    uint8_t* r = s_reports[itf];
+    uint16_t n = 0;
+    uint8_t const head[] = { 0x06, 0x00, 0xFF, 0x09, 0x01, 0xA1, 0x01 };
+    memcpy(&r[n], head, sizeof(head));
+    n += sizeof(head);
+    uint8_t const field[] = { 0x09, 0x02, 0x15, 0x00, 0x26, 0xFF, 0x00, 0x75, 0x08, 0x95, 0x08, 0x81, 0x02 };
+    while (n + sizeof(field) + 3u < REPORT_LEN)
+    {
+        memcpy(&r[n], field, sizeof(field));
+        n += sizeof(field);
+    }
+    if (itf == HID_ITFS - 1u)
+    {
+        r[n++] = 0x85;
+        r[n++] = 0x02;
+    }
+    r[n++] = 0xC0;
+    s_report_len[itf] = n;
+}
+
+static void build_set(void)
+{
+    uint16_t o = 9;
+    uint8_t  itf = 0;
+    for (; itf < HID_ITFS; itf++)
+    {
+        o = put_itf(o, itf, 3, 0, (uint8_t)(4 + itf));
+        build_report(itf);
+        uint8_t const hid[9] = { 9, 0x21, 0x11, 0x01, 0, 1, 0x22,
+                                 (uint8_t)(s_report_len[itf] & 0xFF), (uint8_t)(s_report_len[itf] >> 8) };
+        memcpy(&s_config[o], hid, sizeof(hid));
+        o += sizeof(hid);
+        o = put_ep(o, (uint8_t)(0x81 + itf));
+        o = put_ep(o, (uint8_t)(0x01 + itf));
+    }
+    for (; itf < HID_ITFS + VENDOR_ITFS && o + 23u <= sizeof(s_config); itf++)
+    {
+        o = put_itf(o, itf, 0xFF, 0, 0);
+        o = put_ep(o, (uint8_t)(0x81 + (itf & 0x0F)));
+        o = put_ep(o, (uint8_t)(0x01 + (itf & 0x0F)));
+    }
+    uint8_t const head[9] = { 9, 2, (uint8_t)(o & 0xFF), (uint8_t)(o >> 8), itf, 1, 0, 0xA0, 250 };
+    memcpy(s_config, head, sizeof(head));
+    s_config_len = o;
+}
+
+// Same fields as remote_desc_reset_reports_and_config() in hid_proxy_dev.c.
+static void reset_set(void)
+{
+    s_remote_desc.device.len = 0;
+    s_remote_desc.device.valid = false;
+    s_remote_desc.device_parsed = false;
+    s_remote_desc.config.len = 0;
+    s_remote_desc.config.valid = false;
+    s_remote_desc.config_expected_len = 0;
+    s_remote_desc.config_parsed = false;
+    for (uint8_t i = 0; i < CFG_TUD_HID; i++)
+    {
+        s_remote_desc.reports[i].len = 0;
+        s_remote_desc.reports[i].valid = false;
+        s_remote_desc.hid_itf_present[i] = false;
+        s_remote_desc.hid_report_expected_len[i] = 0;
+        s_remote_desc.report_has_id[i] = false;
+        s_remote_desc.report_parsed[i] = false;
+    }
+    s_remote_desc.descriptors_complete = false;
+}
+
+static void store_device(void)
+{
+    memcpy(s_remote_desc.device.data, s_device, sizeof(s_device));
+    s_remote_desc.device.len = sizeof(s_device);
+    s_remote_desc.device.valid = true;
+}
+
+// Report chunks carry the interface number first, so they hold one byte less.
+static uint16_t chunk_len(uint16_t total, uint16_t off, uint16_t max)
+{
+    uint16_t left = (uint16_t)(total - off);
+    return left < max ? left : max;
+}
+
+static bool set_ready(void)
+{
+    return s_remote_desc.device.valid && remote_storage_config_complete() && remote_storage_reports_ready();
+}
+
+static uint32_t run_incremental(void)
+{
+    uint32_t chunks = 1;
+    bool ready = false;
+    reset_set();
+    store_device();
+    if (remote_storage_device_stored()) ready = set_ready();
+
+    for (uint16_t o = 0; o < s_config_len; o = (uint16_t)(o + CHUNK_MAX), chunks++)
+    {
+        uint16_t n = chunk_len(s_config_len, o, CHUNK_MAX);
+        (void)remote_desc_config_append(&s_config[o], n);
+        if (remote_storage_config_appended()) ready = set_ready();
+    }
+    for (uint8_t itf = 0; itf < HID_ITFS; itf++)
+    {
+        for (uint16_t o = 0; o < s_report_len[itf]; o = (uint16_t)(o + CHUNK_MAX - 1u), chunks++)
+        {
+            uint16_t n = chunk_len(s_report_len[itf], o, CHUNK_MAX - 1u);
+            remote_desc_append(&s_remote_desc.reports[itf], &s_reports[itf][o], n);
+            if (remote_storage_report_appended(itf)) ready = set_ready();
+        }
+    }
+    return ready ? chunks : 0;
+}
+
+// Pre-incremental maybe_complete_descriptors(): full re-walk on every chunk.
+static bool legacy_check(void)
+{
+    if (!s_remote_desc.device.valid || !s_remote_desc.config.valid) return false;
+    remote_storage_update_string_allowlist();
+    remote_storage_analyze_report_descriptors();
+    return remote_storage_reports_ready();
+}
+
+static uint32_t run_rewalk(void)
+{
+    uint32_t chunks = 1;
+    bool ready = false;
+    reset_set();
+    store_device();
+    ready = legacy_check();
+
+    for (uint16_t o = 0; o < s_config_len; o = (uint16_t)(o + CHUNK_MAX), chunks++)
+    {
+        uint16_t n = chunk_len(s_config_len, o, CHUNK_MAX);
+        (void)remote_desc_config_append(&s_config[o], n);
+        if (s_remote_desc.config.len > s_config_len) s_remote_desc.config.len = s_config_len;
+        ready = legacy_check();
+    }
+    for (uint8_t itf = 0; itf < HID_ITFS; itf++)
+    {
+        for (uint16_t o = 0; o < s_report_len[itf]; o = (uint16_t)(o + CHUNK_MAX - 1u), chunks++)
+        {
+            uint16_t n = chunk_len(s_report_len[itf], o, CHUNK_MAX - 1u);
+            remote_desc_append(&s_remote_desc.reports[itf], &s_reports[itf][o], n);
+            ready = legacy_check();
+        }
+    }
+    return ready ? chunks : 0;
+}
+
+typedef struct
+{
+    bool     has_id[CFG_TUD_HID];
+    uint16_t expect[CFG_TUD_HID];
+} outcome_t;
+
+static outcome_t outcome(void)
+{
+    outcome_t r;
+    memset(&r, 0, sizeof(r));
+    for (uint8_t i = 0; i < CFG_TUD_HID; i++)
+    {
+        r.has_id[i] = s_remote_desc.report_has_id[i];
+        r.expect[i] = s_remote_desc.hid_report_expected_len[i];
+    }
+    return r;
+}
+
+static double bench(uint32_t (*run)(void), uint32_t sets, uint32_t* chunks)
+{
+    double t0 = now_s();
+    for (uint32_t i = 0; i < sets; i++)
+    {
+        *chunks = run();
+    }
+    return (now_s() - t0) / sets;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t sets = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 2000u;
+    if (!sets) sets = 1;
+
+    remote_storage_init_defaults();
+    build_set();
+
+    uint32_t chunks_inc = run_incremental();
+    outcome_t inc = outcome();
+    uint32_t chunks_old = run_rewalk();
+    outcome_t old = outcome();
+    if (!chunks_inc || chunks_inc != chunks_old || memcmp(&inc, &old, sizeof(inc)) != 0 ||
+        inc.expect[0] != s_report_len[0] || !inc.has_id[HID_ITFS - 1u] || inc.has_id[0])
+    {
+        printf("strategies disagree (chunks %u/%u)\n", chunks_inc, chunks_old);
+        return 1;
+    }
+
+    uint32_t reports = 0;
+    for (uint8_t i = 0; i < HID_ITFS; i++) reports += s_report_len[i];
+    printf("set: config %u B, %u HID itf, reports %u B, %u chunks\n",
+           s_config_len, (unsigned)HID_ITFS, reports, chunks_inc);
+
+    double t_old = bench(run_rewalk, sets, &chunks_old);
+    double t_inc = bench(run_incremental, sets, &chunks_inc);
+    printf("%-12s %10s %12s\n", "strategy", "us/set", "ns/chunk");
+    printf("%-12s %10.2f %12.1f\n", "rewalk", t_old * 1e6, t_old * 1e9 / chunks_old);
+    printf("%-12s %10.2f %12.1f\n", "incremental", t_inc * 1e6, t_inc * 1e9 / chunks_inc);
+    printf("speedup %.1fx\n", t_old / t_inc);
+    return 0;
+}
@@ -0,0 +1,443 @@
+/*
+ * Host simulation: descriptor hand-off over a lossy inter-board UART.
+ *
+ * Runs the shared session code (common/desc_session.c, proto_frame.c) on both
+ * ends of a simulated link and corrupts wire bytes at a fixed per-byte rate;
+ * a damaged frame fails the CRC in proto_parse() and is dropped, as on the
+ * boards. Two strategies are compared for the same descriptor set:
+ *
+ *   resume  PF_DESC_SEGMENT frames + DONE manifest; A_device answers with
+ *           PF_CTRL_DESC_STATUS gap lists and B_host resends only those
+ *           (PROXY_DESC_RESUME = 1).
+ *   full    legacy frames; any loss costs the whole set again. Modelled as
+ *           the cheapest legacy recovery (DESC_RESEND right after DONE), so
+ *           the real gap is larger whenever the legacy path ends in
+ *           UNMOUNT/RESET and a re-enumeration.
+ *
+ * Time is simulated, not measured: wire time at the configured baud rate
+ * (10 bits per byte, SLIP framing bytes included, escapes not), the 2 ms
+ * pacing between chunks of one descriptor, 1 ms turnaround on A_device and a
+ * 300 ms READY timeout whenever DONE or its answer is lost (5 retries, then
+ * the set counts as failed). This exercises the session/codec logic, not the
+ * full board glue.
+ *
+ * Build and run from Firmware/:
+ *   gcc -O2 -DLOG_LEVEL=0 -Isrc/common -Itools/proto_bench/shim \
+ *       tools/desc_resume_sim/desc_resume_sim.c src/common/desc_session.c \
+ *       src/common/proto_frame.c src/common/crc16.c -o desc_resume_sim
+ *   ./desc_resume_sim [trials] [baud]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "desc_session.h"
+#include "proto_frame.h"
+
+// proto_frame.c logs through the deferred LOGx path; nothing is printed here.
+volatile uint8_t g_log_level = 0;
+void logging_push(uint8_t level, uint8_t module, char const* fmt, uint8_t nargs,
+                  uintptr_t const* args, uint32_t str_mask)
+{
+    (void)level; (void)module; (void)fmt; (void)nargs; (void)args; (void)str_mask;
+}
+
+#define CHUNK_MAX        48u     // send_descriptor_range()
+#define PACE_US          2000u   // sleep_ms(2) between chunks
+#define TURNAROUND_US    1000u
+#define READY_TIMEOUT_US 300000u
+#define DONE_RETRIES     5u
+#define MAX_ROUNDS       PROXY_DESC_RESUME_ROUNDS
+#define SET_MAX          4u
+#define DESC_MAX         512u
+
+typedef struct
+{
+    const char* name;
+    uint16_t    device;
+    uint16_t    config;
+    uint8_t     reports;
+    uint16_t    report[SET_MAX];
+} desc_set_t;
+
+static const desc_set_t k_sets[] = {
+    { "keyboard+mouse", 18, 59, 2, { 65, 120 } },
+    { "gaming mouse",   18, 141, 4, { 98, 210, 160, 47 } },
+};
+
+typedef struct
+{
+    uint64_t now_us;
+    uint32_t baud;
+    uint32_t byte_err_ppm;       // per-byte corruption probability, ppm
+    uint64_t wire_bytes;
+    uint32_t frames_lost;
+} link_t;
+
+typedef struct
+{
+    bool     ok;
+    bool     corrupt;            // accepted bytes differ from the source
+    uint32_t rounds;             // recovery rounds after the first pass
+} run_result_t;
+
+static uint64_t s_rng = 0x9E3779B97F4A7C15ull;
+
+static uint32_t rng_u32(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 7;
+    s_rng ^= s_rng << 17;
+    return (uint32_t)(s_rng >> 32);
+}
+
+// Puts `len` bytes on the wire; false when the receiver drops the frame.
+static bool link_xfer(link_t* l, const uint8_t* buf, uint16_t len, proto_frame_t* out)
+{
+    uint8_t wire[PROTO_MAX_FRAME_SIZE];
+    memcpy(wire, buf, len);
+    for (uint16_t i = 0; i < len; i++)
+    {
+        if (rng_u32() % 1000000u < l->byte_err_ppm)
+        {
+            wire[i] ^= (uint8_t)(1u << (rng_u32() & 7u));
+        }
+    }
+    uint32_t on_wire = len + 2u;   // SLIP END on both sides
+    l->wire_bytes += on_wire;
+    l->now_us += (uint64_t)on_wire * 10u * 1000000u / l->baud;
+    if (!proto_parse(wire, len, out))
+    {
+        l->frames_lost++;
+        return false;
+    }
+    return true;
+}
+
+static void make_source(const desc_set_t* set, uint8_t src[2 + SET_MAX][DESC_MAX], uint16_t lens[2 + SET_MAX])
+{
+    lens[0] = set->device;
+    lens[1] = set->config;
+    for (uint8_t i = 0; i < SET_MAX; i++)
+    {
+        lens[2 + i] = i < set->reports ? set->report[i] : 0;
+    }
+    for (uint8_t d = 0; d < 2 + SET_MAX; d++)
+    {
+        for (uint16_t k = 0; k < lens[d]; k++)
+        {
+            src[d][k] = (uint8_t)(rng_u32() & 0xFF);
+        }
+    }
+}
+
+static uint8_t slot_cmd(uint8_t d) { return d == 0 ? PF_DESC_DEVICE : d == 1 ? PF_DESC_CONFIG : PF_DESC_REPORT; }
+static uint8_t slot_itf(uint8_t d) { return d < 2 ? 0 : (uint8_t)(d - 2); }
+static uint8_t cmd_slot(uint8_t cmd, uint8_t itf)
+{
+    return cmd == PF_DESC_DEVICE ? 0 : cmd == PF_DESC_CONFIG ? 1 : (uint8_t)(2 + itf);
+}
+
+// ------------------------------------------------------
+// resume: segments, manifest, gap lists
+// ------------------------------------------------------
+
+typedef struct
+{
+    desc_session_t session;
+    uint8_t        bytes[2 + SET_MAX][DESC_MAX];
+} resume_rx_t;
+
+static void resume_send_range(link_t* l, resume_rx_t* rx, uint8_t session,
+                              uint8_t src[2 + SET_MAX][DESC_MAX], uint16_t const lens[2 + SET_MAX],
+                              uint8_t d, uint16_t offset, uint16_t len)
+{
+    if (offset >= lens[d]) return;
+    if (len > lens[d] - offset) len = (uint16_t)(lens[d] - offset);
+    while (len)
+    {
+        uint16_t chunk = len > CHUNK_MAX ? CHUNK_MAX : len;
+        proto_desc_segment_t seg = {
+            .session = session, .desc_cmd = slot_cmd(d), .itf = slot_itf(d),
+            .offset = offset, .total = lens[d], .data = &src[d][offset], .len = chunk,
+        };
+        uint8_t buf[PROTO_MAX_FRAME_SIZE];
+        int out = proto_build_desc_segment(&seg, buf, sizeof(buf));
+        proto_frame_t f;
+        if (out > 0 && link_xfer(l, buf, (uint16_t)out, &f))
+        {
+            proto_desc_segment_t got;
+            if (f.type == PF_DESCRIPTOR && f.cmd == PF_DESC_SEGMENT &&
+                proto_parse_desc_segment(f.data, f.len, &got) &&
+                cmd_slot(got.desc_cmd, got.itf) < 2 + SET_MAX &&
+                got.offset + got.len <= DESC_MAX &&
+                desc_session_note(&rx->session, &got))
+            {
+                memcpy(&rx->bytes[cmd_slot(got.desc_cmd, got.itf)][got.offset], got.data, got.len);
+            }
+        }
+        offset = (uint16_t)(offset + chunk);
+        len    = (uint16_t)(len - chunk);
+        if (len) l->now_us += PACE_US;
+    }
+}
+
+static run_result_t run_resume(link_t* l, uint8_t src[2 + SET_MAX][DESC_MAX], uint16_t const lens[2 + SET_MAX],
+                               uint8_t reports)
+{
+    run_result_t r = { 0 };
+    static resume_rx_t rx;
+    memset(&rx, 0, sizeof(rx));
+    uint8_t session = (uint8_t)(1u + rng_u32() % 255u);
+    desc_session_begin(&rx.session, session);
+
+    for (uint8_t d = 0; d < 2 + reports; d++)
+    {
+        resume_send_range(l, &rx, session, src, lens, d, 0, lens[d]);
+    }
+
+    desc_manifest_t m = { .session = session, .device_total = lens[0], .config_total = lens[1] };
+    for (uint8_t i = 0; i < reports; i++)
+    {
+        m.report_mask |= (uint8_t)(1u << i);
+        m.report_total[i] = lens[2 + i];
+    }
+    uint8_t manifest[PROTO_DESC_MANIFEST_HDR + DESC_SESSION_MAX_REPORTS * PROTO_DESC_MANIFEST_ENTRY];
+    uint16_t mlen = desc_session_build_manifest(&m, manifest, sizeof(manifest));
+
+    uint32_t retries = 0;
+    for (;;)
+    {
+        uint8_t buf[PROTO_MAX_FRAME_SIZE];
+        proto_frame_t f;
+        int out = proto_build_descriptor(PF_DESC_DONE, manifest, mlen, buf, sizeof(buf));
+        bool answered = false;
+        desc_status_t st = { 0 };
+        bool ready = false;
+
+        if (link_xfer(l, buf, (uint16_t)out, &f))
+        {
+            desc_manifest_t got;
+            if (f.len && desc_session_parse_manifest(f.data, f.len, &got) && got.session == session)
+            {
+                desc_session_apply_manifest(&rx.session, &got);
+            }
+            l->now_us += TURNAROUND_US;
+            if (desc_session_complete(&rx.session))
+            {
+                out = proto_build_ctrl_ready(buf, sizeof(buf));
+                answered = link_xfer(l, buf, (uint16_t)out, &f) && f.cmd == PF_CTRL_READY;
+                ready = answered;
+            }
+            else
+            {
+                uint8_t payload[PROTO_MAX_PAYLOAD_SIZE];
+                uint16_t plen = desc_session_build_status(&rx.session, payload, sizeof(payload));
+                out = proto_build_ctrl_desc_status(payload, plen, buf, sizeof(buf));
+                answered = link_xfer(l, buf, (uint16_t)out, &f) &&
+                           f.cmd == PF_CTRL_DESC_STATUS &&
+                           desc_session_parse_status(f.data, f.len, &st);
+            }
+        }
+
+        if (ready)
+        {
+            r.ok = true;
+            break;
+        }
+        if (!answered)
+        {
+            l->now_us += READY_TIMEOUT_US;
+            if (++retries > DONE_RETRIES) break;
+            continue;
+        }
+
+        retries = 0;
+        if (++r.rounds > MAX_ROUNDS) break;
+        for (uint8_t g = 0; g < st.count; g++)
+        {
+            uint8_t d = cmd_slot(st.gaps[g].desc_cmd, st.gaps[g].itf);
+            if (d < 2 + reports)
+            {
+                resume_send_range(l, &rx, session, src, lens, d, st.gaps[g].offset, st.gaps[g].len);
+            }
+        }
+    }
+
+    if (r.ok)
+    {
+        for (uint8_t d = 0; d < 2 + reports; d++)
+        {
+            r.corrupt |= memcmp(rx.bytes[d], src[d], lens[d]) != 0;
+        }
+    }
+    return r;
+}
+
+// ------------------------------------------------------
+// full: legacy in-order frames, whole set per round
+// ------------------------------------------------------
+
+static run_result_t run_full(link_t* l, uint8_t src[2 + SET_MAX][DESC_MAX], uint16_t const lens[2 + SET_MAX],
+                             uint8_t reports)
+{
+    run_result_t r = { 0 };
+    uint32_t retries = 0;
+    bool have_all = false;
+    bool send_set = true;
+
+    for (;;)
+    {
+        uint8_t buf[PROTO_MAX_FRAME_SIZE];
+        proto_frame_t f;
+        if (send_set)
+        {
+            have_all = true;
+            for (uint8_t d = 0; d < 2 + reports; d++)
+            {
+                // Report frames lead with the interface byte.
+                uint8_t tmp[DESC_MAX + 1];
+                uint16_t total = lens[d];
+                const uint8_t* p = src[d];
+                if (d >= 2)
+                {
+                    tmp[0] = slot_itf(d);
+                    memcpy(&tmp[1], src[d], lens[d]);
+                    p = tmp;
+                    total = (uint16_t)(total + 1);
+                }
+                for (uint16_t off = 0; off < total; off = (uint16_t)(off + CHUNK_MAX))
+                {
+                    uint16_t chunk = (uint16_t)(total - off);
+                    if (chunk > CHUNK_MAX) chunk = CHUNK_MAX;
+                    int out = proto_build_descriptor(slot_cmd(d), &p[off], chunk, buf, sizeof(buf));
+                    have_all &= link_xfer(l, buf, (uint16_t)out, &f);
+                    if (off + chunk < total) l->now_us += PACE_US;
+                }
+            }
+            send_set = false;
+        }
+
+        int out = proto_build_descriptor(PF_DESC_DONE, NULL, 0, buf, sizeof(buf));
+        bool answered = false;
+        if (link_xfer(l, buf, (uint16_t)out, &f))
+        {
+            l->now_us += TURNAROUND_US;
+            out = have_all ? proto_build_ctrl_ready(buf, sizeof(buf))
+                           : proto_build_ctrl_desc_resend(buf, sizeof(buf));
+            answered = link_xfer(l, buf, (uint16_t)out, &f);
+        }
+
+        if (answered && have_all)
+        {
+            r.ok = true;
+            break;
+        }
+        if (!answered)
+        {
+            l->now_us += READY_TIMEOUT_US;
+            if (++retries > DONE_RETRIES) break;
+            continue;
+        }
+        retries = 0;
+        if (++r.rounds > MAX_ROUNDS) break;
+        send_set = true;
+    }
+    return r;
+}
+
+// ------------------------------------------------------
+
+typedef struct
+{
+    uint32_t ok;
+    uint32_t corrupt;
+    uint64_t rounds;
+    uint64_t bytes;
+    uint64_t time_sum_us;
+    uint64_t* times;
+} stats_t;
+
+static int cmp_u64(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void stats_add(stats_t* s, run_result_t const* r, link_t const* l)
+{
+    s->rounds += r->rounds;
+    s->bytes += l->wire_bytes;
+    s->corrupt += r->corrupt;
+    if (r->ok)
+    {
+        // Time only counts sets that made it; a failed one ends in
+        // UNMOUNT/RESET, which the simulation does not price.
+        s->time_sum_us += l->now_us;
+        s->times[s->ok++] = l->now_us;
+    }
+}
+
+static void stats_print(const char* name, stats_t* s, uint32_t trials)
+{
+    uint32_t n = s->ok ? s->ok : 1;
+    qsort(s->times, s->ok, sizeof(s->times[0]), cmp_u64);
+    printf("  %-6s ok=%6.2f%%  rounds=%5.2f  bytes=%7.0f  ok ms mean=%7.1f p50=%7.1f p99=%7.1f%s\n",
+           name,
+           100.0 * s->ok / trials,
+           (double)s->rounds / trials,
+           (double)s->bytes / trials,
+           (double)s->time_sum_us / n / 1000.0,
+           (double)s->times[s->ok / 2] / 1000.0,
+           (double)s->times[(uint64_t)s->ok * 99u / 100u] / 1000.0,
+           s->corrupt ? "  CORRUPT" : "");
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t trials = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 2000u;
+    uint32_t baud   = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 0) : 1000000u;
+    if (!trials) trials = 1;
+    if (!baud) baud = 1000000u;
+
+    static const uint32_t k_ppm[] = { 0, 100, 500, 1000, 3000, 10000 };
+    static uint8_t src[2 + SET_MAX][DESC_MAX];
+    uint16_t lens[2 + SET_MAX];
+    int rc = 0;
+
+    printf("descriptor hand-off, %u trials, %u baud\n", trials, baud);
+    for (size_t si = 0; si < sizeof(k_sets) / sizeof(k_sets[0]); si++)
+    {
+        const desc_set_t* set = &k_sets[si];
+        for (size_t pi = 0; pi < sizeof(k_ppm) / sizeof(k_ppm[0]); pi++)
+        {
+            stats_t res  = { .times = calloc(trials, sizeof(uint64_t)) };
+            stats_t full = { .times = calloc(trials, sizeof(uint64_t)) };
+            if (!res.times || !full.times) return 1;
+
+            for (uint32_t t = 0; t < trials; t++)
+            {
+                make_source(set, src, lens);
+
+                link_t l = { .baud = baud, .byte_err_ppm = k_ppm[pi] };
+                run_result_t r = run_resume(&l, src, lens, set->reports);
+                stats_add(&res, &r, &l);
+
+                link_t lf = { .baud = baud, .byte_err_ppm = k_ppm[pi] };
+                r = run_full(&lf, src, lens, set->reports);
+                stats_add(&full, &r, &lf);
+            }
+
+            printf("%s, byte error %.2f%%\n", set->name, k_ppm[pi] / 10000.0);
+            stats_print("resume", &res, trials);
+            stats_print("full", &full, trials);
+            if (res.corrupt) rc = 1;
+            free(res.times);
+            free(full.times);
+        }
+    }
+    return rc;
+}
@@ -0,0 +1,284 @@
+/*
+ * Host simulation: one B_host fanning out to several A_device targets.
+ *
+ * Runs B_host/fanout.c (routing table, focus, hotkey, reply and descriptor
+ * scope) over simulated links. Each target is a minimal A_device model: it
+ * counts the descriptor sets it is given (every DONE is one enumeration of
+ * its PC), answers DONE with READY, and records which interfaces' PF_INPUT
+ * reached it. Frames are real proto_frame frames with CRC, parsed on the far
+ * side. Scenarios:
+ *
+ *   enumerate  a descriptor set reaches every target; all READY
+ *   route      PF_INPUT follows the focus, pinned interfaces stay put
+ *   hotkey     Right Ctrl + digit moves the focus, the digit never leaks,
+ *              and no target is re-enumerated by the switch
+ *   resync     a target asking DESC_RESEND gets the set alone
+ *   diag       STATS_REQ goes to the focused target only
+ *
+ * This exercises the routing logic, not the board glue (hid_proxy_host.c
+ * releases held keys on the old target before the focus moves).
+ *
+ * Build and run from Firmware/:
+ *   gcc -O2 -DLOG_LEVEL=0 -DPROXY_FANOUT_TARGETS=3u -Isrc/common -Isrc/B_host \
+ *       -Itools/proto_bench/shim tools/fanout_sim/fanout_sim.c \
+ *       src/B_host/fanout.c src/common/proto_frame.c src/common/crc16.c \
+ *       -o fanout_sim
+ *   ./fanout_sim
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "fanout.h"
+#include "proto_frame.h"
+#include "proxy_config.h"
+
+// proto_frame.c and fanout.c log through the deferred LOGx path; nothing is printed here.
+volatile uint8_t g_log_level = 0;
+void logging_push(uint8_t level, uint8_t module, char const* fmt, uint8_t nargs,
+                  uintptr_t const* args, uint32_t str_mask)
+{
+    (void)level; (void)module; (void)fmt; (void)nargs; (void)args; (void)str_mask;
+}
+
+#define TARGETS   PROXY_FANOUT_TARGETS
+#define QUEUE_MAX 8u
+#define ITF_MAX   4u
+
+#define USAGE_KEY_1   0x1Eu
+#define USAGE_KEY_A   0x04u
+#define MOD_RIGHT_CTRL 0x10u
+
+typedef struct
+{
+    uint8_t  data[PROTO_MAX_FRAME_SIZE];
+    uint16_t len;
+} sim_frame_t;
+
+typedef struct
+{
+    // A_device -> B_host
+    sim_frame_t up[QUEUE_MAX];
+    uint8_t     up_count;
+    // What the target saw
+    uint32_t    frames;
+    uint32_t    desc_frames;
+    uint32_t    enumerations;
+    uint32_t    stats_reqs;
+    uint32_t    input[ITF_MAX];
+    uint8_t     last_keys[ITF_MAX];
+} sim_target_t;
+
+static sim_target_t s_tgt[TARGETS];
+static int          s_failures;
+
+static void check(bool ok, char const* what)
+{
+    printf("  %-58s %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok) s_failures++;
+}
+
+static void queue_up(uint8_t t, uint8_t const* frame, int len)
+{
+    sim_target_t* st = &s_tgt[t];
+    if (len <= 0 || st->up_count >= QUEUE_MAX) return;
+    memcpy(st->up[st->up_count].data, frame, (size_t)len);
+    st->up[st->up_count].len = (uint16_t)len;
+    st->up_count++;
+}
+
+// A_device side of target `t`.
+static void target_receive(uint8_t t, uint8_t const* frame, uint16_t len)
+{
+    sim_target_t* st = &s_tgt[t];
+    proto_frame_t f;
+    if (!proto_parse(frame, len, &f)) return;
+    st->frames++;
+
+    uint8_t buf[PROTO_MAX_FRAME_SIZE];
+    switch (f.type)
+    {
+        case PF_DESCRIPTOR:
+            st->desc_frames++;
+            if (f.cmd == PF_DESC_DONE)
+            {
+                st->enumerations++;
+                queue_up(t, buf, proto_build_ctrl_ready(buf, sizeof(buf)));
+            }
+            break;
+        case PF_INPUT:
+            if (f.len > 7 && f.data[0] < ITF_MAX)
+            {
+                st->input[f.data[0]]++;
+                st->last_keys[f.data[0]] = f.len > 9 ? f.data[9] : 0;
+            }
+            break;
+        case PF_CONTROL:
+            if (f.cmd == PF_CTRL_STATS_REQ) st->stats_reqs++;
+            break;
+        default:
+            break;
+    }
+}
+
+static int sim_send(uint8_t target, uint8_t const* frame, uint16_t len)
+{
+    target_receive(target, frame, len);
+    return (int)len;
+}
+
+static int sim_recv(uint8_t target, uint8_t* buf, uint16_t max)
+{
+    sim_target_t* st = &s_tgt[target];
+    if (!st->up_count) return 0;
+    uint16_t n = st->up[0].len < max ? st->up[0].len : max;
+    memcpy(buf, st->up[0].data, n);
+    memmove(&st->up[0], &st->up[1], (size_t)(st->up_count - 1u) * sizeof(st->up[0]));
+    st->up_count--;
+    return (int)n;
+}
+
+static const fanout_link_ops_t s_ops = {
+    .send          = sim_send,
+    .send_from_isr = sim_send,
+    .recv          = sim_recv,
+};
+
+// ---------------------------------------------------------------------------
+// B_host side, reduced to what touches routing
+// ---------------------------------------------------------------------------
+static void host_send_set(void)
+{
+    static const uint8_t device[18] = { 18, 1, 0x00, 0x02, 0, 0, 0, 64, 0x6D, 0x04, 0x2B, 0xC5, 0, 1, 1, 2, 0, 1 };
+    static const uint8_t config[9]  = { 9, 2, 9, 0, 1, 1, 0, 0xA0, 50 };
+    uint8_t buf[PROTO_MAX_FRAME_SIZE];
+    int n;
+    n = proto_build_descriptor(PF_DESC_DEVICE, device, sizeof(device), buf, sizeof(buf));
+    fanout_send(buf, (uint16_t)n);
+    n = proto_build_descriptor(PF_DESC_CONFIG, config, sizeof(config), buf, sizeof(buf));
+    fanout_send(buf, (uint16_t)n);
+    n = proto_build_descriptor(PF_DESC_DONE, NULL, 0, buf, sizeof(buf));
+    fanout_send(buf, (uint16_t)n);
+}
+
+// process_control_frames(): answers go back to the target that asked.
+static void host_poll(void)
+{
+    uint8_t buf[PROTO_MAX_FRAME_SIZE];
+    uint8_t src;
+    int len;
+    while ((len = fanout_recv(buf, sizeof(buf), &src)) > 0)
+    {
+        proto_frame_t f;
+        if (!proto_parse(buf, (uint16_t)len, &f) || f.type != PF_CONTROL) continue;
+        if (f.cmd == PF_CTRL_READY)
+        {
+            fanout_note_ready(src);
+        }
+        else if (f.cmd == PF_CTRL_DESC_RESEND)
+        {
+            fanout_desc_scope_reply();
+            host_send_set();
+        }
+    }
+}
+
+static void host_key_report(uint8_t itf, uint8_t mods, uint8_t key)
+{
+    uint8_t report[8] = { mods, 0, key, 0, 0, 0, 0, 0 };
+    uint8_t keys[1] = { key };
+    bool swallow = false;
+    if (itf == 0)
+    {
+        uint8_t target = fanout_hotkey_feed(mods, keys, key ? 1 : 0, &swallow);
+        if (target != FANOUT_NO_TARGET) fanout_set_focus(target);
+    }
+    if (swallow) return;
+
+    uint8_t buf[PROTO_MAX_FRAME_SIZE];
+    int n = proto_build_input(itf, 0, 0, report, sizeof(report), buf, sizeof(buf));
+    fanout_send(buf, (uint16_t)n);
+}
+
+static uint32_t total_enumerations(void)
+{
+    uint32_t n = 0;
+    for (uint8_t t = 0; t < TARGETS; t++) n += s_tgt[t].enumerations;
+    return n;
+}
+
+static bool all_ready(void)
+{
+    for (uint8_t t = 0; t < TARGETS; t++)
+    {
+        fanout_target_stats_t st;
+        if (!fanout_target_stats(t, &st) || !st.ready) return false;
+    }
+    return true;
+}
+
+int main(void)
+{
+    if (TARGETS < 3)
+    {
+        printf("build with -DPROXY_FANOUT_TARGETS=3u or more\n");
+        return 2;
+    }
+    fanout_init(TARGETS, &s_ops);
+
+    printf("enumerate\n");
+    host_send_set();
+    host_poll();
+    bool each = true;
+    for (uint8_t t = 0; t < TARGETS; t++) each = each && s_tgt[t].enumerations == 1;
+    check(each, "every target enumerated once");
+    check(all_ready(), "every target READY");
+    check(fanout_desc_scope() == (1u << TARGETS) - 1u, "descriptor scope is every target");
+
+    printf("route\n");
+    host_key_report(0, 0, USAGE_KEY_A);
+    host_key_report(0, 0, 0);
+    check(s_tgt[0].input[0] == 2 && s_tgt[1].input[0] == 0, "keyboard input reaches the focus only");
+    fanout_set_route(1, 2);
+    host_key_report(1, 0, 0);
+    check(s_tgt[2].input[1] == 1 && s_tgt[0].input[1] == 0, "pinned interface 1 reaches target 2");
+
+    printf("hotkey\n");
+    uint32_t enums = total_enumerations();
+    uint32_t before = s_tgt[0].input[0] + s_tgt[1].input[0];
+    host_key_report(0, MOD_RIGHT_CTRL, 0);               // Right Ctrl down: still target 0
+    host_key_report(0, MOD_RIGHT_CTRL, USAGE_KEY_1 + 1); // + '2'
+    check(fanout_focus() == 1, "Right Ctrl+2 focuses target 1");
+    host_key_report(0, MOD_RIGHT_CTRL, USAGE_KEY_1 + 1); // digit still held
+    check(s_tgt[0].input[0] + s_tgt[1].input[0] == before + 1, "reports holding the digit are swallowed");
+    host_key_report(0, MOD_RIGHT_CTRL, 0);               // digit released
+    host_key_report(0, 0, USAGE_KEY_A);
+    check(s_tgt[1].input[0] == 2 && s_tgt[1].last_keys[0] == USAGE_KEY_A, "input after the switch reaches target 1");
+    check(s_tgt[2].input[1] == 1, "pinned interface unaffected by the switch");
+    check(total_enumerations() == enums, "no target re-enumerated by the switch");
+    check(fanout_switch_count() == 1, "one focus switch counted");
+    host_key_report(0, MOD_RIGHT_CTRL, USAGE_KEY_1 + TARGETS);
+    check(fanout_focus() == 1, "digit beyond the last target ignored");
+    host_key_report(0, 0, 0);
+
+    printf("resync\n");
+    uint8_t buf[PROTO_MAX_FRAME_SIZE];
+    int n = proto_build_ctrl_desc_resend(buf, sizeof(buf));
+    queue_up(2, buf, n);
+    uint32_t e0 = s_tgt[0].enumerations, e1 = s_tgt[1].enumerations, e2 = s_tgt[2].enumerations;
+    host_poll();
+    check(s_tgt[2].enumerations == e2 + 1, "asking target re-enumerated");
+    check(s_tgt[0].enumerations == e0 && s_tgt[1].enumerations == e1, "other targets untouched");
+    check(fanout_desc_scope() == (1u << TARGETS) - 1u, "scope back to every target after READY");
+
+    printf("diag\n");
+    n = proto_build_ctrl_stats_req(buf, sizeof(buf));
+    fanout_send(buf, (uint16_t)n);
+    check(s_tgt[1].stats_reqs == 1 && s_tgt[0].stats_reqs == 0 && s_tgt[2].stats_reqs == 0,
+          "STATS_REQ reaches the focus only");
+
+    printf("%s\n", s_failures ? "FAILED" : "all passed");
+    return s_failures ? 1 : 0;
+}
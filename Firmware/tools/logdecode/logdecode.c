@@ -0,0 +1,254 @@
+/*
+ * Host tool: turns deferred log records back into text.
+ *
+ * Firmware built with LOG_DEFERRED=1 stores a log call as the address of its
+ * format string plus raw 32-bit arguments. With the record drain
+ * (LOG_DRAIN=1, or logging_set_drain()) the stdio UART carries one
+ * "@L<hex words>" line per call; B_host LOG_READ (cmd 0x17) returns the same
+ * words as raw little-endian bytes. This tool reads the format strings from
+ * the matching ELF and prints the lines the firmware would have printed,
+ * prefixed with the B_host/A_device clock in microseconds.
+ *
+ * Build and run from Firmware/:
+ *   gcc -O2 tools/logdecode/logdecode.c -o logdecode
+ *   ./logdecode build/B_host.elf < console.log        # "@L" lines, others pass through
+ *   ./logdecode -b build/B_host.elf log_read.bin      # raw LOG_READ payloads
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SHF_ALLOC     0x2u
+#define SHT_PROGBITS  1u
+#define MAX_WORDS     256u
+
+typedef struct
+{
+    uint32_t addr;
+    uint32_t size;
+    uint32_t offset;
+} section_t;
+
+static uint8_t*   s_elf;
+static size_t     s_elf_len;
+static section_t  s_sections[64];
+static unsigned   s_section_count;
+
+static uint32_t rd32(uint8_t const* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t rd16(uint8_t const* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static bool load_elf(char const* path)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    s_elf = malloc((size_t)len);
+    if (!s_elf || fread(s_elf, 1, (size_t)len, f) != (size_t)len)
+    {
+        fclose(f);
+        return false;
+    }
+    fclose(f);
+    s_elf_len = (size_t)len;
+
+    // ELF32, little-endian: the RP2040 images.
+    if (s_elf_len < 52 || memcmp(s_elf, "\x7f" "ELF", 4) != 0 || s_elf[4] != 1 || s_elf[5] != 1) return false;
+    uint32_t shoff = rd32(&s_elf[32]);
+    uint16_t shentsize = rd16(&s_elf[46]);
+    uint16_t shnum = rd16(&s_elf[48]);
+    for (uint16_t i = 0; i < shnum && s_section_count < sizeof(s_sections) / sizeof(s_sections[0]); i++)
+    {
+        size_t at = shoff + (size_t)i * shentsize;
+        if (at + 40 > s_elf_len) break;
+        uint8_t const* sh = &s_elf[at];
+        if (rd32(&sh[4]) != SHT_PROGBITS || !(rd32(&sh[8]) & SHF_ALLOC)) continue;
+        section_t* s = &s_sections[s_section_count++];
+        s->addr = rd32(&sh[12]);
+        s->offset = rd32(&sh[16]);
+        s->size = rd32(&sh[20]);
+    }
+    return s_section_count != 0;
+}
+
+static char const* string_at(uint32_t addr)
+{
+    for (unsigned i = 0; i < s_section_count; i++)
+    {
+        section_t const* s = &s_sections[i];
+        if (addr < s->addr || addr - s->addr >= s->size) continue;
+        size_t off = s->offset + (addr - s->addr);
+        if (off >= s_elf_len || !memchr(&s_elf[off], 0, s_elf_len - off)) return NULL;
+        return (char const*)&s_elf[off];
+    }
+    return NULL;
+}
+
+// Mirrors format_entry() in common/logging.c.
+static void print_entry(uint32_t const* w, uint32_t words)
+{
+    static char const* const k_tags[] = { "", "[E] ", "[W] ", "[I] ", "[T] " };
+    uint32_t hdr = w[0];
+    uint32_t level = (hdr >> 8) & 0x07u;
+    uint32_t nargs = (hdr >> 16) & 0x1Fu;
+    char const* fmt = string_at(w[1]);
+    printf("%10lu ", (unsigned long)w[2]);
+    if (!fmt)
+    {
+        printf("<unknown format 0x%08lx, wrong ELF?>\n", (unsigned long)w[1]);
+        return;
+    }
+    fputs(k_tags[level < 5 ? level : 0], stdout);
+
+    uint32_t pos = 3;
+    uint32_t arg = 0;
+    while (*fmt)
+    {
+        if (*fmt != '%')
+        {
+            putchar(*fmt++);
+            continue;
+        }
+        char spec[16];
+        unsigned n = 0;
+        spec[n++] = *fmt++;
+        while (*fmt && n < sizeof(spec) - 2 && !strchr("diouxXcsp%", *fmt))
+        {
+            // Arguments are 32-bit on the target: drop length modifiers.
+            if (!strchr("lhzjt", *fmt)) spec[n++] = *fmt;
+            fmt++;
+        }
+        if (!*fmt) break;
+        char conv = *fmt++;
+        spec[n++] = conv;
+        spec[n] = '\0';
+        if (conv == '%')
+        {
+            putchar('%');
+            continue;
+        }
+        if (arg++ >= nargs || pos >= words) continue;
+
+        uint32_t v = w[pos++];
+        if (conv == 's')
+        {
+            char text[257];
+            uint32_t len = v < 256 ? v : 256;
+            for (uint32_t i = 0; i < len; i++)
+            {
+                uint32_t at = pos + i / 4;
+                text[i] = at < words ? (char)(w[at] >> (8 * (i % 4))) : '?';
+            }
+            text[len] = '\0';
+            pos += (v + 3) / 4;
+            printf(spec, text);
+        }
+        else if (conv == 'd' || conv == 'i')
+        {
+            printf(spec, (int)(int32_t)v);
+        }
+        else if (conv == 'p')
+        {
+            printf("0x%08lx", (unsigned long)v);
+        }
+        else
+        {
+            printf(spec, (unsigned)v);
+        }
+    }
+    putchar('\n');
+}
+
+static int decode_lines(FILE* in)
+{
+    char line[4096];
+    while (fgets(line, sizeof(line), in))
+    {
+        char* rec = strstr(line, "@L");
+        if (!rec)
+        {
+            fputs(line, stdout);
+            continue;
+        }
+        uint32_t w[MAX_WORDS];
+        uint32_t words = 0;
+        char const* p = rec + 2;
+        while (words < MAX_WORDS && strspn(p, "0123456789abcdefABCDEF") >= 8)
+        {
+            char hex[9];
+            memcpy(hex, p, 8);
+            hex[8] = '\0';
+            w[words++] = (uint32_t)strtoul(hex, NULL, 16);
+            p += 8;
+        }
+        if (words < 3 || (w[0] & 0xFFu) != words)
+        {
+            printf("<bad record> %s", rec);
+            continue;
+        }
+        print_entry(w, words);
+    }
+    return 0;
+}
+
+static int decode_binary(FILE* in)
+{
+    uint8_t b[4];
+    uint32_t w[MAX_WORDS];
+    while (fread(b, 1, 4, in) == 4)
+    {
+        w[0] = rd32(b);
+        uint32_t words = w[0] & 0xFFu;
+        if (words < 3)
+        {
+            fprintf(stderr, "bad entry header 0x%08lx\n", (unsigned long)w[0]);
+            return 1;
+        }
+        for (uint32_t i = 1; i < words; i++)
+        {
+            if (fread(b, 1, 4, in) != 4) return 1;
+            w[i] = rd32(b);
+        }
+        print_entry(w, words);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    bool binary = argc > 1 && strcmp(argv[1], "-b") == 0;
+    int first = binary ? 2 : 1;
+    if (argc <= first)
+    {
+        fprintf(stderr, "usage: %s [-b] firmware.elf [input]\n", argv[0]);
+        return 2;
+    }
+    if (!load_elf(argv[first]))
+    {
+        fprintf(stderr, "%s: not a readable ELF32 image\n", argv[first]);
+        return 1;
+    }
+
+    FILE* in = stdin;
+    if (argc > first + 1)
+    {
+        in = fopen(argv[first + 1], binary ? "rb" : "r");
+        if (!in)
+        {
+            perror(argv[first + 1]);
+            return 1;
+        }
+    }
+    return binary ? decode_binary(in) : decode_lines(in);
+}
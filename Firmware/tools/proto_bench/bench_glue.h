@@ -0,0 +1,35 @@
+// Entry points into firmware statics. Each glue_*.c includes one firmware
+// translation unit whole, so the code measured is the code that ships.
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// glue_link.c: common/uart_transport.c
+int  bench_slip_encode(const uint8_t* data, uint16_t len, uint8_t* out, uint16_t out_max);
+// Pushes bytes into the link RX ring the way the UART IRQ does.
+void bench_link_feed(const uint8_t* data, uint32_t len);
+
+// glue_ctrl.c: B_host/control_uart.c
+// Opens a fast-MAC session with a fixed nonce, as SESSION_SETUP would.
+void bench_ctrl_start_fast_session(void);
+// Builds a signed command frame (v2 HMAC or fast SipHash), unencoded.
+int  bench_ctrl_build(uint8_t seq, uint8_t cmd, const uint8_t* payload, uint8_t len,
+                      bool fast, uint8_t* out, uint16_t out_max);
+void bench_ctrl_handle(const uint8_t* frame, uint16_t len);
+// Lets prebuilt fast frames pass the replay check again.
+void bench_ctrl_rewind_fast(void);
+
+// glue_host.c: B_host/hid_proxy_host.c
+typedef struct
+{
+    uint8_t        itf_protocol;   // HID_ITF_PROTOCOL_*
+    const uint8_t* desc;
+    uint16_t       desc_len;
+} bench_itf_t;
+
+// Mounts interfaces 0..n-1 on one device, streaming and READY-acked.
+void     bench_host_mount(uint8_t dev_addr, const bench_itf_t* itfs, uint8_t n);
+uint8_t  bench_host_infer_type(const uint8_t* desc, uint16_t len);
+uint32_t bench_host_inject_sent(void);
+uint32_t bench_host_reports_forwarded(void);
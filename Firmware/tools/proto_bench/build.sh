@@ -0,0 +1,17 @@
+#!/bin/sh
+# Builds the host microbenchmark from the B_host firmware sources.
+# Run from Firmware/; extra arguments go to the compiler (e.g. -DLOG_LEVEL=2).
+set -e
+cd "$(dirname "$0")/../.."
+
+B=tools/proto_bench
+# uart_transport.c, control_uart.c and hid_proxy_host.c are built through
+# the glue files, which reach their statics.
+# pio_link.c drives the PIO blocks and has no host counterpart; with the
+# default PROXY_FANOUT_TARGETS=1 nothing calls it.
+SRCS=$(ls src/common/*.c src/B_host/*.c | grep -v -e i2c -e pio_link -e '/main\.c$' \
+       -e '/uart_transport\.c$' -e '/control_uart\.c$' -e '/hid_proxy_host\.c$')
+
+${CC:-cc} -O2 -std=gnu11 -I$B/shim -I$B -Isrc/common -Isrc/B_host "$@" \
+    $B/proto_bench.c $B/host_platform.c $B/glue_link.c $B/glue_ctrl.c $B/glue_host.c \
+    $SRCS -o proto_bench
@@ -0,0 +1,27 @@
+// See bench_glue.h.
+#include "control_uart.c"
+
+#include "bench_glue.h"
+
+void bench_ctrl_start_fast_session(void)
+{
+    static const uint8_t k_nonce[CTRL_SESSION_NONCE_LEN] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+    start_fast_session(0, k_nonce);
+}
+
+int bench_ctrl_build(uint8_t seq, uint8_t cmd, const uint8_t* payload, uint8_t len,
+                     bool fast, uint8_t* out, uint16_t out_max)
+{
+    return fast ? build_fast_frame(seq, cmd, 0, payload, len, out, out_max)
+                : build_v2_frame(seq, cmd, 0, payload, len, out, out_max, false);
+}
+
+void bench_ctrl_handle(const uint8_t* frame, uint16_t len)
+{
+    handle_ctrl_frame(frame, len);
+}
+
+void bench_ctrl_rewind_fast(void)
+{
+    s_ctrl_fast.rx_counter = 0;
+}
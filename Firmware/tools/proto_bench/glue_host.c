@@ -0,0 +1,38 @@
+// See bench_glue.h.
+#include "hid_proxy_host.c"
+
+#include "bench_glue.h"
+
+void bench_host_mount(uint8_t dev_addr, const bench_itf_t* itfs, uint8_t n)
+{
+    for (uint8_t i = 0; i < n && i < CFG_TUH_HID; i++)
+    {
+        host_itf_state_t* hs = alloc_slot(dev_addr, i, i);
+        if (!hs) return;
+        hs->mounted = true;
+        hs->itf_protocol = itfs[i].itf_protocol;
+        hs->protocol = HID_PROTOCOL_REPORT;
+        hs->protocol_report_set = true;
+        hs->input_paused = false;
+        hs->input_started = true;
+        hs->input_ready = true;
+        hid_proxy_host_store_report_desc(i, itfs[i].desc, itfs[i].desc_len);
+        hid_proxy_host_update_inferred_type(i, itfs[i].desc, itfs[i].desc_len);
+    }
+    s_wait_ready_ack = false;
+}
+
+uint8_t bench_host_infer_type(const uint8_t* desc, uint16_t len)
+{
+    return infer_hid_type_from_report_desc(desc, len);
+}
+
+uint32_t bench_host_inject_sent(void)
+{
+    return metric_value(&m_inject_sent);
+}
+
+uint32_t bench_host_reports_forwarded(void)
+{
+    return metric_value(&m_input_reports) - metric_value(&m_input_skipped);
+}
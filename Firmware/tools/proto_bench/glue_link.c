@@ -0,0 +1,17 @@
+// See bench_glue.h.
+#include "uart_transport.c"
+
+#include "bench_glue.h"
+
+int bench_slip_encode(const uint8_t* data, uint16_t len, uint8_t* out, uint16_t out_max)
+{
+    return slip_encode(data, len, out, out_max);
+}
+
+void bench_link_feed(const uint8_t* data, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        rx_ring_push(data[i]);
+    }
+}
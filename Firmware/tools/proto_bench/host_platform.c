@@ -0,0 +1,256 @@
+/*
+ * Host stand-ins for the Pico SDK and TinyUSB calls the B_host sources make,
+ * so tools/proto_bench can link them unchanged.
+ *
+ * Time comes from CLOCK_MONOTONIC. UART writes go nowhere but are counted;
+ * the control UART's TX FIFO never reports full, so responses drain as fast
+ * as the firmware queues them. USB host requests all "succeed" without doing
+ * anything. Interrupt masking and spin locks are no-ops: the bench is single
+ * threaded.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "bsp/board.h"
+#include "hardware/flash.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "hardware/uart.h"
+#include "pico/rand.h"
+#include "pico/time.h"
+#include "pico/unique_id.h"
+#include "tusb.h"
+
+struct uart_inst
+{
+    uint      index;
+    uart_hw_t hw;
+};
+
+static struct uart_inst s_uart0 = { .index = 0, .hw = { .fr = UART_UARTFR_RXFE_BITS } };
+static struct uart_inst s_uart1 = { .index = 1, .hw = { .fr = UART_UARTFR_RXFE_BITS } };
+
+uart_inst_t* uart0_inst = &s_uart0;
+uart_inst_t* uart1_inst = &s_uart1;
+
+// Bytes the firmware wrote to each UART; read by nobody, kept so the writes
+// cannot be optimised away.
+volatile uint64_t g_host_uart_tx_bytes[2];
+
+// ------------------------------------------------------
+// Time
+// ------------------------------------------------------
+
+static uint64_t s_t0_ns = 0;
+
+static uint64_t mono_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t time_us_64(void)
+{
+    // Starts at 1 s, not 0: the firmware treats a zero timestamp as "never".
+    uint64_t now = mono_ns();
+    if (!s_t0_ns) s_t0_ns = now;
+    return (now - s_t0_ns) / 1000u + 1000000u;
+}
+
+uint32_t time_us_32(void)
+{
+    return (uint32_t)time_us_64();
+}
+
+absolute_time_t get_absolute_time(void)
+{
+    return time_us_64();
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t)
+{
+    return (uint32_t)(t / 1000u);
+}
+
+uint32_t board_millis(void)
+{
+    return (uint32_t)(time_us_64() / 1000u);
+}
+
+void sleep_ms(uint32_t ms)
+{
+    struct timespec ts = { .tv_sec = ms / 1000u, .tv_nsec = (long)(ms % 1000u) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+// ------------------------------------------------------
+// Interrupts, locks, alarms
+// ------------------------------------------------------
+
+uint32_t save_and_disable_interrupts(void) { return 0; }
+void restore_interrupts(uint32_t status) { (void)status; }
+
+static spin_lock_t s_spin_locks[32];
+static uint32_t    s_spin_claimed = 0;
+
+int spin_lock_claim_unused(bool required)
+{
+    (void)required;
+    for (int i = 0; i < 32; i++)
+    {
+        if (!(s_spin_claimed & (1u << i)))
+        {
+            s_spin_claimed |= 1u << i;
+            return i;
+        }
+    }
+    return -1;
+}
+
+spin_lock_t* spin_lock_init(uint lock_num) { return &s_spin_locks[lock_num & 31u]; }
+spin_lock_t* spin_lock_instance(uint lock_num) { return &s_spin_locks[lock_num & 31u]; }
+uint32_t spin_lock_blocking(spin_lock_t* lock) { (void)lock; return 0; }
+void spin_unlock(spin_lock_t* lock, uint32_t saved_irq) { (void)lock; (void)saved_irq; }
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) { (void)num; (void)handler; }
+void irq_set_enabled(uint num, bool enabled) { (void)num; (void)enabled; }
+
+int hardware_alarm_claim_unused(bool required) { (void)required; return 0; }
+void hardware_alarm_set_callback(uint alarm_num, hardware_alarm_callback_t callback) { (void)alarm_num; (void)callback; }
+bool hardware_alarm_set_target(uint alarm_num, absolute_time_t t) { (void)alarm_num; (void)t; return false; }
+void hardware_alarm_cancel(uint alarm_num) { (void)alarm_num; }
+void hardware_alarm_force_irq(uint alarm_num) { (void)alarm_num; }
+
+// ------------------------------------------------------
+// GPIO, flash, board identity
+// ------------------------------------------------------
+
+void gpio_init(uint gpio) { (void)gpio; }
+void gpio_set_dir(uint gpio, bool out) { (void)gpio; (void)out; }
+void gpio_pull_down(uint gpio) { (void)gpio; }
+void gpio_put(uint gpio, bool value) { (void)gpio; (void)value; }
+void gpio_set_function(uint gpio, enum gpio_function fn) { (void)gpio; (void)fn; }
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled) { (void)gpio; (void)events; (void)enabled; }
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback)
+{
+    (void)gpio;
+    (void)events;
+    (void)enabled;
+    (void)callback;
+}
+
+// Linker symbol on the device; here only its address is taken, by replay.c.
+char __flash_binary_end;
+
+void flash_range_erase(uint32_t flash_offs, size_t count) { (void)flash_offs; (void)count; }
+void flash_range_program(uint32_t flash_offs, const uint8_t* data, size_t count)
+{
+    (void)flash_offs;
+    (void)data;
+    (void)count;
+}
+
+void pico_get_unique_board_id(pico_unique_board_id_t* id_out)
+{
+    static const uint8_t k_id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES] = { 0xE6, 0x61, 0x38, 0x52, 0x83, 0x4B, 0x2A, 0x2F };
+    memcpy(id_out->id, k_id, sizeof(k_id));
+}
+
+void get_rand_128(rng_128_t* rand128)
+{
+    // Fixed: runs stay comparable.
+    rand128->r[0] = 0x0123456789ABCDEFull;
+    rand128->r[1] = 0xFEDCBA9876543210ull;
+}
+
+// ------------------------------------------------------
+// UART
+// ------------------------------------------------------
+
+uint uart_init(uart_inst_t* uart, uint baudrate) { (void)uart; return baudrate; }
+void uart_set_hw_flow(uart_inst_t* uart, bool cts, bool rts) { (void)uart; (void)cts; (void)rts; }
+void uart_set_format(uart_inst_t* uart, uint data_bits, uint stop_bits, uart_parity_t parity)
+{
+    (void)uart;
+    (void)data_bits;
+    (void)stop_bits;
+    (void)parity;
+}
+void uart_set_fifo_enabled(uart_inst_t* uart, bool enabled) { (void)uart; (void)enabled; }
+void uart_set_irq_enables(uart_inst_t* uart, bool rx_has_data, bool tx_needs_data)
+{
+    (void)uart;
+    (void)rx_has_data;
+    (void)tx_needs_data;
+}
+
+bool uart_is_readable(uart_inst_t* uart) { (void)uart; return false; }
+bool uart_is_writable(uart_inst_t* uart) { (void)uart; return true; }
+char uart_getc(uart_inst_t* uart) { (void)uart; return 0; }
+uint uart_get_index(uart_inst_t* uart) { return uart->index; }
+uart_hw_t* uart_get_hw(uart_inst_t* uart) { return &uart->hw; }
+
+void uart_putc_raw(uart_inst_t* uart, char c)
+{
+    (void)c;
+    g_host_uart_tx_bytes[uart->index & 1u]++;
+}
+
+void uart_write_blocking(uart_inst_t* uart, const uint8_t* src, size_t len)
+{
+    (void)src;
+    g_host_uart_tx_bytes[uart->index & 1u] += len;
+}
+
+// ------------------------------------------------------
+// TinyUSB host
+// ------------------------------------------------------
+
+void tuh_task(void) {}
+bool tuh_control_xfer(tuh_xfer_t* xfer) { (void)xfer; return true; }
+bool tuh_descriptor_get_device(uint8_t daddr, void* buffer, uint16_t len, tuh_xfer_cb_t complete_cb, uintptr_t user_data)
+{
+    (void)daddr; (void)buffer; (void)len; (void)complete_cb; (void)user_data;
+    return true;
+}
+bool tuh_descriptor_get_configuration(uint8_t daddr, uint8_t index, void* buffer, uint16_t len,
+                                      tuh_xfer_cb_t complete_cb, uintptr_t user_data)
+{
+    (void)daddr; (void)index; (void)buffer; (void)len; (void)complete_cb; (void)user_data;
+    return true;
+}
+bool tuh_descriptor_get_hid_report(uint8_t daddr, uint8_t itf_num, uint8_t desc_type, uint8_t index,
+                                   void* buffer, uint16_t len, tuh_xfer_cb_t complete_cb, uintptr_t user_data)
+{
+    (void)daddr; (void)itf_num; (void)desc_type; (void)index; (void)buffer; (void)len; (void)complete_cb; (void)user_data;
+    return true;
+}
+bool tuh_descriptor_get_string(uint8_t daddr, uint8_t index, uint16_t language_id, void* buffer, uint16_t len,
+                               tuh_xfer_cb_t complete_cb, uintptr_t user_data)
+{
+    (void)daddr; (void)index; (void)language_id; (void)buffer; (void)len; (void)complete_cb; (void)user_data;
+    return true;
+}
+bool tuh_hid_itf_get_info(uint8_t daddr, uint8_t idx, tuh_itf_info_t* itf_info)
+{
+    (void)daddr; (void)idx;
+    memset(itf_info, 0, sizeof(*itf_info));
+    return false;
+}
+bool tuh_hid_receive_report(uint8_t dev_addr, uint8_t idx) { (void)dev_addr; (void)idx; return true; }
+bool tuh_hid_set_protocol(uint8_t dev_addr, uint8_t idx, uint8_t protocol) { (void)dev_addr; (void)idx; (void)protocol; return true; }
+bool tuh_hid_set_report(uint8_t dev_addr, uint8_t idx, uint8_t report_id, uint8_t report_type, void* report, uint16_t len)
+{
+    (void)dev_addr; (void)idx; (void)report_id; (void)report_type; (void)report; (void)len;
+    return true;
+}
+bool tuh_hid_get_report(uint8_t dev_addr, uint8_t idx, uint8_t report_id, uint8_t report_type, void* report, uint16_t len)
+{
+    (void)dev_addr; (void)idx; (void)report_id; (void)report_type; (void)report; (void)len;
+    return true;
+}
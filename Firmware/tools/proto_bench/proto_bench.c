@@ -0,0 +1,760 @@
+/*
+ * Host microbenchmarks for the bridge's per-report hot paths, built from the
+ * firmware sources unchanged (B_host configuration, see host_platform.c).
+ *
+ * Cases cover the link framing (proto_build_input, proto_parse, SLIP encode,
+ * the SLIP decode loop in uart_transport_recv_frame), the checksums and MACs
+ * (crc16_ccitt, hmac_sha256), the control UART (handle_ctrl_frame for v2 and
+ * fast-MAC INJECT_REPORT), the report-descriptor parsers and the physical
+ * forward path (hid_proxy_host_on_report). "mix" cases cycle through a
+ * desk-like report stream: mostly 9-byte gaming-mouse reports with boot
+ * mouse, boot keyboard, 17-byte NKRO and consumer-control reports mixed in.
+ *
+ * Each case reports the median and the best ns/op over the samples, and
+ * bytes/s of payload. Numbers are for regression tracking on one machine,
+ * not for predicting RP2040 timings.
+ *
+ * Build and run from Firmware/:
+ *   tools/proto_bench/build.sh            # -> ./proto_bench
+ *   ./proto_bench [-f filter] [-n samples] [-m min_sample_ms] [-o results.json]
+ *   ./proto_bench -b baseline.json [-t threshold_pct] [-o results.json]
+ *   ./proto_bench -l
+ *
+ * With -b the run is compared case by case against a file written by -o; a
+ * median more than threshold_pct (default 10) slower than the baseline is a
+ * regression and the exit status is 1. Exit status 2 means the self check
+ * failed: some path under test did not do its work, so its timing is
+ * meaningless.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench_glue.h"
+#include "control_uart.h"
+#include "crc16.h"
+#include "hid_host.h"
+#include "hid_proxy_host.h"
+#include "inject_sched.h"
+#include "metrics.h"
+#include "proto_frame.h"
+#include "replay.h"
+#include "sha256.h"
+#include "tusb.h"
+#include "uart_transport.h"
+
+#define MIX_LEN      64u
+#define REPORT_MAX   64u
+#define ENCODED_MAX  (PROTO_MAX_FRAME_SIZE * 2 + 4)
+#define CTRL_CMD_INJECT_REPORT   0x01
+#define CTRL_CMD_LIST_INTERFACES 0x02
+#define BENCH_DEV_ADDR 1
+
+// ------------------------------------------------------
+// Report descriptors and the report mix
+// ------------------------------------------------------
+
+static const uint8_t k_desc_boot_kbd[] = {
+    0x05, 0x01, 0x09, 0x06, 0xA1, 0x01, 0x05, 0x07, 0x19, 0xE0, 0x29, 0xE7, 0x15, 0x00, 0x25, 0x01,
+    0x75, 0x01, 0x95, 0x08, 0x81, 0x02, 0x95, 0x01, 0x75, 0x08, 0x81, 0x01, 0x95, 0x05, 0x75, 0x01,
+    0x05, 0x08, 0x19, 0x01, 0x29, 0x05, 0x91, 0x02, 0x95, 0x01, 0x75, 0x03, 0x91, 0x01, 0x95, 0x06,
+    0x75, 0x08, 0x15, 0x00, 0x25, 0x65, 0x05, 0x07, 0x19, 0x00, 0x29, 0x65, 0x81, 0x00, 0xC0,
+};
+
+static const uint8_t k_desc_boot_mouse[] = {
+    0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x09, 0x01, 0xA1, 0x00, 0x05, 0x09, 0x19, 0x01, 0x29, 0x03,
+    0x15, 0x00, 0x25, 0x01, 0x95, 0x03, 0x75, 0x01, 0x81, 0x02, 0x95, 0x01, 0x75, 0x05, 0x81, 0x01,
+    0x05, 0x01, 0x09, 0x30, 0x09, 0x31, 0x09, 0x38, 0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, 0x03,
+    0x81, 0x06, 0xC0, 0xC0,
+};
+
+// Report 1: 16 buttons, 16-bit X/Y, wheel, AC Pan (9 bytes with the ID).
+// Report 2: one consumer-control usage (3 bytes).
+static const uint8_t k_desc_gaming_mouse[] = {
+    0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x85, 0x01, 0x09, 0x01, 0xA1, 0x00,
+    0x05, 0x09, 0x19, 0x01, 0x29, 0x10, 0x15, 0x00, 0x25, 0x01, 0x95, 0x10, 0x75, 0x01, 0x81, 0x02,
+    0x05, 0x01, 0x16, 0x01, 0x80, 0x26, 0xFF, 0x7F, 0x75, 0x10, 0x95, 0x02, 0x09, 0x30, 0x09, 0x31, 0x81, 0x06,
+    0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, 0x01, 0x09, 0x38, 0x81, 0x06,
+    0x05, 0x0C, 0x0A, 0x38, 0x02, 0x95, 0x01, 0x81, 0x06,
+    0xC0, 0xC0,
+    0x05, 0x0C, 0x09, 0x01, 0xA1, 0x01, 0x85, 0x02, 0x15, 0x00, 0x26, 0xFF, 0x03, 0x19, 0x00, 0x2A, 0xFF, 0x03,
+    0x75, 0x10, 0x95, 0x01, 0x81, 0x00, 0xC0,
+};
+
+// Report 1: modifiers + 120-bit key bitmap (17 bytes with the ID), LED output.
+static const uint8_t k_desc_nkro_kbd[] = {
+    0x05, 0x01, 0x09, 0x06, 0xA1, 0x01, 0x85, 0x01,
+    0x05, 0x07, 0x19, 0xE0, 0x29, 0xE7, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x08, 0x81, 0x02,
+    0x19, 0x00, 0x29, 0x77, 0x95, 0x78, 0x81, 0x02,
+    0x05, 0x08, 0x19, 0x01, 0x29, 0x05, 0x95, 0x05, 0x75, 0x01, 0x91, 0x02, 0x95, 0x01, 0x75, 0x03, 0x91, 0x01,
+    0xC0,
+};
+
+static const bench_itf_t k_itfs[] = {
+    { HID_ITF_PROTOCOL_KEYBOARD, k_desc_boot_kbd, sizeof(k_desc_boot_kbd) },
+    { HID_ITF_PROTOCOL_MOUSE, k_desc_boot_mouse, sizeof(k_desc_boot_mouse) },
+    { HID_ITF_PROTOCOL_NONE, k_desc_gaming_mouse, sizeof(k_desc_gaming_mouse) },
+    { HID_ITF_PROTOCOL_NONE, k_desc_nkro_kbd, sizeof(k_desc_nkro_kbd) },
+};
+#define ITF_COUNT ((uint8_t)(sizeof(k_itfs) / sizeof(k_itfs[0])))
+
+// Interface and report ID of every input report the descriptors define.
+static const uint8_t k_layouts[][2] = { { 0, 0 }, { 1, 0 }, { 2, 1 }, { 2, 2 }, { 3, 1 } };
+#define LAYOUT_COUNT (sizeof(k_layouts) / sizeof(k_layouts[0]))
+
+typedef struct
+{
+    uint8_t itf;
+    uint8_t len;
+    uint8_t data[REPORT_MAX];
+} mix_report_t;
+
+static mix_report_t s_mix[MIX_LEN];
+
+static uint32_t s_rng = 0x2545F491u;
+
+static uint32_t rng_next(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static int16_t rng_delta(int16_t span)
+{
+    return (int16_t)((int32_t)(rng_next() % (uint32_t)(2 * span + 1)) - span);
+}
+
+// G gaming mouse, B boot mouse, K boot keyboard, N NKRO keyboard, C consumer.
+static void build_mix(void)
+{
+    static const char k_pattern[] = "GGGGBGGKGGGBGNGC";
+    for (uint32_t i = 0; i < MIX_LEN; i++)
+    {
+        mix_report_t* r = &s_mix[i];
+        memset(r, 0, sizeof(*r));
+        switch (k_pattern[i % (sizeof(k_pattern) - 1)])
+        {
+            case 'G':
+            {
+                int16_t dx = rng_delta(40);
+                int16_t dy = rng_delta(40);
+                r->itf = 2;
+                r->len = 9;
+                r->data[0] = 1;
+                r->data[1] = (rng_next() % 8u) == 0 ? 0x01 : 0x00;
+                r->data[3] = (uint8_t)dx;
+                r->data[4] = (uint8_t)((uint16_t)dx >> 8);
+                r->data[5] = (uint8_t)dy;
+                r->data[6] = (uint8_t)((uint16_t)dy >> 8);
+                r->data[7] = (rng_next() % 16u) == 0 ? 0xFF : 0x00;
+                break;
+            }
+            case 'B':
+                r->itf = 1;
+                r->len = 4;
+                r->data[1] = (uint8_t)rng_delta(20);
+                r->data[2] = (uint8_t)rng_delta(20);
+                break;
+            case 'K':
+                r->itf = 0;
+                r->len = 8;
+                r->data[0] = (rng_next() % 4u) == 0 ? 0x02 : 0x00;
+                r->data[2] = (uint8_t)(0x04 + rng_next() % 26u);
+                break;
+            case 'N':
+            {
+                uint8_t usage = (uint8_t)(0x04 + rng_next() % 26u);
+                r->itf = 3;
+                r->len = 17;
+                r->data[0] = 1;
+                r->data[2 + usage / 8u] = (uint8_t)(1u << (usage % 8u));
+                break;
+            }
+            default:
+                r->itf = 2;
+                r->len = 3;
+                r->data[0] = 2;
+                r->data[1] = 0xE9;   // Volume Increment
+                break;
+        }
+    }
+}
+
+// ------------------------------------------------------
+// Prebuilt inputs
+// ------------------------------------------------------
+
+static uint8_t  s_blob[256];
+static uint8_t  s_frames[MIX_LEN][PROTO_MAX_FRAME_SIZE];
+static uint16_t s_frame_len[MIX_LEN];
+static uint8_t  s_slip[MIX_LEN][ENCODED_MAX];
+static uint16_t s_slip_len[MIX_LEN];
+static uint8_t  s_escape_frame[REPORT_MAX];
+static uint8_t  s_ctrl_v2[MIX_LEN][PROTO_MAX_FRAME_SIZE];
+static uint16_t s_ctrl_v2_len[MIX_LEN];
+static uint8_t  s_ctrl_fast[MIX_LEN][PROTO_MAX_FRAME_SIZE];
+static uint16_t s_ctrl_fast_len[MIX_LEN];
+static uint8_t  s_ctrl_list[PROTO_MAX_FRAME_SIZE];
+static uint16_t s_ctrl_list_len;
+static uint8_t  s_hmac_key[32];
+
+static volatile uint32_t s_sink;
+
+static int inject_payload(const mix_report_t* r, uint8_t* out)
+{
+    out[0] = r->itf;
+    out[1] = r->len;
+    memcpy(&out[2], r->data, r->len);
+    return 2 + r->len;
+}
+
+static bool prepare_inputs(void)
+{
+    for (uint32_t i = 0; i < sizeof(s_blob); i++) s_blob[i] = (uint8_t)rng_next();
+    for (uint32_t i = 0; i < sizeof(s_hmac_key); i++) s_hmac_key[i] = (uint8_t)rng_next();
+    for (uint32_t i = 0; i < sizeof(s_escape_frame); i++) s_escape_frame[i] = (i & 1u) ? 0xDB : 0xC0;
+    build_mix();
+
+    for (uint32_t i = 0; i < MIX_LEN; i++)
+    {
+        const mix_report_t* r = &s_mix[i];
+        int n = proto_build_input(r->itf, 1000u + i, (uint16_t)i, r->data, r->len,
+                                  s_frames[i], sizeof(s_frames[i]));
+        if (n <= 0) return false;
+        s_frame_len[i] = (uint16_t)n;
+
+        n = bench_slip_encode(s_frames[i], s_frame_len[i], s_slip[i], sizeof(s_slip[i]));
+        if (n <= 0) return false;
+        s_slip_len[i] = (uint16_t)n;
+
+        uint8_t payload[2 + REPORT_MAX];
+        int plen = inject_payload(r, payload);
+        n = bench_ctrl_build((uint8_t)i, CTRL_CMD_INJECT_REPORT, payload, (uint8_t)plen, false,
+                             s_ctrl_v2[i], sizeof(s_ctrl_v2[i]));
+        if (n <= 0) return false;
+        s_ctrl_v2_len[i] = (uint16_t)n;
+    }
+
+    // Fast frames carry counters 1..MIX_LEN; responses move only the TX counter.
+    bench_ctrl_start_fast_session();
+    for (uint32_t i = 0; i < MIX_LEN; i++)
+    {
+        uint8_t payload[2 + REPORT_MAX];
+        int plen = inject_payload(&s_mix[i], payload);
+        int n = bench_ctrl_build((uint8_t)i, CTRL_CMD_INJECT_REPORT, payload, (uint8_t)plen, true,
+                                 s_ctrl_fast[i], sizeof(s_ctrl_fast[i]));
+        if (n <= 0) return false;
+        s_ctrl_fast_len[i] = (uint16_t)n;
+    }
+
+    int n = bench_ctrl_build(0, CTRL_CMD_LIST_INTERFACES, NULL, 0, false, s_ctrl_list, sizeof(s_ctrl_list));
+    if (n <= 0) return false;
+    s_ctrl_list_len = (uint16_t)n;
+    return true;
+}
+
+// ------------------------------------------------------
+// Cases: each op returns the payload bytes it processed
+// ------------------------------------------------------
+
+static uint32_t op_crc16_16(uint32_t i)
+{
+    s_sink += crc16_ccitt(&s_blob[i & 63u], 16, 0xFFFF);
+    return 16;
+}
+
+static uint32_t op_crc16_64(uint32_t i)
+{
+    s_sink += crc16_ccitt(&s_blob[i & 63u], 64, 0xFFFF);
+    return 64;
+}
+
+static uint32_t op_crc16_256(uint32_t i)
+{
+    (void)i;
+    s_sink += crc16_ccitt(s_blob, 256, 0xFFFF);
+    return 256;
+}
+
+static uint32_t op_hmac_raw(uint32_t i)
+{
+    uint8_t mac[32];
+    hmac_sha256(s_hmac_key, sizeof(s_hmac_key), &s_blob[i & 63u], 32, mac);
+    s_sink += mac[0];
+    return 32;
+}
+
+static hmac_sha256_key_t s_hmac_midstate;
+
+static void setup_hmac_midstate(void)
+{
+    hmac_sha256_precompute(&s_hmac_midstate, s_hmac_key, sizeof(s_hmac_key));
+}
+
+static uint32_t op_hmac_midstate(uint32_t i)
+{
+    uint8_t mac[32];
+    hmac_sha256_with(&s_hmac_midstate, &s_blob[i & 63u], 32, mac);
+    s_sink += mac[0];
+    return 32;
+}
+
+static uint32_t op_build_input_mix(uint32_t i)
+{
+    const mix_report_t* r = &s_mix[i % MIX_LEN];
+    uint8_t buf[PROTO_MAX_FRAME_SIZE];
+    s_sink += (uint32_t)proto_build_input(r->itf, i, (uint16_t)i, r->data, r->len, buf, sizeof(buf));
+    return r->len;
+}
+
+static uint32_t op_build_input_64(uint32_t i)
+{
+    uint8_t buf[PROTO_MAX_FRAME_SIZE];
+    s_sink += (uint32_t)proto_build_input(0, i, (uint16_t)i, s_blob, 64, buf, sizeof(buf));
+    return 64;
+}
+
+static uint32_t op_parse_mix(uint32_t i)
+{
+    uint32_t j = i % MIX_LEN;
+    proto_frame_t f;
+    s_sink += proto_parse(s_frames[j], s_frame_len[j], &f) ? f.len : 0u;
+    return s_frame_len[j];
+}
+
+static uint32_t op_slip_encode_mix(uint32_t i)
+{
+    uint32_t j = i % MIX_LEN;
+    uint8_t out[ENCODED_MAX];
+    s_sink += (uint32_t)bench_slip_encode(s_frames[j], s_frame_len[j], out, sizeof(out));
+    return s_frame_len[j];
+}
+
+static uint32_t op_slip_encode_escape(uint32_t i)
+{
+    (void)i;
+    uint8_t out[ENCODED_MAX];
+    s_sink += (uint32_t)bench_slip_encode(s_escape_frame, sizeof(s_escape_frame), out, sizeof(out));
+    return sizeof(s_escape_frame);
+}
+
+// The RX ring holds 16 KB; 256 mix frames stay well below that.
+#define SLIP_DECODE_BATCH 256u
+
+static void prepare_slip_decode(uint32_t batch)
+{
+    for (uint32_t i = 0; i < batch; i++)
+    {
+        bench_link_feed(s_slip[i % MIX_LEN], s_slip_len[i % MIX_LEN]);
+    }
+}
+
+static uint32_t op_slip_decode(uint32_t i)
+{
+    (void)i;
+    uint8_t buf[PROTO_MAX_FRAME_SIZE];
+    int n = uart_transport_recv_frame(buf, sizeof(buf));
+    s_sink += buf[0];
+    return n > 0 ? (uint32_t)n : 0u;
+}
+
+static uint32_t op_ctrl_inject_v2(uint32_t i)
+{
+    uint32_t j = i % MIX_LEN;
+    bench_ctrl_handle(s_ctrl_v2[j], s_ctrl_v2_len[j]);
+    return s_ctrl_v2_len[j];
+}
+
+static void prepare_ctrl_fast(uint32_t batch)
+{
+    (void)batch;
+    bench_ctrl_rewind_fast();
+}
+
+static uint32_t op_ctrl_inject_fast(uint32_t i)
+{
+    uint32_t j = i % MIX_LEN;
+    bench_ctrl_handle(s_ctrl_fast[j], s_ctrl_fast_len[j]);
+    return s_ctrl_fast_len[j];
+}
+
+static uint32_t op_ctrl_list(uint32_t i)
+{
+    (void)i;
+    bench_ctrl_handle(s_ctrl_list, s_ctrl_list_len);
+    return s_ctrl_list_len;
+}
+
+static uint32_t op_desc_infer(uint32_t i)
+{
+    const bench_itf_t* d = &k_itfs[i % ITF_COUNT];
+    s_sink += bench_host_infer_type(d->desc, d->desc_len);
+    return d->desc_len;
+}
+
+static uint32_t op_desc_layout(uint32_t i)
+{
+    const uint8_t* l = k_layouts[i % LAYOUT_COUNT];
+    hid_report_layout_t layout;
+    s_sink += hid_proxy_host_get_report_layout(l[0], l[1], &layout) ? layout.x_size_bits : 0u;
+    return k_itfs[l[0]].desc_len;
+}
+
+static uint32_t op_on_report(uint32_t i)
+{
+    const mix_report_t* r = &s_mix[i % MIX_LEN];
+    hid_proxy_host_on_report(BENCH_DEV_ADDR, r->itf, r->data, r->len);
+    return r->len;
+}
+
+typedef struct
+{
+    const char* name;
+    void     (*setup)(void);            // once, before the first sample
+    void     (*prepare)(uint32_t batch); // before every sample, not timed
+    uint32_t (*op)(uint32_t i);
+    uint32_t max_batch;                 // ops per sample cap, 0 = none
+} bench_case_t;
+
+static const bench_case_t k_cases[] = {
+    { "crc16_ccitt/16B",             NULL, NULL, op_crc16_16, 0 },
+    { "crc16_ccitt/64B",             NULL, NULL, op_crc16_64, 0 },
+    { "crc16_ccitt/256B",            NULL, NULL, op_crc16_256, 0 },
+    { "hmac_sha256/raw_key_32B",     NULL, NULL, op_hmac_raw, 0 },
+    { "hmac_sha256/midstate_32B",    setup_hmac_midstate, NULL, op_hmac_midstate, 0 },
+    { "proto_build_input/mix",       NULL, NULL, op_build_input_mix, 0 },
+    { "proto_build_input/64B",       NULL, NULL, op_build_input_64, 0 },
+    { "proto_parse/mix",             NULL, NULL, op_parse_mix, 0 },
+    { "slip_encode/mix",             NULL, NULL, op_slip_encode_mix, 0 },
+    { "slip_encode/escape_64B",      NULL, NULL, op_slip_encode_escape, 0 },
+    { "slip_decode/mix",             NULL, prepare_slip_decode, op_slip_decode, SLIP_DECODE_BATCH },
+    { "handle_ctrl_frame/inject_v2",   NULL, NULL, op_ctrl_inject_v2, 0 },
+    { "handle_ctrl_frame/inject_fast", NULL, prepare_ctrl_fast, op_ctrl_inject_fast, MIX_LEN },
+    { "handle_ctrl_frame/list_itfs",   NULL, NULL, op_ctrl_list, 0 },
+    { "report_desc/infer_type",      NULL, NULL, op_desc_infer, 0 },
+    { "report_desc/layout",          NULL, NULL, op_desc_layout, 0 },
+    { "on_report/mix",               NULL, NULL, op_on_report, 0 },
+};
+#define CASE_COUNT (sizeof(k_cases) / sizeof(k_cases[0]))
+
+// ------------------------------------------------------
+// Self check: every path must do its work before it is timed
+// ------------------------------------------------------
+
+static bool check(bool ok, const char* what)
+{
+    if (!ok) fprintf(stderr, "self check failed: %s\n", what);
+    return ok;
+}
+
+static bool self_check(void)
+{
+    bool ok = true;
+
+    proto_frame_t f;
+    ok &= check(proto_parse(s_frames[0], s_frame_len[0], &f) && f.type == PF_INPUT,
+                "proto_parse of a built input frame");
+
+    uint8_t buf[PROTO_MAX_FRAME_SIZE];
+    bench_link_feed(s_slip[13], s_slip_len[13]);
+    int n = uart_transport_recv_frame(buf, sizeof(buf));
+    ok &= check(n == s_frame_len[13] && memcmp(buf, s_frames[13], (size_t)n) == 0,
+                "SLIP round trip through uart_transport_recv_frame");
+
+    uint32_t before = bench_host_inject_sent();
+    bench_ctrl_handle(s_ctrl_v2[0], s_ctrl_v2_len[0]);
+    ok &= check(bench_host_inject_sent() == before + 1, "v2 INJECT_REPORT reaches the link");
+
+    bench_ctrl_rewind_fast();
+    before = bench_host_inject_sent();
+    bench_ctrl_handle(s_ctrl_fast[0], s_ctrl_fast_len[0]);
+    ok &= check(bench_host_inject_sent() == before + 1, "fast INJECT_REPORT reaches the link");
+
+    control_uart_stats_t st;
+    control_uart_get_stats(&st);
+    ok &= check(st.auth_failures == 0 && st.bad_frames == 0, "control frames verify");
+
+    ok &= check(bench_host_infer_type(k_desc_boot_kbd, sizeof(k_desc_boot_kbd)) == 0x01 &&
+                bench_host_infer_type(k_desc_gaming_mouse, sizeof(k_desc_gaming_mouse)) == 0x02,
+                "report type inference");
+    for (size_t i = 0; i < LAYOUT_COUNT; i++)
+    {
+        hid_report_layout_t layout;
+        ok &= check(hid_proxy_host_get_report_layout(k_layouts[i][0], k_layouts[i][1], &layout),
+                    "report layout for every input report");
+    }
+
+    before = bench_host_reports_forwarded();
+    op_on_report(0);
+    ok &= check(bench_host_reports_forwarded() == before + 1, "on_report forwards a physical report");
+    return ok;
+}
+
+// ------------------------------------------------------
+// Harness
+// ------------------------------------------------------
+
+typedef struct
+{
+    const char* name;
+    double      ns_per_op;      // median over samples
+    double      ns_per_op_min;
+    double      bytes_per_op;
+} bench_result_t;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t run_sample(const bench_case_t* c, uint32_t batch, uint32_t* base, uint64_t* bytes)
+{
+    if (c->prepare) c->prepare(batch);
+    uint32_t i0 = *base;
+    uint64_t b = 0;
+    uint64_t t0 = now_ns();
+    for (uint32_t i = 0; i < batch; i++)
+    {
+        b += c->op(i0 + i);
+    }
+    uint64_t t1 = now_ns();
+    *base = i0 + batch;
+    if (bytes) *bytes = b;
+    return t1 - t0;
+}
+
+static int cmp_double(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+#define MAX_SAMPLES 101
+
+static void run_case(const bench_case_t* c, uint32_t samples, double min_sample_ms, bench_result_t* out)
+{
+    if (c->setup) c->setup();
+
+    // Grow the batch until one sample takes min_sample_ms (or hits the cap);
+    // the calibration samples double as warmup.
+    uint32_t base = 0;
+    uint32_t batch = 16;
+    uint64_t target = (uint64_t)(min_sample_ms * 1e6);
+    for (;;)
+    {
+        uint64_t t = run_sample(c, batch, &base, NULL);
+        if (t >= target || batch >= (1u << 24)) break;
+        if (c->max_batch && batch >= c->max_batch) break;
+        batch *= 2;
+        if (c->max_batch && batch > c->max_batch) batch = c->max_batch;
+    }
+
+    double per_op[MAX_SAMPLES];
+    uint64_t bytes = 0;
+    for (uint32_t s = 0; s < samples; s++)
+    {
+        per_op[s] = (double)run_sample(c, batch, &base, &bytes) / batch;
+    }
+    qsort(per_op, samples, sizeof(per_op[0]), cmp_double);
+
+    out->name = c->name;
+    out->ns_per_op = per_op[samples / 2];
+    out->ns_per_op_min = per_op[0];
+    out->bytes_per_op = (double)bytes / batch;
+}
+
+static double bytes_per_s(const bench_result_t* r)
+{
+    return r->ns_per_op > 0 ? r->bytes_per_op * 1e9 / r->ns_per_op : 0;
+}
+
+static bool write_json(const char* path, const bench_result_t* res, size_t n)
+{
+    FILE* f = fopen(path, "w");
+    if (!f)
+    {
+        perror(path);
+        return false;
+    }
+    // One case per line: -b reads this back with a line scanner.
+    fprintf(f, "{\n  \"tool\": \"proto_bench\",\n  \"cases\": [\n");
+    for (size_t i = 0; i < n; i++)
+    {
+        fprintf(f, "    {\"name\": \"%s\", \"ns_per_op\": %.3f, \"ns_per_op_min\": %.3f, "
+                   "\"bytes_per_op\": %.2f, \"bytes_per_s\": %.0f}%s\n",
+                res[i].name, res[i].ns_per_op, res[i].ns_per_op_min,
+                res[i].bytes_per_op, bytes_per_s(&res[i]), (i + 1 < n) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    return fclose(f) == 0;
+}
+
+typedef struct
+{
+    char   name[64];
+    double ns_per_op;
+} baseline_entry_t;
+
+static size_t read_baseline(const char* path, baseline_entry_t* out, size_t max)
+{
+    FILE* f = fopen(path, "r");
+    if (!f)
+    {
+        perror(path);
+        return 0;
+    }
+    size_t n = 0;
+    char line[512];
+    while (n < max && fgets(line, sizeof(line), f))
+    {
+        char* p = strstr(line, "\"name\": \"");
+        char* q = strstr(line, "\"ns_per_op\": ");
+        if (!p || !q) continue;
+        p += strlen("\"name\": \"");
+        char* e = strchr(p, '"');
+        if (!e || (size_t)(e - p) >= sizeof(out[n].name)) continue;
+        memcpy(out[n].name, p, (size_t)(e - p));
+        out[n].name[e - p] = '\0';
+        out[n].ns_per_op = strtod(q + strlen("\"ns_per_op\": "), NULL);
+        n++;
+    }
+    fclose(f);
+    return n;
+}
+
+// Prints one line per case; returns the number of regressions.
+static int compare(const bench_result_t* res, size_t n, const baseline_entry_t* base, size_t nb,
+                   double threshold_pct)
+{
+    int regressions = 0;
+    printf("\n%-32s %12s %12s %8s\n", "case", "base ns/op", "ns/op", "delta");
+    for (size_t i = 0; i < n; i++)
+    {
+        const baseline_entry_t* b = NULL;
+        for (size_t j = 0; j < nb; j++)
+        {
+            if (strcmp(base[j].name, res[i].name) == 0)
+            {
+                b = &base[j];
+                break;
+            }
+        }
+        if (!b || b->ns_per_op <= 0)
+        {
+            printf("%-32s %12s %12.1f %8s  new\n", res[i].name, "-", res[i].ns_per_op, "-");
+            continue;
+        }
+        double delta = (res[i].ns_per_op / b->ns_per_op - 1.0) * 100.0;
+        const char* verdict = "ok";
+        if (delta > threshold_pct)
+        {
+            verdict = "REGRESSION";
+            regressions++;
+        }
+        else if (delta < -threshold_pct)
+        {
+            verdict = "faster";
+        }
+        printf("%-32s %12.1f %12.1f %+7.1f%%  %s\n", res[i].name, b->ns_per_op, res[i].ns_per_op, delta, verdict);
+    }
+    return regressions;
+}
+
+static void usage(const char* argv0)
+{
+    fprintf(stderr,
+            "usage: %s [-l] [-f filter] [-n samples] [-m min_sample_ms] [-o out.json]\n"
+            "          [-b baseline.json] [-t threshold_pct]\n",
+            argv0);
+}
+
+int main(int argc, char** argv)
+{
+    const char* filter = NULL;
+    const char* out_path = NULL;
+    const char* base_path = NULL;
+    uint32_t samples = 21;
+    double min_sample_ms = 2.0;
+    double threshold_pct = 10.0;
+    bool list = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* a = argv[i];
+        bool has_val = (i + 1 < argc);
+        if (strcmp(a, "-l") == 0) list = true;
+        else if (strcmp(a, "-f") == 0 && has_val) filter = argv[++i];
+        else if (strcmp(a, "-o") == 0 && has_val) out_path = argv[++i];
+        else if (strcmp(a, "-b") == 0 && has_val) base_path = argv[++i];
+        else if (strcmp(a, "-n") == 0 && has_val) samples = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(a, "-m") == 0 && has_val) min_sample_ms = strtod(argv[++i], NULL);
+        else if (strcmp(a, "-t") == 0 && has_val) threshold_pct = strtod(argv[++i], NULL);
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (samples == 0) samples = 1;
+    if (samples > MAX_SAMPLES) samples = MAX_SAMPLES;
+
+    if (list)
+    {
+        for (size_t i = 0; i < CASE_COUNT; i++) printf("%s\n", k_cases[i].name);
+        return 0;
+    }
+
+    // Same bring-up order as B_host/main.c, minus TinyUSB.
+    metrics_init();
+    uart_transport_init_host();
+    control_uart_init();
+    hid_host_init();
+    hid_proxy_host_init();
+    replay_init();
+    inject_sched_init();
+    bench_host_mount(BENCH_DEV_ADDR, k_itfs, ITF_COUNT);
+
+    if (!prepare_inputs() || !self_check()) return 2;
+
+    bench_result_t res[CASE_COUNT];
+    size_t n = 0;
+    printf("%-32s %10s %10s %12s\n", "case", "ns/op", "best", "MB/s");
+    for (size_t i = 0; i < CASE_COUNT; i++)
+    {
+        if (filter && !strstr(k_cases[i].name, filter)) continue;
+        run_case(&k_cases[i], samples, min_sample_ms, &res[n]);
+        printf("%-32s %10.1f %10.1f %12.2f\n", res[n].name, res[n].ns_per_op, res[n].ns_per_op_min,
+               bytes_per_s(&res[n]) / 1e6);
+        fflush(stdout);
+        n++;
+    }
+
+    if (out_path && !write_json(out_path, res, n)) return 2;
+
+    if (base_path)
+    {
+        baseline_entry_t base[CASE_COUNT * 2];
+        size_t nb = read_baseline(base_path, base, sizeof(base) / sizeof(base[0]));
+        if (!nb)
+        {
+            fprintf(stderr, "%s: no cases found\n", base_path);
+            return 2;
+        }
+        int regressions = compare(res, n, base, nb, threshold_pct);
+        if (regressions)
+        {
+            printf("\n%d case(s) slower than baseline by more than %.1f%%\n", regressions, threshold_pct);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,5 @@
+// Host shim of <bsp/board.h> for tools/proto_bench: declarations only, see host_platform.c.
+#pragma once
+#include <stdint.h>
+void board_init(void);
+uint32_t board_millis(void);
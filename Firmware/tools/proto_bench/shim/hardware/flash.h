@@ -0,0 +1,13 @@
+// Host shim of <hardware/flash.h> for tools/proto_bench: declarations only, see host_platform.c.
+#pragma once
+#include "pico/types.h"
+#define FLASH_PAGE_SIZE (1u << 8)
+#define FLASH_SECTOR_SIZE (1u << 12)
+#ifndef XIP_BASE
+#define XIP_BASE 0x10000000u
+#endif
+#ifndef PICO_FLASH_SIZE_BYTES
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+#endif
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
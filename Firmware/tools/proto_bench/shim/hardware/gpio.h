@@ -0,0 +1,15 @@
+// Host shim of <hardware/gpio.h> for tools/proto_bench: declarations only, see host_platform.c.
+#pragma once
+#include "pico/types.h"
+enum gpio_function { GPIO_FUNC_UART = 2 };
+#define GPIO_IN 0
+#define GPIO_OUT 1
+#define GPIO_IRQ_EDGE_RISE 8u
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t event_mask);
+void gpio_set_function(uint gpio, enum gpio_function fn);
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_pull_down(uint gpio);
+void gpio_put(uint gpio, bool value);
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback);
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled);
@@ -0,0 +1,8 @@
+// Host shim of <hardware/irq.h> for tools/proto_bench: declarations only, see host_platform.c.
+#pragma once
+#include "pico/types.h"
+#define UART0_IRQ 20
+#define UART1_IRQ 21
+typedef void (*irq_handler_t)(void);
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+void irq_set_enabled(uint num, bool enabled);
@@ -0,0 +1,13 @@
+// Host shim of <hardware/structs/uart.h> for tools/proto_bench: declarations only, see host_platform.c.
+#pragma once
+#include <stdint.h>
+typedef struct { volatile uint32_t dr, rsr, _pad[4], fr, _pad2, ilpr, ibrd, fbrd, lcr_h, cr, ifls, imsc, ris, mis, icr, dmacr; } uart_hw_t;
+#define UART_UARTFR_BUSY_BITS 0x8u
+#define UART_UARTFR_RXFE_BITS 0x10u
+#define UART_UARTIMSC_RXIM_BITS 0x10u
+#define UART_UARTIMSC_RTIM_BITS 0x40u
+#define UART_UARTDR_OE_BITS 0x800u
+#define UART_UARTFR_TXFF_BITS 0x20u
+#define UART_UARTIMSC_TXIM_BITS 0x20u
+static inline void hw_set_bits(volatile uint32_t* addr, uint32_t mask) { *addr |= mask; }
+static inline void hw_clear_bits(volatile uint32_t* addr, uint32_t mask) { *addr &= ~mask; }
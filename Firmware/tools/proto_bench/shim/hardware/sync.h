@@ -0,0 +1,13 @@
+// Host shim of <hardware/sync.h> for tools/proto_bench: declarations only, see host_platform.c.
+#pragma once
+#include "pico/types.h"
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+static inline void __dmb(void) {}
+static inline void __compiler_memory_barrier(void) {}
+typedef volatile uint32_t spin_lock_t;
+spin_lock_t *spin_lock_init(uint lock_num);
+uint32_t spin_lock_blocking(spin_lock_t *lock);
+void spin_unlock(spin_lock_t *lock, uint32_t saved_irq);
+int spin_lock_claim_unused(bool required);
+spin_lock_t *spin_lock_instance(uint lock_num);
@@ -0,0 +1,23 @@
+// Host shim of <hardware/uart.h> for tools/proto_bench: declarations only, see host_platform.c.
+#pragma once
+#include "pico/types.h"
+typedef struct uart_inst uart_inst_t;
+extern uart_inst_t *uart0_inst, *uart1_inst;
+#define uart0 uart0_inst
+#define uart1 uart1_inst
+typedef enum { UART_PARITY_NONE, UART_PARITY_EVEN, UART_PARITY_ODD } uart_parity_t;
+uint uart_init(uart_inst_t *uart, uint baudrate);
+void uart_set_hw_flow(uart_inst_t *uart, bool cts, bool rts);
+void uart_set_format(uart_inst_t *uart, uint data_bits, uint stop_bits, uart_parity_t parity);
+void uart_set_fifo_enabled(uart_inst_t *uart, bool enabled);
+bool uart_is_readable(uart_inst_t *uart);
+bool uart_is_writable(uart_inst_t *uart);
+char uart_getc(uart_inst_t *uart);
+void uart_putc_raw(uart_inst_t *uart, char c);
+void uart_write_blocking(uart_inst_t *uart, const uint8_t *src, size_t len);
+void uart_set_irq_enables(uart_inst_t *uart, bool rx_has_data, bool tx_needs_data);
+uint uart_get_index(uart_inst_t *uart);
+#include "hardware/structs/uart.h"
+uart_hw_t* uart_get_hw(uart_inst_t *uart);
+#define UART_NUM(u) uart_get_index(u)
+#define UART_IRQ_NUM(u) (20 + uart_get_index(u))
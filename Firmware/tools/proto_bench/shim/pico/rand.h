@@ -0,0 +1,7 @@
+// Host shim of <pico/rand.h> for tools/proto_bench: declarations only, see host_platform.c.
+#pragma once
+#include <stdint.h>
+typedef struct { uint64_t r[2]; } rng_128_t;
+void get_rand_128(rng_128_t* rand128);
+uint32_t get_rand_32(void);
+uint64_t get_rand_64(void);
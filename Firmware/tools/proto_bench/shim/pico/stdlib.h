@@ -0,0 +1,15 @@
+// Host shim of <pico/stdlib.h> for tools/proto_bench: declarations only, see host_platform.c.
+#pragma once
+#include "pico/types.h"
+#include "pico/time.h"
+#include "hardware/uart.h"
+#include "hardware/gpio.h"
+#include <stdio.h>
+void stdio_init_all(void);
+static inline void tight_loop_contents(void) {}
+void sleep_ms(uint32_t ms);
+void sleep_us(uint64_t us);
+void busy_wait_us_32(uint32_t us);
+#define __isr
+#define __not_in_flash_func(x) x
+#define __time_critical_func(x) x
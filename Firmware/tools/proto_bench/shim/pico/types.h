@@ -0,0 +1,7 @@
+// Host shim of <pico/types.h> for tools/proto_bench: declarations only, see host_platform.c.
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
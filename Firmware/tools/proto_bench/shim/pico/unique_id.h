@@ -0,0 +1,6 @@
+// Host shim of <pico/unique_id.h> for tools/proto_bench: declarations only, see host_platform.c.
+#pragma once
+#include <stdint.h>
+#define PICO_UNIQUE_BOARD_ID_SIZE_BYTES 8
+typedef struct { uint8_t id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES]; } pico_unique_board_id_t;
+void pico_get_unique_board_id(pico_unique_board_id_t *id_out);
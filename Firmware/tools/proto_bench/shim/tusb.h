@@ -0,0 +1,63 @@
+// Host shim of <tusb.h> for tools/proto_bench: declarations only, see host_platform.c.
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "tusb_config.h"
+#define TU_ATTR_PACKED __attribute__((packed))
+#define TU_BIT(n) (1UL << (n))
+#define TU_MIN(a,b) (((a) < (b)) ? (a) : (b))
+#define TU_MAX(a,b) (((a) > (b)) ? (a) : (b))
+#define TU_ARRAY_SIZE(a) (sizeof(a)/sizeof(a[0]))
+static inline uint16_t tu_min16(uint16_t a, uint16_t b) { return a < b ? a : b; }
+static inline uint16_t tu_le16toh(uint16_t v) { return v; }
+static inline uint16_t tu_htole16(uint16_t v) { return v; }
+typedef enum { TUSB_SPEED_FULL = 0, TUSB_SPEED_LOW = 1, TUSB_SPEED_HIGH = 2 } tusb_speed_t;
+typedef enum { TUSB_ROLE_INVALID=0, TUSB_ROLE_DEVICE = 1, TUSB_ROLE_HOST = 2 } tusb_role_t;
+typedef struct { tusb_role_t role; tusb_speed_t speed; } tusb_rhport_init_t;
+enum { TUSB_DESC_DEVICE = 1, TUSB_DESC_CONFIGURATION = 2, TUSB_DESC_STRING = 3, TUSB_DESC_INTERFACE = 4, TUSB_DESC_ENDPOINT = 5, TUSB_DESC_INTERFACE_ASSOCIATION = 11 };
+enum { TUSB_CLASS_HID = 3 };
+enum { TUSB_DIR_OUT = 0, TUSB_DIR_IN = 1, TUSB_DIR_IN_MASK = 0x80 };
+enum { TUSB_XFER_CONTROL = 0, TUSB_XFER_ISOCHRONOUS, TUSB_XFER_BULK, TUSB_XFER_INTERRUPT };
+static inline int tu_edpt_dir(uint8_t addr) { return (addr & 0x80) ? TUSB_DIR_IN : TUSB_DIR_OUT; }
+enum { TUSB_REQ_GET_DESCRIPTOR = 6 };
+enum { TUSB_REQ_RCPT_INTERFACE = 1 };
+enum { TUSB_REQ_TYPE_CLASS = 1 };
+enum { TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP = 0x20 };
+enum { HID_DESC_TYPE_HID = 0x21, HID_DESC_TYPE_REPORT = 0x22 };
+enum { HID_ITF_PROTOCOL_NONE = 0, HID_ITF_PROTOCOL_KEYBOARD = 1, HID_ITF_PROTOCOL_MOUSE = 2 };
+enum { HID_PROTOCOL_BOOT = 0, HID_PROTOCOL_REPORT = 1 };
+enum { HID_REQ_CONTROL_SET_IDLE = 0x0A };
+typedef enum { HID_REPORT_TYPE_INVALID=0, HID_REPORT_TYPE_INPUT=1, HID_REPORT_TYPE_OUTPUT=2, HID_REPORT_TYPE_FEATURE=3 } hid_report_type_t;
+typedef struct TU_ATTR_PACKED { uint8_t bLength, bDescriptorType; uint16_t bcdUSB; uint8_t bDeviceClass, bDeviceSubClass, bDeviceProtocol, bMaxPacketSize0; uint16_t idVendor, idProduct, bcdDevice; uint8_t iManufacturer, iProduct, iSerialNumber, bNumConfigurations; } tusb_desc_device_t;
+typedef struct TU_ATTR_PACKED { uint8_t bLength, bDescriptorType; uint16_t wTotalLength; uint8_t bNumInterfaces, bConfigurationValue, iConfiguration, bmAttributes, bMaxPower; } tusb_desc_configuration_t;
+typedef struct TU_ATTR_PACKED { uint8_t bLength, bDescriptorType, bInterfaceNumber, bAlternateSetting, bNumEndpoints, bInterfaceClass, bInterfaceSubClass, bInterfaceProtocol, iInterface; } tusb_desc_interface_t;
+typedef struct TU_ATTR_PACKED { uint8_t bLength, bDescriptorType, bEndpointAddress; struct TU_ATTR_PACKED { uint8_t xfer:2; uint8_t sync:2; uint8_t usage:2; uint8_t :2; } bmAttributes; uint16_t wMaxPacketSize; uint8_t bInterval; } tusb_desc_endpoint_t;
+typedef struct TU_ATTR_PACKED { union { struct TU_ATTR_PACKED { uint8_t recipient:5; uint8_t type:2; uint8_t direction:1; } bmRequestType_bit; uint8_t bmRequestType; }; uint8_t bRequest; uint16_t wValue, wIndex, wLength; } tusb_control_request_t;
+#define TUD_CONFIG_DESC_LEN 9
+#define TUD_HID_DESC_LEN 25
+#define TUD_CONFIG_DESCRIPTOR(n, itfc, s, tl, att, pw) 9, 2, (tl)&0xff, (tl)>>8, itfc, n, s, 0x80|att, pw/2
+#define TUD_HID_DESCRIPTOR(itf, s, p, rl, ep, sz, iv) 9,4,itf,0,1,3,0,p,s, 9,0x21,0x11,1,0,1,0x22,(rl)&0xff,(rl)>>8, 7,5,ep,3,(sz)&0xff,(sz)>>8,iv
+bool tusb_init(void);
+bool tusb_rhport_init(uint8_t rhport, const tusb_rhport_init_t* init);
+#if CFG_TUH_ENABLED
+typedef enum { XFER_RESULT_SUCCESS = 0, XFER_RESULT_FAILED, XFER_RESULT_STALLED, XFER_RESULT_TIMEOUT, XFER_RESULT_INVALID } xfer_result_t;
+typedef struct tuh_xfer_s tuh_xfer_t;
+typedef void (*tuh_xfer_cb_t)(tuh_xfer_t* xfer);
+struct tuh_xfer_s { uint8_t daddr; uint8_t ep_addr; xfer_result_t result; uint32_t actual_len; tusb_control_request_t const* setup; uint8_t* buffer; tuh_xfer_cb_t complete_cb; uintptr_t user_data; };
+typedef struct { uint8_t daddr; tusb_desc_interface_t desc; } tuh_itf_info_t;
+void tuh_task(void);
+bool tuh_descriptor_get_device(uint8_t daddr, void* buffer, uint16_t len, tuh_xfer_cb_t complete_cb, uintptr_t user_data);
+bool tuh_descriptor_get_configuration(uint8_t daddr, uint8_t index, void* buffer, uint16_t len, tuh_xfer_cb_t complete_cb, uintptr_t user_data);
+bool tuh_descriptor_get_hid_report(uint8_t daddr, uint8_t itf_num, uint8_t desc_type, uint8_t index, void* buffer, uint16_t len, tuh_xfer_cb_t complete_cb, uintptr_t user_data);
+bool tuh_descriptor_get_string(uint8_t daddr, uint8_t index, uint16_t language_id, void* buffer, uint16_t len, tuh_xfer_cb_t complete_cb, uintptr_t user_data);
+bool tuh_descriptor_get(uint8_t daddr, uint8_t type, uint8_t index, void* buffer, uint16_t len, tuh_xfer_cb_t complete_cb, uintptr_t user_data);
+bool tuh_control_xfer(tuh_xfer_t* xfer);
+bool tuh_hid_itf_get_info(uint8_t daddr, uint8_t idx, tuh_itf_info_t* itf_info);
+bool tuh_hid_receive_report(uint8_t dev_addr, uint8_t idx);
+bool tuh_hid_set_protocol(uint8_t dev_addr, uint8_t idx, uint8_t protocol);
+bool tuh_hid_set_report(uint8_t dev_addr, uint8_t idx, uint8_t report_id, uint8_t report_type, void* report, uint16_t len);
+bool tuh_hid_get_report(uint8_t dev_addr, uint8_t idx, uint8_t report_id, uint8_t report_type, void* report, uint16_t len);
+bool tuh_hid_send_report(uint8_t dev_addr, uint8_t idx, uint8_t report_id, const void* report, uint16_t len);
+#endif
@@ -0,0 +1,7 @@
+// Host shim of <tusb_option.h> for tools/proto_bench: declarations only, see host_platform.c.
+#pragma once
+#define OPT_MCU_RP2040 1
+#define OPT_OS_PICO 1
+#define OPT_MODE_HOST 2
+#define OPT_MODE_DEVICE 1
+#define OPT_MODE_NONE 0
@@ -9,6 +9,11 @@ public static class UartErrorCatalog
     public const string UartInjectFailed = "E_UART_DEVICE_ERROR_0x02";
     public const string UartDescriptorMissing = "E_UART_DEVICE_ERROR_0x03";
     public const string UartLayoutMissing = "E_UART_DEVICE_ERROR_0x04";
+    public const string UartSessionKeyRejected = "E_UART_DEVICE_ERROR_0x05";
+    public const string UartReplayRefused = "E_UART_DEVICE_ERROR_0x06";
+    public const string UartScheduleRefused = "E_UART_DEVICE_ERROR_0x07";
+    public const string UartTextRefused = "E_UART_DEVICE_ERROR_0x08";
+    public const string UartKeysFull = "E_UART_DEVICE_ERROR_0x09";
 
     /// <summary>
     /// Converts a firmware error code into a stable <see cref="ErrorInfo"/> contract value.
@@ -23,6 +28,11 @@ public static class UartErrorCatalog
             0x02 => new ErrorInfo(ErrorDomain.Uart, UartInjectFailed, "UART device failed to inject report", true),
             0x03 => new ErrorInfo(ErrorDomain.Uart, UartDescriptorMissing, "UART device is missing report descriptor", true),
             0x04 => new ErrorInfo(ErrorDomain.Uart, UartLayoutMissing, "UART device is missing report layout", true),
+            0x05 => new ErrorInfo(ErrorDomain.Uart, UartSessionKeyRejected, "UART device requires a derived-key HMAC frame for session setup", false),
+            0x06 => new ErrorInfo(ErrorDomain.Uart, UartReplayRefused, "UART device refused the replay operation", false),
+            0x07 => new ErrorInfo(ErrorDomain.Uart, UartScheduleRefused, "UART device refused a scheduled report", true),
+            0x08 => new ErrorInfo(ErrorDomain.Uart, UartTextRefused, "UART device refused text to type", true),
+            0x09 => new ErrorInfo(ErrorDomain.Uart, UartKeysFull, "UART device holds too many injected keys", false),
             _ => new ErrorInfo(ErrorDomain.Uart, $"E_UART_DEVICE_ERROR_0x{code:X2}", "UART device returned unknown error", false),
         };
     }
@@ -3,6 +3,11 @@ namespace HidBridge.Hid;
 /// <summary>
 /// Describes one HID interface reported by the bridge firmware.
 /// </summary>
+/// <remarks>
+/// <see cref="Itf"/> is the interface the target PC sees. With several devices behind a hub
+/// B_host presents one composite device, so it differs from <see cref="PhysicalItf"/>, the
+/// interface number on the physical device <see cref="DevAddr"/>; null from older firmware.
+/// </remarks>
 public sealed record HidInterfaceInfo(
     byte DevAddr,
     byte Itf,
@@ -10,7 +15,8 @@ public sealed record HidInterfaceInfo(
     byte Protocol,
     byte InferredType,
     bool Active,
-    bool Mounted);
+    bool Mounted,
+    byte? PhysicalItf = null);
 
 /// <summary>
 /// Represents the HID interface inventory returned by the bridge.
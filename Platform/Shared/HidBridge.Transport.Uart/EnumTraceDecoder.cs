@@ -0,0 +1,239 @@
+using System.Buffers.Binary;
+using System.Globalization;
+using System.Text;
+
+namespace HidBridge.Transport.Uart;
+
+/// <summary>
+/// Identifies one enumeration timeline event recorded by bridge firmware (see <c>common/enum_trace.h</c>).
+/// </summary>
+public enum EnumTraceEventKind : byte
+{
+    Mount = 1,
+    DescriptorFetched = 2,
+    DescriptorFrameSent = 3,
+    DescriptorFrameAccepted = 4,
+    DescriptorDoneSent = 5,
+    DescriptorDoneReceived = 6,
+    DeviceStackStarted = 7,
+    DeviceMounted = 8,
+    ReadySent = 9,
+    ReadyReceived = 10,
+    FirstInputSent = 11,
+    FirstInputDelivered = 12,
+    Unmount = 13,
+    ReplugResumed = 14,
+    DescriptorGapsSent = 15,
+    DescriptorGapsServed = 16,
+}
+
+/// <summary>
+/// Represents one timeline event on the B_host clock.
+/// </summary>
+/// <param name="TimeUs">Microseconds since the earliest event in the timeline.</param>
+/// <param name="Board">Recording board (0 = B_host, 1 = A_device).</param>
+/// <param name="Kind">Event kind.</param>
+/// <param name="Arg">Event argument (interface, descriptor type/index, frame cmd/len).</param>
+public sealed record EnumTraceEvent(uint TimeUs, byte Board, EnumTraceEventKind Kind, ushort Arg);
+
+/// <summary>
+/// Represents one decoded GET_TRACE response page.
+/// </summary>
+/// <param name="Total">Entries in the frozen merged timeline.</param>
+/// <param name="Page">Page index echoed by firmware.</param>
+/// <param name="HasRemote">Whether A_device events are part of the timeline.</param>
+/// <param name="Pending">Whether B_host is still pulling the A_device ring.</param>
+/// <param name="OffsetUs">A_device clock minus B_host clock in microseconds.</param>
+/// <param name="Events">Events carried by this page.</param>
+public sealed record EnumTracePage(
+    int Total,
+    byte Page,
+    bool HasRemote,
+    bool Pending,
+    int OffsetUs,
+    IReadOnlyList<EnumTraceEvent> Events);
+
+/// <summary>
+/// Represents a fully downloaded enumeration timeline.
+/// </summary>
+/// <param name="OffsetUs">A_device clock minus B_host clock in microseconds.</param>
+/// <param name="HasRemote">Whether A_device events are part of the timeline.</param>
+/// <param name="Events">Time-ordered events from both boards.</param>
+public sealed record EnumTraceTimeline(int OffsetUs, bool HasRemote, IReadOnlyList<EnumTraceEvent> Events);
+
+/// <summary>
+/// Represents the duration between two timeline events.
+/// </summary>
+/// <param name="Name">Human-readable phase name.</param>
+/// <param name="StartUs">Phase start on the timeline.</param>
+/// <param name="EndUs">Phase end on the timeline.</param>
+public sealed record EnumTracePhase(string Name, uint StartUs, uint EndUs)
+{
+    /// <summary>
+    /// Gets the phase duration in microseconds.
+    /// </summary>
+    public uint DurationUs => EndUs - StartUs;
+}
+
+/// <summary>
+/// Decodes firmware GET_TRACE pages and derives per-phase enumeration durations.
+/// </summary>
+public static class EnumTraceDecoder
+{
+    /// <summary>
+    /// Entries carried by one full GET_TRACE page.
+    /// </summary>
+    public const int EntriesPerPage = 28;
+
+    private const int HeaderLen = 9;
+    private const int EntryLen = 8;
+    private const byte FlagHasRemote = 0x01;
+    private const byte FlagPending = 0x02;
+    private const byte DescTypeDevice = 0x01;
+    private const byte DescTypeConfig = 0x02;
+
+    /// <summary>
+    /// Parses one GET_TRACE response payload.
+    /// </summary>
+    /// <param name="payload">Raw response payload.</param>
+    /// <param name="page">Decoded page when parsing succeeds.</param>
+    /// <returns><c>true</c> when the payload is well-formed; otherwise <c>false</c>.</returns>
+    public static bool TryParsePage(ReadOnlySpan<byte> payload, out EnumTracePage page)
+    {
+        page = null!;
+        if (payload.Length < HeaderLen)
+        {
+            return false;
+        }
+
+        var count = payload[4];
+        if (payload.Length < HeaderLen + (count * EntryLen))
+        {
+            return false;
+        }
+
+        var events = new List<EnumTraceEvent>(count);
+        for (var i = 0; i < count; i++)
+        {
+            var entry = payload.Slice(HeaderLen + (i * EntryLen), EntryLen);
+            events.Add(new EnumTraceEvent(
+                BinaryPrimitives.ReadUInt32LittleEndian(entry),
+                entry[4],
+                (EnumTraceEventKind)entry[5],
+                BinaryPrimitives.ReadUInt16LittleEndian(entry[6..])));
+        }
+
+        page = new EnumTracePage(
+            BinaryPrimitives.ReadUInt16LittleEndian(payload),
+            payload[2],
+            (payload[3] & FlagHasRemote) != 0,
+            (payload[3] & FlagPending) != 0,
+            BinaryPrimitives.ReadInt32LittleEndian(payload[5..]),
+            events);
+        return true;
+    }
+
+    /// <summary>
+    /// Derives mount-to-first-input phases; phases with missing or out-of-order events are skipped.
+    /// </summary>
+    /// <param name="events">Time-ordered timeline events.</param>
+    /// <returns>Phases in critical-path order.</returns>
+    public static IReadOnlyList<EnumTracePhase> ComputePhases(IReadOnlyList<EnumTraceEvent> events)
+    {
+        var mount = First(events, EnumTraceEventKind.Mount);
+        var deviceFetched = First(events, EnumTraceEventKind.DescriptorFetched, e => (e.Arg >> 8) == DescTypeDevice);
+        var configFetched = First(events, EnumTraceEventKind.DescriptorFetched, e => (e.Arg >> 8) == DescTypeConfig);
+        var lastFetched = Last(events, EnumTraceEventKind.DescriptorFetched);
+        var firstFrameSent = First(events, EnumTraceEventKind.DescriptorFrameSent);
+        var lastFrameAccepted = Last(events, EnumTraceEventKind.DescriptorFrameAccepted);
+        var doneSent = First(events, EnumTraceEventKind.DescriptorDoneSent);
+        var doneReceived = First(events, EnumTraceEventKind.DescriptorDoneReceived);
+        var stackStarted = First(events, EnumTraceEventKind.DeviceStackStarted);
+        var deviceMounted = First(events, EnumTraceEventKind.DeviceMounted);
+        var readySent = First(events, EnumTraceEventKind.ReadySent);
+        var readyReceived = First(events, EnumTraceEventKind.ReadyReceived);
+        var firstInputSent = First(events, EnumTraceEventKind.FirstInputSent);
+        var firstInputDelivered = First(events, EnumTraceEventKind.FirstInputDelivered);
+
+        var phases = new List<EnumTracePhase>();
+        AddPhase(phases, "B: device descriptor fetch", mount, deviceFetched);
+        AddPhase(phases, "B: config descriptor fetch", deviceFetched, configFetched);
+        AddPhase(phases, "B: report/string descriptor fetch", configFetched, lastFetched);
+        AddPhase(phases, "link: descriptor forwarding", firstFrameSent, lastFrameAccepted);
+        AddPhase(phases, "link: DONE", doneSent, doneReceived);
+        AddPhase(phases, "A: PC enumeration", stackStarted, deviceMounted);
+        AddPhase(phases, "link: READY", readySent, readyReceived);
+        AddPhase(phases, "B: READY to first input", readyReceived, firstInputSent);
+        AddPhase(phases, "link: first input", firstInputSent, firstInputDelivered);
+        AddPhase(phases, "total: mount to first input delivered", mount, firstInputDelivered);
+        return phases;
+    }
+
+    /// <summary>
+    /// Renders the timeline and its phase durations as plain text.
+    /// </summary>
+    /// <param name="timeline">Downloaded timeline.</param>
+    /// <returns>Multi-line report.</returns>
+    public static string Render(EnumTraceTimeline timeline)
+    {
+        var sb = new StringBuilder();
+        sb.AppendLine(string.Create(
+            CultureInfo.InvariantCulture,
+            $"events={timeline.Events.Count} a_device={(timeline.HasRemote ? "yes" : "no")} clock_offset_us={timeline.OffsetUs}"));
+        foreach (var e in timeline.Events)
+        {
+            sb.AppendLine(string.Create(
+                CultureInfo.InvariantCulture,
+                $"{e.TimeUs / 1000.0,10:F3} ms  {(e.Board == 0 ? 'B' : 'A')}  {e.Kind,-24} 0x{e.Arg:X4}"));
+        }
+
+        sb.AppendLine();
+        foreach (var phase in ComputePhases(timeline.Events))
+        {
+            sb.AppendLine(string.Create(
+                CultureInfo.InvariantCulture,
+                $"{phase.Name,-40} {phase.DurationUs / 1000.0,10:F3} ms"));
+        }
+
+        return sb.ToString();
+    }
+
+    private static EnumTraceEvent? First(
+        IReadOnlyList<EnumTraceEvent> events,
+        EnumTraceEventKind kind,
+        Func<EnumTraceEvent, bool>? predicate = null)
+    {
+        foreach (var e in events)
+        {
+            if (e.Kind == kind && (predicate is null || predicate(e)))
+            {
+                return e;
+            }
+        }
+
+        return null;
+    }
+
+    private static EnumTraceEvent? Last(IReadOnlyList<EnumTraceEvent> events, EnumTraceEventKind kind)
+    {
+        for (var i = events.Count - 1; i >= 0; i--)
+        {
+            if (events[i].Kind == kind)
+            {
+                return events[i];
+            }
+        }
+
+        return null;
+    }
+
+    private static void AddPhase(List<EnumTracePhase> phases, string name, EnumTraceEvent? start, EnumTraceEvent? end)
+    {
+        if (start is null || end is null || end.TimeUs < start.TimeUs)
+        {
+            return;
+        }
+
+        phases.Add(new EnumTracePhase(name, start.TimeUs, end.TimeUs));
+    }
+}
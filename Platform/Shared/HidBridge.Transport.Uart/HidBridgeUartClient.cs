@@ -1,3 +1,4 @@
+using System.Buffers.Binary;
 using System.Collections.Concurrent;
 using System.IO.Ports;
 using System.Security.Cryptography;
@@ -14,6 +15,25 @@ public sealed class HidBridgeUartClient : IAsyncDisposable
 {
     private const byte FlagResponse = 0x01;
     private const byte FlagError = 0x02;
+    private const byte FlagNoAck = 0x04;
+    private const byte CmdCumulativeAck = 0x0C;
+    private const byte CmdSubscribe = 0x0D;
+    private const byte CmdTap = 0x0E;
+    private const byte CmdTapData = 0x0F;
+    private const byte CmdReplay = 0x10;
+    private const byte CmdSchedule = 0x11;
+    private const byte CmdMove = 0x12;
+    private const byte CmdTypeText = 0x13;
+    private const byte CmdTypeEvent = 0x14;
+    private const byte CmdKey = 0x15;
+    private const byte CmdMix = 0x16;
+    private const byte CmdLogRead = 0x17;
+    private const byte CmdGetMetrics = 0x18;
+    private const byte CmdFanout = 0x19;
+    private const int ReplayChunkLen = 240;
+    // Nine 4 KB sector erases at up to 400 ms each, plus page programming.
+    private const int ReplaySaveTimeoutMs = 6000;
+    private const int MaxQueuedTapFrames = 256;
     private const byte FlagResponseLegacy = 0x80;
     private const byte FlagErrorLegacy = 0x40;
 
@@ -25,6 +45,14 @@ public sealed class HidBridgeUartClient : IAsyncDisposable
     private byte[]? _derivedHmacKey;
     private bool _forceBootstrapKey;
     private bool _usingDerivedKey;
+    private byte[]? _sessionKey;
+    private uint _sessionTxCounter;
+    private uint _sessionRxCounter;
+    private HidBridgeUartCumulativeAck? _lastCumulativeAck;
+    private UartTelemetryFrame? _lastTelemetry;
+    private UartTelemetryFrame? _pendingTelemetry;
+    private HidBridgeUartTypeTextStatus? _lastTypeEvent;
+    private readonly ConcurrentQueue<UartInputTapFrame> _tapFrames = new();
     private bool _rxEscaped;
     private int _seq;
     private byte _mouseButtons;
@@ -120,6 +148,51 @@ public sealed class HidBridgeUartClient : IAsyncDisposable
     {
         _forceBootstrapKey = true;
         _usingDerivedKey = false;
+        _sessionKey = null;
+    }
+
+    /// <summary>
+    /// Gets whether requests are currently sent as fast-MAC session frames.
+    /// </summary>
+    public bool IsUsingFastSession => _sessionKey is not null;
+
+    /// <summary>
+    /// Agrees a session key with firmware (SESSION_SETUP) and switches subsequent commands to
+    /// fast-MAC frames (SipHash-2-4 tag and replay counter instead of HMAC-SHA256).
+    /// Requires the derived key, see <see cref="EnsureDerivedKeyAsync"/>.
+    /// </summary>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns><c>true</c> when the session is active; otherwise <c>false</c> and v2 frames stay in use.</returns>
+    public async Task<bool> StartFastSessionAsync(CancellationToken cancellationToken)
+    {
+        _sessionKey = null;
+        if (_derivedHmacKey is null || _forceBootstrapKey)
+        {
+            return false;
+        }
+
+        var hostNonce = RandomNumberGenerator.GetBytes(UartFrameCodec.SessionNonceLen);
+        UartResponse? response;
+        try
+        {
+            response = await SendCommandAsync(0x09, hostNonce, _options.CommandTimeoutMs, cancellationToken, allowBootstrapFallback: false);
+        }
+        catch (HidBridgeUartDeviceException)
+        {
+            // Older firmware ignores 0x09; a bootstrap-signed setup is refused with error 5.
+            return false;
+        }
+
+        var payload = response?.Payload;
+        if (payload is null || payload.Length < UartFrameCodec.SessionNonceLen || response!.UsedAlternateHmacKey)
+        {
+            return false;
+        }
+
+        _sessionTxCounter = 0;
+        _sessionRxCounter = 0;
+        _sessionKey = UartFrameCodec.DeriveSessionKey(_derivedHmacKey, hostNonce, payload);
+        return true;
     }
 
     /// <summary>
@@ -280,6 +353,850 @@ public sealed class HidBridgeUartClient : IAsyncDisposable
         await SendKeyboardResetAsync(itf, layout, cancellationToken);
     }
 
+    /// <summary>
+    /// Sends reports as INJECT_BATCH commands: one MAC and one response per up to 240 payload bytes.
+    /// Firmware spaces the reports by <see cref="HidBridgeUartBatchReport.DelayUs"/>.
+    /// </summary>
+    /// <param name="reports">Reports in send order.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Aggregated firmware answer.</returns>
+    public async Task<HidBridgeUartBatchResult> SendInjectBatchAsync(
+        IReadOnlyList<HidBridgeUartBatchReport> reports,
+        CancellationToken cancellationToken)
+    {
+        var resolved = new List<HidBridgeUartBatchReport>(reports.Count);
+        foreach (var report in reports)
+        {
+            var itf = await ResolveInterfaceAsync(report.InterfaceSelector, preferMouse: report.InterfaceSelector != 0xFE, cancellationToken);
+            resolved.Add(report with { InterfaceSelector = itf });
+        }
+
+        var result = new HidBridgeUartBatchResult(0, 0, 0);
+        foreach (var payload in UartInjectBatch.Pack(resolved))
+        {
+            // No retries: a resent batch whose response was lost would inject its reports twice.
+            var response = await SendCommandAsync(0x0A, payload, _options.InjectTimeoutMs, cancellationToken);
+            if (response is null || response.Payload.Length < 6)
+            {
+                throw new TimeoutException(
+                    $"No UART ACK for inject batch on {_options.PortName} " +
+                    $"(baud={_options.BaudRate}, accepted={result.Accepted}, timeoutMs={_options.InjectTimeoutMs}).");
+            }
+
+            result = new HidBridgeUartBatchResult(
+                result.Accepted + response.Payload[0],
+                response.Payload[1],
+                BinaryPrimitives.ReadUInt32LittleEndian(response.Payload.AsSpan(2)));
+        }
+
+        return result;
+    }
+
+    /// <summary>
+    /// Queues reports in firmware for hardware-timed sending at their deadlines (SCHEDULE ADD).
+    /// </summary>
+    /// <param name="reports">Reports in deadline order.</param>
+    /// <param name="tag">Tag for <see cref="CancelScheduledReportsAsync"/>.</param>
+    /// <param name="absolute">Whether <see cref="HidBridgeUartScheduledReport.DueUs"/> is a B_host clock value.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Aggregated firmware answer, including the B_host clock.</returns>
+    public async Task<HidBridgeUartScheduleResult> ScheduleReportsAsync(
+        IReadOnlyList<HidBridgeUartScheduledReport> reports,
+        ushort tag,
+        bool absolute,
+        CancellationToken cancellationToken)
+    {
+        var resolved = new List<HidBridgeUartScheduledReport>(reports.Count);
+        foreach (var report in reports)
+        {
+            var itf = await ResolveInterfaceAsync(report.InterfaceSelector, preferMouse: report.InterfaceSelector != 0xFE, cancellationToken);
+            resolved.Add(report with { InterfaceSelector = itf });
+        }
+
+        var result = new HidBridgeUartScheduleResult(0, 0, 0);
+        foreach (var payload in UartInjectSchedule.Pack(resolved, tag, absolute))
+        {
+            // No retries: a resent ADD whose response was lost would queue its reports twice.
+            var response = await SendCommandAsync(CmdSchedule, payload, _options.InjectTimeoutMs, cancellationToken);
+            if (response is null || response.Payload.Length < 6)
+            {
+                throw new TimeoutException(
+                    $"No UART ACK for scheduled inject on {_options.PortName} " +
+                    $"(baud={_options.BaudRate}, accepted={result.Accepted}, timeoutMs={_options.InjectTimeoutMs}).");
+            }
+
+            result = new HidBridgeUartScheduleResult(
+                result.Accepted + response.Payload[0],
+                response.Payload[1],
+                BinaryPrimitives.ReadUInt32LittleEndian(response.Payload.AsSpan(2)));
+        }
+
+        return result;
+    }
+
+    /// <summary>
+    /// Removes pending scheduled reports.
+    /// </summary>
+    /// <param name="tag">Tag given to <see cref="ScheduleReportsAsync"/>, or <c>null</c> for all reports.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Number of reports removed.</returns>
+    public async Task<int> CancelScheduledReportsAsync(ushort? tag, CancellationToken cancellationToken)
+    {
+        var value = tag ?? UartInjectSchedule.TagAll;
+        var payload = new byte[] { UartInjectSchedule.SubCancel, (byte)(value & 0xFF), (byte)(value >> 8) };
+        var response = await SendCommandAsync(CmdSchedule, payload, _options.CommandTimeoutMs, cancellationToken);
+        if (response is null || response.Payload.Length < 2)
+        {
+            throw new TimeoutException($"No UART response for schedule cancel on {_options.PortName}.");
+        }
+
+        return response.Payload[0];
+    }
+
+    /// <summary>
+    /// Reads scheduled-injection counters and deadline accuracy.
+    /// </summary>
+    /// <param name="reset">Whether firmware resets the counters after reading them.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>The counters, or <c>null</c> without a response.</returns>
+    public async Task<HidBridgeUartScheduleStats?> GetScheduleStatsAsync(bool reset, CancellationToken cancellationToken)
+    {
+        var payload = new byte[] { UartInjectSchedule.SubStats, reset ? (byte)1 : (byte)0 };
+        var response = await SendCommandAsync(CmdSchedule, payload, _options.CommandTimeoutMs, cancellationToken);
+        return response is not null && UartInjectSchedule.TryParseStats(response.Payload, out var stats) ? stats : null;
+    }
+
+    /// <summary>
+    /// Starts a paced pointer motion in firmware, replacing any motion in progress (MOVE).
+    /// </summary>
+    /// <param name="move">Motion to perform.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Firmware motion status right after the start.</returns>
+    public async Task<HidBridgeUartMoveStatus> MovePointerAsync(HidBridgeUartPointerMove move, CancellationToken cancellationToken)
+    {
+        var itf = await ResolveInterfaceAsync(move.InterfaceSelector, preferMouse: true, cancellationToken);
+        var payload = UartPointerMove.Pack(move with { InterfaceSelector = itf });
+        var response = await SendCommandAsync(CmdMove, payload, _options.InjectTimeoutMs, cancellationToken);
+        if (response is null || !UartPointerMove.TryParseStatus(response.Payload, out var status))
+        {
+            throw new TimeoutException(
+                $"No UART response for pointer move on {_options.PortName} " +
+                $"(baud={_options.BaudRate}, timeoutMs={_options.InjectTimeoutMs}).");
+        }
+
+        return status;
+    }
+
+    /// <summary>
+    /// Stops the firmware pointer motion in progress.
+    /// </summary>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Status of the stopped motion, or <c>null</c> without a response.</returns>
+    public async Task<HidBridgeUartMoveStatus?> StopPointerMoveAsync(CancellationToken cancellationToken)
+    {
+        var response = await SendCommandAsync(CmdMove, new[] { UartPointerMove.ModeStop }, _options.CommandTimeoutMs, cancellationToken);
+        return response is not null && UartPointerMove.TryParseStatus(response.Payload, out var status) ? status : null;
+    }
+
+    /// <summary>
+    /// Reads the firmware pointer motion status.
+    /// </summary>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>The status, or <c>null</c> without a response.</returns>
+    public async Task<HidBridgeUartMoveStatus?> GetPointerMoveStatusAsync(CancellationToken cancellationToken)
+    {
+        var response = await SendCommandAsync(CmdMove, Array.Empty<byte>(), _options.CommandTimeoutMs, cancellationToken);
+        return response is not null && UartPointerMove.TryParseStatus(response.Payload, out var status) ? status : null;
+    }
+
+    /// <summary>
+    /// Types text on a keyboard interface with the firmware typing engine (TYPE_TEXT).
+    /// </summary>
+    /// <param name="text">Text to type; characters the layout cannot produce are skipped.</param>
+    /// <param name="layout">Keyboard layout the target host uses.</param>
+    /// <param name="interfaceSelector">Keyboard interface or 0xFE for the first keyboard.</param>
+    /// <param name="sendEvents">Whether firmware pushes TYPE_EVENT progress frames (see <see cref="LastTypeEvent"/>).</param>
+    /// <param name="releaseEachKey">Whether firmware releases after every key instead of only before a repeat.</param>
+    /// <param name="intervalUs">Report spacing; 0 uses the endpoint poll interval.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Firmware typing status after the last chunk was queued.</returns>
+    public async Task<HidBridgeUartTypeTextStatus> TypeTextAsync(
+        string text,
+        UartKeyboardLayout layout,
+        byte interfaceSelector,
+        bool sendEvents,
+        bool releaseEachKey,
+        ushort intervalUs,
+        CancellationToken cancellationToken)
+    {
+        var itf = await ResolveInterfaceAsync(interfaceSelector, preferMouse: false, cancellationToken);
+        var flags = (byte)((sendEvents ? UartTextTyping.FlagEvents : 0) | (releaseEachKey ? UartTextTyping.FlagReleaseEach : 0));
+        HidBridgeUartTypeTextStatus? status = null;
+        foreach (var payload in UartTextTyping.Pack(text, layout, itf, flags, intervalUs))
+        {
+            while (true)
+            {
+                try
+                {
+                    // No retries: a resent APPEND whose response was lost would type its text twice.
+                    var response = await SendCommandAsync(CmdTypeText, payload, _options.CommandTimeoutMs, cancellationToken);
+                    if (response is null || !UartTextTyping.TryParseStatus(response.Payload, out var parsed))
+                    {
+                        throw new TimeoutException($"No UART response for text typing on {_options.PortName}.");
+                    }
+
+                    status = parsed;
+                    break;
+                }
+                catch (HidBridgeUartDeviceException ex) when (ex.DeviceErrorCode == 0x08 && ex.DeviceErrorDetail == UartTextTyping.ErrorQueueFull)
+                {
+                    // Text longer than the firmware queue: wait for it to drain a little.
+                    await Task.Delay(TimeSpan.FromMilliseconds(100), cancellationToken);
+                }
+            }
+        }
+
+        return status ?? await GetTypeTextStatusAsync(cancellationToken)
+            ?? throw new TimeoutException($"No UART response for text typing on {_options.PortName}.");
+    }
+
+    /// <summary>
+    /// Drops text firmware has not typed yet and releases the held key.
+    /// </summary>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Typing status, or <c>null</c> without a response.</returns>
+    public async Task<HidBridgeUartTypeTextStatus?> CancelTypeTextAsync(CancellationToken cancellationToken)
+    {
+        var response = await SendCommandAsync(CmdTypeText, new[] { UartTextTyping.SubCancel }, _options.CommandTimeoutMs, cancellationToken);
+        return response is not null && UartTextTyping.TryParseStatus(response.Payload, out var status) ? status : null;
+    }
+
+    /// <summary>
+    /// Reads the firmware typing status.
+    /// </summary>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Typing status, or <c>null</c> without a response.</returns>
+    public async Task<HidBridgeUartTypeTextStatus?> GetTypeTextStatusAsync(CancellationToken cancellationToken)
+    {
+        var response = await SendCommandAsync(CmdTypeText, Array.Empty<byte>(), _options.CommandTimeoutMs, cancellationToken);
+        return response is not null && UartTextTyping.TryParseStatus(response.Payload, out var status) ? status : null;
+    }
+
+    /// <summary>
+    /// Gets the newest TYPE_EVENT progress frame seen while waiting for other responses.
+    /// </summary>
+    public HidBridgeUartTypeTextStatus? LastTypeEvent => _lastTypeEvent;
+
+    /// <summary>
+    /// Presses keys on a keyboard interface and keeps them held in firmware (KEY_DOWN).
+    /// </summary>
+    /// <param name="interfaceSelector">Keyboard interface or 0xFE for the first keyboard.</param>
+    /// <param name="usages">Keyboard page usages; 0xE0..0xE7 are modifiers.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Interface state after the report was sent.</returns>
+    public Task<HidBridgeUartKeyState> KeyDownAsync(byte interfaceSelector, IReadOnlyList<byte> usages, CancellationToken cancellationToken)
+        => SendKeyAsync(UartKeyState.OpKeyDown, interfaceSelector, preferMouse: false, usages.ToArray(), cancellationToken);
+
+    /// <summary>
+    /// Releases keys held through <see cref="KeyDownAsync"/> (KEY_UP).
+    /// </summary>
+    /// <param name="interfaceSelector">Keyboard interface or 0xFE for the first keyboard.</param>
+    /// <param name="usages">Keyboard page usages; 0xE0..0xE7 are modifiers.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Interface state after the report was sent.</returns>
+    public Task<HidBridgeUartKeyState> KeyUpAsync(byte interfaceSelector, IReadOnlyList<byte> usages, CancellationToken cancellationToken)
+        => SendKeyAsync(UartKeyState.OpKeyUp, interfaceSelector, preferMouse: false, usages.ToArray(), cancellationToken);
+
+    /// <summary>
+    /// Presses mouse buttons and keeps them held in firmware across physical reports (BUTTON_DOWN).
+    /// </summary>
+    /// <param name="interfaceSelector">Mouse interface or 0xFF for the first mouse.</param>
+    /// <param name="mask">Buttons to press, bit 0 = left.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Interface state after the report was sent.</returns>
+    public Task<HidBridgeUartKeyState> ButtonDownAsync(byte interfaceSelector, byte mask, CancellationToken cancellationToken)
+        => SendKeyAsync(UartKeyState.OpButtonDown, interfaceSelector, preferMouse: true, new[] { mask }, cancellationToken);
+
+    /// <summary>
+    /// Releases mouse buttons held through <see cref="ButtonDownAsync"/> (BUTTON_UP).
+    /// </summary>
+    /// <param name="interfaceSelector">Mouse interface or 0xFF for the first mouse.</param>
+    /// <param name="mask">Buttons to release, bit 0 = left.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Interface state after the report was sent.</returns>
+    public Task<HidBridgeUartKeyState> ButtonUpAsync(byte interfaceSelector, byte mask, CancellationToken cancellationToken)
+        => SendKeyAsync(UartKeyState.OpButtonUp, interfaceSelector, preferMouse: true, new[] { mask }, cancellationToken);
+
+    /// <summary>
+    /// Releases every key and button, injected or stuck, on one interface or on all of them (RELEASE_ALL).
+    /// </summary>
+    /// <param name="interfaceSelector">Interface or logical selector, or <c>null</c> for every interface.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    public async Task ReleaseAllAsync(byte? interfaceSelector, CancellationToken cancellationToken)
+    {
+        var itf = interfaceSelector.HasValue
+            ? await ResolveInterfaceAsync(interfaceSelector.Value, preferMouse: interfaceSelector.Value != 0xFE, cancellationToken)
+            : UartKeyState.AllInterfaces;
+        var payload = UartKeyState.Pack(UartKeyState.OpReleaseAll, itf, ReadOnlySpan<byte>.Empty);
+        var response = await SendCommandAsync(CmdKey, payload, _options.InjectTimeoutMs, cancellationToken);
+        if (response is null)
+        {
+            throw new TimeoutException($"No UART response for release-all on {_options.PortName}.");
+        }
+    }
+
+    /// <summary>
+    /// Reads the injected and physical key and button state of an interface.
+    /// </summary>
+    /// <param name="interfaceSelector">Interface or logical selector.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>The state, or <c>null</c> without a response.</returns>
+    public async Task<HidBridgeUartKeyState?> GetKeyStateAsync(byte interfaceSelector, CancellationToken cancellationToken)
+    {
+        var itf = await ResolveInterfaceAsync(interfaceSelector, preferMouse: interfaceSelector != 0xFE, cancellationToken);
+        var payload = UartKeyState.Pack(UartKeyState.OpState, itf, ReadOnlySpan<byte>.Empty);
+        var response = await SendCommandAsync(CmdKey, payload, _options.CommandTimeoutMs, cancellationToken);
+        return response is not null && UartKeyState.TryParseState(response.Payload, out var state) ? state : null;
+    }
+
+    /// <summary>
+    /// Sets how firmware combines physical and injected input (MIX).
+    /// </summary>
+    /// <param name="interfaceSelector">Interface or logical selector, or <c>null</c> for every interface.</param>
+    /// <param name="policy">Policy to apply.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>State of every interface slot after the change.</returns>
+    public async Task<IReadOnlyList<HidBridgeUartMixState>> SetMixPolicyAsync(
+        byte? interfaceSelector,
+        UartMixPolicy policy,
+        CancellationToken cancellationToken)
+    {
+        var itf = interfaceSelector ?? UartInputMixer.AllInterfaces;
+        var response = await SendCommandAsync(CmdMix, UartInputMixer.Pack(itf, policy), _options.CommandTimeoutMs, cancellationToken);
+        if (response is null || !UartInputMixer.TryParse(response.Payload, out var states))
+        {
+            throw new TimeoutException($"No UART response for mix policy on {_options.PortName}.");
+        }
+
+        return states;
+    }
+
+    /// <summary>
+    /// Reads the mix policy and counters of every interface slot.
+    /// </summary>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Interface slots, or <c>null</c> without a response.</returns>
+    public async Task<IReadOnlyList<HidBridgeUartMixState>?> GetMixStateAsync(CancellationToken cancellationToken)
+    {
+        var response = await SendCommandAsync(CmdMix, Array.Empty<byte>(), _options.CommandTimeoutMs, cancellationToken);
+        return response is not null && UartInputMixer.TryParse(response.Payload, out var states) ? states : null;
+    }
+
+    /// <summary>
+    /// Takes deferred log entries out of the firmware ring (LOG_READ).
+    /// </summary>
+    /// <param name="drain">Drain mode to switch to first; <see cref="UartLogDrain.Hold"/> keeps entries for this call.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>The entries read, or <c>null</c> without a response.</returns>
+    public async Task<HidBridgeUartLogChunk?> ReadDeviceLogAsync(UartLogDrain? drain, CancellationToken cancellationToken)
+    {
+        var response = await SendCommandAsync(CmdLogRead, UartDeviceLog.Pack(drain), _options.CommandTimeoutMs, cancellationToken);
+        return response is not null && UartDeviceLog.TryParse(response.Payload, out var chunk) ? chunk : null;
+    }
+
+    /// <summary>
+    /// Reads one page of a board's metrics registry (GET_METRICS).
+    /// </summary>
+    /// <param name="board">Board to read; A_device metrics come from B_host's cached snapshot.</param>
+    /// <param name="start">Index of the first metric wanted; 0 also refreshes the A_device snapshot.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>The page, or <c>null</c> without a response.</returns>
+    public async Task<HidBridgeUartMetricsPage?> GetMetricsPageAsync(UartMetricsBoard board, byte start, CancellationToken cancellationToken)
+    {
+        var response = await SendCommandAsync(CmdGetMetrics, UartMetrics.Pack(board, start), _options.CommandTimeoutMs, cancellationToken);
+        return response is not null && UartMetrics.TryParse(response.Payload, out var page) ? page : null;
+    }
+
+    /// <summary>
+    /// Reads every metric of a board, page by page (GET_METRICS).
+    /// </summary>
+    /// <param name="board">Board to read. The A_device snapshot returned is the one cached before this call; read again for current values.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>All metrics as one page starting at 0, or <c>null</c> without a response.</returns>
+    public async Task<HidBridgeUartMetricsPage?> GetMetricsAsync(UartMetricsBoard board, CancellationToken cancellationToken)
+    {
+        var first = await GetMetricsPageAsync(board, 0, cancellationToken);
+        if (first is null)
+        {
+            return null;
+        }
+
+        var metrics = new List<HidBridgeUartMetric>(first.Metrics);
+        while (metrics.Count < first.Total)
+        {
+            var page = await GetMetricsPageAsync(board, (byte)metrics.Count, cancellationToken);
+            if (page is null || page.Metrics.Count == 0)
+            {
+                break;
+            }
+
+            metrics.AddRange(page.Metrics);
+        }
+
+        return first with { Metrics = metrics };
+    }
+
+    /// <summary>
+    /// Reads the fan-out routing state: focus, targets and interface routes (FANOUT).
+    /// </summary>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>The state, or <c>null</c> without a response.</returns>
+    public async Task<HidBridgeUartFanoutState?> GetFanoutStateAsync(CancellationToken cancellationToken)
+    {
+        var response = await SendCommandAsync(CmdFanout, Array.Empty<byte>(), _options.CommandTimeoutMs, cancellationToken);
+        return response is not null && UartFanout.TryParse(response.Payload, out var state) ? state : null;
+    }
+
+    /// <summary>
+    /// Moves the input focus to another target PC. Keys held on the old target are released there first.
+    /// </summary>
+    /// <param name="target">Target number; 0 is the hardware UART link.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>State after the change.</returns>
+    public Task<HidBridgeUartFanoutState> SetFanoutFocusAsync(byte target, CancellationToken cancellationToken)
+        => SendFanoutAsync(UartFanout.PackFocus(target), cancellationToken);
+
+    /// <summary>
+    /// Pins an interface to a target regardless of the focus.
+    /// </summary>
+    /// <param name="interfaceNumber">Interface as listed by LIST_INTERFACES.</param>
+    /// <param name="target">Target number, or <c>null</c> to follow the focus again.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>State after the change.</returns>
+    public Task<HidBridgeUartFanoutState> SetFanoutRouteAsync(byte interfaceNumber, byte? target, CancellationToken cancellationToken)
+        => SendFanoutAsync(UartFanout.PackRoute(interfaceNumber, target), cancellationToken);
+
+    /// <summary>
+    /// Sends the descriptor set to one target only, e.g. a board powered up after the bridge.
+    /// </summary>
+    /// <param name="target">Target number.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>State after the request.</returns>
+    public Task<HidBridgeUartFanoutState> ResyncFanoutTargetAsync(byte target, CancellationToken cancellationToken)
+        => SendFanoutAsync(UartFanout.PackResync(target), cancellationToken);
+
+    private async Task<HidBridgeUartFanoutState> SendFanoutAsync(byte[] payload, CancellationToken cancellationToken)
+    {
+        var response = await SendCommandAsync(CmdFanout, payload, _options.CommandTimeoutMs, cancellationToken);
+        if (response is null || !UartFanout.TryParse(response.Payload, out var state) || state is null)
+        {
+            throw new TimeoutException($"No UART response for fan-out on {_options.PortName}.");
+        }
+
+        return state;
+    }
+
+    /// <summary>
+    /// Gets the newest cumulative ACK seen while waiting for other responses.
+    /// </summary>
+    public HidBridgeUartCumulativeAck? LastCumulativeAck => _lastCumulativeAck;
+
+    /// <summary>
+    /// Configures firmware cumulative ACKs for reports sent with <see cref="SendInjectReportNoAckAsync"/>.
+    /// </summary>
+    /// <param name="intervalMs">Maximum ACK delay; 0 turns cumulative ACKs off (fire-and-forget).</param>
+    /// <param name="window">Frames per ACK (1..64).</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns><c>true</c> when firmware applied the mode.</returns>
+    public async Task<bool> SetAckModeAsync(ushort intervalMs, byte window, CancellationToken cancellationToken)
+    {
+        var payload = new byte[] { (byte)(intervalMs & 0xFF), (byte)(intervalMs >> 8), window };
+        var response = await SendCommandAsync(0x0B, payload, _options.CommandTimeoutMs, cancellationToken);
+        return response is not null;
+    }
+
+    /// <summary>
+    /// Sends one INJECT_REPORT with the NO_ACK flag and returns without waiting for firmware.
+    /// </summary>
+    /// <param name="interfaceSelector">Concrete interface or logical selector (0xFF mouse, 0xFE keyboard).</param>
+    /// <param name="report">Raw HID report bytes.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>The sequence number a later cumulative ACK refers to.</returns>
+    public async Task<byte> SendInjectReportNoAckAsync(byte interfaceSelector, byte[] report, CancellationToken cancellationToken)
+    {
+        if (report.Length is 0 or > 238)
+        {
+            throw new InvalidOperationException("HID report length must be 1..238 bytes.");
+        }
+
+        var payload = new byte[2 + report.Length];
+        payload[0] = interfaceSelector;
+        payload[1] = (byte)report.Length;
+        Buffer.BlockCopy(report, 0, payload, 2, report.Length);
+
+        var seq = unchecked((byte)Interlocked.Increment(ref _seq));
+        var requestKey = SelectRequestHmacKey(0x01, forceBootstrapKey: false);
+        await _ioLock.WaitAsync(cancellationToken);
+        try
+        {
+            var slip = Slip.Encode(BuildRequestFrame(seq, 0x01, FlagNoAck, payload, requestKey, forceBootstrapKey: false));
+            await _port.BaseStream.WriteAsync(slip.AsMemory(0, slip.Length), cancellationToken);
+            await _port.BaseStream.FlushAsync(cancellationToken);
+        }
+        finally
+        {
+            _ioLock.Release();
+        }
+
+        return seq;
+    }
+
+    /// <summary>
+    /// Waits for the next cumulative ACK frame.
+    /// </summary>
+    /// <param name="timeoutMs">Maximum wait in milliseconds.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>The ACK, or <c>null</c> when none arrived in time.</returns>
+    public async Task<HidBridgeUartCumulativeAck?> ReadCumulativeAckAsync(int timeoutMs, CancellationToken cancellationToken)
+    {
+        var requestKey = SelectRequestHmacKey(0x01, forceBootstrapKey: false);
+        await _ioLock.WaitAsync(cancellationToken);
+        try
+        {
+            var start = Environment.TickCount64;
+            while ((Environment.TickCount64 - start) < timeoutMs)
+            {
+                cancellationToken.ThrowIfCancellationRequested();
+                var frame = TryReadSlipFrame();
+                if (frame is null) continue;
+                if (!TryParseFrame(frame, requestKey, SelectAlternateResponseHmacKey(requestKey), out var response, out _)) continue;
+                if ((response.Flags & FlagResponse) == 0) continue;
+                if (response.Cmd != CmdCumulativeAck)
+                {
+                    RecordUnsolicited(response, CmdCumulativeAck);
+                    continue;
+                }
+
+                RecordCumulativeAck(response);
+                return _lastCumulativeAck;
+            }
+
+            return null;
+        }
+        finally
+        {
+            _ioLock.Release();
+        }
+    }
+
+    /// <summary>
+    /// Gets the newest complete telemetry snapshot seen while waiting for other responses.
+    /// Paged snapshots are merged; a snapshot with a lost page keeps the pages that arrived.
+    /// </summary>
+    public UartTelemetryFrame? LastTelemetry => _lastTelemetry;
+
+    /// <summary>
+    /// Subscribes to firmware telemetry frames pushed every <paramref name="intervalMs"/> milliseconds.
+    /// </summary>
+    /// <param name="intervalMs">Push interval; 0 cancels the subscription.</param>
+    /// <param name="sections">Sections to include in every frame.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>The interval applied by firmware (short intervals are clamped), or <c>null</c> without a response.</returns>
+    public async Task<ushort?> SubscribeTelemetryAsync(ushort intervalMs, UartTelemetrySections sections, CancellationToken cancellationToken)
+    {
+        var payload = new byte[] { (byte)(intervalMs & 0xFF), (byte)(intervalMs >> 8), (byte)sections };
+        var response = await SendCommandAsync(CmdSubscribe, payload, _options.CommandTimeoutMs, cancellationToken);
+        if (response is null || response.Payload.Length < 2)
+        {
+            return null;
+        }
+
+        return BinaryPrimitives.ReadUInt16LittleEndian(response.Payload);
+    }
+
+    /// <summary>
+    /// Cancels the telemetry subscription.
+    /// </summary>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns><c>true</c> when firmware confirmed the cancellation.</returns>
+    public async Task<bool> UnsubscribeTelemetryAsync(CancellationToken cancellationToken)
+        => await SubscribeTelemetryAsync(0, UartTelemetrySections.All, cancellationToken) is not null;
+
+    /// <summary>
+    /// Waits for the next telemetry frame.
+    /// </summary>
+    /// <param name="timeoutMs">Maximum wait in milliseconds.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>The frame, or <c>null</c> when none arrived in time.</returns>
+    public async Task<UartTelemetryFrame?> ReadTelemetryAsync(int timeoutMs, CancellationToken cancellationToken)
+    {
+        var requestKey = SelectRequestHmacKey(CmdSubscribe, forceBootstrapKey: false);
+        await _ioLock.WaitAsync(cancellationToken);
+        try
+        {
+            var start = Environment.TickCount64;
+            while ((Environment.TickCount64 - start) < timeoutMs)
+            {
+                cancellationToken.ThrowIfCancellationRequested();
+                var frame = TryReadSlipFrame();
+                if (frame is null) continue;
+                if (!TryParseFrame(frame, requestKey, SelectAlternateResponseHmacKey(requestKey), out var response, out _)) continue;
+                if ((response.Flags & FlagResponse) == 0) continue;
+                if (RecordUnsolicited(response, CmdSubscribe) && response.Cmd == CmdSubscribe && _pendingTelemetry is null)
+                {
+                    return _lastTelemetry;
+                }
+            }
+
+            return null;
+        }
+        finally
+        {
+            _ioLock.Release();
+        }
+    }
+
+    /// <summary>
+    /// Enables, reconfigures or disables the physical input tap. Any change clears the firmware ring and counters.
+    /// </summary>
+    /// <param name="mode">Drop policy, or <see cref="UartInputTapMode.Off"/>.</param>
+    /// <param name="flushMs">Maximum age of a waiting report before a partly filled frame is sent.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Tap counters after the change, or <c>null</c> without a response.</returns>
+    public async Task<UartInputTapStats?> ConfigureInputTapAsync(UartInputTapMode mode, ushort flushMs, CancellationToken cancellationToken)
+    {
+        _tapFrames.Clear();
+        var payload = new byte[] { (byte)mode, (byte)(flushMs & 0xFF), (byte)(flushMs >> 8) };
+        var response = await SendCommandAsync(CmdTap, payload, _options.CommandTimeoutMs, cancellationToken);
+        return response is not null && UartInputTapDecoder.TryParseStats(response.Payload, out var stats) ? stats : null;
+    }
+
+    /// <summary>
+    /// Reads the input tap counters, including the ring high-water mark, without changing the mode.
+    /// </summary>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Tap counters, or <c>null</c> without a response.</returns>
+    public async Task<UartInputTapStats?> GetInputTapStatsAsync(CancellationToken cancellationToken)
+    {
+        var response = await SendCommandAsync(CmdTap, Array.Empty<byte>(), _options.CommandTimeoutMs, cancellationToken);
+        return response is not null && UartInputTapDecoder.TryParseStats(response.Payload, out var stats) ? stats : null;
+    }
+
+    /// <summary>
+    /// Returns the next TAP_DATA frame, including frames that arrived while waiting for other responses.
+    /// </summary>
+    /// <param name="timeoutMs">Maximum wait in milliseconds.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>The frame, or <c>null</c> when none arrived in time.</returns>
+    public async Task<UartInputTapFrame?> ReadInputTapAsync(int timeoutMs, CancellationToken cancellationToken)
+    {
+        if (_tapFrames.TryDequeue(out var queued))
+        {
+            return queued;
+        }
+
+        var requestKey = SelectRequestHmacKey(CmdTap, forceBootstrapKey: false);
+        await _ioLock.WaitAsync(cancellationToken);
+        try
+        {
+            var start = Environment.TickCount64;
+            while ((Environment.TickCount64 - start) < timeoutMs)
+            {
+                cancellationToken.ThrowIfCancellationRequested();
+                var frame = TryReadSlipFrame();
+                if (frame is null) continue;
+                if (!TryParseFrame(frame, requestKey, SelectAlternateResponseHmacKey(requestKey), out var response, out _)) continue;
+                if ((response.Flags & FlagResponse) == 0) continue;
+                if (RecordUnsolicited(response, CmdTapData) && _tapFrames.TryDequeue(out var tap))
+                {
+                    return tap;
+                }
+            }
+
+            return null;
+        }
+        finally
+        {
+            _ioLock.Release();
+        }
+    }
+
+    /// <summary>
+    /// Replaces the firmware replay buffer with <paramref name="entries"/>.
+    /// </summary>
+    /// <param name="entries">Entries with concrete interface numbers and non-decreasing times.</param>
+    /// <param name="durationUs">Loop period; 0 uses the last entry time.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Replay status after the upload.</returns>
+    public async Task<UartReplayStatus> UploadReplayAsync(IReadOnlyList<UartReplayEntry> entries, uint durationUs, CancellationToken cancellationToken)
+    {
+        var image = UartReplay.Pack(entries);
+        var args = new byte[4];
+        BinaryPrimitives.WriteUInt32LittleEndian(args, durationUs);
+        var status = await SendReplayAsync(0x01, args, _options.CommandTimeoutMs, cancellationToken);
+        for (var offset = 0; offset < image.Length; offset += ReplayChunkLen)
+        {
+            var len = Math.Min(ReplayChunkLen, image.Length - offset);
+            var chunk = new byte[2 + len];
+            BinaryPrimitives.WriteUInt16LittleEndian(chunk, (ushort)offset);
+            image.AsSpan(offset, len).CopyTo(chunk.AsSpan(2));
+            // APPEND at an explicit offset is idempotent, so a lost response is simply retried once.
+            status = await TrySendReplayAsync(0x02, chunk, _options.CommandTimeoutMs, cancellationToken)
+                ?? await SendReplayAsync(0x02, chunk, _options.CommandTimeoutMs, cancellationToken);
+        }
+
+        return status;
+    }
+
+    /// <summary>
+    /// Downloads the firmware replay buffer, e.g. after recording.
+    /// </summary>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>The decoded entries.</returns>
+    public async Task<IReadOnlyList<UartReplayEntry>> DownloadReplayAsync(CancellationToken cancellationToken)
+    {
+        var image = new List<byte>();
+        var total = int.MaxValue;
+        while (image.Count < total)
+        {
+            var request = new byte[] { 0x03, (byte)(image.Count & 0xFF), (byte)(image.Count >> 8) };
+            var response = await SendCommandAsync(CmdReplay, request, _options.CommandTimeoutMs, cancellationToken);
+            if (response is null || response.Payload.Length < 4)
+            {
+                throw new TimeoutException($"No UART response for replay read on {_options.PortName} at offset {image.Count}.");
+            }
+
+            total = BinaryPrimitives.ReadUInt16LittleEndian(response.Payload.AsSpan(2));
+            if (response.Payload.Length == 4) break;
+            image.AddRange(response.Payload.AsSpan(4).ToArray());
+        }
+
+        if (!UartReplay.TryUnpack(image.ToArray(), out var entries))
+        {
+            throw new InvalidDataException("Replay buffer downloaded from firmware ends in a partial entry.");
+        }
+
+        return entries;
+    }
+
+    /// <summary>
+    /// Clears the replay buffer and records reports from <paramref name="sources"/> until stopped.
+    /// </summary>
+    /// <param name="sources">Reports to record.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Replay status.</returns>
+    public Task<UartReplayStatus> StartReplayRecordingAsync(UartReplaySources sources, CancellationToken cancellationToken)
+        => SendReplayAsync(0x04, new[] { (byte)sources }, _options.CommandTimeoutMs, cancellationToken);
+
+    /// <summary>
+    /// Stops recording; the recorded time becomes the loop period.
+    /// </summary>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Replay status.</returns>
+    public Task<UartReplayStatus> StopReplayRecordingAsync(CancellationToken cancellationToken)
+        => SendReplayAsync(0x05, Array.Empty<byte>(), _options.CommandTimeoutMs, cancellationToken);
+
+    /// <summary>
+    /// Starts hardware-timed playback of the replay buffer.
+    /// </summary>
+    /// <param name="loops">Number of loops; 0 repeats until <see cref="StopReplayAsync"/>.</param>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Replay status.</returns>
+    public Task<UartReplayStatus> PlayReplayAsync(ushort loops, CancellationToken cancellationToken)
+        => SendReplayAsync(0x06, new[] { (byte)(loops & 0xFF), (byte)(loops >> 8) }, _options.CommandTimeoutMs, cancellationToken);
+
+    /// <summary>
+    /// Stops recording or playback.
+    /// </summary>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Replay status.</returns>
+    public Task<UartReplayStatus> StopReplayAsync(CancellationToken cancellationToken)
+        => SendReplayAsync(0x07, Array.Empty<byte>(), _options.CommandTimeoutMs, cancellationToken);
+
+    /// <summary>
+    /// Reads the replay state and playback timing counters.
+    /// </summary>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Replay status.</returns>
+    public Task<UartReplayStatus> GetReplayStatusAsync(CancellationToken cancellationToken)
+        => SendReplayAsync(0x08, Array.Empty<byte>(), _options.CommandTimeoutMs, cancellationToken);
+
+    /// <summary>
+    /// Stores the replay buffer in firmware flash. Firmware blocks interrupts for each sector erase, so it refuses
+    /// (reason 5) while a HID device is mounted or further frames are already queued; send nothing else until it answers.
+    /// </summary>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Replay status.</returns>
+    public Task<UartReplayStatus> SaveReplayAsync(CancellationToken cancellationToken)
+        => SendReplayAsync(0x09, Array.Empty<byte>(), Math.Max(_options.CommandTimeoutMs, ReplaySaveTimeoutMs), cancellationToken);
+
+    /// <summary>
+    /// Restores the replay buffer saved with <see cref="SaveReplayAsync"/>.
+    /// </summary>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>Replay status.</returns>
+    public Task<UartReplayStatus> LoadReplayAsync(CancellationToken cancellationToken)
+        => SendReplayAsync(0x0A, Array.Empty<byte>(), _options.CommandTimeoutMs, cancellationToken);
+
+    /// <summary>
+    /// Downloads the last enumeration timeline recorded by both bridge boards.
+    /// </summary>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>The merged timeline, or <c>null</c> when the bridge does not answer GET_TRACE.</returns>
+    public async Task<EnumTraceTimeline?> GetEnumerationTraceAsync(CancellationToken cancellationToken)
+    {
+        var first = await RequestTracePageAsync(0, refresh: true, cancellationToken);
+        for (var attempt = 0; first is not null && first.Pending && attempt < 20; attempt++)
+        {
+            // B_host pulls the A_device ring over the link asynchronously; poll page 0 until it lands.
+            await Task.Delay(25, cancellationToken);
+            first = await RequestTracePageAsync(0, refresh: false, cancellationToken);
+        }
+
+        if (first is null) return null;
+
+        var events = new List<EnumTraceEvent>(first.Total);
+        events.AddRange(first.Events);
+        for (var page = 1; events.Count < first.Total && page < 256; page++)
+        {
+            var next = await RequestTracePageAsync((byte)page, refresh: false, cancellationToken);
+            if (next is null || next.Events.Count == 0) break;
+            events.AddRange(next.Events);
+        }
+
+        return new EnumTraceTimeline(first.OffsetUs, first.HasRemote, events);
+    }
+
+    /// <summary>
+    /// Reads the control UART receive-path counters (ring overflows, FIFO overruns, rejected frames).
+    /// </summary>
+    /// <param name="cancellationToken">Cancels the operation.</param>
+    /// <returns>The counters, or <c>null</c> when the bridge does not answer GET_CTRL_STATS.</returns>
+    public async Task<HidBridgeUartControlStats?> GetControlStatsAsync(CancellationToken cancellationToken)
+    {
+        var response = await SendCommandAsync(0x08, Array.Empty<byte>(), _options.CommandTimeoutMs, cancellationToken);
+        var payload = response?.Payload;
+        if (payload is null || payload.Length < 32) return null;
+
+        var hasSessionCounters = payload.Length >= 40;
+        var hasTxCounters = payload.Length >= 52;
+        return new HidBridgeUartControlStats(
+            BinaryPrimitives.ReadUInt16LittleEndian(payload.AsSpan(0)),
+            BinaryPrimitives.ReadUInt16LittleEndian(payload.AsSpan(2)),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload.AsSpan(4)),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload.AsSpan(8)),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload.AsSpan(12)),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload.AsSpan(16)),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload.AsSpan(20)),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload.AsSpan(24)),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload.AsSpan(28)),
+            hasSessionCounters ? BinaryPrimitives.ReadUInt32LittleEndian(payload.AsSpan(32)) : 0,
+            hasSessionCounters ? BinaryPrimitives.ReadUInt32LittleEndian(payload.AsSpan(36)) : 0,
+            hasTxCounters ? BinaryPrimitives.ReadUInt32LittleEndian(payload.AsSpan(40)) : 0,
+            hasTxCounters ? BinaryPrimitives.ReadUInt32LittleEndian(payload.AsSpan(44)) : 0,
+            hasTxCounters ? BinaryPrimitives.ReadUInt32LittleEndian(payload.AsSpan(48)) : 0);
+    }
+
     /// <summary>
     /// Closes the serial port and releases transport resources.
     /// </summary>
@@ -382,10 +1299,26 @@ public sealed class HidBridgeUartClient : IAsyncDisposable
         return hmac.ComputeHash(deviceId);
     }
 
+    private async Task<EnumTracePage?> RequestTracePageAsync(byte page, bool refresh, CancellationToken cancellationToken)
+    {
+        var response = await SendCommandAsync(0x07, new byte[] { page, refresh ? (byte)0x01 : (byte)0x00 }, _options.CommandTimeoutMs, cancellationToken);
+        var payload = response?.Payload;
+        if (payload is null || !EnumTraceDecoder.TryParsePage(payload, out var parsed)) return null;
+        return parsed;
+    }
+
     private async Task<HidInterfaceList?> RequestInterfaceListAsync(CancellationToken cancellationToken)
     {
         var response = await SendCommandAsync(0x02, Array.Empty<byte>(), _options.CommandTimeoutMs, cancellationToken);
-        var payload = response is null ? null : response.Payload;
+        return ParseInterfaceList(response?.Payload);
+    }
+
+    /// <summary>
+    /// Decodes a LIST_INTERFACES response: a count, 7-byte entries and, from firmware
+    /// with hub aggregation, one physical interface number per entry after them.
+    /// </summary>
+    internal static HidInterfaceList? ParseInterfaceList(byte[]? payload)
+    {
         if (payload is null || payload.Length < 1) return null;
 
         var count = payload[0];
@@ -405,6 +1338,14 @@ public sealed class HidBridgeUartClient : IAsyncDisposable
             offset += 7;
         }
 
+        if (items.Count == count && offset + count <= payload.Length)
+        {
+            for (var i = 0; i < count; i++)
+            {
+                items[i] = items[i] with { PhysicalItf = payload[offset + i] };
+            }
+        }
+
         return new HidInterfaceList(DateTimeOffset.UtcNow, items);
     }
 
@@ -513,12 +1454,11 @@ public sealed class HidBridgeUartClient : IAsyncDisposable
                 var seq = unchecked((byte)Interlocked.Increment(ref _seq));
                 var requestKey = SelectRequestHmacKey(cmd, forceBootstrapKey);
                 var alternateResponseKey = SelectAlternateResponseHmacKey(requestKey);
-                var frame = UartFrameCodec.BuildFrame(seq, cmd, flags: 0, payload, requestKey);
-                var slip = Slip.Encode(frame);
 
                 await _ioLock.WaitAsync(cancellationToken);
                 try
                 {
+                    var slip = Slip.Encode(BuildRequestFrame(seq, cmd, flags: 0, payload, requestKey, forceBootstrapKey));
                     await _port.BaseStream.WriteAsync(slip.AsMemory(0, slip.Length), cancellationToken);
                     await _port.BaseStream.FlushAsync(cancellationToken);
                     var attemptResponse = ReadMatchingResponse(seq, cmd, timeoutMs, cancellationToken, requestKey, alternateResponseKey);
@@ -543,6 +1483,13 @@ public sealed class HidBridgeUartClient : IAsyncDisposable
             return response;
         }
 
+        if (!forceBootstrapKey && _sessionKey is not null)
+        {
+            // B_host drops the session on reset and never answers its fast frames: continue with v2.
+            _sessionKey = null;
+            return await SendCommandAsync(cmd, payload, timeoutMs, cancellationToken, 0, forceBootstrapKey, allowBootstrapFallback);
+        }
+
         if (!forceBootstrapKey
             && allowBootstrapFallback
             && _derivedHmacKey is not null
@@ -569,6 +1516,122 @@ public sealed class HidBridgeUartClient : IAsyncDisposable
         return null;
     }
 
+    // Session counters must reach the wire in order, so call this under _ioLock.
+    private byte[] BuildRequestFrame(byte seq, byte cmd, byte flags, byte[] payload, byte[] requestKey, bool forceBootstrapKey)
+    {
+        var sessionKey = forceBootstrapKey ? null : _sessionKey;
+        return sessionKey is not null
+            ? UartFrameCodec.BuildFastFrame(seq, cmd, flags, ++_sessionTxCounter, payload, sessionKey)
+            : UartFrameCodec.BuildFrame(seq, cmd, flags, payload, requestKey);
+    }
+
+    private void RecordCumulativeAck(UartResponse response)
+    {
+        if (HidBridgeUartCumulativeAck.TryParse(response.Payload, out var ack))
+        {
+            _lastCumulativeAck = ack;
+        }
+    }
+
+    private async Task<UartReplayStatus> SendReplayAsync(byte subcommand, byte[] args, int timeoutMs, CancellationToken cancellationToken)
+    {
+        return await TrySendReplayAsync(subcommand, args, timeoutMs, cancellationToken)
+            ?? throw new TimeoutException($"No UART response for replay subcommand 0x{subcommand:X2} on {_options.PortName} (timeoutMs={timeoutMs}).");
+    }
+
+    private async Task<HidBridgeUartKeyState> SendKeyAsync(byte op, byte selector, bool preferMouse, byte[] args, CancellationToken cancellationToken)
+    {
+        var itf = await ResolveInterfaceAsync(selector, preferMouse, cancellationToken);
+        var payload = UartKeyState.Pack(op, itf, args);
+        var response = await SendCommandAsync(CmdKey, payload, _options.InjectTimeoutMs, cancellationToken);
+        if (response is null || !UartKeyState.TryParseState(response.Payload, out var state))
+        {
+            throw new TimeoutException(
+                $"No UART response for key state on {_options.PortName} " +
+                $"(baud={_options.BaudRate}, timeoutMs={_options.InjectTimeoutMs}).");
+        }
+
+        return state;
+    }
+
+    private async Task<UartReplayStatus?> TrySendReplayAsync(byte subcommand, byte[] args, int timeoutMs, CancellationToken cancellationToken)
+    {
+        var payload = new byte[1 + args.Length];
+        payload[0] = subcommand;
+        args.CopyTo(payload, 1);
+        var response = await SendCommandAsync(CmdReplay, payload, timeoutMs, cancellationToken);
+        return response is not null && UartReplay.TryParseStatus(response.Payload, out var status) ? status : null;
+    }
+
+    // Records frames firmware pushes on its own; `awaitedCmd` is left to the caller.
+    private bool RecordUnsolicited(UartResponse response, byte awaitedCmd)
+    {
+        switch (response.Cmd)
+        {
+            case CmdCumulativeAck when awaitedCmd != CmdCumulativeAck:
+                RecordCumulativeAck(response);
+                return true;
+            case CmdSubscribe:
+                return RecordTelemetry(response);
+            case CmdTypeEvent:
+                if (!UartTextTyping.TryParseStatus(response.Payload, out var typing))
+                {
+                    return false;
+                }
+
+                _lastTypeEvent = typing;
+                return true;
+            case CmdTapData:
+                if (!UartInputTapDecoder.TryParseFrame(response.Payload, out var tap))
+                {
+                    return false;
+                }
+
+                _tapFrames.Enqueue(tap);
+                while (_tapFrames.Count > MaxQueuedTapFrames)
+                {
+                    _tapFrames.TryDequeue(out _);
+                }
+
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // SUBSCRIBE responses carry 3 bytes; telemetry frames are at least a header long.
+    private bool RecordTelemetry(UartResponse response)
+    {
+        if (response.Payload.Length < UartTelemetryDecoder.HeaderLen ||
+            !UartTelemetryDecoder.TryParse(response.Payload, out var telemetry))
+        {
+            return false;
+        }
+
+        if (_pendingTelemetry is not null)
+        {
+            if (UartTelemetryDecoder.TryAppendPage(_pendingTelemetry, telemetry, out var merged))
+            {
+                telemetry = merged;
+            }
+            else
+            {
+                // A page went missing: publish what arrived of the previous snapshot.
+                _lastTelemetry = _pendingTelemetry;
+            }
+        }
+
+        if (telemetry.More)
+        {
+            _pendingTelemetry = telemetry;
+            return true;
+        }
+
+        _pendingTelemetry = null;
+        _lastTelemetry = telemetry;
+        return true;
+    }
+
     private UartResponse? ReadMatchingResponse(
         byte seq,
         byte cmd,
@@ -590,13 +1653,19 @@ public sealed class HidBridgeUartClient : IAsyncDisposable
 
             var isResponse = (response.Flags & FlagResponse) != 0 || (response.Flags & FlagResponseLegacy) != 0;
             if (!isResponse) continue;
+            if (RecordUnsolicited(response, cmd))
+            {
+                continue;
+            }
+
             if (response.Seq != seq || response.Cmd != cmd) continue;
 
             var isError = (response.Flags & FlagError) != 0 || (response.Flags & FlagErrorLegacy) != 0;
             if (isError)
             {
                 var errorCode = response.Payload.Length > 0 ? response.Payload[0] : (byte?)null;
-                throw new HidBridgeUartDeviceException(errorCode);
+                var errorDetail = response.Payload.Length > 1 ? response.Payload[1] : (byte?)null;
+                throw new HidBridgeUartDeviceException(errorCode, errorDetail);
             }
 
             response.UsedAlternateHmacKey = usedAlternateHmacKey;
@@ -678,6 +1747,21 @@ public sealed class HidBridgeUartClient : IAsyncDisposable
     {
         response = null!;
         usedAlternateHmacKey = false;
+        if (frame.Length > 1 && frame[1] == UartFrameCodec.FastVersion)
+        {
+            var sessionKey = _sessionKey;
+            if (sessionKey is null
+                || !UartFrameCodec.TryParseFastFrame(frame, sessionKey, out var fastFrame, out var counter)
+                || counter <= _sessionRxCounter)
+            {
+                return false;
+            }
+
+            _sessionRxCounter = counter;
+            response = new UartResponse(fastFrame.Seq, fastFrame.Cmd, fastFrame.Flags, fastFrame.Payload);
+            return true;
+        }
+
         if (!UartFrameCodec.TryParseFrame(frame, expectedHmacKey, alternateHmacKey, out var parsedFrame))
         {
             return false;
@@ -765,10 +1849,12 @@ public sealed class HidBridgeUartDeviceException : Exception
     /// Creates a new device exception from a raw firmware status byte.
     /// </summary>
     /// <param name="deviceErrorCode">The raw device status byte, when available.</param>
-    public HidBridgeUartDeviceException(byte? deviceErrorCode)
+    /// <param name="deviceErrorDetail">The second error byte some commands add, when available.</param>
+    public HidBridgeUartDeviceException(byte? deviceErrorCode, byte? deviceErrorDetail = null)
         : base(deviceErrorCode.HasValue ? $"UART device returned error 0x{deviceErrorCode.Value:X2}" : "UART device returned error")
     {
         DeviceErrorCode = deviceErrorCode;
+        DeviceErrorDetail = deviceErrorDetail;
     }
 
     /// <summary>
@@ -776,6 +1862,11 @@ public sealed class HidBridgeUartDeviceException : Exception
     /// </summary>
     public byte? DeviceErrorCode { get; }
 
+    /// <summary>
+    /// Gets the command-specific second error byte, e.g. the REPLAY refusal reason.
+    /// </summary>
+    public byte? DeviceErrorDetail { get; }
+
     /// <summary>
     /// Converts the device exception into a contract-level error payload.
     /// </summary>
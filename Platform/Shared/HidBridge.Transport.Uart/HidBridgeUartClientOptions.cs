@@ -1,3 +1,5 @@
+using System.Buffers.Binary;
+
 namespace HidBridge.Transport.Uart;
 
 /// <summary>
@@ -27,3 +29,160 @@ public sealed record HidBridgeUartHealth(
     int InterfaceCount,
     bool IsConnected,
     DateTimeOffset SampledAt);
+
+/// <summary>
+/// Captures the firmware receive-path counters of the control UART (GET_CTRL_STATS).
+/// Counters missing from older firmware read as zero.
+/// </summary>
+public sealed record HidBridgeUartControlStats(
+    int RingSize,
+    int RingHighWater,
+    uint RxBytes,
+    uint RxFrames,
+    uint RingOverflowBytes,
+    uint HardwareOverruns,
+    uint FramesTooLong,
+    uint BadFrames,
+    uint AuthFailures,
+    uint ReplayRejects = 0,
+    uint SessionsStarted = 0,
+    uint TxDroppedFrames = 0,
+    uint CumulativeAcks = 0,
+    uint NoAckFailures = 0);
+
+/// <summary>
+/// Describes one report of an INJECT_BATCH command.
+/// </summary>
+/// <param name="InterfaceSelector">Concrete interface or logical selector (0xFF mouse, 0xFE keyboard).</param>
+/// <param name="DelayUs">Spacing after the previous report in microseconds.</param>
+/// <param name="Report">Raw HID report bytes.</param>
+public sealed record HidBridgeUartBatchReport(byte InterfaceSelector, ushort DelayUs, byte[] Report);
+
+/// <summary>
+/// Captures the aggregated firmware answer to one or more INJECT_BATCH commands.
+/// </summary>
+/// <param name="Accepted">Reports accepted by firmware.</param>
+/// <param name="Pending">Reports still waiting in the firmware queue after the last command.</param>
+/// <param name="Dropped">Scheduled reports (SCHEDULE and INJECT_BATCH) firmware could not send when due, since boot or the last SCHEDULE STATS reset.</param>
+public sealed record HidBridgeUartBatchResult(int Accepted, int Pending, uint Dropped);
+
+/// <summary>
+/// Describes one report of a SCHEDULE ADD command.
+/// </summary>
+/// <param name="InterfaceSelector">Concrete interface or logical selector (0xFF mouse, 0xFE keyboard).</param>
+/// <param name="DueUs">Deadline: B_host clock value when absolute, otherwise microseconds after firmware receives the command.</param>
+/// <param name="Report">Raw HID report bytes (1..64).</param>
+public sealed record HidBridgeUartScheduledReport(byte InterfaceSelector, uint DueUs, byte[] Report);
+
+/// <summary>
+/// Captures the firmware answer to the last SCHEDULE ADD command.
+/// </summary>
+/// <param name="Accepted">Reports accepted across all commands.</param>
+/// <param name="Pending">Reports waiting for their deadline.</param>
+/// <param name="NowUs">B_host clock when firmware handled the last command.</param>
+public sealed record HidBridgeUartScheduleResult(int Accepted, int Pending, uint NowUs);
+
+/// <summary>
+/// Captures SCHEDULE queue counters and deadline accuracy.
+/// </summary>
+/// <param name="Pending">Reports waiting for their deadline.</param>
+/// <param name="Depth">Queue capacity.</param>
+/// <param name="HighWater">Most reports waiting at once.</param>
+/// <param name="NowUs">B_host clock when the counters were read.</param>
+/// <param name="Accepted">Reports accepted.</param>
+/// <param name="Sent">Reports written to the link.</param>
+/// <param name="Failed">Reports whose interface was gone or not ready at the deadline.</param>
+/// <param name="Cancelled">Reports removed by CANCEL.</param>
+/// <param name="Rejected">Reports refused because the queue was full or the deadline out of range.</param>
+/// <param name="BusyRetries">Deadlines that waited for a main-loop frame on the link.</param>
+/// <param name="LateMaxUs">Worst deadline error.</param>
+/// <param name="LateMeanUs">Mean deadline error.</param>
+/// <param name="Overruns">Reports sent later than the firmware lateness limit.</param>
+public sealed record HidBridgeUartScheduleStats(
+    int Pending,
+    int Depth,
+    int HighWater,
+    uint NowUs,
+    uint Accepted,
+    uint Sent,
+    uint Failed,
+    uint Cancelled,
+    uint Rejected,
+    uint BusyRetries,
+    uint LateMaxUs,
+    uint LateMeanUs,
+    uint Overruns);
+
+/// <summary>
+/// Describes one MOVE command for the firmware pointer motion engine.
+/// </summary>
+/// <param name="InterfaceSelector">Concrete interface or logical selector (0xFF mouse).</param>
+/// <param name="X">Horizontal motion in units of <paramref name="ScaleQ8"/>.</param>
+/// <param name="Y">Vertical motion in units of <paramref name="ScaleQ8"/>.</param>
+/// <param name="Absolute">Whether firmware homes the cursor to the top-left corner before moving (MOVE_TO).</param>
+/// <param name="Buttons">Button bits held during the motion.</param>
+/// <param name="Wheel">Wheel delta sent with the first report.</param>
+/// <param name="MaxStep">Counts per report and axis; 0 uses the axis limit.</param>
+/// <param name="ScaleQ8">Counts per unit in 8.8 fixed point; 0 means 1.0.</param>
+/// <param name="IntervalUs">Report spacing; 0 uses the endpoint poll interval.</param>
+public sealed record HidBridgeUartPointerMove(
+    byte InterfaceSelector,
+    short X,
+    short Y,
+    bool Absolute = false,
+    byte Buttons = 0,
+    sbyte Wheel = 0,
+    byte MaxStep = 0,
+    ushort ScaleQ8 = 0,
+    ushort IntervalUs = 0);
+
+/// <summary>
+/// Represents the MOVE status response.
+/// </summary>
+/// <param name="Active">Whether a motion is in progress.</param>
+/// <param name="Remaining">Reports still to send.</param>
+/// <param name="IntervalUs">Report spacing of the current or last motion.</param>
+/// <param name="Sent">Reports written to the link by the current or last motion.</param>
+/// <param name="Failed">Reports the link refused.</param>
+public sealed record HidBridgeUartMoveStatus(bool Active, int Remaining, int IntervalUs, uint Sent, uint Failed);
+
+/// <summary>
+/// Captures one firmware CUMULATIVE_ACK (0x0C) for NO_ACK inject frames.
+/// </summary>
+/// <param name="LastSeq">Newest acknowledged sequence number; all NO_ACK frames up to it are covered.</param>
+/// <param name="Count">NO_ACK frames covered by this ACK.</param>
+/// <param name="FailureBits">Bit <c>i</c> set when the frame with sequence <c>LastSeq - i</c> failed.</param>
+public sealed record HidBridgeUartCumulativeAck(byte LastSeq, int Count, ulong FailureBits)
+{
+    /// <summary>
+    /// Gets whether the frame with <paramref name="seq"/> is reported as failed or lost on the wire.
+    /// </summary>
+    /// <param name="seq">Sequence number returned by the NO_ACK send.</param>
+    /// <returns><c>true</c> when the frame is inside the 64-frame window and failed or never arrived.</returns>
+    public bool IsFailed(byte seq)
+    {
+        var distance = unchecked((byte)(LastSeq - seq));
+        return distance < 64 && ((FailureBits >> distance) & 1UL) != 0;
+    }
+
+    /// <summary>
+    /// Parses a CUMULATIVE_ACK payload.
+    /// </summary>
+    /// <param name="payload">Raw response payload.</param>
+    /// <param name="ack">Decoded ACK when parsing succeeds.</param>
+    /// <returns><c>true</c> when the payload is well-formed.</returns>
+    public static bool TryParse(ReadOnlySpan<byte> payload, out HidBridgeUartCumulativeAck ack)
+    {
+        ack = null!;
+        if (payload.Length < 10)
+        {
+            return false;
+        }
+
+        ack = new HidBridgeUartCumulativeAck(
+            payload[0],
+            payload[1],
+            BinaryPrimitives.ReadUInt64LittleEndian(payload[2..]));
+        return true;
+    }
+}
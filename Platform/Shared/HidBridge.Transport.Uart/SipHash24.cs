@@ -0,0 +1,70 @@
+using System.Buffers.Binary;
+using System.Numerics;
+
+namespace HidBridge.Transport.Uart;
+
+/// <summary>
+/// SipHash-2-4 with a 128-bit key, matching firmware <c>common/siphash.c</c>.
+/// </summary>
+internal static class SipHash24
+{
+    internal const int KeyLen = 16;
+
+    /// <summary>
+    /// Computes the 64-bit SipHash-2-4 tag of <paramref name="data"/>.
+    /// </summary>
+    /// <param name="key">16-byte key.</param>
+    /// <param name="data">Message bytes.</param>
+    /// <returns>The tag; serialized little-endian on the wire.</returns>
+    internal static ulong Compute(ReadOnlySpan<byte> key, ReadOnlySpan<byte> data)
+    {
+        if (key.Length != KeyLen)
+        {
+            throw new ArgumentException("SipHash key must be 16 bytes.", nameof(key));
+        }
+
+        var k0 = BinaryPrimitives.ReadUInt64LittleEndian(key);
+        var k1 = BinaryPrimitives.ReadUInt64LittleEndian(key[8..]);
+        var v0 = 0x736f6d6570736575UL ^ k0;
+        var v1 = 0x646f72616e646f6dUL ^ k1;
+        var v2 = 0x6c7967656e657261UL ^ k0;
+        var v3 = 0x7465646279746573UL ^ k1;
+
+        var full = data.Length & ~7;
+        for (var i = 0; i < full; i += 8)
+        {
+            var m = BinaryPrimitives.ReadUInt64LittleEndian(data[i..]);
+            v3 ^= m;
+            Round(ref v0, ref v1, ref v2, ref v3);
+            Round(ref v0, ref v1, ref v2, ref v3);
+            v0 ^= m;
+        }
+
+        var last = (ulong)data.Length << 56;
+        for (var i = 0; i < (data.Length & 7); i++)
+        {
+            last |= (ulong)data[full + i] << (8 * i);
+        }
+
+        v3 ^= last;
+        Round(ref v0, ref v1, ref v2, ref v3);
+        Round(ref v0, ref v1, ref v2, ref v3);
+        v0 ^= last;
+
+        v2 ^= 0xFF;
+        for (var i = 0; i < 4; i++)
+        {
+            Round(ref v0, ref v1, ref v2, ref v3);
+        }
+
+        return v0 ^ v1 ^ v2 ^ v3;
+    }
+
+    private static void Round(ref ulong v0, ref ulong v1, ref ulong v2, ref ulong v3)
+    {
+        v0 += v1; v1 = BitOperations.RotateLeft(v1, 13); v1 ^= v0; v0 = BitOperations.RotateLeft(v0, 32);
+        v2 += v3; v3 = BitOperations.RotateLeft(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = BitOperations.RotateLeft(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = BitOperations.RotateLeft(v1, 17); v1 ^= v2; v2 = BitOperations.RotateLeft(v2, 32);
+    }
+}
@@ -0,0 +1,69 @@
+using System.Buffers.Binary;
+
+namespace HidBridge.Transport.Uart;
+
+/// <summary>
+/// Where B_host sends its deferred log entries.
+/// </summary>
+public enum UartLogDrain : byte
+{
+    /// <summary>Text lines on the stdio UART.</summary>
+    Text = 0,
+
+    /// <summary><c>@L</c> hex records on the stdio UART, decoded with tools/logdecode.</summary>
+    Records = 1,
+
+    /// <summary>Entries stay in the ring until LOG_READ takes them.</summary>
+    Hold = 2,
+}
+
+/// <summary>
+/// Represents one LOG_READ (0x17) response.
+/// </summary>
+/// <param name="Drain">Active drain mode.</param>
+/// <param name="Dropped">Entries dropped since boot because the ring was full.</param>
+/// <param name="QueuedWords">Ring words still waiting after this read.</param>
+/// <param name="Entries">Whole ring entries as little-endian words; decode with tools/logdecode and the firmware ELF.</param>
+public sealed record HidBridgeUartLogChunk(
+    UartLogDrain Drain,
+    uint Dropped,
+    int QueuedWords,
+    byte[] Entries);
+
+/// <summary>
+/// Encodes LOG_READ (0x17) requests and decodes their responses.
+/// </summary>
+internal static class UartDeviceLog
+{
+    private const int HeaderLength = 7;
+
+    /// <summary>
+    /// Encodes a LOG_READ request.
+    /// </summary>
+    /// <param name="drain">Drain mode to switch to first, or <c>null</c> to keep the current one.</param>
+    /// <returns>The request payload.</returns>
+    internal static byte[] Pack(UartLogDrain? drain)
+        => drain.HasValue ? new[] { (byte)drain.Value } : Array.Empty<byte>();
+
+    /// <summary>
+    /// Parses a LOG_READ response.
+    /// </summary>
+    /// <param name="payload">Raw response payload.</param>
+    /// <param name="chunk">Decoded response when parsing succeeds.</param>
+    /// <returns><c>true</c> when the payload is well-formed.</returns>
+    internal static bool TryParse(ReadOnlySpan<byte> payload, out HidBridgeUartLogChunk chunk)
+    {
+        chunk = null!;
+        if (payload.Length < HeaderLength || (payload.Length - HeaderLength) % 4 != 0)
+        {
+            return false;
+        }
+
+        chunk = new HidBridgeUartLogChunk(
+            (UartLogDrain)payload[0],
+            BinaryPrimitives.ReadUInt32LittleEndian(payload.Slice(1)),
+            BinaryPrimitives.ReadUInt16LittleEndian(payload.Slice(5)),
+            payload.Slice(HeaderLength).ToArray());
+        return true;
+    }
+}
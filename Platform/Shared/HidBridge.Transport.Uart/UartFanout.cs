@@ -0,0 +1,104 @@
+using System.Buffers.Binary;
+
+namespace HidBridge.Transport.Uart;
+
+/// <summary>
+/// Represents one A_device target of a fan-out bridge.
+/// </summary>
+/// <param name="Index">Target number; 0 is the hardware UART link.</param>
+/// <param name="Ready">READY seen since the target's last descriptor set.</param>
+/// <param name="TxFrames">Frames written to the target.</param>
+/// <param name="TxErrors">Frames the target's link refused.</param>
+/// <param name="RxFrames">Frames received from the target.</param>
+public sealed record HidBridgeUartFanoutTarget(
+    byte Index,
+    bool Ready,
+    uint TxFrames,
+    uint TxErrors,
+    uint RxFrames);
+
+/// <summary>
+/// Represents the routing state of a fan-out bridge (FANOUT).
+/// </summary>
+/// <param name="Focus">Target that interfaces without a pinned route feed.</param>
+/// <param name="DescriptorScope">Bit mask of targets that receive descriptor traffic.</param>
+/// <param name="Switches">Focus switches since boot.</param>
+/// <param name="Targets">Every configured target.</param>
+/// <param name="Routes">Route entry per interface; <see cref="UartFanout.FollowFocus"/> follows the focus.</param>
+public sealed record HidBridgeUartFanoutState(
+    byte Focus,
+    byte DescriptorScope,
+    uint Switches,
+    IReadOnlyList<HidBridgeUartFanoutTarget> Targets,
+    IReadOnlyList<byte> Routes);
+
+/// <summary>
+/// Encodes FANOUT (0x19) requests and decodes their responses.
+/// </summary>
+internal static class UartFanout
+{
+    internal const byte FollowFocus = 0xFF;
+    private const byte OpFocus = 0x00;
+    private const byte OpRoute = 0x01;
+    private const byte OpResync = 0x02;
+    private const int HeaderLength = 7;
+    private const int TargetLength = 13;
+
+    /// <summary>
+    /// Encodes a focus change.
+    /// </summary>
+    internal static byte[] PackFocus(byte target) => new[] { OpFocus, target };
+
+    /// <summary>
+    /// Encodes a route change; a <c>null</c> target makes the interface follow the focus.
+    /// </summary>
+    internal static byte[] PackRoute(byte interfaceNumber, byte? target)
+        => new[] { OpRoute, interfaceNumber, target ?? FollowFocus };
+
+    /// <summary>
+    /// Encodes a descriptor resync of one target.
+    /// </summary>
+    internal static byte[] PackResync(byte target) => new[] { OpResync, target };
+
+    /// <summary>
+    /// Parses a FANOUT response.
+    /// </summary>
+    /// <param name="payload">Raw response payload.</param>
+    /// <param name="state">Decoded state when parsing succeeds.</param>
+    /// <returns><c>true</c> when the payload is well-formed.</returns>
+    internal static bool TryParse(ReadOnlySpan<byte> payload, out HidBridgeUartFanoutState? state)
+    {
+        state = null;
+        if (payload.Length < HeaderLength)
+        {
+            return false;
+        }
+
+        var count = payload[0];
+        var routesAt = HeaderLength + count * TargetLength;
+        if (payload.Length < routesAt + 1 || payload.Length < routesAt + 1 + payload[routesAt])
+        {
+            return false;
+        }
+
+        var targets = new List<HidBridgeUartFanoutTarget>(count);
+        for (var i = 0; i < count; i++)
+        {
+            var e = payload.Slice(HeaderLength + i * TargetLength, TargetLength);
+            targets.Add(new HidBridgeUartFanoutTarget(
+                (byte)i,
+                e[0] != 0,
+                BinaryPrimitives.ReadUInt32LittleEndian(e.Slice(1)),
+                BinaryPrimitives.ReadUInt32LittleEndian(e.Slice(5)),
+                BinaryPrimitives.ReadUInt32LittleEndian(e.Slice(9))));
+        }
+
+        state = new HidBridgeUartFanoutState(
+            payload[1],
+            payload[2],
+            BinaryPrimitives.ReadUInt32LittleEndian(payload.Slice(3)),
+            targets,
+            payload.Slice(routesAt + 1, payload[routesAt]).ToArray());
+        return true;
+    }
+}
@@ -1,3 +1,4 @@
+using System.Buffers.Binary;
 using System.Security.Cryptography;
 
 namespace HidBridge.Transport.Uart;
@@ -12,6 +13,10 @@ internal static class UartFrameCodec
     internal const int HeaderLen = 6;
     internal const int CrcLen = 2;
     internal const int HmacLen = 16;
+    internal const byte FastVersion = 0x02;
+    internal const int FastHeaderLen = 10;
+    internal const int FastTagLen = 8;
+    internal const int SessionNonceLen = 16;
 
     /// <summary>
     /// Builds one UART frame with CRC16 and truncated HMAC.
@@ -105,6 +110,107 @@ internal static class UartFrameCodec
         return true;
     }
 
+    /// <summary>
+    /// Builds one fast-MAC frame (version 0x02) with replay counter, CRC16 and SipHash-2-4 tag.
+    /// </summary>
+    /// <param name="seq">Protocol sequence number.</param>
+    /// <param name="cmd">Command identifier.</param>
+    /// <param name="flags">Protocol flags byte.</param>
+    /// <param name="counter">Session counter; must increase with every frame.</param>
+    /// <param name="payload">Raw payload bytes.</param>
+    /// <param name="sessionKey">16-byte key agreed by SESSION_SETUP.</param>
+    /// <returns>Encoded UART frame bytes without SLIP wrapping.</returns>
+    internal static byte[] BuildFastFrame(byte seq, byte cmd, byte flags, uint counter, ReadOnlySpan<byte> payload, byte[] sessionKey)
+    {
+        var payloadLen = payload.Length;
+        var bodyLen = FastHeaderLen + payloadLen;
+        var frame = new byte[bodyLen + CrcLen + FastTagLen];
+        frame[0] = Magic;
+        frame[1] = FastVersion;
+        frame[2] = flags;
+        frame[3] = seq;
+        frame[4] = cmd;
+        frame[5] = (byte)payloadLen;
+        BinaryPrimitives.WriteUInt32LittleEndian(frame.AsSpan(6), counter);
+        payload.CopyTo(frame.AsSpan(FastHeaderLen));
+
+        var crc = ComputeCrc16Ccitt(frame.AsSpan(0, bodyLen));
+        frame[bodyLen + 0] = (byte)(crc & 0xFF);
+        frame[bodyLen + 1] = (byte)(crc >> 8);
+
+        var tag = SipHash24.Compute(sessionKey, frame.AsSpan(0, bodyLen + CrcLen));
+        BinaryPrimitives.WriteUInt64LittleEndian(frame.AsSpan(bodyLen + CrcLen), tag);
+        return frame;
+    }
+
+    /// <summary>
+    /// Parses one fast-MAC frame and validates CRC and SipHash tag; replay checks are left to the caller.
+    /// </summary>
+    /// <param name="frame">Raw frame bytes without SLIP wrapping.</param>
+    /// <param name="sessionKey">16-byte session key.</param>
+    /// <param name="parsedFrame">Parsed frame result when validation succeeds.</param>
+    /// <param name="counter">Replay counter carried by the frame.</param>
+    /// <returns><c>true</c> when frame is valid and parsed; otherwise <c>false</c>.</returns>
+    internal static bool TryParseFastFrame(
+        ReadOnlySpan<byte> frame,
+        byte[] sessionKey,
+        out UartParsedFrame parsedFrame,
+        out uint counter)
+    {
+        parsedFrame = default;
+        counter = 0;
+        if (frame.Length < FastHeaderLen + CrcLen + FastTagLen || frame[0] != Magic || frame[1] != FastVersion)
+        {
+            return false;
+        }
+
+        var payloadLen = frame[5];
+        var bodyLen = FastHeaderLen + payloadLen;
+        if (frame.Length != bodyLen + CrcLen + FastTagLen)
+        {
+            return false;
+        }
+
+        var crc = ComputeCrc16Ccitt(frame[..bodyLen]);
+        var actualCrc = (ushort)(frame[bodyLen] | (frame[bodyLen + 1] << 8));
+        if (crc != actualCrc)
+        {
+            return false;
+        }
+
+        Span<byte> tag = stackalloc byte[FastTagLen];
+        BinaryPrimitives.WriteUInt64LittleEndian(tag, SipHash24.Compute(sessionKey, frame[..(bodyLen + CrcLen)]));
+        if (!CryptographicOperations.FixedTimeEquals(tag, frame.Slice(bodyLen + CrcLen, FastTagLen)))
+        {
+            return false;
+        }
+
+        counter = BinaryPrimitives.ReadUInt32LittleEndian(frame[6..]);
+        parsedFrame = new UartParsedFrame(
+            frame[3],
+            frame[4],
+            frame[2],
+            frame.Slice(FastHeaderLen, payloadLen).ToArray(),
+            false);
+        return true;
+    }
+
+    /// <summary>
+    /// Derives the fast-MAC session key agreed by SESSION_SETUP.
+    /// </summary>
+    /// <param name="derivedKey">Per-device derived HMAC key.</param>
+    /// <param name="hostNonce">16-byte nonce sent by the controller.</param>
+    /// <param name="deviceNonce">16-byte nonce returned by firmware.</param>
+    /// <returns>First 16 bytes of <c>HMAC-SHA256(derivedKey, "HBS1" || hostNonce || deviceNonce)</c>.</returns>
+    internal static byte[] DeriveSessionKey(byte[] derivedKey, ReadOnlySpan<byte> hostNonce, ReadOnlySpan<byte> deviceNonce)
+    {
+        var message = new byte[4 + SessionNonceLen + SessionNonceLen];
+        "HBS1"u8.CopyTo(message);
+        hostNonce[..SessionNonceLen].CopyTo(message.AsSpan(4));
+        deviceNonce[..SessionNonceLen].CopyTo(message.AsSpan(4 + SessionNonceLen));
+        return HMACSHA256.HashData(derivedKey, message).AsSpan(0, SipHash24.KeyLen).ToArray();
+    }
+
     /// <summary>
     /// Computes protocol CRC16-CCITT checksum over provided bytes.
     /// </summary>
@@ -0,0 +1,48 @@
+namespace HidBridge.Transport.Uart;
+
+/// <summary>
+/// Packs reports into INJECT_BATCH (0x0A) payloads.
+/// </summary>
+internal static class UartInjectBatch
+{
+    internal const int MaxPayload = 240;
+    internal const int TupleHeaderLen = 4;
+
+    /// <summary>
+    /// Splits reports into as few payloads as fit the 240-byte frame limit, preserving order.
+    /// </summary>
+    /// <param name="reports">Reports with resolved interface selectors.</param>
+    /// <returns>One payload per INJECT_BATCH command.</returns>
+    internal static IReadOnlyList<byte[]> Pack(IReadOnlyList<HidBridgeUartBatchReport> reports)
+    {
+        var payloads = new List<byte[]>();
+        var current = new List<byte> { 0 };
+        foreach (var report in reports)
+        {
+            if (report.Report.Length is 0 or > MaxPayload - 1 - TupleHeaderLen)
+            {
+                throw new InvalidOperationException("HID report length must be 1..235 bytes in a batch.");
+            }
+
+            if (current.Count + TupleHeaderLen + report.Report.Length > MaxPayload || current[0] == byte.MaxValue)
+            {
+                payloads.Add(current.ToArray());
+                current = new List<byte> { 0 };
+            }
+
+            current[0]++;
+            current.Add(report.InterfaceSelector);
+            current.Add((byte)(report.DelayUs & 0xFF));
+            current.Add((byte)(report.DelayUs >> 8));
+            current.Add((byte)report.Report.Length);
+            current.AddRange(report.Report);
+        }
+
+        if (current[0] > 0)
+        {
+            payloads.Add(current.ToArray());
+        }
+
+        return payloads;
+    }
+}
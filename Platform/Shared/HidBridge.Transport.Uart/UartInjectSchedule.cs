@@ -0,0 +1,95 @@
+using System.Buffers.Binary;
+
+namespace HidBridge.Transport.Uart;
+
+/// <summary>
+/// Packs reports into SCHEDULE (0x11) ADD payloads and decodes STATS responses.
+/// </summary>
+internal static class UartInjectSchedule
+{
+    internal const int MaxPayload = 240;
+    internal const int MaxReportLength = 64;
+    internal const byte SubAdd = 0x01;
+    internal const byte SubCancel = 0x02;
+    internal const byte SubStats = 0x03;
+    internal const ushort TagAll = 0xFFFF;
+    private const byte FlagAbsolute = 0x01;
+    private const int HeaderLen = 4;
+    private const int TupleHeaderLen = 6;
+    private const int StatsLen = 43;
+
+    /// <summary>
+    /// Splits reports into as few ADD payloads as fit the 240-byte frame limit, preserving order.
+    /// </summary>
+    /// <param name="reports">Reports with resolved interface selectors.</param>
+    /// <param name="tag">Tag used to cancel the reports later.</param>
+    /// <param name="absolute">Whether due times are B_host clock values.</param>
+    /// <returns>One payload per SCHEDULE command.</returns>
+    internal static IReadOnlyList<byte[]> Pack(IReadOnlyList<HidBridgeUartScheduledReport> reports, ushort tag, bool absolute)
+    {
+        var payloads = new List<byte[]>();
+        List<byte>? current = null;
+        foreach (var report in reports)
+        {
+            if (report.Report.Length is 0 or > MaxReportLength)
+            {
+                throw new InvalidOperationException("HID report length must be 1..64 bytes for scheduled injection.");
+            }
+
+            if (current is null || current.Count + TupleHeaderLen + report.Report.Length > MaxPayload)
+            {
+                if (current is not null)
+                {
+                    payloads.Add(current.ToArray());
+                }
+
+                current = new List<byte> { SubAdd, absolute ? FlagAbsolute : (byte)0, (byte)(tag & 0xFF), (byte)(tag >> 8) };
+            }
+
+            var tuple = new byte[TupleHeaderLen];
+            BinaryPrimitives.WriteUInt32LittleEndian(tuple, report.DueUs);
+            tuple[4] = report.InterfaceSelector;
+            tuple[5] = (byte)report.Report.Length;
+            current.AddRange(tuple);
+            current.AddRange(report.Report);
+        }
+
+        if (current is not null && current.Count > HeaderLen)
+        {
+            payloads.Add(current.ToArray());
+        }
+
+        return payloads;
+    }
+
+    /// <summary>
+    /// Parses a SCHEDULE STATS response.
+    /// </summary>
+    /// <param name="payload">Raw response payload.</param>
+    /// <param name="stats">Decoded counters when parsing succeeds.</param>
+    /// <returns><c>true</c> when the payload is well-formed.</returns>
+    internal static bool TryParseStats(ReadOnlySpan<byte> payload, out HidBridgeUartScheduleStats stats)
+    {
+        stats = null!;
+        if (payload.Length < StatsLen)
+        {
+            return false;
+        }
+
+        stats = new HidBridgeUartScheduleStats(
+            payload[0],
+            payload[1],
+            payload[2],
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[3..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[7..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[11..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[15..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[19..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[23..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[27..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[31..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[35..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[39..]));
+        return true;
+    }
+}
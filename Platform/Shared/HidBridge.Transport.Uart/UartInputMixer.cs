@@ -0,0 +1,93 @@
+using System.Buffers.Binary;
+
+namespace HidBridge.Transport.Uart;
+
+/// <summary>
+/// How firmware combines physical and injected input of one interface (MIX).
+/// </summary>
+public enum UartMixPolicy : byte
+{
+    /// <summary>Every report goes out as it arrives; the newest report wins.</summary>
+    Off = 0,
+
+    /// <summary>Both sources are merged into one report per poll interval.</summary>
+    Merge = 1,
+
+    /// <summary>Injected input is dropped while the user is active.</summary>
+    PhysicalFirst = 2,
+
+    /// <summary>Physical input is dropped while the controller is active.</summary>
+    InjectedFirst = 3,
+
+    /// <summary>Exclusive lock: physical input is dropped.</summary>
+    InjectedOnly = 4,
+}
+
+/// <summary>
+/// Represents the MIX state of one interface slot.
+/// </summary>
+/// <param name="Interface">Interface number.</param>
+/// <param name="Policy">Active policy.</param>
+/// <param name="IntervalUs">Merged report spacing; 0 until the first merged report.</param>
+/// <param name="PhysicalIn">Physical reports taken by the mixer.</param>
+/// <param name="InjectedIn">Injected reports taken by the mixer.</param>
+/// <param name="MergedOut">Merged reports sent.</param>
+/// <param name="Suppressed">Reports a priority policy dropped.</param>
+public sealed record HidBridgeUartMixState(
+    byte Interface,
+    UartMixPolicy Policy,
+    int IntervalUs,
+    uint PhysicalIn,
+    uint InjectedIn,
+    uint MergedOut,
+    uint Suppressed);
+
+/// <summary>
+/// Encodes MIX (0x16) requests and decodes their responses.
+/// </summary>
+internal static class UartInputMixer
+{
+    internal const byte AllInterfaces = 0xFD;
+    private const int EntryLength = 20;
+
+    /// <summary>
+    /// Encodes a MIX set request.
+    /// </summary>
+    /// <param name="interfaceSelector">Interface, logical selector, or <see cref="AllInterfaces"/>.</param>
+    /// <param name="policy">Policy to apply.</param>
+    /// <returns>The request payload.</returns>
+    internal static byte[] Pack(byte interfaceSelector, UartMixPolicy policy)
+        => new[] { interfaceSelector, (byte)policy };
+
+    /// <summary>
+    /// Parses a MIX response.
+    /// </summary>
+    /// <param name="payload">Raw response payload.</param>
+    /// <param name="states">Decoded interface slots when parsing succeeds.</param>
+    /// <returns><c>true</c> when the payload is well-formed.</returns>
+    internal static bool TryParse(ReadOnlySpan<byte> payload, out IReadOnlyList<HidBridgeUartMixState> states)
+    {
+        states = Array.Empty<HidBridgeUartMixState>();
+        if (payload.Length < 1 || payload.Length < 1 + payload[0] * EntryLength)
+        {
+            return false;
+        }
+
+        var list = new List<HidBridgeUartMixState>(payload[0]);
+        for (var i = 0; i < payload[0]; i++)
+        {
+            var e = payload.Slice(1 + i * EntryLength, EntryLength);
+            list.Add(new HidBridgeUartMixState(
+                e[0],
+                (UartMixPolicy)e[1],
+                BinaryPrimitives.ReadUInt16LittleEndian(e.Slice(2)),
+                BinaryPrimitives.ReadUInt32LittleEndian(e.Slice(4)),
+                BinaryPrimitives.ReadUInt32LittleEndian(e.Slice(8)),
+                BinaryPrimitives.ReadUInt32LittleEndian(e.Slice(12)),
+                BinaryPrimitives.ReadUInt32LittleEndian(e.Slice(16))));
+        }
+
+        states = list;
+        return true;
+    }
+}
@@ -0,0 +1,141 @@
+using System.Buffers.Binary;
+
+namespace HidBridge.Transport.Uart;
+
+/// <summary>
+/// Selects what firmware does with captured reports when the tap ring is full.
+/// </summary>
+public enum UartInputTapMode : byte
+{
+    Off = 0,
+    DropOldest = 1,
+    DropNewest = 2,
+}
+
+/// <summary>
+/// Represents one physical report captured by B_host.
+/// </summary>
+/// <param name="TimeUs">B_host clock at capture.</param>
+/// <param name="Seq">Capture counter; gaps mean reports were dropped by the tap ring.</param>
+/// <param name="Interface">Interface the report arrived on.</param>
+/// <param name="Forwarded">Whether the report was forwarded to A_device.</param>
+/// <param name="Truncated">Whether firmware cut the report to 64 bytes.</param>
+/// <param name="Report">Raw HID report bytes.</param>
+public sealed record UartInputTapEntry(uint TimeUs, ushort Seq, byte Interface, bool Forwarded, bool Truncated, byte[] Report);
+
+/// <summary>
+/// Represents one decoded TAP_DATA frame.
+/// </summary>
+/// <param name="Used">Entries still waiting in the firmware ring.</param>
+/// <param name="HighWater">Maximum entries waiting since the tap was enabled.</param>
+/// <param name="Dropped">Entries dropped by either policy since the tap was enabled.</param>
+/// <param name="Entries">Entries carried by this frame, oldest first.</param>
+public sealed record UartInputTapFrame(int Used, int HighWater, uint Dropped, IReadOnlyList<UartInputTapEntry> Entries);
+
+/// <summary>
+/// Represents the TAP command response.
+/// </summary>
+/// <param name="Mode">Active mode.</param>
+/// <param name="Depth">Ring capacity in entries.</param>
+/// <param name="Used">Entries waiting right now.</param>
+/// <param name="HighWater">Maximum entries waiting since the tap was enabled.</param>
+/// <param name="Captured">Reports offered to the tap.</param>
+/// <param name="DroppedOldest">Entries overwritten before they were sent.</param>
+/// <param name="DroppedNewest">Reports refused because the ring was full.</param>
+/// <param name="Drained">Entries sent to the control port.</param>
+public sealed record UartInputTapStats(
+    UartInputTapMode Mode,
+    int Depth,
+    int Used,
+    int HighWater,
+    uint Captured,
+    uint DroppedOldest,
+    uint DroppedNewest,
+    uint Drained);
+
+/// <summary>
+/// Decodes firmware TAP (0x0E) responses and TAP_DATA (0x0F) frames.
+/// </summary>
+public static class UartInputTapDecoder
+{
+    private const int FrameHeaderLen = 9;
+    private const int EntryHeaderLen = 9;
+    private const int StatsLen = 23;
+    private const byte FlagForwarded = 0x01;
+    private const byte FlagTruncated = 0x02;
+
+    /// <summary>
+    /// Parses one TAP_DATA payload.
+    /// </summary>
+    /// <param name="payload">Raw frame payload.</param>
+    /// <param name="frame">Decoded frame when parsing succeeds.</param>
+    /// <returns><c>true</c> when the payload holds the declared number of whole entries.</returns>
+    public static bool TryParseFrame(ReadOnlySpan<byte> payload, out UartInputTapFrame frame)
+    {
+        frame = null!;
+        if (payload.Length < FrameHeaderLen)
+        {
+            return false;
+        }
+
+        var count = payload[0];
+        var entries = new List<UartInputTapEntry>(count);
+        var pos = FrameHeaderLen;
+        for (var i = 0; i < count; i++)
+        {
+            if (pos + EntryHeaderLen > payload.Length)
+            {
+                return false;
+            }
+
+            var entry = payload[pos..];
+            var len = entry[8];
+            if (pos + EntryHeaderLen + len > payload.Length)
+            {
+                return false;
+            }
+
+            entries.Add(new UartInputTapEntry(
+                BinaryPrimitives.ReadUInt32LittleEndian(entry),
+                BinaryPrimitives.ReadUInt16LittleEndian(entry[4..]),
+                entry[6],
+                (entry[7] & FlagForwarded) != 0,
+                (entry[7] & FlagTruncated) != 0,
+                entry.Slice(EntryHeaderLen, len).ToArray()));
+            pos += EntryHeaderLen + len;
+        }
+
+        frame = new UartInputTapFrame(
+            BinaryPrimitives.ReadUInt16LittleEndian(payload[1..]),
+            BinaryPrimitives.ReadUInt16LittleEndian(payload[3..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[5..]),
+            entries);
+        return true;
+    }
+
+    /// <summary>
+    /// Parses a TAP command response.
+    /// </summary>
+    /// <param name="payload">Raw response payload.</param>
+    /// <param name="stats">Decoded counters when parsing succeeds.</param>
+    /// <returns><c>true</c> when the payload is well-formed.</returns>
+    public static bool TryParseStats(ReadOnlySpan<byte> payload, out UartInputTapStats stats)
+    {
+        stats = null!;
+        if (payload.Length < StatsLen)
+        {
+            return false;
+        }
+
+        stats = new UartInputTapStats(
+            (UartInputTapMode)payload[0],
+            BinaryPrimitives.ReadUInt16LittleEndian(payload[1..]),
+            BinaryPrimitives.ReadUInt16LittleEndian(payload[3..]),
+            BinaryPrimitives.ReadUInt16LittleEndian(payload[5..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[7..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[11..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[15..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[19..]));
+        return true;
+    }
+}
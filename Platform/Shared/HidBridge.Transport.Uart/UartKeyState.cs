@@ -0,0 +1,83 @@
+namespace HidBridge.Transport.Uart;
+
+/// <summary>
+/// Represents the KEY (0x15) state response for one interface.
+/// </summary>
+/// <param name="Interface">Concrete interface number.</param>
+/// <param name="InjectedModifiers">Modifier bits held through KEY_DOWN.</param>
+/// <param name="InjectedButtons">Mouse buttons held through BUTTON_DOWN.</param>
+/// <param name="InjectedKeys">Key usages held through KEY_DOWN.</param>
+/// <param name="PhysicalModifiers">Modifier bits in the last physical report.</param>
+/// <param name="PhysicalButtons">Mouse buttons in the last physical report.</param>
+/// <param name="PhysicalKeys">Key usages in the last physical report (up to 16).</param>
+public sealed record HidBridgeUartKeyState(
+    byte Interface,
+    byte InjectedModifiers,
+    byte InjectedButtons,
+    byte[] InjectedKeys,
+    byte PhysicalModifiers,
+    byte PhysicalButtons,
+    byte[] PhysicalKeys);
+
+/// <summary>
+/// Encodes KEY (0x15) requests and decodes their state responses.
+/// </summary>
+internal static class UartKeyState
+{
+    internal const byte OpKeyDown = 0x01;
+    internal const byte OpKeyUp = 0x02;
+    internal const byte OpButtonDown = 0x03;
+    internal const byte OpButtonUp = 0x04;
+    internal const byte OpReleaseAll = 0x05;
+    internal const byte OpState = 0x06;
+    internal const byte AllInterfaces = 0xFD;
+
+    /// <summary>
+    /// Encodes a KEY request.
+    /// </summary>
+    /// <param name="op">Operation code.</param>
+    /// <param name="interfaceSelector">Concrete interface, or <see cref="AllInterfaces"/> for RELEASE_ALL.</param>
+    /// <param name="args">Usages for key ops, the button mask for button ops, nothing otherwise.</param>
+    /// <returns>The request payload.</returns>
+    internal static byte[] Pack(byte op, byte interfaceSelector, ReadOnlySpan<byte> args)
+    {
+        var payload = new byte[2 + args.Length];
+        payload[0] = op;
+        payload[1] = interfaceSelector;
+        args.CopyTo(payload.AsSpan(2));
+        return payload;
+    }
+
+    /// <summary>
+    /// Parses a KEY state response.
+    /// </summary>
+    /// <param name="payload">Raw response payload.</param>
+    /// <param name="state">Decoded state when parsing succeeds.</param>
+    /// <returns><c>true</c> when the payload is well-formed.</returns>
+    internal static bool TryParseState(ReadOnlySpan<byte> payload, out HidBridgeUartKeyState state)
+    {
+        state = null!;
+        if (payload.Length < 4 || payload.Length < 4 + payload[3] + 3)
+        {
+            return false;
+        }
+
+        var injected = payload.Slice(4, payload[3]).ToArray();
+        var pos = 4 + injected.Length;
+        var physicalCount = payload[pos + 2];
+        if (payload.Length < pos + 3 + physicalCount)
+        {
+            return false;
+        }
+
+        state = new HidBridgeUartKeyState(
+            payload[0],
+            payload[1],
+            payload[2],
+            injected,
+            payload[pos],
+            payload[pos + 1],
+            payload.Slice(pos + 3, physicalCount).ToArray());
+        return true;
+    }
+}
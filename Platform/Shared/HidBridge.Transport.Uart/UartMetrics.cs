@@ -0,0 +1,273 @@
+using System.Buffers.Binary;
+using System.Text;
+
+namespace HidBridge.Transport.Uart;
+
+/// <summary>
+/// Board whose metrics registry GET_METRICS reads.
+/// </summary>
+public enum UartMetricsBoard : byte
+{
+    /// <summary>B_host, the USB host side.</summary>
+    BHost = 0,
+
+    /// <summary>A_device, served from the snapshot B_host pulled over the link.</summary>
+    ADevice = 1,
+}
+
+/// <summary>
+/// Kind of a firmware metric.
+/// </summary>
+public enum UartMetricKind : byte
+{
+    /// <summary>Monotonic count since boot.</summary>
+    Counter = 0,
+
+    /// <summary>Current value.</summary>
+    Gauge = 1,
+
+    /// <summary>Log-linear distribution since boot.</summary>
+    Histogram = 2,
+}
+
+/// <summary>
+/// Represents one non-empty histogram bucket.
+/// </summary>
+/// <param name="LowerBound">Smallest value the bucket holds.</param>
+/// <param name="Count">Observations in the bucket.</param>
+public sealed record HidBridgeUartHistogramBucket(ulong LowerBound, ulong Count);
+
+/// <summary>
+/// Represents a firmware histogram.
+/// </summary>
+/// <param name="Count">Observations since boot.</param>
+/// <param name="Sum">Sum of all observations.</param>
+/// <param name="Min">Smallest observation; 0 when empty.</param>
+/// <param name="Max">Largest observation.</param>
+/// <param name="Buckets">Buckets in ascending order, empty ones left out.</param>
+public sealed record HidBridgeUartHistogram(
+    ulong Count,
+    ulong Sum,
+    ulong Min,
+    ulong Max,
+    IReadOnlyList<HidBridgeUartHistogramBucket> Buckets)
+{
+    /// <summary>
+    /// Gets the mean observation, or 0 when empty.
+    /// </summary>
+    public double Mean => Count == 0 ? 0 : (double)Sum / Count;
+
+    /// <summary>
+    /// Estimates a percentile as the lower bound of the bucket that reaches it.
+    /// </summary>
+    /// <param name="fraction">Percentile as a fraction, 0..1.</param>
+    /// <returns>The estimate, or 0 when empty.</returns>
+    public ulong Percentile(double fraction)
+    {
+        if (Count == 0)
+        {
+            return 0;
+        }
+
+        var target = Math.Clamp(fraction, 0, 1) * Count;
+        ulong seen = 0;
+        foreach (var bucket in Buckets)
+        {
+            seen += bucket.Count;
+            if (seen >= target)
+            {
+                return Math.Max(bucket.LowerBound, Min);
+            }
+        }
+
+        return Max;
+    }
+}
+
+/// <summary>
+/// Represents one firmware metric.
+/// </summary>
+/// <param name="Name">Dotted metric name, e.g. <c>host.input.send_us</c>.</param>
+/// <param name="Kind">Metric kind.</param>
+/// <param name="Value">Counter or gauge value; the observation count for histograms.</param>
+/// <param name="Histogram">Distribution for histograms, otherwise <c>null</c>.</param>
+public sealed record HidBridgeUartMetric(
+    string Name,
+    UartMetricKind Kind,
+    ulong Value,
+    HidBridgeUartHistogram? Histogram);
+
+/// <summary>
+/// Represents GET_METRICS (0x18) output: one page, or every page of a board.
+/// </summary>
+/// <param name="Board">Board the metrics belong to.</param>
+/// <param name="Total">Metrics in the registry.</param>
+/// <param name="Start">Index of the first metric in <paramref name="Metrics"/>.</param>
+/// <param name="AgeMs">Age of the A_device snapshot; 0 for B_host, <see cref="uint.MaxValue"/> while none has arrived.</param>
+/// <param name="Metrics">Decoded metrics.</param>
+public sealed record HidBridgeUartMetricsPage(
+    UartMetricsBoard Board,
+    int Total,
+    int Start,
+    uint AgeMs,
+    IReadOnlyList<HidBridgeUartMetric> Metrics);
+
+/// <summary>
+/// Encodes GET_METRICS (0x18) requests and decodes their responses.
+/// </summary>
+internal static class UartMetrics
+{
+    private const int HeaderLength = 8;
+    private const int LinearBuckets = 8;
+    private const int SubBucketBits = 2;
+
+    /// <summary>
+    /// Encodes a GET_METRICS request.
+    /// </summary>
+    /// <param name="board">Board to read.</param>
+    /// <param name="start">Index of the first metric wanted.</param>
+    /// <returns>The request payload.</returns>
+    internal static byte[] Pack(UartMetricsBoard board, byte start)
+        => new[] { (byte)board, start };
+
+    /// <summary>
+    /// Gets the smallest value firmware histogram bucket <paramref name="bucket"/> holds.
+    /// </summary>
+    /// <param name="bucket">Bucket index, 0..63.</param>
+    /// <returns>The lower bound.</returns>
+    internal static ulong BucketLowerBound(int bucket)
+    {
+        if (bucket < LinearBuckets)
+        {
+            return (ulong)bucket;
+        }
+
+        var i = bucket - LinearBuckets;
+        var sub = i & ((1 << SubBucketBits) - 1);
+        var shift = 1 + (i >> SubBucketBits);
+        return (ulong)((1 << SubBucketBits) + sub) << shift;
+    }
+
+    /// <summary>
+    /// Parses a GET_METRICS response.
+    /// </summary>
+    /// <param name="payload">Raw response payload.</param>
+    /// <param name="page">Decoded page when parsing succeeds.</param>
+    /// <returns><c>true</c> when the payload is well-formed.</returns>
+    internal static bool TryParse(ReadOnlySpan<byte> payload, out HidBridgeUartMetricsPage page)
+    {
+        page = null!;
+        if (payload.Length < HeaderLength)
+        {
+            return false;
+        }
+
+        var count = payload[3];
+        var metrics = new List<HidBridgeUartMetric>(count);
+        var at = HeaderLength;
+        for (var i = 0; i < count; i++)
+        {
+            if (!TryParseMetric(payload, ref at, out var metric))
+            {
+                return false;
+            }
+
+            metrics.Add(metric);
+        }
+
+        if (at != payload.Length)
+        {
+            return false;
+        }
+
+        page = new HidBridgeUartMetricsPage(
+            (UartMetricsBoard)payload[0],
+            payload[1],
+            payload[2],
+            BinaryPrimitives.ReadUInt32LittleEndian(payload.Slice(4)),
+            metrics);
+        return true;
+    }
+
+    private static bool TryParseMetric(ReadOnlySpan<byte> payload, ref int at, out HidBridgeUartMetric metric)
+    {
+        metric = null!;
+        if (at + 2 > payload.Length)
+        {
+            return false;
+        }
+
+        var kind = (UartMetricKind)payload[at];
+        var nameLength = payload[at + 1];
+        at += 2;
+        if (at + nameLength > payload.Length)
+        {
+            return false;
+        }
+
+        var name = Encoding.ASCII.GetString(payload.Slice(at, nameLength));
+        at += nameLength;
+
+        switch (kind)
+        {
+            case UartMetricKind.Counter:
+            case UartMetricKind.Gauge:
+                if (!TryReadVarint(payload, ref at, out var value))
+                {
+                    return false;
+                }
+
+                metric = new HidBridgeUartMetric(name, kind, value, null);
+                return true;
+
+            case UartMetricKind.Histogram:
+                if (!TryReadVarint(payload, ref at, out var hCount) ||
+                    !TryReadVarint(payload, ref at, out var sum) ||
+                    !TryReadVarint(payload, ref at, out var min) ||
+                    !TryReadVarint(payload, ref at, out var max) ||
+                    at + 2 > payload.Length)
+                {
+                    return false;
+                }
+
+                int first = payload[at];
+                int n = payload[at + 1];
+                at += 2;
+                var buckets = new List<HidBridgeUartHistogramBucket>();
+                for (var b = 0; b < n; b++)
+                {
+                    if (!TryReadVarint(payload, ref at, out var bucketCount))
+                    {
+                        return false;
+                    }
+
+                    if (bucketCount != 0)
+                    {
+                        buckets.Add(new HidBridgeUartHistogramBucket(BucketLowerBound(first + b), bucketCount));
+                    }
+                }
+
+                metric = new HidBridgeUartMetric(name, kind, hCount, new HidBridgeUartHistogram(hCount, sum, min, max, buckets));
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    private static bool TryReadVarint(ReadOnlySpan<byte> payload, ref int at, out ulong value)
+    {
+        value = 0;
+        for (var shift = 0; shift < 64 && at < payload.Length; shift += 7)
+        {
+            var b = payload[at++];
+            value |= (ulong)(b & 0x7F) << shift;
+            if ((b & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,58 @@
+using System.Buffers.Binary;
+
+namespace HidBridge.Transport.Uart;
+
+/// <summary>
+/// Encodes MOVE (0x12) requests and decodes their status responses.
+/// </summary>
+internal static class UartPointerMove
+{
+    internal const byte ModeBy = 0x00;
+    internal const byte ModeTo = 0x01;
+    internal const byte ModeStop = 0x02;
+    private const int RequestLen = 13;
+    private const int StatusLen = 13;
+
+    /// <summary>
+    /// Encodes a MOVE request.
+    /// </summary>
+    /// <param name="move">Motion with a resolved interface selector.</param>
+    /// <returns>The 13-byte request payload.</returns>
+    internal static byte[] Pack(HidBridgeUartPointerMove move)
+    {
+        var payload = new byte[RequestLen];
+        payload[0] = move.Absolute ? ModeTo : ModeBy;
+        payload[1] = move.InterfaceSelector;
+        payload[2] = move.Buttons;
+        BinaryPrimitives.WriteInt16LittleEndian(payload.AsSpan(3), move.X);
+        BinaryPrimitives.WriteInt16LittleEndian(payload.AsSpan(5), move.Y);
+        payload[7] = unchecked((byte)move.Wheel);
+        payload[8] = move.MaxStep;
+        BinaryPrimitives.WriteUInt16LittleEndian(payload.AsSpan(9), move.ScaleQ8);
+        BinaryPrimitives.WriteUInt16LittleEndian(payload.AsSpan(11), move.IntervalUs);
+        return payload;
+    }
+
+    /// <summary>
+    /// Parses a MOVE status response.
+    /// </summary>
+    /// <param name="payload">Raw response payload.</param>
+    /// <param name="status">Decoded status when parsing succeeds.</param>
+    /// <returns><c>true</c> when the payload is well-formed.</returns>
+    internal static bool TryParseStatus(ReadOnlySpan<byte> payload, out HidBridgeUartMoveStatus status)
+    {
+        status = null!;
+        if (payload.Length < StatusLen)
+        {
+            return false;
+        }
+
+        status = new HidBridgeUartMoveStatus(
+            payload[0] != 0,
+            BinaryPrimitives.ReadUInt16LittleEndian(payload[1..]),
+            BinaryPrimitives.ReadUInt16LittleEndian(payload[3..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[5..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[9..]));
+        return true;
+    }
+}
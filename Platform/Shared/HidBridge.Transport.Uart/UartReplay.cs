@@ -0,0 +1,177 @@
+using System.Buffers.Binary;
+
+namespace HidBridge.Transport.Uart;
+
+/// <summary>
+/// Firmware replay engine state.
+/// </summary>
+public enum UartReplayState : byte
+{
+    Idle = 0,
+    Recording = 1,
+    Playing = 2,
+}
+
+/// <summary>
+/// Selects which reports firmware records.
+/// </summary>
+[Flags]
+public enum UartReplaySources : byte
+{
+    Physical = 0x01,
+    Injected = 0x02,
+}
+
+/// <summary>
+/// Represents one report in a replay sequence.
+/// </summary>
+/// <param name="TimeUs">Offset from the sequence start.</param>
+/// <param name="Interface">Concrete interface number the report is sent on.</param>
+/// <param name="Report">Raw HID report bytes (1..64).</param>
+public sealed record UartReplayEntry(uint TimeUs, byte Interface, byte[] Report);
+
+/// <summary>
+/// Represents the REPLAY status response.
+/// </summary>
+/// <param name="State">Current engine state.</param>
+/// <param name="Sources">Sources being recorded.</param>
+/// <param name="Events">Entries in the buffer.</param>
+/// <param name="Used">Bytes in the buffer.</param>
+/// <param name="Size">Buffer capacity in bytes.</param>
+/// <param name="DurationUs">Loop period; 0 uses the last entry time.</param>
+/// <param name="LoopsDone">Completed loops of the current or last playback.</param>
+/// <param name="Sent">Reports written to the link.</param>
+/// <param name="Failed">Reports whose interface was missing or not ready when due.</param>
+/// <param name="BusyRetries">Times a due report waited for a main-loop frame on the link.</param>
+/// <param name="LateMaxUs">Worst schedule error.</param>
+/// <param name="LateMeanUs">Mean schedule error.</param>
+/// <param name="Overruns">Reports later than the firmware lateness limit.</param>
+/// <param name="RecordDropped">Reports not recorded because the buffer was full.</param>
+public sealed record UartReplayStatus(
+    UartReplayState State,
+    UartReplaySources Sources,
+    int Events,
+    int Used,
+    int Size,
+    uint DurationUs,
+    int LoopsDone,
+    uint Sent,
+    uint Failed,
+    uint BusyRetries,
+    uint LateMaxUs,
+    uint LateMeanUs,
+    uint Overruns,
+    uint RecordDropped);
+
+/// <summary>
+/// Encodes replay sequences and decodes REPLAY (0x10) responses.
+/// </summary>
+public static class UartReplay
+{
+    /// <summary>
+    /// Largest report firmware replays.
+    /// </summary>
+    public const int MaxReportLength = 64;
+
+    private const int EntryHeaderLen = 6;
+    private const int StatusLen = 42;
+
+    /// <summary>
+    /// Encodes entries into the firmware buffer format.
+    /// </summary>
+    /// <param name="entries">Entries with non-decreasing <see cref="UartReplayEntry.TimeUs"/>.</param>
+    /// <returns>The buffer image.</returns>
+    public static byte[] Pack(IReadOnlyList<UartReplayEntry> entries)
+    {
+        var buffer = new List<byte>();
+        var header = new byte[EntryHeaderLen];
+        uint previous = 0;
+        foreach (var entry in entries)
+        {
+            if (entry.Report.Length is 0 or > MaxReportLength)
+            {
+                throw new InvalidOperationException("HID report length must be 1..64 bytes in a replay sequence.");
+            }
+
+            if (entry.TimeUs < previous)
+            {
+                throw new InvalidOperationException("Replay entry times must not decrease.");
+            }
+
+            previous = entry.TimeUs;
+            BinaryPrimitives.WriteUInt32LittleEndian(header, entry.TimeUs);
+            header[4] = entry.Interface;
+            header[5] = (byte)entry.Report.Length;
+            buffer.AddRange(header);
+            buffer.AddRange(entry.Report);
+        }
+
+        return buffer.ToArray();
+    }
+
+    /// <summary>
+    /// Decodes a buffer image downloaded from firmware.
+    /// </summary>
+    /// <param name="buffer">Buffer bytes.</param>
+    /// <param name="entries">Decoded entries when parsing succeeds.</param>
+    /// <returns><c>true</c> when the buffer holds whole entries only.</returns>
+    public static bool TryUnpack(ReadOnlySpan<byte> buffer, out IReadOnlyList<UartReplayEntry> entries)
+    {
+        var list = new List<UartReplayEntry>();
+        entries = list;
+        var pos = 0;
+        while (pos < buffer.Length)
+        {
+            if (pos + EntryHeaderLen > buffer.Length)
+            {
+                return false;
+            }
+
+            var len = buffer[pos + 5];
+            if (pos + EntryHeaderLen + len > buffer.Length)
+            {
+                return false;
+            }
+
+            list.Add(new UartReplayEntry(
+                BinaryPrimitives.ReadUInt32LittleEndian(buffer[pos..]),
+                buffer[pos + 4],
+                buffer.Slice(pos + EntryHeaderLen, len).ToArray()));
+            pos += EntryHeaderLen + len;
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    /// Parses a REPLAY status response.
+    /// </summary>
+    /// <param name="payload">Raw response payload.</param>
+    /// <param name="status">Decoded status when parsing succeeds.</param>
+    /// <returns><c>true</c> when the payload is well-formed.</returns>
+    public static bool TryParseStatus(ReadOnlySpan<byte> payload, out UartReplayStatus status)
+    {
+        status = null!;
+        if (payload.Length < StatusLen)
+        {
+            return false;
+        }
+
+        status = new UartReplayStatus(
+            (UartReplayState)payload[0],
+            (UartReplaySources)payload[1],
+            BinaryPrimitives.ReadUInt16LittleEndian(payload[2..]),
+            BinaryPrimitives.ReadUInt16LittleEndian(payload[4..]),
+            BinaryPrimitives.ReadUInt16LittleEndian(payload[6..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[8..]),
+            BinaryPrimitives.ReadUInt16LittleEndian(payload[12..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[14..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[18..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[22..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[26..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[30..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[34..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[38..]));
+        return true;
+    }
+}
@@ -0,0 +1,275 @@
+using System.Buffers.Binary;
+
+namespace HidBridge.Transport.Uart;
+
+/// <summary>
+/// Selects the sections firmware includes in TELEMETRY frames (SUBSCRIBE mask).
+/// </summary>
+[Flags]
+public enum UartTelemetrySections : byte
+{
+    Interfaces = 0x01,
+    Link = 0x02,
+    Device = 0x04,
+    Control = 0x08,
+    All = Interfaces | Link | Device | Control,
+}
+
+/// <summary>
+/// Represents B_host counters for one proxied HID interface.
+/// </summary>
+/// <param name="Interface">Interface index.</param>
+/// <param name="Mounted">Whether the interface is mounted.</param>
+/// <param name="InputReady">Whether A_device acknowledged READY for the interface.</param>
+/// <param name="InputCount">Reports received from the physical device since mount.</param>
+/// <param name="InputSkippedNotReady">Reports not forwarded because the link was not ready.</param>
+/// <param name="SendMaxUs">Slowest link send since the previous frame (saturates at 0xFFFF).</param>
+/// <param name="SendHistogram">Link send times since the previous frame; bucket <c>i</c> is below <c>8 &lt;&lt; i</c> us, the last bucket is open-ended.</param>
+public sealed record UartTelemetryInterface(
+    byte Interface,
+    bool Mounted,
+    bool InputReady,
+    uint InputCount,
+    uint InputSkippedNotReady,
+    ushort SendMaxUs,
+    IReadOnlyList<ushort> SendHistogram);
+
+/// <summary>
+/// Represents the B_host side of the B_host to A_device link.
+/// </summary>
+/// <param name="TxFrames">Frames sent to A_device.</param>
+/// <param name="RxFrames">Frames received from A_device.</param>
+/// <param name="RxRingOverflow">Bytes dropped because the RX ring was full.</param>
+/// <param name="RxFrameOverflow">Frames dropped for exceeding the frame buffer.</param>
+/// <param name="CrcErrors">Frames rejected by CRC.</param>
+/// <param name="RxRingDepth">Bytes waiting in the RX ring.</param>
+/// <param name="RxRingHighWater">Maximum bytes ever queued in the RX ring.</param>
+/// <param name="InjectPending">Delayed INJECT_BATCH reports waiting in the schedule heap.</param>
+/// <param name="InjectDropped">Scheduled reports (SCHEDULE and INJECT_BATCH) that could not be sent when due.</param>
+public sealed record UartTelemetryLink(
+    uint TxFrames,
+    uint RxFrames,
+    uint RxRingOverflow,
+    uint RxFrameOverflow,
+    uint CrcErrors,
+    ushort RxRingDepth,
+    ushort RxRingHighWater,
+    byte InjectPending,
+    uint InjectDropped);
+
+/// <summary>
+/// Represents A_device counters tunnelled over the link.
+/// </summary>
+/// <param name="AgeMs">Age of the snapshot when the frame was built.</param>
+/// <param name="InputReceived">Input frames received from B_host.</param>
+/// <param name="InputDroppedNotReady">Input frames dropped before the PC enumerated.</param>
+/// <param name="LatencyMinMs">Minimum link latency in the current A_device log window.</param>
+/// <param name="LatencyMaxMs">Maximum link latency in the current A_device log window.</param>
+/// <param name="CrcErrors">Link frames rejected by CRC.</param>
+/// <param name="RxRingOverflow">Link RX ring bytes dropped.</param>
+/// <param name="RxFrameOverflow">Link frames dropped for exceeding the frame buffer.</param>
+/// <param name="RxRingHighWater">Maximum bytes ever queued in the link RX ring.</param>
+/// <param name="PendingReports">Reports waiting for the USB endpoint.</param>
+public sealed record UartTelemetryDevice(
+    uint AgeMs,
+    uint InputReceived,
+    uint InputDroppedNotReady,
+    uint LatencyMinMs,
+    uint LatencyMaxMs,
+    uint CrcErrors,
+    uint RxRingOverflow,
+    uint RxFrameOverflow,
+    uint RxRingHighWater,
+    byte PendingReports);
+
+/// <summary>
+/// Represents control UART counters.
+/// </summary>
+/// <param name="RxFrames">SLIP frames handed to the parser.</param>
+/// <param name="BadFrames">Frames with bad magic, version, length or CRC.</param>
+/// <param name="AuthFailures">Frames with a bad MAC.</param>
+/// <param name="RingOverflowBytes">Bytes dropped because the RX ring was full.</param>
+/// <param name="TxDroppedFrames">Responses dropped because the TX ring was full.</param>
+/// <param name="RingHighWater">Maximum bytes queued in the RX ring.</param>
+/// <param name="TxRingUsed">Bytes waiting in the TX ring.</param>
+public sealed record UartTelemetryControl(
+    uint RxFrames,
+    uint BadFrames,
+    uint AuthFailures,
+    uint RingOverflowBytes,
+    uint TxDroppedFrames,
+    ushort RingHighWater,
+    ushort TxRingUsed);
+
+/// <summary>
+/// Represents one decoded TELEMETRY frame.
+/// </summary>
+/// <param name="Seq">Frame counter since SUBSCRIBE; gaps mean frames were dropped.</param>
+/// <param name="TimeUs">B_host clock when the frame was built.</param>
+/// <param name="Sections">Sections requested by the subscription.</param>
+/// <param name="Interfaces">Active interfaces.</param>
+/// <param name="Link">Link counters when requested.</param>
+/// <param name="Device">A_device counters when requested and available.</param>
+/// <param name="Control">Control UART counters when requested.</param>
+/// <param name="More">The snapshot continues in the next frame (paged snapshot).</param>
+public sealed record UartTelemetryFrame(
+    ushort Seq,
+    uint TimeUs,
+    UartTelemetrySections Sections,
+    IReadOnlyList<UartTelemetryInterface> Interfaces,
+    UartTelemetryLink? Link,
+    UartTelemetryDevice? Device,
+    UartTelemetryControl? Control,
+    bool More = false);
+
+/// <summary>
+/// Decodes firmware TELEMETRY (0x0D) payloads pushed after SUBSCRIBE.
+/// </summary>
+public static class UartTelemetryDecoder
+{
+    /// <summary>
+    /// Buckets in the per-interface send-time histogram.
+    /// </summary>
+    public const int HistogramBuckets = 8;
+
+    /// <summary>
+    /// Smallest TELEMETRY payload; shorter 0x0D payloads are SUBSCRIBE responses.
+    /// </summary>
+    public const int HeaderLen = 7;
+
+    private const byte MoreFlag = 0x80;
+
+    private const int InterfaceLen = 28;
+    private const int LinkLen = 29;
+    private const int DeviceLen = 37;
+    private const int ControlLen = 24;
+
+    /// <summary>
+    /// Parses one TELEMETRY payload. Unknown and short sections are skipped.
+    /// </summary>
+    /// <param name="payload">Raw frame payload.</param>
+    /// <param name="frame">Decoded frame when parsing succeeds.</param>
+    /// <returns><c>true</c> when the header and section framing are well-formed.</returns>
+    public static bool TryParse(ReadOnlySpan<byte> payload, out UartTelemetryFrame frame)
+    {
+        frame = null!;
+        if (payload.Length < HeaderLen)
+        {
+            return false;
+        }
+
+        var interfaces = new List<UartTelemetryInterface>();
+        UartTelemetryLink? link = null;
+        UartTelemetryDevice? device = null;
+        UartTelemetryControl? control = null;
+
+        var pos = HeaderLen;
+        while (pos < payload.Length)
+        {
+            if (pos + 2 > payload.Length || pos + 2 + payload[pos + 1] > payload.Length)
+            {
+                return false;
+            }
+
+            var type = payload[pos];
+            var data = payload.Slice(pos + 2, payload[pos + 1]);
+            pos += 2 + data.Length;
+
+            switch ((UartTelemetrySections)type)
+            {
+                case UartTelemetrySections.Interfaces when data.Length >= InterfaceLen:
+                    var histogram = new ushort[HistogramBuckets];
+                    for (var i = 0; i < HistogramBuckets; i++)
+                    {
+                        histogram[i] = BinaryPrimitives.ReadUInt16LittleEndian(data[(12 + (i * 2))..]);
+                    }
+
+                    interfaces.Add(new UartTelemetryInterface(
+                        data[0],
+                        (data[1] & 0x01) != 0,
+                        (data[1] & 0x02) != 0,
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[2..]),
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[6..]),
+                        BinaryPrimitives.ReadUInt16LittleEndian(data[10..]),
+                        histogram));
+                    break;
+
+                case UartTelemetrySections.Link when data.Length >= LinkLen:
+                    link = new UartTelemetryLink(
+                        BinaryPrimitives.ReadUInt32LittleEndian(data),
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[4..]),
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[8..]),
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[12..]),
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[16..]),
+                        BinaryPrimitives.ReadUInt16LittleEndian(data[20..]),
+                        BinaryPrimitives.ReadUInt16LittleEndian(data[22..]),
+                        data[24],
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[25..]));
+                    break;
+
+                case UartTelemetrySections.Device when data.Length >= DeviceLen:
+                    device = new UartTelemetryDevice(
+                        BinaryPrimitives.ReadUInt32LittleEndian(data),
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[4..]),
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[8..]),
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[12..]),
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[16..]),
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[20..]),
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[24..]),
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[28..]),
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[32..]),
+                        data[36]);
+                    break;
+
+                case UartTelemetrySections.Control when data.Length >= ControlLen:
+                    control = new UartTelemetryControl(
+                        BinaryPrimitives.ReadUInt32LittleEndian(data),
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[4..]),
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[8..]),
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[12..]),
+                        BinaryPrimitives.ReadUInt32LittleEndian(data[16..]),
+                        BinaryPrimitives.ReadUInt16LittleEndian(data[20..]),
+                        BinaryPrimitives.ReadUInt16LittleEndian(data[22..]));
+                    break;
+            }
+        }
+
+        frame = new UartTelemetryFrame(
+            BinaryPrimitives.ReadUInt16LittleEndian(payload),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[2..]),
+            (UartTelemetrySections)(payload[6] & (byte)UartTelemetrySections.All),
+            interfaces,
+            link,
+            device,
+            control,
+            (payload[6] & MoreFlag) != 0);
+        return true;
+    }
+
+    /// <summary>
+    /// Appends the next page of a paged snapshot.
+    /// </summary>
+    /// <param name="head">Pages decoded so far; its <see cref="UartTelemetryFrame.More"/> is set.</param>
+    /// <param name="page">Next frame.</param>
+    /// <param name="merged">Combined snapshot when <paramref name="page"/> continues <paramref name="head"/>.</param>
+    /// <returns><c>true</c> when the page follows <paramref name="head"/> directly and shares its time stamp.</returns>
+    public static bool TryAppendPage(UartTelemetryFrame head, UartTelemetryFrame page, out UartTelemetryFrame merged)
+    {
+        merged = page;
+        if (!head.More || page.TimeUs != head.TimeUs || page.Seq != unchecked((ushort)(head.Seq + 1)))
+        {
+            return false;
+        }
+
+        merged = new UartTelemetryFrame(
+            page.Seq,
+            head.TimeUs,
+            head.Sections,
+            head.Interfaces.Concat(page.Interfaces).ToList(),
+            page.Link ?? head.Link,
+            page.Device ?? head.Device,
+            page.Control ?? head.Control,
+            page.More);
+        return true;
+    }
+}
@@ -0,0 +1,114 @@
+using System.Buffers.Binary;
+using System.Text;
+
+namespace HidBridge.Transport.Uart;
+
+/// <summary>
+/// Keyboard layout tables compiled into firmware for TYPE_TEXT.
+/// </summary>
+public enum UartKeyboardLayout : byte
+{
+    /// <summary>US QWERTY.</summary>
+    Us = 0,
+
+    /// <summary>Ukrainian (Enhanced); AltGr produces ґ/Ґ.</summary>
+    Ukrainian = 1,
+}
+
+/// <summary>
+/// Represents the TYPE_TEXT status and TYPE_EVENT payload.
+/// </summary>
+/// <param name="Active">Whether firmware is typing.</param>
+/// <param name="Queued">Keystrokes waiting.</param>
+/// <param name="Free">Keystrokes the firmware queue can still take.</param>
+/// <param name="IntervalUs">Report spacing.</param>
+/// <param name="Typed">Keystrokes typed since typing last started from idle.</param>
+/// <param name="Unmapped">Characters the layout cannot produce; firmware skips them.</param>
+/// <param name="Failed">Reports the link refused.</param>
+public sealed record HidBridgeUartTypeTextStatus(
+    bool Active,
+    int Queued,
+    int Free,
+    int IntervalUs,
+    uint Typed,
+    int Unmapped,
+    int Failed);
+
+/// <summary>
+/// Splits text into TYPE_TEXT (0x13) APPEND payloads and decodes status payloads.
+/// </summary>
+internal static class UartTextTyping
+{
+    internal const byte SubAppend = 0x01;
+    internal const byte SubCancel = 0x02;
+    internal const byte FlagReleaseEach = 0x01;
+    internal const byte FlagEvents = 0x02;
+    internal const byte ErrorQueueFull = 0x03;
+    internal const int MaxPayload = 240;
+    private const int HeaderLen = 6;
+    private const int StatusLen = 15;
+
+    /// <summary>
+    /// Splits UTF-8 text into as few APPEND payloads as fit the frame limit, never inside a character.
+    /// </summary>
+    /// <param name="text">Text to type.</param>
+    /// <param name="layout">Firmware layout table.</param>
+    /// <param name="interfaceSelector">Resolved keyboard interface.</param>
+    /// <param name="flags">APPEND flags.</param>
+    /// <param name="intervalUs">Report spacing; 0 uses the endpoint poll interval.</param>
+    /// <returns>One payload per TYPE_TEXT command.</returns>
+    internal static IReadOnlyList<byte[]> Pack(string text, UartKeyboardLayout layout, byte interfaceSelector, byte flags, ushort intervalUs)
+    {
+        var payloads = new List<byte[]>();
+        var current = new List<byte>(MaxPayload);
+        Span<byte> rune = stackalloc byte[4];
+        foreach (var r in text.EnumerateRunes())
+        {
+            var len = r.EncodeToUtf8(rune);
+            if (current.Count > 0 && current.Count + len > MaxPayload)
+            {
+                payloads.Add(current.ToArray());
+                current.Clear();
+            }
+
+            if (current.Count == 0)
+            {
+                current.AddRange(new byte[] { SubAppend, (byte)layout, interfaceSelector, flags, (byte)(intervalUs & 0xFF), (byte)(intervalUs >> 8) });
+            }
+
+            current.AddRange(rune[..len].ToArray());
+        }
+
+        if (current.Count > HeaderLen)
+        {
+            payloads.Add(current.ToArray());
+        }
+
+        return payloads;
+    }
+
+    /// <summary>
+    /// Parses a TYPE_TEXT status or TYPE_EVENT payload.
+    /// </summary>
+    /// <param name="payload">Raw response payload.</param>
+    /// <param name="status">Decoded status when parsing succeeds.</param>
+    /// <returns><c>true</c> when the payload is well-formed.</returns>
+    internal static bool TryParseStatus(ReadOnlySpan<byte> payload, out HidBridgeUartTypeTextStatus status)
+    {
+        status = null!;
+        if (payload.Length < StatusLen)
+        {
+            return false;
+        }
+
+        status = new HidBridgeUartTypeTextStatus(
+            payload[0] != 0,
+            BinaryPrimitives.ReadUInt16LittleEndian(payload[1..]),
+            BinaryPrimitives.ReadUInt16LittleEndian(payload[3..]),
+            BinaryPrimitives.ReadUInt16LittleEndian(payload[5..]),
+            BinaryPrimitives.ReadUInt32LittleEndian(payload[7..]),
+            BinaryPrimitives.ReadUInt16LittleEndian(payload[11..]),
+            BinaryPrimitives.ReadUInt16LittleEndian(payload[13..]));
+        return true;
+    }
+}
@@ -0,0 +1,98 @@
+using System.Buffers.Binary;
+using HidBridge.Transport.Uart;
+using Xunit;
+
+namespace HidBridge.Platform.Tests;
+
+/// <summary>
+/// Verifies GET_TRACE page decoding and enumeration phase derivation.
+/// </summary>
+public sealed class EnumTraceDecoderTests
+{
+    /// <summary>
+    /// Ensures one firmware page is decoded with header flags, clock offset and entries.
+    /// </summary>
+    [Fact]
+    public void TryParsePage_DecodesHeaderAndEntries()
+    {
+        var payload = BuildPage(total: 2, page: 0, flags: 0x01, offsetUs: -1234,
+            (0, 0, 1, 0x0000),
+            (5_000, 1, 8, 0x0000));
+
+        var ok = EnumTraceDecoder.TryParsePage(payload, out var page);
+
+        Assert.True(ok);
+        Assert.Equal(2, page.Total);
+        Assert.True(page.HasRemote);
+        Assert.False(page.Pending);
+        Assert.Equal(-1234, page.OffsetUs);
+        Assert.Equal(2, page.Events.Count);
+        Assert.Equal(EnumTraceEventKind.DeviceMounted, page.Events[1].Kind);
+        Assert.Equal(1, page.Events[1].Board);
+        Assert.Equal(5_000u, page.Events[1].TimeUs);
+    }
+
+    /// <summary>
+    /// Ensures pages whose declared entry count exceeds the payload are rejected.
+    /// </summary>
+    [Fact]
+    public void TryParsePage_TruncatedEntries_ReturnsFalse()
+    {
+        var payload = BuildPage(total: 1, page: 0, flags: 0, offsetUs: 0, (0, 0, 1, 0));
+
+        Assert.False(EnumTraceDecoder.TryParsePage(payload.AsSpan(0, payload.Length - 1), out _));
+    }
+
+    /// <summary>
+    /// Ensures critical-path phases are derived from the merged timeline and missing phases are skipped.
+    /// </summary>
+    [Fact]
+    public void ComputePhases_DerivesDescriptorAndLinkDurations()
+    {
+        var events = new[]
+        {
+            new EnumTraceEvent(0, 0, EnumTraceEventKind.Mount, 0),
+            new EnumTraceEvent(2_000, 0, EnumTraceEventKind.DescriptorFetched, 0x0100),
+            new EnumTraceEvent(5_000, 0, EnumTraceEventKind.DescriptorFetched, 0x0200),
+            new EnumTraceEvent(9_000, 0, EnumTraceEventKind.DescriptorFetched, 0x2201),
+            new EnumTraceEvent(9_500, 0, EnumTraceEventKind.DescriptorDoneSent, 0),
+            new EnumTraceEvent(10_000, 1, EnumTraceEventKind.DescriptorDoneReceived, 0),
+            new EnumTraceEvent(60_000, 0, EnumTraceEventKind.FirstInputSent, 0),
+            new EnumTraceEvent(61_000, 1, EnumTraceEventKind.FirstInputDelivered, 0),
+        };
+
+        var phases = EnumTraceDecoder.ComputePhases(events);
+
+        Assert.Equal(2_000u, phases.Single(p => p.Name == "B: device descriptor fetch").DurationUs);
+        Assert.Equal(3_000u, phases.Single(p => p.Name == "B: config descriptor fetch").DurationUs);
+        Assert.Equal(4_000u, phases.Single(p => p.Name == "B: report/string descriptor fetch").DurationUs);
+        Assert.Equal(500u, phases.Single(p => p.Name == "link: DONE").DurationUs);
+        Assert.Equal(61_000u, phases.Single(p => p.Name == "total: mount to first input delivered").DurationUs);
+        Assert.DoesNotContain(phases, p => p.Name == "link: READY");
+    }
+
+    private static byte[] BuildPage(
+        int total,
+        byte page,
+        byte flags,
+        int offsetUs,
+        params (uint TimeUs, byte Board, byte Event, ushort Arg)[] entries)
+    {
+        var payload = new byte[9 + (entries.Length * 8)];
+        BinaryPrimitives.WriteUInt16LittleEndian(payload, (ushort)total);
+        payload[2] = page;
+        payload[3] = flags;
+        payload[4] = (byte)entries.Length;
+        BinaryPrimitives.WriteInt32LittleEndian(payload.AsSpan(5), offsetUs);
+        for (var i = 0; i < entries.Length; i++)
+        {
+            var entry = payload.AsSpan(9 + (i * 8), 8);
+            BinaryPrimitives.WriteUInt32LittleEndian(entry, entries[i].TimeUs);
+            entry[4] = entries[i].Board;
+            entry[5] = entries[i].Event;
+            BinaryPrimitives.WriteUInt16LittleEndian(entry[6..], entries[i].Arg);
+        }
+
+        return payload;
+    }
+}
@@ -0,0 +1,50 @@
+using HidBridge.Transport.Uart;
+using Xunit;
+
+namespace HidBridge.Platform.Tests;
+
+/// <summary>
+/// Verifies CUMULATIVE_ACK payload decoding and failure lookup.
+/// </summary>
+public sealed class HidBridgeUartCumulativeAckTests
+{
+    /// <summary>
+    /// Ensures the payload is decoded and failure bits map to sequence numbers relative to the last one.
+    /// </summary>
+    [Fact]
+    public void TryParse_MapsFailureBitsToSequenceNumbers()
+    {
+        var payload = new byte[] { 0x10, 5, 0b0000_0101, 0, 0, 0, 0, 0, 0, 0 };
+
+        var ok = HidBridgeUartCumulativeAck.TryParse(payload, out var ack);
+
+        Assert.True(ok);
+        Assert.Equal(0x10, ack.LastSeq);
+        Assert.Equal(5, ack.Count);
+        Assert.True(ack.IsFailed(0x10));
+        Assert.False(ack.IsFailed(0x0F));
+        Assert.True(ack.IsFailed(0x0E));
+    }
+
+    /// <summary>
+    /// Ensures sequence numbers across the 8-bit wrap and outside the window are handled.
+    /// </summary>
+    [Fact]
+    public void IsFailed_HandlesWrapAndWindow()
+    {
+        var ack = new HidBridgeUartCumulativeAck(0x02, 4, 1UL << 3);
+
+        Assert.True(ack.IsFailed(0xFF));
+        Assert.False(ack.IsFailed(0x80));
+        Assert.False(ack.IsFailed(0x03));
+    }
+
+    /// <summary>
+    /// Ensures short payloads are rejected.
+    /// </summary>
+    [Fact]
+    public void TryParse_ShortPayload_ReturnsFalse()
+    {
+        Assert.False(HidBridgeUartCumulativeAck.TryParse(new byte[9], out _));
+    }
+}
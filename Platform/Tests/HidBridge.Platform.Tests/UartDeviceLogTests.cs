@@ -0,0 +1,45 @@
+using HidBridge.Transport.Uart;
+using Xunit;
+
+namespace HidBridge.Platform.Tests;
+
+/// <summary>
+/// Verifies LOG_READ request packing and response decoding.
+/// </summary>
+public sealed class UartDeviceLogTests
+{
+    /// <summary>
+    /// Ensures a plain read is empty and a mode switch is one byte.
+    /// </summary>
+    [Fact]
+    public void Pack_EncodesOptionalDrain()
+    {
+        Assert.Empty(UartDeviceLog.Pack(null));
+        Assert.Equal(new byte[] { 0x02 }, UartDeviceLog.Pack(UartLogDrain.Hold));
+    }
+
+    /// <summary>
+    /// Ensures the header decodes and entry words are passed through untouched.
+    /// </summary>
+    [Fact]
+    public void TryParse_DecodesHeaderAndEntries()
+    {
+        var payload = new byte[] { 2, 5, 0, 0, 0, 0x10, 0x00, 0x03, 0x03, 0x00, 0x00, 0xAA, 0xBB, 0xCC, 0xDD };
+
+        Assert.True(UartDeviceLog.TryParse(payload, out var chunk));
+        Assert.Equal(UartLogDrain.Hold, chunk.Drain);
+        Assert.Equal(5u, chunk.Dropped);
+        Assert.Equal(16, chunk.QueuedWords);
+        Assert.Equal(payload[7..], chunk.Entries);
+    }
+
+    /// <summary>
+    /// Ensures a short header or a partial word is rejected.
+    /// </summary>
+    [Fact]
+    public void TryParse_RejectsMalformedPayload()
+    {
+        Assert.False(UartDeviceLog.TryParse(new byte[6], out _));
+        Assert.False(UartDeviceLog.TryParse(new byte[9], out _));
+    }
+}
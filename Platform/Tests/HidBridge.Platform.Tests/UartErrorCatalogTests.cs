@@ -21,6 +21,20 @@ public sealed class UartErrorCatalogTests
         Assert.True(error.Retryable);
     }
 
+    [Fact]
+    /// <summary>
+    /// Verifies that a rejected session setup maps to its own non-retryable code.
+    /// </summary>
+    public void FromFirmwareCode_SessionKeyRejected_IsNotUnknown()
+    {
+        var error = UartErrorCatalog.FromFirmwareCode(0x05);
+
+        Assert.Equal(ErrorDomain.Uart, error.Domain);
+        Assert.Equal(UartErrorCatalog.UartSessionKeyRejected, error.Code);
+        Assert.DoesNotContain("unknown", error.Message);
+        Assert.False(error.Retryable);
+    }
+
     [Fact]
     /// <summary>
     /// Verifies that unknown firmware codes remain stable through formatted fallback error ids.
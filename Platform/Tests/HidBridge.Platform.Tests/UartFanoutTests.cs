@@ -0,0 +1,87 @@
+using HidBridge.Transport.Uart;
+using Xunit;
+
+namespace HidBridge.Platform.Tests;
+
+/// <summary>
+/// Verifies FANOUT request packing and response decoding.
+/// </summary>
+public sealed class UartFanoutTests
+{
+    /// <summary>
+    /// Ensures focus, route and resync requests carry their op codes.
+    /// </summary>
+    [Fact]
+    public void Pack_EncodesOps()
+    {
+        Assert.Equal(new byte[] { 0x00, 0x02 }, UartFanout.PackFocus(2));
+        Assert.Equal(new byte[] { 0x01, 0x03, 0x01 }, UartFanout.PackRoute(3, 1));
+        Assert.Equal(new byte[] { 0x02, 0x01 }, UartFanout.PackResync(1));
+    }
+
+    /// <summary>
+    /// Ensures a route without a target follows the focus.
+    /// </summary>
+    [Fact]
+    public void PackRoute_NullTargetFollowsFocus()
+    {
+        Assert.Equal(new byte[] { 0x01, 0x00, UartFanout.FollowFocus }, UartFanout.PackRoute(0, null));
+    }
+
+    /// <summary>
+    /// Ensures header, per-target counters and routes decode little-endian.
+    /// </summary>
+    [Fact]
+    public void TryParse_DecodesTargetsAndRoutes()
+    {
+        var payload = new byte[7 + 2 * 13 + 1 + 2];
+        payload[0] = 2;
+        payload[1] = 1;
+        payload[2] = 0x03;
+        payload[3] = 0x05;
+        payload[4] = 0x01;
+        payload[7] = 1;
+        payload[8] = 0x20;
+        payload[20] = 1;
+        payload[21] = 9;
+        payload[25] = 2;
+        payload[29] = 0x00;
+        payload[30] = 0x01;
+        payload[33] = 2;
+        payload[34] = UartFanout.FollowFocus;
+        payload[35] = 1;
+
+        Assert.True(UartFanout.TryParse(payload, out var state));
+        Assert.NotNull(state);
+        Assert.Equal(1, state!.Focus);
+        Assert.Equal(0x03, state.DescriptorScope);
+        Assert.Equal(0x105u, state.Switches);
+        Assert.Equal(2, state.Targets.Count);
+        Assert.True(state.Targets[0].Ready);
+        Assert.Equal(0x20u, state.Targets[0].TxFrames);
+        Assert.Equal(1, state.Targets[1].Index);
+        Assert.True(state.Targets[1].Ready);
+        Assert.Equal(9u, state.Targets[1].TxFrames);
+        Assert.Equal(2u, state.Targets[1].TxErrors);
+        Assert.Equal(0x100u, state.Targets[1].RxFrames);
+        Assert.Equal(new byte[] { UartFanout.FollowFocus, 1 }, state.Routes);
+    }
+
+    /// <summary>
+    /// Ensures a payload shorter than its target or route count is rejected.
+    /// </summary>
+    [Fact]
+    public void TryParse_RejectsTruncatedPayload()
+    {
+        var payload = new byte[7 + 13];
+        payload[0] = 1;
+
+        Assert.False(UartFanout.TryParse(payload, out _));
+
+        var missingRoutes = new byte[7 + 13 + 1];
+        missingRoutes[0] = 1;
+        missingRoutes[20] = 4;
+        Assert.False(UartFanout.TryParse(missingRoutes, out _));
+        Assert.False(UartFanout.TryParse(ReadOnlySpan<byte>.Empty, out _));
+    }
+}
@@ -75,4 +75,59 @@ public sealed class UartFrameCodecTests
         Assert.True(parsed.UsedAlternateHmacKey);
         Assert.Equal(0x80, parsed.Flags);
     }
+
+    /// <summary>
+    /// Ensures SipHash-2-4 matches the reference vectors used by firmware self-checks.
+    /// </summary>
+    [Fact]
+    public void SipHash24_MatchesReferenceVectors()
+    {
+        var key = Enumerable.Range(0, 16).Select(i => (byte)i).ToArray();
+        var message = Enumerable.Range(0, 15).Select(i => (byte)i).ToArray();
+
+        Assert.Equal(0x726fdb47dd0e0e31UL, SipHash24.Compute(key, ReadOnlySpan<byte>.Empty));
+        Assert.Equal(0xa129ca6149be45e5UL, SipHash24.Compute(key, message));
+    }
+
+    /// <summary>
+    /// Ensures one fast-MAC frame round-trips and carries its replay counter.
+    /// </summary>
+    [Fact]
+    public void BuildFastFrame_ThenParse_RoundTripsWithCounter()
+    {
+        var sessionKey = UartFrameCodec.DeriveSessionKey(
+            Encoding.UTF8.GetBytes("derived-key"),
+            new byte[UartFrameCodec.SessionNonceLen],
+            Enumerable.Repeat((byte)0xA5, UartFrameCodec.SessionNonceLen).ToArray());
+        var payload = new byte[] { 0x00, 0x04, 0x01, 0x02, 0x03, 0x04 };
+        var frame = UartFrameCodec.BuildFastFrame(seq: 0x11, cmd: 0x01, flags: 0x00, counter: 42, payload, sessionKey);
+
+        var ok = UartFrameCodec.TryParseFastFrame(frame, sessionKey, out var parsed, out var counter);
+
+        Assert.True(ok);
+        Assert.Equal(42u, counter);
+        Assert.Equal(0x11, parsed.Seq);
+        Assert.Equal(payload, parsed.Payload);
+        Assert.Equal(UartFrameCodec.FastHeaderLen + payload.Length + UartFrameCodec.CrcLen + UartFrameCodec.FastTagLen, frame.Length);
+    }
+
+    /// <summary>
+    /// Ensures fast-MAC frames are rejected under another session key or with a tampered counter.
+    /// </summary>
+    [Fact]
+    public void TryParseFastFrame_WrongKeyOrTamperedCounter_ReturnsFalse()
+    {
+        var sessionKey = Enumerable.Range(0, 16).Select(i => (byte)i).ToArray();
+        var otherKey = Enumerable.Range(1, 16).Select(i => (byte)i).ToArray();
+        var frame = UartFrameCodec.BuildFastFrame(seq: 0x01, cmd: 0x01, flags: 0x00, counter: 7, new byte[] { 0xAA }, sessionKey);
+
+        Assert.False(UartFrameCodec.TryParseFastFrame(frame, otherKey, out _, out _));
+
+        // Keep the CRC valid so only the tag can catch the change.
+        frame[6] = 8;
+        var crc = UartFrameCodec.ComputeCrc16Ccitt(frame.AsSpan(0, UartFrameCodec.FastHeaderLen + 1));
+        frame[UartFrameCodec.FastHeaderLen + 1] = (byte)(crc & 0xFF);
+        frame[UartFrameCodec.FastHeaderLen + 2] = (byte)(crc >> 8);
+        Assert.False(UartFrameCodec.TryParseFastFrame(frame, sessionKey, out _, out _));
+    }
 }
@@ -0,0 +1,55 @@
+using HidBridge.Transport.Uart;
+using Xunit;
+
+namespace HidBridge.Platform.Tests;
+
+/// <summary>
+/// Verifies INJECT_BATCH payload packing.
+/// </summary>
+public sealed class UartInjectBatchTests
+{
+    /// <summary>
+    /// Ensures tuples are encoded as itf, LE16 delay, length and report bytes after the count.
+    /// </summary>
+    [Fact]
+    public void Pack_EncodesTuplesInOrder()
+    {
+        var payloads = UartInjectBatch.Pack(new[]
+        {
+            new HidBridgeUartBatchReport(2, 0, new byte[] { 0x01, 0x05 }),
+            new HidBridgeUartBatchReport(3, 1000, new byte[] { 0x00 }),
+        });
+
+        var payload = Assert.Single(payloads);
+        Assert.Equal(new byte[] { 2, 2, 0x00, 0x00, 2, 0x01, 0x05, 3, 0xE8, 0x03, 1, 0x00 }, payload);
+    }
+
+    /// <summary>
+    /// Ensures batches larger than one frame are split without reordering reports.
+    /// </summary>
+    [Fact]
+    public void Pack_SplitsAtFrameLimit()
+    {
+        var reports = Enumerable.Range(0, 30)
+            .Select(i => new HidBridgeUartBatchReport(1, 125, new byte[] { (byte)i, 0, 0, 0, 0, 0, 0, 0 }))
+            .ToArray();
+
+        var payloads = UartInjectBatch.Pack(reports);
+
+        Assert.Equal(2, payloads.Count);
+        Assert.All(payloads, p => Assert.True(p.Length <= UartInjectBatch.MaxPayload));
+        Assert.Equal(19, payloads[0][0]);
+        Assert.Equal(11, payloads[1][0]);
+        Assert.Equal(19, payloads[1][1 + UartInjectBatch.TupleHeaderLen]);
+    }
+
+    /// <summary>
+    /// Ensures empty reports are rejected before anything is sent.
+    /// </summary>
+    [Fact]
+    public void Pack_EmptyReport_Throws()
+    {
+        Assert.Throws<InvalidOperationException>(() =>
+            UartInjectBatch.Pack(new[] { new HidBridgeUartBatchReport(1, 0, Array.Empty<byte>()) }));
+    }
+}
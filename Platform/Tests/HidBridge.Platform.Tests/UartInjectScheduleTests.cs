@@ -0,0 +1,76 @@
+using System.Buffers.Binary;
+using HidBridge.Transport.Uart;
+using Xunit;
+
+namespace HidBridge.Platform.Tests;
+
+/// <summary>
+/// Verifies SCHEDULE payload packing and STATS decoding.
+/// </summary>
+public sealed class UartInjectScheduleTests
+{
+    /// <summary>
+    /// Ensures ADD carries subcommand, flags and tag, then due, itf, length and report per tuple.
+    /// </summary>
+    [Fact]
+    public void Pack_EncodesHeaderAndTuples()
+    {
+        var payloads = UartInjectSchedule.Pack(new[]
+        {
+            new HidBridgeUartScheduledReport(2, 20_000, new byte[] { 0x01, 0x05 }),
+            new HidBridgeUartScheduledReport(2, 28_000, new byte[] { 0x00 }),
+        }, tag: 0x1234, absolute: false);
+
+        var payload = Assert.Single(payloads);
+        Assert.Equal(
+            new byte[] { 0x01, 0x00, 0x34, 0x12, 0x20, 0x4E, 0, 0, 2, 2, 0x01, 0x05, 0x60, 0x6D, 0, 0, 2, 1, 0x00 },
+            payload);
+    }
+
+    /// <summary>
+    /// Ensures long streams are split at the frame limit and every chunk repeats the header.
+    /// </summary>
+    [Fact]
+    public void Pack_SplitsAtFrameLimit()
+    {
+        var reports = Enumerable.Range(0, 40)
+            .Select(i => new HidBridgeUartScheduledReport(1, (uint)(i * 1000), new byte[8]))
+            .ToArray();
+
+        var payloads = UartInjectSchedule.Pack(reports, tag: 7, absolute: true);
+
+        Assert.Equal(3, payloads.Count);
+        Assert.All(payloads, p =>
+        {
+            Assert.True(p.Length <= UartInjectSchedule.MaxPayload);
+            Assert.Equal(new byte[] { 0x01, 0x01, 7, 0 }, p[..4]);
+        });
+        Assert.Equal(39_000u, BinaryPrimitives.ReadUInt32LittleEndian(payloads[2].AsSpan(payloads[2].Length - 14)));
+    }
+
+    /// <summary>
+    /// Ensures the STATS response exposes queue depth, clock and lateness counters.
+    /// </summary>
+    [Fact]
+    public void TryParseStats_DecodesCounters()
+    {
+        var payload = new byte[43];
+        payload[0] = 5;
+        payload[1] = 32;
+        payload[2] = 17;
+        BinaryPrimitives.WriteUInt32LittleEndian(payload.AsSpan(3), 123_456_789);
+        BinaryPrimitives.WriteUInt32LittleEndian(payload.AsSpan(11), 900);
+        BinaryPrimitives.WriteUInt32LittleEndian(payload.AsSpan(31), 42);
+        BinaryPrimitives.WriteUInt32LittleEndian(payload.AsSpan(35), 6);
+
+        Assert.True(UartInjectSchedule.TryParseStats(payload, out var stats));
+        Assert.Equal(5, stats.Pending);
+        Assert.Equal(32, stats.Depth);
+        Assert.Equal(17, stats.HighWater);
+        Assert.Equal(123_456_789u, stats.NowUs);
+        Assert.Equal(900u, stats.Sent);
+        Assert.Equal(42u, stats.LateMaxUs);
+        Assert.Equal(6u, stats.LateMeanUs);
+        Assert.False(UartInjectSchedule.TryParseStats(payload.AsSpan(0, 42), out _));
+    }
+}
@@ -0,0 +1,62 @@
+using HidBridge.Transport.Uart;
+using Xunit;
+
+namespace HidBridge.Platform.Tests;
+
+/// <summary>
+/// Verifies MIX request packing and response decoding.
+/// </summary>
+public sealed class UartInputMixerTests
+{
+    /// <summary>
+    /// Ensures a set request carries the selector and the policy.
+    /// </summary>
+    [Fact]
+    public void Pack_EncodesSelectorAndPolicy()
+    {
+        Assert.Equal(new byte[] { 0xFD, 0x04 }, UartInputMixer.Pack(UartInputMixer.AllInterfaces, UartMixPolicy.InjectedOnly));
+    }
+
+    /// <summary>
+    /// Ensures interface slots decode with little-endian counters.
+    /// </summary>
+    [Fact]
+    public void TryParse_DecodesSlots()
+    {
+        var payload = new byte[1 + 2 * 20];
+        payload[0] = 2;
+        payload[21] = 1;
+        payload[22] = (byte)UartMixPolicy.Merge;
+        payload[23] = 0x40;
+        payload[24] = 0x1F;
+        payload[25] = 7;
+        payload[29] = 3;
+        payload[33] = 0x10;
+        payload[34] = 0x01;
+        payload[37] = 2;
+
+        Assert.True(UartInputMixer.TryParse(payload, out var states));
+        Assert.Equal(2, states.Count);
+        Assert.Equal(UartMixPolicy.Off, states[0].Policy);
+        Assert.Equal(1, states[1].Interface);
+        Assert.Equal(UartMixPolicy.Merge, states[1].Policy);
+        Assert.Equal(8000, states[1].IntervalUs);
+        Assert.Equal(7u, states[1].PhysicalIn);
+        Assert.Equal(3u, states[1].InjectedIn);
+        Assert.Equal(0x110u, states[1].MergedOut);
+        Assert.Equal(2u, states[1].Suppressed);
+    }
+
+    /// <summary>
+    /// Ensures a payload shorter than its slot count is rejected.
+    /// </summary>
+    [Fact]
+    public void TryParse_RejectsTruncatedPayload()
+    {
+        var payload = new byte[1 + 20];
+        payload[0] = 2;
+
+        Assert.False(UartInputMixer.TryParse(payload, out _));
+        Assert.False(UartInputMixer.TryParse(ReadOnlySpan<byte>.Empty, out _));
+    }
+}
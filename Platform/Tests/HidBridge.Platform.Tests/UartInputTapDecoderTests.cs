@@ -0,0 +1,82 @@
+using System.Buffers.Binary;
+using HidBridge.Transport.Uart;
+using Xunit;
+
+namespace HidBridge.Platform.Tests;
+
+/// <summary>
+/// Verifies TAP response and TAP_DATA frame decoding.
+/// </summary>
+public sealed class UartInputTapDecoderTests
+{
+    /// <summary>
+    /// Ensures entries keep their timestamp, capture sequence, flags and report bytes.
+    /// </summary>
+    [Fact]
+    public void TryParseFrame_DecodesEntries()
+    {
+        var payload = new List<byte> { 2, 5, 0, 40, 0 };
+        payload.AddRange(BitConverter.GetBytes(3u));
+        AddEntry(payload, 1_000, 10, 0, 0x01, new byte[] { 0x01, 0x05, 0xFB, 0x00 });
+        AddEntry(payload, 9_000, 14, 1, 0x00, new byte[] { 0x00, 0x00, 0x04 });
+
+        var ok = UartInputTapDecoder.TryParseFrame(payload.ToArray(), out var frame);
+
+        Assert.True(ok);
+        Assert.Equal(5, frame.Used);
+        Assert.Equal(40, frame.HighWater);
+        Assert.Equal(3u, frame.Dropped);
+        Assert.Equal(2, frame.Entries.Count);
+        Assert.True(frame.Entries[0].Forwarded);
+        Assert.Equal(new byte[] { 0x01, 0x05, 0xFB, 0x00 }, frame.Entries[0].Report);
+        Assert.False(frame.Entries[1].Forwarded);
+        Assert.Equal(14, frame.Entries[1].Seq);
+        Assert.Equal(9_000u, frame.Entries[1].TimeUs);
+        Assert.Equal(1, frame.Entries[1].Interface);
+    }
+
+    /// <summary>
+    /// Ensures a frame whose last entry is cut short is rejected.
+    /// </summary>
+    [Fact]
+    public void TryParseFrame_TruncatedEntry_ReturnsFalse()
+    {
+        var payload = new List<byte> { 1, 0, 0, 1, 0, 0, 0, 0, 0 };
+        AddEntry(payload, 0, 0, 0, 0x01, new byte[] { 1, 2, 3 });
+
+        Assert.False(UartInputTapDecoder.TryParseFrame(payload.ToArray().AsSpan(0, payload.Count - 1), out _));
+    }
+
+    /// <summary>
+    /// Ensures the TAP response exposes mode, high-water mark and loss counters.
+    /// </summary>
+    [Fact]
+    public void TryParseStats_DecodesCounters()
+    {
+        var payload = new byte[23];
+        payload[0] = 2;
+        BinaryPrimitives.WriteUInt16LittleEndian(payload.AsSpan(1), 64);
+        BinaryPrimitives.WriteUInt16LittleEndian(payload.AsSpan(5), 61);
+        BinaryPrimitives.WriteUInt32LittleEndian(payload.AsSpan(7), 1_000);
+        BinaryPrimitives.WriteUInt32LittleEndian(payload.AsSpan(15), 12);
+
+        Assert.True(UartInputTapDecoder.TryParseStats(payload, out var stats));
+        Assert.Equal(UartInputTapMode.DropNewest, stats.Mode);
+        Assert.Equal(64, stats.Depth);
+        Assert.Equal(61, stats.HighWater);
+        Assert.Equal(1_000u, stats.Captured);
+        Assert.Equal(12u, stats.DroppedNewest);
+    }
+
+    private static void AddEntry(List<byte> payload, uint timeUs, ushort seq, byte itf, byte flags, byte[] report)
+    {
+        var header = new byte[9];
+        BinaryPrimitives.WriteUInt32LittleEndian(header, timeUs);
+        BinaryPrimitives.WriteUInt16LittleEndian(header.AsSpan(4), seq);
+        header[6] = itf;
+        header[7] = flags;
+        header[8] = (byte)report.Length;
+        payload.AddRange(header);
+        payload.AddRange(report);
+    }
+}
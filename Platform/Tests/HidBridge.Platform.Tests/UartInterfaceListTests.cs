@@ -0,0 +1,62 @@
+using HidBridge.Transport.Uart;
+using Xunit;
+
+namespace HidBridge.Platform.Tests;
+
+/// <summary>
+/// Verifies LIST_INTERFACES decoding for legacy and hub-aggregating firmware.
+/// </summary>
+public sealed class UartInterfaceListTests
+{
+    /// <summary>
+    /// Ensures a payload without the trailing block still decodes.
+    /// </summary>
+    [Fact]
+    public void ParseInterfaceList_LegacyPayload_LeavesPhysicalItfEmpty()
+    {
+        var payload = new byte[] { 1, 5, 0, 1, 1, 1, 1, 1 };
+
+        var list = HidBridgeUartClient.ParseInterfaceList(payload);
+
+        Assert.NotNull(list);
+        var item = Assert.Single(list!.Interfaces);
+        Assert.Equal(5, item.DevAddr);
+        Assert.Equal(0, item.Itf);
+        Assert.True(item.Active);
+        Assert.Null(item.PhysicalItf);
+    }
+
+    /// <summary>
+    /// Ensures the trailing block fills in each entry's physical interface.
+    /// </summary>
+    [Fact]
+    public void ParseInterfaceList_TrailingBlock_MapsCompositeToPhysicalItf()
+    {
+        var payload = new byte[]
+        {
+            2,
+            5, 0, 1, 1, 1, 1, 1,
+            7, 1, 2, 1, 2, 1, 1,
+            0, 1,
+        };
+
+        var list = HidBridgeUartClient.ParseInterfaceList(payload);
+
+        Assert.NotNull(list);
+        Assert.Equal(2, list!.Interfaces.Count);
+        Assert.Equal((byte)0, list.Interfaces[0].PhysicalItf);
+        Assert.Equal(7, list.Interfaces[1].DevAddr);
+        Assert.Equal(1, list.Interfaces[1].Itf);
+        Assert.Equal((byte)1, list.Interfaces[1].PhysicalItf);
+    }
+
+    /// <summary>
+    /// Ensures a missing or empty payload yields no list.
+    /// </summary>
+    [Fact]
+    public void ParseInterfaceList_EmptyPayload_ReturnsNull()
+    {
+        Assert.Null(HidBridgeUartClient.ParseInterfaceList(Array.Empty<byte>()));
+        Assert.Null(HidBridgeUartClient.ParseInterfaceList(null));
+    }
+}
@@ -0,0 +1,49 @@
+using HidBridge.Transport.Uart;
+using Xunit;
+
+namespace HidBridge.Platform.Tests;
+
+/// <summary>
+/// Verifies KEY request packing and state decoding.
+/// </summary>
+public sealed class UartKeyStateTests
+{
+    /// <summary>
+    /// Ensures a KEY_DOWN carries op, interface and usages, so Ctrl+Alt+Del fits five bytes.
+    /// </summary>
+    [Fact]
+    public void Pack_EncodesCtrlAltDel()
+    {
+        var payload = UartKeyState.Pack(UartKeyState.OpKeyDown, 2, new byte[] { 0xE0, 0xE2, 0x4C });
+
+        Assert.Equal(new byte[] { 0x01, 2, 0xE0, 0xE2, 0x4C }, payload);
+    }
+
+    /// <summary>
+    /// Ensures injected and physical key lists decode from their counted sections.
+    /// </summary>
+    [Fact]
+    public void TryParseState_DecodesInjectedAndPhysical()
+    {
+        var payload = new byte[] { 2, 0x05, 0x00, 1, 0x4C, 0x02, 0x00, 2, 0x04, 0x05 };
+
+        Assert.True(UartKeyState.TryParseState(payload, out var state));
+        Assert.Equal(2, state.Interface);
+        Assert.Equal(0x05, state.InjectedModifiers);
+        Assert.Equal(new byte[] { 0x4C }, state.InjectedKeys);
+        Assert.Equal(0x02, state.PhysicalModifiers);
+        Assert.Equal(new byte[] { 0x04, 0x05 }, state.PhysicalKeys);
+    }
+
+    /// <summary>
+    /// Ensures a payload cut inside a key list is rejected.
+    /// </summary>
+    [Fact]
+    public void TryParseState_RejectsTruncatedPayload()
+    {
+        var payload = new byte[] { 2, 0x00, 0x00, 1, 0x4C, 0x00, 0x00, 2, 0x04 };
+
+        Assert.False(UartKeyState.TryParseState(payload, out _));
+        Assert.False(UartKeyState.TryParseState(payload.AsSpan(0, 3), out _));
+    }
+}
@@ -0,0 +1,77 @@
+using HidBridge.Transport.Uart;
+using Xunit;
+
+namespace HidBridge.Platform.Tests;
+
+/// <summary>
+/// Verifies GET_METRICS request packing and response decoding.
+/// </summary>
+public sealed class UartMetricsTests
+{
+    /// <summary>
+    /// Ensures the request carries board and start index.
+    /// </summary>
+    [Fact]
+    public void Pack_EncodesBoardAndStart()
+    {
+        Assert.Equal(new byte[] { 0x01, 0x05 }, UartMetrics.Pack(UartMetricsBoard.ADevice, 5));
+    }
+
+    /// <summary>
+    /// Ensures bucket bounds follow the firmware's log-linear layout.
+    /// </summary>
+    [Theory]
+    [InlineData(0, 0UL)]
+    [InlineData(7, 7UL)]
+    [InlineData(8, 8UL)]
+    [InlineData(11, 14UL)]
+    [InlineData(12, 16UL)]
+    [InlineData(63, 114688UL)]
+    public void BucketLowerBound_MatchesFirmware(int bucket, ulong expected)
+    {
+        Assert.Equal(expected, UartMetrics.BucketLowerBound(bucket));
+    }
+
+    /// <summary>
+    /// Ensures counters, gauges and a sparse histogram decode.
+    /// </summary>
+    [Fact]
+    public void TryParse_DecodesAllKinds()
+    {
+        var payload = new List<byte> { 0, 3, 0, 3, 0, 0, 0, 0 };
+        payload.AddRange(new byte[] { 0, 1, (byte)'c', 0xC9, 0x01 });
+        payload.AddRange(new byte[] { 1, 1, (byte)'g', 0xAC, 0x02 });
+        // count 12, sum 1000, min 3, max 900; buckets 3..35, only the ends used.
+        payload.AddRange(new byte[] { 2, 1, (byte)'h', 12, 0xE8, 0x07, 3, 0x84, 0x07, 3, 33, 10 });
+        payload.AddRange(new byte[31]);
+        payload.Add(2);
+
+        Assert.True(UartMetrics.TryParse(payload.ToArray(), out var page));
+        Assert.Equal(UartMetricsBoard.BHost, page.Board);
+        Assert.Equal(3, page.Total);
+        Assert.Equal(0u, page.AgeMs);
+        Assert.Equal(201UL, page.Metrics[0].Value);
+        Assert.Equal(UartMetricKind.Gauge, page.Metrics[1].Kind);
+        Assert.Equal(300UL, page.Metrics[1].Value);
+
+        var hist = page.Metrics[2].Histogram!;
+        Assert.Equal(12UL, hist.Count);
+        Assert.Equal(900UL, hist.Max);
+        Assert.Equal(2, hist.Buckets.Count);
+        Assert.Equal(new HidBridgeUartHistogramBucket(3, 10), hist.Buckets[0]);
+        Assert.Equal(new HidBridgeUartHistogramBucket(896, 2), hist.Buckets[1]);
+        Assert.Equal(3UL, hist.Percentile(0.5));
+        Assert.Equal(896UL, hist.Percentile(0.99));
+    }
+
+    /// <summary>
+    /// Ensures a truncated metric or trailing bytes are rejected.
+    /// </summary>
+    [Fact]
+    public void TryParse_RejectsMalformedPayload()
+    {
+        Assert.False(UartMetrics.TryParse(new byte[7], out _));
+        Assert.False(UartMetrics.TryParse(new byte[] { 0, 1, 0, 1, 0, 0, 0, 0, 0, 1, (byte)'c', 0x80 }, out _));
+        Assert.False(UartMetrics.TryParse(new byte[] { 0, 0, 0, 0, 0, 0, 0, 0, 0xFF }, out _));
+    }
+}
@@ -0,0 +1,48 @@
+using HidBridge.Transport.Uart;
+using Xunit;
+
+namespace HidBridge.Platform.Tests;
+
+/// <summary>
+/// Verifies MOVE request packing and status decoding.
+/// </summary>
+public sealed class UartPointerMoveTests
+{
+    /// <summary>
+    /// Ensures the request carries mode, selector, buttons, signed axes and pacing in firmware order.
+    /// </summary>
+    [Fact]
+    public void Pack_EncodesMoveTo()
+    {
+        var payload = UartPointerMove.Pack(new HidBridgeUartPointerMove(
+            2, X: -300, Y: 500, Absolute: true, Buttons: 0x01, Wheel: -1, MaxStep: 10, ScaleQ8: 0x0180, IntervalUs: 1000));
+
+        Assert.Equal(
+            new byte[] { 0x01, 2, 0x01, 0xD4, 0xFE, 0xF4, 0x01, 0xFF, 10, 0x80, 0x01, 0xE8, 0x03 },
+            payload);
+    }
+
+    /// <summary>
+    /// Ensures relative motion uses mode 0 and zero defaults.
+    /// </summary>
+    [Fact]
+    public void Pack_DefaultsToMoveBy()
+    {
+        var payload = UartPointerMove.Pack(new HidBridgeUartPointerMove(1, 5, 0));
+
+        Assert.Equal(new byte[] { 0x00, 1, 0, 5, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, payload);
+    }
+
+    /// <summary>
+    /// Ensures the status response decodes and a short payload is rejected.
+    /// </summary>
+    [Fact]
+    public void TryParseStatus_DecodesFields()
+    {
+        var payload = new byte[] { 1, 0x22, 0x00, 0x40, 0x1F, 0x0A, 0, 0, 0, 0x02, 0, 0, 0 };
+
+        Assert.True(UartPointerMove.TryParseStatus(payload, out var status));
+        Assert.Equal(new HidBridgeUartMoveStatus(true, 0x22, 8000, 10, 2), status);
+        Assert.False(UartPointerMove.TryParseStatus(payload.AsSpan(0, 12), out _));
+    }
+}
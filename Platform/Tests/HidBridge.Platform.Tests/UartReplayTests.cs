@@ -0,0 +1,88 @@
+using System.Buffers.Binary;
+using HidBridge.Transport.Uart;
+using Xunit;
+
+namespace HidBridge.Platform.Tests;
+
+/// <summary>
+/// Verifies replay sequence encoding and REPLAY status decoding.
+/// </summary>
+public sealed class UartReplayTests
+{
+    /// <summary>
+    /// Ensures a packed sequence decodes back to the same entries.
+    /// </summary>
+    [Fact]
+    public void Pack_RoundTripsThroughTryUnpack()
+    {
+        var entries = new[]
+        {
+            new UartReplayEntry(0, 1, new byte[] { 0x00, 0x05, 0xFB, 0x00 }),
+            new UartReplayEntry(8_000, 1, new byte[] { 0x00, 0x05, 0xFB, 0x00 }),
+            new UartReplayEntry(8_000, 0, new byte[] { 0x00, 0x00, 0x04, 0, 0, 0, 0, 0 }),
+        };
+
+        var image = UartReplay.Pack(entries);
+
+        Assert.Equal(3 * 6 + 4 + 4 + 8, image.Length);
+        Assert.Equal(8_000u, BinaryPrimitives.ReadUInt32LittleEndian(image.AsSpan(10)));
+        Assert.True(UartReplay.TryUnpack(image, out var decoded));
+        Assert.Equal(3, decoded.Count);
+        Assert.Equal(0, decoded[2].Interface);
+        Assert.Equal(entries[2].Report, decoded[2].Report);
+    }
+
+    /// <summary>
+    /// Ensures firmware-incompatible sequences are rejected before upload.
+    /// </summary>
+    [Fact]
+    public void Pack_RejectsDecreasingTimesAndOversizedReports()
+    {
+        Assert.Throws<InvalidOperationException>(() => UartReplay.Pack(new[]
+        {
+            new UartReplayEntry(10, 0, new byte[] { 1 }),
+            new UartReplayEntry(5, 0, new byte[] { 1 }),
+        }));
+        Assert.Throws<InvalidOperationException>(() => UartReplay.Pack(new[]
+        {
+            new UartReplayEntry(0, 0, new byte[65]),
+        }));
+    }
+
+    /// <summary>
+    /// Ensures a buffer cut inside an entry is reported as malformed.
+    /// </summary>
+    [Fact]
+    public void TryUnpack_PartialEntry_ReturnsFalse()
+    {
+        var image = UartReplay.Pack(new[] { new UartReplayEntry(0, 0, new byte[] { 1, 2, 3 }) });
+
+        Assert.False(UartReplay.TryUnpack(image.AsSpan(0, image.Length - 1), out _));
+    }
+
+    /// <summary>
+    /// Ensures the status response exposes state, buffer usage and playback timing.
+    /// </summary>
+    [Fact]
+    public void TryParseStatus_DecodesTimingCounters()
+    {
+        var payload = new byte[42];
+        payload[0] = 2;
+        BinaryPrimitives.WriteUInt16LittleEndian(payload.AsSpan(2), 120);
+        BinaryPrimitives.WriteUInt16LittleEndian(payload.AsSpan(6), 32768);
+        BinaryPrimitives.WriteUInt32LittleEndian(payload.AsSpan(8), 1_000_000);
+        BinaryPrimitives.WriteUInt32LittleEndian(payload.AsSpan(14), 360);
+        BinaryPrimitives.WriteUInt32LittleEndian(payload.AsSpan(26), 74);
+        BinaryPrimitives.WriteUInt32LittleEndian(payload.AsSpan(34), 1);
+
+        Assert.True(UartReplay.TryParseStatus(payload, out var status));
+        Assert.Equal(UartReplayState.Playing, status.State);
+        Assert.Equal(120, status.Events);
+        Assert.Equal(32768, status.Size);
+        Assert.Equal(1_000_000u, status.DurationUs);
+        Assert.Equal(360u, status.Sent);
+        Assert.Equal(74u, status.LateMaxUs);
+        Assert.Equal(1u, status.Overruns);
+        Assert.False(UartReplay.TryParseStatus(payload.AsSpan(0, 41), out _));
+    }
+}
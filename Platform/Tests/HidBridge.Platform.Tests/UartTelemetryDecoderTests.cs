@@ -0,0 +1,131 @@
+using System.Buffers.Binary;
+using HidBridge.Transport.Uart;
+using Xunit;
+
+namespace HidBridge.Platform.Tests;
+
+/// <summary>
+/// Verifies TELEMETRY frame decoding.
+/// </summary>
+public sealed class UartTelemetryDecoderTests
+{
+    /// <summary>
+    /// Ensures the header, interface histogram and tunnelled A_device section are decoded.
+    /// </summary>
+    [Fact]
+    public void TryParse_DecodesInterfaceAndDeviceSections()
+    {
+        var itf = new byte[28];
+        itf[0] = 1;
+        itf[1] = 0x03;
+        BinaryPrimitives.WriteUInt32LittleEndian(itf.AsSpan(2), 500);
+        BinaryPrimitives.WriteUInt32LittleEndian(itf.AsSpan(6), 7);
+        BinaryPrimitives.WriteUInt16LittleEndian(itf.AsSpan(10), 40);
+        BinaryPrimitives.WriteUInt16LittleEndian(itf.AsSpan(12 + (3 * 2)), 12);
+
+        var device = new byte[37];
+        BinaryPrimitives.WriteUInt32LittleEndian(device, 25);
+        BinaryPrimitives.WriteUInt32LittleEndian(device.AsSpan(4), 480);
+        device[36] = 2;
+
+        var payload = BuildFrame(seq: 0x0102, timeUs: 123_456, mask: 0x05, (0x01, itf), (0x04, device));
+
+        var ok = UartTelemetryDecoder.TryParse(payload, out var frame);
+
+        Assert.True(ok);
+        Assert.Equal(0x0102, frame.Seq);
+        Assert.Equal(123_456u, frame.TimeUs);
+        Assert.Equal(UartTelemetrySections.Interfaces | UartTelemetrySections.Device, frame.Sections);
+        var decoded = Assert.Single(frame.Interfaces);
+        Assert.True(decoded.Mounted);
+        Assert.True(decoded.InputReady);
+        Assert.Equal(500u, decoded.InputCount);
+        Assert.Equal(7u, decoded.InputSkippedNotReady);
+        Assert.Equal(40, decoded.SendMaxUs);
+        Assert.Equal(12, decoded.SendHistogram[3]);
+        Assert.NotNull(frame.Device);
+        Assert.Equal(25u, frame.Device!.AgeMs);
+        Assert.Equal(480u, frame.Device.InputReceived);
+        Assert.Equal(2, frame.Device.PendingReports);
+        Assert.Null(frame.Link);
+    }
+
+    /// <summary>
+    /// Ensures unknown section types are skipped by their length.
+    /// </summary>
+    [Fact]
+    public void TryParse_SkipsUnknownSections()
+    {
+        var control = new byte[24];
+        BinaryPrimitives.WriteUInt32LittleEndian(control.AsSpan(16), 3);
+        var payload = BuildFrame(seq: 1, timeUs: 0, mask: 0x08, (0x40, new byte[5]), (0x08, control));
+
+        Assert.True(UartTelemetryDecoder.TryParse(payload, out var frame));
+        Assert.Equal(3u, frame.Control!.TxDroppedFrames);
+    }
+
+    /// <summary>
+    /// Ensures a section running past the payload is rejected.
+    /// </summary>
+    [Fact]
+    public void TryParse_TruncatedSection_ReturnsFalse()
+    {
+        var payload = BuildFrame(seq: 1, timeUs: 0, mask: 0x02, (0x02, new byte[29]));
+
+        Assert.False(UartTelemetryDecoder.TryParse(payload.AsSpan(0, payload.Length - 1), out _));
+    }
+
+    /// <summary>
+    /// Ensures the paging bit is reported separately from the section mask.
+    /// </summary>
+    [Fact]
+    public void TryParse_MoreBit_IsNotASection()
+    {
+        var payload = BuildFrame(seq: 4, timeUs: 9, mask: 0x8F, (0x01, new byte[28]));
+
+        Assert.True(UartTelemetryDecoder.TryParse(payload, out var frame));
+        Assert.True(frame.More);
+        Assert.Equal(UartTelemetrySections.All, frame.Sections);
+    }
+
+    /// <summary>
+    /// Ensures consecutive pages of one snapshot merge and a page from another snapshot does not.
+    /// </summary>
+    [Fact]
+    public void TryAppendPage_MergesConsecutivePages()
+    {
+        var itf = new byte[28];
+        itf[0] = 1;
+        Assert.True(UartTelemetryDecoder.TryParse(BuildFrame(seq: 0xFFFF, timeUs: 77, mask: 0x8B, (0x01, itf)), out var head));
+        itf[0] = 2;
+        var tail = BuildFrame(seq: 0, timeUs: 77, mask: 0x0B, (0x01, itf), (0x02, new byte[29]), (0x08, new byte[24]));
+        Assert.True(UartTelemetryDecoder.TryParse(tail, out var page));
+
+        Assert.True(UartTelemetryDecoder.TryAppendPage(head, page, out var merged));
+        Assert.False(merged.More);
+        Assert.Equal(new byte[] { 1, 2 }, merged.Interfaces.Select(i => i.Interface));
+        Assert.NotNull(merged.Link);
+        Assert.NotNull(merged.Control);
+
+        Assert.True(UartTelemetryDecoder.TryParse(BuildFrame(seq: 0, timeUs: 78, mask: 0x0B), out var other));
+        Assert.False(UartTelemetryDecoder.TryAppendPage(head, other, out _));
+    }
+
+    private static byte[] BuildFrame(ushort seq, uint timeUs, byte mask, params (byte Type, byte[] Data)[] sections)
+    {
+        var header = new byte[UartTelemetryDecoder.HeaderLen];
+        BinaryPrimitives.WriteUInt16LittleEndian(header, seq);
+        BinaryPrimitives.WriteUInt32LittleEndian(header.AsSpan(2), timeUs);
+        header[6] = mask;
+
+        var payload = new List<byte>(header);
+        foreach (var (type, data) in sections)
+        {
+            payload.Add(type);
+            payload.Add((byte)data.Length);
+            payload.AddRange(data);
+        }
+
+        return payload.ToArray();
+    }
+}
@@ -0,0 +1,59 @@
+using HidBridge.Transport.Uart;
+using Xunit;
+
+namespace HidBridge.Platform.Tests;
+
+/// <summary>
+/// Verifies TYPE_TEXT payload packing and status decoding.
+/// </summary>
+public sealed class UartTextTypingTests
+{
+    /// <summary>
+    /// Ensures APPEND carries subcommand, layout, interface, flags and interval before the UTF-8 text.
+    /// </summary>
+    [Fact]
+    public void Pack_EncodesHeaderAndUtf8()
+    {
+        var payloads = UartTextTyping.Pack("Ґа", UartKeyboardLayout.Ukrainian, 3, UartTextTyping.FlagEvents, 1000);
+
+        var payload = Assert.Single(payloads);
+        Assert.Equal(new byte[] { 0x01, 0x01, 3, 0x02, 0xE8, 0x03, 0xD2, 0x90, 0xD0, 0xB0 }, payload);
+    }
+
+    /// <summary>
+    /// Ensures long text is split at the frame limit without cutting a multi-byte character.
+    /// </summary>
+    [Fact]
+    public void Pack_SplitsOnCharacterBoundaries()
+    {
+        var text = new string('ж', 300);
+
+        var payloads = UartTextTyping.Pack(text, UartKeyboardLayout.Ukrainian, 1, 0, 0);
+
+        Assert.All(payloads, p => Assert.True(p.Length <= UartTextTyping.MaxPayload));
+        Assert.All(payloads, p => Assert.Equal(0, (p.Length - 6) % 2));
+        Assert.Equal(600, payloads.Sum(p => p.Length - 6));
+    }
+
+    /// <summary>
+    /// Ensures empty text produces no commands.
+    /// </summary>
+    [Fact]
+    public void Pack_EmptyTextProducesNothing()
+    {
+        Assert.Empty(UartTextTyping.Pack(string.Empty, UartKeyboardLayout.Us, 1, 0, 0));
+    }
+
+    /// <summary>
+    /// Ensures the status payload decodes and a short payload is rejected.
+    /// </summary>
+    [Fact]
+    public void TryParseStatus_DecodesFields()
+    {
+        var payload = new byte[] { 1, 0x10, 0x00, 0xEF, 0x07, 0x10, 0x27, 0x2C, 0x01, 0, 0, 0x03, 0x00, 0x01, 0x00 };
+
+        Assert.True(UartTextTyping.TryParseStatus(payload, out var status));
+        Assert.Equal(new HidBridgeUartTypeTextStatus(true, 16, 2031, 10000, 300, 3, 1), status);
+        Assert.False(UartTextTyping.TryParseStatus(payload.AsSpan(0, 14), out _));
+    }
+}